@@ -167,6 +167,29 @@ public:
     return 0;
   }
 
+  int encrypt_buf(const unsigned char *in, size_t in_len,
+		  unsigned char *out, size_t out_len,
+		  std::string *error) const override {
+    const size_t pad = AES_BLOCK_LEN - in_len % AES_BLOCK_LEN;
+    if (out_len < in_len + pad) {
+      if (error)
+	*error = "encrypt_buf: output buffer too small";
+      return -1;
+    }
+    // StreamTransformationFilter would apply the same PKCS#7 padding,
+    // but through a heap-allocated sink; feed the cipher directly and
+    // pad the tail block on the stack instead.
+    CryptoPP::CBC_Mode_ExternalCipher::Encryption cbc(
+      *enc_key, (const byte*)CEPH_AES_IV);
+    const size_t whole = in_len - in_len % AES_BLOCK_LEN;
+    cbc.ProcessData((byte*)out, (const byte*)in, whole);
+    byte last[AES_BLOCK_LEN];
+    memcpy(last, in + whole, in_len - whole);
+    memset(last + (in_len - whole), pad, pad);
+    cbc.ProcessData((byte*)out + whole, last, sizeof(last));
+    return in_len + pad;
+  }
+
   int decrypt(const bufferlist& in,
 	      bufferlist& out, std::string *error) const {
     string decryptedtext;
@@ -315,6 +338,45 @@ public:
 	      bufferlist& out, std::string *error) const override {
     return nss_aes_operation(CKA_ENCRYPT, mechanism, key, param, in, out, error);
   }
+  int encrypt_buf(const unsigned char *in, size_t in_len,
+		  unsigned char *out, size_t out_len,
+		  std::string *error) const override {
+    if (out_len < in_len + AES_BLOCK_LEN) {
+      if (error)
+	*error = "encrypt_buf: output buffer too small";
+      return -1;
+    }
+
+    PK11Context *ectx =
+      PK11_CreateContextBySymKey(mechanism, CKA_ENCRYPT, key, param);
+    assert(ectx);
+
+    int written = 0;
+    SECStatus ret = PK11_CipherOp(ectx, out, &written, out_len,
+				  const_cast<unsigned char*>(in), in_len);
+    if (ret != SECSuccess) {
+      PK11_DestroyContext(ectx, PR_TRUE);
+      if (error) {
+	ostringstream oss;
+	oss << "NSS AES failed: " << PR_GetError();
+	*error = oss.str();
+      }
+      return -1;
+    }
+
+    unsigned int written2;
+    ret = PK11_DigestFinal(ectx, out + written, &written2, out_len - written);
+    PK11_DestroyContext(ectx, PR_TRUE);
+    if (ret != SECSuccess) {
+      if (error) {
+	ostringstream oss;
+	oss << "NSS AES final round failed: " << PR_GetError();
+	*error = oss.str();
+      }
+      return -1;
+    }
+    return written + written2;
+  }
   int decrypt(const bufferlist& in,
 	       bufferlist& out, std::string *error) const override {
     return nss_aes_operation(CKA_DECRYPT, mechanism, key, param, in, out, error);
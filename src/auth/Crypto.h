@@ -40,6 +40,19 @@ public:
 		       bufferlist& out, std::string *error) const = 0;
   virtual int decrypt(const bufferlist& in,
 		       bufferlist& out, std::string *error) const = 0;
+
+  // One-shot encryption of a small flat buffer into a caller-provided
+  // buffer, for hot paths (per-message signing) where the bufferlist
+  // round trips of encrypt() are measurable.  out_len must have room
+  // for in_len rounded up to the cipher block size plus one block of
+  // padding.  Returns the number of bytes written, or -ENOTSUP if the
+  // backend only implements the bufferlist interface and the caller
+  // should fall back to encrypt().
+  virtual int encrypt_buf(const unsigned char *in, size_t in_len,
+			  unsigned char *out, size_t out_len,
+			  std::string *error) const {
+    return -ENOTSUP;
+  }
 };
 
 /*
@@ -114,6 +127,12 @@ public:
     assert(ckh); // Bad key?
     return ckh->decrypt(in, out, error);
   }
+  int encrypt_buf(CephContext *cct, const unsigned char *in, size_t in_len,
+		  unsigned char *out, size_t out_len,
+		  std::string *error) const {
+    assert(ckh); // Bad key?
+    return ckh->encrypt_buf(in, in_len, out, out_len, error);
+  }
 
   void to_str(std::string& s) const;
 };
@@ -18,7 +18,7 @@
 #include "auth/KeyRing.h"
 #include "CephxProtocol.h"
 #include "CephxKeyServer.h"
-#include "common/Mutex.h"
+#include "common/RWLock.h"
 
 class CephContext;
 
@@ -187,7 +187,10 @@ WRITE_CLASS_ENCODER(KeyServerData::Incremental)
 class KeyServer : public KeyStore {
   CephContext *cct;
   KeyServerData data;
-  mutable Mutex lock;
+  // Most users only read secrets (ticket validation, session key
+  // construction); mutation only happens on paxos updates and secret
+  // rotation, so let readers proceed concurrently.
+  mutable RWLock lock;
 
   int _rotate_secret(uint32_t service_id);
   bool _check_rotating_secrets();
@@ -225,7 +228,7 @@ public:
     ::encode(data, bl);
   }
   void decode(bufferlist::iterator& bl) {
-    Mutex::Locker l(lock);
+    RWLock::WLocker l(lock);
     ::decode(data, bl);
   }
   bool contains(const EntityName& name) const;
@@ -236,31 +239,31 @@ public:
     return encode_secrets(NULL, &ds);
   }
   version_t get_ver() const {
-    Mutex::Locker l(lock);
-    return data.version;    
+    RWLock::RLocker l(lock);
+    return data.version;
   }
 
   void clear_secrets() {
-    Mutex::Locker l(lock);
+    RWLock::WLocker l(lock);
     data.clear_secrets();
   }
 
   void apply_data_incremental(KeyServerData::Incremental& inc) {
-    Mutex::Locker l(lock);
+    RWLock::WLocker l(lock);
     data.apply_incremental(inc);
   }
   void set_ver(version_t ver) {
-    Mutex::Locker l(lock);
+    RWLock::WLocker l(lock);
     data.version = ver;
   }
 
   void add_auth(const EntityName& name, EntityAuth& auth) {
-    Mutex::Locker l(lock);
+    RWLock::WLocker l(lock);
     data.add_auth(name, auth);
   }
 
   void remove_secret(const EntityName& name) {
-    Mutex::Locker l(lock);
+    RWLock::WLocker l(lock);
     data.remove_secret(name);
   }
 
@@ -269,16 +272,16 @@ public:
     return (b != data.secrets_end());
   }
   int get_num_secrets() {
-    Mutex::Locker l(lock);
+    RWLock::RLocker l(lock);
     return data.secrets.size();
   }
 
   void clone_to(KeyServerData& dst) const {
-    Mutex::Locker l(lock);
+    RWLock::RLocker l(lock);
     dst = data;
   }
   void export_keyring(KeyRing& keyring) {
-    Mutex::Locker l(lock);
+    RWLock::RLocker l(lock);
     for (map<EntityName, EntityAuth>::iterator p = data.secrets.begin();
 	 p != data.secrets.end();
 	 ++p) {
@@ -290,7 +293,7 @@ public:
 
   bool get_rotating_encrypted(const EntityName& name, bufferlist& enc_bl) const;
 
-  Mutex& get_lock() const { return lock; }
+  RWLock& get_lock() const { return lock; }
   bool get_service_caps(const EntityName& name, uint32_t service_id,
 			AuthCapsInfo& caps) const;
 
@@ -45,18 +45,31 @@ int CephxSessionHandler::_calc_signature(Message *m, uint64_t *psig)
     mswab<uint32_t>(header.crc), mswab<uint32_t>(footer.front_crc),
     mswab<uint32_t>(footer.middle_crc), mswab<uint32_t>(footer.data_crc)
   };
-  bufferlist bl_plaintext;
-  bl_plaintext.append(buffer::create_static(sizeof(sigblock), (char*)&sigblock));
+  unsigned char cipher[sizeof(sigblock) + 16];
+  int r = key.encrypt_buf(cct, (const unsigned char*)&sigblock,
+			  sizeof(sigblock), cipher, sizeof(cipher), NULL);
+  if (r >= (int)sizeof(*psig)) {
+    // the signature is the leading 8 bytes of ciphertext, which is
+    // little-endian on the wire (as decode() of a __u64 would read it)
+    uint64_t raw;
+    memcpy(&raw, cipher, sizeof(raw));
+    *psig = mswab(raw);
+  } else {
+    // backend without a flat-buffer fast path
+    bufferlist bl_plaintext;
+    bl_plaintext.append(buffer::create_static(sizeof(sigblock),
+					      (char*)&sigblock));
+
+    bufferlist bl_ciphertext;
+    if (key.encrypt(cct, bl_plaintext, bl_ciphertext, NULL) < 0) {
+      lderr(cct) << __func__ << " failed to encrypt signature block" << dendl;
+      return -1;
+    }
 
-  bufferlist bl_ciphertext;
-  if (key.encrypt(cct, bl_plaintext, bl_ciphertext, NULL) < 0) {
-    lderr(cct) << __func__ << " failed to encrypt signature block" << dendl;
-    return -1;
+    bufferlist::iterator ci = bl_ciphertext.begin();
+    ::decode(*psig, ci);
   }
 
-  bufferlist::iterator ci = bl_ciphertext.begin();
-  ::decode(*psig, ci);
-
   ldout(cct, 10) << __func__ << " seq " << m->get_seq()
 		 << " front_crc_ = " << footer.front_crc
 		 << " middle_crc = " << footer.middle_crc
@@ -9460,10 +9460,19 @@ int Client::statfs(const char *path, struct statvfs *stbuf,
 
   if (quota_root && cct->_conf->client_quota_df && quota_root->quota.max_bytes) {
 
+    // Serve from the cached rstat if it was refreshed recently enough;
+    // frequent df polling otherwise lands a getattr on the MDS every
+    // time.  Zero max age preserves the always-refresh behaviour.
+    utime_t now = ceph_clock_now();
+    double max_age = cct->_conf->client_quota_df_max_age;
+    bool fresh = max_age > 0 &&
+      !quota_root->last_quota_df_stamp.is_zero() &&
+      (double)(now - quota_root->last_quota_df_stamp) < max_age;
+
     // Skip the getattr if any sessions are stale, as we don't want to
     // block `df` if this client has e.g. been evicted, or if the MDS cluster
     // is unhealthy.
-    if (!_any_stale_sessions()) {
+    if (!fresh && !_any_stale_sessions()) {
       int r = _getattr(quota_root, 0, perms, true);
       if (r != 0) {
         // Ignore return value: error getting latest inode metadata is not a good
@@ -9471,6 +9480,8 @@ int Client::statfs(const char *path, struct statvfs *stbuf,
         lderr(cct) << "Error in getattr on quota root 0x"
                    << std::hex << quota_root->ino << std::dec
                    << " statfs result may be outdated" << dendl;
+      } else {
+	quota_root->last_quota_df_stamp = now;
       }
     }
 
@@ -10118,6 +10129,75 @@ int Client::ll_lookupx(Inode *parent, const char *name, Inode **out,
   return r;
 }
 
+static int _lookup_batch_prime_cb(void *p, struct dirent *de,
+				  struct ceph_statx *stx, off_t off,
+				  Inode *in)
+{
+  // we only want the side effect of the readdir filling the dentry cache
+  return 0;
+}
+
+int Client::ll_lookup_batch(Inode *parent, const char **names, size_t count,
+			    Inode **out, struct ceph_statx *stx,
+			    unsigned want, unsigned flags,
+			    const UserPerm& perms)
+{
+  unsigned mask = statx_to_mask(flags, want);
+  dir_result_t *dirp = NULL;
+
+  {
+    Mutex::Locker lock(client_lock);
+    vinodeno_t vparent = _get_vino(parent);
+    ldout(cct, 3) << "ll_lookup_batch " << vparent << " " << count
+		  << " names" << dendl;
+    tout(cct) << "ll_lookup_batch" << std::endl;
+
+    if (!cct->_conf->fuse_default_permissions) {
+      int r = may_lookup(parent, perms);
+      if (r < 0)
+	return r;
+    }
+
+    // If we don't have the whole directory cached, sweep it with
+    // readdirplus first: one MDS round trip per dirfrag instead of one
+    // per missing name.  The readdir replies populate the dentry cache,
+    // so the lookups below are served locally.
+    if (count > 1 && parent->is_dir() &&
+	!((parent->flags & I_COMPLETE) &&
+	  parent->caps_issued_mask(CEPH_CAP_FILE_SHARED))) {
+      if (_opendir(parent, &dirp, perms) != 0)
+	dirp = NULL;  // priming is best effort; fall back to lookups
+    }
+  }
+
+  if (dirp) {
+    readdir_r_cb(dirp, _lookup_batch_prime_cb, NULL, want, flags, false);
+    Mutex::Locker lock(client_lock);
+    _closedir(dirp);
+  }
+
+  Mutex::Locker lock(client_lock);
+  int found = 0;
+  for (size_t i = 0; i < count; i++) {
+    InodeRef in;
+    string dname(names[i]);
+    int r = _lookup(parent, dname, mask, &in, perms);
+    if (r < 0) {
+      stx[i].stx_ino = 0;
+      stx[i].stx_mask = 0;
+      out[i] = NULL;
+      continue;
+    }
+    assert(in);
+    fill_statx(in, mask, &stx[i]);
+    _ll_get(in.get());
+    out[i] = in.get();
+    found++;
+  }
+  ldout(cct, 3) << "ll_lookup_batch found " << found << "/" << count << dendl;
+  return found;
+}
+
 int Client::ll_walk(const char* name, Inode **out, struct ceph_statx *stx,
 		    unsigned int want, unsigned int flags, const UserPerm& perms)
 {
@@ -11966,6 +12046,12 @@ int Client::ll_file_layout(Fh *fh, file_layout_t *layout)
   return ll_file_layout(fh->inode.get(), layout);
 }
 
+int Client::ll_caps_issued(Fh *fh)
+{
+  Mutex::Locker lock(client_lock);
+  return fh->inode->caps_issued();
+}
+
 /* Currently we cannot take advantage of redundancy in reads, since we
    would have to go through all possible placement groups (a
    potentially quite large number determined by a hash), and use CRUSH
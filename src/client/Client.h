@@ -1137,6 +1137,9 @@ public:
   int ll_lookupx(Inode *parent, const char *name, Inode **out,
 			struct ceph_statx *stx, unsigned want, unsigned flags,
 			const UserPerm& perms);
+  int ll_lookup_batch(Inode *parent, const char **names, size_t count,
+		      Inode **out, struct ceph_statx *stx, unsigned want,
+		      unsigned flags, const UserPerm& perms);
   bool ll_forget(Inode *in, int count);
   bool ll_put(Inode *in);
   int ll_getattr(Inode *in, struct stat *st, const UserPerm& perms);
@@ -1216,6 +1219,7 @@ public:
   int ll_setlk(Fh *fh, struct flock *fl, uint64_t owner, int sleep);
   int ll_flock(Fh *fh, int cmd, uint64_t owner);
   int ll_file_layout(Fh *fh, file_layout_t *layout);
+  int ll_caps_issued(Fh *fh);
   void ll_interrupt(void *d);
   bool ll_handle_umask() {
     return acl_type != NO_ACL;
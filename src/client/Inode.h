@@ -151,6 +151,7 @@ struct Inode {
   unsigned flags;
 
   quota_info_t quota;
+  utime_t last_quota_df_stamp;  // last time statfs refreshed our rstat from the mds
 
   bool is_complete_and_ordered() {
     static const unsigned wants = I_COMPLETE | I_DIR_ORDERED;
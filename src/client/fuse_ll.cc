@@ -563,6 +563,11 @@ static void fuse_ll_open(fuse_req_t req, fuse_ino_t ino,
 #if FUSE_VERSION >= FUSE_MAKE_VERSION(2, 8)
     if (cfuse->client->cct->_conf->fuse_disable_pagecache)
       fi->direct_io = 1;
+    else if (cfuse->client->cct->_conf->fuse_auto_direct_io &&
+	     !(cfuse->client->ll_caps_issued(fh) & CEPH_CAP_FILE_CACHE))
+      // without Fc the read path is synchronous anyway; don't pay an
+      // extra copy to fill a page cache we would have to invalidate
+      fi->direct_io = 1;
     else if (cfuse->client->cct->_conf->fuse_use_invalidate_cb)
       fi->keep_cache = 1;
 #endif
@@ -772,6 +777,9 @@ static void fuse_ll_create(fuse_req_t req, fuse_ino_t parent, const char *name,
 #if FUSE_VERSION >= FUSE_MAKE_VERSION(2, 8)
     if (cfuse->client->cct->_conf->fuse_disable_pagecache)
       fi->direct_io = 1;
+    else if (cfuse->client->cct->_conf->fuse_auto_direct_io &&
+	     !(cfuse->client->ll_caps_issued(fh) & CEPH_CAP_FILE_CACHE))
+      fi->direct_io = 1;
     else if (cfuse->client->cct->_conf->fuse_use_invalidate_cb)
       fi->keep_cache = 1;
 #endif
@@ -931,6 +939,16 @@ static void do_init(void *data, fuse_conn_info *conn)
   }
 #endif
 
+#ifdef FUSE_CAP_WRITEBACK_CACHE
+  if (client->cct->_conf->fuse_writeback_cache &&
+      (conn->capable & FUSE_CAP_WRITEBACK_CACHE)) {
+    // let the kernel aggregate small writes before they reach us; the
+    // invalidate callback keeps the page cache consistent when caps
+    // are revoked, so ObjectCacher stays the cache authority
+    conn->want |= FUSE_CAP_WRITEBACK_CACHE;
+  }
+#endif
+
   if (cfuse->fd_on_success) {
     //cout << "fuse init signaling on fd " << fd_on_success << std::endl;
     // see Preforker::daemonize(), ceph-fuse's parent process expects a `-1`
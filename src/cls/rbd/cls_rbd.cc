@@ -2397,34 +2397,19 @@ int object_map_resize(cls_method_context_t hctx, bufferlist *in, bufferlist *out
 }
 
 /**
- * Update an rbd image's object map
+ * Apply a state update to one or more index ranges of an rbd image's
+ * object map, loading the header and footer only once.
  *
- * Input:
- * @param start_object_no the start object iterator
- * @param end_object_no the end object iterator
+ * @param ranges map of start object iterator to end object iterator
  * @param new_object_state the new object state
  * @param current_object_state optional current object state filter
- *
- * Output:
  * @returns 0 on success, negative error code on failure
  */
-int object_map_update(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
+static int object_map_update_ranges(
+    cls_method_context_t hctx, const std::map<uint64_t, uint64_t> &ranges,
+    uint8_t new_object_state,
+    const boost::optional<uint8_t> &current_object_state)
 {
-  uint64_t start_object_no;
-  uint64_t end_object_no;
-  uint8_t new_object_state;
-  boost::optional<uint8_t> current_object_state;
-  try {
-    bufferlist::iterator iter = in->begin();
-    ::decode(start_object_no, iter);
-    ::decode(end_object_no, iter);
-    ::decode(new_object_state, iter);
-    ::decode(current_object_state, iter);
-  } catch (const buffer::error &err) {
-    CLS_ERR("failed to decode message");
-    return -EINVAL;
-  }
-
   uint64_t size;
   int r = cls_cxx_stat(hctx, &size, NULL);
   if (r < 0) {
@@ -2464,46 +2449,94 @@ int object_map_update(cls_method_context_t hctx, bufferlist *in, bufferlist *out
     CLS_ERR("failed to decode object map footer: %s", err.what());
   }
 
-  if (start_object_no >= end_object_no || end_object_no > object_map.size()) {
-    return -ERANGE;
+  // reads execute against the objectstore and never observe the writes
+  // this call has buffered in its transaction, and decoding a data block
+  // a second time would revert in-memory updates an earlier range already
+  // made to it. Validate the ranges and load every affected block exactly
+  // once before touching the map.
+  interval_set<uint64_t> data_extents;
+  for (auto &range : ranges) {
+    if (range.first >= range.second || range.second > object_map.size()) {
+      return -ERANGE;
+    }
+
+    uint64_t byte_offset;
+    uint64_t byte_length;
+    object_map.get_data_extents(range.first, range.second - range.first,
+				&byte_offset, &byte_length);
+    data_extents.union_insert(byte_offset, byte_length);
   }
 
-  uint64_t byte_offset;
-  uint64_t byte_length;
-  object_map.get_data_extents(start_object_no,
-			      end_object_no - start_object_no,
-			      &byte_offset, &byte_length);
+  for (interval_set<uint64_t>::const_iterator ext = data_extents.begin();
+       ext != data_extents.end(); ++ext) {
+    bufferlist data_bl;
+    r = cls_cxx_read2(hctx, object_map.get_header_length() + ext.get_start(),
+		      ext.get_len(), &data_bl,
+		      CEPH_OSD_OP_FLAG_FADVISE_WILLNEED);
+    if (r < 0) {
+      CLS_ERR("object map data read failed");
+      return r;
+    }
+
+    try {
+      bufferlist::iterator it = data_bl.begin();
+      object_map.decode_data(it, ext.get_start());
+    } catch (const buffer::error &err) {
+      CLS_ERR("failed to decode data chunk [%" PRIu64 "]: %s",
+	      ext.get_start(), err.what());
+      return -EINVAL;
+    }
+  }
 
-  bufferlist data_bl;
-  r = cls_cxx_read2(hctx, object_map.get_header_length() + byte_offset,
-		    byte_length, &data_bl, CEPH_OSD_OP_FLAG_FADVISE_WILLNEED);
-  if (r < 0) {
-    CLS_ERR("object map data read failed");
-    return r;
+  // apply every range to the in-memory map before encoding anything back
+  interval_set<uint64_t> updated_object_nos;
+  for (auto &range : ranges) {
+    bool updated = false;
+    for (uint64_t object_no = range.first; object_no < range.second;
+	 ++object_no) {
+      uint8_t state = object_map[object_no];
+      if ((!current_object_state || state == *current_object_state ||
+	  (*current_object_state == OBJECT_EXISTS &&
+	   state == OBJECT_EXISTS_CLEAN)) && state != new_object_state) {
+	object_map[object_no] = new_object_state;
+	updated = true;
+      }
+    }
+    if (updated) {
+      updated_object_nos.union_insert(range.first,
+				      range.second - range.first);
+    }
   }
 
-  try {
-    bufferlist::iterator it = data_bl.begin();
-    object_map.decode_data(it, byte_offset);
-  } catch (const buffer::error &err) {
-    CLS_ERR("failed to decode data chunk [%" PRIu64 "]: %s",
-	    byte_offset, err.what());
-    return -EINVAL;
+  if (updated_object_nos.empty()) {
+    CLS_LOG(20, "object_map_update: no update necessary");
+    return 0;
   }
 
-  bool updated = false;
-  for (uint64_t object_no = start_object_no; object_no < end_object_no;
-       ++object_no) {
-    uint8_t state = object_map[object_no];
-    if ((!current_object_state || state == *current_object_state ||
-        (*current_object_state == OBJECT_EXISTS &&
-         state == OBJECT_EXISTS_CLEAN)) && state != new_object_state) {
-      object_map[object_no] = new_object_state;
-      updated = true;
+  // emit one write per dirtied extent: merge updated object runs whose
+  // data blocks overlap so no block is written twice
+  interval_set<uint64_t>::const_iterator it = updated_object_nos.begin();
+  while (it != updated_object_nos.end()) {
+    uint64_t start_object_no = it.get_start();
+    uint64_t end_object_no = it.get_start() + it.get_len();
+
+    uint64_t byte_offset;
+    uint64_t byte_length;
+    object_map.get_data_extents(start_object_no,
+				end_object_no - start_object_no,
+				&byte_offset, &byte_length);
+    for (++it; it != updated_object_nos.end(); ++it) {
+      uint64_t next_byte_offset;
+      uint64_t next_byte_length;
+      object_map.get_data_extents(it.get_start(), it.get_len(),
+				  &next_byte_offset, &next_byte_length);
+      if (next_byte_offset >= byte_offset + byte_length) {
+	break;
+      }
+      end_object_no = it.get_start() + it.get_len();
+      byte_length = next_byte_offset + next_byte_length - byte_offset;
     }
-  }
 
-  if (updated) {
     CLS_LOG(20, "object_map_update: %" PRIu64 "~%" PRIu64 " -> %" PRIu64,
 	    byte_offset, byte_length,
 	    object_map.get_header_length() + byte_offset);
@@ -2518,21 +2551,101 @@ int object_map_update(cls_method_context_t hctx, bufferlist *in, bufferlist *out
       return r;
     }
 
-    footer_bl.clear();
-    object_map.encode_footer(footer_bl);
-    r = cls_cxx_write2(hctx, object_map.get_footer_offset(), footer_bl.length(),
-		       &footer_bl, CEPH_OSD_OP_FLAG_FADVISE_WILLNEED);
-    if (r < 0) {
-      CLS_ERR("failed to write object map footer: %s", cpp_strerror(r).c_str());
-      return r;
+    // only rewrite the CRCs for the updated data blocks instead of the
+    // full footer -- the footer scales with the image size
+    bufferlist data_crcs_bl;
+    object_map.encode_data_crcs(data_crcs_bl, start_object_no,
+				end_object_no - start_object_no);
+    if (data_crcs_bl.length() > 0) {
+      uint64_t crc_byte_offset;
+      uint64_t crc_byte_length;
+      object_map.get_data_crcs_extents(start_object_no,
+				       end_object_no - start_object_no,
+				       &crc_byte_offset, &crc_byte_length);
+      assert(data_crcs_bl.length() == crc_byte_length);
+
+      r = cls_cxx_write2(hctx,
+			 object_map.get_footer_offset() + crc_byte_offset,
+			 crc_byte_length, &data_crcs_bl,
+			 CEPH_OSD_OP_FLAG_FADVISE_WILLNEED);
+      if (r < 0) {
+	CLS_ERR("failed to write object map footer: %s",
+		cpp_strerror(r).c_str());
+	return r;
+      }
     }
-  } else {
-    CLS_LOG(20, "object_map_update: no update necessary");
   }
 
   return 0;
 }
 
+/**
+ * Update an rbd image's object map
+ *
+ * Input:
+ * @param start_object_no the start object iterator
+ * @param end_object_no the end object iterator
+ * @param new_object_state the new object state
+ * @param current_object_state optional current object state filter
+ *
+ * Output:
+ * @returns 0 on success, negative error code on failure
+ */
+int object_map_update(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
+{
+  uint64_t start_object_no;
+  uint64_t end_object_no;
+  uint8_t new_object_state;
+  boost::optional<uint8_t> current_object_state;
+  try {
+    bufferlist::iterator iter = in->begin();
+    ::decode(start_object_no, iter);
+    ::decode(end_object_no, iter);
+    ::decode(new_object_state, iter);
+    ::decode(current_object_state, iter);
+  } catch (const buffer::error &err) {
+    CLS_ERR("failed to decode message");
+    return -EINVAL;
+  }
+
+  std::map<uint64_t, uint64_t> ranges;
+  ranges[start_object_no] = end_object_no;
+  return object_map_update_ranges(hctx, ranges, new_object_state,
+				  current_object_state);
+}
+
+/**
+ * Update multiple index ranges of an rbd image's object map in a
+ * single call, sharing one header/footer load across the ranges.
+ *
+ * Input:
+ * @param ranges map of start object iterator to end object iterator
+ * @param new_object_state the new object state
+ * @param current_object_state optional current object state filter
+ *
+ * Output:
+ * @returns 0 on success, negative error code on failure
+ */
+int object_map_update_batch(cls_method_context_t hctx, bufferlist *in,
+                            bufferlist *out)
+{
+  std::map<uint64_t, uint64_t> ranges;
+  uint8_t new_object_state;
+  boost::optional<uint8_t> current_object_state;
+  try {
+    bufferlist::iterator iter = in->begin();
+    ::decode(ranges, iter);
+    ::decode(new_object_state, iter);
+    ::decode(current_object_state, iter);
+  } catch (const buffer::error &err) {
+    CLS_ERR("failed to decode message");
+    return -EINVAL;
+  }
+
+  return object_map_update_ranges(hctx, ranges, new_object_state,
+				  current_object_state);
+}
+
 /**
  * Mark all _EXISTS objects as _EXISTS_CLEAN so future writes to the
  * image HEAD can be tracked.
@@ -5139,6 +5252,7 @@ CLS_INIT(rbd)
   cls_method_handle_t h_object_map_save;
   cls_method_handle_t h_object_map_resize;
   cls_method_handle_t h_object_map_update;
+  cls_method_handle_t h_object_map_update_batch;
   cls_method_handle_t h_object_map_snap_add;
   cls_method_handle_t h_object_map_snap_remove;
   cls_method_handle_t h_metadata_set;
@@ -5338,6 +5452,9 @@ CLS_INIT(rbd)
   cls_register_cxx_method(h_class, "object_map_update",
                           CLS_METHOD_RD | CLS_METHOD_WR,
 			  object_map_update, &h_object_map_update);
+  cls_register_cxx_method(h_class, "object_map_update_batch",
+                          CLS_METHOD_RD | CLS_METHOD_WR,
+			  object_map_update_batch, &h_object_map_update_batch);
   cls_register_cxx_method(h_class, "object_map_snap_add",
                           CLS_METHOD_RD | CLS_METHOD_WR,
 			  object_map_snap_add, &h_object_map_snap_add);
@@ -1209,6 +1209,19 @@ namespace librbd {
       rados_op->exec("rbd", "object_map_update", in);
     }
 
+    void object_map_update_batch(
+        librados::ObjectWriteOperation *rados_op,
+        const std::map<uint64_t, uint64_t> &ranges,
+        uint8_t new_object_state,
+        const boost::optional<uint8_t> &current_object_state)
+    {
+      bufferlist in;
+      ::encode(ranges, in);
+      ::encode(new_object_state, in);
+      ::encode(current_object_state, in);
+      rados_op->exec("rbd", "object_map_update_batch", in);
+    }
+
     void object_map_snap_add(librados::ObjectWriteOperation *rados_op)
     {
       bufferlist in;
@@ -80,12 +80,20 @@ static void get_time_key(real_time& ut, string *key)
   *key = buf;
 }
 
-static void get_index_ver_key(cls_method_context_t hctx, uint64_t index_ver, string *key)
-{
-  char buf[48];
-  snprintf(buf, sizeof(buf), "%011llu.%llu.%d", (unsigned long long)index_ver,
-           (unsigned long long)cls_current_version(hctx),
-           cls_current_subop_num(hctx));
+static void get_index_ver_key(cls_method_context_t hctx, uint64_t index_ver, string *key,
+                              uint64_t entry_ordinal)
+{
+  char buf[64];
+  int len = snprintf(buf, sizeof(buf), "%011llu.%llu.%d", (unsigned long long)index_ver,
+                     (unsigned long long)cls_current_version(hctx),
+                     cls_current_subop_num(hctx));
+  if (entry_ordinal > 0) {
+    /* a batched call logs several entries under the same (index_ver,
+     * version, subop) triple; fold the entry ordinal in so the keys stay
+     * unique. The first entry keeps the unsuffixed singleton format, and
+     * the zero padding keeps lexical order matching batch order. */
+    snprintf(buf + len, sizeof(buf) - len, ".%08llu", (unsigned long long)entry_ordinal);
+  }
   *key = buf;
 }
 
@@ -95,17 +103,19 @@ static void bi_log_prefix(string& key)
   key.append(bucket_index_prefixes[BI_BUCKET_LOG_INDEX]);
 }
 
-static void bi_log_index_key(cls_method_context_t hctx, string& key, string& id, uint64_t index_ver)
+static void bi_log_index_key(cls_method_context_t hctx, string& key, string& id, uint64_t index_ver,
+                             uint64_t entry_ordinal)
 {
   bi_log_prefix(key);
-  get_index_ver_key(hctx, index_ver, &id);
+  get_index_ver_key(hctx, index_ver, &id, entry_ordinal);
   key.append(id);
 }
 
 static int log_index_operation(cls_method_context_t hctx, cls_rgw_obj_key& obj_key, RGWModifyOp op,
                                string& tag, real_time& timestamp,
                                rgw_bucket_entry_ver& ver, RGWPendingState state, uint64_t index_ver,
-                               string& max_marker, uint16_t bilog_flags, string *owner, string *owner_display_name, rgw_zone_set *zones_trace)
+                               string& max_marker, uint16_t bilog_flags, string *owner, string *owner_display_name, rgw_zone_set *zones_trace,
+                               uint64_t entry_ordinal = 0)
 {
   bufferlist bl;
 
@@ -131,7 +141,7 @@ static int log_index_operation(cls_method_context_t hctx, cls_rgw_obj_key& obj_k
   }
 
   string key;
-  bi_log_index_key(hctx, key, entry.id, index_ver);
+  bi_log_index_key(hctx, key, entry.id, index_ver, entry_ordinal);
 
   ::encode(entry, bl);
 
@@ -498,7 +508,7 @@ static int check_index(cls_method_context_t hctx, struct rgw_bucket_dir_header *
       struct rgw_bucket_dir_entry entry;
       bufferlist::iterator eiter = kiter->second.begin();
       try {
-        ::decode(entry, eiter);
+        entry.decode_summary(eiter);
       } catch (buffer::error& err) {
         CLS_LOG(1, "ERROR: rgw_bucket_list(): failed to decode entry, key=%s\n", kiter->first.c_str());
         return -EIO;
@@ -636,24 +646,16 @@ int rgw_bucket_set_tag_timeout(cls_method_context_t hctx, bufferlist *in, buffer
 static int read_key_entry(cls_method_context_t hctx, cls_rgw_obj_key& key, string *idx, struct rgw_bucket_dir_entry *entry,
                           bool special_delete_marker_name = false);
 
-int rgw_bucket_prepare_op(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
+static int bucket_prepare_entry(cls_method_context_t hctx, rgw_cls_obj_prepare_op& op,
+                                struct rgw_bucket_dir_header& header,
+                                uint64_t entry_ordinal = 0)
 {
-  // decode request
-  rgw_cls_obj_prepare_op op;
-  bufferlist::iterator iter = in->begin();
-  try {
-    ::decode(op, iter);
-  } catch (buffer::error& err) {
-    CLS_LOG(1, "ERROR: rgw_bucket_prepare_op(): failed to decode request\n");
-    return -EINVAL;
-  }
-
   if (op.tag.empty()) {
     CLS_LOG(1, "ERROR: tag is empty\n");
     return -EINVAL;
   }
 
-  CLS_LOG(1, "rgw_bucket_prepare_op(): request: op=%d name=%s instance=%s tag=%s\n",
+  CLS_LOG(1, "%s(): request: op=%d name=%s instance=%s tag=%s\n", __func__,
           op.op, op.key.name.c_str(), op.key.instance.c_str(), op.tag.c_str());
 
   // get on-disk state
@@ -682,16 +684,10 @@ int rgw_bucket_prepare_op(cls_method_context_t hctx, bufferlist *in, bufferlist
   info.op = op.op;
   entry.pending_map.insert(pair<string, rgw_bucket_pending_info>(op.tag, info));
 
-  struct rgw_bucket_dir_header header;
-  rc = read_bucket_header(hctx, &header);
-  if (rc < 0) {
-    CLS_LOG(1, "ERROR: rgw_bucket_prepare_op(): failed to read header\n");
-    return rc;
-  }
-
   if (op.log_op) {
     rc = log_index_operation(hctx, op.key, op.op, op.tag, entry.meta.mtime,
-                             entry.ver, info.state, header.ver, header.max_marker, op.bilog_flags, NULL, NULL, &op.zones_trace);
+                             entry.ver, info.state, header.ver, header.max_marker, op.bilog_flags, NULL, NULL, &op.zones_trace,
+                             entry_ordinal);
     if (rc < 0)
       return rc;
   }
@@ -699,13 +695,75 @@ int rgw_bucket_prepare_op(cls_method_context_t hctx, bufferlist *in, bufferlist
   // write out new key to disk
   bufferlist info_bl;
   ::encode(entry, info_bl);
-  rc = cls_cxx_map_set_val(hctx, idx, &info_bl);
+  return cls_cxx_map_set_val(hctx, idx, &info_bl);
+}
+
+int rgw_bucket_prepare_op(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
+{
+  // decode request
+  rgw_cls_obj_prepare_op op;
+  bufferlist::iterator iter = in->begin();
+  try {
+    ::decode(op, iter);
+  } catch (buffer::error& err) {
+    CLS_LOG(1, "ERROR: rgw_bucket_prepare_op(): failed to decode request\n");
+    return -EINVAL;
+  }
+
+  struct rgw_bucket_dir_header header;
+  int rc = read_bucket_header(hctx, &header);
+  if (rc < 0) {
+    CLS_LOG(1, "ERROR: rgw_bucket_prepare_op(): failed to read header\n");
+    return rc;
+  }
+
+  rc = bucket_prepare_entry(hctx, op, header);
   if (rc < 0)
     return rc;
 
   return write_bucket_header(hctx, &header);
 }
 
+int rgw_bucket_batch_prepare_op(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
+{
+  // decode request
+  rgw_cls_obj_batch_prepare_op op;
+  bufferlist::iterator iter = in->begin();
+  try {
+    ::decode(op, iter);
+  } catch (buffer::error& err) {
+    CLS_LOG(1, "ERROR: rgw_bucket_batch_prepare_op(): failed to decode request\n");
+    return -EINVAL;
+  }
+
+  if (op.entries.empty()) {
+    CLS_LOG(1, "ERROR: rgw_bucket_batch_prepare_op(): empty batch\n");
+    return -EINVAL;
+  }
+
+  CLS_LOG(10, "rgw_bucket_batch_prepare_op(): %d entries\n", (int)op.entries.size());
+
+  struct rgw_bucket_dir_header header;
+  int rc = read_bucket_header(hctx, &header);
+  if (rc < 0) {
+    CLS_LOG(1, "ERROR: rgw_bucket_batch_prepare_op(): failed to read header\n");
+    return rc;
+  }
+
+  /* the whole batch shares a single header read/write and is applied in
+   * the one osd transaction this call runs in, so a failing entry leaves
+   * no partial updates behind */
+  uint64_t entry_ordinal = 0;
+  for (list<rgw_cls_obj_prepare_op>::iterator eiter = op.entries.begin();
+       eiter != op.entries.end(); ++eiter, ++entry_ordinal) {
+    rc = bucket_prepare_entry(hctx, *eiter, header, entry_ordinal);
+    if (rc < 0)
+      return rc;
+  }
+
+  return write_bucket_header(hctx, &header);
+}
+
 static void unaccount_entry(struct rgw_bucket_dir_header& header, struct rgw_bucket_dir_entry& entry)
 {
   struct rgw_bucket_category_stats& stats = header.stats[entry.meta.category];
@@ -782,34 +840,22 @@ static int read_key_entry(cls_method_context_t hctx, cls_rgw_obj_key& key, strin
   return 0;
 }
 
-int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
+static int bucket_complete_entry(cls_method_context_t hctx, rgw_cls_obj_complete_op& op,
+                                 struct rgw_bucket_dir_header& header, bool *header_changed,
+                                 uint64_t entry_ordinal = 0)
 {
-  // decode request
-  rgw_cls_obj_complete_op op;
-  bufferlist::iterator iter = in->begin();
-  try {
-    ::decode(op, iter);
-  } catch (buffer::error& err) {
-    CLS_LOG(1, "ERROR: rgw_bucket_complete_op(): failed to decode request\n");
-    return -EINVAL;
-  }
-  CLS_LOG(1, "rgw_bucket_complete_op(): request: op=%d name=%s instance=%s ver=%lu:%llu tag=%s\n",
+  CLS_LOG(1, "%s(): request: op=%d name=%s instance=%s ver=%lu:%llu tag=%s\n", __func__,
           op.op, op.key.name.c_str(), op.key.instance.c_str(),
           (unsigned long)op.ver.pool, (unsigned long long)op.ver.epoch,
           op.tag.c_str());
 
-  struct rgw_bucket_dir_header header;
-  int rc = read_bucket_header(hctx, &header);
-  if (rc < 0) {
-    CLS_LOG(1, "ERROR: rgw_bucket_complete_op(): failed to read header\n");
-    return -EINVAL;
-  }
+  *header_changed = false;
 
   struct rgw_bucket_dir_entry entry;
   bool ondisk = true;
 
   string idx;
-  rc = read_key_entry(hctx, op.key, &idx, &entry);
+  int rc = read_key_entry(hctx, op.key, &idx, &entry);
   if (rc == -ENOENT) {
     entry.key = op.key;
     entry.ver = op.ver;
@@ -848,7 +894,8 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
   if (cancel) {
     if (op.log_op) {
       rc = log_index_operation(hctx, op.key, op.op, op.tag, entry.meta.mtime, entry.ver,
-                               CLS_RGW_STATE_COMPLETE, header.ver, header.max_marker, op.bilog_flags, NULL, NULL, &op.zones_trace);
+                               CLS_RGW_STATE_COMPLETE, header.ver, header.max_marker, op.bilog_flags, NULL, NULL, &op.zones_trace,
+                               entry_ordinal);
       if (rc < 0)
         return rc;
     }
@@ -910,7 +957,8 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
 
   if (op.log_op) {
     rc = log_index_operation(hctx, op.key, op.op, op.tag, entry.meta.mtime, entry.ver,
-                             CLS_RGW_STATE_COMPLETE, header.ver, header.max_marker, op.bilog_flags, NULL, NULL, &op.zones_trace);
+                             CLS_RGW_STATE_COMPLETE, header.ver, header.max_marker, op.bilog_flags, NULL, NULL, &op.zones_trace,
+                             entry_ordinal);
     if (rc < 0)
       return rc;
   }
@@ -935,7 +983,8 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
 
     if (op.log_op) {
       rc = log_index_operation(hctx, remove_key, CLS_RGW_OP_DEL, op.tag, remove_entry.meta.mtime,
-                               remove_entry.ver, CLS_RGW_STATE_COMPLETE, header.ver, header.max_marker, op.bilog_flags, NULL, NULL, &op.zones_trace);
+                               remove_entry.ver, CLS_RGW_STATE_COMPLETE, header.ver, header.max_marker, op.bilog_flags, NULL, NULL, &op.zones_trace,
+                               entry_ordinal);
       if (rc < 0)
         continue;
     }
@@ -947,6 +996,86 @@ int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist
     }
   }
 
+  *header_changed = true;
+  return 0;
+}
+
+int rgw_bucket_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
+{
+  // decode request
+  rgw_cls_obj_complete_op op;
+  bufferlist::iterator iter = in->begin();
+  try {
+    ::decode(op, iter);
+  } catch (buffer::error& err) {
+    CLS_LOG(1, "ERROR: rgw_bucket_complete_op(): failed to decode request\n");
+    return -EINVAL;
+  }
+
+  struct rgw_bucket_dir_header header;
+  int rc = read_bucket_header(hctx, &header);
+  if (rc < 0) {
+    CLS_LOG(1, "ERROR: rgw_bucket_complete_op(): failed to read header\n");
+    return -EINVAL;
+  }
+
+  bool header_changed;
+  rc = bucket_complete_entry(hctx, op, header, &header_changed);
+  if (rc < 0)
+    return rc;
+
+  if (!header_changed) {
+    /* a canceled operation doesn't dirty the header */
+    return 0;
+  }
+
+  return write_bucket_header(hctx, &header);
+}
+
+int rgw_bucket_batch_complete_op(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
+{
+  // decode request
+  rgw_cls_obj_batch_complete_op op;
+  bufferlist::iterator iter = in->begin();
+  try {
+    ::decode(op, iter);
+  } catch (buffer::error& err) {
+    CLS_LOG(1, "ERROR: rgw_bucket_batch_complete_op(): failed to decode request\n");
+    return -EINVAL;
+  }
+
+  if (op.entries.empty()) {
+    CLS_LOG(1, "ERROR: rgw_bucket_batch_complete_op(): empty batch\n");
+    return -EINVAL;
+  }
+
+  CLS_LOG(10, "rgw_bucket_batch_complete_op(): %d entries\n", (int)op.entries.size());
+
+  struct rgw_bucket_dir_header header;
+  int rc = read_bucket_header(hctx, &header);
+  if (rc < 0) {
+    CLS_LOG(1, "ERROR: rgw_bucket_batch_complete_op(): failed to read header\n");
+    return -EINVAL;
+  }
+
+  /* all entries share a single header read/write and are applied in the
+   * one osd transaction this call runs in, so a failing entry leaves no
+   * partial updates behind */
+  bool write_header = false;
+  uint64_t entry_ordinal = 0;
+  for (list<rgw_cls_obj_complete_op>::iterator eiter = op.entries.begin();
+       eiter != op.entries.end(); ++eiter, ++entry_ordinal) {
+    bool header_changed;
+    rc = bucket_complete_entry(hctx, *eiter, header, &header_changed, entry_ordinal);
+    if (rc < 0)
+      return rc;
+    write_header |= header_changed;
+  }
+
+  if (!write_header) {
+    return 0;
+  }
+
   return write_bucket_header(hctx, &header);
 }
 
@@ -3734,6 +3863,8 @@ CLS_INIT(rgw)
   cls_method_handle_t h_rgw_bucket_update_stats;
   cls_method_handle_t h_rgw_bucket_prepare_op;
   cls_method_handle_t h_rgw_bucket_complete_op;
+  cls_method_handle_t h_rgw_bucket_batch_prepare_op;
+  cls_method_handle_t h_rgw_bucket_batch_complete_op;
   cls_method_handle_t h_rgw_bucket_link_olh;
   cls_method_handle_t h_rgw_bucket_unlink_instance_op;
   cls_method_handle_t h_rgw_bucket_read_olh_log;
@@ -3781,6 +3912,8 @@ CLS_INIT(rgw)
   cls_register_cxx_method(h_class, RGW_BUCKET_UPDATE_STATS, CLS_METHOD_RD | CLS_METHOD_WR, rgw_bucket_update_stats, &h_rgw_bucket_update_stats);
   cls_register_cxx_method(h_class, RGW_BUCKET_PREPARE_OP, CLS_METHOD_RD | CLS_METHOD_WR, rgw_bucket_prepare_op, &h_rgw_bucket_prepare_op);
   cls_register_cxx_method(h_class, RGW_BUCKET_COMPLETE_OP, CLS_METHOD_RD | CLS_METHOD_WR, rgw_bucket_complete_op, &h_rgw_bucket_complete_op);
+  cls_register_cxx_method(h_class, RGW_BUCKET_BATCH_PREPARE_OP, CLS_METHOD_RD | CLS_METHOD_WR, rgw_bucket_batch_prepare_op, &h_rgw_bucket_batch_prepare_op);
+  cls_register_cxx_method(h_class, RGW_BUCKET_BATCH_COMPLETE_OP, CLS_METHOD_RD | CLS_METHOD_WR, rgw_bucket_batch_complete_op, &h_rgw_bucket_batch_complete_op);
   cls_register_cxx_method(h_class, RGW_BUCKET_LINK_OLH, CLS_METHOD_RD | CLS_METHOD_WR, rgw_bucket_link_olh, &h_rgw_bucket_link_olh);
   cls_register_cxx_method(h_class, RGW_BUCKET_UNLINK_INSTANCE, CLS_METHOD_RD | CLS_METHOD_WR, rgw_bucket_unlink_instance, &h_rgw_bucket_unlink_instance_op);
   cls_register_cxx_method(h_class, RGW_BUCKET_READ_OLH_LOG, CLS_METHOD_RD, rgw_bucket_read_olh_log, &h_rgw_bucket_read_olh_log);
@@ -191,6 +191,26 @@ void cls_rgw_bucket_complete_op(ObjectWriteOperation& o, RGWModifyOp op, string&
   o.exec(RGW_CLASS, RGW_BUCKET_COMPLETE_OP, in);
 }
 
+void cls_rgw_bucket_batch_prepare_op(ObjectWriteOperation& o,
+                                     list<rgw_cls_obj_prepare_op>& entries)
+{
+  struct rgw_cls_obj_batch_prepare_op call;
+  call.entries = entries;
+  bufferlist in;
+  ::encode(call, in);
+  o.exec(RGW_CLASS, RGW_BUCKET_BATCH_PREPARE_OP, in);
+}
+
+void cls_rgw_bucket_batch_complete_op(ObjectWriteOperation& o,
+                                      list<rgw_cls_obj_complete_op>& entries)
+{
+  struct rgw_cls_obj_batch_complete_op call;
+  call.entries = entries;
+  bufferlist in;
+  ::encode(call, in);
+  o.exec(RGW_CLASS, RGW_BUCKET_BATCH_COMPLETE_OP, in);
+}
+
 static bool issue_bucket_list_op(librados::IoCtx& io_ctx,
     const string& oid, const cls_rgw_obj_key& start_obj, const string& filter_prefix,
     uint32_t num_entries, bool list_versions, BucketIndexAioManager *manager,
@@ -319,6 +319,14 @@ void cls_rgw_bucket_complete_op(librados::ObjectWriteOperation& o, RGWModifyOp o
 				list<cls_rgw_obj_key> *remove_objs, bool log_op,
                                 uint16_t bilog_op, rgw_zone_set *zones_trace);
 
+/* batched variants: all entries are applied by the cls method in a single
+ * omap transaction, sharing one bucket header read/write */
+void cls_rgw_bucket_batch_prepare_op(librados::ObjectWriteOperation& o,
+                                     list<rgw_cls_obj_prepare_op>& entries);
+
+void cls_rgw_bucket_batch_complete_op(librados::ObjectWriteOperation& o,
+                                      list<rgw_cls_obj_complete_op>& entries);
+
 void cls_rgw_remove_obj(librados::ObjectWriteOperation& o, list<string>& keep_attr_prefixes);
 void cls_rgw_obj_store_pg_ver(librados::ObjectWriteOperation& o, const string& attr);
 void cls_rgw_obj_check_attrs_prefix(librados::ObjectOperation& o, const string& prefix, bool fail_if_exist);
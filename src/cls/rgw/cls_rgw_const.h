@@ -16,6 +16,8 @@
 #define RGW_BUCKET_UPDATE_STATS "bucket_update_stats"
 #define RGW_BUCKET_PREPARE_OP "bucket_prepare_op"
 #define RGW_BUCKET_COMPLETE_OP "bucket_complete_op"
+#define RGW_BUCKET_BATCH_PREPARE_OP "bucket_batch_prepare_op"
+#define RGW_BUCKET_BATCH_COMPLETE_OP "bucket_batch_complete_op"
 #define RGW_BUCKET_LINK_OLH "bucket_link_olh"
 #define RGW_BUCKET_UNLINK_INSTANCE "bucket_unlink_instance"
 #define RGW_BUCKET_READ_OLH_LOG "bucket_read_olh_log"
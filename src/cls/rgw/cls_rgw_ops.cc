@@ -150,6 +150,44 @@ void rgw_cls_obj_complete_op::dump(Formatter *f) const
   ::encode_json("zones_trace", zones_trace, f);
 }
 
+void rgw_cls_obj_batch_prepare_op::generate_test_instances(list<rgw_cls_obj_batch_prepare_op*>& o)
+{
+  rgw_cls_obj_batch_prepare_op *op = new rgw_cls_obj_batch_prepare_op;
+  list<rgw_cls_obj_prepare_op *> l;
+  rgw_cls_obj_prepare_op::generate_test_instances(l);
+  for (list<rgw_cls_obj_prepare_op *>::iterator iter = l.begin();
+       iter != l.end(); ++iter) {
+    op->entries.push_back(*(*iter));
+    delete *iter;
+  }
+  o.push_back(op);
+  o.push_back(new rgw_cls_obj_batch_prepare_op);
+}
+
+void rgw_cls_obj_batch_prepare_op::dump(Formatter *f) const
+{
+  ::encode_json("entries", entries, f);
+}
+
+void rgw_cls_obj_batch_complete_op::generate_test_instances(list<rgw_cls_obj_batch_complete_op*>& o)
+{
+  rgw_cls_obj_batch_complete_op *op = new rgw_cls_obj_batch_complete_op;
+  list<rgw_cls_obj_complete_op *> l;
+  rgw_cls_obj_complete_op::generate_test_instances(l);
+  for (list<rgw_cls_obj_complete_op *>::iterator iter = l.begin();
+       iter != l.end(); ++iter) {
+    op->entries.push_back(*(*iter));
+    delete *iter;
+  }
+  o.push_back(op);
+  o.push_back(new rgw_cls_obj_batch_complete_op);
+}
+
+void rgw_cls_obj_batch_complete_op::dump(Formatter *f) const
+{
+  ::encode_json("entries", entries, f);
+}
+
 void rgw_cls_link_olh_op::generate_test_instances(list<rgw_cls_link_olh_op*>& o)
 {
   rgw_cls_link_olh_op *op = new rgw_cls_link_olh_op;
@@ -162,6 +162,48 @@ struct rgw_cls_obj_complete_op
 };
 WRITE_CLASS_ENCODER(rgw_cls_obj_complete_op)
 
+struct rgw_cls_obj_batch_prepare_op
+{
+  list<rgw_cls_obj_prepare_op> entries;
+
+  rgw_cls_obj_batch_prepare_op() {}
+
+  void encode(bufferlist& bl) const {
+    ENCODE_START(1, 1, bl);
+    ::encode(entries, bl);
+    ENCODE_FINISH(bl);
+  }
+  void decode(bufferlist::iterator& bl) {
+    DECODE_START(1, bl);
+    ::decode(entries, bl);
+    DECODE_FINISH(bl);
+  }
+  void dump(Formatter *f) const;
+  static void generate_test_instances(list<rgw_cls_obj_batch_prepare_op*>& o);
+};
+WRITE_CLASS_ENCODER(rgw_cls_obj_batch_prepare_op)
+
+struct rgw_cls_obj_batch_complete_op
+{
+  list<rgw_cls_obj_complete_op> entries;
+
+  rgw_cls_obj_batch_complete_op() {}
+
+  void encode(bufferlist& bl) const {
+    ENCODE_START(1, 1, bl);
+    ::encode(entries, bl);
+    ENCODE_FINISH(bl);
+  }
+  void decode(bufferlist::iterator& bl) {
+    DECODE_START(1, bl);
+    ::decode(entries, bl);
+    DECODE_FINISH(bl);
+  }
+  void dump(Formatter *f) const;
+  static void generate_test_instances(list<rgw_cls_obj_batch_complete_op*>& o);
+};
+WRITE_CLASS_ENCODER(rgw_cls_obj_batch_complete_op)
+
 struct rgw_cls_link_olh_op {
   cls_rgw_obj_key key;
   string olh_tag;
@@ -357,6 +357,18 @@ struct rgw_bucket_dir_entry {
     DECODE_FINISH(bl);
   }
 
+  /// decode only what bucket accounting needs (name, epoch, exists,
+  /// meta) and skip pending_map and the versioning tail; noticeably
+  /// cheaper than a full decode when scanning a whole index shard.
+  void decode_summary(bufferlist::iterator &bl) {
+    DECODE_START_LEGACY_COMPAT_LEN(8, 3, 3, bl);
+    ::decode(key.name, bl);
+    ::decode(ver.epoch, bl);
+    ::decode(exists, bl);
+    ::decode(meta, bl);
+    DECODE_FINISH(bl);
+  }
+
   bool is_current() {
     int test_flags = RGW_BUCKET_DIRENT_FLAG_VER | RGW_BUCKET_DIRENT_FLAG_CURRENT;
     return (flags & RGW_BUCKET_DIRENT_FLAG_VER) == 0 ||
@@ -5,6 +5,7 @@
 #define CEPH_OS_BLUESTORE_CHECKSUMMER
 
 #include "xxHash/xxhash.h"
+#include "include/crc32c.h"
 
 class Checksummer {
 public:
@@ -86,6 +87,15 @@ public:
       ) {
       return p.crc32c(len, init_value);
     }
+    static value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *p
+      ) {
+      return ceph_crc32c(init_value,
+			 reinterpret_cast<const unsigned char*>(p), len);
+    }
   };
 
   struct crc32c_16 {
@@ -107,6 +117,16 @@ public:
       ) {
       return p.crc32c(len, init_value) & 0xffff;
     }
+    static value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *p
+      ) {
+      return ceph_crc32c(init_value,
+			 reinterpret_cast<const unsigned char*>(p),
+			 len) & 0xffff;
+    }
   };
 
   struct crc32c_8 {
@@ -128,6 +148,16 @@ public:
       ) {
       return p.crc32c(len, init_value) & 0xff;
     }
+    static value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *p
+      ) {
+      return ceph_crc32c(init_value,
+			 reinterpret_cast<const unsigned char*>(p),
+			 len) & 0xff;
+    }
   };
 
   struct xxhash32 {
@@ -157,6 +187,14 @@ public:
       }
       return XXH32_digest(state);
     }
+    static value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *p
+      ) {
+      return XXH32(p, len, init_value);
+    }
   };
 
   struct xxhash64 {
@@ -186,6 +224,14 @@ public:
       }
       return XXH64_digest(state);
     }
+    static value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *p
+      ) {
+      return XXH64(p, len, init_value);
+    }
   };
 
   template<class Alg>
@@ -249,6 +295,28 @@ public:
       reinterpret_cast<const typename Alg::value_t*>(csum_data.c_str());
     pv += offset / csum_block_size;
     size_t pos = offset;
+    if (bl.get_num_buffers() == 1) {
+      // contiguous data: checksum straight off the memory and skip the
+      // per-block iterator machinery.  reads almost always land here.
+      const char *data = bl.buffers().front().c_str();
+      while (length > 0) {
+	typename Alg::value_t v = Alg::calc(state, -1, csum_block_size,
+					    data);
+	if (*pv != v) {
+	  if (bad_csum) {
+	    *bad_csum = v;
+	  }
+	  Alg::fini(&state);
+	  return pos;
+	}
+	++pv;
+	data += csum_block_size;
+	pos += csum_block_size;
+	length -= csum_block_size;
+      }
+      Alg::fini(&state);
+      return -1;  // no errors
+    }
     while (length > 0) {
       typename Alg::value_t v = Alg::calc(state, -1, csum_block_size, p);
       if (*pv != v) {
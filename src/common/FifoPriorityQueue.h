@@ -0,0 +1,168 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * Copyright (C) 2004-2006 Sage Weil <sage@newdream.net>
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#ifndef FIFO_PRIORITY_QUEUE_H
+#define FIFO_PRIORITY_QUEUE_H
+
+#include "OpQueue.h"
+
+#include "common/Formatter.h"
+#include "include/assert.h"
+
+#include <array>
+#include <list>
+#include <utility>
+
+/**
+ * Strict-priority queue of per-priority FIFOs
+ *
+ * One FIFO per priority level plus a bitmap of non-empty levels, so
+ * enqueue and dequeue are O(1) and touch at most two cache lines of
+ * metadata -- unlike wpq/prio, which rebalance tree-based multimaps on
+ * every operation.  Always dequeues from the highest non-empty
+ * priority; there is no fairness between classes and no cost-based
+ * weighting, so a sustained stream of high-priority ops can starve
+ * lower priorities.  That makes it unsuitable as a general default but
+ * a useful upper-bound baseline and a reasonable choice when all ops
+ * are effectively one class.
+ */
+template <typename T, typename K>
+class FifoPriorityQueue : public OpQueue<T, K>
+{
+  static const unsigned max_prio = 255;
+
+  struct SubQueue {
+    std::array<std::list<std::pair<K, T>>, max_prio + 1> levels;
+    uint64_t bitmap[4] = { 0, 0, 0, 0 };
+    unsigned size = 0;
+
+    static unsigned clamp(unsigned priority) {
+      return priority > max_prio ? max_prio : priority;
+    }
+    void mark(unsigned p) {
+      bitmap[p >> 6] |= uint64_t(1) << (p & 63);
+    }
+    void unmark(unsigned p) {
+      bitmap[p >> 6] &= ~(uint64_t(1) << (p & 63));
+    }
+    /// highest non-empty priority; only valid if !empty()
+    unsigned highest() const {
+      for (int w = 3; w >= 0; --w) {
+	if (bitmap[w])
+	  return (w << 6) + 63 - __builtin_clzll(bitmap[w]);
+      }
+      ceph_abort();
+    }
+    bool empty() const {
+      return size == 0;
+    }
+    void enqueue(K cl, unsigned priority, T item, bool front) {
+      unsigned p = clamp(priority);
+      if (front)
+	levels[p].emplace_front(cl, std::move(item));
+      else
+	levels[p].emplace_back(cl, std::move(item));
+      mark(p);
+      ++size;
+    }
+    T dequeue() {
+      unsigned p = highest();
+      T ret = std::move(levels[p].front().second);
+      levels[p].pop_front();
+      if (levels[p].empty())
+	unmark(p);
+      --size;
+      return ret;
+    }
+    void remove_by_class(K k, std::list<T> *out) {
+      for (unsigned p = 0; p <= max_prio; ++p) {
+	auto& l = levels[p];
+	for (auto i = l.rbegin(); i != l.rend();) {
+	  if (i->first == k) {
+	    if (out)
+	      out->push_front(std::move(i->second));
+	    i = decltype(i)(l.erase(std::next(i).base()));
+	    --size;
+	  } else {
+	    ++i;
+	  }
+	}
+	if (l.empty())
+	  unmark(p);
+      }
+    }
+    void dump(ceph::Formatter *f) const {
+      f->dump_int("size", size);
+      f->open_array_section("levels");
+      for (unsigned p = 0; p <= max_prio; ++p) {
+	if (levels[p].empty())
+	  continue;
+	f->open_object_section("level");
+	f->dump_int("priority", p);
+	f->dump_int("size", levels[p].size());
+	f->close_section();
+      }
+      f->close_section();
+    }
+  };
+
+  SubQueue strict;
+  SubQueue normal;
+
+public:
+  FifoPriorityQueue(unsigned max_per, unsigned min_c)
+  {
+    // tokens/costs are ignored; parameters kept for symmetry with the
+    // other OpQueue constructors
+  }
+
+  unsigned length() const final {
+    return strict.size + normal.size;
+  }
+  void remove_by_class(K k, std::list<T> *out) final {
+    normal.remove_by_class(k, out);
+    strict.remove_by_class(k, out);
+  }
+  void enqueue_strict(K cl, unsigned priority, T item) final {
+    strict.enqueue(cl, priority, std::move(item), false);
+  }
+  void enqueue_strict_front(K cl, unsigned priority, T item) final {
+    strict.enqueue(cl, priority, std::move(item), true);
+  }
+  void enqueue(K cl, unsigned priority, unsigned cost, T item) final {
+    normal.enqueue(cl, priority, std::move(item), false);
+  }
+  void enqueue_front(K cl, unsigned priority, unsigned cost, T item) final {
+    normal.enqueue(cl, priority, std::move(item), true);
+  }
+  bool empty() const final {
+    return strict.empty() && normal.empty();
+  }
+  T dequeue() final {
+    assert(!empty());
+    if (!strict.empty())
+      return strict.dequeue();
+    return normal.dequeue();
+  }
+  void dump(ceph::Formatter *f) const final {
+    f->open_object_section("strict");
+    strict.dump(f);
+    f->close_section();
+    f->open_object_section("normal");
+    normal.dump(f);
+    f->close_section();
+  }
+};
+
+#endif
@@ -162,6 +162,11 @@ void JSONFormatter::print_comma(json_formatter_stack_entry_d& entry)
 void JSONFormatter::print_quoted_string(const std::string& s)
 {
   int len = escape_json_attr_len(s.c_str(), s.size());
+  if (len == (int)s.size() + 1) {
+    // no character needed escaping; skip the escape pass and the copy
+    m_ss << '\"' << s << '\"';
+    return;
+  }
   char escaped[len];
   escape_json_attr(s.c_str(), s.size(), escaped);
   m_ss << '\"' << escaped << '\"';
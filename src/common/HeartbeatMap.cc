@@ -69,13 +69,13 @@ bool HeartbeatMap::_check(const heartbeat_handle_d *h, const char *who, time_t n
   bool healthy = true;
   time_t was;
 
-  was = h->timeout;
+  was = h->timeout.load(std::memory_order_relaxed);
   if (was && was < now) {
     ldout(m_cct, 1) << who << " '" << h->name << "'"
 		    << " had timed out after " << h->grace << dendl;
     healthy = false;
   }
-  was = h->suicide_timeout;
+  was = h->suicide_timeout.load(std::memory_order_relaxed);
   if (was && was < now) {
     ldout(m_cct, 1) << who << " '" << h->name << "'"
 		    << " had suicide timed out after " << h->suicide_grace << dendl;
@@ -93,13 +93,16 @@ void HeartbeatMap::reset_timeout(heartbeat_handle_d *h, time_t grace, time_t sui
   time_t now = time(NULL);
   _check(h, "reset_timeout", now);
 
-  h->timeout = now + grace;
+  // workers call this for every item they process; a plain relaxed
+  // store is all the health checker needs (it only compares the value
+  // against the clock), so don't pay for a full barrier each time
+  h->timeout.store(now + grace, std::memory_order_relaxed);
   h->grace = grace;
 
   if (suicide_grace)
-    h->suicide_timeout = now + suicide_grace;
+    h->suicide_timeout.store(now + suicide_grace, std::memory_order_relaxed);
   else
-    h->suicide_timeout = 0;
+    h->suicide_timeout.store(0, std::memory_order_relaxed);
   h->suicide_grace = suicide_grace;
 }
 
@@ -108,8 +111,8 @@ void HeartbeatMap::clear_timeout(heartbeat_handle_d *h)
   ldout(m_cct, 20) << "clear_timeout '" << h->name << "'" << dendl;
   time_t now = time(NULL);
   _check(h, "clear_timeout", now);
-  h->timeout = 0;
-  h->suicide_timeout = 0;
+  h->timeout.store(0, std::memory_order_relaxed);
+  h->suicide_timeout.store(0, std::memory_order_relaxed);
 }
 
 bool HeartbeatMap::is_healthy()
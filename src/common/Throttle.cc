@@ -97,23 +97,27 @@ bool Throttle::_wait(int64_t c)
   if (_should_wait(c) || !cond.empty()) { // always wait behind other waiters.
     Cond *cv = new Cond;
     cond.push_back(cv);
-    waited = true;
+    ++waiters;
     ldout(cct, 2) << "_wait waiting..." << dendl;
     if (logger)
       start = ceph_clock_now();
 
-    do {
+    // re-check the condition before every sleep: the lock-free put path
+    // can return budget (and read our waiters increment) at any time
+    while (_should_wait(c) || cv != cond.front()) {
       cv->Wait(lock);
-    } while (_should_wait(c) || cv != cond.front());
+      waited = true;
+    }
 
     ldout(cct, 2) << "_wait finished waiting" << dendl;
-    if (logger) {
+    if (logger && waited) {
       utime_t dur = ceph_clock_now() - start;
       logger->tinc(l_throttle_wait, dur);
     }
 
     delete cv;
     cond.pop_front();
+    --waiters;
 
     // wake up the next guy
     if (!cond.empty())
@@ -144,10 +148,7 @@ int64_t Throttle::take(int64_t c)
   }
   assert(c >= 0);
   ldout(cct, 10) << "take " << c << dendl;
-  {
-    Mutex::Locker l(lock);
-    count += c;
-  }
+  count += c;
   if (logger) {
     logger->inc(l_throttle_take);
     logger->inc(l_throttle_take_sum, c);
@@ -168,7 +169,21 @@ bool Throttle::get(int64_t c, int64_t m)
     logger->inc(l_throttle_get_started);
   }
   bool waited = false;
-  {
+  // fast path: nobody queued and we stay under max; take the slot with
+  // a compare-exchange instead of the mutex
+  bool fast = false;
+  if (!m) {
+    while (waiters.load() == 0) {
+      unsigned cur = count.load();
+      if (_should_wait_for(cur, c))
+	break;
+      if (count.compare_exchange_weak(cur, cur + c)) {
+	fast = true;
+	break;
+      }
+    }
+  }
+  if (!fast) {
     Mutex::Locker l(lock);
     if (m) {
       assert(m > 0);
@@ -195,23 +210,36 @@ bool Throttle::get_or_fail(int64_t c)
   }
 
   assert (c >= 0);
-  Mutex::Locker l(lock);
-  if (_should_wait(c) || !cond.empty()) {
-    ldout(cct, 10) << "get_or_fail " << c << " failed" << dendl;
-    if (logger) {
-      logger->inc(l_throttle_get_or_fail_fail);
+  // lock-free: waiters always have priority (matching the old
+  // !cond.empty() check), otherwise take the slot with a
+  // compare-exchange or fail on the spot
+  while (true) {
+    if (waiters.load() != 0) {
+      ldout(cct, 10) << "get_or_fail " << c << " failed" << dendl;
+      if (logger) {
+	logger->inc(l_throttle_get_or_fail_fail);
+      }
+      return false;
     }
-    return false;
-  } else {
-    ldout(cct, 10) << "get_or_fail " << c << " success (" << count.load() << " -> " << (count.load() + c) << ")" << dendl;
-    count += c;
-    if (logger) {
-      logger->inc(l_throttle_get_or_fail_success);
-      logger->inc(l_throttle_get);
-      logger->inc(l_throttle_get_sum, c);
-      logger->set(l_throttle_val, count);
+    unsigned cur = count.load();
+    if (_should_wait_for(cur, c)) {
+      ldout(cct, 10) << "get_or_fail " << c << " failed" << dendl;
+      if (logger) {
+	logger->inc(l_throttle_get_or_fail_fail);
+      }
+      return false;
+    }
+    if (count.compare_exchange_weak(cur, cur + c)) {
+      ldout(cct, 10) << "get_or_fail " << c << " success (" << cur << " -> "
+		     << (cur + c) << ")" << dendl;
+      if (logger) {
+	logger->inc(l_throttle_get_or_fail_success);
+	logger->inc(l_throttle_get);
+	logger->inc(l_throttle_get_sum, c);
+	logger->set(l_throttle_val, count);
+      }
+      return true;
     }
-    return true;
   }
 }
 
@@ -223,17 +251,21 @@ int64_t Throttle::put(int64_t c)
 
   assert(c >= 0);
   ldout(cct, 10) << "put " << c << " (" << count.load() << " -> " << (count.load()-c) << ")" << dendl;
-  Mutex::Locker l(lock);
   if (c) {
-    if (!cond.empty())
-      cond.front()->SignalOne();
-    assert(static_cast<int64_t>(count) >= c); // if count goes negative, we failed somewhere!
-    count -= c;
+    unsigned old = count.fetch_sub(c);
+    assert(static_cast<int64_t>(old) >= c); // if count goes negative, we failed somewhere!
     if (logger) {
       logger->inc(l_throttle_put);
       logger->inc(l_throttle_put_sum, c);
       logger->set(l_throttle_val, count);
     }
+    // only touch the mutex when someone is actually waiting; _wait
+    // re-checks the count after our decrement, so this can't be missed
+    if (waiters.load() != 0) {
+      Mutex::Locker l(lock);
+      if (!cond.empty())
+	cond.front()->SignalOne();
+    }
   }
   return count;
 }
@@ -30,6 +30,9 @@ class Throttle {
   const std::string name;
   PerfCounters *logger;
   std::atomic<unsigned> count = { 0 }, max = { 0 };
+  // number of entries in cond; lets the uncontended get/put paths skip
+  // the mutex entirely (see Throttle.cc)
+  std::atomic<unsigned> waiters = { 0 };
   Mutex lock;
   list<Cond*> cond;
   const bool use_perf;
@@ -40,14 +43,16 @@ public:
 
 private:
   void _reset_max(int64_t m);
-  bool _should_wait(int64_t c) const {
+  bool _should_wait_for(int64_t cur, int64_t c) const {
     int64_t m = max;
-    int64_t cur = count;
     return
       m &&
       ((c <= m && cur + c > m) || // normally stay under max
        (c >= m && cur > m));     // except for large c
   }
+  bool _should_wait(int64_t c) const {
+    return _should_wait_for(count, c);
+  }
 
   bool _wait(int64_t c);
 
@@ -135,7 +135,7 @@ OpTracker::OpTracker(CephContext *cct_, bool tracking, uint32_t num_shards):
   num_optracker_shards(num_shards),
   complaint_time(0), log_threshold(0),
   tracking_enabled(tracking),
-  lock("OpTracker::lock"), cct(cct_) {
+  cct(cct_) {
     for (uint32_t i = 0; i < num_optracker_shards; i++) {
       char lock_name[32] = {0};
       snprintf(lock_name, sizeof(lock_name), "%s:%d", "OpTracker::ShardedLock", i);
@@ -154,7 +154,6 @@ OpTracker::~OpTracker() {
 
 bool OpTracker::dump_historic_ops(Formatter *f, bool by_duration)
 {
-  RWLock::RLocker l(lock);
   if (!tracking_enabled)
     return false;
 
@@ -191,7 +190,6 @@ void OpHistory::dump_slow_ops(utime_t now, Formatter *f)
 
 bool OpTracker::dump_historic_slow_ops(Formatter *f)
 {
-  RWLock::RLocker l(lock);
   if (!tracking_enabled)
     return false;
 
@@ -202,7 +200,6 @@ bool OpTracker::dump_historic_slow_ops(Formatter *f)
 
 bool OpTracker::dump_ops_in_flight(Formatter *f, bool print_only_blocked)
 {
-  RWLock::RLocker l(lock);
   if (!tracking_enabled)
     return false;
 
@@ -235,7 +232,6 @@ bool OpTracker::dump_ops_in_flight(Formatter *f, bool print_only_blocked)
 
 bool OpTracker::register_inflight_op(TrackedOp *i)
 {
-  RWLock::RLocker l(lock);
   if (!tracking_enabled)
     return false;
 
@@ -266,7 +262,6 @@ void OpTracker::unregister_inflight_op(TrackedOp *i)
   }
   i->_unregistered();
 
-  RWLock::RLocker l(lock);
   if (!tracking_enabled)
     delete i;
   else {
@@ -278,7 +273,6 @@ void OpTracker::unregister_inflight_op(TrackedOp *i)
 
 bool OpTracker::check_ops_in_flight(std::vector<string> &warning_vector, int *slow)
 {
-  RWLock::RLocker l(lock);
   if (!tracking_enabled)
     return false;
 
@@ -69,8 +69,7 @@ class OpTracker {
   OpHistory history;
   float complaint_time;
   int log_threshold;
-  bool tracking_enabled;
-  RWLock       lock;
+  std::atomic<bool> tracking_enabled;
 
 public:
   CephContext *cct;
@@ -86,8 +85,9 @@ public:
   void set_history_slow_op_size_and_threshold(uint32_t new_size, uint32_t new_threshold) {
     history.set_slow_op_size_and_threshold(new_size, new_threshold);
   }
+  // NB: a racing register/unregister may see the old value briefly;
+  // ops that straddle the toggle are handled by TrackedOp::state
   void set_tracking(bool enable) {
-    RWLock::WLocker l(lock);
     tracking_enabled = enable;
   }
   bool dump_ops_in_flight(Formatter *f, bool print_only_blocked=false);
@@ -85,6 +85,12 @@ public:
   void decode_footer(bufferlist::iterator& it);
   uint64_t get_footer_offset() const;
 
+  void encode_data_crcs(bufferlist& bl, uint64_t offset,
+                        uint64_t length) const;
+  void get_data_crcs_extents(uint64_t offset, uint64_t length,
+                             uint64_t *byte_offset,
+                             uint64_t *byte_length) const;
+
   void encode(bufferlist& bl) const;
   void decode(bufferlist::iterator& it);
   void dump(Formatter *f) const;
@@ -306,6 +312,45 @@ uint64_t BitVector<_b>::get_footer_offset() const {
   return get_header_length() + m_data.length();
 }
 
+template <uint8_t _b>
+void BitVector<_b>::encode_data_crcs(bufferlist& bl, uint64_t offset,
+				     uint64_t length) const {
+  if (!m_crc_enabled || length == 0) {
+    return;
+  }
+
+  uint64_t index;
+  uint64_t shift;
+  compute_index(offset, &index, &shift);
+  uint64_t crc_index = index / BLOCK_SIZE;
+
+  compute_index(offset + length - 1, &index, &shift);
+  uint64_t end_crc_index = index / BLOCK_SIZE;
+  while (crc_index <= end_crc_index) {
+    ::encode(m_data_crcs[crc_index++], bl);
+  }
+}
+
+template <uint8_t _b>
+void BitVector<_b>::get_data_crcs_extents(uint64_t offset, uint64_t length,
+					  uint64_t *byte_offset,
+					  uint64_t *byte_length) const {
+  // byte extent, relative to the start of the encoded footer, covering
+  // the CRCs for the affected data blocks
+  assert(length > 0 && offset + length <= m_size);
+  uint64_t index;
+  uint64_t shift;
+  compute_index(offset, &index, &shift);
+  uint64_t crc_index = index / BLOCK_SIZE;
+
+  compute_index(offset + length - 1, &index, &shift);
+  uint64_t end_crc_index = index / BLOCK_SIZE;
+
+  // 4 byte bl length, 4 byte header CRC, 4 byte CRC vector length
+  *byte_offset = 12 + (sizeof(__u32) * crc_index);
+  *byte_length = sizeof(__u32) * (end_crc_index - crc_index + 1);
+}
+
 template <uint8_t _b>
 void BitVector<_b>::encode(bufferlist& bl) const {
   encode_header(bl);
@@ -1918,14 +1918,37 @@ static std::atomic_flag buffer_debug_lock = ATOMIC_FLAG_INIT;
 
   void buffer::list::append(const ptr& bp)
   {
-    if (bp.length())
-      push_back(bp);
+    if (!bp.length())
+      return;
+    if (!_buffers.empty()) {
+      ptr &l = _buffers.back();
+      if (l.get_raw() == bp.get_raw() &&
+	  l.end() == bp.start()) {
+	// contiguous with tail bp: extend the existing node instead of
+	// adding (and later walking) another one for the same raw
+	l.set_length(l.length() + bp.length());
+	_len += bp.length();
+	return;
+      }
+    }
+    push_back(bp);
   }
 
   void buffer::list::append(ptr&& bp)
   {
-    if (bp.length())
-      push_back(std::move(bp));
+    if (!bp.length())
+      return;
+    if (!_buffers.empty()) {
+      ptr &l = _buffers.back();
+      if (l.get_raw() == bp.get_raw() &&
+	  l.end() == bp.start()) {
+	l.set_length(l.length() + bp.length());
+	_len += bp.length();
+	bp = ptr();
+	return;
+      }
+    }
+    push_back(std::move(bp));
   }
 
   void buffer::list::append(const ptr& bp, unsigned off, unsigned len)
@@ -20,6 +20,7 @@
 #include "common/perf_counters.h"
 #include "common/code_environment.h"
 #include "common/ceph_crypto.h"
+#include "common/Clock.h"
 #include "common/HeartbeatMap.h"
 #include "common/errno.h"
 #include "common/Graylog.h"
@@ -358,6 +359,12 @@ public:
   }
 };
 
+struct CephContext::PerfDumpCache {
+  utime_t stamp;
+  std::string format;
+  bufferlist bl;
+};
+
 void CephContext::do_command(std::string command, cmdmap_t& cmdmap,
 			     std::string format, bufferlist *out)
 {
@@ -376,7 +383,36 @@ void CephContext::do_command(std::string command, cmdmap_t& cmdmap,
     std::string counter;
     cmd_getval(this, cmdmap, "logger", logger);
     cmd_getval(this, cmdmap, "counter", counter);
-    _perf_counters_collection->dump_formatted(f, false, logger, counter);
+    double age = _conf->perf_dump_cache_age;
+    bool cached = false;
+    if (age > 0 && logger.empty() && counter.empty()) {
+      // serve frequent full dumps (e.g. a telemetry scraper) from a
+      // pre-serialized snapshot instead of reformatting the whole
+      // collection under its lock on every request
+      utime_t now = ceph_clock_now();
+      ceph_spin_lock(&_perf_dump_cache_lock);
+      if (_perf_dump_cache &&
+	  _perf_dump_cache->format == format &&
+	  now - _perf_dump_cache->stamp <= age) {
+	out->append(_perf_dump_cache->bl);
+	cached = true;
+      }
+      ceph_spin_unlock(&_perf_dump_cache_lock);
+      if (!cached) {
+	PerfDumpCache *c = new PerfDumpCache;
+	c->stamp = now;
+	c->format = format;
+	_perf_counters_collection->dump_formatted(f, false);
+	f->flush(c->bl);
+	out->append(c->bl);
+	ceph_spin_lock(&_perf_dump_cache_lock);
+	std::swap(c, _perf_dump_cache);
+	ceph_spin_unlock(&_perf_dump_cache_lock);
+	delete c;
+      }
+    } else {
+      _perf_counters_collection->dump_formatted(f, false, logger, counter);
+    }
   }
   else if (command == "perfcounters_schema" || command == "2" ||
     command == "perf schema") {
@@ -546,6 +582,7 @@ CephContext::CephContext(uint32_t module_type_, int init_flags_)
     _admin_socket(NULL),
     _perf_counters_collection(NULL),
     _perf_counters_conf_obs(NULL),
+    _perf_dump_cache(NULL),
     _heartbeat_map(NULL),
     _crypto_none(NULL),
     _crypto_aes(NULL),
@@ -559,6 +596,7 @@ CephContext::CephContext(uint32_t module_type_, int init_flags_)
   ceph_spin_init(&_fork_watchers_lock);
   ceph_spin_init(&_feature_lock);
   ceph_spin_init(&_cct_perf_lock);
+  ceph_spin_init(&_perf_dump_cache_lock);
 
   _log = new ceph::logging::Log(&_conf->subsys);
   _log->start();
@@ -650,6 +688,9 @@ CephContext::~CephContext()
   delete _perf_counters_collection;
   _perf_counters_collection = NULL;
 
+  delete _perf_dump_cache;
+  _perf_dump_cache = NULL;
+
   delete _perf_counters_conf_obs;
   _perf_counters_conf_obs = NULL;
 
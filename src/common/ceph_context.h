@@ -248,6 +248,12 @@ private:
 
   md_config_obs_t *_perf_counters_conf_obs;
 
+  /* pre-serialized 'perf dump' snapshot; built outside the lock and
+   * swapped in under it (see do_command) */
+  struct PerfDumpCache;
+  ceph_spinlock_t _perf_dump_cache_lock;
+  PerfDumpCache *_perf_dump_cache;
+
   CephContextHook *_admin_hook;
 
   ceph::HeartbeatMap *_heartbeat_map;
@@ -183,6 +183,7 @@ OPTION(heartbeat_interval, OPT_INT, 5)
 OPTION(heartbeat_file, OPT_STR, "")
 OPTION(heartbeat_inject_failure, OPT_INT, 0)    // force an unhealthy heartbeat for N seconds
 OPTION(perf, OPT_BOOL, true)       // enable internal perf counters
+OPTION(perf_dump_cache_age, OPT_DOUBLE, 0) // seconds an unfiltered 'perf dump' may be served from a pre-serialized snapshot; 0 = off
 
 SAFE_OPTION(ms_type, OPT_STR, "async+posix")   // messenger backend. It will be modified in runtime, so use SAFE_OPTION
 OPTION(ms_public_type, OPT_STR, "")   // messenger backend
@@ -193,6 +194,7 @@ OPTION(ms_tcp_prefetch_max_size, OPT_INT, 4096) // max prefetch size, we limit t
 OPTION(ms_initial_backoff, OPT_DOUBLE, .2)
 OPTION(ms_max_backoff, OPT_DOUBLE, 15.0)
 OPTION(ms_crc_data, OPT_BOOL, true)
+OPTION(ms_crc_data_deferred, OPT_BOOL, false) // verify data crc off the msgr thread (on dispatch or op dequeue)
 OPTION(ms_crc_header, OPT_BOOL, true)
 OPTION(ms_die_on_bad_msg, OPT_BOOL, false)
 OPTION(ms_die_on_unhandled_msg, OPT_BOOL, false)
@@ -216,6 +218,11 @@ OPTION(ms_rwthread_stack_bytes, OPT_U64, 1024 << 10)
 OPTION(ms_tcp_read_timeout, OPT_U64, 900)
 OPTION(ms_pq_max_tokens_per_priority, OPT_U64, 16777216)
 OPTION(ms_pq_min_cost, OPT_U64, 65536)
+// which queue to use for the (non-fast-dispatch) dispatch queue:
+// "prioritized" dequeues one message per connection per turn;
+// "wpq" round-robins connections weighted by message cost so a
+// flooding client cannot starve others at the same priority
+OPTION(ms_dispatch_queue_type, OPT_STR, "prioritized")
 OPTION(ms_inject_socket_failures, OPT_U64, 0)
 SAFE_OPTION(ms_inject_delay_type, OPT_STR, "")          // "osd mds mon client" allowed
 OPTION(ms_inject_delay_msg_type, OPT_STR, "")      // the type of message to delay, as returned by Message::get_type_name(). This is an additional restriction on the general type filter ms_inject_delay_type.
@@ -226,6 +233,13 @@ OPTION(ms_dump_on_send, OPT_BOOL, false)           // hexdump msg to log on send
 OPTION(ms_dump_corrupt_message_level, OPT_INT, 1)  // debug level to hexdump undecodeable messages at
 OPTION(ms_async_op_threads, OPT_U64, 3)            // number of worker processing threads for async messenger created on init
 OPTION(ms_async_max_op_threads, OPT_U64, 5)        // max number of worker processing threads for async messenger
+OPTION(ms_compress_on_wire, OPT_BOOL, false)       // compress message data payloads; all peers must run code that understands it
+OPTION(ms_compress_type, OPT_STR, "snappy")        // compressor plugin for outgoing payloads
+OPTION(ms_compress_min_size, OPT_U32, 4096)        // don't compress payloads smaller than this
+OPTION(ms_async_busy_poll_us, OPT_U64, 0)          // spin-poll the event center this many usec before blocking (0 = always block)
+OPTION(ms_async_send_batch_size, OPT_U64, 64*1024) // defer the sendmsg while more messages are queued and less than this many bytes are pending (0 = send per message)
+OPTION(ms_async_rx_buffer_pool_size, OPT_U32, 8)   // recycled rx payload buffers kept per worker (0 = disable pooling)
+OPTION(ms_async_rx_buffer_size, OPT_U32, 65536)    // minimum size of a pooled rx payload buffer
 OPTION(ms_async_set_affinity, OPT_BOOL, true)
 // example: ms_async_affinity_cores = 0,1
 // The number of coreset is expected to equal to ms_async_op_threads, otherwise
@@ -233,6 +247,11 @@ OPTION(ms_async_set_affinity, OPT_BOOL, true)
 // If ms_async_affinity_cores is empty, all threads will be bind to current running
 // core
 OPTION(ms_async_affinity_cores, OPT_STR, "")
+// Map each connection to a worker by hashing the peer address instead of
+// picking the least loaded worker.  Combined with ms_async_affinity_cores
+// and the NIC's RSS indirection table this keeps a flow's rx queue and
+// msgr worker on the same core.
+OPTION(ms_async_steer_connections, OPT_BOOL, false)
 OPTION(ms_async_rdma_device_name, OPT_STR, "")
 OPTION(ms_async_rdma_enable_hugepage, OPT_BOOL, false)
 OPTION(ms_async_rdma_buffer_size, OPT_INT, 128 << 10)
@@ -240,6 +259,7 @@ OPTION(ms_async_rdma_send_buffers, OPT_U32, 1024)
 OPTION(ms_async_rdma_receive_buffers, OPT_U32, 1024)
 OPTION(ms_async_rdma_port_num, OPT_U32, 1)
 OPTION(ms_async_rdma_polling_us, OPT_U32, 1000)
+OPTION(ms_async_rdma_dispatchers, OPT_U32, 1)      // number of cq polling threads; workers are sharded across them
 OPTION(ms_async_rdma_local_gid, OPT_STR, "")       // GID format: "fe80:0000:0000:0000:7efe:90ff:fe72:6efe", no zero folding
 OPTION(ms_async_rdma_roce_ver, OPT_INT, 1)         // 0=RoCEv1, 1=RoCEv2, 2=RoCEv1.5
 OPTION(ms_async_rdma_sl, OPT_INT, 3)               // in RoCE, this means PCP
@@ -445,6 +465,7 @@ OPTION(client_notify_timeout, OPT_INT, 10) // in seconds
 OPTION(osd_client_watch_timeout, OPT_INT, 30) // in seconds
 OPTION(client_caps_release_delay, OPT_INT, 5) // in seconds
 OPTION(client_quota_df, OPT_BOOL, true) // use quota for df on subdir mounts
+OPTION(client_quota_df_max_age, OPT_DOUBLE, 0) // serve quota df from cached rstats up to this many seconds old (0 = refresh every call)
 OPTION(client_oc, OPT_BOOL, true)
 OPTION(client_oc_size, OPT_INT, 1024*1024* 200)    // MB * n
 OPTION(client_oc_max_dirty, OPT_INT, 1024*1024* 100)    // MB * n  (dirty OR tx.. bigish)
@@ -465,6 +486,8 @@ OPTION(client_dirsize_rbytes, OPT_BOOL, true)
 // note: the max amount of "in flight" dirty data is roughly (max - target)
 OPTION(fuse_use_invalidate_cb, OPT_BOOL, true) // use fuse 2.8+ invalidate callback to keep page cache consistent
 OPTION(fuse_disable_pagecache, OPT_BOOL, false)
+OPTION(fuse_writeback_cache, OPT_BOOL, false) // ask the kernel for fuse writeback-cache mode (requires fuse_use_invalidate_cb for coherence)
+OPTION(fuse_auto_direct_io, OPT_BOOL, false)  // open files direct_io when the Fc cap is not held
 OPTION(fuse_allow_other, OPT_BOOL, true)
 OPTION(fuse_default_permissions, OPT_BOOL, false)
 OPTION(fuse_big_writes, OPT_BOOL, true)
@@ -511,6 +534,7 @@ OPTION(mds_cache_mid, OPT_FLOAT, .7)
 OPTION(mds_max_file_recover, OPT_U32, 32)
 OPTION(mds_dir_max_commit_size, OPT_INT, 10) // MB
 OPTION(mds_dir_keys_per_op, OPT_INT, 16384)
+OPTION(mds_dir_prefetch_siblings, OPT_BOOL, false) // fetch other frags of a fragmented dir alongside the one a traversal missed
 OPTION(mds_decay_halflife, OPT_FLOAT, 5)
 OPTION(mds_beacon_interval, OPT_FLOAT, 4)
 OPTION(mds_beacon_grace, OPT_FLOAT, 15)
@@ -524,6 +548,7 @@ OPTION(mds_session_blacklist_on_evict, OPT_BOOL, true)  // whether to blacklist
 OPTION(mds_sessionmap_keys_per_op, OPT_U32, 1024)    // how many sessions should I try to load/store in a single OMAP operation?
 OPTION(mds_revoke_cap_timeout, OPT_FLOAT, 60)    // detect clients which aren't revoking caps
 OPTION(mds_recall_state_timeout, OPT_FLOAT, 60)    // detect clients which aren't trimming caps
+OPTION(mds_recall_max_caps, OPT_INT, 30000)    // max caps to recall from a session in one RECALL_STATE message
 OPTION(mds_freeze_tree_timeout, OPT_FLOAT, 30)    // detecting freeze tree deadlock
 OPTION(mds_session_autoclose, OPT_FLOAT, 300) // autoclose idle session
 OPTION(mds_health_summarize_threshold, OPT_INT, 10) // collapse N-client health metrics to a single 'many'
@@ -538,6 +563,7 @@ OPTION(mds_early_reply, OPT_BOOL, true)
 OPTION(mds_default_dir_hash, OPT_INT, CEPH_STR_HASH_RJENKINS)
 OPTION(mds_log_pause, OPT_BOOL, false)
 OPTION(mds_log_skip_corrupt_events, OPT_BOOL, false)
+OPTION(mds_log_replay_batch, OPT_INT, 128)  // max decoded events applied per mds_lock hold during replay
 OPTION(mds_log_max_events, OPT_INT, -1)
 OPTION(mds_log_events_per_segment, OPT_INT, 1024)
 OPTION(mds_log_segment_size, OPT_INT, 0)  // segment size for mds log, default to default file_layout_t
@@ -567,6 +593,8 @@ OPTION(mds_bal_need_min, OPT_FLOAT, .8)       // take within this range of what
 OPTION(mds_bal_need_max, OPT_FLOAT, 1.2)
 OPTION(mds_bal_midchunk, OPT_FLOAT, .3)       // any sub bigger than this taken in full
 OPTION(mds_bal_minchunk, OPT_FLOAT, .001)     // never take anything smaller than this
+OPTION(mds_bal_export_cooldown, OPT_FLOAT, 30)  // seconds after importing a subtree before we'll move it again
+OPTION(mds_bal_export_cost_per_dentry, OPT_FLOAT, .0001) // estimated load it costs to migrate one dentry; skip exports not worth it
 OPTION(mds_bal_target_decay, OPT_DOUBLE, 10.0) // target decay half-life in MDSMap (2x larger is approx. 2x slower)
 OPTION(mds_replay_interval, OPT_FLOAT, 1.0) // time to wait before starting replay again
 OPTION(mds_shutdown_check, OPT_INT, 0)
@@ -730,6 +758,7 @@ OPTION(osd_pool_default_cache_max_evict_check_size, OPT_INT, 10)  // max size to
 OPTION(osd_hit_set_min_size, OPT_INT, 1000)  // min target size for a HitSet
 OPTION(osd_hit_set_max_size, OPT_INT, 100000)  // max target size for a HitSet
 OPTION(osd_hit_set_namespace, OPT_STR, ".ceph-internal") // rados namespace for hit_set tracking
+OPTION(osd_agent_read_freq_sketch_width, OPT_U64, 0) // per-row width of the read-frequency count-min sketch augmenting hit_set membership (0 = disabled)
 
 // conservative default throttling values
 OPTION(osd_tier_promote_max_objects_sec, OPT_U64, 25)
@@ -769,14 +798,20 @@ OPTION(osd_op_num_threads_per_shard_ssd, OPT_INT, 2)
 OPTION(osd_op_num_shards, OPT_INT, 0)
 OPTION(osd_op_num_shards_hdd, OPT_INT, 5)
 OPTION(osd_op_num_shards_ssd, OPT_INT, 8)
+// let an op shard thread with an empty queue process items from a
+// backlogged neighbor shard instead of sleeping
+OPTION(osd_op_shard_steal, OPT_BOOL, false)
 
 // PrioritzedQueue (prio), Weighted Priority Queue (wpq ; default),
 // mclock_opclass, mclock_client, or debug_random. "mclock_opclass"
 // and "mclock_client" are based on the mClock/dmClock algorithm
 // (Gulati, et al. 2010). "mclock_opclass" prioritizes based on the
 // class the operation belongs to. "mclock_client" does the same but
-// also works to ienforce fairness between clients. "debug_random"
-// chooses among all four with equal probability.
+// also works to ienforce fairness between clients. "fifo" is a
+// strict-priority queue of per-priority FIFOs with O(1) operations
+// but no fairness or cost weighting (benchmark baseline; can starve
+// low priorities). "debug_random" chooses among prio, wpq and the
+// mclock queues with equal probability.
 OPTION(osd_op_queue, OPT_STR, "wpq")
 
 OPTION(osd_op_queue_cut_off, OPT_STR, "low") // Min priority to go to strict queue. (low, high, debug_random)
@@ -804,6 +839,8 @@ OPTION(osd_ignore_stale_divergent_priors, OPT_BOOL, false) // do not assert on d
 // If set to true even after reading enough shards to
 // decode the object, any error will be reported.
 OPTION(osd_read_ec_check_for_errors, OPT_BOOL, false) // return error if any ec shard has an error
+OPTION(osd_ec_cost_aware_reads, OPT_BOOL, true) // weight ec recovery reads by crush distance to the shard
+OPTION(osd_ec_partial_reads, OPT_BOOL, true) // only read the data shards covering a sub-stripe read
 
 // Only use clone_overlap for recovery if there are fewer than
 // osd_recover_clone_overlap_limit entries in the overlap set
@@ -831,6 +868,7 @@ OPTION(osd_heartbeat_grace, OPT_INT, 20)
 OPTION(osd_heartbeat_min_peers, OPT_INT, 10)     // minimum number of peers
 OPTION(osd_heartbeat_use_min_delay_socket, OPT_BOOL, false) // prio the heartbeat tcp socket and set dscp as CS6 on it if true
 OPTION(osd_heartbeat_min_size, OPT_INT, 2000) // the minimum size of OSD heartbeat messages to send
+OPTION(osd_heartbeat_rtt_warn_ms, OPT_INT, 0) // warn if a peer's average ping RTT exceeds this many ms; 0 to disable
 
 // max number of parallel snap trims/pg
 OPTION(osd_pg_max_concurrent_snap_trims, OPT_U64, 2)
@@ -844,6 +882,7 @@ OPTION(osd_heartbeat_min_healthy_ratio, OPT_FLOAT, .33)
 OPTION(osd_mon_heartbeat_interval, OPT_INT, 30)  // (seconds) how often to ping monitor if no peers
 OPTION(osd_mon_report_interval_max, OPT_INT, 600)
 OPTION(osd_mon_report_interval_min, OPT_INT, 5)  // pg stats, failures, up_thru, boot.
+OPTION(osd_mgr_pg_stats_resync_interval, OPT_DOUBLE, 300) // periodically resend all pg stats to the mgr in case a changed-only report was lost
 OPTION(osd_mon_report_max_in_flight, OPT_INT, 2)  // max updates in flight
 OPTION(osd_beacon_report_interval, OPT_INT, 300)       // (second) how often to send beacon message to monitor
 OPTION(osd_pg_stat_report_interval_max, OPT_INT, 500)  // report pg stats for any given pg at least this often
@@ -856,12 +895,14 @@ OPTION(osd_recovery_delay_start, OPT_FLOAT, 0)
 OPTION(osd_recovery_max_active, OPT_U64, 3)
 OPTION(osd_recovery_max_single_start, OPT_U64, 1)
 OPTION(osd_recovery_max_chunk, OPT_U64, 8<<20)  // max size of push chunk
+OPTION(osd_recovery_max_chunks_in_flight, OPT_U64, 4)  // push chunks in flight per object and peer
 OPTION(osd_recovery_max_omap_entries_per_chunk, OPT_U64, 64000) // max number of omap entries per chunk; 0 to disable limit
 OPTION(osd_copyfrom_max_chunk, OPT_U64, 8<<20)   // max size of a COPYFROM chunk
 OPTION(osd_push_per_object_cost, OPT_U64, 1000)  // push cost per object
 OPTION(osd_max_push_cost, OPT_U64, 8<<20)  // max size of push message
 OPTION(osd_max_push_objects, OPT_U64, 10)  // max objects in single push op
 OPTION(osd_recovery_forget_lost_objects, OPT_BOOL, false)   // off for now
+OPTION(osd_recovery_cache_dont_need, OPT_BOOL, true) // hint that background recovery reads/writes should bypass the object store cache
 OPTION(osd_max_scrubs, OPT_INT, 1)
 OPTION(osd_scrub_during_recovery, OPT_BOOL, false) // Allow new scrubs to start while recovery is active on the OSD
 OPTION(osd_scrub_begin_hour, OPT_INT, 0)
@@ -896,6 +937,7 @@ OPTION(osd_kill_backfill_at, OPT_INT, 0)
 OPTION(osd_pg_epoch_persisted_max_stale, OPT_U32, 40) // make this < map_cache_size!
 
 OPTION(osd_min_pg_log_entries, OPT_U32, 3000)  // number of entries to keep in the pg log when trimming it
+OPTION(osd_pg_log_dups_tracked, OPT_U32, 3000) // how many versions back to track in order to detect duplicate ops; this spans trimmed log entries via compact dup entries
 OPTION(osd_max_pg_log_entries, OPT_U32, 10000) // max entries, say when degraded, before we trim
 OPTION(osd_force_recovery_pg_log_entries_factor, OPT_FLOAT, 1.3) // max entries factor before force recovery
 OPTION(osd_pg_log_trim_min, OPT_U32, 100)
@@ -936,6 +978,7 @@ OPTION(osd_failsafe_full_ratio, OPT_FLOAT, .97) // what % full makes an OSD "ful
 OPTION(osd_fast_fail_on_connection_refused, OPT_BOOL, true) // immediately mark OSDs as down once they refuse to accept connections
 
 OPTION(osd_pg_object_context_cache_count, OPT_INT, 64)
+OPTION(osd_object_context_cache_budget, OPT_INT, 0) // total object context cache entries across the whole OSD, split evenly among PGs; 0 = use osd_pg_object_context_cache_count per PG
 OPTION(osd_tracing, OPT_BOOL, false) // true if LTTng-UST tracepoints should be enabled
 OPTION(osd_function_tracing, OPT_BOOL, false) // true if function instrumentation should use LTTng
 
@@ -959,6 +1002,7 @@ OPTION(leveldb_compression, OPT_BOOL, true) // leveldb uses compression
 OPTION(leveldb_paranoid, OPT_BOOL, false) // leveldb paranoid flag
 OPTION(leveldb_log, OPT_STR, "/dev/null")  // enable leveldb log file
 OPTION(leveldb_compact_on_mount, OPT_BOOL, false)
+OPTION(leveldb_compact_queue_delay, OPT_FLOAT, 0) // seconds to pause between queued async compactions
 
 OPTION(kinetic_host, OPT_STR, "") // hostname or ip address of a kinetic drive to use
 OPTION(kinetic_port, OPT_INT, 8123) // port number of the kinetic drive
@@ -980,11 +1024,19 @@ OPTION(rocksdb_collect_compaction_stats, OPT_BOOL, false) //For rocksdb, this be
 OPTION(rocksdb_collect_extended_stats, OPT_BOOL, false) //For rocksdb, this behavior will be an overhead of 5%~10%, collected only rocksdb_perf is enabled.
 OPTION(rocksdb_collect_memory_stats, OPT_BOOL, false) //For rocksdb, this behavior will be an overhead of 5%~10%, collected only rocksdb_perf is enabled.
 OPTION(rocksdb_enable_rmrange, OPT_BOOL, false) // see https://github.com/facebook/rocksdb/blob/master/include/rocksdb/db.h#L253
+// map key prefixes onto column families, created at mkfs.  format:
+// "prefix[=cf options][;prefix...]", e.g. "M=write_buffer_size=33554432;P"
+OPTION(rocksdb_column_families, OPT_STR, "")
+OPTION(rocksdb_compact_queue_delay, OPT_FLOAT, 0) // seconds to pause between queued async compactions
 
 // rocksdb options that will be used for omap(if omap_backend is rocksdb)
 OPTION(filestore_rocksdb_options, OPT_STR, "")
 // rocksdb options that will be used in monstore
 OPTION(mon_rocksdb_options, OPT_STR, "write_buffer_size=33554432,compression=kNoCompression")
+// column families for the mon store, applied at mkfs; separates the
+// high-churn paxos/osdmap/logm prefixes so trimming one doesn't force
+// compaction of the others
+OPTION(mon_rocksdb_column_families, OPT_STR, "paxos;osdmap;logm")
 
 /**
  * osd_*_priority adjust the relative priority of client io, recovery io,
@@ -1040,7 +1092,9 @@ OPTION(osd_bench_max_block_size, OPT_U64, 64 << 20) // cap the block size at 64M
 OPTION(osd_bench_duration, OPT_U32, 30) // duration of 'osd bench', capped at 30s to avoid triggering timeouts
 
 OPTION(osd_blkin_trace_all, OPT_BOOL, false) // create a blkin trace for all osd requests
+OPTION(osd_blkin_trace_every_n, OPT_U64, 0) // additionally trace 1 in N osd requests (0 = off)
 OPTION(osdc_blkin_trace_all, OPT_BOOL, false) // create a blkin trace for all objecter requests
+OPTION(osdc_blkin_trace_every_n, OPT_U64, 0) // additionally trace 1 in N objecter requests (0 = off)
 
 OPTION(osd_discard_disconnected_ops, OPT_BOOL, true)
 
@@ -1053,6 +1107,7 @@ OPTION(bdev_inject_crash, OPT_INT, 0)  // if N>0, then ~ 1/N IOs will complete b
 OPTION(bdev_inject_crash_flush_delay, OPT_INT, 2) // wait N more seconds on flush
 OPTION(bdev_aio, OPT_BOOL, true)
 OPTION(bdev_aio_poll_ms, OPT_INT, 250)  // milliseconds
+OPTION(bdev_aio_poll, OPT_BOOL, false)  // burn a core busy-polling for completions
 OPTION(bdev_aio_max_queue_depth, OPT_INT, 1024)
 OPTION(bdev_aio_reap_max, OPT_INT, 16)
 OPTION(bdev_block_size, OPT_INT, 4096)
@@ -1161,6 +1216,7 @@ OPTION(bluestore_extent_map_inline_shard_prealloc_size, OPT_U32, 256)
 OPTION(bluestore_cache_trim_interval, OPT_DOUBLE, .2)
 OPTION(bluestore_cache_trim_max_skip_pinned, OPT_U32, 64) // skip this many onodes pinned in cache before we give up
 OPTION(bluestore_cache_type, OPT_STR, "2q")   // lru, 2q
+OPTION(bluestore_cache_shards, OPT_U32, 0)  // 0 -> follow the caller (e.g. osd_op_num_shards)
 OPTION(bluestore_2q_cache_kin_ratio, OPT_DOUBLE, .5)    // kin page slot size / max page slot size
 OPTION(bluestore_2q_cache_kout_ratio, OPT_DOUBLE, .5)   // number of kout page slot / total number of page slot
 OPTION(bluestore_cache_size, OPT_U64, 0)
@@ -1169,8 +1225,15 @@ OPTION(bluestore_cache_size_ssd, OPT_U64, 3*1024*1024*1024)
 OPTION(bluestore_cache_meta_ratio, OPT_DOUBLE, .01)
 OPTION(bluestore_cache_kv_ratio, OPT_DOUBLE, .99)
 OPTION(bluestore_cache_kv_max, OPT_U64, 512*1024*1024) // limit the maximum amount of cache for the kv store
+OPTION(bluestore_cache_autotune, OPT_BOOL, false) // rebalance meta/data cache split based on hit rates
+OPTION(bluestore_cache_autotune_interval, OPT_DOUBLE, 5) // seconds between rebalances
+OPTION(bluestore_cache_autotune_step, OPT_DOUBLE, .02)   // ratio shifted per rebalance
+OPTION(bluestore_cache_autotune_min_ratio, OPT_DOUBLE, .02) // floor for either share
 OPTION(bluestore_kvbackend, OPT_STR, "rocksdb")
-OPTION(bluestore_allocator, OPT_STR, "bitmap")     // stupid | bitmap
+OPTION(bluestore_allocator, OPT_STR, "bitmap")     // stupid | bitmap | hybrid
+OPTION(bluestore_hybrid_alloc_small_max, OPT_U64, 128*1024) // requests <= this hit the bitmap side
+OPTION(bluestore_hybrid_alloc_region_size, OPT_U64, 64*1024*1024) // carved per bitmap refill
+OPTION(bluestore_deferred_max_running, OPT_U32, 1) // deferred batches in flight per osr (>1 pipelines disjoint batches)
 OPTION(bluestore_freelist_blocks_per_key, OPT_INT, 128)
 OPTION(bluestore_bitmapallocator_blocks_per_zone, OPT_INT, 1024) // must be power of 2 aligned, e.g., 512, 1024, 2048...
 OPTION(bluestore_bitmapallocator_span_size, OPT_INT, 1024) // must be power of 2 aligned, e.g., 512, 1024, 2048...
@@ -1181,6 +1244,7 @@ OPTION(bluestore_fsck_on_mount_deep, OPT_BOOL, true)
 OPTION(bluestore_fsck_on_umount, OPT_BOOL, false)
 OPTION(bluestore_fsck_on_umount_deep, OPT_BOOL, true)
 OPTION(bluestore_fsck_on_mkfs, OPT_BOOL, true)
+OPTION(bluestore_fsck_deep_threads, OPT_INT, 4)  // workers doing data reads/csum checks in deep fsck
 OPTION(bluestore_fsck_on_mkfs_deep, OPT_BOOL, false)
 OPTION(bluestore_sync_submit_transaction, OPT_BOOL, false) // submit kv txn in queueing thread (not kv_sync_thread)
 OPTION(bluestore_throttle_bytes, OPT_U64, 64*1024*1024)
@@ -1195,6 +1259,7 @@ OPTION(bluestore_nid_prealloc, OPT_INT, 1024)
 OPTION(bluestore_blobid_prealloc, OPT_U64, 10240)
 OPTION(bluestore_clone_cow, OPT_BOOL, true)  // do copy-on-write for clones
 OPTION(bluestore_default_buffered_read, OPT_BOOL, true)
+OPTION(bluestore_cache_hugepage_buffers, OPT_BOOL, false) // copy cache-admitted read buffers into hugepage-backed slabs
 OPTION(bluestore_default_buffered_write, OPT_BOOL, false)
 OPTION(bluestore_debug_misc, OPT_BOOL, false)
 OPTION(bluestore_debug_no_reuse_blocks, OPT_BOOL, false)
@@ -1229,6 +1294,8 @@ OPTION(filestore_omap_backend_path, OPT_STR, "")
 
 /// filestore wb throttle limits
 OPTION(filestore_wbthrottle_enable, OPT_BOOL, true)
+OPTION(filestore_wbthrottle_adaptive, OPT_BOOL, false) // scale the limits below by flush latency feedback
+OPTION(filestore_wbthrottle_adaptive_target_lat, OPT_DOUBLE, .05) // target per-inode flush latency (seconds)
 OPTION(filestore_wbthrottle_btrfs_bytes_start_flusher, OPT_U64, 41943040)
 OPTION(filestore_wbthrottle_btrfs_bytes_hard_limit, OPT_U64, 419430400)
 OPTION(filestore_wbthrottle_btrfs_ios_start_flusher, OPT_U64, 500)
@@ -1374,6 +1441,7 @@ OPTION(journal_throttle_max_multiple, OPT_DOUBLE, 0)
 
 OPTION(journal_align_min_size, OPT_INT, 64 << 10)  // align data payloads >= this.
 OPTION(journal_replay_from, OPT_INT, 0)
+OPTION(journal_replay_readahead, OPT_U64, 16) // entries to read+validate ahead of apply during replay (0 = serial)
 OPTION(journal_zero_on_create, OPT_BOOL, false)
 OPTION(journal_ignore_corruption, OPT_BOOL, false) // assume journal is not corrupt
 OPTION(journal_discard, OPT_BOOL, false) //using ssd disk as journal, whether support discard nouse journal-data.
@@ -1387,6 +1455,7 @@ OPTION(rados_tracing, OPT_BOOL, false) // true if LTTng-UST tracepoints should b
 OPTION(rbd_op_threads, OPT_INT, 1)
 OPTION(rbd_op_thread_timeout, OPT_INT, 60)
 OPTION(rbd_non_blocking_aio, OPT_BOOL, true) // process AIO ops from a worker thread to prevent blocking
+OPTION(rbd_aio_inline_dispatch, OPT_BOOL, false) // issue AIO inline from the caller thread when nothing blocks it; callers must tolerate completion callbacks from their own threads
 OPTION(rbd_cache, OPT_BOOL, true) // whether to enable caching (writeback unless rbd_cache_max_dirty is 0)
 OPTION(rbd_cache_writethrough_until_flush, OPT_BOOL, true) // whether to make writeback caching writethrough until flush is called, to be sure the user of librbd will send flushs so that writeback is safe
 OPTION(rbd_cache_size, OPT_LONGLONG, 32<<20)         // cache size in bytes
@@ -1395,13 +1464,19 @@ OPTION(rbd_cache_target_dirty, OPT_LONGLONG, 16<<20) // target dirty limit in by
 OPTION(rbd_cache_max_dirty_age, OPT_FLOAT, 1.0)      // seconds in cache before writeback starts
 OPTION(rbd_cache_max_dirty_object, OPT_INT, 0)       // dirty limit for objects - set to 0 for auto calculate from rbd_cache_size
 OPTION(rbd_cache_block_writes_upfront, OPT_BOOL, false) // whether to block writes to the cache before the aio_write call completes (true), or block before the aio completion is called (false)
+OPTION(rbd_image_cache, OPT_BOOL, false) // whether to enable the persistent write-back image cache
+OPTION(rbd_image_cache_path, OPT_STR, "/tmp") // local directory (NVMe/pmem) holding the image cache write logs
+OPTION(rbd_image_cache_log_max_bytes, OPT_LONGLONG, 1<<30) // write log size triggering write-back to the cluster
 OPTION(rbd_concurrent_management_ops, OPT_INT, 10) // how many operations can be in flight for a management operation like deleting or resizing an image
+OPTION(rbd_concurrent_copyups, OPT_INT, 0) // how many object copy-ups from the parent image can be in flight (0 = unlimited)
+OPTION(rbd_copyup_coalesce_objects, OPT_INT, 4) // maximum number of adjacent objects whose deferred copy-ups share a single parent read (requires rbd_concurrent_copyups)
 OPTION(rbd_balance_snap_reads, OPT_BOOL, false)
 OPTION(rbd_localize_snap_reads, OPT_BOOL, false)
 OPTION(rbd_balance_parent_reads, OPT_BOOL, false)
 OPTION(rbd_localize_parent_reads, OPT_BOOL, true)
 OPTION(rbd_readahead_trigger_requests, OPT_INT, 10) // number of sequential requests necessary to trigger readahead
 OPTION(rbd_readahead_max_bytes, OPT_LONGLONG, 512 * 1024) // set to 0 to disable readahead
+OPTION(rbd_readahead_buffer_bytes, OPT_LONGLONG, 0) // buffer for staging speculative reads when the cache is disabled (0 = no native readahead)
 OPTION(rbd_readahead_disable_after_bytes, OPT_LONGLONG, 50 * 1024 * 1024) // how many bytes are read in total before readahead is disabled
 OPTION(rbd_clone_copy_on_read, OPT_BOOL, false)
 OPTION(rbd_blacklist_on_break_lock, OPT_BOOL, true) // whether to blacklist clients whose lock was broken
@@ -1414,6 +1489,7 @@ OPTION(rbd_blkin_trace_all, OPT_BOOL, false) // create a blkin trace for all RBD
 OPTION(rbd_validate_pool, OPT_BOOL, true) // true if empty pools should be validated for RBD compatibility
 OPTION(rbd_validate_names, OPT_BOOL, true) // true if image specs should be validated
 OPTION(rbd_auto_exclusive_lock_until_manual_request, OPT_BOOL, true) // whether to automatically acquire/release exclusive lock until it is explicitly requested, i.e. before we know the user of librbd is properly using the lock API
+OPTION(rbd_exclusive_lock_min_hold_seconds, OPT_DOUBLE, 0) // minimum time to hold the exclusive lock before honoring a non-forced transfer request, to dampen lock ping-pong between clients alternating I/O on one image (0 = release immediately)
 OPTION(rbd_mirroring_resync_after_disconnect, OPT_BOOL, false) // automatically start image resync after mirroring is disconnected due to being laggy
 OPTION(rbd_mirroring_replay_delay, OPT_INT, 0) // time-delay in seconds for rbd-mirror asynchronous replication
 
@@ -1471,7 +1547,7 @@ OPTION(rbd_journal_splay_width, OPT_U32, 4) // number of active journal objects
 OPTION(rbd_journal_commit_age, OPT_DOUBLE, 5) // commit time interval, seconds
 OPTION(rbd_journal_object_flush_interval, OPT_INT, 0) // maximum number of pending commits per journal object
 OPTION(rbd_journal_object_flush_bytes, OPT_INT, 0) // maximum number of pending bytes per journal object
-OPTION(rbd_journal_object_flush_age, OPT_DOUBLE, 0) // maximum age (in seconds) for pending commits
+OPTION(rbd_journal_object_flush_age, OPT_DOUBLE, 0) // maximum age (in seconds) for pending commits; non-zero enables append batching bounded by this latency
 OPTION(rbd_journal_pool, OPT_STR, "") // pool for journal objects
 OPTION(rbd_journal_max_payload_bytes, OPT_U32, 16384) // maximum journal payload size before splitting
 OPTION(rbd_journal_max_concurrent_object_sets, OPT_INT, 0) // maximum number of object sets a journal client can be behind before it is automatically unregistered
@@ -1528,6 +1604,7 @@ OPTION(rgw_data, OPT_STR, "/var/lib/ceph/radosgw/$cluster-$id")
 OPTION(rgw_enable_apis, OPT_STR, "s3, s3website, swift, swift_auth, admin")
 OPTION(rgw_cache_enabled, OPT_BOOL, true)   // rgw cache enabled
 OPTION(rgw_cache_lru_size, OPT_INT, 10000)   // num of entries in rgw cache
+OPTION(rgw_cache_notify_interval_msec, OPT_INT, 0)  // coalesce cache invalidation notifies for up to this long, 0 sends each one immediately. enable only once all radosgw instances understand batched notifies
 OPTION(rgw_socket_path, OPT_STR, "")   // path to unix domain socket, if not specified, rgw will not run as external fcgi
 OPTION(rgw_host, OPT_STR, "")  // host for radosgw, can be an IP, default is 0.0.0.0
 OPTION(rgw_port, OPT_STR, "")  // port to listen, format as "8080" "5000", if not specified, rgw will not run external fcgi
@@ -1563,6 +1640,7 @@ OPTION(rgw_keystone_api_version, OPT_INT, 2) // Version of Keystone API to use (
 OPTION(rgw_keystone_accepted_roles, OPT_STR, "Member, admin")  // roles required to serve requests
 OPTION(rgw_keystone_accepted_admin_roles, OPT_STR, "") // list of roles allowing an user to gain admin privileges
 OPTION(rgw_keystone_token_cache_size, OPT_INT, 10000)  // max number of entries in keystone token cache
+OPTION(rgw_keystone_token_cache_negative_ttl, OPT_INT, 10)  // seconds to remember tokens keystone rejected (0 = off)
 OPTION(rgw_keystone_revocation_interval, OPT_INT, 15 * 60)  // seconds between tokens revocation check
 OPTION(rgw_keystone_verify_ssl, OPT_BOOL, true) // should we try to verify keystone's ssl
 OPTION(rgw_keystone_implicit_tenants, OPT_BOOL, false)  // create new users in their own tenants of the same name
@@ -1657,6 +1735,8 @@ OPTION(rgw_gc_max_objs, OPT_INT, 32)
 OPTION(rgw_gc_obj_min_wait, OPT_INT, 2 * 3600)    // wait time before object may be handled by gc
 OPTION(rgw_gc_processor_max_time, OPT_INT, 3600)  // total run time for a single gc processor work
 OPTION(rgw_gc_processor_period, OPT_INT, 3600)  // gc processor cycle time
+OPTION(rgw_gc_processor_threads, OPT_INT, 1)  // number of concurrent gc worker threads
+OPTION(rgw_gc_max_concurrent_io, OPT_INT, 10)  // max concurrent object removals per gc worker
 OPTION(rgw_s3_success_create_obj_status, OPT_INT, 0) // alternative success status response for create-obj (0 - default)
 OPTION(rgw_resolve_cname, OPT_BOOL, false)  // should rgw try to resolve hostname as a dns cname record
 OPTION(rgw_obj_stripe_size, OPT_INT, 4 << 20)
@@ -1720,6 +1800,7 @@ OPTION(rgw_md_notify_interval_msec, OPT_INT, 200) // metadata changes notificati
 OPTION(rgw_run_sync_thread, OPT_BOOL, true) // whether radosgw (not radosgw-admin) spawns the sync thread
 OPTION(rgw_sync_lease_period, OPT_INT, 120) // time in second for lease that rgw takes on a specific log (or log shard)
 OPTION(rgw_sync_log_trim_interval, OPT_INT, 1200) // time in seconds between attempts to trim sync logs
+OPTION(rgw_data_sync_spawn_window, OPT_INT, 20) // max concurrent entries applied per data sync log shard
 
 OPTION(rgw_sync_data_inject_err_probability, OPT_DOUBLE, 0) // range [0, 1]
 OPTION(rgw_sync_meta_inject_err_probability, OPT_DOUBLE, 0) // range [0, 1]
@@ -1790,3 +1871,10 @@ OPTION(rgw_reshard_bucket_lock_duration, OPT_INT, 120) // duration of lock on bu
 OPTION(rgw_dynamic_resharding, OPT_BOOL, true)
 OPTION(rgw_max_objs_per_shard, OPT_INT, 100000)
 OPTION(rgw_reshard_thread_interval, OPT_U32, 60 * 10) // maximum time between rounds of reshard thread processing
+
+/* request admission control (QoS) tunables */
+OPTION(rgw_qos_user_ops_rate, OPT_INT, 0) // sustained ops/sec admitted per user (0 = unlimited)
+OPTION(rgw_qos_user_ops_burst, OPT_INT, 0) // per-user burst size in ops (0 = same as rate)
+OPTION(rgw_qos_bucket_ops_rate, OPT_INT, 0) // sustained ops/sec admitted per bucket (0 = unlimited)
+OPTION(rgw_qos_bucket_ops_burst, OPT_INT, 0) // per-bucket burst size in ops (0 = same as rate)
+OPTION(rgw_qos_cache_size, OPT_INT, 10000) // number of token buckets kept before purging idle ones
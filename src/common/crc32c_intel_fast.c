@@ -1,3 +1,4 @@
+#include <string.h>
 #include "acconfig.h"
 #include "common/crc32c_intel_baseline.h"
 
@@ -6,6 +7,32 @@ extern unsigned int crc32_iscsi_zero_00(unsigned char const *buffer, int len, un
 
 #ifdef HAVE_GOOD_YASM_ELF64
 
+/*
+ * this is only ever called when the runtime probe found SSE4.2, so we
+ * can use the crc32 instruction here even though the rest of the file
+ * is compiled without -msse4.2.  it covers the short buffers and
+ * unaligned tails that are not worth handing to the assembly, which
+ * previously fell back to the software table loop.
+ */
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hw_small(uint32_t crc, unsigned char const *buffer,
+				unsigned len)
+{
+	while (len >= 8) {
+		uint64_t v;
+		memcpy(&v, buffer, 8);
+		crc = (uint32_t)__builtin_ia32_crc32di(crc, v);
+		buffer += 8;
+		len -= 8;
+	}
+	while (len) {
+		crc = __builtin_ia32_crc32qi(crc, *buffer);
+		buffer++;
+		len--;
+	}
+	return crc;
+}
+
 uint32_t ceph_crc32c_intel_fast(uint32_t crc, unsigned char const *buffer, unsigned len)
 {
 	uint32_t v;
@@ -22,12 +49,12 @@ uint32_t ceph_crc32c_intel_fast(uint32_t crc, unsigned char const *buffer, unsig
 	 * that.
 	 */
 	if (len < 16)
-		return ceph_crc32c_intel_baseline(crc, buffer, len);
+		return crc32c_hw_small(crc, buffer, len);
 	left = ((unsigned long)buffer + len) & 7;
 	len -= left;
 	v = crc32_iscsi_00(buffer, len, crc);
 	if (left)
-		v = ceph_crc32c_intel_baseline(v, buffer + len, left);
+		v = crc32c_hw_small(v, buffer + len, left);
 	return v;
 }
 
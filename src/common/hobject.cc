@@ -153,6 +153,89 @@ void hobject_t::decode(bufferlist::iterator& bl)
   build_hash_cache();
 }
 
+void hobject_t::bound_encode(size_t& p) const
+{
+  DENC_START(4, 3, p);
+  denc(key, p);
+  denc(oid, p);
+  denc(snap, p);
+  denc(hash, p);
+  denc(max, p);
+  denc(nspace, p);
+  denc(pool, p);
+  DENC_FINISH(p);
+}
+
+void hobject_t::encode(bufferlist::contiguous_appender& p) const
+{
+  DENC_START(4, 3, p);
+  denc(key, p);
+  denc(oid, p);
+  denc(snap, p);
+  denc(hash, p);
+  denc(max, p);
+  denc(nspace, p);
+  denc(pool, p);
+  assert(!max || (*this == hobject_t(hobject_t::get_max())));
+  DENC_FINISH(p);
+}
+
+void hobject_t::decode(buffer::ptr::iterator& p)
+{
+  // decoded by hand so we can cope with the pre-header (struct_v < 3)
+  // encodings the way DECODE_START_LEGACY_COMPAT_LEN does
+  __u8 struct_v;
+  denc(struct_v, p);
+  uint32_t struct_len = 0;
+  const char *start_pos = nullptr;
+  if (struct_v >= 3) {
+    __u8 struct_compat;
+    denc(struct_compat, p);
+    if (struct_compat > 4)
+      throw buffer::malformed_input("hobject_t: unsupported struct_compat");
+    denc(struct_len, p);
+    start_pos = p.get_pos();
+  }
+  if (struct_v >= 1)
+    denc(key, p);
+  denc(oid, p);
+  denc(snap, p);
+  denc(hash, p);
+  if (struct_v >= 2)
+    denc(max, p);
+  else
+    max = false;
+  if (struct_v >= 4) {
+    denc(nspace, p);
+    denc(pool, p);
+    // for compat with hammer, which did not handle the transition
+    // from pool -1 -> pool INT64_MIN for MIN properly.  this object
+    // name looks a bit like a pgmeta object for the meta collection,
+    // but those do not ever exist (and is_pgmeta() pool >= 0).
+    if (pool == -1 &&
+	snap == 0 &&
+	hash == 0 &&
+	!max &&
+	oid.name.empty()) {
+      pool = INT64_MIN;
+      assert(is_min());
+    }
+
+    // for compatibility with some earlier verisons which might encoded
+    // a non-canonical max object
+    if (max) {
+      *this = hobject_t::get_max();
+    }
+  }
+  if (struct_v >= 3) {
+    const char *end = start_pos + struct_len;
+    assert(p.get_pos() <= end);
+    if (p.get_pos() < end)
+      p.advance(end - p.get_pos());
+  }
+  build_hash_cache();
+}
+
 void hobject_t::decode(json_spirit::Value& v)
 {
   using namespace json_spirit;
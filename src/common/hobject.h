@@ -276,6 +276,16 @@ public:
   void encode(bufferlist& bl) const;
   void decode(bufferlist::iterator& bl);
   void decode(json_spirit::Value& v);
+
+  // denc variants; these are what ::encode()/::decode() of a bare
+  // hobject_t dispatch to, so per-object keys are sized once and
+  // written in a single contiguous pass.  Keep them in sync with the
+  // classic methods above.
+  DENC_HELPERS
+  void bound_encode(size_t& p) const;
+  void encode(bufferlist::contiguous_appender& p) const;
+  void decode(buffer::ptr::iterator& p);
+
   void dump(Formatter *f) const;
   static void generate_test_instances(list<hobject_t*>& o);
   friend int cmp(const hobject_t& l, const hobject_t& r);
@@ -295,7 +305,26 @@ public:
   friend bool operator!=(const hobject_t&, const hobject_t&);
   friend struct ghobject_t;
 };
-WRITE_CLASS_ENCODER(hobject_t)
+
+// spelled out instead of WRITE_CLASS_DENC: the retained legacy decode
+// member would otherwise flip need_contiguous off and send the glue
+// down a path these traits do not implement
+template<>
+struct denc_traits<hobject_t> {
+  static constexpr bool supported = true;
+  static constexpr bool featured = false;
+  static constexpr bool bounded = false;
+  static constexpr bool need_contiguous = true;
+  static void bound_encode(const hobject_t& o, size_t& p) {
+    o.bound_encode(p);
+  }
+  static void encode(const hobject_t& o, buffer::list::contiguous_appender& p) {
+    o.encode(p);
+  }
+  static void decode(hobject_t& o, buffer::ptr::iterator& p) {
+    o.decode(p);
+  }
+};
 
 namespace std {
   template<> struct hash<hobject_t> {
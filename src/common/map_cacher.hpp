@@ -41,6 +41,58 @@ public:
   virtual ~Transaction() {}
 };
 
+/**
+ * Coalesces updates against a wrapped Transaction, issuing at most one
+ * set_keys and one remove_keys on flush().  A later operation on a key
+ * supersedes an earlier one, so flushing yields the same final state as
+ * applying the operations in order.  Reads are unaffected; pending
+ * values remain visible through the MapCacher registry as usual.
+ */
+template<typename K, typename V>
+class BatchTransaction : public Transaction<K, V> {
+  Transaction<K, V> *t;
+  std::map<K, boost::optional<V> > buffered;
+public:
+  explicit BatchTransaction(Transaction<K, V> *t) : t(t) {}
+  void set_keys(
+    const std::map<K, V> &keys) override {
+    for (typename std::map<K, V>::const_iterator i = keys.begin();
+	 i != keys.end();
+	 ++i)
+      buffered[i->first] = i->second;
+  }
+  void remove_keys(
+    const std::set<K> &to_remove) override {
+    for (typename std::set<K>::const_iterator i = to_remove.begin();
+	 i != to_remove.end();
+	 ++i)
+      buffered[*i] = boost::none;
+  }
+  void add_callback(
+    Context *c) override {
+    t->add_callback(c);
+  }
+  /// Push the coalesced updates into the wrapped transaction
+  void flush() {
+    std::map<K, V> to_set;
+    std::set<K> to_remove;
+    for (typename std::map<K, boost::optional<V> >::iterator i =
+	   buffered.begin();
+	 i != buffered.end();
+	 ++i) {
+      if (i->second)
+	to_set.insert(make_pair(i->first, i->second.get()));
+      else
+	to_remove.insert(i->first);
+    }
+    if (!to_remove.empty())
+      t->remove_keys(to_remove);
+    if (!to_set.empty())
+      t->set_keys(to_set);
+    buffered.clear();
+  }
+};
+
 /**
  * Abstraction for fetching keys
  */
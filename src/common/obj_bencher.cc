@@ -20,6 +20,8 @@
 #include "common/Cond.h"
 #include "obj_bencher.h"
 
+#include <algorithm>
+
 const std::string BENCH_LASTRUN_METADATA = "benchmark_last_metadata";
 const std::string BENCH_PREFIX = "benchmark_data";
 static char cached_hostname[30] = {0};
@@ -344,6 +346,20 @@ static T vec_stddev(vector<T>& v)
   return sqrt(stddev);
 }
 
+// nearest-rank percentile over the recorded per-op values; takes the
+// vector by value since it reorders it, which is fine at summary time
+template<class T>
+static T vec_percentile(vector<T> v, double centile)
+{
+  if (v.empty())
+    return 0;
+  size_t rank = (size_t)(centile * v.size() / 100);
+  if (rank >= v.size())
+    rank = v.size() - 1;
+  std::nth_element(v.begin(), v.begin() + rank, v.end());
+  return v[rank];
+}
+
 int ObjBencher::fetch_bench_metadata(const std::string& metadata_file,
 				     uint64_t *op_size, uint64_t* object_size,
 				     int* num_objects, int* prevPid) {
@@ -575,6 +591,10 @@ int ObjBencher::write_bench(int secondsToRun,
        << "Min IOPS:               " << data.idata.min_iops << std::endl
        << "Average Latency(s):     " << data.avg_latency << std::endl
        << "Stddev Latency(s):      " << vec_stddev(data.history.latency) << std::endl
+       << "Latency p50(s):         " << vec_percentile(data.history.latency, 50) << std::endl
+       << "Latency p95(s):         " << vec_percentile(data.history.latency, 95) << std::endl
+       << "Latency p99(s):         " << vec_percentile(data.history.latency, 99) << std::endl
+       << "Latency p99.9(s):       " << vec_percentile(data.history.latency, 99.9) << std::endl
        << "Max latency(s):         " << data.max_latency << std::endl
        << "Min latency(s):         " << data.min_latency << std::endl;
   } else {
@@ -592,6 +612,10 @@ int ObjBencher::write_bench(int secondsToRun,
     formatter->dump_format("min_iops", "%d", data.idata.min_iops);
     formatter->dump_format("average_latency", "%f", data.avg_latency);
     formatter->dump_format("stddev_latency", "%f", vec_stddev(data.history.latency));
+    formatter->dump_format("latency_p50", "%f", vec_percentile(data.history.latency, 50));
+    formatter->dump_format("latency_p95", "%f", vec_percentile(data.history.latency, 95));
+    formatter->dump_format("latency_p99", "%f", vec_percentile(data.history.latency, 99));
+    formatter->dump_format("latency_p999", "%f", vec_percentile(data.history.latency, 99.9));
     formatter->dump_format("max_latency:", "%f", data.max_latency);
     formatter->dump_format("min_latency", "%f", data.min_latency);
   }
@@ -741,6 +765,7 @@ int ObjBencher::seq_read_bench(int seconds_to_run, int num_objects, int concurre
       lock.Unlock();
       goto ERR;
     }
+    data.history.latency.push_back(data.cur_latency);
     total_latency += data.cur_latency;
     if (data.cur_latency > data.max_latency) data.max_latency = data.cur_latency;
     if (data.cur_latency < data.min_latency) data.min_latency = data.cur_latency;
@@ -777,6 +802,7 @@ int ObjBencher::seq_read_bench(int seconds_to_run, int num_objects, int concurre
       goto ERR;
     }
     data.cur_latency = ceph_clock_now() - start_times[slot];
+    data.history.latency.push_back(data.cur_latency);
     total_latency += data.cur_latency;
     if (data.cur_latency > data.max_latency) data.max_latency = data.cur_latency;
     if (data.cur_latency < data.min_latency) data.min_latency = data.cur_latency;
@@ -820,6 +846,11 @@ int ObjBencher::seq_read_bench(int seconds_to_run, int num_objects, int concurre
        << "Max IOPS:             " << data.idata.max_iops << std::endl
        << "Min IOPS:             " << data.idata.min_iops << std::endl
        << "Average Latency(s):   " << data.avg_latency << std::endl
+       << "Stddev Latency(s):    " << vec_stddev(data.history.latency) << std::endl
+       << "Latency p50(s):       " << vec_percentile(data.history.latency, 50) << std::endl
+       << "Latency p95(s):       " << vec_percentile(data.history.latency, 95) << std::endl
+       << "Latency p99(s):       " << vec_percentile(data.history.latency, 99) << std::endl
+       << "Latency p99.9(s):     " << vec_percentile(data.history.latency, 99.9) << std::endl
        << "Max latency(s):       " << data.max_latency << std::endl
        << "Min latency(s):       " << data.min_latency << std::endl;
   } else {
@@ -833,6 +864,11 @@ int ObjBencher::seq_read_bench(int seconds_to_run, int num_objects, int concurre
     formatter->dump_format("max_iops", "%d", data.idata.max_iops);
     formatter->dump_format("min_iops", "%d", data.idata.min_iops);
     formatter->dump_format("average_latency", "%f", data.avg_latency);
+    formatter->dump_format("stddev_latency", "%f", vec_stddev(data.history.latency));
+    formatter->dump_format("latency_p50", "%f", vec_percentile(data.history.latency, 50));
+    formatter->dump_format("latency_p95", "%f", vec_percentile(data.history.latency, 95));
+    formatter->dump_format("latency_p99", "%f", vec_percentile(data.history.latency, 99));
+    formatter->dump_format("latency_p999", "%f", vec_percentile(data.history.latency, 99.9));
     formatter->dump_format("max_latency", "%f", data.max_latency);
     formatter->dump_format("min_latency", "%f", data.min_latency);
   }
@@ -957,6 +993,7 @@ int ObjBencher::rand_read_bench(int seconds_to_run, int num_objects, int concurr
       goto ERR;
     }
 
+    data.history.latency.push_back(data.cur_latency);
     total_latency += data.cur_latency;
     if (data.cur_latency > data.max_latency) data.max_latency = data.cur_latency;
     if (data.cur_latency < data.min_latency) data.min_latency = data.cur_latency;
@@ -1010,6 +1047,7 @@ int ObjBencher::rand_read_bench(int seconds_to_run, int num_objects, int concurr
       goto ERR;
     }
     data.cur_latency = ceph_clock_now() - start_times[slot];
+    data.history.latency.push_back(data.cur_latency);
     total_latency += data.cur_latency;
     if (data.cur_latency > data.max_latency) data.max_latency = data.cur_latency;
     if (data.cur_latency < data.min_latency) data.min_latency = data.cur_latency;
@@ -1053,6 +1091,11 @@ int ObjBencher::rand_read_bench(int seconds_to_run, int num_objects, int concurr
        << "Max IOPS:             " << data.idata.max_iops << std::endl
        << "Min IOPS:             " << data.idata.min_iops << std::endl
        << "Average Latency(s):   " << data.avg_latency << std::endl
+       << "Stddev Latency(s):    " << vec_stddev(data.history.latency) << std::endl
+       << "Latency p50(s):       " << vec_percentile(data.history.latency, 50) << std::endl
+       << "Latency p95(s):       " << vec_percentile(data.history.latency, 95) << std::endl
+       << "Latency p99(s):       " << vec_percentile(data.history.latency, 99) << std::endl
+       << "Latency p99.9(s):     " << vec_percentile(data.history.latency, 99.9) << std::endl
        << "Max latency(s):       " << data.max_latency << std::endl
        << "Min latency(s):       " << data.min_latency << std::endl;
   } else {
@@ -1066,6 +1109,11 @@ int ObjBencher::rand_read_bench(int seconds_to_run, int num_objects, int concurr
     formatter->dump_format("max_iops", "%d", data.idata.max_iops);
     formatter->dump_format("min_iops", "%d", data.idata.min_iops);
     formatter->dump_format("average_latency", "%f", data.avg_latency);
+    formatter->dump_format("stddev_latency", "%f", vec_stddev(data.history.latency));
+    formatter->dump_format("latency_p50", "%f", vec_percentile(data.history.latency, 50));
+    formatter->dump_format("latency_p95", "%f", vec_percentile(data.history.latency, 95));
+    formatter->dump_format("latency_p99", "%f", vec_percentile(data.history.latency, 99));
+    formatter->dump_format("latency_p999", "%f", vec_percentile(data.history.latency, 99.9));
     formatter->dump_format("max_latency", "%f", data.max_latency);
     formatter->dump_format("min_latency", "%f", data.min_latency);
   }
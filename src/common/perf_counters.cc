@@ -177,7 +177,10 @@ void PerfCounters::inc(int idx, uint64_t amt)
     data.u64 += amt;
     data.avgcount2++;
   } else {
-    data.u64 += amt;
+    // plain counters have no cross-field invariant to preserve (the
+    // LONGRUNAVG paths rely on the default ordering for read_avg()),
+    // so a relaxed add keeps the hot paths down to one lock-free op
+    data.u64.fetch_add(amt, std::memory_order_relaxed);
   }
 }
 
@@ -192,7 +195,7 @@ void PerfCounters::dec(int idx, uint64_t amt)
   assert(!(data.type & PERFCOUNTER_LONGRUNAVG));
   if (!(data.type & PERFCOUNTER_U64))
     return;
-  data.u64 -= amt;
+  data.u64.fetch_sub(amt, std::memory_order_relaxed);
 }
 
 void PerfCounters::set(int idx, uint64_t amt)
@@ -227,7 +230,7 @@ uint64_t PerfCounters::get(int idx) const
   const perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_U64))
     return 0;
-  return data.u64;
+  return data.u64.load(std::memory_order_relaxed);
 }
 
 void PerfCounters::tinc(int idx, utime_t amt, uint32_t avgcount)
@@ -245,7 +248,10 @@ void PerfCounters::tinc(int idx, utime_t amt, uint32_t avgcount)
     data.u64 += amt.to_nsec();
     data.avgcount2++;
   } else {
-    data.u64 += amt.to_nsec();
+    data.u64.fetch_add(amt.to_nsec(), std::memory_order_relaxed);
+  }
+  if (data.time_histogram) {
+    data.time_histogram->inc((int64_t)amt.to_nsec());
   }
 }
 
@@ -264,7 +270,10 @@ void PerfCounters::tinc(int idx, ceph::timespan amt, uint32_t avgcount)
     data.u64 += amt.count();
     data.avgcount2++;
   } else {
-    data.u64 += amt.count();
+    data.u64.fetch_add(amt.count(), std::memory_order_relaxed);
+  }
+  if (data.time_histogram) {
+    data.time_histogram->inc((int64_t)amt.count());
   }
 }
 
@@ -351,9 +360,11 @@ void PerfCounters::dump_formatted_generic(Formatter *f, bool schema,
       continue;
     }
 
-    // Switch between normal and histogram view
+    // Switch between normal and histogram view; a counter carrying
+    // both an average and a histogram shows up in both
     bool is_histogram = (d->type & PERFCOUNTER_HISTOGRAM) != 0;
-    if (is_histogram != histograms) {
+    if (histograms ? !is_histogram
+		   : (is_histogram && !(d->type & PERFCOUNTER_LONGRUNAVG))) {
       continue;
     }
 
@@ -370,14 +381,16 @@ void PerfCounters::dump_formatted_generic(Formatter *f, bool schema,
 	f->dump_string("metric_type", "gauge");
       }
 
-      if (d->type & PERFCOUNTER_LONGRUNAVG) {
+      if ((d->type & PERFCOUNTER_LONGRUNAVG) && !histograms) {
 	if (d->type & PERFCOUNTER_TIME) {
 	  f->dump_string("value_type", "real-integer-pair");
 	} else {
 	  f->dump_string("value_type", "integer-integer-pair");
 	}
       } else if (d->type & PERFCOUNTER_HISTOGRAM) {
-	if (d->type & PERFCOUNTER_TIME) {
+	if (d->time_histogram) {
+	  f->dump_string("value_type", "real-histogram");
+	} else if (d->type & PERFCOUNTER_TIME) {
 	  f->dump_string("value_type", "real-2d-histogram");
 	} else {
 	  f->dump_string("value_type", "integer-2d-histogram");
@@ -404,7 +417,17 @@ void PerfCounters::dump_formatted_generic(Formatter *f, bool schema,
       }
       f->close_section();
     } else {
-      if (d->type & PERFCOUNTER_LONGRUNAVG) {
+      if (histograms) {
+	assert(d->type & PERFCOUNTER_HISTOGRAM);
+	f->open_object_section(d->name);
+	if (d->time_histogram) {
+	  d->time_histogram->dump_formatted(f);
+	} else {
+	  assert(d->histogram);
+	  d->histogram->dump_formatted(f);
+	}
+	f->close_section();
+      } else if (d->type & PERFCOUNTER_LONGRUNAVG) {
 	f->open_object_section(d->name);
 	pair<uint64_t,uint64_t> a = d->read_avg();
 	if (d->type & PERFCOUNTER_U64) {
@@ -429,12 +452,6 @@ void PerfCounters::dump_formatted_generic(Formatter *f, bool schema,
 	  ceph_abort();
 	}
 	f->close_section();
-      } else if (d->type & PERFCOUNTER_HISTOGRAM) {
-        assert(d->type == (PERFCOUNTER_HISTOGRAM | PERFCOUNTER_COUNTER | PERFCOUNTER_U64));
-        assert(d->histogram);
-        f->open_object_section(d->name);
-        d->histogram->dump_formatted(f);
-        f->close_section();
       } else {
 	uint64_t v = d->u64;
 	if (d->type & PERFCOUNTER_U64) {
@@ -531,10 +548,22 @@ void PerfCountersBuilder::add_u64_counter_histogram(
            unique_ptr<PerfHistogram<>>{new PerfHistogram<>{x_axis_config, y_axis_config}});
 }
 
+void PerfCountersBuilder::add_time_avg_histogram(
+  int idx, const char *name,
+  PerfHistogramCommon::axis_config_d x_axis_config,
+  const char *description, const char *nick, int prio)
+{
+  add_impl(idx, name, description, nick, prio,
+	   PERFCOUNTER_TIME | PERFCOUNTER_LONGRUNAVG | PERFCOUNTER_HISTOGRAM,
+	   nullptr,
+	   unique_ptr<PerfHistogram<1>>{new PerfHistogram<1>{x_axis_config}});
+}
+
 void PerfCountersBuilder::add_impl(
   int idx, const char *name,
   const char *description, const char *nick, int prio, int ty,
-  unique_ptr<PerfHistogram<>> histogram)
+  unique_ptr<PerfHistogram<>> histogram,
+  unique_ptr<PerfHistogram<1>> time_histogram)
 {
   assert(idx > m_perf_counters->m_lower_bound);
   assert(idx < m_perf_counters->m_upper_bound);
@@ -552,6 +581,7 @@ void PerfCountersBuilder::add_impl(
   data.prio = prio;
   data.type = (enum perfcounter_type_d)ty;
   data.histogram = std::move(histogram);
+  data.time_histogram = std::move(time_histogram);
 }
 
 PerfCounters *PerfCountersBuilder::create_perf_counters()
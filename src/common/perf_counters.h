@@ -52,6 +52,7 @@ enum perfcounter_type_d : uint8_t
  * 2) floating-point values & counters
  * 3) floating-point averages
  * 4) 2D histograms of quantized value pairs
+ * 5) time averages with an attached latency histogram
  *
  * The difference between values, counters and histograms is in how they are initialized
  * and accessed. For a counter, use the inc(counter, amount) function (note
@@ -59,6 +60,12 @@ enum perfcounter_type_d : uint8_t
  * set(index, value) function. For histogram use the hinc(value1, value2) function.
  * (For time, use the tinc and tset variants.)
  *
+ * A time average registered with add_time_avg_histogram() additionally
+ * quantizes every value passed to tinc() into a one-dimensional histogram
+ * (typically log2-bucketed), so percentiles can be derived at the source;
+ * it is reported both through the regular counter dump (as the average)
+ * and through the histogram dump (as the buckets).
+ *
  * If for some reason you would like to reset your counters, you can do so using
  * the set functions even if they are counters, and you can also
  * increment your values if for some reason you wish to.
@@ -91,6 +98,9 @@ public:
       if (other.histogram) {
         histogram.reset(new PerfHistogram<>(*other.histogram));
       }
+      if (other.time_histogram) {
+        time_histogram.reset(new PerfHistogram<1>(*other.time_histogram));
+      }
     }
 
     const char *name;
@@ -102,6 +112,7 @@ public:
     std::atomic<uint64_t> avgcount = { 0 };
     std::atomic<uint64_t> avgcount2 = { 0 };
     std::unique_ptr<PerfHistogram<>> histogram;
+    std::unique_ptr<PerfHistogram<1>> time_histogram;
 
     void reset()
     {
@@ -113,6 +124,9 @@ public:
       if (histogram) {
         histogram->reset();
       }
+      if (time_histogram) {
+        time_histogram->reset();
+      }
     }
 
     // read <sum, count> safely by making sure the post- and pre-count
@@ -307,6 +321,12 @@ public:
 		    const char *description=NULL,
 		    const char *nick = NULL,
 		    int prio=0);
+  void add_time_avg_histogram(
+    int key, const char *name,
+    PerfHistogramCommon::axis_config_d x_axis_config,
+    const char *description=NULL,
+    const char *nick = NULL,
+    int prio=0);
   void add_u64_counter_histogram(
     int key, const char* name,
     PerfHistogramCommon::axis_config_d x_axis_config,
@@ -321,7 +341,8 @@ private:
   PerfCountersBuilder& operator=(const PerfCountersBuilder &rhs);
   void add_impl(int idx, const char *name,
                 const char *description, const char *nick, int prio, int ty,
-                unique_ptr<PerfHistogram<>> histogram = nullptr);
+                unique_ptr<PerfHistogram<>> histogram = nullptr,
+                unique_ptr<PerfHistogram<1>> time_histogram = nullptr);
 
   PerfCounters *m_perf_counters;
 };
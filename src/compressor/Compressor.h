@@ -66,6 +66,23 @@ public:
   // alignment with decode methods
   virtual int decompress(ceph::bufferlist::iterator &p, size_t compressed_len, ceph::bufferlist &out) = 0;
 
+  /* Dictionary-aware variants, for data sets whose small blocks share a
+   * trained dictionary (e.g. zstd's zdict). Plugins without dictionary
+   * support ignore the dictionary and fall back to plain compression, so
+   * data stays readable as long as the same plugin handles both directions. */
+  virtual int compress(const ceph::bufferlist &in, ceph::bufferlist &out,
+		       const ceph::bufferlist &dict) {
+    return compress(in, out);
+  }
+  virtual int decompress(const ceph::bufferlist &in, ceph::bufferlist &out,
+			 const ceph::bufferlist &dict) {
+    return decompress(in, out);
+  }
+  virtual int decompress(ceph::bufferlist::iterator &p, size_t compressed_len,
+			 ceph::bufferlist &out, const ceph::bufferlist &dict) {
+    return decompress(p, compressed_len, out);
+  }
+
   static CompressorRef create(CephContext *cct, const std::string &type);
   static CompressorRef create(CephContext *cct, int alg);
 
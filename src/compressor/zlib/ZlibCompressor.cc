@@ -47,23 +47,49 @@ _prefix(std::ostream* _dout)
 // compression ratio.
 #define ZLIB_MEMORY_LEVEL 8
 
+/* deflate state is costly to set up, so keep one per thread and reset it
+ * between calls instead of re-initializing it for every block */
+struct zlib_session {
+  z_stream strm;
+  int level = -1;
+  bool initialized = false;
+  ~zlib_session() {
+    if (initialized) {
+      deflateEnd(&strm);
+    }
+  }
+};
+
+static thread_local zlib_session session;
+
 int ZlibCompressor::zlib_compress(const bufferlist &in, bufferlist &out)
 {
   int ret;
   unsigned have;
-  z_stream strm;
+  z_stream& strm = session.strm;
   unsigned char* c_in;
   int begin = 1;
 
-  /* allocate deflate state */
-  strm.zalloc = Z_NULL;
-  strm.zfree = Z_NULL;
-  strm.opaque = Z_NULL;
-  ret = deflateInit2(&strm, g_conf->compressor_zlib_level, Z_DEFLATED, ZLIB_DEFAULT_WIN_SIZE, ZLIB_MEMORY_LEVEL, Z_DEFAULT_STRATEGY);
-  if (ret != Z_OK) {
-    dout(1) << "Compression init error: init return "
-         << ret << " instead of Z_OK" << dendl;
-    return -1;
+  int level = g_conf->compressor_zlib_level;
+  if (!session.initialized || session.level != level) {
+    if (session.initialized) {
+      deflateEnd(&strm);
+      session.initialized = false;
+    }
+    /* allocate deflate state */
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    ret = deflateInit2(&strm, level, Z_DEFLATED, ZLIB_DEFAULT_WIN_SIZE, ZLIB_MEMORY_LEVEL, Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK) {
+      dout(1) << "Compression init error: init return "
+           << ret << " instead of Z_OK" << dendl;
+      return -1;
+    }
+    session.initialized = true;
+    session.level = level;
+  } else {
+    deflateReset(&strm);
   }
 
   for (std::list<buffer::ptr>::const_iterator i = in.buffers().begin();
@@ -91,6 +117,7 @@ int ZlibCompressor::zlib_compress(const bufferlist &in, bufferlist &out)
          dout(1) << "Compression error: compress return Z_STREAM_ERROR("
               << ret << ")" << dendl;
          deflateEnd(&strm);
+         session.initialized = false;
          return -1;
       }
       have = MAX_LEN - strm.avail_out;
@@ -99,11 +126,12 @@ int ZlibCompressor::zlib_compress(const bufferlist &in, bufferlist &out)
     if (strm.avail_in != 0) {
       dout(10) << "Compression error: unused input" << dendl;
       deflateEnd(&strm);
+      session.initialized = false;
       return -1;
     }
   }
 
-  deflateEnd(&strm);
+  /* the session is reset on the next call, keep the state allocated */
   return 0;
 }
 
@@ -23,10 +23,36 @@
 #define COMPRESSION_LEVEL 5
 
 class ZstdCompressor : public Compressor {
+  /* Creating a compression context is expensive relative to compressing the
+   * small blocks bluestore feeds us, so keep one stream per thread and
+   * re-init it for every call; ZSTD_initCStream() on an existing stream
+   * reuses its workspace instead of allocating a new one. */
+  static ZSTD_CStream *get_cstream() {
+    struct cstream_holder {
+      ZSTD_CStream *s = ZSTD_createCStream();
+      ~cstream_holder() { ZSTD_freeCStream(s); }
+    };
+    static thread_local cstream_holder holder;
+    return holder.s;
+  }
+
+  static ZSTD_DStream *get_dstream() {
+    struct dstream_holder {
+      ZSTD_DStream *s = ZSTD_createDStream();
+      ~dstream_holder() { ZSTD_freeDStream(s); }
+    };
+    static thread_local dstream_holder holder;
+    return holder.s;
+  }
+
  public:
   ZstdCompressor() : Compressor(COMP_ALG_ZSTD, "zstd") {}
 
   int compress(const bufferlist &src, bufferlist &dst) override {
+    return compress(src, dst, bufferlist());
+  }
+
+  int compress(const bufferlist &src, bufferlist &dst, const bufferlist &dict) override {
     bufferptr outptr = buffer::create_page_aligned(
       ZSTD_compressBound(src.length()));
     ZSTD_outBuffer_s outbuf;
@@ -34,8 +60,15 @@ class ZstdCompressor : public Compressor {
     outbuf.size = outptr.length();
     outbuf.pos = 0;
 
-    ZSTD_CStream *s = ZSTD_createCStream();
-    ZSTD_initCStream(s, COMPRESSION_LEVEL);
+    ZSTD_CStream *s = get_cstream();
+    if (dict.length()) {
+      /* zstd wants the dictionary contiguous; rebuild (if needed) only
+       * affects the cheap local copy */
+      bufferlist d(dict);
+      ZSTD_initCStream_usingDict(s, d.c_str(), d.length(), COMPRESSION_LEVEL);
+    } else {
+      ZSTD_initCStream(s, COMPRESSION_LEVEL);
+    }
     auto p = src.begin();
     size_t left = src.length();
     while (left) {
@@ -49,7 +82,6 @@ class ZstdCompressor : public Compressor {
     assert(p.end());
     ZSTD_flushStream(s, &outbuf);
     ZSTD_endStream(s, &outbuf);
-    ZSTD_freeCStream(s);
 
     // prefix with decompressed length
     ::encode((uint32_t)src.length(), dst);
@@ -62,9 +94,21 @@ class ZstdCompressor : public Compressor {
     return decompress(i, src.length(), dst);
   }
 
+  int decompress(const bufferlist &src, bufferlist &dst, const bufferlist &dict) override {
+    bufferlist::iterator i = const_cast<bufferlist&>(src).begin();
+    return decompress(i, src.length(), dst, dict);
+  }
+
   int decompress(bufferlist::iterator &p,
 		 size_t compressed_len,
 		 bufferlist &dst) override {
+    return decompress(p, compressed_len, dst, bufferlist());
+  }
+
+  int decompress(bufferlist::iterator &p,
+		 size_t compressed_len,
+		 bufferlist &dst,
+		 const bufferlist &dict) override {
     if (compressed_len < 4) {
       return -1;
     }
@@ -77,8 +121,13 @@ class ZstdCompressor : public Compressor {
     outbuf.dst = dstptr.c_str();
     outbuf.size = dstptr.length();
     outbuf.pos = 0;
-    ZSTD_DStream *s = ZSTD_createDStream();
-    ZSTD_initDStream(s);
+    ZSTD_DStream *s = get_dstream();
+    if (dict.length()) {
+      bufferlist d(dict);
+      ZSTD_initDStream_usingDict(s, d.c_str(), d.length());
+    } else {
+      ZSTD_initDStream(s);
+    }
     while (compressed_len > 0) {
       if (p.end()) {
 	return -1;
@@ -89,7 +138,6 @@ class ZstdCompressor : public Compressor {
       ZSTD_decompressStream(s, &outbuf, &inbuf);
       compressed_len -= inbuf.size;
     }
-    ZSTD_freeDStream(s);
 
     dst.append(dstptr, 0, outbuf.pos);
     return 0;
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <stdlib.h>
+#include <thread>
 #include <boost/lexical_cast.hpp>
 // to workaround https://svn.boost.org/trac/boost/ticket/9501
 #ifdef _LIBCPP_VERSION
@@ -589,6 +590,68 @@ int CrushTester::test()
       for (unsigned i = 0; i < num_devices; i++)
         num_objects_expected[i] = (proportional_weights[i]*expected_objects);
 
+      /*
+       * when we are only counting mappings we can spread the x range
+       * over several threads: do_rule only reads the map and keeps its
+       * working space per thread.  each worker accumulates private
+       * counters which are merged below; bad mapping reports are
+       * buffered per worker so they still come out in x order.
+       */
+      if (use_crush && num_threads > 1 && num_batches == 1 &&
+	  !output_mappings && !output_data_file && !output_choose_tries) {
+	int nthreads = num_threads;
+	if (nthreads > num_objects)
+	  nthreads = num_objects;
+	vector<vector<int> > worker_per(nthreads, vector<int>(per.size(), 0));
+	vector<map<int,int> > worker_sizes(nthreads);
+	vector<ostringstream> worker_err(nthreads);
+	vector<std::thread> workers;
+	int objects_per_thread = num_objects / nthreads;
+	for (int t = 0; t < nthreads; t++) {
+	  int x_begin = min_x + t * objects_per_thread;
+	  int x_end = (t == nthreads - 1) ? max_x + 1
+	    : x_begin + objects_per_thread;
+	  workers.push_back(std::thread(
+	      [&, t, x_begin, x_end]() {
+		for (int x = x_begin; x < x_end; x++) {
+		  vector<int> out;
+		  uint32_t real_x = x;
+		  if (pool_id != -1) {
+		    real_x = crush_hash32_2(CRUSH_HASH_RJENKINS1, x,
+					    (uint32_t)pool_id);
+		  }
+		  crush.do_rule(r, real_x, out, nr, weight, 0);
+
+		  bool has_item_none = false;
+		  for (unsigned i = 0; i < out.size(); i++) {
+		    if (out[i] != CRUSH_ITEM_NONE) {
+		      worker_per[t][out[i]]++;
+		    } else {
+		      has_item_none = true;
+		    }
+		  }
+		  worker_sizes[t][out.size()]++;
+		  if (output_bad_mappings &&
+		      (out.size() != (unsigned)nr ||
+		       has_item_none)) {
+		    worker_err[t] << "bad mapping rule " << r << " x " << x
+				  << " num_rep " << nr << " result " << out
+				  << std::endl;
+		  }
+		}
+	      }));
+	}
+	for (auto& w : workers)
+	  w.join();
+	for (int t = 0; t < nthreads; t++) {
+	  for (unsigned i = 0; i < per.size(); i++)
+	    per[i] += worker_per[t][i];
+	  for (map<int,int>::iterator p = worker_sizes[t].begin();
+	       p != worker_sizes[t].end(); ++p)
+	    sizes[p->first] += p->second;
+	  err << worker_err[t].str();
+	}
+      } else
       for (int current_batch = 0; current_batch < num_batches; current_batch++) {
         if (current_batch == (num_batches - 1)) {
           batch_max = max_x;
@@ -680,6 +743,35 @@ int CrushTester::test()
           }
         }
 
+      if (output_overload) {
+	// how far over its expectation each device landed; the tail of
+	// this distribution is what overfills devices after a reweight
+	vector<float> overload;
+	int max_device = -1;
+	float max_ratio = 0.0;
+	for (unsigned i = 0; i < per.size(); i++) {
+	  if (num_objects_expected[i] > 0) {
+	    float ratio = (float)per[i] / num_objects_expected[i];
+	    overload.push_back(ratio);
+	    if (ratio > max_ratio) {
+	      max_ratio = ratio;
+	      max_device = i;
+	    }
+	  }
+	}
+	if (!overload.empty()) {
+	  std::sort(overload.begin(), overload.end());
+	  unsigned p99 = overload.size() * 99 / 100;
+	  if (p99 >= overload.size())
+	    p99 = overload.size() - 1;
+	  err << "rule " << r << " (" << crush.get_rule_name(r)
+	      << ") num_rep " << nr << " overload (stored/expected):"
+	      << " p99 " << overload[p99]
+	      << " max " << max_ratio << " (device " << max_device << ")"
+	      << std::endl;
+	}
+      }
+
       if (output_data_file)
         for (unsigned i = 0; i < per.size(); i++) {
           vector_data_buffer_f.clear();
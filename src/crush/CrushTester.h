@@ -20,6 +20,7 @@ class CrushTester {
   int64_t pool_id;
 
   int num_batches;
+  int num_threads;
   bool use_crush;
 
   float mark_down_device_ratio;
@@ -31,6 +32,7 @@ class CrushTester {
   bool output_mappings;
   bool output_bad_mappings;
   bool output_choose_tries;
+  bool output_overload;
 
   bool output_data_file;
   bool output_csv;
@@ -174,6 +176,7 @@ public:
       min_rep(-1), max_rep(-1),
       pool_id(-1),
       num_batches(1),
+      num_threads(1),
       use_crush(true),
       mark_down_device_ratio(0.0),
       mark_down_bucket_ratio(1.0),
@@ -183,6 +186,7 @@ public:
       output_mappings(false),
       output_bad_mappings(false),
       output_choose_tries(false),
+      output_overload(false),
       output_data_file(false),
       output_csv(false),
       output_data_file_name("")
@@ -259,6 +263,20 @@ public:
     return num_batches;
   }
 
+  void set_num_threads(int t) {
+    num_threads = t;
+  }
+  int get_num_threads() const {
+    return num_threads;
+  }
+
+  void set_output_overload(bool b) {
+    output_overload = b;
+  }
+  bool get_output_overload() const {
+    return output_overload;
+  }
+
   void set_random_placement() {
     use_crush = false;
   }
@@ -5,6 +5,7 @@
 #define CEPH_CRUSH_WRAPPER_H
 
 #include <stdlib.h>
+#include <atomic>
 #include <map>
 #include <set>
 #include <string>
@@ -65,6 +66,16 @@ private:
 
   bool have_uniform_rules = false;
 
+  /// process-unique ids for bucket layouts; see get_working_space()
+  static uint64_t get_next_working_gen() {
+    static std::atomic<uint64_t> gen = { 0 };
+    return ++gen;
+  }
+
+  /// identifies the current bucket layout of this map to the
+  /// per-thread workspace cache; reassigned by finalize()
+  uint64_t working_gen = get_next_working_gen();
+
   /* reverse maps */
   mutable bool have_rmaps;
   mutable std::map<string, int> type_rmap, name_rmap, rule_name_rmap;
@@ -1190,6 +1201,8 @@ public:
     assert(crush);
     crush_finalize(crush);
     have_uniform_rules = !has_legacy_rulesets();
+    // orphan any per-thread workspaces initialized for the old layout
+    working_gen = get_next_working_gen();
   }
 
   int update_device_class(int id, const string& class_name, const string& name, ostream *ss);
@@ -1303,13 +1316,39 @@ public:
     choose_args.clear();
   }
 
+  /**
+   * Return a workspace for crush_do_rule, ready for this map's current
+   * bucket layout.  Workspaces are cached per thread and reused across
+   * calls, per the guidance in mapper.h: initializing one walks every
+   * bucket in the map, which at scale costs more than the mapping it
+   * supports.  The workspace is reinitialized whenever the layout
+   * changes (finalize() hands out a new working_gen) or the buffer has
+   * to grow for a larger result set.
+   */
+  char *get_working_space(int maxout) const {
+    struct working_space_t {
+      uint64_t gen = 0;
+      std::vector<char> buf;
+    };
+    static thread_local working_space_t ws;
+    size_t size = crush_work_size(crush, maxout);
+    if (ws.buf.size() < size) {
+      ws.buf.resize(size);
+      ws.gen = 0;  // the buffer moved; its internal pointers are stale
+    }
+    if (ws.gen != working_gen) {
+      crush_init_workspace(crush, &ws.buf[0]);
+      ws.gen = working_gen;
+    }
+    return &ws.buf[0];
+  }
+
   template<typename WeightVector>
   void do_rule(int rule, int x, vector<int>& out, int maxout,
 	       const WeightVector& weight,
 	       uint64_t choose_args_index) const {
     int rawout[maxout];
-    char work[crush_work_size(crush, maxout)];
-    crush_init_workspace(crush, work);
+    char *work = get_working_space(maxout);
     crush_choose_arg_map arg_map = choose_args_get(choose_args_index);
     int numrep = crush_do_rule(crush, rule, x, rawout, maxout, &weight[0],
 			       weight.size(), work, arg_map.args);
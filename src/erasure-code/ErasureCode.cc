@@ -112,10 +112,39 @@ int ErasureCode::minimum_to_decode_with_cost(const set<int> &want_to_read,
                                              set<int> *minimum)
 {
   set <int> available_chunks;
+  bool flat_cost = true;
   for (map<int, int>::const_iterator i = available.begin();
        i != available.end();
-       ++i)
+       ++i) {
     available_chunks.insert(i->first);
+    flat_cost = flat_cost && (i->second == available.begin()->second);
+  }
+
+  if (flat_cost)
+    return minimum_to_decode(want_to_read, available_chunks, minimum);
+
+  // Drop the most expensive chunks for as long as what remains can
+  // still decode want_to_read, then plan on what is left.  Chunks in
+  // want_to_read are never dropped: reconstructing an available chunk
+  // from the others would read more data, not less.  Decodability is
+  // delegated to minimum_to_decode so codes with their own placement
+  // logic (layered or local parity codes) keep it.
+  multimap<int, int> by_cost;
+  for (map<int, int>::const_iterator i = available.begin();
+       i != available.end();
+       ++i)
+    by_cost.insert(make_pair(i->second, i->first));
+  for (multimap<int, int>::reverse_iterator i = by_cost.rbegin();
+       i != by_cost.rend();
+       ++i) {
+    if (want_to_read.count(i->second))
+      continue;
+    set<int> candidate = available_chunks;
+    candidate.erase(i->second);
+    set<int> dummy;
+    if (minimum_to_decode(want_to_read, candidate, &dummy) == 0)
+      available_chunks.swap(candidate);
+  }
   return minimum_to_decode(want_to_read, available_chunks, minimum);
 }
 
@@ -358,6 +358,40 @@ namespace ceph {
     virtual int encode_chunks(const std::set<int> &want_to_encode,
                               std::map<int, bufferlist> *encoded) = 0;
 
+    /**
+     * Compute the change to the coding chunks caused by overwriting
+     * the data chunk **data_chunk** of an already encoded stripe with
+     * **new_chunk**.
+     *
+     * For linear codes the coding chunks of the modified stripe can
+     * be obtained without re-encoding the whole stripe: the
+     * **parity_delta** buffer for each coding chunk index only
+     * depends on **old_chunk** and **new_chunk** and XORing it into
+     * the existing coding chunk yields the coding chunk of the
+     * stripe with **new_chunk** in place of **old_chunk**.
+     *
+     * **old_chunk** and **new_chunk** must have the same length. On
+     * success **parity_delta** contains one buffer of that length
+     * for every coding chunk index.
+     *
+     * Plugins that cannot compute coding deltas (i.e. for which a
+     * full re-encode of the stripe is the only option) return
+     * -EOPNOTSUPP and the caller is expected to fall back to
+     * **encode()**.
+     *
+     * @param [in] data_chunk index of the data chunk being overwritten
+     * @param [in] old_chunk current content of the data chunk
+     * @param [in] new_chunk new content of the data chunk
+     * @param [out] parity_delta map coding chunk indexes to delta buffers
+     * @return **0** on success or a negative errno on error.
+     */
+    virtual int encode_delta(int data_chunk,
+                             const bufferlist &old_chunk,
+                             const bufferlist &new_chunk,
+                             std::map<int, bufferlist> *parity_delta) {
+      return -EOPNOTSUPP;
+    }
+
     /**
      * Decode the **chunks** and store at least **want_to_read**
      * chunks in **decoded**.
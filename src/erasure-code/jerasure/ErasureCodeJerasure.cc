@@ -149,6 +149,51 @@ bool ErasureCodeJerasure::is_prime(int value)
 // 
 // ErasureCodeJerasureReedSolomonVandermonde
 //
+int ErasureCodeJerasureReedSolomonVandermonde::encode_delta(
+  int data_chunk,
+  const bufferlist &old_chunk,
+  const bufferlist &new_chunk,
+  map<int, bufferlist> *parity_delta)
+{
+  if (data_chunk < 0 || data_chunk >= k)
+    return -EINVAL;
+  if (old_chunk.length() == 0 ||
+      old_chunk.length() != new_chunk.length())
+    return -EINVAL;
+  unsigned int blocksize = old_chunk.length();
+  if (blocksize % (w / 8))
+    return -EINVAL;
+
+  /* the code is linear, so the coding deltas only depend on the data
+     delta, not on the remaining chunks of the stripe */
+  bufferlist old_copy(old_chunk);
+  bufferlist new_copy(new_chunk);
+  bufferptr delta(buffer::create_aligned(blocksize, SIMD_ALIGN));
+  memcpy(delta.c_str(), new_copy.c_str(), blocksize);
+  galois_region_xor(old_copy.c_str(), delta.c_str(), blocksize);
+
+  for (int i = 0; i < m; i++) {
+    bufferptr d(buffer::create_aligned(blocksize, SIMD_ALIGN));
+    int multby = matrix[i * k + data_chunk];
+    switch (w) {
+    case 8:
+      galois_w08_region_multiply(delta.c_str(), multby, blocksize,
+				 d.c_str(), 0);
+      break;
+    case 16:
+      galois_w16_region_multiply(delta.c_str(), multby, blocksize,
+				 d.c_str(), 0);
+      break;
+    case 32:
+      galois_w32_region_multiply(delta.c_str(), multby, blocksize,
+				 d.c_str(), 0);
+      break;
+    }
+    (*parity_delta)[k + i].append(d);
+  }
+  return 0;
+}
+
 void ErasureCodeJerasureReedSolomonVandermonde::jerasure_encode(char **data,
                                                                 char **coding,
                                                                 int blocksize)
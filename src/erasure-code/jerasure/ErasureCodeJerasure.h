@@ -96,6 +96,11 @@ public:
       free(matrix);
   }
 
+  int encode_delta(int data_chunk,
+		   const bufferlist &old_chunk,
+		   const bufferlist &new_chunk,
+		   std::map<int, bufferlist> *parity_delta) override;
+
   void jerasure_encode(char **data,
                                char **coding,
                                int blocksize) override;
@@ -120,20 +120,6 @@ int ErasureCodeShec::minimum_to_decode(const set<int> &want_to_read,
   return 0;
 }
 
-int ErasureCodeShec::minimum_to_decode_with_cost(const set<int> &want_to_read,
-						 const map<int, int> &available,
-						 set<int> *minimum_chunks)
-{
-  set <int> available_chunks;
-
-  for (map<int, int>::const_iterator i = available.begin();
-       i != available.end();
-       ++i)
-    available_chunks.insert(i->first);
-
-  return minimum_to_decode(want_to_read, available_chunks, minimum_chunks);
-}
-
 int ErasureCodeShec::encode(const set<int> &want_to_encode,
 			    const bufferlist &in,
 			    map<int, bufferlist> *encoded)
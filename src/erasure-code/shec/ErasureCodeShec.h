@@ -75,10 +75,6 @@ public:
 				const set<int> &available_chunks,
 				set<int> *minimum) override;
 
-  int minimum_to_decode_with_cost(const set<int> &want_to_read,
-					  const map<int, int> &available,
-					  set<int> *minimum) override;
-
   int encode(const set<int> &want_to_encode,
 		     const bufferlist &in,
 		     map<int, bufferlist> *encoded) override;
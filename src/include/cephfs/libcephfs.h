@@ -1443,6 +1443,24 @@ int ceph_ll_lookup_root(struct ceph_mount_info *cmount,
 int ceph_ll_lookup(struct ceph_mount_info *cmount, Inode *parent,
 		   const char *name, Inode **out, struct ceph_statx *stx,
 		   unsigned want, unsigned flags, const UserPerm *perms);
+
+/**
+ * Look up many names under one parent in a single call.  If the
+ * directory is not already fully cached the client primes its dentry
+ * cache with a readdirplus sweep (one MDS round trip per dirfrag)
+ * before resolving the names locally, which is much cheaper than a
+ * round trip per name when scanning large directories.
+ *
+ * Each resolved name takes an inode reference (release with
+ * ceph_ll_put); entries that failed have out[i] == NULL and
+ * stx[i].stx_ino == 0.
+ *
+ * @returns the number of names resolved, or negative error code
+ */
+int ceph_ll_lookup_batch(struct ceph_mount_info *cmount, Inode *parent,
+			 const char **names, size_t count, Inode **out,
+			 struct ceph_statx *stx, unsigned want,
+			 unsigned flags, const UserPerm *perms);
 int ceph_ll_put(struct ceph_mount_info *cmount, struct Inode *in);
 int ceph_ll_forget(struct ceph_mount_info *cmount, struct Inode *in,
 		   int count);
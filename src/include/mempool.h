@@ -27,6 +27,8 @@
 
 #include <common/Formatter.h>
 #include "include/assert.h"
+#include "include/cpp-btree/btree_map.h"
+#include "include/cpp-btree/btree_set.h"
 
 
 /*
@@ -148,6 +150,7 @@ namespace mempool {
   f(bluefs)			      \
   f(buffer_anon)		      \
   f(buffer_meta)		      \
+  f(msgr)			      \
   f(osd)			      \
   f(osd_mapbl)			      \
   f(osd_pglog)			      \
@@ -271,6 +274,7 @@ void dump(ceph::Formatter *f);
 
 template<pool_index_t pool_ix, typename T>
 class pool_allocator {
+protected:
   pool_t *pool;
   type_t *type = nullptr;
 
@@ -375,6 +379,84 @@ public:
 };
 
 
+// Slab variant for fixed-size object factories.  Single objects are
+// carved slab_items at a time and freed back onto a per-shard free
+// list, so the hot new/delete path takes a sharded mutex instead of
+// the global heap lock and free is O(1).  Slabs are never returned to
+// the heap, which also keeps long-lived caches from fragmenting it.
+// Pool accounting still reflects live objects only.
+template<pool_index_t pool_ix, typename T, unsigned slab_items = 64>
+class slab_allocator : public pool_allocator<pool_ix, T> {
+  struct free_node {
+    free_node *next;
+  };
+  static_assert(sizeof(T) >= sizeof(free_node),
+		"objects must be able to hold a free list node");
+
+  struct slab_shard_t {
+    std::mutex lock;
+    free_node *free = nullptr;
+    char __padding[128 - sizeof(std::mutex) - sizeof(free_node*)];
+  } __attribute__ ((aligned (128)));
+  slab_shard_t shard[num_shards];
+
+  slab_shard_t *pick_a_slab_shard() {
+    size_t me = (size_t)pthread_self();
+    size_t i = (me >> 3) & ((1 << num_shard_bits) - 1);
+    return &shard[i];
+  }
+
+public:
+  slab_allocator(bool force_register=false)
+    : pool_allocator<pool_ix, T>(force_register) {}
+
+  T* allocate(size_t n, void *p = nullptr) {
+    if (n != 1) {
+      return pool_allocator<pool_ix, T>::allocate(n, p);
+    }
+    shard_t *stat = this->pool->pick_a_shard();
+    stat->bytes += sizeof(T);
+    stat->items += 1;
+    if (this->type) {
+      this->type->items += 1;
+    }
+    slab_shard_t *s = pick_a_slab_shard();
+    std::lock_guard<std::mutex> l(s->lock);
+    if (!s->free) {
+      char *slab = new char[sizeof(T) * slab_items];
+      for (unsigned i = 0; i < slab_items; ++i) {
+	free_node *node = reinterpret_cast<free_node*>(slab + i * sizeof(T));
+	node->next = s->free;
+	s->free = node;
+      }
+    }
+    free_node *node = s->free;
+    s->free = node->next;
+    return reinterpret_cast<T*>(node);
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      pool_allocator<pool_ix, T>::deallocate(p, n);
+      return;
+    }
+    shard_t *stat = this->pool->pick_a_shard();
+    stat->bytes -= sizeof(T);
+    stat->items -= 1;
+    if (this->type) {
+      this->type->items -= 1;
+    }
+    // freed onto the current thread's shard, which may differ from the
+    // allocating one; the lists just rebalance over time
+    slab_shard_t *s = pick_a_slab_shard();
+    free_node *node = reinterpret_cast<free_node*>(p);
+    std::lock_guard<std::mutex> l(s->lock);
+    node->next = s->free;
+    s->free = node;
+  }
+};
+
+
 // Namespace mempool
 
 #define P(x)								\
@@ -383,6 +465,9 @@ public:
     template<typename v>						\
     using pool_allocator = mempool::pool_allocator<id,v>;		\
                                                                         \
+    template<typename v>						\
+    using slab_allocator = mempool::slab_allocator<id,v>;		\
+                                                                        \
     using string = std::basic_string<char,std::char_traits<char>,       \
                                      pool_allocator<char>>;             \
                                                                         \
@@ -398,6 +483,13 @@ public:
     template<typename k, typename cmp = std::less<k> >			\
     using set = std::set<k,cmp,pool_allocator<k>>;			\
                                                                         \
+    template<typename k,typename v, typename cmp = std::less<k> >	\
+    using btree_map = btree::btree_map<k,v,cmp,				\
+			  pool_allocator<std::pair<const k,v>>>;	\
+                                                                        \
+    template<typename k, typename cmp = std::less<k> >			\
+    using btree_set = btree::btree_set<k,cmp,pool_allocator<k>>;	\
+                                                                        \
     template<typename v>						\
     using list = std::list<v,pool_allocator<v>>;			\
                                                                         \
@@ -469,4 +561,20 @@ DEFINE_MEMORY_POOLS_HELPER(P)
     return mempool::pool::alloc_##factoryname.deallocate((obj*)p, 1);	\
   }
 
+// Like MEMPOOL_DEFINE_OBJECT_FACTORY, but allocations come from
+// per-shard slabs; use for small fixed-size objects that churn on hot
+// paths (onodes, extents, ...).
+#define MEMPOOL_DEFINE_SLAB_OBJECT_FACTORY(obj,factoryname,pool)	\
+  namespace mempool {							\
+    namespace pool {							\
+      slab_allocator<obj> slab_alloc_##factoryname = {true};		\
+    }									\
+  }									\
+  void *obj::operator new(size_t size) {				\
+    return mempool::pool::slab_alloc_##factoryname.allocate(1);		\
+  }									\
+  void obj::operator delete(void *p)  {					\
+    return mempool::pool::slab_alloc_##factoryname.deallocate((obj*)p, 1); \
+  }
+
 #endif
@@ -189,6 +189,7 @@ struct ceph_msg_footer {
 #define CEPH_MSG_FOOTER_COMPLETE  (1<<0)   /* msg wasn't aborted */
 #define CEPH_MSG_FOOTER_NOCRC     (1<<1)   /* no data crc */
 #define CEPH_MSG_FOOTER_SIGNED	  (1<<2)   /* msg was signed */
+#define CEPH_MSG_FOOTER_COMPRESSED (1<<3)  /* data payload is compressed */
 
 
 #endif
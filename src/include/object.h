@@ -54,6 +54,23 @@ struct object_t {
 };
 WRITE_CLASS_ENCODER(object_t)
 
+template<>
+struct denc_traits<object_t> {
+  static constexpr bool supported = true;
+  static constexpr bool featured = false;
+  static constexpr bool bounded = false;
+  static constexpr bool need_contiguous = true;
+  static void bound_encode(const object_t& o, size_t& p) {
+    denc(o.name, p);
+  }
+  static void encode(const object_t& o, buffer::list::contiguous_appender& p) {
+    denc(o.name, p);
+  }
+  static void decode(object_t& o, buffer::ptr::iterator& p) {
+    denc(o.name, p);
+  }
+};
+
 inline bool operator==(const object_t& l, const object_t& r) {
   return l.name == r.name;
 }
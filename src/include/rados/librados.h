@@ -1404,6 +1404,26 @@ CEPH_RADOS_API uint64_t rados_get_last_version(rados_ioctx_t io);
 CEPH_RADOS_API int rados_write(rados_ioctx_t io, const char *oid,
                                const char *buf, size_t len, uint64_t off);
 
+/**
+ * Write *len* bytes from *buf* into the *oid* object, starting at
+ * offset *off*, without copying the data into library-owned memory.
+ * The value of *len* must be <= UINT_MAX/2.
+ *
+ * The library sends directly from *buf*; the caller keeps ownership
+ * of the buffer throughout and must not modify or free it until this
+ * call returns.
+ *
+ * @param io the io context in which the write will occur
+ * @param oid name of the object
+ * @param buf data to write
+ * @param len length of the data, in bytes
+ * @param off byte offset in the object to begin writing at
+ * @returns 0 on success, negative error code on failure
+ */
+CEPH_RADOS_API int rados_write_zerocopy(rados_ioctx_t io, const char *oid,
+                                        const char *buf, size_t len,
+                                        uint64_t off);
+
 /**
  * Write *len* bytes from *buf* into the *oid* object. The value of
  * *len* must be <= UINT_MAX/2.
@@ -1989,6 +2009,32 @@ CEPH_RADOS_API int rados_aio_write(rados_ioctx_t io, const char *oid,
 		                   rados_completion_t completion,
 		                   const char *buf, size_t len, uint64_t off);
 
+/**
+ * Asynchronously write data to an object without copying it into
+ * library-owned memory
+ *
+ * Queues the write and returns. The return value of the completion
+ * will be 0 on success, negative error code on failure.
+ *
+ * The library sends directly from *buf*; the caller keeps ownership
+ * of the buffer throughout but must not modify or free it until the
+ * operation is safe (see rados_aio_wait_for_safe()), since the data
+ * may be resent if the write has to be retried.
+ *
+ * @param io the io context in which the write will occur
+ * @param oid name of the object
+ * @param completion what to do when the write is safe and complete
+ * @param buf data to write
+ * @param len length of the data, in bytes
+ * @param off byte offset in the object to begin writing at
+ * @returns 0 on success, -EROFS if the io context specifies a snap_seq
+ * other than LIBRADOS_SNAP_HEAD
+ */
+CEPH_RADOS_API int rados_aio_write_zerocopy(rados_ioctx_t io, const char *oid,
+		                            rados_completion_t completion,
+		                            const char *buf, size_t len,
+		                            uint64_t off);
+
 /**
  * Asychronously append data to an object
  *
@@ -2108,6 +2154,37 @@ CEPH_RADOS_API int rados_aio_read(rados_ioctx_t io, const char *oid,
  */
 CEPH_RADOS_API int rados_aio_flush(rados_ioctx_t io);
 
+/**
+ * Enable or disable poll mode on an io context; see rados_aio_poll().
+ *
+ * Must not be changed while asynchronous operations are in flight.
+ *
+ * @param io the io context to change
+ * @param enable non zero to activate poll mode
+ */
+CEPH_RADOS_API void rados_ioctx_set_pollmode(rados_ioctx_t io, int enable);
+
+/**
+ * Reap asynchronous I/O callbacks in the calling thread.
+ *
+ * Only valid after rados_ioctx_set_pollmode(): in poll mode,
+ * completion and safe callbacks of asynchronous object operations
+ * issued on this io context are no longer run from an internal thread
+ * but queued until the application calls rados_aio_poll(), which
+ * executes them inline.  Intended for applications running their own
+ * event loops; waiting on a completion
+ * (rados_aio_wait_for_complete() etc.) still works as usual.
+ *
+ * @param io the io context to poll
+ * @param max maximum number of callbacks to run, 0 for no limit
+ * @param timeout_ms how long to wait if no completion is pending,
+ *        0 to return immediately
+ * @returns number of callbacks run, 0 on timeout, -EINVAL if the io
+ *          context is not in poll mode
+ */
+CEPH_RADOS_API int rados_aio_poll(rados_ioctx_t io, int max,
+                                  uint64_t timeout_ms);
+
 
 /**
  * Schedule a callback for when all currently pending
@@ -1085,6 +1085,24 @@ namespace librados
     int operate(const std::string& oid, ObjectReadOperation *op, bufferlist *pbl);
     int aio_operate(const std::string& oid, AioCompletion *c, ObjectWriteOperation *op);
     int aio_operate(const std::string& oid, AioCompletion *c, ObjectWriteOperation *op, int flags);
+    /**
+     * Schedule several async write operations in one call
+     *
+     * Entries are matched up by index; each completion fires
+     * independently, exactly as if the operations had been submitted
+     * one at a time.  The objecter state is acquired once for the
+     * whole batch, which cuts the per-op locking overhead when
+     * issuing many small operations.
+     *
+     * @param oids names of the objects
+     * @param ops operations to perform, one per object
+     * @param comps what to do when each operation is safe and complete
+     * @returns 0 on success, -EINVAL if the vector sizes differ,
+     * -EROFS if the io context specifies a snapshot
+     */
+    int aio_operate_batch(const std::vector<std::string>& oids,
+			  const std::vector<ObjectWriteOperation*>& ops,
+			  const std::vector<AioCompletion*>& comps);
     /**
      * Schedule an async write operation with explicit snapshot parameters
      *
@@ -1250,6 +1268,46 @@ namespace librados
     void set_osdmap_full_try();
     void unset_osdmap_full_try();
 
+    /**
+     * Set the default read affinity for this IoCtx.
+     *
+     * The given flag (OPERATION_BALANCE_READS to spread reads over
+     * all replicas, OPERATION_LOCALIZE_READS to favor the replica
+     * closest to this client's crush_location, or 0 to restore
+     * reading from the primary) is applied to every read issued
+     * through this IoCtx.  Reads from replicas may return stale data
+     * while writes are in flight, so this should only be used where
+     * that is acceptable (e.g. immutable or versioned objects).
+     *
+     * @returns 0 on success, -EINVAL for any other flag combination
+     */
+    int set_read_affinity(uint32_t flags);
+
+    /**
+     * Reap asynchronous I/O callbacks in the calling thread.
+     *
+     * Only valid after set_pollmode(true): in poll mode, completion
+     * and safe callbacks of asynchronous object operations issued on
+     * this io context are no longer run from an internal thread but
+     * queued until the application calls aio_poll(), which executes
+     * them inline.  Intended for applications running their own event
+     * loops; waiting on a completion (wait_for_complete() etc.) still
+     * works as usual.
+     *
+     * @param max maximum number of callbacks to run, 0 for no limit
+     * @param timeout_ms how long to wait if no completion is pending,
+     *        0 to return immediately
+     * @returns number of callbacks run, 0 on timeout, -EINVAL if the
+     *          io context is not in poll mode
+     */
+    int aio_poll(int max, uint64_t timeout_ms);
+
+    /**
+     * Enable or disable poll mode; see aio_poll(). Must not be
+     * changed while asynchronous operations are in flight.
+     */
+    void set_pollmode(bool enabled);
+
   private:
     /* You can only get IoCtx instances from Rados */
     IoCtx(IoCtxImpl *io_ctx_impl_);
@@ -87,6 +87,20 @@ int rados_striper_set_object_layout_stripe_count(rados_striper_t striper,
 int rados_striper_set_object_layout_object_size(rados_striper_t striper,
                                                 unsigned int object_size);
 
+/**
+ * Declares that striped objects handled through this striper have a
+ * single concurrent user. The striper then spares the shared lock
+ * round trips on each read and write; this is only safe if the caller
+ * guarantees that no other client writes or truncates the objects
+ * concurrently.
+ *
+ * @param striper the targetted striper
+ * @param single_writer non zero to activate single writer mode
+ * @returns 0 on success, negative error code on failure
+ */
+int rados_striper_set_single_writer(rados_striper_t striper,
+                                    int single_writer);
+
 /** @} init */
 
 /**
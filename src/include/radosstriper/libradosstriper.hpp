@@ -107,6 +107,15 @@ namespace libradosstriper
      */
     int set_object_layout_object_size(unsigned int object_size);
 
+    /*
+     * declare that striped objects handled through this striper have a
+     * single concurrent user. The striper then spares the shared lock
+     * round trips on each read and write; this is only safe if the
+     * caller guarantees that no other client writes or truncates the
+     * objects concurrently.
+     */
+    int set_single_writer(bool single_writer);
+
     /**
      * Get the value of an extended attribute on a striped object
      */
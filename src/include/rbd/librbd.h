@@ -258,6 +258,23 @@ CEPH_RBD_API int rbd_remove_with_progress(rados_ioctx_t io, const char *name,
 CEPH_RBD_API int rbd_rename(rados_ioctx_t src_io_ctx, const char *srcname,
                             const char *destname);
 
+/**
+ * Create (or remove) the same snapshot on many images, pipelined with
+ * bounded concurrency inside the library.  results must hold
+ * image_count entries and receives the per-image error codes; the
+ * return value is the first error encountered.
+ */
+CEPH_RBD_API int rbd_snap_create_batch(rados_ioctx_t io,
+                                       const char **image_names,
+                                       size_t image_count,
+                                       const char *snap_name,
+                                       int *results);
+CEPH_RBD_API int rbd_snap_remove_batch(rados_ioctx_t io,
+                                       const char **image_names,
+                                       size_t image_count,
+                                       const char *snap_name,
+                                       int *results);
+
 CEPH_RBD_API int rbd_trash_move(rados_ioctx_t io, const char *name,
                                 uint64_t delay);
 CEPH_RBD_API int rbd_trash_get(rados_ioctx_t io, const char *id,
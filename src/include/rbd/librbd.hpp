@@ -160,6 +160,21 @@ public:
   int remove_with_progress(IoCtx& io_ctx, const char *name, ProgressContext& pctx);
   int rename(IoCtx& src_io_ctx, const char *srcname, const char *destname);
 
+  /**
+   * Create (or remove) the same snapshot on many images, pipelined
+   * with bounded concurrency inside the library.  Per-image error
+   * codes are stored in *results, parallel to image_names; returns
+   * the first error encountered.
+   */
+  int snap_create_batch(IoCtx& io_ctx,
+                        const std::vector<std::string>& image_names,
+                        const std::string& snap_name,
+                        std::vector<int>* results);
+  int snap_remove_batch(IoCtx& io_ctx,
+                        const std::vector<std::string>& image_names,
+                        const std::string& snap_name,
+                        std::vector<int>* results);
+
   int trash_move(IoCtx &io_ctx, const char *name, uint64_t delay);
   int trash_get(IoCtx &io_ctx, const char *id, trash_image_info_t *info);
   int trash_list(IoCtx &io_ctx, std::vector<trash_image_info_t> &entries);
@@ -84,6 +84,7 @@ JournalPlayer::~JournalPlayer() {
     Mutex::Locker locker(m_lock);
     assert(m_shut_down);
     assert(m_fetch_object_numbers.empty());
+    assert(m_fetch_ahead_object_numbers.empty());
     assert(!m_watch_scheduled);
   }
   m_replay_handler->put();
@@ -320,6 +321,12 @@ int JournalPlayer::process_prefetch(uint64_t object_number) {
   ldout(m_cct, 10) << "switching to playback mode" << dendl;
   m_state = STATE_PLAYBACK;
 
+  // start reading ahead of each splay offset so that playback isn't
+  // stalled waiting on a fetch at every object boundary
+  for (auto &player_pair : m_object_players) {
+    fetch_ahead(player_pair.second);
+  }
+
   // if we have a valid commit position, our read should start with
   // the next consistent journal entry in the sequence
   if (m_commit_position_valid) {
@@ -508,6 +515,10 @@ void JournalPlayer::prune_tag(uint64_t tag_tid) {
       ObjectPlayerPtr object_player(player_pair.second);
       object_player->set_refetch_state(ObjectPlayer::REFETCH_STATE_IMMEDIATE);
     }
+    for (auto &player_pair : m_fetch_ahead_players) {
+      player_pair.second->set_refetch_state(
+        ObjectPlayer::REFETCH_STATE_IMMEDIATE);
+    }
   }
 
   // trim empty player to prefetch the next available object
@@ -581,6 +592,9 @@ bool JournalPlayer::remove_empty_object_player(const ObjectPlayerPtr &player) {
     for (auto &pair : m_object_players) {
       pair.second->set_refetch_state(ObjectPlayer::REFETCH_STATE_IMMEDIATE);
     }
+    for (auto &pair : m_fetch_ahead_players) {
+      pair.second->set_refetch_state(ObjectPlayer::REFETCH_STATE_IMMEDIATE);
+    }
     return false;
   }
 
@@ -591,7 +605,32 @@ bool JournalPlayer::remove_empty_object_player(const ObjectPlayerPtr &player) {
   m_watch_step = WATCH_STEP_FETCH_CURRENT;
 
   uint64_t next_object_num = player->get_object_number() + splay_width;
-  fetch(next_object_num);
+  uint8_t splay_offset = next_object_num % splay_width;
+  auto ahead_it = m_fetch_ahead_players.find(splay_offset);
+  if (ahead_it == m_fetch_ahead_players.end()) {
+    fetch(next_object_num);
+    return true;
+  }
+
+  // promote the read-ahead player to the active player for this offset
+  ObjectPlayerPtr next_player(ahead_it->second);
+  assert(next_player->get_object_number() == next_object_num);
+  m_fetch_ahead_players.erase(ahead_it);
+  m_object_players[splay_offset] = next_player;
+
+  if (m_fetch_ahead_object_numbers.erase(next_object_num) > 0) {
+    // fetch still in-flight -- convert it to a foreground fetch so that
+    // playback waits for it to complete
+    ldout(m_cct, 15) << __func__ << ": promoted in-flight read-ahead of "
+                     << next_player->get_oid() << dendl;
+    m_fetch_object_numbers.insert(next_object_num);
+    return true;
+  }
+
+  ldout(m_cct, 15) << __func__ << ": promoted read-ahead of "
+                   << next_player->get_oid() << dendl;
+  fetch_ahead(next_player);
+  remove_empty_object_player(next_player);
   return true;
 }
 
@@ -622,12 +661,59 @@ void JournalPlayer::fetch(const ObjectPlayerPtr &object_player) {
   object_player->fetch(fetch_ctx);
 }
 
+void JournalPlayer::fetch_ahead(const ObjectPlayerPtr &object_player) {
+  assert(m_lock.is_locked());
+  if (m_state != STATE_PLAYBACK) {
+    return;
+  }
+
+  uint64_t object_num = object_player->get_object_number();
+  uint8_t splay_width = m_journal_metadata->get_splay_width();
+  uint64_t object_set = object_num / splay_width;
+  if (object_set >= m_journal_metadata->get_active_set()) {
+    // the next object in the sequence might not exist yet
+    return;
+  }
+
+  uint8_t splay_offset = object_num % splay_width;
+  if (m_fetch_ahead_players.count(splay_offset) != 0) {
+    return;
+  }
+
+  uint64_t next_object_num = object_num + splay_width;
+  ObjectPlayerPtr next_player(new ObjectPlayer(
+    m_ioctx, m_object_oid_prefix, next_object_num,
+    m_journal_metadata->get_timer(), m_journal_metadata->get_timer_lock(),
+    m_journal_metadata->get_order(),
+    m_journal_metadata->get_settings().max_fetch_bytes));
+
+  ldout(m_cct, 10) << __func__ << ": " << next_player->get_oid() << dendl;
+  assert(m_fetch_ahead_object_numbers.count(next_object_num) == 0);
+  m_fetch_ahead_object_numbers.insert(next_object_num);
+  m_fetch_ahead_players[splay_offset] = next_player;
+
+  next_player->fetch(new C_Fetch(this, next_object_num));
+}
+
 void JournalPlayer::handle_fetched(uint64_t object_num, int r) {
   ldout(m_cct, 10) << __func__ << ": "
                    << utils::get_object_name(m_object_oid_prefix, object_num)
                    << ": r=" << r << dendl;
 
   Mutex::Locker locker(m_lock);
+  if (m_fetch_ahead_object_numbers.erase(object_num) > 0) {
+    // read-ahead of the next splay object -- it remains parked until the
+    // active object player for its offset drains
+    ldout(m_cct, 15) << __func__ << ": read-ahead fetch complete" << dendl;
+    if (!m_shut_down && r < 0) {
+      // drop the read-ahead player -- promotion will fall back to a
+      // foreground fetch and surface the error through the normal path
+      uint8_t splay_width = m_journal_metadata->get_splay_width();
+      m_fetch_ahead_players.erase(object_num % splay_width);
+    }
+    return;
+  }
+
   assert(m_fetch_object_numbers.count(object_num) == 1);
   m_fetch_object_numbers.erase(object_num);
 
@@ -637,7 +723,9 @@ void JournalPlayer::handle_fetched(uint64_t object_num, int r) {
 
   if (r == 0) {
     ObjectPlayerPtr object_player = get_object_player(object_num);
-    remove_empty_object_player(object_player);
+    if (!remove_empty_object_player(object_player)) {
+      fetch_ahead(object_player);
+    }
   }
   process_state(object_num, r);
 }
@@ -112,9 +112,11 @@ private:
   bool m_handler_notified = false;
 
   ObjectNumbers m_fetch_object_numbers;
+  ObjectNumbers m_fetch_ahead_object_numbers;
 
   PrefetchSplayOffsets m_prefetch_splay_offsets;
   SplayedObjectPlayers m_object_players;
+  SplayedObjectPlayers m_fetch_ahead_players;
 
   bool m_commit_position_valid = false;
   ObjectPosition m_commit_position;
@@ -141,6 +143,7 @@ private:
 
   void fetch(uint64_t object_num);
   void fetch(const ObjectPlayerPtr &object_player);
+  void fetch_ahead(const ObjectPlayerPtr &object_player);
   void handle_fetched(uint64_t object_num, int r);
   void refetch(bool immediate);
 
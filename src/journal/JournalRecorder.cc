@@ -163,15 +163,17 @@ void JournalRecorder::close_and_advance_object_set(uint64_t object_set) {
 
   ldout(m_cct, 20) << __func__ << ": closing active object set "
                    << object_set << dendl;
-  if (close_object_set(m_current_set)) {
-    advance_object_set();
-  }
+
+  // overlap the in-flight object closes with the active set update so
+  // the roll costs the longer of the two round-trips instead of their
+  // sum -- appends restart on the new set once both have completed
+  close_object_set(m_current_set);
+  advance_object_set();
 }
 
 void JournalRecorder::advance_object_set() {
   assert(m_lock.is_locked());
 
-  assert(m_in_flight_object_closes == 0);
   ldout(m_cct, 20) << __func__ << ": advance to object set " << m_current_set
                    << dendl;
   m_journal_metadata->set_active_set(m_current_set, new C_AdvanceObjectSet(
@@ -326,14 +328,10 @@ void JournalRecorder::handle_closed(ObjectRecorder *object_recorder) {
   // object closed after advance active set committed
   ldout(m_cct, 20) << __func__ << ": object "
                    << active_object_recorder->get_oid() << " closed" << dendl;
-  if (m_in_flight_object_closes == 0) {
-    if (m_in_flight_advance_sets == 0) {
-      // peer forced closing of object set
-      open_object_set();
-    } else {
-      // local overflow advanced object set
-      advance_object_set();
-    }
+  if (m_in_flight_object_closes == 0 && m_in_flight_advance_sets == 0) {
+    // a local overflow already advanced the active set in parallel with
+    // the closes (or a peer forced the close) -- safe to restart appends
+    open_object_set();
   }
 }
 
@@ -224,11 +224,17 @@ bool ObjectRecorder::flush_appends(bool force) {
     return true;
   }
 
+  // batch appends while below the configured flush limits. the append
+  // task bounds the added latency to m_flush_age, so a non-zero age is
+  // sufficient to enable batching on its own
   if (m_append_buffers.empty() ||
       (!force &&
        m_size + m_pending_bytes < m_soft_max_size &&
-       (m_flush_interval > 0 && m_append_buffers.size() < m_flush_interval) &&
-       (m_flush_bytes > 0 && m_pending_bytes < m_flush_bytes))) {
+       (m_flush_age > 0 ||
+        (m_flush_interval > 0 && m_flush_bytes > 0)) &&
+       (m_flush_interval == 0 ||
+        m_append_buffers.size() < m_flush_interval) &&
+       (m_flush_bytes == 0 || m_pending_bytes < m_flush_bytes))) {
     return false;
   }
 
@@ -372,16 +378,21 @@ void ObjectRecorder::send_appends_aio() {
   C_AppendFlush *append_flush = new C_AppendFlush(this, append_tid);
   C_Gather *gather_ctx = new C_Gather(m_cct, append_flush);
 
-  librados::ObjectWriteOperation op;
-  client::guard_append(&op, m_soft_max_size);
+  // group-commit the batch as a single append op to avoid per-entry
+  // op overhead on the OSD
+  bufferlist append_bl;
   for (AppendBuffers::iterator it = append_buffers->begin();
        it != append_buffers->end(); ++it) {
     ldout(m_cct, 20) << __func__ << ": flushing " << *it->first
                      << dendl;
-    op.append(it->second);
-    op.set_op_flags2(CEPH_OSD_OP_FLAG_FADVISE_DONTNEED);
+    append_bl.append(it->second);
   }
 
+  librados::ObjectWriteOperation op;
+  client::guard_append(&op, m_soft_max_size);
+  op.append(append_bl);
+  op.set_op_flags2(CEPH_OSD_OP_FLAG_FADVISE_DONTNEED);
+
   librados::AioCompletion *rados_completion =
     librados::Rados::aio_create_completion(gather_ctx->new_sub(), nullptr,
                                            utils::rados_ctx_callback);
@@ -144,6 +144,8 @@ public:
   virtual int init(string option_str="") = 0;
   virtual int open(std::ostream &out) = 0;
   virtual int create_and_open(std::ostream &out) = 0;
+  /// override the conf-supplied column family spec; call before open
+  virtual void set_column_family_spec(const std::string& spec) {}
   virtual void close() { }
 
   virtual Transaction get_transaction() = 0;
@@ -295,7 +297,7 @@ public:
     return _get_iterator();
   }
 
-  Iterator get_iterator(const std::string &prefix) {
+  virtual Iterator get_iterator(const std::string &prefix) {
     return std::make_shared<IteratorImpl>(prefix, get_iterator());
   }
 
@@ -313,6 +315,12 @@ public:
   /// compact the underlying store
   virtual void compact() {}
 
+  /// Hint that a large sorted write burst (PG import, bulk backfill) is
+  /// starting (true) or done (false).  Implementations may suspend
+  /// background compaction for the duration so the burst lands without
+  /// repeatedly rewriting the same ranges.
+  virtual void set_bulk_load(bool enable) {}
+
   /// compact db for all keys with a given prefix
   virtual void compact_prefix(const std::string& prefix) {}
   /// compact db for all keys with a given prefix, async
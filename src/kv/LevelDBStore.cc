@@ -354,6 +354,12 @@ void LevelDBStore::compact_thread_entry()
       compact_queue_lock.Unlock();
       logger->inc(l_leveldb_compact_range);
       compact_range(range.first, range.second);
+      // give foreground io a chance between compactions
+      if (g_conf->leveldb_compact_queue_delay > 0) {
+	utime_t delay;
+	delay.set_from_double(g_conf->leveldb_compact_queue_delay);
+	delay.sleep();
+      }
       compact_queue_lock.Lock();
       continue;
     }
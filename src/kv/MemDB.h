@@ -22,6 +22,7 @@
 #include "include/encoding_btree.h"
 #include "KeyValueDB.h"
 #include "osd/osd_types.h"
+#include "common/RWLock.h"
 
 using std::string;
 #define KEY_DELIM '\0' 
@@ -29,7 +30,9 @@ using std::string;
 class MemDB : public KeyValueDB
 {
   typedef std::pair<std::pair<std::string, std::string>, bufferlist> ms_op_t;
-  std::mutex m_lock;
+  // guards m_map and the byte/seq counters; reads and iteration take it
+  // shared so concurrent readers don't serialize on a single mutex
+  RWLock m_lock;
   uint64_t m_total_bytes;
   uint64_t m_allocated_bytes;
 
@@ -57,6 +60,7 @@ class MemDB : public KeyValueDB
 
 public:
   MemDB(CephContext *c, const string &path, void *p) :
+    m_lock("MemDB::m_lock"),
     m_using_btree(false), m_cct(c), m_priv(p), m_db_path(path), iterator_seq_no(1)
   {
     //Nothing as of now
@@ -145,17 +149,17 @@ public:
       mdb_iter_t m_iter;
       std::pair<string, bufferlist> m_key_value;
       mdb_map_t *m_map_p;
-      std::mutex *m_map_lock_p;
+      RWLock *m_map_lock_p;
       uint64_t *global_seq_no;
       uint64_t this_seq_no;
       bool m_using_btree;
 
   public:
-    MDBWholeSpaceIteratorImpl(mdb_map_t *btree_p, std::mutex *btree_lock_p,
+    MDBWholeSpaceIteratorImpl(mdb_map_t *btree_p, RWLock *btree_lock_p,
                               uint64_t *iterator_seq_no, bool using_btree) {
       m_map_p = btree_p;
       m_map_lock_p = btree_lock_p;
-      std::lock_guard<std::mutex> l(*m_map_lock_p);
+      RWLock::RLocker l(*m_map_lock_p);
       global_seq_no = iterator_seq_no;
       this_seq_no = *iterator_seq_no;
       m_using_btree = using_btree;
@@ -188,12 +192,12 @@ public:
   };
 
   uint64_t get_estimated_size(std::map<std::string,uint64_t> &extra) override {
-      std::lock_guard<std::mutex> l(m_lock);
+      RWLock::RLocker l(m_lock);
       return m_allocated_bytes;
   };
 
   int get_statfs(struct store_statfs_t *buf) override {
-    std::lock_guard<std::mutex> l(m_lock);
+    RWLock::RLocker l(m_lock);
     buf->reset();
     buf->total = m_total_bytes;
     buf->allocated = m_allocated_bytes;
@@ -3,6 +3,7 @@
 
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <memory>
 #include <errno.h>
@@ -14,6 +15,7 @@
 #include "rocksdb/table.h"
 #include "rocksdb/env.h"
 #include "rocksdb/slice.h"
+#include "rocksdb/slice_transform.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/utilities/convenience.h"
@@ -181,6 +183,15 @@ int RocksDBStore::tryInterpret(const string key, const string val, rocksdb::Opti
     int ret = string2bool(val, disableWAL);
     if (ret != 0)
       return ret;
+  } else if (key == "prefix_extractor") {
+    // fixed-length prefix transform so memtable/table prefix bloom
+    // filters (memtable_prefix_bloom_size_ratio et al) have a prefix
+    // definition to work against
+    std::string err;
+    int f = strict_sistrtoll(val.c_str(), &err);
+    if (!err.empty() || f <= 0)
+      return -EINVAL;
+    opt.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(f));
   } else {
     //unrecognize config options.
     return -EINVAL;
@@ -346,14 +357,95 @@ int RocksDBStore::do_open(ostream &out, bool create_if_missing)
 	   << dendl;
 
   opt.merge_operator.reset(new MergeOperatorRouter(*this));
-  status = rocksdb::DB::Open(opt, path, &db);
-  if (!status.ok()) {
-    derr << status.ToString() << dendl;
-    return -EINVAL;
+
+  // column family spec from conf: "prefix[=options][;prefix...]".  only
+  // consulted when creating the db; existing families are rediscovered
+  // (and retuned) on every open.
+  map<string,string> cf_spec;
+  {
+    list<string> items;
+    get_str_list(cf_spec_override.length() ? cf_spec_override
+		 : g_conf->rocksdb_column_families, ";", items);
+    for (auto& i : items) {
+      size_t pos = i.find('=');
+      if (pos == string::npos) {
+	cf_spec[i] = string();
+      } else {
+	cf_spec[i.substr(0, pos)] = i.substr(pos + 1);
+      }
+    }
   }
-  
+  auto get_cf_options = [&](const string& name,
+			    rocksdb::ColumnFamilyOptions *cf_opt) {
+    *cf_opt = rocksdb::ColumnFamilyOptions(opt);
+    auto p = cf_spec.find(name);
+    if (p != cf_spec.end() && p->second.length()) {
+      rocksdb::Status r = rocksdb::GetColumnFamilyOptionsFromString(
+	*cf_opt, p->second, cf_opt);
+      if (!r.ok()) {
+	derr << __func__ << " invalid options for column family " << name
+	     << ": " << p->second << dendl;
+	return -EINVAL;
+      }
+    }
+    return 0;
+  };
+
+  std::vector<std::string> existing_cfs;
+  rocksdb::Status lstatus = rocksdb::DB::ListColumnFamilies(
+    rocksdb::DBOptions(opt), path, &existing_cfs);
+  if (lstatus.ok() && existing_cfs.size() > 1) {
+    std::vector<rocksdb::ColumnFamilyDescriptor> descs;
+    for (auto& name : existing_cfs) {
+      rocksdb::ColumnFamilyOptions cf_opt;
+      if (get_cf_options(name, &cf_opt) < 0) {
+	return -EINVAL;
+      }
+      descs.push_back(rocksdb::ColumnFamilyDescriptor(name, cf_opt));
+    }
+    std::vector<rocksdb::ColumnFamilyHandle*> handles;
+    status = rocksdb::DB::Open(opt, path, descs, &handles, &db);
+    if (!status.ok()) {
+      derr << status.ToString() << dendl;
+      return -EINVAL;
+    }
+    for (unsigned i = 0; i < handles.size(); ++i) {
+      if (existing_cfs[i] == rocksdb::kDefaultColumnFamilyName) {
+	// the default family is addressed through db directly
+	delete handles[i];
+      } else {
+	dout(10) << __func__ << " column family " << existing_cfs[i] << dendl;
+	cf_handles[existing_cfs[i]] = handles[i];
+      }
+    }
+  } else {
+    status = rocksdb::DB::Open(opt, path, &db);
+    if (!status.ok()) {
+      derr << status.ToString() << dendl;
+      return -EINVAL;
+    }
+    if (create_if_missing) {
+      for (auto& p : cf_spec) {
+	rocksdb::ColumnFamilyOptions cf_opt;
+	if (get_cf_options(p.first, &cf_opt) < 0) {
+	  return -EINVAL;
+	}
+	rocksdb::ColumnFamilyHandle *h;
+	status = db->CreateColumnFamily(cf_opt, p.first, &h);
+	if (!status.ok()) {
+	  derr << __func__ << " failed to create column family " << p.first
+	       << ": " << status.ToString() << dendl;
+	  return -EINVAL;
+	}
+	dout(10) << __func__ << " created column family " << p.first << dendl;
+	cf_handles[p.first] = h;
+      }
+    }
+  }
+
   PerfCountersBuilder plb(g_ceph_context, "rocksdb", l_rocksdb_first, l_rocksdb_last);
   plb.add_u64_counter(l_rocksdb_gets, "get", "Gets");
+  plb.add_u64_counter(l_rocksdb_iterators, "get_iterator", "Iterators created");
   plb.add_u64_counter(l_rocksdb_txns, "submit_transaction", "Submit transactions");
   plb.add_u64_counter(l_rocksdb_txns_sync, "submit_transaction_sync", "Submit transactions sync");
   plb.add_time_avg(l_rocksdb_get_latency, "get_latency", "Get latency");
@@ -396,6 +488,10 @@ RocksDBStore::~RocksDBStore()
   delete logger;
 
   // Ensure db is destroyed before dependent db_cache and filterpolicy
+  for (auto& p : cf_handles) {
+    delete p.second;
+  }
+  cf_handles.clear();
   delete db;
   db = nullptr;
 
@@ -600,16 +696,17 @@ void RocksDBStore::RocksDBTransactionImpl::set(
   const bufferlist &to_set_bl)
 {
   string key = combine_strings(prefix, k);
+  auto cf = db->get_cf_handle(prefix);
 
   // bufferlist::c_str() is non-constant, so we can't call c_str()
   if (to_set_bl.is_contiguous() && to_set_bl.length() > 0) {
-    bat.Put(rocksdb::Slice(key),
+    bat.Put(cf, rocksdb::Slice(key),
 	     rocksdb::Slice(to_set_bl.buffers().front().c_str(),
 			    to_set_bl.length()));
   } else {
     rocksdb::Slice key_slice(key);
     rocksdb::Slice value_slices[to_set_bl.buffers().size()];
-    bat.Put(nullptr, rocksdb::SliceParts(&key_slice, 1),
+    bat.Put(cf, rocksdb::SliceParts(&key_slice, 1),
             prepare_sliceparts(to_set_bl, value_slices));
   }
 }
@@ -621,16 +718,17 @@ void RocksDBStore::RocksDBTransactionImpl::set(
 {
   string key;
   combine_strings(prefix, k, keylen, &key);
+  auto cf = db->get_cf_handle(prefix);
 
   // bufferlist::c_str() is non-constant, so we can't call c_str()
   if (to_set_bl.is_contiguous() && to_set_bl.length() > 0) {
-    bat.Put(rocksdb::Slice(key),
+    bat.Put(cf, rocksdb::Slice(key),
 	     rocksdb::Slice(to_set_bl.buffers().front().c_str(),
 			    to_set_bl.length()));
   } else {
     rocksdb::Slice key_slice(key);
     rocksdb::Slice value_slices[to_set_bl.buffers().size()];
-    bat.Put(nullptr, rocksdb::SliceParts(&key_slice, 1),
+    bat.Put(cf, rocksdb::SliceParts(&key_slice, 1),
             prepare_sliceparts(to_set_bl, value_slices));
   }
 }
@@ -638,7 +736,7 @@ void RocksDBStore::RocksDBTransactionImpl::set(
 void RocksDBStore::RocksDBTransactionImpl::rmkey(const string &prefix,
 					         const string &k)
 {
-  bat.Delete(combine_strings(prefix, k));
+  bat.Delete(db->get_cf_handle(prefix), combine_strings(prefix, k));
 }
 
 void RocksDBStore::RocksDBTransactionImpl::rmkey(const string &prefix,
@@ -647,28 +745,30 @@ void RocksDBStore::RocksDBTransactionImpl::rmkey(const string &prefix,
 {
   string key;
   combine_strings(prefix, k, keylen, &key);
-  bat.Delete(key);
+  bat.Delete(db->get_cf_handle(prefix), key);
 }
 
 void RocksDBStore::RocksDBTransactionImpl::rm_single_key(const string &prefix,
 					                 const string &k)
 {
-  bat.SingleDelete(combine_strings(prefix, k));
+  bat.SingleDelete(db->get_cf_handle(prefix), combine_strings(prefix, k));
 }
 
 void RocksDBStore::RocksDBTransactionImpl::rmkeys_by_prefix(const string &prefix)
 {
+  auto cf = db->get_cf_handle(prefix);
   if (db->enable_rmrange) {
     string endprefix = prefix;
     endprefix.push_back('\x01');
-    bat.DeleteRange(combine_strings(prefix, string()),
+    bat.DeleteRange(cf,
+		    combine_strings(prefix, string()),
 		    combine_strings(endprefix, string()));
   } else {
     KeyValueDB::Iterator it = db->get_iterator(prefix);
     for (it->seek_to_first();
 	 it->valid();
 	 it->next()) {
-      bat.Delete(combine_strings(prefix, it->key()));
+      bat.Delete(cf, combine_strings(prefix, it->key()));
     }
   }
 }
@@ -677,8 +777,11 @@ void RocksDBStore::RocksDBTransactionImpl::rm_range_keys(const string &prefix,
                                                          const string &start,
                                                          const string &end)
 {
+  auto cf = db->get_cf_handle(prefix);
   if (db->enable_rmrange) {
-    bat.DeleteRange(combine_strings(prefix, start), combine_strings(prefix, end));
+    bat.DeleteRange(cf,
+		    combine_strings(prefix, start),
+		    combine_strings(prefix, end));
   } else {
     auto it = db->get_iterator(prefix);
     it->lower_bound(start);
@@ -686,7 +789,7 @@ void RocksDBStore::RocksDBTransactionImpl::rm_range_keys(const string &prefix,
       if (it->key() >= end) {
         break;
       }
-      bat.Delete(combine_strings(prefix, it->key()));
+      bat.Delete(cf, combine_strings(prefix, it->key()));
       it->next();
     }
   }
@@ -698,17 +801,18 @@ void RocksDBStore::RocksDBTransactionImpl::merge(
   const bufferlist &to_set_bl)
 {
   string key = combine_strings(prefix, k);
+  auto cf = db->get_cf_handle(prefix);
 
   // bufferlist::c_str() is non-constant, so we can't call c_str()
   if (to_set_bl.is_contiguous() && to_set_bl.length() > 0) {
-    bat.Merge(rocksdb::Slice(key),
+    bat.Merge(cf, rocksdb::Slice(key),
 	       rocksdb::Slice(to_set_bl.buffers().front().c_str(),
 			    to_set_bl.length()));
   } else {
     // make a copy
     rocksdb::Slice key_slice(key);
     rocksdb::Slice value_slices[to_set_bl.buffers().size()];
-    bat.Merge(nullptr, rocksdb::SliceParts(&key_slice, 1),
+    bat.Merge(cf, rocksdb::SliceParts(&key_slice, 1),
               prepare_sliceparts(to_set_bl, value_slices));
   }
 }
@@ -720,11 +824,14 @@ int RocksDBStore::get(
     std::map<string, bufferlist> *out)
 {
   utime_t start = ceph_clock_now();
+  auto cf = get_cf_handle(prefix);
   for (std::set<string>::const_iterator i = keys.begin();
        i != keys.end(); ++i) {
     std::string value;
     std::string bound = combine_strings(prefix, *i);
-    auto status = db->Get(rocksdb::ReadOptions(), rocksdb::Slice(bound), &value);
+    auto status = db->Get(rocksdb::ReadOptions(),
+			  cf ? cf : db->DefaultColumnFamily(),
+			  rocksdb::Slice(bound), &value);
     if (status.ok()) {
       (*out)[*i].append(value);
     } else if (status.IsIOError()) {
@@ -749,7 +856,10 @@ int RocksDBStore::get(
   string value, k;
   rocksdb::Status s;
   k = combine_strings(prefix, key);
-  s = db->Get(rocksdb::ReadOptions(), rocksdb::Slice(k), &value);
+  auto cf = get_cf_handle(prefix);
+  s = db->Get(rocksdb::ReadOptions(),
+	      cf ? cf : db->DefaultColumnFamily(),
+	      rocksdb::Slice(k), &value);
   if (s.ok()) {
     out->append(value);
   } else if (s.IsNotFound()) {
@@ -775,7 +885,10 @@ int RocksDBStore::get(
   string value, k;
   combine_strings(prefix, key, keylen, &k);
   rocksdb::Status s;
-  s = db->Get(rocksdb::ReadOptions(), rocksdb::Slice(k), &value);
+  auto cf = get_cf_handle(prefix);
+  s = db->Get(rocksdb::ReadOptions(),
+	      cf ? cf : db->DefaultColumnFamily(),
+	      rocksdb::Slice(k), &value);
   if (s.ok()) {
     out->append(value);
   } else if (s.IsNotFound()) {
@@ -814,9 +927,33 @@ void RocksDBStore::compact()
   logger->inc(l_rocksdb_compact);
   rocksdb::CompactRangeOptions options;
   db->CompactRange(options, nullptr, nullptr);
+  for (auto& p : cf_handles) {
+    db->CompactRange(options, p.second, nullptr, nullptr);
+  }
 }
 
 
+void RocksDBStore::set_bulk_load(bool enable)
+{
+  // With auto compaction suspended a big sorted burst lands as cheap
+  // L0 flushes; rocksdb folds the backlog back in once we re-enable.
+  dout(5) << __func__ << " " << (enable ? "on" : "off") << dendl;
+  std::unordered_map<std::string, std::string> new_opt = {
+    { "disable_auto_compactions", enable ? "true" : "false" }
+  };
+  rocksdb::Status status = db->SetOptions(new_opt);
+  if (!status.ok()) {
+    derr << __func__ << " SetOptions: " << status.ToString() << dendl;
+    return;
+  }
+  for (auto& p : cf_handles) {
+    status = db->SetOptions(p.second, new_opt);
+    if (!status.ok())
+      derr << __func__ << " SetOptions on cf " << p.first << ": "
+	   << status.ToString() << dendl;
+  }
+}
+
 void RocksDBStore::compact_thread_entry()
 {
   compact_queue_lock.Lock();
@@ -828,6 +965,12 @@ void RocksDBStore::compact_thread_entry()
       compact_queue_lock.Unlock();
       logger->inc(l_rocksdb_compact_range);
       compact_range(range.first, range.second);
+      // give foreground io a chance between compactions
+      if (g_conf->rocksdb_compact_queue_delay > 0) {
+	utime_t delay;
+	delay.set_from_double(g_conf->rocksdb_compact_queue_delay);
+	delay.sleep();
+      }
       compact_queue_lock.Lock();
       continue;
     }
@@ -849,6 +992,13 @@ void RocksDBStore::compact_range_async(const string& start, const string& end)
       // dup; no-op
       return;
     }
+    if (p->first.substr(0, p->first.find('\0')) !=
+	start.substr(0, start.find('\0'))) {
+      // don't merge ranges with different prefixes; they may live in
+      // different column families
+      ++p;
+      continue;
+    }
     if (p->first <= end && p->first > start) {
       // merge with existing range to the right
       compact_queue.push_back(make_pair(start, p->second));
@@ -890,7 +1040,15 @@ void RocksDBStore::compact_range(const string& start, const string& end)
   rocksdb::CompactRangeOptions options;
   rocksdb::Slice cstart(start);
   rocksdb::Slice cend(end);
-  db->CompactRange(options, &cstart, &cend);
+  // all keys in a compacted range share a single prefix; if that prefix
+  // is mapped to a column family the data lives there, not in the
+  // default family
+  rocksdb::ColumnFamilyHandle *cf =
+    get_cf_handle(start.substr(0, start.find('\0')));
+  if (cf)
+    db->CompactRange(options, cf, &cstart, &cend);
+  else
+    db->CompactRange(options, &cstart, &cend);
 }
 RocksDBStore::RocksDBWholeSpaceIteratorImpl::~RocksDBWholeSpaceIteratorImpl()
 {
@@ -1021,8 +1179,24 @@ string RocksDBStore::past_prefix(const string &prefix)
   return limit;
 }
 
+KeyValueDB::Iterator RocksDBStore::get_iterator(const std::string& prefix)
+{
+  logger->inc(l_rocksdb_iterators);
+  auto cf = get_cf_handle(prefix);
+  if (cf) {
+    // keys inside a column family keep the combined prefix encoding, so
+    // the generic prefix view works unchanged on top of a cf iterator
+    return std::make_shared<IteratorImpl>(
+      prefix,
+      std::make_shared<RocksDBWholeSpaceIteratorImpl>(
+	db->NewIterator(rocksdb::ReadOptions(), cf)));
+  }
+  return KeyValueDB::get_iterator(prefix);
+}
+
 RocksDBStore::WholeSpaceIterator RocksDBStore::_get_iterator()
 {
+  logger->inc(l_rocksdb_iterators);
   return std::make_shared<RocksDBWholeSpaceIteratorImpl>(
         db->NewIterator(rocksdb::ReadOptions()));
 }
@@ -29,6 +29,7 @@ class PerfCounters;
 enum {
   l_rocksdb_first = 34300,
   l_rocksdb_gets,
+  l_rocksdb_iterators,
   l_rocksdb_txns,
   l_rocksdb_txns_sync,
   l_rocksdb_get_latency,
@@ -47,6 +48,7 @@ enum {
 
 namespace rocksdb{
   class DB;
+  class ColumnFamilyHandle;
   class Env;
   class Cache;
   class FilterPolicy;
@@ -78,6 +80,14 @@ class RocksDBStore : public KeyValueDB {
   uint64_t cache_size = 0;
   bool set_cache_flag = false;
 
+  /// column family handle per key prefix; prefixes not listed here live
+  /// in the default column family.  families are created at mkfs from
+  /// rocksdb_column_families and rediscovered on every open.
+  std::map<std::string,rocksdb::ColumnFamilyHandle*> cf_handles;
+
+  /// if set, used instead of rocksdb_column_families at create time
+  std::string cf_spec_override;
+
   int do_open(ostream &out, bool create_if_missing);
 
   // manage async compactions
@@ -107,11 +117,15 @@ public:
   bool disableWAL;
   bool enable_rmrange;
   void compact() override;
+  void set_bulk_load(bool enable) override;
 
   int tryInterpret(const string key, const string val, rocksdb::Options &opt);
   int ParseOptionsFromString(const string opt_str, rocksdb::Options &opt);
   static int _test_init(const string& dir);
   int init(string options_str) override;
+  void set_column_family_spec(const std::string& spec) override {
+    cf_spec_override = spec;
+  }
   /// compact rocksdb for all keys with a given prefix
   void compact_prefix(const string& prefix) override {
     compact_range(prefix, past_prefix(prefix));
@@ -310,6 +324,11 @@ public:
     size_t keylen,
     bufferlist *out) override;
 
+  rocksdb::ColumnFamilyHandle *get_cf_handle(const std::string& prefix) {
+    auto p = cf_handles.find(prefix);
+    return p == cf_handles.end() ? nullptr : p->second;
+  }
+  Iterator get_iterator(const std::string &prefix) override;
 
   class RocksDBWholeSpaceIteratorImpl :
     public KeyValueDB::WholeSpaceIteratorImpl {
@@ -1425,6 +1425,18 @@ extern "C" int ceph_ll_lookup(struct ceph_mount_info *cmount,
 					    flags, *perms);
 }
 
+extern "C" int ceph_ll_lookup_batch(struct ceph_mount_info *cmount,
+				    Inode *parent, const char **names,
+				    size_t count, Inode **out,
+				    struct ceph_statx *stx, unsigned want,
+				    unsigned flags, const UserPerm *perms)
+{
+  if (flags & ~CEPH_REQ_FLAG_MASK)
+    return -EINVAL;
+  return (cmount->get_client())->ll_lookup_batch(parent, names, count, out,
+						 stx, want, flags, *perms);
+}
+
 extern "C" int ceph_ll_put(class ceph_mount_info *cmount, Inode *in)
 {
   return (cmount->get_client()->ll_put(in));
@@ -229,8 +229,11 @@ struct C_aio_selfmanaged_snap_create_Complete : public C_aio_selfmanaged_snap_op
 
 librados::IoCtxImpl::IoCtxImpl() :
   ref_cnt(0), client(NULL), poolid(0), assert_ver(0), last_objver(0),
-  notify_timeout(30), aio_write_list_lock("librados::IoCtxImpl::aio_write_list_lock"),
-  aio_write_seq(0), objecter(NULL)
+  notify_timeout(30), extra_read_flags(0),
+  aio_write_list_lock("librados::IoCtxImpl::aio_write_list_lock"),
+  aio_write_seq(0), pollmode(false),
+  poll_completion_lock("librados::IoCtxImpl::poll_completion_lock"),
+  objecter(NULL)
 {
 }
 
@@ -239,11 +242,25 @@ librados::IoCtxImpl::IoCtxImpl(RadosClient *c, Objecter *objecter,
   : ref_cnt(0), client(c), poolid(poolid), snap_seq(s),
     assert_ver(0), last_objver(0),
     notify_timeout(c->cct->_conf->client_notify_timeout),
-    oloc(poolid), aio_write_list_lock("librados::IoCtxImpl::aio_write_list_lock"),
-    aio_write_seq(0), objecter(objecter)
+    oloc(poolid), extra_read_flags(0),
+    aio_write_list_lock("librados::IoCtxImpl::aio_write_list_lock"),
+    aio_write_seq(0), pollmode(false),
+    poll_completion_lock("librados::IoCtxImpl::poll_completion_lock"),
+    objecter(objecter)
 {
 }
 
+librados::IoCtxImpl::~IoCtxImpl()
+{
+  // run any poll mode completions never reaped by aio_poll() so that
+  // the references they hold are released
+  while (!poll_completions.empty()) {
+    Context *ctx = poll_completions.front();
+    poll_completions.pop_front();
+    ctx->complete(0);
+  }
+}
+
 void librados::IoCtxImpl::set_snap_read(snapid_t s)
 {
   if (!s)
@@ -252,6 +269,72 @@ void librados::IoCtxImpl::set_snap_read(snapid_t s)
   snap_seq = s;
 }
 
+int librados::IoCtxImpl::set_read_affinity(uint32_t flags)
+{
+  uint32_t f;
+  switch (flags) {
+  case 0:
+    f = 0;
+    break;
+  case librados::OPERATION_BALANCE_READS:
+    f = CEPH_OSD_FLAG_BALANCE_READS;
+    break;
+  case librados::OPERATION_LOCALIZE_READS:
+    f = CEPH_OSD_FLAG_LOCALIZE_READS;
+    break;
+  default:
+    return -EINVAL;
+  }
+  ldout(client->cct, 10) << "set read affinity flags " << extra_read_flags
+			 << " -> " << f << dendl;
+  extra_read_flags = f;
+  return 0;
+}
+
+void librados::IoCtxImpl::set_pollmode(bool enable)
+{
+  ldout(client->cct, 10) << "set pollmode " << pollmode << " -> " << enable
+			 << dendl;
+  pollmode = enable;
+}
+
+void librados::IoCtxImpl::queue_poll_completion(Context *ctx)
+{
+  Mutex::Locker l(poll_completion_lock);
+  poll_completions.push_back(ctx);
+  poll_completion_cond.Signal();
+}
+
+int librados::IoCtxImpl::aio_poll(int max, uint64_t timeout_ms)
+{
+  if (!pollmode)
+    return -EINVAL;
+  std::list<Context*> ready;
+  {
+    Mutex::Locker l(poll_completion_lock);
+    if (poll_completions.empty() && timeout_ms > 0) {
+      utime_t interval;
+      interval.set_from_double((double)timeout_ms / 1000.0);
+      poll_completion_cond.WaitInterval(poll_completion_lock, interval);
+    }
+    int n = 0;
+    while (!poll_completions.empty() && (max <= 0 || n < max)) {
+      ready.push_back(poll_completions.front());
+      poll_completions.pop_front();
+      ++n;
+    }
+  }
+  // run the callbacks inline, outside of the lock
+  int count = 0;
+  while (!ready.empty()) {
+    Context *ctx = ready.front();
+    ready.pop_front();
+    ctx->complete(0);
+    ++count;
+  }
+  return count;
+}
+
 int librados::IoCtxImpl::set_snap_write_context(snapid_t seq, vector<snapid_t>& snaps)
 {
   ::SnapContext n;
@@ -749,7 +832,8 @@ int librados::IoCtxImpl::operate_read(const object_t& oid,
   int op = o->ops[0].op.op;
   ldout(client->cct, 10) << ceph_osd_op_name(op) << " oid=" << oid << " nspace=" << oloc.nspace << dendl;
   Objecter::Op *objecter_op = objecter->prepare_read_op(oid, oloc,
-	                                      *o, snap_seq, pbl, flags,
+	                                      *o, snap_seq, pbl,
+	                                      flags | extra_read_flags,
 	                                      onack, &ver);
   objecter->op_submit(objecter_op);
 
@@ -789,7 +873,7 @@ int librados::IoCtxImpl::aio_operate_read(const object_t &oid,
 
   trace.event("init root span");
   Objecter::Op *objecter_op = objecter->prepare_read_op(oid, oloc,
-		 *o, snap_seq, pbl, flags,
+		 *o, snap_seq, pbl, flags | extra_read_flags,
 		 oncomplete, &c->objver, nullptr, 0, &trace);
   objecter->op_submit(objecter_op, &c->tid);
   trace.event("rados operate read submitted");
@@ -833,6 +917,41 @@ int librados::IoCtxImpl::aio_operate(const object_t& oid,
   return 0;
 }
 
+int librados::IoCtxImpl::aio_operate_batch(
+  const vector<object_t>& oids,
+  const vector< ::ObjectOperation*>& ops,
+  const vector<AioCompletionImpl*>& comps,
+  const SnapContext& snap_context, int flags)
+{
+  FUNCTRACE();
+  auto ut = ceph::real_clock::now();
+  /* can't write to a snapshot */
+  if (snap_seq != CEPH_NOSNAP)
+    return -EROFS;
+  assert(oids.size() == ops.size());
+  assert(oids.size() == comps.size());
+
+  vector<Objecter::Op*> prepared;
+  vector<ceph_tid_t*> ptids;
+  prepared.reserve(oids.size());
+  ptids.reserve(oids.size());
+  for (size_t i = 0; i < oids.size(); ++i) {
+    AioCompletionImpl *c = comps[i];
+    Context *oncomplete = new C_aio_Complete(c);
+#if defined(WITH_LTTNG) && defined(WITH_EVENTTRACE)
+    ((C_aio_Complete *) oncomplete)->oid = oids[i];
+#endif
+    c->io = this;
+    queue_aio_write(c);
+    prepared.push_back(objecter->prepare_mutate_op(
+      oids[i], oloc, *ops[i], snap_context, ut, flags,
+      oncomplete, &c->objver));
+    ptids.push_back(&c->tid);
+  }
+  objecter->op_submit_batch(prepared, ptids);
+  return 0;
+}
+
 int librados::IoCtxImpl::aio_read(const object_t oid, AioCompletionImpl *c,
 				  bufferlist *pbl, size_t len, uint64_t off,
 				  uint64_t snapid, const blkin_trace_info *info)
@@ -857,7 +976,7 @@ int librados::IoCtxImpl::aio_read(const object_t oid, AioCompletionImpl *c,
 
   Objecter::Op *o = objecter->prepare_read_op(
     oid, oloc,
-    off, len, snapid, pbl, 0,
+    off, len, snapid, pbl, extra_read_flags,
     oncomplete, &c->objver, nullptr, 0, &trace);
   objecter->op_submit(o, &c->tid);
   return 0;
@@ -890,7 +1009,7 @@ int librados::IoCtxImpl::aio_read(const object_t oid, AioCompletionImpl *c,
 
   Objecter::Op *o = objecter->prepare_read_op(
     oid, oloc,
-    off, len, snapid, &c->bl, 0,
+    off, len, snapid, &c->bl, extra_read_flags,
     oncomplete, &c->objver, nullptr, 0, &trace);
   objecter->op_submit(o, &c->tid);
   return 0;
@@ -930,7 +1049,7 @@ int librados::IoCtxImpl::aio_sparse_read(const object_t oid,
 
   Objecter::Op *o = objecter->prepare_read_op(
     oid, oloc,
-    onack->m_ops, snapid, NULL, 0,
+    onack->m_ops, snapid, NULL, extra_read_flags,
     onack, &c->objver);
   objecter->op_submit(o, &c->tid);
   return 0;
@@ -979,7 +1098,8 @@ int librados::IoCtxImpl::aio_cmpext(const object_t& oid,
   onack->m_ops.cmpext(off, cmp_len, cmp_buf, NULL);
 
   Objecter::Op *o = objecter->prepare_read_op(
-    oid, oloc, onack->m_ops, snap_seq, NULL, 0, onack, &c->objver);
+    oid, oloc, onack->m_ops, snap_seq, NULL, extra_read_flags,
+    onack, &c->objver);
   objecter->op_submit(o, &c->tid);
   return 0;
 }
@@ -1402,7 +1522,8 @@ int librados::IoCtxImpl::aio_exec(const object_t& oid, AioCompletionImpl *c,
   prepare_assert_ops(&rd);
   rd.call(cls, method, inbl);
   Objecter::Op *o = objecter->prepare_read_op(
-    oid, oloc, rd, snap_seq, outbl, 0, oncomplete, &c->objver);
+    oid, oloc, rd, snap_seq, outbl, extra_read_flags,
+    oncomplete, &c->objver);
   objecter->op_submit(o, &c->tid);
   return 0;
 }
@@ -1428,7 +1549,8 @@ int librados::IoCtxImpl::aio_exec(const object_t& oid, AioCompletionImpl *c,
   prepare_assert_ops(&rd);
   rd.call(cls, method, inbl);
   Objecter::Op *o = objecter->prepare_read_op(
-    oid, oloc, rd, snap_seq, &c->bl, 0, oncomplete, &c->objver);
+    oid, oloc, rd, snap_seq, &c->bl, extra_read_flags,
+    oncomplete, &c->objver);
   objecter->op_submit(o, &c->tid);
   return 0;
 }
@@ -2027,7 +2149,10 @@ void librados::IoCtxImpl::C_aio_Complete::finish(int r)
 
   if (c->callback_complete ||
       c->callback_safe) {
-    c->io->client->finisher.queue(new C_AioComplete(c));
+    if (c->io->pollmode)
+      c->io->queue_poll_completion(new C_AioComplete(c));
+    else
+      c->io->client->finisher.queue(new C_AioComplete(c));
   }
 
   if (c->aio_write_seq) {
@@ -40,6 +40,7 @@ struct librados::IoCtxImpl {
   version_t last_objver;
   uint32_t notify_timeout;
   object_locator_t oloc;
+  uint32_t extra_read_flags;  ///< CEPH_OSD_FLAG_* applied to every read
 
   Mutex aio_write_list_lock;
   ceph_tid_t aio_write_seq;
@@ -47,11 +48,20 @@ struct librados::IoCtxImpl {
   xlist<AioCompletionImpl*> aio_write_list;
   map<ceph_tid_t, std::list<AioCompletionImpl*> > aio_write_waiters;
 
+  /// poll mode: when enabled, aio callbacks are queued here and run
+  /// inline from aio_poll() in the caller's thread instead of hopping
+  /// through the client finisher
+  bool pollmode;
+  Mutex poll_completion_lock;
+  Cond poll_completion_cond;
+  std::list<Context*> poll_completions;
+
   Objecter *objecter;
 
   IoCtxImpl();
   IoCtxImpl(RadosClient *c, Objecter *objecter,
 	    int64_t poolid, snapid_t s);
+  ~IoCtxImpl();
 
   void dup(const IoCtxImpl& rhs) {
     // Copy everything except the ref count
@@ -63,11 +73,16 @@ struct librados::IoCtxImpl {
     last_objver = rhs.last_objver;
     notify_timeout = rhs.notify_timeout;
     oloc = rhs.oloc;
+    extra_read_flags = rhs.extra_read_flags;
     objecter = rhs.objecter;
   }
 
   void set_snap_read(snapid_t s);
   int set_snap_write_context(snapid_t seq, vector<snapid_t>& snaps);
+  int set_read_affinity(uint32_t flags);
+  void set_pollmode(bool enable);
+  void queue_poll_completion(Context *ctx);
+  int aio_poll(int max, uint64_t timeout_ms);
 
   void get() {
     ref_cnt++;
@@ -159,6 +174,10 @@ struct librados::IoCtxImpl {
   int aio_operate(const object_t& oid, ::ObjectOperation *o,
 		  AioCompletionImpl *c, const SnapContext& snap_context,
 		  int flags, const blkin_trace_info *trace_info = nullptr);
+  int aio_operate_batch(const std::vector<object_t>& oids,
+			const std::vector< ::ObjectOperation*>& ops,
+			const std::vector<AioCompletionImpl*>& comps,
+			const SnapContext& snap_context, int flags);
   int aio_operate_read(const object_t& oid, ::ObjectOperation *o,
 		       AioCompletionImpl *c, int flags, bufferlist *pbl, const blkin_trace_info *trace_info = nullptr);
 
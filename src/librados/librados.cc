@@ -1515,6 +1515,28 @@ int librados::IoCtx::aio_operate(const std::string& oid, AioCompletion *c,
 				  translate_flags(flags));
 }
 
+int librados::IoCtx::aio_operate_batch(
+  const std::vector<std::string>& oids,
+  const std::vector<ObjectWriteOperation*>& ops,
+  const std::vector<AioCompletion*>& comps)
+{
+  if (oids.size() != ops.size() || oids.size() != comps.size())
+    return -EINVAL;
+  vector<object_t> objs;
+  vector< ::ObjectOperation*> oops;
+  vector<librados::AioCompletionImpl*> cimpls;
+  objs.reserve(oids.size());
+  oops.reserve(oids.size());
+  cimpls.reserve(oids.size());
+  for (size_t i = 0; i < oids.size(); ++i) {
+    objs.push_back(object_t(oids[i]));
+    oops.push_back(&ops[i]->impl->o);
+    cimpls.push_back(comps[i]->pc);
+  }
+  return io_ctx_impl->aio_operate_batch(objs, oops, cimpls,
+					io_ctx_impl->snapc, 0);
+}
+
 int librados::IoCtx::aio_operate(const std::string& oid, AioCompletion *c,
 				 librados::ObjectWriteOperation *o,
 				 snap_t snap_seq, std::vector<snap_t>& snaps)
@@ -2228,6 +2250,21 @@ void librados::IoCtx::unset_osdmap_full_try()
   io_ctx_impl->objecter->unset_osdmap_full_try();
 }
 
+int librados::IoCtx::set_read_affinity(uint32_t flags)
+{
+  return io_ctx_impl->set_read_affinity(flags);
+}
+
+void librados::IoCtx::set_pollmode(bool enabled)
+{
+  io_ctx_impl->set_pollmode(enabled);
+}
+
+int librados::IoCtx::aio_poll(int max, uint64_t timeout_ms)
+{
+  return io_ctx_impl->aio_poll(max, timeout_ms);
+}
+
 ///////////////////////////// Rados //////////////////////////////
 void librados::Rados::version(int *major, int *minor, int *extra)
 {
@@ -3521,6 +3558,20 @@ extern "C" int rados_write(rados_ioctx_t io, const char *o, const char *buf, siz
   return retval;
 }
 
+extern "C" int rados_write_zerocopy(rados_ioctx_t io, const char *o, const char *buf, size_t len, uint64_t off)
+{
+  tracepoint(librados, rados_write_zerocopy_enter, io, o, buf, len, off);
+  if (len > UINT_MAX/2)
+    return -E2BIG;
+  librados::IoCtxImpl *ctx = (librados::IoCtxImpl *)io;
+  object_t oid(o);
+  bufferlist bl;
+  bl.push_back(buffer::create_static(len, (char*)buf));
+  int retval = ctx->write(oid, bl, len, off);
+  tracepoint(librados, rados_write_zerocopy_exit, retval);
+  return retval;
+}
+
 extern "C" int rados_append(rados_ioctx_t io, const char *o, const char *buf, size_t len)
 {
   tracepoint(librados, rados_append_enter, io, o, buf, len);
@@ -4623,6 +4674,23 @@ extern "C" int rados_aio_write(rados_ioctx_t io, const char *o,
   return retval;
 }
 
+extern "C" int rados_aio_write_zerocopy(rados_ioctx_t io, const char *o,
+					rados_completion_t completion,
+					const char *buf, size_t len, uint64_t off)
+{
+  tracepoint(librados, rados_aio_write_zerocopy_enter, io, o, completion, buf, len, off);
+  if (len > UINT_MAX/2)
+    return -E2BIG;
+  librados::IoCtxImpl *ctx = (librados::IoCtxImpl *)io;
+  object_t oid(o);
+  bufferlist bl;
+  bl.push_back(buffer::create_static(len, (char*)buf));
+  int retval = ctx->aio_write(oid, (librados::AioCompletionImpl*)completion,
+			bl, len, off);
+  tracepoint(librados, rados_aio_write_zerocopy_exit, retval);
+  return retval;
+}
+
 #ifdef WITH_BLKIN
 extern "C" int rados_aio_write_traced(rados_ioctx_t io, const char *o,
                                       rados_completion_t completion,
@@ -4723,6 +4791,23 @@ extern "C" int rados_aio_flush(rados_ioctx_t io)
   return 0;
 }
 
+extern "C" void rados_ioctx_set_pollmode(rados_ioctx_t io, int enable)
+{
+  tracepoint(librados, rados_ioctx_set_pollmode_enter, io, enable);
+  librados::IoCtxImpl *ctx = (librados::IoCtxImpl *)io;
+  ctx->set_pollmode(enable != 0);
+  tracepoint(librados, rados_ioctx_set_pollmode_exit);
+}
+
+extern "C" int rados_aio_poll(rados_ioctx_t io, int max, uint64_t timeout_ms)
+{
+  tracepoint(librados, rados_aio_poll_enter, io, max, timeout_ms);
+  librados::IoCtxImpl *ctx = (librados::IoCtxImpl *)io;
+  int retval = ctx->aio_poll(max, timeout_ms);
+  tracepoint(librados, rados_aio_poll_exit, retval);
+  return retval;
+}
+
 struct AioGetxattrData {
   AioGetxattrData(char* buf, rados_completion_t c, size_t l) :
     user_buf(buf), len(l), user_completion((librados::AioCompletionImpl*)c) {}
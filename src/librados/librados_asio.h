@@ -0,0 +1,232 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * Copyright (C) 2017 Red Hat, Inc.
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation. See file COPYING.
+ */
+#ifndef LIBRADOS_ASIO_H
+#define LIBRADOS_ASIO_H
+
+#include <memory>
+
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/handler_type.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "include/rados/librados.hpp"
+
+/// Defines asynchronous librados operations that satisfy the requirements
+/// on asynchronous operations imposed by boost::asio:
+///
+/// http://www.boost.org/doc/libs/1_61_0/doc/html/boost_asio/reference/asynchronous_operations.html
+///
+/// Because the CompletionToken is left unconstrained, a single
+/// implementation serves every continuation style asio understands:
+/// plain callbacks, futures via boost::asio::use_future, and stackful
+/// coroutines via boost::asio::yield_context.  Handlers are invoked
+/// directly from the librados finisher thread; a handler bound to an
+/// io_service (e.g. a spawn()ed coroutine) resumes on its own service
+/// as usual.
+
+namespace librados {
+
+namespace detail {
+
+/// completion handler signature for write operations
+using write_signature = void(boost::system::error_code);
+/// completion handler signature for read operations, which receive the
+/// resulting bufferlist as a second argument
+using read_signature = void(boost::system::error_code, bufferlist);
+
+/// unique_ptr with custom deleter for AioCompletion
+struct AioCompletionDeleter {
+  void operator()(AioCompletion *c) { c->release(); }
+};
+using unique_aio_completion_ptr =
+    std::unique_ptr<AioCompletion, AioCompletionDeleter>;
+
+/// Operation state for a single asynchronous call.  One allocation holds
+/// the AioCompletion, the completion handler, and any result storage, so
+/// a call costs a single frame instead of a separate allocation per
+/// callback object.  Ownership passes to the AioCompletion callback on
+/// successful submission and is reclaimed in dispatch().
+template <typename Handler>
+struct write_op {
+  unique_aio_completion_ptr completion;
+  Handler handler;
+
+  explicit write_op(Handler&& handler) : handler(std::move(handler)) {}
+
+  static void dispatch(completion_t cb, void *arg) {
+    std::unique_ptr<write_op> op(static_cast<write_op*>(arg));
+    const int ret = op->completion->get_return_value();
+    boost::system::error_code ec;
+    if (ret < 0) {
+      ec.assign(-ret, boost::system::system_category());
+    }
+    // move the handler out and free the op before invoking it
+    Handler handler(std::move(op->handler));
+    op.reset();
+    handler(ec);
+  }
+};
+
+template <typename Handler>
+struct read_op {
+  unique_aio_completion_ptr completion;
+  Handler handler;
+  bufferlist bl; //< filled in by the aio operation
+
+  explicit read_op(Handler&& handler) : handler(std::move(handler)) {}
+
+  static void dispatch(completion_t cb, void *arg) {
+    std::unique_ptr<read_op> op(static_cast<read_op*>(arg));
+    const int ret = op->completion->get_return_value();
+    boost::system::error_code ec;
+    if (ret < 0) {
+      ec.assign(-ret, boost::system::system_category());
+    }
+    Handler handler(std::move(op->handler));
+    bufferlist bl(std::move(op->bl));
+    op.reset();
+    handler(ec, std::move(bl));
+  }
+};
+
+} // namespace detail
+
+/// Calls IoCtx::aio_read() and invokes the handler with an error_code and
+/// the resulting bufferlist.
+template <typename CompletionToken>
+typename boost::asio::async_result<
+  typename boost::asio::handler_type<
+    CompletionToken, detail::read_signature>::type>::type
+async_read(IoCtx& io, const std::string& oid, size_t len, uint64_t off,
+	   CompletionToken&& token)
+{
+  using handler_t = typename boost::asio::handler_type<
+    CompletionToken, detail::read_signature>::type;
+  handler_t handler(std::forward<CompletionToken>(token));
+  boost::asio::async_result<handler_t> result(handler);
+
+  using op_t = detail::read_op<handler_t>;
+  std::unique_ptr<op_t> op(new op_t(std::move(handler)));
+  op->completion.reset(
+    Rados::aio_create_completion(op.get(), op_t::dispatch, nullptr));
+
+  int ret = io.aio_read(oid, op->completion.get(), &op->bl, len, off);
+  if (ret < 0) {
+    // the completion will never fire; fail from the initiating function
+    boost::system::error_code ec(-ret, boost::system::system_category());
+    handler_t h(std::move(op->handler));
+    op.reset();
+    h(ec, bufferlist());
+  } else {
+    op.release(); // release ownership to the callback
+  }
+  return result.get();
+}
+
+/// Calls IoCtx::aio_write() and invokes the handler with an error_code
+/// once the write is safe.
+template <typename CompletionToken>
+typename boost::asio::async_result<
+  typename boost::asio::handler_type<
+    CompletionToken, detail::write_signature>::type>::type
+async_write(IoCtx& io, const std::string& oid, bufferlist &bl,
+	    size_t len, uint64_t off, CompletionToken&& token)
+{
+  using handler_t = typename boost::asio::handler_type<
+    CompletionToken, detail::write_signature>::type;
+  handler_t handler(std::forward<CompletionToken>(token));
+  boost::asio::async_result<handler_t> result(handler);
+
+  using op_t = detail::write_op<handler_t>;
+  std::unique_ptr<op_t> op(new op_t(std::move(handler)));
+  op->completion.reset(
+    Rados::aio_create_completion(op.get(), nullptr, op_t::dispatch));
+
+  int ret = io.aio_write(oid, op->completion.get(), bl, len, off);
+  if (ret < 0) {
+    boost::system::error_code ec(-ret, boost::system::system_category());
+    handler_t h(std::move(op->handler));
+    op.reset();
+    h(ec);
+  } else {
+    op.release();
+  }
+  return result.get();
+}
+
+/// Calls IoCtx::aio_operate() and invokes the handler with an error_code
+/// and the resulting bufferlist.
+template <typename CompletionToken>
+typename boost::asio::async_result<
+  typename boost::asio::handler_type<
+    CompletionToken, detail::read_signature>::type>::type
+async_operate(IoCtx& io, const std::string& oid, ObjectReadOperation *read_op,
+	      int flags, CompletionToken&& token)
+{
+  using handler_t = typename boost::asio::handler_type<
+    CompletionToken, detail::read_signature>::type;
+  handler_t handler(std::forward<CompletionToken>(token));
+  boost::asio::async_result<handler_t> result(handler);
+
+  using op_t = detail::read_op<handler_t>;
+  std::unique_ptr<op_t> op(new op_t(std::move(handler)));
+  op->completion.reset(
+    Rados::aio_create_completion(op.get(), op_t::dispatch, nullptr));
+
+  int ret = io.aio_operate(oid, op->completion.get(), read_op,
+			   flags, &op->bl);
+  if (ret < 0) {
+    boost::system::error_code ec(-ret, boost::system::system_category());
+    handler_t h(std::move(op->handler));
+    op.reset();
+    h(ec, bufferlist());
+  } else {
+    op.release();
+  }
+  return result.get();
+}
+
+/// Calls IoCtx::aio_operate() and invokes the handler with an error_code
+/// once the operation is safe.
+template <typename CompletionToken>
+typename boost::asio::async_result<
+  typename boost::asio::handler_type<
+    CompletionToken, detail::write_signature>::type>::type
+async_operate(IoCtx& io, const std::string& oid, ObjectWriteOperation *write_op,
+	      int flags, CompletionToken&& token)
+{
+  using handler_t = typename boost::asio::handler_type<
+    CompletionToken, detail::write_signature>::type;
+  handler_t handler(std::forward<CompletionToken>(token));
+  boost::asio::async_result<handler_t> result(handler);
+
+  using op_t = detail::write_op<handler_t>;
+  std::unique_ptr<op_t> op(new op_t(std::move(handler)));
+  op->completion.reset(
+    Rados::aio_create_completion(op.get(), nullptr, op_t::dispatch));
+
+  int ret = io.aio_operate(oid, op->completion.get(), write_op, flags);
+  if (ret < 0) {
+    boost::system::error_code ec(-ret, boost::system::system_category());
+    handler_t h(std::move(op->handler));
+    op.reset();
+    h(ec);
+  } else {
+    op.release();
+  }
+  return result.get();
+}
+
+} // namespace librados
+
+#endif // LIBRADOS_ASIO_H
@@ -437,7 +437,7 @@ struct RadosRemoveCompletionData : RefCountedObject {
 
 libradosstriper::RadosStriperImpl::RadosStriperImpl(librados::IoCtx& ioctx, librados::IoCtxImpl *ioctx_impl) :
   m_refCnt(0),lock("RadosStriper Refcont", false, false), m_radosCluster(ioctx), m_ioCtx(ioctx), m_ioCtxImpl(ioctx_impl),
-  m_layout(default_file_layout) {}
+  m_layout(default_file_layout), m_singleWriter(false) {}
 
 ///////////////////////// layout /////////////////////////////
 
@@ -475,6 +475,12 @@ int libradosstriper::RadosStriperImpl::setObjectLayoutObjectSize
   return 0;
 }
 
+int libradosstriper::RadosStriperImpl::setSingleWriter(bool single_writer)
+{
+  m_singleWriter = single_writer;
+  return 0;
+}
+
 ///////////////////////// xattrs /////////////////////////////
 
 int libradosstriper::RadosStriperImpl::getxattr(const object_t& soid,
@@ -1124,6 +1130,9 @@ std::string libradosstriper::RadosStriperImpl::getObjectId(const object_t& soid,
 void libradosstriper::RadosStriperImpl::unlockObject(const std::string& soid,
 						     const std::string& lockCookie)
 {
+  // nothing to do when no lock was taken (single writer mode)
+  if (lockCookie.empty())
+    return;
   // unlock the shared lock on the first rados object
   std::string firstObjOid = getObjectId(soid, 0);
   m_ioCtx.unlock(firstObjOid, RADOS_LOCK_NAME, lockCookie);
@@ -1133,6 +1142,13 @@ void libradosstriper::RadosStriperImpl::aio_unlockObject(const std::string& soid
 						         const std::string& lockCookie,
                                                          librados::AioCompletion *c)
 {
+  // when no lock was taken (single writer mode), just fire the
+  // completion as if the unlocking had taken place
+  if (lockCookie.empty()) {
+    Context *ctx = new librados::C_AioCompleteAndSafe(c->pc);
+    ctx->complete(0);
+    return;
+  }
   // unlock the shared lock on the first rados object
   std::string firstObjOid = getObjectId(soid, 0);
   m_ioCtx.aio_unlock(firstObjOid, RADOS_LOCK_NAME, lockCookie, c);
@@ -1372,23 +1388,33 @@ int libradosstriper::RadosStriperImpl::openStripedObjectForRead(
 {
   // take a lock the first rados object, if it exists and gets its size
   // check, lock and size reading must be atomic and are thus done within a single operation
-  librados::ObjectWriteOperation op;
-  op.assert_exists();
-  *lockCookie = getUUID();
-  utime_t dur = utime_t();
-  rados::cls::lock::lock(&op, RADOS_LOCK_NAME, LOCK_SHARED, *lockCookie, "Tag", "", dur, 0);
+  // in single writer mode, the caller guarantees that nobody writes or
+  // truncates concurrently, so the lock round trip is spared and the
+  // existence check is left to the retrieval of layout and size
   std::string firstObjOid = getObjectId(soid, 0);
-  int rc = m_ioCtx.operate(firstObjOid, &op);
-  if (rc) {
-    // error case (including -ENOENT)
-    return rc;
+  if (!m_singleWriter) {
+    librados::ObjectWriteOperation op;
+    op.assert_exists();
+    *lockCookie = getUUID();
+    utime_t dur = utime_t();
+    rados::cls::lock::lock(&op, RADOS_LOCK_NAME, LOCK_SHARED, *lockCookie, "Tag", "", dur, 0);
+    int rc = m_ioCtx.operate(firstObjOid, &op);
+    if (rc) {
+      // error case (including -ENOENT)
+      return rc;
+    }
+  } else {
+    lockCookie->clear();
   }
-  rc = internal_get_layout_and_size(firstObjOid, layout, size);
+  int rc = internal_get_layout_and_size(firstObjOid, layout, size);
   if (rc) {
     unlockObject(soid, *lockCookie);
-    lderr(cct()) << "RadosStriperImpl::openStripedObjectForRead : "
-		 << "could not load layout and size for "
-		 << soid << " : rc = " << rc << dendl;
+    // a plain -ENOENT is expected in single writer mode (no
+    // assert_exists was issued) and does not deserve an error line
+    if (-ENOENT != rc)
+      lderr(cct()) << "RadosStriperImpl::openStripedObjectForRead : "
+		   << "could not load layout and size for "
+		   << soid << " : rc = " << rc << dendl;
   }
   return rc;
 }
@@ -1401,28 +1427,42 @@ int libradosstriper::RadosStriperImpl::openStripedObjectForWrite(const std::stri
 {
   // take a lock the first rados object, if it exists
   // check and lock must be atomic and are thus done within a single operation
-  librados::ObjectWriteOperation op;
-  op.assert_exists();
-  *lockCookie = getUUID();
-  utime_t dur = utime_t();
-  rados::cls::lock::lock(&op, RADOS_LOCK_NAME, LOCK_SHARED, *lockCookie, "Tag", "", dur, 0);
+  // in single writer mode, the caller guarantees that nobody else writes
+  // or truncates concurrently, so the lock round trip is spared and the
+  // existence check is left to the retrieval of layout and size
   std::string firstObjOid = getObjectId(soid, 0);
-  int rc = m_ioCtx.operate(firstObjOid, &op);
+  if (!m_singleWriter) {
+    librados::ObjectWriteOperation op;
+    op.assert_exists();
+    *lockCookie = getUUID();
+    utime_t dur = utime_t();
+    rados::cls::lock::lock(&op, RADOS_LOCK_NAME, LOCK_SHARED, *lockCookie, "Tag", "", dur, 0);
+    int rc = m_ioCtx.operate(firstObjOid, &op);
+    if (rc) {
+      if (rc == -ENOENT) {
+	// object does not exist, delegate to createEmptyStripedObject
+	int rc = createAndOpenStripedObject(soid, layout, *size, lockCookie, isFileSizeAbsolute);
+	// return original size
+	*size = 0;
+	return rc;
+      } else {
+	return rc;
+      }
+    }
+  } else {
+    lockCookie->clear();
+  }
+  // all fine
+  uint64_t curSize;
+  int rc = internal_get_layout_and_size(firstObjOid, layout, &curSize);
   if (rc) {
-    if (rc == -ENOENT) {
+    if (m_singleWriter && -ENOENT == rc) {
       // object does not exist, delegate to createEmptyStripedObject
-      int rc = createAndOpenStripedObject(soid, layout, *size, lockCookie, isFileSizeAbsolute);
+      rc = createAndOpenStripedObject(soid, layout, *size, lockCookie, isFileSizeAbsolute);
       // return original size
       *size = 0;
-      return rc; 
-    } else {
       return rc;
     }
-  }
-  // all fine
-  uint64_t curSize;
-  rc = internal_get_layout_and_size(firstObjOid, layout, &curSize);
-  if (rc) {
     unlockObject(soid, *lockCookie);
     lderr(cct()) << "RadosStriperImpl::openStripedObjectForWrite : "
 		   << "could not load layout and size for "
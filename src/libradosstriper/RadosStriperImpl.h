@@ -57,6 +57,7 @@ struct RadosStriperImpl {
   int setObjectLayoutStripeUnit(unsigned int stripe_unit);
   int setObjectLayoutStripeCount(unsigned int stripe_count);
   int setObjectLayoutObjectSize(unsigned int object_size);
+  int setSingleWriter(bool single_writer);
 
   // xattrs
   int getxattr(const object_t& soid, const char *name, bufferlist& bl);
@@ -269,6 +270,10 @@ struct RadosStriperImpl {
 
   // Default layout
   ceph_file_layout m_layout;
+
+  // Whether the caller guarantees a single concurrent user per striped
+  // object, allowing the per-operation shared lock to be skipped
+  bool m_singleWriter;
 };
 }
 #endif
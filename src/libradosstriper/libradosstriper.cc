@@ -178,6 +178,11 @@ int libradosstriper::RadosStriper::set_object_layout_object_size
   return rados_striper_impl->setObjectLayoutObjectSize(object_size);
 }
 
+int libradosstriper::RadosStriper::set_single_writer(bool single_writer)
+{
+  return rados_striper_impl->setSingleWriter(single_writer);
+}
+
 int libradosstriper::RadosStriper::getxattr(const std::string& oid, const char *name, bufferlist& bl)
 {
   return rados_striper_impl->getxattr(oid, name, bl);
@@ -382,6 +387,13 @@ extern "C" int rados_striper_set_object_layout_object_size(rados_striper_t strip
   return impl->setObjectLayoutObjectSize(object_size);
 }
 
+extern "C" int rados_striper_set_single_writer(rados_striper_t striper,
+					       int single_writer)
+{
+  libradosstriper::RadosStriperImpl *impl = (libradosstriper::RadosStriperImpl *)striper;
+  return impl->setSingleWriter(single_writer != 0);
+}
+
 extern "C" int rados_striper_write(rados_striper_t striper,
 				   const char *soid,
 				   const char *buf,
@@ -24,11 +24,13 @@
 #include "librbd/operation/ResizeRequest.h"
 #include "librbd/Utils.h"
 #include "librbd/LibrbdWriteback.h"
+#include "librbd/cache/WriteLogImageCache.h"
 #include "librbd/exclusive_lock/AutomaticPolicy.h"
 #include "librbd/exclusive_lock/StandardPolicy.h"
 #include "librbd/io/AioCompletion.h"
 #include "librbd/io/AsyncOperation.h"
 #include "librbd/io/ImageRequestWQ.h"
+#include "librbd/io/ReadaheadBuffer.h"
 #include "librbd/journal/StandardPolicy.h"
 
 #include "osdc/Striper.h"
@@ -193,7 +195,9 @@ struct C_InvalidateCache : public Context {
       stripe_unit(0), stripe_count(0), flags(0),
       object_cacher(NULL), writeback_handler(NULL), object_set(NULL),
       readahead(),
+      readahead_buffer(nullptr),
       total_bytes_read(0),
+      in_flight_copyups(0),
       state(new ImageState<>(this)),
       operations(new Operations<>(*this)),
       exclusive_lock(nullptr), object_map(nullptr),
@@ -240,6 +244,10 @@ struct C_InvalidateCache : public Context {
       delete writeback_handler;
       writeback_handler = NULL;
     }
+    if (readahead_buffer) {
+      delete readahead_buffer;
+      readahead_buffer = nullptr;
+    }
     if (object_set) {
       delete object_set;
       object_set = NULL;
@@ -314,6 +322,11 @@ struct C_InvalidateCache : public Context {
 
     readahead.set_trigger_requests(readahead_trigger_requests);
     readahead.set_max_readahead_size(readahead_max_bytes);
+
+    if (object_cacher == nullptr && readahead_buffer_bytes > 0 &&
+        readahead_buffer == nullptr) {
+      readahead_buffer = new io::ReadaheadBuffer(*this);
+    }
   }
 
   void ImageCtx::shutdown() {
@@ -386,7 +399,19 @@ struct C_InvalidateCache : public Context {
     plb.add_u64_counter(l_librbd_resize, "resize", "Resizes");
     plb.add_u64_counter(l_librbd_readahead, "readahead", "Read ahead");
     plb.add_u64_counter(l_librbd_readahead_bytes, "readahead_bytes", "Data size in read ahead");
+    plb.add_u64_counter(l_librbd_readahead_hit, "readahead_hit", "Reads served from the readahead buffer");
+    plb.add_u64_counter(l_librbd_readahead_hit_bytes, "readahead_hit_bytes", "Data size served from the readahead buffer");
     plb.add_u64_counter(l_librbd_invalidate_cache, "invalidate_cache", "Cache invalidates");
+    plb.add_u64_counter(l_librbd_image_cache_hit, "image_cache_hit",
+                        "Image cache read hits");
+    plb.add_u64_counter(l_librbd_image_cache_miss, "image_cache_miss",
+                        "Image cache read misses");
+    plb.add_u64_counter(l_librbd_image_cache_wr, "image_cache_wr",
+                        "Image cache writes");
+    plb.add_u64_counter(l_librbd_image_cache_wr_bytes, "image_cache_wr_bytes",
+                        "Image cache written data");
+    plb.add_time_avg(l_librbd_image_cache_wr_latency, "image_cache_wr_latency",
+                     "Image cache write latency");
 
     perfcounter = plb.create_perf_counters();
     cct->get_perfcounters_collection()->add(perfcounter);
@@ -779,6 +804,30 @@ struct C_InvalidateCache : public Context {
     }
   }
 
+  void ImageCtx::init_image_cache(Context *on_finish) {
+    if (read_only || !cct->_conf->rbd_image_cache) {
+      op_work_queue->queue(on_finish, 0);
+      return;
+    }
+
+    ldout(cct, 10) << "enabling image cache..." << dendl;
+    image_cache = new cache::WriteLogImageCache<>(*this);
+    image_cache->init(on_finish);
+  }
+
+  void ImageCtx::shut_down_image_cache(Context *on_finish) {
+    if (image_cache == nullptr) {
+      op_work_queue->queue(on_finish, 0);
+      return;
+    }
+
+    image_cache->shut_down(new FunctionContext([this, on_finish](int r) {
+        delete image_cache;
+        image_cache = nullptr;
+        on_finish->complete(r);
+      }));
+  }
+
   void ImageCtx::flush_cache(Context *onfinish) {
     cache_lock.Lock();
     object_cacher->flush_set(object_set, onfinish);
@@ -801,6 +850,9 @@ struct C_InvalidateCache : public Context {
 
   int ImageCtx::invalidate_cache(bool purge_on_error) {
     flush_async_operations();
+    if (readahead_buffer != nullptr) {
+      readahead_buffer->purge();
+    }
     if (object_cacher == NULL) {
       return 0;
     }
@@ -817,6 +869,9 @@ struct C_InvalidateCache : public Context {
   }
 
   void ImageCtx::invalidate_cache(bool purge_on_error, Context *on_finish) {
+    if (readahead_buffer != nullptr) {
+      readahead_buffer->purge();
+    }
     if (object_cacher == NULL) {
       op_work_queue->queue(on_finish, 0);
       return;
@@ -972,6 +1027,8 @@ struct C_InvalidateCache : public Context {
         "rbd_cache_max_dirty_object", false)(
         "rbd_cache_block_writes_upfront", false)(
         "rbd_concurrent_management_ops", false)(
+        "rbd_concurrent_copyups", false)(
+        "rbd_copyup_coalesce_objects", false)(
         "rbd_balance_snap_reads", false)(
         "rbd_localize_snap_reads", false)(
         "rbd_balance_parent_reads", false)(
@@ -979,6 +1036,7 @@ struct C_InvalidateCache : public Context {
         "rbd_readahead_trigger_requests", false)(
         "rbd_readahead_max_bytes", false)(
         "rbd_readahead_disable_after_bytes", false)(
+        "rbd_readahead_buffer_bytes", false)(
         "rbd_clone_copy_on_read", false)(
         "rbd_blacklist_on_break_lock", false)(
         "rbd_blacklist_expire_seconds", false)(
@@ -1021,6 +1079,7 @@ struct C_InvalidateCache : public Context {
     } while (0);
 
     ASSIGN_OPTION(non_blocking_aio);
+    ASSIGN_OPTION(aio_inline_dispatch);
     ASSIGN_OPTION(cache);
     ASSIGN_OPTION(cache_writethrough_until_flush);
     ASSIGN_OPTION(cache_size);
@@ -1030,6 +1089,8 @@ struct C_InvalidateCache : public Context {
     ASSIGN_OPTION(cache_max_dirty_object);
     ASSIGN_OPTION(cache_block_writes_upfront);
     ASSIGN_OPTION(concurrent_management_ops);
+    ASSIGN_OPTION(concurrent_copyups);
+    ASSIGN_OPTION(copyup_coalesce_objects);
     ASSIGN_OPTION(balance_snap_reads);
     ASSIGN_OPTION(localize_snap_reads);
     ASSIGN_OPTION(balance_parent_reads);
@@ -1037,6 +1098,7 @@ struct C_InvalidateCache : public Context {
     ASSIGN_OPTION(readahead_trigger_requests);
     ASSIGN_OPTION(readahead_max_bytes);
     ASSIGN_OPTION(readahead_disable_after_bytes);
+    ASSIGN_OPTION(readahead_buffer_bytes);
     ASSIGN_OPTION(clone_copy_on_read);
     ASSIGN_OPTION(blacklist_on_break_lock);
     ASSIGN_OPTION(blacklist_expire_seconds);
@@ -54,6 +54,7 @@ namespace librbd {
   class AsyncOperation;
   template <typename> class ImageRequestWQ;
   class CopyupRequest;
+  class ReadaheadBuffer;
   }
   namespace journal { struct Policy; }
 
@@ -110,7 +111,8 @@ namespace librbd {
     RWLock parent_lock; // protects parent_md and parent
     RWLock object_map_lock; // protects object map updates and object_map itself
     Mutex async_ops_lock; // protects async_ops and async_requests
-    Mutex copyup_list_lock; // protects copyup_waiting_list
+    Mutex copyup_list_lock; // protects copyup_list, copyup_pending_list and
+                            // in_flight_copyups
     Mutex completed_reqs_lock; // protects completed_reqs
 
     unsigned extra_read_flags;
@@ -138,9 +140,12 @@ namespace librbd {
     ObjectCacher::ObjectSet *object_set;
 
     Readahead readahead;
+    io::ReadaheadBuffer *readahead_buffer;
     uint64_t total_bytes_read;
 
     std::map<uint64_t, io::CopyupRequest*> copyup_list;
+    std::list<io::CopyupRequest*> copyup_pending_list;
+    uint64_t in_flight_copyups;
 
     xlist<io::AsyncOperation*> async_ops;
     xlist<AsyncRequest<>*> async_requests;
@@ -163,6 +168,7 @@ namespace librbd {
     // Configuration
     static const string METADATA_CONF_PREFIX;
     bool non_blocking_aio;
+    bool aio_inline_dispatch;
     bool cache;
     bool cache_writethrough_until_flush;
     uint64_t cache_size;
@@ -172,6 +178,8 @@ namespace librbd {
     uint32_t cache_max_dirty_object;
     bool cache_block_writes_upfront;
     uint32_t concurrent_management_ops;
+    uint32_t concurrent_copyups;
+    uint32_t copyup_coalesce_objects;
     bool balance_snap_reads;
     bool localize_snap_reads;
     bool balance_parent_reads;
@@ -179,6 +187,7 @@ namespace librbd {
     uint32_t readahead_trigger_requests;
     uint64_t readahead_max_bytes;
     uint64_t readahead_disable_after_bytes;
+    uint64_t readahead_buffer_bytes;
     bool clone_copy_on_read;
     bool blacklist_on_break_lock;
     uint32_t blacklist_expire_seconds;
@@ -289,6 +298,8 @@ namespace librbd {
 			uint64_t off, Context *onfinish, int fadvise_flags,
                         uint64_t journal_tid, ZTracer::Trace *trace);
     void user_flushed();
+    void init_image_cache(Context *on_finish);
+    void shut_down_image_cache(Context *on_finish);
     void flush_cache(Context *onfinish);
     void shut_down_cache(Context *on_finish);
     int invalidate_cache(bool purge_on_error);
@@ -14,6 +14,7 @@
 #include "librbd/io/AioCompletion.h"
 #include "librbd/watcher/Utils.h"
 #include "include/encoding.h"
+#include "common/Clock.h"
 #include "common/errno.h"
 #include "common/WorkQueue.h"
 #include <boost/bind.hpp>
@@ -334,6 +335,7 @@ void ImageWatcher<I>::notify_acquired_lock() {
   {
     Mutex::Locker owner_client_id_locker(m_owner_client_id_lock);
     set_owner_client_id(client_id);
+    m_lock_acquire_time = ceph_clock_now();
   }
 
   send_notify(AcquiredLockPayload(client_id));
@@ -348,6 +350,7 @@ void ImageWatcher<I>::notify_released_lock() {
     set_owner_client_id(ClientId());
   }
 
+  m_task_finisher->cancel(TASK_CODE_DEFERRED_LOCK_REQUEST);
   send_notify(ReleasedLockPayload(get_client_id()));
 }
 
@@ -432,6 +435,27 @@ void ImageWatcher<I>::handle_request_lock(int r) {
   }
 }
 
+template <typename I>
+void ImageWatcher<I>::handle_deferred_lock_request() {
+  RWLock::RLocker owner_locker(m_image_ctx.owner_lock);
+
+  // lock might have been released, disabled, or transitioned while the
+  // handoff was deferred
+  if (m_image_ctx.exclusive_lock == nullptr ||
+      !m_image_ctx.exclusive_lock->is_lock_owner()) {
+    return;
+  }
+
+  int r = 0;
+  if (!m_image_ctx.exclusive_lock->accept_requests(&r)) {
+    return;
+  }
+
+  ldout(m_image_ctx.cct, 10) << this << " queuing deferred release of "
+                             << "exclusive lock" << dendl;
+  m_image_ctx.get_exclusive_lock_policy()->lock_requested(false);
+}
+
 template <typename I>
 void ImageWatcher<I>::notify_lock_owner(const Payload& payload,
                                         Context *on_finish) {
@@ -636,10 +660,26 @@ bool ImageWatcher<I>::handle_payload(const RequestLockPayload &payload,
         return true;
       }
 
-      ldout(m_image_ctx.cct, 10) << this << " queuing release of exclusive lock"
-                                 << dendl;
-      r = m_image_ctx.get_exclusive_lock_policy()->lock_requested(
-        payload.force);
+      double min_hold =
+        m_image_ctx.cct->_conf->rbd_exclusive_lock_min_hold_seconds;
+      double held = ceph_clock_now() - m_lock_acquire_time;
+      if (!payload.force && min_hold > 0 && held < min_hold) {
+        // defer the handoff so that clients alternating I/O on one
+        // image don't transfer the lock on every request; the peer
+        // will see the released-lock notification when it fires
+        ldout(m_image_ctx.cct, 10) << this << " deferring release of "
+                                   << "exclusive lock for "
+                                   << (min_hold - held) << " seconds" << dendl;
+        FunctionContext *ctx = new FunctionContext(boost::bind(
+          &ImageWatcher<I>::handle_deferred_lock_request, this));
+        m_task_finisher->add_event_after(TASK_CODE_DEFERRED_LOCK_REQUEST,
+                                         min_hold - held, ctx);
+      } else {
+        ldout(m_image_ctx.cct, 10) << this << " queuing release of exclusive "
+                                   << "lock" << dendl;
+        r = m_image_ctx.get_exclusive_lock_policy()->lock_requested(
+          payload.force);
+      }
     }
     ::encode(ResponseMessage(r), ack_ctx->out);
   }
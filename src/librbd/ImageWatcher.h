@@ -76,6 +76,7 @@ public:
 private:
   enum TaskCode {
     TASK_CODE_REQUEST_LOCK,
+    TASK_CODE_DEFERRED_LOCK_REQUEST,
     TASK_CODE_CANCEL_ASYNC_REQUESTS,
     TASK_CODE_REREGISTER_WATCH,
     TASK_CODE_ASYNC_REQUEST,
@@ -165,6 +166,7 @@ private:
 
   Mutex m_owner_client_id_lock;
   watch_notify::ClientId m_owner_client_id;
+  utime_t m_lock_acquire_time;
 
   void handle_register_watch(int r);
 
@@ -175,6 +177,7 @@ private:
   watch_notify::ClientId get_client_id();
 
   void handle_request_lock(int r);
+  void handle_deferred_lock_request();
   void schedule_request_lock(bool use_timer, int timer_delay = -1);
 
   void notify_lock_owner(const watch_notify::Payload& payload,
@@ -290,7 +290,7 @@ int DiffIterate<I>::execute() {
   BitVector<2> object_diff_state;
   {
     RWLock::RLocker snap_locker(m_image_ctx.snap_lock);
-    if (m_whole_object && (m_image_ctx.features & RBD_FEATURE_FAST_DIFF) != 0) {
+    if ((m_image_ctx.features & RBD_FEATURE_FAST_DIFF) != 0) {
       r = diff_object_map(from_snap_id, end_snap_id, &object_diff_state);
       if (r < 0) {
         ldout(cct, 5) << "fast diff disabled" << dendl;
@@ -353,7 +353,32 @@ int DiffIterate<I>::execute() {
 
       if (fast_diff_enabled) {
         const uint64_t object_no = p->second.front().objectno;
-        if (object_diff_state[object_no] != OBJECT_DIFF_STATE_NONE) {
+        if (object_diff_state[object_no] == OBJECT_DIFF_STATE_NONE) {
+          // object unchanged between the two snapshots -- skip the
+          // list_snaps call, only reporting any parent diff that would
+          // show through the nonexistent object
+          if (from_snap_id == 0 && !diff_context.parent_diff.empty()) {
+            for (std::vector<ObjectExtent>::iterator q = p->second.begin();
+                 q != p->second.end(); ++q) {
+              for (vector<pair<uint64_t,uint64_t> >::iterator b =
+                     q->buffer_extents.begin();
+                   b != q->buffer_extents.end(); ++b) {
+                interval_set<uint64_t> o;
+                o.insert(off + b->first, b->second);
+                o.intersection_of(diff_context.parent_diff);
+                for (interval_set<uint64_t>::iterator s = o.begin();
+                     s != o.end(); ++s) {
+                  r = m_callback(s.get_start(), s.get_len(), true,
+                                 m_callback_arg);
+                  if (r < 0) {
+                    return r;
+                  }
+                }
+              }
+            }
+          }
+          continue;
+        } else if (m_whole_object) {
           bool updated = (object_diff_state[object_no] ==
                             OBJECT_DIFF_STATE_UPDATED);
           for (std::vector<ObjectExtent>::iterator q = p->second.begin();
@@ -363,18 +388,19 @@ int DiffIterate<I>::execute() {
               return r;
             }
           }
+          continue;
         }
-      } else {
-        C_DiffObject *diff_object = new C_DiffObject(m_image_ctx, head_ctx,
-                                                     diff_context,
-                                                     p->first.name, off,
-                                                     p->second);
-        diff_object->send();
-
-        if (diff_context.throttle.pending_error()) {
-          r = diff_context.throttle.wait_for_ret();
-          return r;
-        }
+      }
+
+      C_DiffObject *diff_object = new C_DiffObject(m_image_ctx, head_ctx,
+                                                   diff_context,
+                                                   p->first.name, off,
+                                                   p->second);
+      diff_object->send();
+
+      if (diff_context.throttle.pending_error()) {
+        r = diff_context.throttle.wait_for_ret();
+        return r;
       }
     }
 
@@ -0,0 +1,138 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "librbd/api/Snapshot.h"
+#include "common/dout.h"
+#include "common/errno.h"
+#include "common/Throttle.h"
+#include "cls/rbd/cls_rbd_types.h"
+#include "librbd/ImageCtx.h"
+#include "librbd/ImageState.h"
+#include "librbd/Operations.h"
+#include "librbd/Utils.h"
+
+#define dout_subsys ceph_subsys_rbd
+#undef dout_prefix
+#define dout_prefix *_dout << "librbd::api::Snapshot: " << __func__ << ": "
+
+namespace librbd {
+namespace api {
+
+namespace {
+
+// opens one image, applies a single snapshot operation, and closes it
+// again, releasing its SimpleThrottle slot when finished
+template <typename I>
+class BatchSnapRequest {
+public:
+  BatchSnapRequest(librados::IoCtx &io_ctx, SimpleThrottle &throttle,
+		     const std::string &image_name,
+		     const std::string &snap_name, bool create, int *result)
+    : m_throttle(throttle), m_snap_name(snap_name), m_create(create),
+      m_result(result) {
+    m_image_ctx = I::create(image_name, "", nullptr, io_ctx, false);
+  }
+
+  void send() {
+    m_image_ctx->state->open(false, util::create_context_callback<
+      BatchSnapRequest<I>, &BatchSnapRequest<I>::handle_open>(this));
+  }
+
+private:
+  SimpleThrottle &m_throttle;
+  std::string m_snap_name;
+  bool m_create;
+  int *m_result;
+
+  I *m_image_ctx;
+  int m_snap_result = 0;
+
+  void handle_open(int r) {
+    if (r < 0) {
+      m_image_ctx->destroy();
+      m_image_ctx = nullptr;
+      finish(r);
+      return;
+    }
+
+    Context *ctx = util::create_context_callback<
+      BatchSnapRequest<I>, &BatchSnapRequest<I>::handle_snap>(this);
+    if (m_create) {
+      m_image_ctx->operations->snap_create(cls::rbd::UserSnapshotNamespace(),
+					   m_snap_name.c_str(), ctx);
+    } else {
+      m_image_ctx->operations->snap_remove(cls::rbd::UserSnapshotNamespace(),
+					   m_snap_name.c_str(), ctx);
+    }
+  }
+
+  void handle_snap(int r) {
+    m_snap_result = r;
+    m_image_ctx->state->close(util::create_context_callback<
+      BatchSnapRequest<I>, &BatchSnapRequest<I>::handle_close>(this));
+  }
+
+  void handle_close(int r) {
+    m_image_ctx->destroy();
+    m_image_ctx = nullptr;
+    finish(m_snap_result < 0 ? m_snap_result : r);
+  }
+
+  void finish(int r) {
+    *m_result = r;
+    m_throttle.end_op(r);
+    delete this;
+  }
+};
+
+template <typename I>
+int batch_snap_op(librados::IoCtx& io_ctx,
+		  const std::vector<std::string> &image_names,
+		  const std::string &snap_name, bool create,
+		  std::vector<int> *results) {
+  CephContext *cct = (CephContext *)io_ctx.cct();
+  ldout(cct, 20) << (create ? "create" : "remove") << " snap_name="
+		 << snap_name << " images=" << image_names.size() << dendl;
+
+  results->clear();
+  results->resize(image_names.size(), 0);
+
+  SimpleThrottle throttle(cct->_conf->rbd_concurrent_management_ops, false);
+  for (size_t i = 0; i < image_names.size(); ++i) {
+    if (throttle.pending_error()) {
+      // record the remaining images as skipped
+      (*results)[i] = -ECANCELED;
+      continue;
+    }
+
+    // blocks while the maximum number of images are in flight
+    throttle.start_op();
+    BatchSnapRequest<I> *req = new BatchSnapRequest<I>(
+      io_ctx, throttle, image_names[i], snap_name, create, &(*results)[i]);
+    req->send();
+  }
+  return throttle.wait_for_ret();
+}
+
+} // anonymous namespace
+
+template <typename I>
+int Snapshot<I>::batch_create(librados::IoCtx& io_ctx,
+			      const std::vector<std::string> &image_names,
+			      const std::string &snap_name,
+			      std::vector<int> *results) {
+  return batch_snap_op<I>(io_ctx, image_names, snap_name, true, results);
+}
+
+template <typename I>
+int Snapshot<I>::batch_remove(librados::IoCtx& io_ctx,
+			      const std::vector<std::string> &image_names,
+			      const std::string &snap_name,
+			      std::vector<int> *results) {
+  return batch_snap_op<I>(io_ctx, image_names, snap_name, false, results);
+}
+
+} // namespace api
+} // namespace librbd
+
+template class librbd::api::Snapshot<librbd::ImageCtx>;
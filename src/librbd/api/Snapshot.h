@@ -0,0 +1,45 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#ifndef CEPH_LIBRBD_API_SNAPSHOT_H
+#define CEPH_LIBRBD_API_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+
+namespace librados { struct IoCtx; }
+
+namespace librbd {
+
+struct ImageCtx;
+
+namespace api {
+
+template <typename ImageCtxT = librbd::ImageCtx>
+struct Snapshot {
+
+  /**
+   * Create (or remove) an identically named snapshot on a set of
+   * images, pipelining the per-image open/operate/close sequences
+   * with bounded concurrency inside the library.
+   *
+   * Per-image error codes are stored in *results, parallel to
+   * image_names; the return value is the first error encountered.
+   */
+  static int batch_create(librados::IoCtx& io_ctx,
+                          const std::vector<std::string> &image_names,
+                          const std::string &snap_name,
+                          std::vector<int> *results);
+  static int batch_remove(librados::IoCtx& io_ctx,
+                          const std::vector<std::string> &image_names,
+                          const std::string &snap_name,
+                          std::vector<int> *results);
+
+};
+
+} // namespace api
+} // namespace librbd
+
+extern template class librbd::api::Snapshot<librbd::ImageCtx>;
+
+#endif // CEPH_LIBRBD_API_SNAPSHOT_H
@@ -0,0 +1,699 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "WriteLogImageCache.h"
+#include "include/buffer.h"
+#include "include/encoding.h"
+#include "include/stringify.h"
+#include "include/Context.h"
+#include "common/Clock.h"
+#include "common/dout.h"
+#include "common/errno.h"
+#include "common/perf_counters.h"
+#include "common/safe_io.h"
+#include "common/WorkQueue.h"
+#include "librbd/ImageCtx.h"
+#include "librbd/internal.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define dout_subsys ceph_subsys_rbd
+#undef dout_prefix
+#define dout_prefix *_dout << "librbd::WriteLogImageCache: " << this << " " \
+                           <<  __func__ << ": "
+
+namespace librbd {
+namespace cache {
+
+namespace {
+
+const uint32_t LOG_MAGIC = 0x52424457;       // 'RBDW'
+const uint32_t LOG_VERSION = 1;
+const uint64_t LOG_HEADER_SIZE = 8;
+const uint32_t ENTRY_MAGIC = 0x77724c47;     // 'wrLG'
+const uint64_t ENTRY_HEADER_SIZE = 4 + 8 + 8 + 4;
+
+} // anonymous namespace
+
+template <typename I>
+struct WriteLogImageCache<I>::C_DeferredWrite : public Context {
+  WriteLogImageCache *image_cache;
+  Extents image_extents;
+  bufferlist bl;
+  int fadvise_flags;
+  Context *on_finish;
+
+  C_DeferredWrite(WriteLogImageCache *image_cache, Extents&& image_extents,
+                  bufferlist&& bl, int fadvise_flags, Context *on_finish)
+    : image_cache(image_cache), image_extents(std::move(image_extents)),
+      bl(std::move(bl)), fadvise_flags(fadvise_flags), on_finish(on_finish) {
+  }
+  void finish(int r) override {
+    if (r < 0) {
+      on_finish->complete(r);
+      return;
+    }
+    image_cache->aio_write(std::move(image_extents), std::move(bl),
+                           fadvise_flags, on_finish);
+  }
+};
+
+template <typename I>
+WriteLogImageCache<I>::WriteLogImageCache(ImageCtx &image_ctx)
+  : m_image_ctx(image_ctx), m_image_writeback(image_ctx),
+    m_lock("librbd::cache::WriteLogImageCache::m_lock") {
+}
+
+template <typename I>
+WriteLogImageCache<I>::~WriteLogImageCache() {
+  if (m_fd >= 0) {
+    ::close(m_fd);
+  }
+}
+
+template <typename I>
+void WriteLogImageCache<I>::aio_read(Extents &&image_extents, bufferlist *bl,
+                                     int fadvise_flags, Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << "image_extents=" << image_extents << ", "
+                 << "on_finish=" << on_finish << dendl;
+
+  bool covered = false;
+  bool overlap = false;
+  int r = 0;
+  {
+    Mutex::Locker locker(m_lock);
+    covered = extents_covered(image_extents);
+    if (covered) {
+      r = read_from_log(image_extents, bl);
+    } else {
+      overlap = extents_overlap(image_extents);
+    }
+  }
+
+  if (covered) {
+    if (m_image_ctx.perfcounter != nullptr) {
+      m_image_ctx.perfcounter->inc(l_librbd_image_cache_hit);
+    }
+    queue_finish(on_finish, r);
+    return;
+  }
+
+  if (m_image_ctx.perfcounter != nullptr) {
+    m_image_ctx.perfcounter->inc(l_librbd_image_cache_miss);
+  }
+
+  if (overlap) {
+    // partially dirty extents need to be written back before the read
+    // can be satisfied from the cluster
+    Extents read_extents(image_extents);
+    flush(new FunctionContext(
+      [this, read_extents, bl, fadvise_flags, on_finish](int r) mutable {
+        if (r < 0) {
+          on_finish->complete(r);
+          return;
+        }
+        m_image_writeback.aio_read(std::move(read_extents), bl, fadvise_flags,
+                                   on_finish);
+      }));
+    return;
+  }
+
+  m_image_writeback.aio_read(std::move(image_extents), bl, fadvise_flags,
+                             on_finish);
+}
+
+template <typename I>
+void WriteLogImageCache<I>::aio_write(Extents &&image_extents,
+                                      bufferlist&& bl,
+                                      int fadvise_flags,
+                                      Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << "image_extents=" << image_extents << ", "
+                 << "on_finish=" << on_finish << dendl;
+
+  utime_t start_time = ceph_clock_now();
+  uint64_t bytes = bl.length();
+
+  int r = 0;
+  bool need_flush = false;
+  {
+    Mutex::Locker locker(m_lock);
+    if (m_flush_in_progress) {
+      // the log will be reset once the in-flight write-back completes --
+      // hold the write until then so its entry isn't dropped
+      m_post_flush_contexts.push_back(
+        new C_DeferredWrite(this, std::move(image_extents), std::move(bl),
+                            fadvise_flags, on_finish));
+      return;
+    }
+
+    uint64_t buffer_offset = 0;
+    for (auto &extent : image_extents) {
+      bufferlist sub_bl;
+      sub_bl.substr_of(bl, buffer_offset, extent.second);
+      buffer_offset += extent.second;
+
+      r = append_entry(extent.first, sub_bl);
+      if (r < 0) {
+        break;
+      }
+    }
+    if (r == 0 && ::fdatasync(m_fd) != 0) {
+      r = -errno;
+    }
+    if (r == 0 &&
+        m_append_pos >= static_cast<uint64_t>(
+          m_image_ctx.cct->_conf->rbd_image_cache_log_max_bytes)) {
+      need_flush = true;
+    }
+  }
+
+  if (r < 0) {
+    lderr(cct) << "failed to append to write log: " << cpp_strerror(r)
+               << dendl;
+  } else if (m_image_ctx.perfcounter != nullptr) {
+    m_image_ctx.perfcounter->inc(l_librbd_image_cache_wr);
+    m_image_ctx.perfcounter->inc(l_librbd_image_cache_wr_bytes, bytes);
+    m_image_ctx.perfcounter->tinc(l_librbd_image_cache_wr_latency,
+                                  ceph_clock_now() - start_time);
+  }
+  queue_finish(on_finish, r);
+
+  if (need_flush) {
+    ldout(cct, 10) << "write log full, writing back" << dendl;
+    flush(new FunctionContext([cct](int r) {
+        if (r < 0) {
+          lderr(cct) << "failed to write back full write log: "
+                     << cpp_strerror(r) << dendl;
+        }
+      }));
+  }
+}
+
+template <typename I>
+void WriteLogImageCache<I>::aio_discard(uint64_t offset, uint64_t length,
+                                        bool skip_partial_discard,
+                                        Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << "offset=" << offset << ", "
+                 << "length=" << length << ", "
+                 << "on_finish=" << on_finish << dendl;
+
+  bool overlap;
+  {
+    Mutex::Locker locker(m_lock);
+    overlap = extents_overlap({{offset, length}});
+  }
+  if (!overlap) {
+    m_image_writeback.aio_discard(offset, length, skip_partial_discard,
+                                  on_finish);
+    return;
+  }
+
+  // write back overlapping entries first so a crash replay cannot
+  // resurrect discarded data
+  flush(new FunctionContext(
+    [this, offset, length, skip_partial_discard, on_finish](int r) {
+      if (r < 0) {
+        on_finish->complete(r);
+        return;
+      }
+      m_image_writeback.aio_discard(offset, length, skip_partial_discard,
+                                    on_finish);
+    }));
+}
+
+template <typename I>
+void WriteLogImageCache<I>::aio_flush(Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << "on_finish=" << on_finish << dendl;
+
+  flush(on_finish);
+}
+
+template <typename I>
+void WriteLogImageCache<I>::aio_writesame(uint64_t offset, uint64_t length,
+                                          bufferlist&& bl, int fadvise_flags,
+                                          Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << "offset=" << offset << ", "
+                 << "length=" << length << ", "
+                 << "data_len=" << bl.length() << ", "
+                 << "on_finish=" << on_finish << dendl;
+
+  bool overlap;
+  {
+    Mutex::Locker locker(m_lock);
+    overlap = extents_overlap({{offset, length}});
+  }
+  if (!overlap) {
+    m_image_writeback.aio_writesame(offset, length, std::move(bl),
+                                    fadvise_flags, on_finish);
+    return;
+  }
+
+  bufferlist ws_bl(bl);
+  flush(new FunctionContext(
+    [this, offset, length, ws_bl, fadvise_flags, on_finish](int r) mutable {
+      if (r < 0) {
+        on_finish->complete(r);
+        return;
+      }
+      m_image_writeback.aio_writesame(offset, length, std::move(ws_bl),
+                                      fadvise_flags, on_finish);
+    }));
+}
+
+template <typename I>
+void WriteLogImageCache<I>::init(Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << dendl;
+
+  int r = open_log();
+  if (r < 0) {
+    lderr(cct) << "failed to open write log " << m_log_path << ": "
+               << cpp_strerror(r) << dendl;
+  }
+  queue_finish(on_finish, r);
+}
+
+template <typename I>
+void WriteLogImageCache<I>::shut_down(Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << dendl;
+
+  flush(new FunctionContext([this, on_finish](int r) {
+      Mutex::Locker locker(m_lock);
+      if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+        if (r == 0) {
+          // nothing dirty remains -- no replay needed on the next open
+          ::unlink(m_log_path.c_str());
+        }
+      }
+      on_finish->complete(r);
+    }));
+}
+
+template <typename I>
+void WriteLogImageCache<I>::invalidate(Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << dendl;
+
+  int r;
+  {
+    Mutex::Locker locker(m_lock);
+    r = reset_log();
+  }
+  queue_finish(on_finish, r);
+}
+
+template <typename I>
+void WriteLogImageCache<I>::flush(Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << "on_finish=" << on_finish << dendl;
+
+  std::map<uint64_t, LogExtent> log_index;
+  {
+    Mutex::Locker locker(m_lock);
+    if (m_flush_in_progress) {
+      m_post_flush_contexts.push_back(new FunctionContext(
+        [this, on_finish](int r) {
+          if (r < 0) {
+            on_finish->complete(r);
+            return;
+          }
+          flush(on_finish);
+        }));
+      return;
+    }
+    if (m_log_index.empty()) {
+      m_image_writeback.aio_flush(on_finish);
+      return;
+    }
+
+    m_flush_in_progress = true;
+    log_index = m_log_index;
+  }
+
+  // write every dirty extent back to the cluster
+  C_Gather *gather = new C_Gather(cct, new FunctionContext(
+    [this, on_finish](int r) {
+      handle_flush_write_back(r, on_finish);
+    }));
+  int r = 0;
+  for (auto &it : log_index) {
+    const LogExtent &extent = it.second;
+    bufferptr bp = buffer::create(extent.length);
+    ssize_t read_bytes;
+    {
+      Mutex::Locker locker(m_lock);
+      read_bytes = safe_pread_exact(m_fd, bp.c_str(), extent.length,
+                                    extent.log_offset);
+    }
+    if (read_bytes < 0) {
+      r = read_bytes;
+      lderr(cct) << "failed to read write log: " << cpp_strerror(r) << dendl;
+      gather->new_sub()->complete(r);
+      continue;
+    }
+
+    bufferlist bl;
+    bl.push_back(bp);
+    m_image_writeback.aio_write({{extent.image_offset, extent.length}},
+                                std::move(bl), 0, gather->new_sub());
+  }
+  gather->activate();
+}
+
+template <typename I>
+void WriteLogImageCache<I>::handle_flush_write_back(int r,
+                                                    Context *on_finish) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << "r=" << r << dendl;
+
+  if (r < 0) {
+    // keep the log intact so the dirty extents can be retried
+    std::list<Context*> post_flush_contexts;
+    {
+      Mutex::Locker locker(m_lock);
+      m_flush_in_progress = false;
+      std::swap(post_flush_contexts, m_post_flush_contexts);
+    }
+    for (auto ctx : post_flush_contexts) {
+      ctx->complete(0);
+    }
+    on_finish->complete(r);
+    return;
+  }
+
+  // ensure the written back extents are safely replicated before
+  // dropping them from the log
+  m_image_writeback.aio_flush(new FunctionContext(
+    [this, on_finish](int r) {
+      std::list<Context*> post_flush_contexts;
+      {
+        Mutex::Locker locker(m_lock);
+        if (r == 0) {
+          r = reset_log();
+        }
+        m_flush_in_progress = false;
+        std::swap(post_flush_contexts, m_post_flush_contexts);
+      }
+      for (auto ctx : post_flush_contexts) {
+        ctx->complete(0);
+      }
+      on_finish->complete(r);
+    }));
+}
+
+template <typename I>
+int WriteLogImageCache<I>::open_log() {
+  CephContext *cct = m_image_ctx.cct;
+
+  m_log_path = cct->_conf->rbd_image_cache_path + "/rbd_write_log." +
+               stringify(m_image_ctx.data_ctx.get_id()) + "." +
+               (m_image_ctx.id.empty() ? m_image_ctx.name : m_image_ctx.id);
+  m_fd = ::open(m_log_path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (m_fd < 0) {
+    return -errno;
+  }
+
+  struct stat st;
+  if (::fstat(m_fd, &st) != 0) {
+    return -errno;
+  }
+
+  if (static_cast<uint64_t>(st.st_size) < LOG_HEADER_SIZE) {
+    bufferlist header_bl;
+    ::encode(LOG_MAGIC, header_bl);
+    ::encode(LOG_VERSION, header_bl);
+    int r = header_bl.write_fd(m_fd, 0);
+    if (r < 0) {
+      return r;
+    }
+    m_append_pos = LOG_HEADER_SIZE;
+    return 0;
+  }
+
+  char header[LOG_HEADER_SIZE];
+  ssize_t read_bytes = safe_pread_exact(m_fd, header, LOG_HEADER_SIZE, 0);
+  if (read_bytes < 0) {
+    return read_bytes;
+  }
+
+  uint32_t magic, version;
+  bufferlist header_bl;
+  header_bl.append(header, LOG_HEADER_SIZE);
+  bufferlist::iterator it = header_bl.begin();
+  ::decode(magic, it);
+  ::decode(version, it);
+  if (magic != LOG_MAGIC || version != LOG_VERSION) {
+    lderr(cct) << "unrecognized write log header" << dendl;
+    return -EINVAL;
+  }
+
+  return replay_log(st.st_size);
+}
+
+template <typename I>
+int WriteLogImageCache<I>::replay_log(uint64_t log_size) {
+  CephContext *cct = m_image_ctx.cct;
+
+  uint64_t pos = LOG_HEADER_SIZE;
+  uint64_t entries = 0;
+  while (pos + ENTRY_HEADER_SIZE <= log_size) {
+    char header[ENTRY_HEADER_SIZE];
+    ssize_t read_bytes = safe_pread_exact(m_fd, header, ENTRY_HEADER_SIZE,
+                                          pos);
+    if (read_bytes < 0) {
+      return read_bytes;
+    }
+
+    uint32_t magic, crc;
+    uint64_t image_offset, length;
+    bufferlist header_bl;
+    header_bl.append(header, ENTRY_HEADER_SIZE);
+    bufferlist::iterator it = header_bl.begin();
+    ::decode(magic, it);
+    ::decode(image_offset, it);
+    ::decode(length, it);
+    ::decode(crc, it);
+    if (magic != ENTRY_MAGIC || length == 0 ||
+        pos + ENTRY_HEADER_SIZE + length > log_size) {
+      // torn tail from an interrupted append
+      break;
+    }
+
+    bufferptr bp = buffer::create(length);
+    read_bytes = safe_pread_exact(m_fd, bp.c_str(), length,
+                                  pos + ENTRY_HEADER_SIZE);
+    if (read_bytes < 0) {
+      return read_bytes;
+    }
+
+    bufferlist data_bl;
+    data_bl.push_back(bp);
+    if (data_bl.crc32c(0) != crc) {
+      break;
+    }
+
+    insert_extent(image_offset, length, pos + ENTRY_HEADER_SIZE);
+    pos += ENTRY_HEADER_SIZE + length;
+    ++entries;
+  }
+
+  m_append_pos = pos;
+  if (pos < log_size) {
+    // drop the torn tail
+    int r = ::ftruncate(m_fd, pos);
+    if (r != 0) {
+      return -errno;
+    }
+  }
+
+  if (entries > 0) {
+    ldout(cct, 5) << "replayed " << entries << " dirty write log entries, "
+                  << "write back deferred until the next flush" << dendl;
+  }
+  return 0;
+}
+
+template <typename I>
+int WriteLogImageCache<I>::reset_log() {
+  assert(m_lock.is_locked());
+  m_log_index.clear();
+  if (m_append_pos > LOG_HEADER_SIZE) {
+    if (::ftruncate(m_fd, LOG_HEADER_SIZE) != 0) {
+      return -errno;
+    }
+    if (::fdatasync(m_fd) != 0) {
+      return -errno;
+    }
+    m_append_pos = LOG_HEADER_SIZE;
+  }
+  return 0;
+}
+
+template <typename I>
+int WriteLogImageCache<I>::append_entry(uint64_t image_offset,
+                                        bufferlist& data) {
+  assert(m_lock.is_locked());
+
+  uint64_t length = data.length();
+  uint32_t crc = data.crc32c(0);
+
+  bufferlist bl;
+  ::encode(ENTRY_MAGIC, bl);
+  ::encode(image_offset, bl);
+  ::encode(length, bl);
+  ::encode(crc, bl);
+  uint64_t log_offset = m_append_pos + bl.length();
+  bl.append(data);
+
+  int r = bl.write_fd(m_fd, m_append_pos);
+  if (r < 0) {
+    return r;
+  }
+
+  insert_extent(image_offset, length, log_offset);
+  m_append_pos += bl.length();
+  return 0;
+}
+
+template <typename I>
+void WriteLogImageCache<I>::insert_extent(uint64_t image_offset,
+                                          uint64_t length,
+                                          uint64_t log_offset) {
+  assert(m_lock.is_locked());
+  uint64_t end = image_offset + length;
+
+  // trim (or split) an existing extent overlapping the front
+  auto it = m_log_index.lower_bound(image_offset);
+  if (it != m_log_index.begin()) {
+    auto prev = std::prev(it);
+    uint64_t prev_end = prev->second.image_offset + prev->second.length;
+    if (prev_end > image_offset) {
+      if (prev_end > end) {
+        LogExtent tail;
+        tail.image_offset = end;
+        tail.length = prev_end - end;
+        tail.log_offset = prev->second.log_offset +
+                          (end - prev->second.image_offset);
+        m_log_index[tail.image_offset] = tail;
+      }
+      prev->second.length = image_offset - prev->second.image_offset;
+    }
+  }
+
+  // drop (or trim) extents starting within the new range
+  while (it != m_log_index.end() && it->first < end) {
+    uint64_t it_end = it->second.image_offset + it->second.length;
+    if (it_end <= end) {
+      it = m_log_index.erase(it);
+      continue;
+    }
+
+    LogExtent tail;
+    tail.image_offset = end;
+    tail.length = it_end - end;
+    tail.log_offset = it->second.log_offset + (end - it->first);
+    m_log_index.erase(it);
+    m_log_index[tail.image_offset] = tail;
+    break;
+  }
+
+  LogExtent extent;
+  extent.image_offset = image_offset;
+  extent.length = length;
+  extent.log_offset = log_offset;
+  m_log_index[image_offset] = extent;
+}
+
+template <typename I>
+bool WriteLogImageCache<I>::extents_overlap(
+    const Extents& image_extents) const {
+  assert(m_lock.is_locked());
+  for (auto &extent : image_extents) {
+    uint64_t end = extent.first + extent.second;
+    auto it = m_log_index.lower_bound(extent.first);
+    if (it != m_log_index.end() && it->first < end) {
+      return true;
+    }
+    if (it != m_log_index.begin()) {
+      auto prev = std::prev(it);
+      if (prev->second.image_offset + prev->second.length > extent.first) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+template <typename I>
+bool WriteLogImageCache<I>::extents_covered(
+    const Extents& image_extents) const {
+  assert(m_lock.is_locked());
+  for (auto &extent : image_extents) {
+    uint64_t pos = extent.first;
+    uint64_t end = extent.first + extent.second;
+    while (pos < end) {
+      auto it = m_log_index.upper_bound(pos);
+      if (it == m_log_index.begin()) {
+        return false;
+      }
+      --it;
+      uint64_t it_end = it->second.image_offset + it->second.length;
+      if (it_end <= pos) {
+        return false;
+      }
+      pos = it_end;
+    }
+  }
+  return true;
+}
+
+template <typename I>
+int WriteLogImageCache<I>::read_from_log(const Extents& image_extents,
+                                         bufferlist *bl) {
+  assert(m_lock.is_locked());
+  for (auto &extent : image_extents) {
+    uint64_t pos = extent.first;
+    uint64_t end = extent.first + extent.second;
+    while (pos < end) {
+      auto it = m_log_index.upper_bound(pos);
+      assert(it != m_log_index.begin());
+      --it;
+
+      const LogExtent &log_extent = it->second;
+      uint64_t it_end = log_extent.image_offset + log_extent.length;
+      assert(it_end > pos);
+
+      uint64_t length = MIN(end, it_end) - pos;
+      bufferptr bp = buffer::create(length);
+      ssize_t read_bytes = safe_pread_exact(
+        m_fd, bp.c_str(), length,
+        log_extent.log_offset + (pos - log_extent.image_offset));
+      if (read_bytes < 0) {
+        return read_bytes;
+      }
+
+      bl->push_back(bp);
+      pos += length;
+    }
+  }
+  return 0;
+}
+
+template <typename I>
+void WriteLogImageCache<I>::queue_finish(Context *on_finish, int r) {
+  m_image_ctx.op_work_queue->queue(on_finish, r);
+}
+
+} // namespace cache
+} // namespace librbd
+
+template class librbd::cache::WriteLogImageCache<librbd::ImageCtx>;
@@ -0,0 +1,102 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#ifndef CEPH_LIBRBD_CACHE_WRITE_LOG_IMAGE_CACHE
+#define CEPH_LIBRBD_CACHE_WRITE_LOG_IMAGE_CACHE
+
+#include "ImageCache.h"
+#include "ImageWriteback.h"
+#include "common/Mutex.h"
+#include <list>
+#include <map>
+#include <string>
+
+namespace librbd {
+
+struct ImageCtx;
+
+namespace cache {
+
+/**
+ * Persistent write-back, image extent cache backed by a write log on
+ * local storage (e.g. NVMe / pmem DAX file system).
+ *
+ * Writes are appended to a per-image log file and acknowledged once
+ * they are durable on the local device; dirty extents are written back
+ * to the cluster when the cache is flushed (user flush, snapshot
+ * creation, exclusive lock release or image close).  If the client
+ * crashes, the log is scanned on the next open and the surviving
+ * entries are re-added to the dirty set, to be written back by the
+ * next flush.
+ *
+ * The cache assumes it is the only writer of the image while it holds
+ * dirty data; it is only enabled via rbd_image_cache (off by default).
+ */
+template <typename ImageCtxT = librbd::ImageCtx>
+class WriteLogImageCache : public ImageCache {
+public:
+  WriteLogImageCache(ImageCtx &image_ctx);
+  ~WriteLogImageCache() override;
+
+  /// client AIO methods
+  void aio_read(Extents&& image_extents, ceph::bufferlist *bl,
+                int fadvise_flags, Context *on_finish) override;
+  void aio_write(Extents&& image_extents, ceph::bufferlist&& bl,
+                 int fadvise_flags, Context *on_finish) override;
+  void aio_discard(uint64_t offset, uint64_t length,
+                   bool skip_partial_discard, Context *on_finish) override;
+  void aio_flush(Context *on_finish) override;
+  void aio_writesame(uint64_t offset, uint64_t length,
+                     ceph::bufferlist&& bl,
+                     int fadvise_flags, Context *on_finish) override;
+
+  /// internal state methods
+  void init(Context *on_finish) override;
+  void shut_down(Context *on_finish) override;
+
+  void invalidate(Context *on_finish) override;
+  void flush(Context *on_finish) override;
+
+private:
+  struct C_DeferredWrite;
+
+  /// dirty image extent whose payload lives within the log file
+  struct LogExtent {
+    uint64_t image_offset = 0;
+    uint64_t length = 0;
+    uint64_t log_offset = 0;
+  };
+
+  ImageCtxT &m_image_ctx;
+  ImageWriteback<ImageCtxT> m_image_writeback;
+
+  Mutex m_lock;
+  std::string m_log_path;
+  int m_fd = -1;
+  uint64_t m_append_pos = 0;
+
+  /// non-overlapping dirty extents keyed by image offset
+  std::map<uint64_t, LogExtent> m_log_index;
+
+  bool m_flush_in_progress = false;
+  std::list<Context*> m_post_flush_contexts;
+
+  int open_log();
+  int replay_log(uint64_t log_size);
+  int reset_log();
+  int append_entry(uint64_t image_offset, ceph::bufferlist& data);
+  void insert_extent(uint64_t image_offset, uint64_t length,
+                     uint64_t log_offset);
+  bool extents_overlap(const Extents& image_extents) const;
+  bool extents_covered(const Extents& image_extents) const;
+  int read_from_log(const Extents& image_extents, ceph::bufferlist *bl);
+  void handle_flush_write_back(int r, Context *on_finish);
+  void queue_finish(Context *on_finish, int r);
+};
+
+} // namespace cache
+} // namespace librbd
+
+extern template class librbd::cache::WriteLogImageCache<librbd::ImageCtx>;
+
+#endif // CEPH_LIBRBD_CACHE_WRITE_LOG_IMAGE_CACHE
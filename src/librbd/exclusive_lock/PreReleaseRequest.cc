@@ -156,6 +156,46 @@ void PreReleaseRequest<I>::handle_wait_for_ops(int r) {
   CephContext *cct = m_image_ctx.cct;
   ldout(cct, 10) << dendl;
 
+  send_flush_image_cache();
+}
+
+template <typename I>
+void PreReleaseRequest<I>::send_flush_image_cache() {
+  if (m_image_ctx.image_cache == nullptr) {
+    send_invalidate_cache(false);
+    return;
+  }
+
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 10) << dendl;
+
+  // ensure dirty extents are replicated before another client can
+  // acquire the lock
+  Context *ctx = create_context_callback<
+    PreReleaseRequest<I>,
+    &PreReleaseRequest<I>::handle_flush_image_cache>(this);
+  m_image_ctx.image_cache->flush(ctx);
+}
+
+template <typename I>
+void PreReleaseRequest<I>::handle_flush_image_cache(int r) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 10) << "r=" << r << dendl;
+
+  if (r == -EBLACKLISTED) {
+    // cluster already considers this client dead -- the dirty extents
+    // are preserved in the local log but cannot be written back
+    lderr(cct) << "failed to flush image cache because client is blacklisted"
+               << dendl;
+  } else if (r < 0) {
+    lderr(cct) << "failed to flush image cache: " << cpp_strerror(r)
+               << dendl;
+    m_image_ctx.io_work_queue->unblock_writes();
+    save_result(r);
+    finish();
+    return;
+  }
+
   send_invalidate_cache(false);
 }
 
@@ -536,7 +536,7 @@ template <typename I>
 Context *OpenRequest<I>::send_set_snap(int *result) {
   if (m_image_ctx->snap_name.empty()) {
     *result = 0;
-    return m_on_finish;
+    return send_init_image_cache(result);
   }
 
   CephContext *cct = m_image_ctx->cct;
@@ -562,6 +562,32 @@ Context *OpenRequest<I>::handle_set_snap(int *result) {
     return nullptr;
   }
 
+  return send_init_image_cache(result);
+}
+
+template <typename I>
+Context *OpenRequest<I>::send_init_image_cache(int *result) {
+  CephContext *cct = m_image_ctx->cct;
+  ldout(cct, 10) << this << " " << __func__ << dendl;
+
+  using klass = OpenRequest<I>;
+  m_image_ctx->init_image_cache(create_context_callback<
+    klass, &klass::handle_init_image_cache>(this));
+  return nullptr;
+}
+
+template <typename I>
+Context *OpenRequest<I>::handle_init_image_cache(int *result) {
+  CephContext *cct = m_image_ctx->cct;
+  ldout(cct, 10) << __func__ << ": r=" << *result << dendl;
+
+  if (*result < 0) {
+    lderr(cct) << "failed to initialize image cache: "
+               << cpp_strerror(*result) << dendl;
+    send_close_image(*result);
+    return nullptr;
+  }
+
   return m_on_finish;
 }
 
@@ -403,6 +403,12 @@ void RefreshRequest<I>::send_v2_get_snapshots() {
 
   librados::ObjectReadOperation op;
   cls_client::snapshot_list_start(&op, m_snapc.snaps);
+  if (!m_legacy_snapshot) {
+    // batch the timestamp and namespace retrieval into the same round
+    // trip; fall back to one call per item if the OSD is too old
+    cls_client::snapshot_timestamp_list_start(&op, m_snapc.snaps);
+    cls_client::snapshot_namespace_list_start(&op, m_snapc.snaps);
+  }
 
   using klass = RefreshRequest<I>;
   librados::AioCompletion *comp = create_rados_callback<
@@ -427,18 +433,36 @@ Context *RefreshRequest<I>::handle_v2_get_snapshots(int *result) {
 					       &m_snap_sizes,
                                                &m_snap_parents,
                                                &m_snap_protection);
+    if (!m_legacy_snapshot && *result == 0) {
+      *result = cls_client::snapshot_timestamp_list_finish(
+        &it, m_snapc.snaps, &m_snap_timestamps);
+      if (*result == 0) {
+        *result = cls_client::snapshot_namespace_list_finish(
+          &it, m_snapc.snaps, &m_snap_namespaces);
+      }
+    }
   }
   if (*result == -ENOENT) {
     ldout(cct, 10) << "out-of-sync snapshot state detected" << dendl;
     send_v2_get_mutable_metadata();
     return nullptr;
+  } else if (!m_legacy_snapshot && *result == -EOPNOTSUPP) {
+    ldout(cct, 10) << "OSD does not support batched snapshot metadata "
+                   << "retrieval" << dendl;
+    m_legacy_snapshot = true;
+    send_v2_get_snapshots();
+    return nullptr;
   } else if (*result < 0) {
     lderr(cct) << "failed to retrieve snapshots: " << cpp_strerror(*result)
                << dendl;
     return m_on_finish;
   }
 
-  send_v2_get_snap_timestamps();
+  if (!m_legacy_snapshot) {
+    send_v2_refresh_parent();
+  } else {
+    send_v2_get_snap_timestamps();
+  }
   return nullptr;
 }
 
@@ -58,13 +58,14 @@ private:
    *            V2_GET_GROUP                                  |
    *                |                                         |
    *                v                                         |
-   *            V2_GET_SNAPSHOTS (skip if no snaps)           |
-   *                |                                         |
+   *            V2_GET_SNAPSHOTS (skip if no snaps;           |
+   *                |              includes timestamps and    |
+   *                |              namespaces)                |
    *                v                                         |
-   *            V2_GET_SNAP_TIMESTAMPS                        |
+   *            V2_GET_SNAP_TIMESTAMPS (legacy OSDs only)     |
    *                |                                         |
    *                v                                         |
-   *            V2_GET_SNAP_NAMESPACES                        |
+   *            V2_GET_SNAP_NAMESPACES (legacy OSDs only)     |
    *                |                                         |
    *                v                                         |
    *            V2_REFRESH_PARENT (skip if no parent or       |
@@ -147,6 +148,7 @@ private:
 
   bool m_blocked_writes = false;
   bool m_incomplete_update = false;
+  bool m_legacy_snapshot = false;
 
   void send_v1_read_header();
   Context *handle_v1_read_header(int *result);
@@ -41,6 +41,7 @@
 #include "librbd/io/ImageRequestWQ.h"
 #include "librbd/io/ObjectRequest.h"
 #include "librbd/io/ReadResult.h"
+#include "librbd/io/ReadaheadBuffer.h"
 #include "librbd/journal/Types.h"
 #include "librbd/managed_lock/Types.h"
 #include "librbd/mirror/EnableRequest.h"
@@ -2300,6 +2301,10 @@ int validate_pool(IoCtx &io_ctx, CephContext *cct) {
   void readahead(ImageCtx *ictx,
                  const vector<pair<uint64_t,uint64_t> >& image_extents)
   {
+    if (ictx->object_cacher == nullptr && ictx->readahead_buffer == nullptr) {
+      return;
+    }
+
     uint64_t total_bytes = 0;
     for (vector<pair<uint64_t,uint64_t> >::const_iterator p = image_extents.begin();
 	 p != image_extents.end();
@@ -2326,25 +2331,48 @@ int validate_pool(IoCtx &io_ctx, CephContext *cct) {
 
     if (readahead_length > 0) {
       ldout(ictx->cct, 20) << "(readahead logical) " << readahead_offset << "~" << readahead_length << dendl;
-      map<object_t,vector<ObjectExtent> > readahead_object_extents;
-      Striper::file_to_extents(ictx->cct, ictx->format_string, &ictx->layout,
-			       readahead_offset, readahead_length, 0, readahead_object_extents);
-      for (map<object_t,vector<ObjectExtent> >::iterator p = readahead_object_extents.begin(); p != readahead_object_extents.end(); ++p) {
-	for (vector<ObjectExtent>::iterator q = p->second.begin(); q != p->second.end(); ++q) {
-	  ldout(ictx->cct, 20) << "(readahead) oid " << q->oid << " " << q->offset << "~" << q->length << dendl;
-
-	  Context *req_comp = new C_RBD_Readahead(ictx, q->oid, q->offset, q->length);
-	  ictx->readahead.inc_pending();
-	  ictx->aio_read_from_cache(q->oid, q->objectno, NULL,
-				    q->length, q->offset,
-				    req_comp, 0, nullptr);
+      if (ictx->object_cacher != nullptr) {
+	map<object_t,vector<ObjectExtent> > readahead_object_extents;
+	Striper::file_to_extents(ictx->cct, ictx->format_string, &ictx->layout,
+				 readahead_offset, readahead_length, 0, readahead_object_extents);
+	for (map<object_t,vector<ObjectExtent> >::iterator p = readahead_object_extents.begin(); p != readahead_object_extents.end(); ++p) {
+	  for (vector<ObjectExtent>::iterator q = p->second.begin(); q != p->second.end(); ++q) {
+	    ldout(ictx->cct, 20) << "(readahead) oid " << q->oid << " " << q->offset << "~" << q->length << dendl;
+
+	    Context *req_comp = new C_RBD_Readahead(ictx, q->oid, q->offset, q->length);
+	    ictx->readahead.inc_pending();
+	    ictx->aio_read_from_cache(q->oid, q->objectno, NULL,
+				      q->length, q->offset,
+				      req_comp, 0, nullptr);
+	  }
 	}
+      } else {
+	// native readahead staged in the image-scoped buffer
+	ictx->readahead_buffer->readahead(readahead_offset, readahead_length);
       }
       ictx->perfcounter->inc(l_librbd_readahead);
       ictx->perfcounter->inc(l_librbd_readahead_bytes, readahead_length);
     }
   }
 
+  bool readahead_buffer_read(ImageCtx *ictx, io::AioCompletion *aio_comp,
+                             const vector<pair<uint64_t,uint64_t> >& image_extents)
+  {
+    if (ictx->readahead_buffer == nullptr || image_extents.size() != 1) {
+      return false;
+    }
+    return ictx->readahead_buffer->read(image_extents[0].first,
+                                        image_extents[0].second, aio_comp);
+  }
+
+  void readahead_buffer_invalidate(ImageCtx *ictx,
+                                   const vector<pair<uint64_t,uint64_t> >& image_extents)
+  {
+    if (ictx->readahead_buffer != nullptr) {
+      ictx->readahead_buffer->invalidate(image_extents);
+    }
+  }
+
 
 
 }
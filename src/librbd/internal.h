@@ -47,9 +47,17 @@ enum {
 
   l_librbd_readahead,
   l_librbd_readahead_bytes,
+  l_librbd_readahead_hit,
+  l_librbd_readahead_hit_bytes,
 
   l_librbd_invalidate_cache,
 
+  l_librbd_image_cache_hit,
+  l_librbd_image_cache_miss,
+  l_librbd_image_cache_wr,
+  l_librbd_image_cache_wr_bytes,
+  l_librbd_image_cache_wr_latency,
+
   l_librbd_last,
 };
 
@@ -200,6 +208,10 @@ namespace librbd {
 		       void *arg);
   void readahead(ImageCtx *ictx,
                  const vector<pair<uint64_t,uint64_t> >& image_extents);
+  bool readahead_buffer_read(ImageCtx *ictx, io::AioCompletion *aio_comp,
+                             const vector<pair<uint64_t,uint64_t> >& image_extents);
+  void readahead_buffer_invalidate(ImageCtx *ictx,
+                                   const vector<pair<uint64_t,uint64_t> >& image_extents);
 
   int flush(ImageCtx *ictx);
   int invalidate_cache(ImageCtx *ictx);
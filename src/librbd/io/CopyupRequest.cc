@@ -202,23 +202,149 @@ bool CopyupRequest::is_copyup_required() {
 }
 
 void CopyupRequest::send()
+{
+  {
+    Mutex::Locker locker(m_ictx->copyup_list_lock);
+    uint32_t max_copyups = m_ictx->concurrent_copyups;
+    if (max_copyups > 0 && m_ictx->in_flight_copyups >= max_copyups) {
+      ldout(m_ictx->cct, 20) << "deferring copyup, "
+                             << m_ictx->in_flight_copyups << " in-flight"
+                             << dendl;
+      m_ictx->copyup_pending_list.push_back(this);
+      return;
+    }
+
+    ++m_ictx->in_flight_copyups;
+    m_throttle_acquired = true;
+  }
+
+  send_read_from_parent();
+}
+
+void CopyupRequest::send_read_from_parent()
 {
   m_state = STATE_READ_FROM_PARENT;
+
+  Extents read_extents(m_image_extents);
+  coalesce_pending_copyups(&read_extents);
+
   AioCompletion *comp = AioCompletion::create_and_start(
     this, m_ictx, AIO_TYPE_READ);
 
   ldout(m_ictx->cct, 20) << "completion " << comp
                          << ", oid " << m_oid
-                         << ", extents " << m_image_extents
+                         << ", extents " << read_extents
                          << dendl;
-  ImageRequest<>::aio_read(m_ictx->parent, comp, std::move(m_image_extents),
-                           ReadResult{&m_copyup_data}, 0, m_trace);
+  ImageRequest<>::aio_read(m_ictx->parent, comp, std::move(read_extents),
+                           ReadResult{&m_read_data}, 0, m_trace);
+}
+
+void CopyupRequest::coalesce_pending_copyups(Extents *read_extents)
+{
+  uint32_t max_objects = m_ictx->copyup_coalesce_objects;
+  if (max_objects <= 1) {
+    return;
+  }
+
+  Mutex::Locker locker(m_ictx->copyup_list_lock);
+  if (m_ictx->copyup_pending_list.empty()) {
+    return;
+  }
+
+  std::map<uint64_t, std::list<CopyupRequest*>::iterator> pending;
+  for (auto it = m_ictx->copyup_pending_list.begin();
+       it != m_ictx->copyup_pending_list.end(); ++it) {
+    pending[(*it)->m_object_no] = it;
+  }
+
+  uint64_t lo = m_object_no;
+  uint64_t hi = m_object_no;
+  while (m_coalesced_requests.size() + 1 < max_objects) {
+    auto it = pending.find(hi + 1);
+    if (it == pending.end() && lo > 0) {
+      it = pending.find(lo - 1);
+    }
+    if (it == pending.end()) {
+      break;
+    }
+
+    CopyupRequest *req = *it->second;
+    ldout(m_ictx->cct, 20) << "coalescing deferred copyup for oid "
+                           << req->m_oid << dendl;
+
+    if (it->first > hi) {
+      hi = it->first;
+    } else {
+      lo = it->first;
+    }
+    m_ictx->copyup_pending_list.erase(it->second);
+    pending.erase(it);
+    req->m_coalesced = true;
+
+    read_extents->insert(read_extents->end(), req->m_image_extents.begin(),
+                         req->m_image_extents.end());
+    m_coalesced_requests.push_back(req);
+  }
+}
+
+void CopyupRequest::distribute_coalesced_data(int r)
+{
+  if (r >= 0) {
+    uint64_t length = 0;
+    for (auto &image_extent : m_image_extents) {
+      length += image_extent.second;
+    }
+    m_copyup_data.substr_of(m_read_data, 0, length);
+
+    uint64_t offset = length;
+    for (CopyupRequest *req : m_coalesced_requests) {
+      length = 0;
+      for (auto &image_extent : req->m_image_extents) {
+        length += image_extent.second;
+      }
+      req->m_copyup_data.substr_of(m_read_data, offset, length);
+      offset += length;
+    }
+  }
+
+  // restart the coalesced requests at the top of their own state machines
+  std::vector<CopyupRequest *> coalesced_requests;
+  coalesced_requests.swap(m_coalesced_requests);
+  for (CopyupRequest *req : coalesced_requests) {
+    req->complete(r);
+  }
+}
+
+void CopyupRequest::release_throttle_slot()
+{
+  if (!m_throttle_acquired) {
+    return;
+  }
+
+  CopyupRequest *next = nullptr;
+  {
+    Mutex::Locker locker(m_ictx->copyup_list_lock);
+    assert(m_ictx->in_flight_copyups > 0);
+    if (!m_ictx->copyup_pending_list.empty()) {
+      // hand the slot over to the next deferred copyup
+      next = m_ictx->copyup_pending_list.front();
+      m_ictx->copyup_pending_list.pop_front();
+      next->m_throttle_acquired = true;
+    } else {
+      --m_ictx->in_flight_copyups;
+    }
+  }
+
+  if (next != nullptr) {
+    next->send_read_from_parent();
+  }
 }
 
 void CopyupRequest::complete(int r)
 {
   if (should_complete(r)) {
     complete_requests(r);
+    release_throttle_slot();
     delete this;
   }
 }
@@ -234,6 +360,11 @@ bool CopyupRequest::should_complete(int r)
   case STATE_READ_FROM_PARENT:
     ldout(cct, 20) << "READ_FROM_PARENT" << dendl;
     remove_from_list();
+    if (!m_coalesced) {
+      // coalesced requests had their data carved out by the dispatching
+      // request before being restarted
+      distribute_coalesced_data(r);
+    }
     if (r >= 0 || r == -ENOENT) {
       if (is_copyup_required()) {
         ldout(cct, 20) << "nop, skipping" << dendl;
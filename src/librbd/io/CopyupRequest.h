@@ -68,6 +68,12 @@ private:
    * The _OBJECT_MAP state is skipped if the object map isn't enabled or if
    * an object map update isn't required. The _COPYUP state is skipped if
    * no data was read from the parent *and* there are no additional ops.
+   *
+   * If rbd_concurrent_copyups caps the number of in-flight copyups, new
+   * requests are deferred on ImageCtx::copyup_pending_list before entering
+   * the state machine. A dispatching request will additionally coalesce
+   * deferred requests for adjacent objects into its own parent read and
+   * advance them once the combined read completes.
    */
   enum State {
     STATE_READ_FROM_PARENT,
@@ -83,9 +89,13 @@ private:
   ZTracer::Trace m_trace;
 
   State m_state;
+  ceph::bufferlist m_read_data;
   ceph::bufferlist m_copyup_data;
   std::vector<ObjectRequest<ImageCtx> *> m_pending_requests;
+  std::vector<CopyupRequest *> m_coalesced_requests;
   std::atomic<unsigned> m_pending_copyups { 0 };
+  bool m_throttle_acquired = false;
+  bool m_coalesced = false;
 
   AsyncOperation m_async_op;
 
@@ -96,6 +106,11 @@ private:
 
   bool should_complete(int r);
 
+  void send_read_from_parent();
+  void coalesce_pending_copyups(Extents *read_extents);
+  void distribute_coalesced_data(int r);
+  void release_throttle_slot();
+
   void remove_from_list();
 
   bool send_object_map_head();
@@ -282,12 +282,26 @@ void ImageReadRequest<I>::send_request() {
   CephContext *cct = image_ctx.cct;
 
   auto &image_extents = this->m_image_extents;
-  if (image_ctx.object_cacher && image_ctx.readahead_max_bytes > 0 &&
+  AioCompletion *aio_comp = this->m_aio_comp;
+  if (image_ctx.readahead_max_bytes > 0 &&
       !(m_op_flags & LIBRADOS_OP_FLAG_FADVISE_RANDOM)) {
     readahead(get_image_ctx(&image_ctx), image_extents);
+
+    if (readahead_buffer_read(get_image_ctx(&image_ctx), aio_comp,
+                              image_extents)) {
+      // served from the native readahead buffer
+      uint64_t buffer_length = 0;
+      for (auto &image_extent : image_extents) {
+        buffer_length += image_extent.second;
+      }
+      aio_comp->put();
+
+      image_ctx.perfcounter->inc(l_librbd_rd);
+      image_ctx.perfcounter->inc(l_librbd_rd_bytes, buffer_length);
+      return;
+    }
   }
 
-  AioCompletion *aio_comp = this->m_aio_comp;
   librados::snap_t snap_id;
   map<object_t,vector<ObjectExtent> > object_extents;
   uint64_t buffer_ofs = 0;
@@ -371,6 +385,10 @@ void AbstractImageWriteRequest<I>::send_request() {
   I &image_ctx = this->m_image_ctx;
   CephContext *cct = image_ctx.cct;
 
+  // stale data cannot be served from the native readahead buffer
+  readahead_buffer_invalidate(get_image_ctx(&image_ctx),
+                              this->m_image_extents);
+
   RWLock::RLocker md_locker(image_ctx.md_lock);
 
   bool journaling = false;
@@ -586,15 +604,32 @@ template <typename I>
 void ImageDiscardRequest<I>::prune_object_extents(ObjectExtents &object_extents) {
   I &image_ctx = this->m_image_ctx;
   CephContext *cct = image_ctx.cct;
-  if (!this->m_skip_partial_discard) {
+  if (this->m_skip_partial_discard) {
+    for (auto p = object_extents.begin(); p != object_extents.end(); ) {
+      if (p->offset + p->length < image_ctx.layout.object_size) {
+        ldout(cct, 20) << "oid " << p->oid << " " << p->offset << "~"
+		       << p->length << " from " << p->buffer_extents
+		       << ": skip partial discard" << dendl;
+        p = object_extents.erase(p);
+      } else {
+        ++p;
+      }
+    }
+  }
+
+  // consult the object map so that known-nonexistent objects never
+  // generate object requests at all -- a full-image discard can span
+  // hundreds of thousands of objects
+  RWLock::RLocker snap_locker(image_ctx.snap_lock);
+  RWLock::RLocker parent_locker(image_ctx.parent_lock);
+  if (image_ctx.object_map == nullptr || image_ctx.parent != nullptr) {
     return;
   }
 
   for (auto p = object_extents.begin(); p != object_extents.end(); ) {
-    if (p->offset + p->length < image_ctx.layout.object_size) {
+    if (!image_ctx.object_map->object_may_exist(p->objectno)) {
       ldout(cct, 20) << "oid " << p->oid << " " << p->offset << "~"
-		     << p->length << " from " << p->buffer_extents
-		     << ": skip partial discard" << dendl;
+		     << p->length << ": skip nonexistent object" << dendl;
       p = object_extents.erase(p);
     } else {
       ++p;
@@ -856,6 +891,27 @@ ObjectRequestHandle *ImageWriteSameRequest<I>::create_object_request(
   bufferlist bl;
   ObjectRequest<I> *req;
 
+  if (m_data_bl.is_zero()) {
+    // treat a zeroed write-same as a discard so that unallocated
+    // extents on thin images are elided via the object map
+    if (object_extent.length == image_ctx.layout.object_size) {
+      req = ObjectRequest<I>::create_remove(
+        &image_ctx, object_extent.oid.name, object_extent.objectno, snapc,
+        this->m_trace, on_finish);
+    } else if (object_extent.offset + object_extent.length ==
+                 image_ctx.layout.object_size) {
+      req = ObjectRequest<I>::create_truncate(
+        &image_ctx, object_extent.oid.name, object_extent.objectno,
+        object_extent.offset, snapc, this->m_trace, on_finish);
+    } else {
+      req = ObjectRequest<I>::create_zero(
+        &image_ctx, object_extent.oid.name, object_extent.objectno,
+        object_extent.offset, object_extent.length, snapc,
+        this->m_trace, on_finish);
+    }
+    return req;
+  }
+
   if (assemble_writesame_extent(object_extent, &bl, false)) {
     req = ObjectRequest<I>::create_writesame(
       &image_ctx, object_extent.oid.name, object_extent.objectno,
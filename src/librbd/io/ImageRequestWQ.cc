@@ -190,8 +190,8 @@ void ImageRequestWQ<I>::aio_read(AioCompletion *c, uint64_t off, uint64_t len,
   // if journaling is enabled -- we need to replay the journal because
   // it might contain an uncommitted write
   RWLock::RLocker owner_locker(m_image_ctx.owner_lock);
-  if (m_image_ctx.non_blocking_aio || writes_blocked() || !writes_empty() ||
-      require_lock_on_read()) {
+  if (!inline_dispatch_enabled() || writes_blocked() || !writes_empty() ||
+      require_lock_on_read() || m_image_ctx.state->is_refresh_required()) {
     queue(ImageRequest<I>::create_read_request(
             m_image_ctx, c, {{off, len}}, std::move(read_result), op_flags,
             trace));
@@ -229,13 +229,14 @@ void ImageRequestWQ<I>::aio_write(AioCompletion *c, uint64_t off, uint64_t len,
   }
 
   RWLock::RLocker owner_locker(m_image_ctx.owner_lock);
-  if (m_image_ctx.non_blocking_aio || writes_blocked()) {
+  if (!start_inline_write_dispatch()) {
     queue(ImageRequest<I>::create_write_request(
             m_image_ctx, c, {{off, len}}, std::move(bl), op_flags, trace));
   } else {
     c->start_op();
     ImageRequest<I>::aio_write(&m_image_ctx, c, {{off, len}},
 			       std::move(bl), op_flags, trace);
+    finish_in_flight_write();
     finish_in_flight_io();
   }
   trace.event("finish");
@@ -266,13 +267,14 @@ void ImageRequestWQ<I>::aio_discard(AioCompletion *c, uint64_t off,
   }
 
   RWLock::RLocker owner_locker(m_image_ctx.owner_lock);
-  if (m_image_ctx.non_blocking_aio || writes_blocked()) {
+  if (!start_inline_write_dispatch()) {
     queue(ImageRequest<I>::create_discard_request(
             m_image_ctx, c, off, len, skip_partial_discard, trace));
   } else {
     c->start_op();
     ImageRequest<I>::aio_discard(&m_image_ctx, c, off, len,
 				 skip_partial_discard, trace);
+    finish_in_flight_write();
     finish_in_flight_io();
   }
   trace.event("finish");
@@ -300,7 +302,7 @@ void ImageRequestWQ<I>::aio_flush(AioCompletion *c, bool native_async) {
   }
 
   RWLock::RLocker owner_locker(m_image_ctx.owner_lock);
-  if (m_image_ctx.non_blocking_aio || writes_blocked() || !writes_empty()) {
+  if (!inline_dispatch_enabled() || writes_blocked() || !writes_empty()) {
     queue(ImageRequest<I>::create_flush_request(m_image_ctx, c, trace));
   } else {
     ImageRequest<I>::aio_flush(&m_image_ctx, c, trace);
@@ -335,13 +337,14 @@ void ImageRequestWQ<I>::aio_writesame(AioCompletion *c, uint64_t off,
   }
 
   RWLock::RLocker owner_locker(m_image_ctx.owner_lock);
-  if (m_image_ctx.non_blocking_aio || writes_blocked()) {
+  if (!start_inline_write_dispatch()) {
     queue(ImageRequest<I>::create_writesame_request(
             m_image_ctx, c, off, len, std::move(bl), op_flags, trace));
   } else {
     c->start_op();
     ImageRequest<I>::aio_writesame(&m_image_ctx, c, off, len, std::move(bl),
 				   op_flags, trace);
+    finish_in_flight_write();
     finish_in_flight_io();
   }
   trace.event("finish");
@@ -547,7 +550,6 @@ void ImageRequestWQ<I>::process(ImageRequest<I> *req) {
 
 template <typename I>
 void ImageRequestWQ<I>::finish_queued_io(ImageRequest<I> *req) {
-  RWLock::RLocker locker(m_lock);
   if (req->is_write_op()) {
     assert(m_queued_writes > 0);
     m_queued_writes--;
@@ -559,12 +561,15 @@ void ImageRequestWQ<I>::finish_queued_io(ImageRequest<I> *req) {
 
 template <typename I>
 void ImageRequestWQ<I>::finish_in_flight_write() {
+  assert(m_in_flight_writes > 0);
+  if (--m_in_flight_writes > 0) {
+    return;
+  }
+
   bool writes_blocked = false;
   {
     RWLock::RLocker locker(m_lock);
-    assert(m_in_flight_writes > 0);
-    if (--m_in_flight_writes == 0 &&
-        !m_write_blocker_contexts.empty()) {
+    if (!m_write_blocker_contexts.empty()) {
       writes_blocked = true;
     }
   }
@@ -576,36 +581,41 @@ void ImageRequestWQ<I>::finish_in_flight_write() {
 
 template <typename I>
 int ImageRequestWQ<I>::start_in_flight_io(AioCompletion *c) {
-  RWLock::RLocker locker(m_lock);
-
-  if (m_shutdown) {
-    CephContext *cct = m_image_ctx.cct;
-    lderr(cct) << "IO received on closed image" << dendl;
-
-    c->get();
-    c->fail(-ESHUTDOWN);
-    return false;
+  // claim the in-flight slot before testing for shut down so that a
+  // racing shut_down() either sees this IO or fails it here
+  m_in_flight_ios++;
+  if (!m_shutdown) {
+    return true;
   }
 
-  m_in_flight_ios++;
-  return true;
+  CephContext *cct = m_image_ctx.cct;
+  lderr(cct) << "IO received on closed image" << dendl;
+
+  c->get();
+  c->fail(-ESHUTDOWN);
+  finish_in_flight_io();
+  return false;
 }
 
 template <typename I>
 void ImageRequestWQ<I>::finish_in_flight_io() {
+  if (--m_in_flight_ios > 0 || !m_shutdown) {
+    return;
+  }
+
   Context *on_shutdown;
   {
-    RWLock::RLocker locker(m_lock);
-    if (--m_in_flight_ios > 0 || !m_shutdown) {
-      return;
-    }
+    RWLock::WLocker locker(m_lock);
     on_shutdown = m_on_shutdown;
+    m_on_shutdown = nullptr;
+  }
+  if (on_shutdown == nullptr) {
+    // shut_down() didn't see this IO and issued the flush itself
+    return;
   }
 
   CephContext *cct = m_image_ctx.cct;
   ldout(cct, 5) << "completing shut down" << dendl;
-
-  assert(on_shutdown != nullptr);
   m_image_ctx.flush(on_shutdown);
 }
 
@@ -625,6 +635,24 @@ bool ImageRequestWQ<I>::is_lock_required(bool write_op) const {
           (!write_op && m_require_lock_on_read));
 }
 
+template <typename I>
+bool ImageRequestWQ<I>::start_inline_write_dispatch() {
+  if (!inline_dispatch_enabled()) {
+    return false;
+  }
+
+  // optimistically claim an in-flight write slot so that a racing
+  // block_writes() waits for this op, then re-test the queueing
+  // conditions
+  m_in_flight_writes++;
+  if (m_write_blockers > 0 || m_require_lock_on_write ||
+      m_image_ctx.state->is_refresh_required()) {
+    finish_in_flight_write();
+    return false;
+  }
+  return true;
+}
+
 template <typename I>
 void ImageRequestWQ<I>::queue(ImageRequest<I> *req) {
   assert(m_image_ctx.owner_lock.is_locked());
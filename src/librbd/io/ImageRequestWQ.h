@@ -52,7 +52,6 @@ public:
   void shut_down(Context *on_shutdown);
 
   inline bool writes_blocked() const {
-    RWLock::RLocker locker(m_lock);
     return (m_write_blockers > 0);
   }
 
@@ -76,28 +75,31 @@ private:
   ImageCtxT &m_image_ctx;
   mutable RWLock m_lock;
   Contexts m_write_blocker_contexts;
-  uint32_t m_write_blockers = 0;
-  bool m_require_lock_on_read = false;
-  bool m_require_lock_on_write = false;
+  std::atomic<uint32_t> m_write_blockers { 0 };
+  std::atomic<bool> m_require_lock_on_read { false };
+  std::atomic<bool> m_require_lock_on_write { false };
   std::atomic<unsigned> m_queued_reads { 0 };
   std::atomic<unsigned> m_queued_writes { 0 };
   std::atomic<unsigned> m_in_flight_ios { 0 };
   std::atomic<unsigned> m_in_flight_writes { 0 };
   std::atomic<unsigned> m_io_blockers { 0 };
 
-  bool m_shutdown = false;
+  std::atomic<bool> m_shutdown { false };
   Context *m_on_shutdown = nullptr;
 
   bool is_lock_required(bool write_op) const;
 
   inline bool require_lock_on_read() const {
-    RWLock::RLocker locker(m_lock);
     return m_require_lock_on_read;
   }
   inline bool writes_empty() const {
-    RWLock::RLocker locker(m_lock);
     return (m_queued_writes == 0);
   }
+  inline bool inline_dispatch_enabled() const {
+    return (!m_image_ctx.non_blocking_aio || m_image_ctx.aio_inline_dispatch);
+  }
+
+  bool start_inline_write_dispatch();
 
   void finish_queued_io(ImageRequest<ImageCtxT> *req);
   void finish_in_flight_write();
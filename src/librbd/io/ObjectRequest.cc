@@ -328,17 +328,23 @@ void ObjectReadRequest<I>::send_copyup()
     }
   }
 
-  Mutex::Locker copyup_locker(image_ctx->copyup_list_lock);
-  map<uint64_t, CopyupRequest*>::iterator it =
-    image_ctx->copyup_list.find(this->m_object_no);
-  if (it == image_ctx->copyup_list.end()) {
-    // create and kick off a CopyupRequest
-    CopyupRequest *new_req = new CopyupRequest(
-      image_ctx, this->m_oid, this->m_object_no,
-      std::move(this->m_parent_extents), this->m_trace);
-    this->m_parent_extents.clear();
-
-    image_ctx->copyup_list[this->m_object_no] = new_req;
+  CopyupRequest *new_req = nullptr;
+  {
+    Mutex::Locker copyup_locker(image_ctx->copyup_list_lock);
+    map<uint64_t, CopyupRequest*>::iterator it =
+      image_ctx->copyup_list.find(this->m_object_no);
+    if (it == image_ctx->copyup_list.end()) {
+      // create and kick off a CopyupRequest
+      new_req = new CopyupRequest(
+        image_ctx, this->m_oid, this->m_object_no,
+        std::move(this->m_parent_extents), this->m_trace);
+      this->m_parent_extents.clear();
+
+      image_ctx->copyup_list[this->m_object_no] = new_req;
+    }
+  }
+
+  if (new_req != nullptr) {
     new_req->send();
   }
 }
@@ -0,0 +1,228 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "librbd/io/ReadaheadBuffer.h"
+#include "common/dout.h"
+#include "include/Context.h"
+#include "include/rados/librados.hpp"
+#include "librbd/ImageCtx.h"
+#include "librbd/Utils.h"
+#include "librbd/internal.h"
+#include "librbd/io/AioCompletion.h"
+#include "librbd/io/ImageRequest.h"
+
+#define dout_subsys ceph_subsys_rbd
+#undef dout_prefix
+#define dout_prefix *_dout << "librbd::io::ReadaheadBuffer: " << this \
+                           << " " << __func__ << ": "
+
+namespace librbd {
+namespace io {
+
+ReadaheadBuffer::ReadaheadBuffer(ImageCtx &image_ctx)
+  : m_image_ctx(image_ctx),
+    m_lock(util::unique_lock_name("librbd::io::ReadaheadBuffer::m_lock",
+                                  this)) {
+}
+
+ReadaheadBuffer::~ReadaheadBuffer() {
+  Mutex::Locker locker(m_lock);
+  for (auto &it : m_entries) {
+    assert(!it.second->pending);
+    assert(it.second->waiters.empty());
+    delete it.second;
+  }
+}
+
+void ReadaheadBuffer::readahead(uint64_t image_offset, uint64_t length) {
+  CephContext *cct = m_image_ctx.cct;
+
+  Entry *entry = new Entry();
+  entry->image_offset = image_offset;
+  entry->length = length;
+
+  {
+    Mutex::Locker locker(m_lock);
+    if (m_entries.count(image_offset) > 0) {
+      delete entry;
+      return;
+    }
+
+    // evict completed entries -- lowest offset first, which for a
+    // forward sequential stream is also the oldest
+    auto it = m_entries.begin();
+    while (m_buffered_bytes + length > m_image_ctx.readahead_buffer_bytes &&
+           it != m_entries.end()) {
+      Entry *evict_entry = it->second;
+      if (!evict_entry->pending) {
+        m_buffered_bytes -= evict_entry->length;
+        it = m_entries.erase(it);
+        delete evict_entry;
+      } else {
+        ++it;
+      }
+    }
+
+    m_entries[image_offset] = entry;
+    m_buffered_bytes += length;
+  }
+
+  ldout(cct, 20) << image_offset << "~" << length << dendl;
+  m_image_ctx.readahead.inc_pending();
+
+  auto comp = AioCompletion::create_and_start(
+    new FunctionContext([this, image_offset](int r) {
+        handle_readahead(image_offset, r);
+      }), &m_image_ctx, AIO_TYPE_READ);
+
+  // FADVISE_RANDOM prevents the speculative read from re-entering the
+  // readahead state machine (or this buffer) on its way down
+  ImageRequest<>::aio_read(&m_image_ctx, comp, {{image_offset, length}},
+                           ReadResult{&entry->bl},
+                           LIBRADOS_OP_FLAG_FADVISE_RANDOM, {});
+}
+
+void ReadaheadBuffer::handle_readahead(uint64_t image_offset, int r) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << image_offset << ": r=" << r << dendl;
+
+  std::list<Waiter> waiters;
+  {
+    Mutex::Locker locker(m_lock);
+    auto it = m_entries.find(image_offset);
+    assert(it != m_entries.end());
+
+    Entry *entry = it->second;
+    assert(entry->pending);
+    entry->pending = false;
+    waiters.swap(entry->waiters);
+
+    if (r >= 0) {
+      for (auto &waiter : waiters) {
+        waiter.req_comp->bl.substr_of(
+          entry->bl, waiter.image_offset - entry->image_offset,
+          waiter.length);
+      }
+    }
+
+    if (r < 0 || entry->invalidated) {
+      m_buffered_bytes -= entry->length;
+      m_entries.erase(it);
+      delete entry;
+    }
+  }
+
+  for (auto &waiter : waiters) {
+    waiter.req_comp->complete(r >= 0 ? 0 : r);
+  }
+  m_image_ctx.readahead.dec_pending();
+}
+
+bool ReadaheadBuffer::read(uint64_t image_offset, uint64_t length,
+                           AioCompletion *aio_comp) {
+  if (length == 0) {
+    return false;
+  }
+
+  ReadResult::C_ImageReadRequest *req_comp = nullptr;
+  {
+    Mutex::Locker locker(m_lock);
+    auto it = m_entries.upper_bound(image_offset);
+    if (it == m_entries.begin()) {
+      return false;
+    }
+    --it;
+
+    Entry *entry = it->second;
+    if (entry->invalidated ||
+        image_offset + length > entry->image_offset + entry->length) {
+      return false;
+    }
+
+    CephContext *cct = m_image_ctx.cct;
+    ldout(cct, 20) << image_offset << "~" << length
+                   << (entry->pending ? " (pending)" : "") << dendl;
+
+    aio_comp->set_request_count(1);
+    req_comp = new ReadResult::C_ImageReadRequest(
+      aio_comp, {{image_offset, length}});
+
+    m_image_ctx.perfcounter->inc(l_librbd_readahead_hit);
+    m_image_ctx.perfcounter->inc(l_librbd_readahead_hit_bytes, length);
+
+    if (entry->pending) {
+      entry->waiters.push_back({image_offset, length, req_comp});
+      return true;
+    }
+
+    req_comp->bl.substr_of(entry->bl, image_offset - entry->image_offset,
+                           length);
+    if (image_offset + length == entry->image_offset + entry->length) {
+      // the sequential reader consumed the entry
+      m_buffered_bytes -= entry->length;
+      m_entries.erase(it);
+      delete entry;
+    }
+  }
+
+  // completed outside of m_lock since the user callback can re-enter
+  req_comp->complete(0);
+  return true;
+}
+
+void ReadaheadBuffer::invalidate(const Extents &image_extents) {
+  Mutex::Locker locker(m_lock);
+  if (m_entries.empty()) {
+    return;
+  }
+
+  CephContext *cct = m_image_ctx.cct;
+  for (auto &image_extent : image_extents) {
+    uint64_t start = image_extent.first;
+    uint64_t end = start + image_extent.second;
+
+    auto it = m_entries.upper_bound(start);
+    if (it != m_entries.begin()) {
+      --it;
+    }
+    while (it != m_entries.end() && it->first < end) {
+      Entry *entry = it->second;
+      if (entry->image_offset + entry->length <= start) {
+        ++it;
+        continue;
+      }
+
+      ldout(cct, 20) << "invalidating " << entry->image_offset << "~"
+                     << entry->length << dendl;
+      if (entry->pending) {
+        // dropped once the in-flight speculative read completes
+        entry->invalidated = true;
+        ++it;
+      } else {
+        m_buffered_bytes -= entry->length;
+        it = m_entries.erase(it);
+        delete entry;
+      }
+    }
+  }
+}
+
+void ReadaheadBuffer::purge() {
+  Mutex::Locker locker(m_lock);
+  ldout(m_image_ctx.cct, 10) << dendl;
+
+  for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+    Entry *entry = it->second;
+    if (entry->pending) {
+      entry->invalidated = true;
+      ++it;
+    } else {
+      m_buffered_bytes -= entry->length;
+      it = m_entries.erase(it);
+      delete entry;
+    }
+  }
+}
+
+} // namespace io
+} // namespace librbd
@@ -0,0 +1,78 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#ifndef CEPH_LIBRBD_IO_READAHEAD_BUFFER_H
+#define CEPH_LIBRBD_IO_READAHEAD_BUFFER_H
+
+#include "include/int_types.h"
+#include "include/buffer.h"
+#include "common/Mutex.h"
+#include "librbd/io/ReadResult.h"
+#include "librbd/io/Types.h"
+
+#include <list>
+#include <map>
+
+namespace librbd {
+
+struct ImageCtx;
+
+namespace io {
+
+struct AioCompletion;
+
+/**
+ * Small image-scoped buffer holding data speculatively read ahead of
+ * detected sequential streams. Used when the ObjectCacher is disabled
+ * (cache=none) so that the readahead state machine in common/Readahead
+ * still has somewhere to stage its speculative reads. Sequential reads
+ * that land within a buffered (or still in-flight) readahead extent are
+ * served locally instead of being re-issued to the cluster.
+ *
+ * Buffered extents are dropped once a reader consumes their tail, when
+ * an overlapping write invalidates them, or when the oldest entries need
+ * to be evicted to honor rbd_readahead_buffer_bytes.
+ */
+class ReadaheadBuffer {
+public:
+  ReadaheadBuffer(ImageCtx &image_ctx);
+  ~ReadaheadBuffer();
+
+  /// issue a speculative read and stage the result in the buffer
+  void readahead(uint64_t image_offset, uint64_t length);
+
+  /// true if the read was (or will be) served from the buffer
+  bool read(uint64_t image_offset, uint64_t length, AioCompletion *aio_comp);
+
+  void invalidate(const Extents &image_extents);
+  void purge();
+
+private:
+  struct Waiter {
+    uint64_t image_offset;
+    uint64_t length;
+    ReadResult::C_ImageReadRequest *req_comp;
+  };
+
+  struct Entry {
+    uint64_t image_offset = 0;
+    uint64_t length = 0;
+    ceph::bufferlist bl;
+    bool pending = true;
+    bool invalidated = false;
+    std::list<Waiter> waiters;
+  };
+
+  ImageCtx &m_image_ctx;
+  Mutex m_lock;
+
+  std::map<uint64_t, Entry*> m_entries;
+  uint64_t m_buffered_bytes = 0;
+
+  void handle_readahead(uint64_t image_offset, int r);
+};
+
+} // namespace io
+} // namespace librbd
+
+#endif // CEPH_LIBRBD_IO_READAHEAD_BUFFER_H
@@ -30,6 +30,7 @@
 #include "librbd/api/DiffIterate.h"
 #include "librbd/api/Group.h"
 #include "librbd/api/Mirror.h"
+#include "librbd/api/Snapshot.h"
 #include "librbd/io/AioCompletion.h"
 #include "librbd/io/ImageRequestWQ.h"
 #include "librbd/io/ReadResult.h"
@@ -632,6 +633,26 @@ namespace librbd {
     return r;
   }
 
+  int RBD::snap_create_batch(IoCtx& io_ctx,
+                             const std::vector<std::string>& image_names,
+                             const std::string& snap_name,
+                             std::vector<int>* results)
+  {
+    TracepointProvider::initialize<tracepoint_traits>(get_cct(io_ctx));
+    return librbd::api::Snapshot<>::batch_create(io_ctx, image_names,
+                                                 snap_name, results);
+  }
+
+  int RBD::snap_remove_batch(IoCtx& io_ctx,
+                             const std::vector<std::string>& image_names,
+                             const std::string& snap_name,
+                             std::vector<int>* results)
+  {
+    TracepointProvider::initialize<tracepoint_traits>(get_cct(io_ctx));
+    return librbd::api::Snapshot<>::batch_remove(io_ctx, image_names,
+                                                 snap_name, results);
+  }
+
   int RBD::mirror_mode_get(IoCtx& io_ctx, rbd_mirror_mode_t *mirror_mode) {
     return librbd::api::Mirror<>::mode_get(io_ctx, mirror_mode);
   }
@@ -2560,6 +2581,44 @@ extern "C" int rbd_rename(rados_ioctx_t src_p, const char *srcname,
   return r;
 }
 
+extern "C" int rbd_snap_create_batch(rados_ioctx_t p,
+                                     const char **image_names,
+                                     size_t image_count,
+                                     const char *snap_name,
+                                     int *results)
+{
+  librados::IoCtx io_ctx;
+  librados::IoCtx::from_rados_ioctx_t(p, io_ctx);
+  TracepointProvider::initialize<tracepoint_traits>(get_cct(io_ctx));
+  std::vector<std::string> names(image_names, image_names + image_count);
+  std::vector<int> image_results;
+  int r = librbd::api::Snapshot<>::batch_create(io_ctx, names, snap_name,
+                                                &image_results);
+  for (size_t i = 0; i < image_results.size(); ++i) {
+    results[i] = image_results[i];
+  }
+  return r;
+}
+
+extern "C" int rbd_snap_remove_batch(rados_ioctx_t p,
+                                     const char **image_names,
+                                     size_t image_count,
+                                     const char *snap_name,
+                                     int *results)
+{
+  librados::IoCtx io_ctx;
+  librados::IoCtx::from_rados_ioctx_t(p, io_ctx);
+  TracepointProvider::initialize<tracepoint_traits>(get_cct(io_ctx));
+  std::vector<std::string> names(image_names, image_names + image_count);
+  std::vector<int> image_results;
+  int r = librbd::api::Snapshot<>::batch_remove(io_ctx, names, snap_name,
+                                                &image_results);
+  for (size_t i = 0; i < image_results.size(); ++i) {
+    results[i] = image_results[i];
+  }
+  return r;
+}
+
 extern "C" int rbd_open(rados_ioctx_t p, const char *name, rbd_image_t *image,
 			const char *snap_name)
 {
@@ -85,6 +85,41 @@ Context *SnapshotCreateRequest<I>::handle_suspend_aio(int *result) {
     return this->create_context_finisher(*result);
   }
 
+  send_flush_image_cache();
+  return nullptr;
+}
+
+template <typename I>
+void SnapshotCreateRequest<I>::send_flush_image_cache() {
+  I &image_ctx = this->m_image_ctx;
+  if (image_ctx.image_cache == nullptr) {
+    send_append_op_event();
+    return;
+  }
+
+  CephContext *cct = image_ctx.cct;
+  ldout(cct, 5) << this << " " << __func__ << dendl;
+
+  // the snapshot needs to include any dirty extents held in the
+  // local write log
+  image_ctx.image_cache->flush(create_context_callback<
+    SnapshotCreateRequest<I>,
+    &SnapshotCreateRequest<I>::handle_flush_image_cache>(this));
+}
+
+template <typename I>
+Context *SnapshotCreateRequest<I>::handle_flush_image_cache(int *result) {
+  I &image_ctx = this->m_image_ctx;
+  CephContext *cct = image_ctx.cct;
+  ldout(cct, 5) << this << " " << __func__ << ": r=" << *result << dendl;
+
+  if (*result < 0) {
+    lderr(cct) << "failed to flush image cache: " << cpp_strerror(*result)
+               << dendl;
+    image_ctx.io_work_queue->unblock_writes();
+    return this->create_context_finisher(*result);
+  }
+
   send_append_op_event();
   return nullptr;
 }
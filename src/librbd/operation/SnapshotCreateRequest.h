@@ -34,6 +34,9 @@ public:
    *           STATE_SUSPEND_AIO * * * * * * * * * * * * *
    *               |                                     *
    *               v                                     *
+   *           STATE_FLUSH_IMAGE_CACHE (skip if no       *
+   *               |                    image cache)     *
+   *               v                                     *
    *           STATE_APPEND_OP_EVENT (skip if journal    *
    *               |                  disabled)          *
    *   (retry)     v                                     *
@@ -94,6 +97,9 @@ private:
   void send_suspend_aio();
   Context *handle_suspend_aio(int *result);
 
+  void send_flush_image_cache();
+  Context *handle_flush_image_cache(int *result);
+
   void send_append_op_event();
   Context *handle_append_op_event(int *result);
 
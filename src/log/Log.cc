@@ -43,6 +43,7 @@ Log::Log(SubsystemMap *s)
     m_subs(s),
     m_queue_mutex_holder(0),
     m_flush_mutex_holder(0),
+    m_loggers_waiting(0),
     m_new(), m_recent(),
     m_fd(-1),
     m_uid(0),
@@ -212,11 +213,18 @@ void Log::submit_entry(Entry *e)
     *(volatile int *)(0) = 0xdead;
 
   // wait for flush to catch up
-  while (m_new.m_len > m_max_new)
+  while (m_new.m_len > m_max_new) {
+    m_loggers_waiting++;
     pthread_cond_wait(&m_cond_loggers, &m_queue_mutex);
+    m_loggers_waiting--;
+  }
 
   m_new.enqueue(e);
-  pthread_cond_signal(&m_cond_flusher);
+  // the flusher drains the whole queue on each pass, so it only needs
+  // a wakeup for the empty->nonempty transition; signalling every
+  // entry costs a futex call per log line under load
+  if (m_new.m_len == 1)
+    pthread_cond_signal(&m_cond_flusher);
   m_queue_mutex_holder = 0;
   pthread_mutex_unlock(&m_queue_mutex);
 }
@@ -268,7 +276,8 @@ void Log::flush()
   m_queue_mutex_holder = pthread_self();
   EntryQueue t;
   t.swap(m_new);
-  pthread_cond_broadcast(&m_cond_loggers);
+  if (m_loggers_waiting)
+    pthread_cond_broadcast(&m_cond_loggers);
   m_queue_mutex_holder = 0;
   pthread_mutex_unlock(&m_queue_mutex);
   _flush(&t, &m_recent, false);
@@ -29,6 +29,8 @@ class Log : private Thread
   pthread_t m_queue_mutex_holder;
   pthread_t m_flush_mutex_holder;
 
+  int m_loggers_waiting;  ///< threads blocked waiting for the flusher
+
   EntryQueue m_new;    ///< new entries
   EntryQueue m_recent; ///< recent (less new) entries we've already written at low detail
 
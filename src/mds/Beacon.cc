@@ -347,6 +347,8 @@ void Beacon::notify_health(MDSRank const *mds)
       MDSHealthMetric m(MDS_HEALTH_TRIM, HEALTH_WARN, oss.str());
       m.metadata["num_segments"] = stringify(mds->mdlog->get_num_segments());
       m.metadata["max_segments"] = stringify(g_conf->mds_log_max_segments);
+      m.metadata["num_expiring_segments"] = stringify(
+	  mds->mdlog->get_expiring_segments().size());
       health.metrics.push_back(m);
     }
   }
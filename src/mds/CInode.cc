@@ -2802,9 +2802,11 @@ Capability *CInode::add_client_cap(client_t client, Session *session, SnapRealm
     dout(10) << "add_client_cap first cap, joining realm " << *containing_realm << dendl;
   }
 
-  if (client_caps.empty())
+  if (client_caps.empty()) {
     mdcache->num_inodes_with_caps++;
-  
+    mdcache->open_file_table.add_inode(this);
+  }
+
   Capability *cap = new Capability(this, ++mdcache->last_cap_id, client);
   assert(client_caps.count(client) == 0);
   client_caps[client] = cap;
@@ -2842,6 +2844,7 @@ void CInode::remove_client_cap(client_t client)
     containing_realm = NULL;
     item_open_file.remove_myself();  // unpin logsegment
     mdcache->num_inodes_with_caps--;
+    mdcache->open_file_table.remove_inode(this);
   }
 
   //clean up advisory locks
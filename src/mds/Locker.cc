@@ -1933,6 +1933,8 @@ void Locker::issue_caps_set(set<CInode*>& inset)
 
 bool Locker::issue_caps(CInode *in, Capability *only_cap)
 {
+  utime_t start = ceph_clock_now();
+
   // allowed caps are determined by the lock mode.
   int all_allowed = in->get_caps_allowed_by_type(CAP_ANY);
   int loner_allowed = in->get_caps_allowed_by_type(CAP_LONER);
@@ -2048,6 +2050,10 @@ bool Locker::issue_caps(CInode *in, Capability *only_cap)
 	in->encode_cap_message(m, cap);
 
 	mds->send_message_client_counted(m, it->first);
+
+	if (mds->logger)
+	  mds->logger->inc(op == CEPH_CAP_OP_REVOKE ? l_mds_cap_revokes
+						    : l_mds_cap_grants);
       }
     }
 
@@ -2055,6 +2061,9 @@ bool Locker::issue_caps(CInode *in, Capability *only_cap)
       break;
   }
 
+  if (nissued && mds->logger)
+    mds->logger->tinc(l_mds_cap_issue_lat, ceph_clock_now() - start);
+
   return (nissued == 0);  // true if no re-issued, no callbacks
 }
 
@@ -857,6 +857,10 @@ void MDBalancer::try_rebalance(balance_state_t& state)
 	    dir->inode->is_stray())
 	  continue;
 	if (dir->is_freezing() || dir->is_frozen()) continue;  // export pbly already in progress
+	if (in_export_cooldown(dir, rebalance_time)) {
+	  dout(5) << "skipping " << *dir << ", imported too recently" << dendl;
+	  continue;
+	}
 	double pop = dir->pop_auth_subtree.meta_load(rebalance_time, mds->mdcache->decayrate);
 	assert(dir->inode->authority().first == target);  // cuz that's how i put it in the map, dummy
 
@@ -982,6 +986,18 @@ void MDBalancer::find_exports(CDir *dir,
 
       if (pop < minchunk) continue;
 
+      if (in_export_cooldown(subdir, rebalance_time)) {
+	dout(15) << "   skipping recently imported " << *subdir << dendl;
+	continue;
+      }
+
+      double cost = export_cost(subdir);
+      if (pop < cost) {
+	dout(15) << "   skipping " << *subdir << ", migration cost " << cost
+		 << " exceeds pop " << pop << dendl;
+	continue;
+      }
+
       // lucky find?
       if (pop > needmin && pop < needmax) {
 	exports.push_back(subdir);
@@ -1215,6 +1231,8 @@ void MDBalancer::subtract_export(CDir *dir, utime_t now)
 
 void MDBalancer::add_import(CDir *dir, utime_t now)
 {
+  recently_imported[dir->dirfrag()] = now;
+
   dirfrag_load_vec_t subload = dir->pop_auth_subtree;
 
   while (true) {
@@ -1226,6 +1244,32 @@ void MDBalancer::add_import(CDir *dir, utime_t now)
   }
 }
 
+bool MDBalancer::in_export_cooldown(CDir *dir, utime_t now)
+{
+  if (g_conf->mds_bal_export_cooldown <= 0)
+    return false;
+  map<dirfrag_t, utime_t>::iterator p = recently_imported.find(dir->dirfrag());
+  if (p == recently_imported.end())
+    return false;
+  if (now - p->second < g_conf->mds_bal_export_cooldown)
+    return true;
+  recently_imported.erase(p);
+  return false;
+}
+
+double MDBalancer::export_cost(CDir *dir)
+{
+  // crude migration cost model: exporting serializes (and on the other
+  // side re-instantiates) every dentry in the subtree, and dirty state
+  // has to be journaled on top of that
+  const nest_info_t &rstat = dir->inode->get_projected_inode()->rstat;
+  double cost = g_conf->mds_bal_export_cost_per_dentry *
+    (rstat.rfiles + rstat.rsubdirs);
+  if (dir->is_dirty())
+    cost *= 2;
+  return cost;
+}
+
 void MDBalancer::handle_mds_failure(mds_rank_t who)
 {
   if (0 == who) {
@@ -103,6 +103,11 @@ private:
                    mds_rank_t ex, double& maxex,
                    mds_rank_t im, double& maxim);
 
+  /// did we import this subtree recently enough that it should stay put?
+  bool in_export_cooldown(CDir *dir, utime_t now);
+  /// estimated load-unit cost of migrating this subtree
+  double export_cost(CDir *dir);
+
   double get_maxim(balance_state_t &state, mds_rank_t im) {
     return target_load - mds_meta_load[im] - state.imported[im];
   }
@@ -138,6 +143,9 @@ private:
   // dirfrags that already have one in flight.
   set<dirfrag_t>   split_pending, merge_pending;
 
+  // when each subtree was last imported, for export hysteresis
+  map<dirfrag_t, utime_t> recently_imported;
+
   // per-epoch scatter/gathered info
   map<mds_rank_t, mds_load_t>  mds_load;
   map<mds_rank_t, double>       mds_meta_load;
@@ -169,7 +169,8 @@ MDCache::MDCache(MDSRank *m, PurgeQueue &purge_queue_) :
   filer(m->objecter, m->finisher),
   exceeded_size_limit(false),
   recovery_queue(m),
-  stray_manager(m, purge_queue_)
+  stray_manager(m, purge_queue_),
+  open_file_table(m)
 {
   migrator.reset(new Migrator(mds, this));
   root = NULL;
@@ -255,8 +256,13 @@ bool MDCache::shutdown()
 void MDCache::add_inode(CInode *in) 
 {
   // add to lru, inode map
-  assert(inode_map.count(in->vino()) == 0);  // should be no dup inos!
-  inode_map[ in->vino() ] = in;
+  if (in->last == CEPH_NOSNAP) {
+    assert(inode_map.count(in->ino()) == 0);  // should be no dup inos!
+    inode_map[ in->ino() ] = in;
+  } else {
+    assert(snap_inode_map.count(in->vino()) == 0);  // should be no dup inos!
+    snap_inode_map[ in->vino() ] = in;
+  }
 
   if (in->ino() < MDS_INO_SYSTEM_BASE) {
     if (in->ino() == MDS_INO_ROOT)
@@ -302,7 +308,10 @@ void MDCache::remove_inode(CInode *o)
     export_pin_queue.erase(o);
 
   // remove from inode map
-  inode_map.erase(o->vino());    
+  if (o->last == CEPH_NOSNAP)
+    inode_map.erase(o->ino());
+  else
+    snap_inode_map.erase(o->vino());
 
   if (o->ino() < MDS_INO_SYSTEM_BASE) {
     if (o == root) root = 0;
@@ -3739,15 +3748,16 @@ void MDCache::trim_unlinked_inodes()
 {
   dout(7) << "trim_unlinked_inodes" << dendl;
   list<CInode*> q;
-  for (ceph::unordered_map<vinodeno_t,CInode*>::iterator p = inode_map.begin();
-       p != inode_map.end();
-       ++p) {
-    CInode *in = p->second;
+  auto scan_func = [&](CInode *in) {
     if (in->get_parent_dn() == NULL && !in->is_base()) {
       dout(7) << " will trim from " << *in << dendl;
       q.push_back(in);
     }
-  }
+  };
+  for (auto &p : inode_map)
+    scan_func(p.second);
+  for (auto &p : snap_inode_map)
+    scan_func(p.second);
   for (list<CInode*>::iterator p = q.begin(); p != q.end(); ++p)
     remove_inode_recursive(*p);
 }
@@ -4542,21 +4552,18 @@ void MDCache::rejoin_scour_survivor_replicas(mds_rank_t from, MMDSCacheRejoin *a
 {
   dout(10) << "rejoin_scour_survivor_replicas from mds." << from << dendl;
 
-  for (ceph::unordered_map<vinodeno_t,CInode*>::iterator p = inode_map.begin();
-       p != inode_map.end();
-       ++p) {
-    CInode *in = p->second;
-    
+  auto scour_func = [&](CInode *in) {
     // inode?
     if (in->is_auth() &&
 	in->is_replica(from) &&
-	(ack == NULL || acked_inodes.count(p->second->vino()) == 0)) {
+	(ack == NULL || acked_inodes.count(in->vino()) == 0)) {
       inode_remove_replica(in, from, false, gather_locks);
       dout(10) << " rem " << *in << dendl;
     }
 
-    if (!in->is_dir()) continue;
-    
+    if (!in->is_dir())
+      return;
+
     list<CDir*> dfs;
     in->get_dirfrags(dfs);
     for (list<CDir*>::iterator p = dfs.begin();
@@ -4586,7 +4593,11 @@ void MDCache::rejoin_scour_survivor_replicas(mds_rank_t from, MMDSCacheRejoin *a
 	}
       }
     }
-  }
+  };
+  for (auto &p : inode_map)
+    scour_func(p.second);
+  for (auto &p : snap_inode_map)
+    scour_func(p.second);
 }
 
 
@@ -5471,14 +5482,9 @@ void MDCache::choose_lock_states_and_reconnect_caps()
 
   map<client_t,MClientSnap*> splits;
 
-  for (ceph::unordered_map<vinodeno_t,CInode*>::iterator i = inode_map.begin();
-       i != inode_map.end();
-       ++i) {
-    CInode *in = i->second;
+  for (auto &i : inode_map) {
+    CInode *in = i.second;
 
-    if (in->last != CEPH_NOSNAP)
-      continue;
- 
     if (in->is_auth() && !in->is_base() && in->inode.is_dirty_rstat())
       in->mark_dirty_rstat();
 
@@ -6088,11 +6094,9 @@ void MDCache::reissue_all_caps()
 {
   dout(10) << "reissue_all_caps" << dendl;
 
-  for (ceph::unordered_map<vinodeno_t,CInode*>::iterator p = inode_map.begin();
-       p != inode_map.end();
-       ++p) {
-    CInode *in = p->second;
-    if (in->is_head() && in->is_any_caps()) {
+  for (auto &p : inode_map) {
+    CInode *in = p.second;
+    if (in->is_any_caps()) {
       if (!mds->locker->eval(in, CEPH_CAP_LOCKS))
 	mds->locker->issue_caps(in);
     }
@@ -6173,16 +6177,11 @@ void MDCache::_queued_file_recover_cow(CInode *in, MutationRef& mut)
 void MDCache::identify_files_to_recover()
 {
   dout(10) << "identify_files_to_recover" << dendl;
-  for (ceph::unordered_map<vinodeno_t,CInode*>::iterator p = inode_map.begin();
-       p != inode_map.end();
-       ++p) {
-    CInode *in = p->second;
+  for (auto &i : inode_map) {
+    CInode *in = i.second;
     if (!in->is_auth())
       continue;
 
-    if (in->last != CEPH_NOSNAP)
-      continue;
-
     // Only normal files need file size recovery
     if (!in->is_file()) {
       continue;
@@ -6920,11 +6919,7 @@ void MDCache::trim_non_auth()
   if (lru.lru_get_size() == 0 &&
       bottom_lru.lru_get_size() == 0) {
     // root, stray, etc.?
-    ceph::unordered_map<vinodeno_t,CInode*>::iterator p = inode_map.begin();
-    while (p != inode_map.end()) {
-      ceph::unordered_map<vinodeno_t,CInode*>::iterator next = p;
-      ++next;
-      CInode *in = p->second;
+    auto trim_func = [&](CInode *in) {
       if (!in->is_auth()) {
 	list<CDir*> ls;
 	in->get_dirfrags(ls);
@@ -6941,8 +6936,13 @@ void MDCache::trim_non_auth()
 	assert(in->get_num_ref() == 0);
 	remove_inode(in);
       }
-      p = next;
-    }
+    };
+    // remove_inode only invalidates the current element, step past it
+    // before the call
+    for (auto p = inode_map.begin(); p != inode_map.end(); )
+      trim_func((p++)->second);
+    for (auto p = snap_inode_map.begin(); p != snap_inode_map.end(); )
+      trim_func((p++)->second);
   }
 
   show_subtrees();
@@ -7422,7 +7422,7 @@ void MDCache::check_memory_usage()
   static MemoryModel::snap baseline = last;
 
   // check client caps
-  assert(CInode::count() == inode_map.size());
+  assert(CInode::count() == inode_map.size() + snap_inode_map.size());
   float caps_per_inode = 0.0;
   if (CInode::count())
     caps_per_inode = (float)Capability::count() / (float)CInode::count();
@@ -8082,6 +8082,8 @@ int MDCache::path_traverse(MDRequestRef& mdr, Message *req, MDSInternalContextBa
         touch_inode(cur);
         curdir->fetch(_get_waiter(mdr, req, fin), path[depth]);
 	if (mds->logger) mds->logger->inc(l_mds_traverse_dir_fetch);
+	if (g_conf->mds_dir_prefetch_siblings)
+	  prefetch_sibling_dirfrags(curdir);
         return 1;
       }
     } else {
@@ -8139,6 +8141,31 @@ int MDCache::path_traverse(MDRequestRef& mdr, Message *req, MDSInternalContextBa
   return 0;
 }
 
+/**
+ * A traversal that missed one frag of a fragmented directory will very
+ * likely need the others shortly (recursive scans walk them all), so
+ * overlap their omap reads with the fetch we are already waiting on
+ * instead of paying one round trip per frag.
+ */
+void MDCache::prefetch_sibling_dirfrags(CDir *dir)
+{
+  CInode *diri = dir->get_inode();
+  list<CDir*> ls;
+  diri->get_dirfrags(ls);
+  for (list<CDir*>::iterator p = ls.begin(); p != ls.end(); ++p) {
+    CDir *sib = *p;
+    if (sib == dir ||
+	!sib->is_auth() ||
+	sib->is_complete() ||
+	sib->state_test(CDir::STATE_FETCHING))
+      continue;
+    if (mds->damage_table.is_dirfrag_damaged(sib))
+      continue;
+    dout(10) << "prefetch_sibling_dirfrags fetching " << *sib << dendl;
+    sib->fetch(NULL);
+  }
+}
+
 CInode *MDCache::cache_traverse(const filepath& fp)
 {
   dout(10) << "cache_traverse " << fp << dendl;
@@ -11282,20 +11309,6 @@ void MDCache::_fragment_logged(MDRequestRef& mdr)
     dir->commit(0, gather.new_sub(), true);  // ignore authpinnability
   }
 
-  gather.activate();
-}
-
-void MDCache::_fragment_stored(MDRequestRef& mdr)
-{
-  dirfrag_t basedirfrag = mdr->more()->fragment_base;
-  map<dirfrag_t,fragment_info_t>::iterator it = fragments.find(basedirfrag);
-  assert(it != fragments.end());
-  fragment_info_t &info = it->second;
-  CInode *diri = info.resultfrags.front()->get_inode();
-
-  dout(10) << "fragment_stored " << basedirfrag << " bits " << info.bits
-	   << " on " << *diri << dendl;
-
   // tell peers
   CDir *first = *info.resultfrags.begin();
   for (compact_map<mds_rank_t,unsigned>::iterator p = first->replicas_begin();
@@ -11317,24 +11330,23 @@ void MDCache::_fragment_stored(MDRequestRef& mdr)
     mds->send_message_mds(notify, p->first);
   }
 
-  // journal commit
-  EFragment *le = new EFragment(mds->mdlog, EFragment::OP_COMMIT, basedirfrag, info.bits);
-  mds->mdlog->start_submit_entry(le, new C_MDC_FragmentCommit(this, basedirfrag,
-							      info.resultfrags));
-
   mds->locker->drop_locks(mdr.get());
 
-  // unfreeze resulting frags
+  // unfreeze resulting frags now that the prepare is journaled and the
+  // commit ops have captured their contents; the stores (and the commit
+  // journal entry behind them) finish in the background while the frags
+  // serve requests again.  STATE_FRAGMENTING keeps them from being
+  // refragmented until then.
   for (list<CDir*>::iterator p = info.resultfrags.begin();
        p != info.resultfrags.end();
        ++p) {
     CDir *dir = *p;
     dout(10) << " result frag " << *dir << dendl;
 
-    for (CDir::map_t::iterator p = dir->items.begin();
-	 p != dir->items.end();
-	 ++p) { 
-      CDentry *dn = p->second;
+    for (CDir::map_t::iterator q = dir->items.begin();
+	 q != dir->items.end();
+	 ++q) {
+      CDentry *dn = q->second;
       assert(dn->state_test(CDentry::STATE_FRAGMENTING));
       dn->state_clear(CDentry::STATE_FRAGMENTING);
       dn->put(CDentry::PIN_FRAGMENTING);
@@ -11344,6 +11356,25 @@ void MDCache::_fragment_stored(MDRequestRef& mdr)
     dir->unfreeze_dir();
   }
 
+  gather.activate();
+}
+
+void MDCache::_fragment_stored(MDRequestRef& mdr)
+{
+  dirfrag_t basedirfrag = mdr->more()->fragment_base;
+  map<dirfrag_t,fragment_info_t>::iterator it = fragments.find(basedirfrag);
+  assert(it != fragments.end());
+  fragment_info_t &info = it->second;
+  CInode *diri = info.resultfrags.front()->get_inode();
+
+  dout(10) << "fragment_stored " << basedirfrag << " bits " << info.bits
+	   << " on " << *diri << dendl;
+
+  // journal commit
+  EFragment *le = new EFragment(mds->mdlog, EFragment::OP_COMMIT, basedirfrag, info.bits);
+  mds->mdlog->start_submit_entry(le, new C_MDC_FragmentCommit(this, basedirfrag,
+							      info.resultfrags));
+
   fragments.erase(it);
   request_finish(mdr);
 }
@@ -11632,12 +11663,9 @@ void MDCache::force_readonly()
   mds->server->force_clients_readonly();
 
   // revoke write caps
-  for (ceph::unordered_map<vinodeno_t,CInode*>::iterator p = inode_map.begin();
-       p != inode_map.end();
-       ++p) {
-    CInode *in = p->second;
-    if (in->is_head())
-      mds->locker->eval(in, CEPH_CAP_LOCKS);
+  for (auto &p : inode_map) {
+    CInode *in = p.second;
+    mds->locker->eval(in, CEPH_CAP_LOCKS);
   }
 
   mds->mdlog->flush();
@@ -11787,17 +11815,15 @@ void MDCache::show_subtrees(int dbl)
 void MDCache::show_cache()
 {
   dout(7) << "show_cache" << dendl;
-  
-  for (ceph::unordered_map<vinodeno_t,CInode*>::iterator it = inode_map.begin();
-       it != inode_map.end();
-       ++it) {
+
+  auto show_func = [this](CInode *in) {
     // unlinked?
-    if (!it->second->parent)
-      dout(7) << " unlinked " << *it->second << dendl;
-    
+    if (!in->parent)
+      dout(7) << " unlinked " << *in << dendl;
+
     // dirfrags?
     list<CDir*> dfs;
-    it->second->get_dirfrags(dfs);
+    in->get_dirfrags(dfs);
     for (list<CDir*>::iterator p = dfs.begin(); p != dfs.end(); ++p) {
       CDir *dir = *p;
       dout(7) << "  dirfrag " << *dir << dendl;
@@ -11808,11 +11834,15 @@ void MDCache::show_cache()
 	CDentry *dn = p->second;
 	dout(7) << "   dentry " << *dn << dendl;
 	CDentry::linkage_t *dnl = dn->get_linkage();
-	if (dnl->is_primary() && dnl->get_inode()) 
+	if (dnl->is_primary() && dnl->get_inode())
 	  dout(7) << "    inode " << *dnl->get_inode() << dendl;
       }
     }
-  }
+  };
+  for (auto &p : inode_map)
+    show_func(p.second);
+  for (auto &p : snap_inode_map)
+    show_func(p.second);
 }
 
 int MDCache::dump_cache(std::string const &file_name)
@@ -11858,11 +11888,8 @@ int MDCache::dump_cache(const char *fn, Formatter *f,
     }
   }
 
-  for (ceph::unordered_map<vinodeno_t,CInode*>::iterator it = inode_map.begin();
-       it != inode_map.end();
-       ++it) {
-    CInode *in = it->second;
-
+  auto dump_func = [&](CInode *in) -> int {
+    int r;
     if (!dump_root.empty()) {
       string ipath;
       if (in->is_root())
@@ -11872,11 +11899,11 @@ int MDCache::dump_cache(const char *fn, Formatter *f,
 
       if (dump_root.length() > ipath.length() ||
 	  !equal(dump_root.begin(), dump_root.end(), ipath.begin()))
-	continue;
+	return 0;
 
       if (depth >= 0 &&
 	  count(ipath.begin() + dump_root.length(), ipath.end(), '/') > depth)
-	continue;
+	return 0;
     }
 
     if (f) {
@@ -11887,9 +11914,8 @@ int MDCache::dump_cache(const char *fn, Formatter *f,
       ss << *in << std::endl;
       std::string s = ss.str();
       r = safe_write(fd, s.c_str(), s.length());
-      if (r < 0) {
-	goto out;
-      }
+      if (r < 0)
+	return r;
     }
 
     list<CDir*> dfs;
@@ -11907,9 +11933,8 @@ int MDCache::dump_cache(const char *fn, Formatter *f,
         tt << " " << *dir << std::endl;
         string t = tt.str();
         r = safe_write(fd, t.c_str(), t.length());
-        if (r < 0) {
-          goto out;
-        }
+        if (r < 0)
+          return r;
       }
       
       if (f) {
@@ -11928,9 +11953,8 @@ int MDCache::dump_cache(const char *fn, Formatter *f,
           uu << "  " << *dn << std::endl;
           string u = uu.str();
           r = safe_write(fd, u.c_str(), u.length());
-          if (r < 0) {
-            goto out;
-          }
+          if (r < 0)
+            return r;
         }
       }
       if (f) {
@@ -11948,6 +11972,18 @@ int MDCache::dump_cache(const char *fn, Formatter *f,
     if (f) {
       f->close_section();  // inode
     }
+    return 0;
+  };
+
+  for (auto &p : inode_map) {
+    r = dump_func(p.second);
+    if (r < 0)
+      goto out;
+  }
+  for (auto &p : snap_inode_map) {
+    r = dump_func(p.second);
+    if (r < 0)
+      goto out;
   }
 
  out:
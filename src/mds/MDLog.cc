@@ -602,6 +602,18 @@ void MDLog::trim(int m)
   utime_t stop = ceph_clock_now();
   stop += 2.0;
 
+  // if we have fallen far behind, scale the concurrent expiry window
+  // with the backlog so trimming can outpace a sustained create
+  // workload instead of letting the journal grow without bound
+  int max_expiring = g_conf->mds_log_max_expiring;
+  if (max_expiring > 0 && max_segments > 0 &&
+      segments.size() > max_segments * 2) {
+    max_expiring = max_expiring * (segments.size() / max_segments) / 2;
+    dout(10) << "trim widening expiry window to " << max_expiring
+	     << " segments (" << segments.size() << "/" << max_segments
+	     << " behind)" << dendl;
+  }
+
   map<uint64_t,LogSegment*>::iterator p = segments.begin();
   while (p != segments.end() &&
 	 ((max_events >= 0 &&
@@ -612,12 +624,12 @@ void MDLog::trim(int m)
       break;
 
     int num_expiring_segments = (int)expiring_segments.size();
-    if (num_expiring_segments >= g_conf->mds_log_max_expiring)
+    if (num_expiring_segments >= max_expiring)
       break;
 
     int op_prio = CEPH_MSG_PRIO_LOW +
 		  (CEPH_MSG_PRIO_HIGH - CEPH_MSG_PRIO_LOW) *
-		  num_expiring_segments / g_conf->mds_log_max_expiring;
+		  num_expiring_segments / max_expiring;
 
     // look at first segment
     LogSegment *ls = p->second;
@@ -1248,9 +1260,36 @@ void MDLog::_replay_thread()
 {
   dout(10) << "_replay_thread start" << dendl;
 
+  // Events are decoded outside mds_lock and applied in batches so the
+  // journaler can keep prefetching while we hold the lock, instead of
+  // taking and dropping it once per event.
+  list<LogEvent*> batched_events;
+  auto flush_batch = [&]() -> bool {
+    if (batched_events.empty())
+      return true;
+    Mutex::Locker l(mds->mds_lock);
+    if (mds->is_daemon_stopping())
+      return false;
+    for (list<LogEvent*>::iterator p = batched_events.begin();
+	 p != batched_events.end();
+	 ++p) {
+      logger->inc(l_mdl_replayed);
+      (*p)->replay(mds);
+      delete *p;
+    }
+    batched_events.clear();
+    return true;
+  };
+
   // loop
   int r = 0;
   while (1) {
+    // apply what we have before waiting for more to read
+    if (!journaler->is_readable() && !flush_batch()) {
+      dout(10) << "_replay_thread stopping during batch flush" << dendl;
+      return;
+    }
+
     // wait for read?
     while (!journaler->is_readable() &&
 	   journaler->get_read_pos() < journaler->get_write_pos() &&
@@ -1370,30 +1409,33 @@ void MDLog::_replay_thread()
 
     // have we seen an import map yet?
     if (segments.empty()) {
-      dout(10) << "_replay " << pos << "~" << bl.length() << " / " << journaler->get_write_pos() 
+      dout(10) << "_replay " << pos << "~" << bl.length() << " / " << journaler->get_write_pos()
 	       << " " << le->get_stamp() << " -- waiting for subtree_map.  (skipping " << *le << ")" << dendl;
+      delete le;
     } else {
-      dout(10) << "_replay " << pos << "~" << bl.length() << " / " << journaler->get_write_pos() 
+      dout(10) << "_replay " << pos << "~" << bl.length() << " / " << journaler->get_write_pos()
 	       << " " << le->get_stamp() << ": " << *le << dendl;
       le->_segment = get_current_segment();    // replay may need this
       le->_segment->num_events++;
       le->_segment->end = journaler->get_read_pos();
       num_events++;
 
-      {
-        Mutex::Locker l(mds->mds_lock);
-        if (mds->is_daemon_stopping()) {
-          return;
-        }
-        logger->inc(l_mdl_replayed);
-        le->replay(mds);
+      batched_events.push_back(le);
+      if (batched_events.size() >= (size_t)g_conf->mds_log_replay_batch &&
+	  !flush_batch()) {
+	dout(10) << "_replay_thread stopping during batch flush" << dendl;
+	return;
       }
     }
-    delete le;
 
     logger->set(l_mdl_rdpos, pos);
   }
 
+  if (!flush_batch()) {
+    dout(10) << "_replay_thread stopping during batch flush" << dendl;
+    return;
+  }
+
   // done!
   if (r == 0) {
     assert(journaler->get_read_pos() == journaler->get_write_pos());
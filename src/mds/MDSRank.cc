@@ -259,6 +259,7 @@ void MDSRankDispatcher::tick()
     mdcache->trim();
     mdcache->trim_client_leases();
     mdcache->check_memory_usage();
+    mdcache->open_file_table.commit();
     mdlog->trim();  // NOT during recovery!
   }
 
@@ -1352,6 +1353,10 @@ void MDSRank::reconnect_start()
     set_osd_epoch_barrier(epoch);
   }
 
+  // warm the cache with the inodes clients are about to reconnect caps
+  // for; purely advisory, reconnect doesn't wait for it
+  mdcache->open_file_table.load_and_prefetch();
+
   server->reconnect_clients(new C_MDS_VoidFn(this, &MDSRank::reconnect_done));
   finish_contexts(g_ceph_context, waiting_for_reconnect);
 }
@@ -2568,6 +2573,18 @@ void MDSRank::create_logger()
     mds_plb.add_u64_counter(
       l_mds_imported_inodes, "imported_inodes", "Imported inodes", "imi",
       PerfCountersBuilder::PRIO_INTERESTING);
+    mds_plb.add_time_avg(l_mds_export_time, "export_time",
+			 "Time spent per subtree export");
+    mds_plb.add_time_avg(l_mds_import_time, "import_time",
+			 "Time spent per subtree import");
+    mds_plb.add_u64(l_mds_recall_backlog, "recall_backlog",
+		    "Caps recalled from clients but not yet released");
+    mds_plb.add_u64_counter(l_mds_cap_grants, "cap_grants",
+			    "Cap grant messages sent");
+    mds_plb.add_u64_counter(l_mds_cap_revokes, "cap_revokes",
+			    "Cap revoke messages sent");
+    mds_plb.add_time_avg(l_mds_cap_issue_lat, "cap_issue_lat",
+			 "Time spent issuing caps per inode");
     logger = mds_plb.create_perf_counters();
     g_ceph_context->get_perfcounters_collection()->add(logger);
   }
@@ -69,6 +69,12 @@ enum {
   l_mds_exported_inodes,
   l_mds_imported,
   l_mds_imported_inodes,
+  l_mds_export_time,
+  l_mds_import_time,
+  l_mds_recall_backlog,
+  l_mds_cap_grants,
+  l_mds_cap_revokes,
+  l_mds_cap_issue_lat,
   l_mds_last,
 };
 
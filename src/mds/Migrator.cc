@@ -860,6 +860,7 @@ void Migrator::export_dir(CDir *dir, mds_rank_t dest)
   stat.peer = dest;
   stat.tid = mdr->reqid.tid;
   stat.mut = mdr;
+  stat.start = ceph_clock_now();
 
   return mds->mdcache->dispatch_request(mdr);
 }
@@ -1996,6 +1997,9 @@ void Migrator::export_finish(CDir *dir)
   if (!finished.empty())
     mds->queue_waiters(finished);
 
+  if (mds->logger)
+    mds->logger->tinc(l_mds_export_time, ceph_clock_now() - it->second.start);
+
   MutationRef mut = it->second.mut;
   // remove from exporting list, clean up state
   export_state.erase(it);
@@ -2045,6 +2049,7 @@ void Migrator::handle_export_discover(MExportDirDiscover *m)
     import_state[df].state = IMPORT_DISCOVERING;
     import_state[df].peer = from;
     import_state[df].tid = m->get_tid();
+    import_state[df].start = ceph_clock_now();
   } else {
     // am i retrying after ancient path_traverse results?
     if (it == import_state.end() ||
@@ -2849,6 +2854,9 @@ void Migrator::import_finish(CDir *dir, bool notify, bool last)
   map<CInode*, map<client_t,Capability::Export> > peer_exports;
   it->second.peer_exports.swap(peer_exports);
 
+  if (mds->logger)
+    mds->logger->tinc(l_mds_import_time, ceph_clock_now() - it->second.start);
+
   // clear import state (we're done!)
   MutationRef mut = it->second.mut;
   import_state.erase(it);
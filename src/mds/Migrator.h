@@ -115,6 +115,7 @@ protected:
     set<mds_rank_t> notify_ack_waiting;
     map<inodeno_t,map<client_t,Capability::Import> > peer_imported;
     MutationRef mut;
+    utime_t start;  ///< when the export began, for timing metrics
     // for freeze tree deadlock detection
     utime_t last_cum_auth_pins_change;
     int last_cum_auth_pins;
@@ -138,6 +139,7 @@ protected:
     map<client_t,entity_inst_t> client_map;
     map<CInode*, map<client_t,Capability::Export> > peer_exports;
     MutationRef mut;
+    utime_t start;  ///< when the import began, for timing metrics
     import_state_t() : state(0), peer(0), tid(0), mut() {}
   };
 
@@ -0,0 +1,191 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * Copyright (C) 2017 Red Hat
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include "OpenFileTable.h"
+#include "CInode.h"
+#include "MDSRank.h"
+#include "MDSMap.h"
+#include "osdc/Objecter.h"
+#include "common/Finisher.h"
+#include "common/errno.h"
+
+#define dout_context g_ceph_context
+#define dout_subsys ceph_subsys_mds
+#undef dout_prefix
+#define dout_prefix *_dout << "mds." << mds->get_nodeid() << ".openfiles "
+
+class C_IO_OFT_Save : public MDSIOContext {
+  OpenFileTable *oft;
+public:
+  C_IO_OFT_Save(OpenFileTable *t, MDSRank *m) : MDSIOContext(m), oft(t) {}
+  void finish(int r) override {
+    oft->_commit_finish(r);
+  }
+};
+
+class C_IO_OFT_Load : public MDSIOContext {
+  OpenFileTable *oft;
+public:
+  int values_r = 0;
+  std::map<std::string, bufferlist> values;
+  bool more = false;
+
+  C_IO_OFT_Load(OpenFileTable *t, MDSRank *m) : MDSIOContext(m), oft(t) {}
+  void finish(int r) override {
+    oft->_load_finish(r, values_r, &values, more);
+  }
+};
+
+object_t OpenFileTable::get_object_name() const
+{
+  char s[30];
+  snprintf(s, sizeof(s), "mds%d_openfiles", int(mds->get_nodeid()));
+  return object_t(s);
+}
+
+void OpenFileTable::add_inode(CInode *in)
+{
+  if (!in->is_normal())
+    return;
+  dirty_items[in->ino()] = in->is_dir() ?
+    (int64_t)mds->mdsmap->get_metadata_pool() : in->inode.layout.pool_id;
+}
+
+void OpenFileTable::remove_inode(CInode *in)
+{
+  if (!in->is_normal())
+    return;
+  dirty_items[in->ino()] = -1;
+}
+
+void OpenFileTable::commit()
+{
+  if (dirty_items.empty() || committing)
+    return;
+
+  dout(10) << __func__ << " " << dirty_items.size() << " dirty items" << dendl;
+
+  map<string, bufferlist> to_set;
+  set<string> to_remove;
+  for (map<inodeno_t, int64_t>::iterator p = dirty_items.begin();
+       p != dirty_items.end();
+       ++p) {
+    char key[32];
+    snprintf(key, sizeof(key), "%llx", (unsigned long long)p->first.val);
+    if (p->second >= 0) {
+      bufferlist bl;
+      ::encode(p->second, bl);
+      to_set[key] = bl;
+    } else {
+      to_remove.insert(key);
+    }
+  }
+  dirty_items.clear();
+
+  ObjectOperation op;
+  if (!to_set.empty())
+    op.omap_set(to_set);
+  if (!to_remove.empty())
+    op.omap_rm_keys(to_remove);
+
+  committing = true;
+  SnapContext snapc;
+  object_locator_t oloc(mds->mdsmap->get_metadata_pool());
+  mds->objecter->mutate(get_object_name(), oloc, op, snapc,
+			ceph::real_clock::now(), 0,
+			new C_OnFinisher(new C_IO_OFT_Save(this, mds),
+					 mds->finisher));
+}
+
+void OpenFileTable::_commit_finish(int r)
+{
+  committing = false;
+  if (r < 0) {
+    // advisory data; complain and carry on, the dropped updates will be
+    // rewritten the next time the inodes' cap state changes
+    derr << __func__ << " got " << cpp_strerror(r) << dendl;
+    return;
+  }
+  dout(10) << __func__ << dendl;
+}
+
+void OpenFileTable::load_and_prefetch()
+{
+  dout(10) << __func__ << dendl;
+
+  C_IO_OFT_Load *c = new C_IO_OFT_Load(this, mds);
+  ObjectOperation op;
+  op.omap_get_vals("", "", g_conf->mds_sessionmap_keys_per_op,
+		   &c->values, &c->more, &c->values_r);
+
+  object_locator_t oloc(mds->mdsmap->get_metadata_pool());
+  mds->objecter->read(get_object_name(), oloc, op, CEPH_NOSNAP, NULL, 0,
+		      new C_OnFinisher(c, mds->finisher));
+}
+
+void OpenFileTable::_load_finish(int r, int values_r,
+				 std::map<std::string, bufferlist> *values,
+				 bool more)
+{
+  if (r == -ENOENT) {
+    dout(10) << __func__ << " no table object, nothing to prefetch" << dendl;
+    return;
+  }
+  if (r < 0 || values_r < 0) {
+    // this table only accelerates reconnect; never fail recovery over it
+    derr << __func__ << " got " << cpp_strerror(r < 0 ? r : values_r)
+	 << ", skipping prefetch" << dendl;
+    return;
+  }
+
+  _prefetch(*values);
+
+  if (more && !values->empty()) {
+    const std::string last_key = values->rbegin()->first;
+    dout(10) << __func__ << " continue omap load from '" << last_key << "'"
+	     << dendl;
+    C_IO_OFT_Load *c = new C_IO_OFT_Load(this, mds);
+    ObjectOperation op;
+    op.omap_get_vals(last_key, "", g_conf->mds_sessionmap_keys_per_op,
+		     &c->values, &c->more, &c->values_r);
+    object_locator_t oloc(mds->mdsmap->get_metadata_pool());
+    mds->objecter->read(get_object_name(), oloc, op, CEPH_NOSNAP, NULL, 0,
+			new C_OnFinisher(c, mds->finisher));
+  }
+}
+
+void OpenFileTable::_prefetch(const std::map<std::string, bufferlist> &values)
+{
+  dout(10) << __func__ << " " << values.size() << " inodes" << dendl;
+  for (std::map<std::string, bufferlist>::const_iterator p = values.begin();
+       p != values.end();
+       ++p) {
+    inodeno_t ino;
+    if (sscanf(p->first.c_str(), "%llx", (unsigned long long*)&ino.val) != 1) {
+      dout(0) << __func__ << " invalid key '" << p->first << "'" << dendl;
+      continue;
+    }
+    int64_t pool = -1;
+    try {
+      bufferlist::iterator q = p->second.begin();
+      ::decode(pool, q);
+    } catch (const buffer::error &e) {
+      dout(0) << __func__ << " corrupt value for ino " << ino << dendl;
+      continue;
+    }
+    if (mds->mdcache->get_inode(ino))
+      continue;
+    mds->mdcache->open_ino(ino, pool, new C_MDSInternalNoop, false);
+  }
+}
@@ -0,0 +1,72 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * Copyright (C) 2017 Red Hat
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#ifndef OPEN_FILE_TABLE_H
+#define OPEN_FILE_TABLE_H
+
+#include "mdstypes.h"
+#include "mds/MDSContext.h"
+
+class CInode;
+class MDSRank;
+
+/**
+ * Advisory table of inodes with live client caps, kept in the omap of a
+ * per-rank object in the metadata pool.  During normal operation the
+ * table is updated lazily, in batches, as caps come and go; after a
+ * failover the recovering rank reads it back and bulk-prefetches the
+ * listed inodes with open_ino() so that client reconnect doesn't have to
+ * fault them in with serial backtrace reads.
+ *
+ * The table is a cache hint, not a source of truth: it may list inodes
+ * whose caps are long gone and miss inodes whose first cap was issued
+ * after the last flush.  Prefetching a stale entry is wasted work and a
+ * missing one falls back to the old per-inode discovery, so nothing here
+ * needs to be ordered against the journal.
+ */
+class OpenFileTable
+{
+public:
+  explicit OpenFileTable(MDSRank *m) : mds(m) {}
+
+  /// inode got its first client cap
+  void add_inode(CInode *in);
+  /// inode dropped its last client cap
+  void remove_inode(CInode *in);
+
+  /// flush accumulated updates, if any (called from MDSRank::tick)
+  void commit();
+
+  /// read the table back and open_ino() everything in it
+  void load_and_prefetch();
+
+  friend class C_IO_OFT_Save;
+  friend class C_IO_OFT_Load;
+
+private:
+  object_t get_object_name() const;
+  void _commit_finish(int r);
+  void _load_finish(int r, int values_r,
+		    std::map<std::string, bufferlist> *values, bool more);
+  void _prefetch(const std::map<std::string, bufferlist> &values);
+
+  MDSRank *mds;
+
+  /// ino -> data pool to look for its backtrace in, or <0 if the last
+  /// cap went away and the key should be removed
+  std::map<inodeno_t, int64_t> dirty_items;
+  bool committing = false;
+};
+
+#endif
@@ -1092,6 +1092,7 @@ void Server::recall_client_state(float ratio)
 	   << ", caps per client " << min_caps_per_client << "-" << max_caps_per_client
 	   << dendl;
 
+  uint64_t backlog = 0;
   set<Session*> sessions;
   mds->sessionmap.get_client_session_set(sessions);
   for (set<Session*>::const_iterator p = sessions.begin();
@@ -1107,16 +1108,35 @@ void Server::recall_client_state(float ratio)
 	     << ", leases " << session->leases.size()
 	     << dendl;
 
-    if (session->caps.size() > min_caps_per_client) {	
+    if (!session->recalled_at.is_zero() &&
+	session->recall_release_count < session->recall_count) {
+      // an earlier recall is still being worked through; let the client
+      // finish (or the health check time it out) before asking for more,
+      // so a big trim happens as a series of steps instead of one storm
+      backlog += session->recall_count - session->recall_release_count;
+      dout(10) << "  recall in flight, "
+	       << session->recall_release_count << "/" << session->recall_count
+	       << " released" << dendl;
+      continue;
+    }
+
+    if (session->caps.size() > min_caps_per_client) {
       int newlim = MIN((int)(session->caps.size() * ratio), max_caps_per_client);
+      if (g_conf->mds_recall_max_caps > 0)
+	newlim = MAX(newlim,
+		     (int)session->caps.size() - g_conf->mds_recall_max_caps);
       if (session->caps.size() > newlim) {
           MClientSession *m = new MClientSession(CEPH_SESSION_RECALL_STATE);
           m->head.max_caps = newlim;
           mds->send_message_client(m, session);
           session->notify_recall_sent(newlim);
+	  backlog += session->caps.size() - newlim;
       }
     }
   }
+
+  if (mds->logger)
+    mds->logger->set(l_mds_recall_backlog, backlog);
 }
 
 void Server::force_clients_readonly()
@@ -3667,8 +3687,16 @@ void Server::handle_client_readdir(MDRequestRef& mdr)
 
   // build dir contents
   bufferlist dnbl;
+  if (bytes_left > 0)
+    // encode the whole batch into one contiguous buffer instead of
+    // growing the list one small append at a time
+    dnbl.reserve(MIN((unsigned)bytes_left, 512u << 10));
   __u32 numfiles = 0;
   bool start = !offset_hash && offset_str.empty();
+  // cursor into the (sorted) dirfrag; lower_bound gets us close, but
+  // entries with the same hash still need the full key comparison until
+  // we pass the offset, after which everything is fair game
+  bool past_offset = start;
   bool end = (dir->begin() == dir->end());
   // skip all dns < dentry_key_t(snapid, offset_str, offset_hash)
   dentry_key_t skip_key(snapid, offset_str.c_str(), offset_hash);
@@ -3692,10 +3720,11 @@ void Server::handle_client_readdir(MDRequestRef& mdr)
       continue;
     }
 
-    if (!start) {
+    if (!past_offset) {
       dentry_key_t offset_key(dn->last, offset_str.c_str(), offset_hash);
       if (!(offset_key < dn->key()))
 	continue;
+      past_offset = true;  // sorted map; no need to compare the rest
     }
 
     CInode *in = dnl->get_inode();
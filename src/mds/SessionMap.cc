@@ -347,6 +347,20 @@ public:
     }
   }
 };
+
+class C_IO_SM_Save_One : public SessionMapIOContext {
+  MDSInternalContextBase *on_safe;
+public:
+  C_IO_SM_Save_One(SessionMap *cm, MDSInternalContextBase *on_safe_)
+    : SessionMapIOContext(cm), on_safe(on_safe_) {}
+  void finish(int r) override {
+    if (r != 0) {
+      get_mds()->handle_write_error(r);
+    } else {
+      on_safe->complete(r);
+    }
+  }
+};
 }
 
 void SessionMap::save(MDSInternalContextBase *onsave, version_t needv)
@@ -406,6 +420,23 @@ void SessionMap::save(MDSInternalContextBase *onsave, version_t needv)
       to_set[k.str()] = bl;
 
       session->clear_dirty_completed_requests();
+
+      if (to_set.size() >= g_conf->mds_sessionmap_keys_per_op) {
+	// Flush this chunk on its own so a mass reconnect doesn't
+	// produce one huge omap_set.  Updates to the same object are
+	// applied in submission order, so the final op carrying the
+	// header (and the save completion) still lands last.
+	ObjectOperation chunk_op;
+	chunk_op.omap_set(to_set);
+	to_set.clear();
+	mds->objecter->mutate(oid, oloc, chunk_op, snapc,
+			      ceph::real_clock::now(),
+			      0,
+			      new C_OnFinisher(
+				new C_IO_SM_Save_One(this,
+						     new C_MDSInternalNoop),
+				mds->finisher));
+      }
     } else {
       dout(20) << "  " << name << " (ignoring)" << dendl;
     }
@@ -677,23 +708,6 @@ version_t SessionMap::mark_projected(Session *s)
   return projected;
 }
 
-namespace {
-class C_IO_SM_Save_One : public SessionMapIOContext {
-  MDSInternalContextBase *on_safe;
-public:
-  C_IO_SM_Save_One(SessionMap *cm, MDSInternalContextBase *on_safe_)
-    : SessionMapIOContext(cm), on_safe(on_safe_) {}
-  void finish(int r) override {
-    if (r != 0) {
-      get_mds()->handle_write_error(r);
-    } else {
-      on_safe->complete(r);
-    }
-  }
-};
-}
-
-
 void SessionMap::save_if_dirty(const std::set<entity_name_t> &tgt_sessions,
                                MDSGatherBuilder *gather_bld)
 {
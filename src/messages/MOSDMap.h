@@ -30,6 +30,11 @@ class MOSDMap : public Message {
   map<epoch_t, bufferlist> incremental_maps;
   epoch_t oldest_map, newest_map;
 
+  // which features the maps above were encoded with, or 0 if unknown;
+  // lets encode_payload skip the reencode pass when the sender already
+  // encoded them for this connection.  not part of the wire encoding.
+  uint64_t encode_features = 0;
+
   epoch_t get_first() const {
     epoch_t e = 0;
     map<epoch_t, bufferlist>::const_iterator i = maps.begin();
@@ -93,34 +98,38 @@ public:
       else if ((features & CEPH_FEATURE_OSDENC) == 0)
 	header.version = 2;  // old pg_pool_t
 
-      // reencode maps using old format
-      //
-      // FIXME: this can probably be done more efficiently higher up
-      // the stack, or maybe replaced with something that only
-      // includes the pools the client cares about.
-      for (map<epoch_t,bufferlist>::iterator p = incremental_maps.begin();
-	   p != incremental_maps.end();
-	   ++p) {
-	OSDMap::Incremental inc;
-	bufferlist::iterator q = p->second.begin();
-	inc.decode(q);
-	p->second.clear();
-	if (inc.fullmap.length()) {
-	  // embedded full map?
+      if (encode_features == 0 ||
+	  OSDMap::get_significant_features(encode_features) !=
+	  OSDMap::get_significant_features(features)) {
+	// reencode maps using old format
+	//
+	// FIXME: this can probably be done more efficiently higher up
+	// the stack, or maybe replaced with something that only
+	// includes the pools the client cares about.
+	for (map<epoch_t,bufferlist>::iterator p = incremental_maps.begin();
+	     p != incremental_maps.end();
+	     ++p) {
+	  OSDMap::Incremental inc;
+	  bufferlist::iterator q = p->second.begin();
+	  inc.decode(q);
+	  p->second.clear();
+	  if (inc.fullmap.length()) {
+	    // embedded full map?
+	    OSDMap m;
+	    m.decode(inc.fullmap);
+	    inc.fullmap.clear();
+	    m.encode(inc.fullmap, features | CEPH_FEATURE_RESERVED);
+	  }
+	  inc.encode(p->second, features | CEPH_FEATURE_RESERVED);
+	}
+	for (map<epoch_t,bufferlist>::iterator p = maps.begin();
+	     p != maps.end();
+	     ++p) {
 	  OSDMap m;
-	  m.decode(inc.fullmap);
-	  inc.fullmap.clear();
-	  m.encode(inc.fullmap, features | CEPH_FEATURE_RESERVED);
+	  m.decode(p->second);
+	  p->second.clear();
+	  m.encode(p->second, features | CEPH_FEATURE_RESERVED);
 	}
-	inc.encode(p->second, features | CEPH_FEATURE_RESERVED);
-      }
-      for (map<epoch_t,bufferlist>::iterator p = maps.begin();
-	   p != maps.end();
-	   ++p) {
-	OSDMap m;
-	m.decode(p->second);
-	p->second.clear();
-	m.encode(p->second, features | CEPH_FEATURE_RESERVED);
       }
     }
     ::encode(incremental_maps, payload);
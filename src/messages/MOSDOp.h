@@ -18,6 +18,7 @@
 
 #include "MOSDFastDispatchOp.h"
 #include "include/ceph_features.h"
+#include "include/mempool.h"
 #include "common/hobject.h"
 #include <atomic>
 
@@ -32,7 +33,9 @@
 class OSD;
 
 class MOSDOp : public MOSDFastDispatchOp {
-
+public:
+  MEMPOOL_CLASS_HELPERS();
+private:
   static const int HEAD_VERSION = 8;
   static const int COMPAT_VERSION = 3;
 
@@ -356,6 +359,15 @@ struct ceph_osd_request_head {
       // latest v8 encoding with hobject_t hash separate from pgid, no
       // reassert version
       header.version = HEAD_VERSION;
+
+      // almost all ops carry a single OSDOp, a short oid and no snaps;
+      // one up-front reservation keeps the appender from reallocating
+      // mid-encode
+      payload.reserve(160 + hobj.oid.name.length() +
+		      hobj.nspace.length() + hobj.get_key().length() +
+		      ops.size() * sizeof(ceph_osd_op) +
+		      snaps.size() * sizeof(snapid_t));
+
       ::encode(pgid, payload);
       ::encode(hobj.get_hash(), payload);
       ::encode(osdmap_epoch, payload);
@@ -18,6 +18,7 @@
 
 #include "msg/Message.h"
 
+#include "include/mempool.h"
 #include "MOSDOp.h"
 #include "os/ObjectStore.h"
 #include "common/errno.h"
@@ -31,7 +32,9 @@
  */
 
 class MOSDOpReply : public Message {
-
+public:
+  MEMPOOL_CLASS_HELPERS();
+private:
   static const int HEAD_VERSION = 8;
   static const int COMPAT_VERSION = 2;
 
@@ -175,6 +178,12 @@ public:
       ::encode_nohead(oid.name, payload);
     } else {
       header.version = HEAD_VERSION;
+
+      // single-op replies with a short oid dominate; reserve once so
+      // the appender never grows mid-encode
+      payload.reserve(128 + oid.name.length() +
+		      ops.size() * (sizeof(ceph_osd_op) + sizeof(__s32)));
+
       ::encode(oid, payload);
       ::encode(pgid, payload);
       ::encode(flags, payload);
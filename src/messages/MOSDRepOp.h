@@ -17,13 +17,16 @@
 #define CEPH_MOSDREPOP_H
 
 #include "MOSDFastDispatchOp.h"
+#include "include/mempool.h"
 
 /*
  * OSD sub op - for internal ops on pobjects between primary and replicas(/stripes/whatever)
  */
 
 class MOSDRepOp : public MOSDFastDispatchOp {
-
+public:
+  MEMPOOL_CLASS_HELPERS();
+private:
   static const int HEAD_VERSION = 2;
   static const int COMPAT_VERSION = 1;
 
@@ -17,6 +17,7 @@
 #define CEPH_MOSDREPOPREPLY_H
 
 #include "MOSDFastDispatchOp.h"
+#include "include/mempool.h"
 
 #include "os/ObjectStore.h"
 
@@ -29,6 +30,9 @@
  */
 
 class MOSDRepOpReply : public MOSDFastDispatchOp {
+public:
+  MEMPOOL_CLASS_HELPERS();
+private:
   static const int HEAD_VERSION = 2;
   static const int COMPAT_VERSION = 1;
 public:
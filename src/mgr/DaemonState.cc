@@ -126,13 +126,19 @@ void DaemonPerfCounters::update(MMgrReport *report)
     declared_types.erase(t);
   }
 
+  if (!report->declare_types.empty() ||
+      !report->undeclare_types.empty() ||
+      decode_order.size() != declared_types.size()) {
+    _rebuild_decode_order();
+  }
+
   const auto now = ceph_clock_now();
 
-  // Parse packed data according to declared set of types
+  // Parse packed data according to the cached decode order
   bufferlist::iterator p = report->packed.begin();
   DECODE_START(1, p);
-  for (const auto &t_path : declared_types) {
-    const auto &t = types.at(t_path);
+  for (auto &i : decode_order) {
+    const auto &t = *i.first;
     uint64_t val = 0;
     uint64_t avgcount = 0;
     uint64_t avgcount2 = 0;
@@ -143,14 +149,24 @@ void DaemonPerfCounters::update(MMgrReport *report)
       ::decode(avgcount2, p);
     }
     // TODO: interface for insertion of avgs
-    instances[t_path].push(now, val);
+    i.second->push(now, val);
   }
   DECODE_FINISH(p);
 }
 
+void DaemonPerfCounters::_rebuild_decode_order()
+{
+  decode_order.clear();
+  decode_order.reserve(declared_types.size());
+  // map nodes are stable, so the pointers stay valid until clear()
+  for (const auto &t_path : declared_types) {
+    decode_order.emplace_back(&types.at(t_path), &instances[t_path]);
+  }
+}
+
 uint64_t PerfCounterInstance::get_current() const
 {
-  return buffer.front().v;
+  return buffer.back().v;
 }
 
 void PerfCounterInstance::push(utime_t t, uint64_t const &v)
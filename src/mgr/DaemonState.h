@@ -46,9 +46,9 @@ class PerfCounterInstance
   };
 
   boost::circular_buffer<DataPoint> buffer;
-  uint64_t get_current() const;
 
   public:
+  uint64_t get_current() const;
   const boost::circular_buffer<DataPoint> & get_data() const
   {
     return buffer;
@@ -86,7 +86,17 @@ class DaemonPerfCounters
   {
     instances.clear();
     declared_types.clear();
+    decode_order.clear();
   }
+
+  private:
+  // The decode order of the packed data, one entry per declared type.
+  // Rebuilt when the declared set changes, so steady-state updates do
+  // no per-counter string lookups.
+  std::vector<std::pair<const PerfCounterType*, PerfCounterInstance*>>
+    decode_order;
+
+  void _rebuild_decode_order();
 };
 
 // The state that we store about one daemon
@@ -154,6 +164,20 @@ class DaemonStateIndex
     return by_server;
   }
 
+  /**
+   * Invoke the callback with a read-only reference to the by-server
+   * index, under the index lock.  This lets high-frequency consumers
+   * (exporters and the like) walk the state in place instead of
+   * copying whole collections per poll.
+   */
+  template<typename Callback, typename...Args>
+  auto with_daemons_by_server(Callback&& cb, Args&&... args) const ->
+    decltype(cb(by_server, std::forward<Args>(args)...))
+  {
+    Mutex::Locker l(lock);
+    return std::forward<Callback>(cb)(by_server, std::forward<Args>(args)...);
+  }
+
   void notify_updating(const DaemonKey &k) { updating.insert(k); }
   void clear_updating(const DaemonKey &k) { updating.erase(k); }
   bool is_updating(const DaemonKey &k) { return updating.count(k) > 0; }
@@ -88,10 +88,17 @@ PyObject *PyModules::get_server_python(const std::string &hostname)
   PyEval_RestoreThread(tstate);
   dout(10) << " (" << hostname << ")" << dendl;
 
-  auto dmc = daemon_state.get_by_server(hostname);
-
   PyFormatter f;
-  dump_server(hostname, dmc, &f);
+  daemon_state.with_daemons_by_server(
+    [this, &hostname, &f]
+    (const std::map<std::string, DaemonStateCollection> &all) {
+      auto p = all.find(hostname);
+      if (p != all.end()) {
+	dump_server(hostname, p->second, &f);
+      } else {
+	dump_server(hostname, {}, &f);
+      }
+    });
   return f.get();
 }
 
@@ -104,14 +111,17 @@ PyObject *PyModules::list_servers_python()
   dout(10) << " >" << dendl;
 
   PyFormatter f(false, true);
-  const auto &all = daemon_state.get_all_servers();
-  for (const auto &i : all) {
-    const auto &hostname = i.first;
-
-    f.open_object_section("server");
-    dump_server(hostname, i.second, &f);
-    f.close_section();
-  }
+  daemon_state.with_daemons_by_server(
+    [this, &f]
+    (const std::map<std::string, DaemonStateCollection> &all) {
+      for (const auto &i : all) {
+	const auto &hostname = i.first;
+
+	f.open_object_section("server");
+	dump_server(hostname, i.second, &f);
+	f.close_section();
+      }
+    });
 
   return f.get();
 }
@@ -661,6 +671,93 @@ PyObject* PyModules::get_counter_python(
   return f.get();
 }
 
+PyObject* PyModules::get_all_perf_counters_python(const std::string &handle)
+{
+  PyThreadState *tstate = PyEval_SaveThread();
+  Mutex::Locker l(lock);
+  PyEval_RestoreThread(tstate);
+
+  PyFormatter f;
+
+  // One pass over all daemons under a single lock hold, so exporters
+  // can take a consistent snapshot instead of locking per value.
+  // FIXME: as with get_counter_python, this reads the DaemonState
+  // objects without a per-daemon lock.
+  for (const auto &i : daemon_state.get_all()) {
+    const auto &key = i.first;
+    const auto &state = i.second;
+
+    std::ostringstream daemon_name;
+    daemon_name << ceph_entity_type_name(key.first) << "." << key.second;
+    f.open_object_section(daemon_name.str().c_str());
+
+    for (const auto &j : state->perf_counters.instances) {
+      const auto &path = j.first;
+      const auto &counter_instance = j.second;
+      auto t = state->perf_counters.types.find(path);
+      if (t == state->perf_counters.types.end()) {
+	continue;
+      }
+
+      f.open_object_section(path.c_str());
+      f.dump_string("description", t->second.description);
+      if (!t->second.nick.empty()) {
+	f.dump_string("nick", t->second.nick);
+      }
+      f.dump_unsigned("type", t->second.type);
+      const auto &data = counter_instance.get_data();
+      if (!data.empty()) {
+	f.dump_unsigned("t", data.back().t.sec());
+	f.dump_unsigned("v", data.back().v);
+      }
+      f.close_section();  // path
+    }
+    f.close_section();  // daemon
+  }
+
+  return f.get();
+}
+
+PyObject *PyModules::calc_pg_upmaps_python(
+    double max_deviation, int max_iterations,
+    const std::set<int64_t> &pools)
+{
+  PyThreadState *tstate = PyEval_SaveThread();
+  Mutex::Locker l(lock);
+  PyEval_RestoreThread(tstate);
+
+  PyFormatter f;
+  cluster_state.with_osdmap(
+    [&](const OSDMap &osd_map) {
+      // calc_pg_upmaps needs a mutable map to iterate on, so work
+      // on a copy and leave the live map alone.
+      OSDMap tmp;
+      tmp.deepish_copy_from(osd_map);
+      OSDMap::Incremental pending_inc(osd_map.get_epoch() + 1);
+      int changed = tmp.calc_pg_upmaps(g_ceph_context, max_deviation,
+				       max_iterations, pools, &pending_inc);
+      f.dump_int("num_changed", changed);
+      f.open_object_section("new_pg_upmap_items");
+      for (const auto &i : pending_inc.new_pg_upmap_items) {
+	f.open_array_section(stringify(i.first).c_str());
+	for (const auto &q : i.second) {
+	  f.open_object_section("mapping");
+	  f.dump_int("from", q.first);
+	  f.dump_int("to", q.second);
+	  f.close_section();
+	}
+	f.close_section();
+      }
+      f.close_section();
+      f.open_array_section("old_pg_upmap_items");
+      for (const auto &pg : pending_inc.old_pg_upmap_items) {
+	f.dump_stream("pgid") << pg;
+      }
+      f.close_section();
+    });
+  return f.get();
+}
+
 PyObject *PyModules::get_context()
 {
   PyThreadState *tstate = PyEval_SaveThread();
@@ -69,6 +69,9 @@ public:
   PyObject *get_counter_python(std::string const &handle,
       entity_type_t svc_type, const std::string &svc_id,
       const std::string &path);
+  PyObject *get_all_perf_counters_python(std::string const &handle);
+  PyObject *calc_pg_upmaps_python(double max_deviation, int max_iterations,
+      const std::set<int64_t> &pools);
   PyObject *get_context();
 
   std::map<std::string, std::string> config_cache;
@@ -348,6 +348,53 @@ get_counter(PyObject *self, PyObject *args)
       handle, svc_type, svc_id, counter_path);
 }
 
+static PyObject*
+calc_pg_upmaps(PyObject *self, PyObject *args)
+{
+  char *handle = nullptr;
+  double max_deviation = 0.01;
+  int max_iterations = 10;
+  PyObject *pools_list = nullptr;
+  if (!PyArg_ParseTuple(args, "sdi|O:calc_pg_upmaps",
+			&handle, &max_deviation, &max_iterations,
+			&pools_list)) {
+    return nullptr;
+  }
+
+  std::set<int64_t> pools;
+  if (pools_list != nullptr && pools_list != Py_None) {
+    PyObject *seq = PySequence_Fast(pools_list,
+				    "pools must be a sequence of pool ids");
+    if (seq == nullptr) {
+      return nullptr;
+    }
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i) {
+      PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+      long pool = PyInt_AsLong(item);
+      if (pool == -1 && PyErr_Occurred()) {
+	Py_DECREF(seq);
+	return nullptr;
+      }
+      pools.insert(pool);
+    }
+    Py_DECREF(seq);
+  }
+
+  return global_handle->calc_pg_upmaps_python(
+      max_deviation, max_iterations, pools);
+}
+
+static PyObject*
+get_all_perf_counters(PyObject *self, PyObject *args)
+{
+  char *handle = nullptr;
+  if (!PyArg_ParseTuple(args, "s:get_all_perf_counters", &handle)) {
+    return nullptr;
+  }
+
+  return global_handle->get_all_perf_counters_python(handle);
+}
+
 PyMethodDef CephStateMethods[] = {
     {"get", ceph_state_get, METH_VARARGS,
      "Get a cluster object"},
@@ -367,6 +414,10 @@ PyMethodDef CephStateMethods[] = {
      "Set a configuration value"},
     {"get_counter", get_counter, METH_VARARGS,
       "Get a performance counter"},
+    {"get_all_perf_counters", get_all_perf_counters, METH_VARARGS,
+      "Get one snapshot of the latest value of every daemon's counters"},
+    {"calc_pg_upmaps", calc_pg_upmaps, METH_VARARGS,
+      "Compute pg upmap entries to balance PG distribution"},
     {"log", ceph_log, METH_VARARGS,
      "Emit a (local) log message"},
     {"get_version", ceph_get_version, METH_VARARGS,
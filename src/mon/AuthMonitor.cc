@@ -257,7 +257,7 @@ void AuthMonitor::encode_full(MonitorDBStore::TransactionRef t)
   assert(get_last_committed() == version);
 
   bufferlist full_bl;
-  Mutex::Locker l(mon->key_server.get_lock());
+  RWLock::RLocker l(mon->key_server.get_lock());
   dout(20) << __func__ << " key server has "
            << (mon->key_server.has_secrets() ? "" : "no ")
            << "secrets!" << dendl;
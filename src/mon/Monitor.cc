@@ -565,6 +565,12 @@ int Monitor::preinit()
     pcb.add_u64_counter(l_mon_election_call, "election_call", "Elections started");
     pcb.add_u64_counter(l_mon_election_win, "election_win", "Elections won");
     pcb.add_u64_counter(l_mon_election_lose, "election_lose", "Elections lost");
+    pcb.add_time_avg(l_mon_osdmap_trim_floor_lat, "osdmap_trim_floor_lat",
+		     "Time to compute osdmap trim floor (min last epoch clean)");
+    pcb.add_u64_counter(l_mon_osdmap_cache_hit, "osdmap_cache_hit",
+			"OSDMap encoding cache hits");
+    pcb.add_u64_counter(l_mon_osdmap_cache_miss, "osdmap_cache_miss",
+			"OSDMap encoding cache misses");
     logger = pcb.create_perf_counters();
     cct->get_perfcounters_collection()->add(logger);
   }
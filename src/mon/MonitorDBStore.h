@@ -620,10 +620,12 @@ class MonitorDBStore
       }
       do_dump = true;
     }
-    if (kv_type == "rocksdb")
+    if (kv_type == "rocksdb") {
+      db->set_column_family_spec(g_conf->mon_rocksdb_column_families);
       db->init(g_conf->mon_rocksdb_options);
-    else
+    } else {
       db->init();
+    }
   }
 
   int open(ostream &out) {
@@ -1247,7 +1247,9 @@ void OSDMonitor::share_map_with_random_osd()
 
   dout(10) << "committed, telling random " << s->inst << " all about it" << dendl;
   // whatev, they'll request more if they need it
-  MOSDMap *m = build_incremental(osdmap.get_epoch() - 1, osdmap.get_epoch());
+  uint64_t features = s->con_features ? s->con_features : CEPH_FEATURES_ALL;
+  MOSDMap *m = build_incremental(osdmap.get_epoch() - 1, osdmap.get_epoch(),
+				 features);
   s->con->send_message(m);
   // NOTE: do *not* record osd has up to this epoch (as we do
   // elsewhere) as they may still need to request older values.
@@ -1277,7 +1279,9 @@ version_t OSDMonitor::get_trim_to()
     if (mon->pgservice->have_creating_pgs()) {
       return 0;
     }
+    utime_t start = ceph_clock_now();
     floor = mon->pgservice->get_min_last_epoch_clean();
+    mon->logger->tinc(l_mon_osdmap_trim_floor_lat, ceph_clock_now() - start);
   }
   {
     dout(10) << " min_last_epoch_clean " << floor << dendl;
@@ -1455,20 +1459,24 @@ bool OSDMonitor::preprocess_get_osdmap(MonOpRequestRef op)
   op->mark_osdmon_event(__func__);
   MMonGetOSDMap *m = static_cast<MMonGetOSDMap*>(op->get_req());
   dout(10) << __func__ << " " << *m << dendl;
+  MonSession *s = op->get_session();
+  assert(s);
+  uint64_t features = s->con_features ? s->con_features : CEPH_FEATURES_ALL;
   MOSDMap *reply = new MOSDMap(mon->monmap->fsid);
+  reply->encode_features = features;
   epoch_t first = get_first_committed();
   epoch_t last = osdmap.get_epoch();
   int max = g_conf->osd_map_message_max;
   for (epoch_t e = MAX(first, m->get_full_first());
        e <= MIN(last, m->get_full_last()) && max > 0;
        ++e, --max) {
-    int r = get_version_full(e, reply->maps[e]);
+    int r = get_version_full(e, features, reply->maps[e]);
     assert(r >= 0);
   }
   for (epoch_t e = MAX(first, m->get_inc_first());
        e <= MIN(last, m->get_inc_last()) && max > 0;
        ++e, --max) {
-    int r = get_version(e, reply->incremental_maps[e]);
+    int r = get_version(e, features, reply->incremental_maps[e]);
     assert(r >= 0);
   }
   reply->oldest_map = first;
@@ -2800,25 +2808,29 @@ void OSDMonitor::send_latest(MonOpRequestRef op, epoch_t start)
 }
 
 
-MOSDMap *OSDMonitor::build_latest_full()
+MOSDMap *OSDMonitor::build_latest_full(uint64_t features)
 {
   MOSDMap *r = new MOSDMap(mon->monmap->fsid);
-  get_version_full(osdmap.get_epoch(), r->maps[osdmap.get_epoch()]);
+  get_version_full(osdmap.get_epoch(), features, r->maps[osdmap.get_epoch()]);
   r->oldest_map = get_first_committed();
   r->newest_map = osdmap.get_epoch();
+  r->encode_features = features;
   return r;
 }
 
-MOSDMap *OSDMonitor::build_incremental(epoch_t from, epoch_t to)
+MOSDMap *OSDMonitor::build_incremental(epoch_t from, epoch_t to,
+				       uint64_t features)
 {
-  dout(10) << "build_incremental [" << from << ".." << to << "]" << dendl;
+  dout(10) << "build_incremental [" << from << ".." << to << "]"
+	   << " with features " << std::hex << features << std::dec << dendl;
   MOSDMap *m = new MOSDMap(mon->monmap->fsid);
   m->oldest_map = get_first_committed();
   m->newest_map = osdmap.get_epoch();
+  m->encode_features = features;
 
   for (epoch_t e = to; e >= from && e > 0; e--) {
     bufferlist bl;
-    int err = get_version(e, bl);
+    int err = get_version(e, features, bl);
     if (err == 0) {
       assert(bl.length());
       // if (get_version(e, bl) > 0) {
@@ -2828,7 +2840,7 @@ MOSDMap *OSDMonitor::build_incremental(epoch_t from, epoch_t to)
     } else {
       assert(err == -ENOENT);
       assert(!bl.length());
-      get_version_full(e, bl);
+      get_version_full(e, features, bl);
       if (bl.length() > 0) {
       //else if (get_version("full", e, bl) > 0) {
       dout(20) << "build_incremental   full " << e << " "
@@ -2846,7 +2858,10 @@ void OSDMonitor::send_full(MonOpRequestRef op)
 {
   op->mark_osdmon_event(__func__);
   dout(5) << "send_full to " << op->get_req()->get_orig_source_inst() << dendl;
-  mon->send_reply(op, build_latest_full());
+  MonSession *s = op->get_session();
+  assert(s);
+  uint64_t features = s->con_features ? s->con_features : CEPH_FEATURES_ALL;
+  mon->send_reply(op, build_latest_full(features));
 }
 
 void OSDMonitor::send_incremental(MonOpRequestRef op, epoch_t first)
@@ -2885,10 +2900,13 @@ void OSDMonitor::send_incremental(epoch_t first,
     first = session->osd_epoch + 1;
   }
 
+  uint64_t features = session->con_features ? session->con_features
+    : CEPH_FEATURES_ALL;
+
   if (first < get_first_committed()) {
     first = get_first_committed();
     bufferlist bl;
-    int err = get_version_full(first, bl);
+    int err = get_version_full(first, features, bl);
     assert(err == 0);
     assert(bl.length());
 
@@ -2899,6 +2917,7 @@ void OSDMonitor::send_incremental(epoch_t first,
     m->oldest_map = get_first_committed();
     m->newest_map = osdmap.get_epoch();
     m->maps[first] = bl;
+    m->encode_features = features;
 
     if (req) {
       mon->send_reply(req, m);
@@ -2914,7 +2933,7 @@ void OSDMonitor::send_incremental(epoch_t first,
   while (first <= osdmap.get_epoch()) {
     epoch_t last = MIN(first + g_conf->osd_map_message_max - 1,
 		       osdmap.get_epoch());
-    MOSDMap *m = build_incremental(first, last);
+    MOSDMap *m = build_incremental(first, last, features);
 
     if (req) {
       // send some maps.  it may not be all of them, but it will get them
@@ -2930,28 +2949,77 @@ void OSDMonitor::send_incremental(epoch_t first,
   }
 }
 
+void OSDMonitor::reencode_incremental_map(bufferlist& bl, uint64_t features)
+{
+  OSDMap::Incremental inc;
+  bufferlist::iterator q = bl.begin();
+  inc.decode(q);
+  bl.clear();
+  if (inc.fullmap.length()) {
+    // embedded full map?
+    OSDMap m;
+    m.decode(inc.fullmap);
+    inc.fullmap.clear();
+    m.encode(inc.fullmap, features | CEPH_FEATURE_RESERVED);
+  }
+  inc.encode(bl, features | CEPH_FEATURE_RESERVED);
+}
+
+void OSDMonitor::reencode_full_map(bufferlist& bl, uint64_t features)
+{
+  OSDMap m;
+  m.decode(bl);
+  bl.clear();
+  m.encode(bl, features | CEPH_FEATURE_RESERVED);
+}
+
 int OSDMonitor::get_version(version_t ver, bufferlist& bl)
 {
-    if (inc_osd_cache.lookup(ver, &bl)) {
-      return 0;
-    }
-    int ret = PaxosService::get_version(ver, bl);
-    if (!ret) {
-      inc_osd_cache.add(ver, bl);
+  return get_version(ver, CEPH_FEATURES_ALL, bl);
+}
+
+int OSDMonitor::get_version(version_t ver, uint64_t features, bufferlist& bl)
+{
+  uint64_t significant_features = OSDMap::get_significant_features(features);
+  if (inc_osd_cache.lookup({ver, significant_features}, &bl)) {
+    mon->logger->inc(l_mon_osdmap_cache_hit);
+    return 0;
+  }
+  int ret = PaxosService::get_version(ver, bl);
+  if (!ret) {
+    mon->logger->inc(l_mon_osdmap_cache_miss);
+    if (significant_features != OSDMap::SIGNIFICANT_FEATURES) {
+      // the stored encoding uses the full featureset; reencode (once)
+      // for this feature combination
+      reencode_incremental_map(bl, features);
     }
-    return ret;
+    inc_osd_cache.add({ver, significant_features}, bl);
+  }
+  return ret;
 }
 
 int OSDMonitor::get_version_full(version_t ver, bufferlist& bl)
 {
-    if (full_osd_cache.lookup(ver, &bl)) {
-      return 0;
-    }
-    int ret = PaxosService::get_version_full(ver, bl);
-    if (!ret) {
-      full_osd_cache.add(ver, bl);
+  return get_version_full(ver, CEPH_FEATURES_ALL, bl);
+}
+
+int OSDMonitor::get_version_full(version_t ver, uint64_t features,
+				 bufferlist& bl)
+{
+  uint64_t significant_features = OSDMap::get_significant_features(features);
+  if (full_osd_cache.lookup({ver, significant_features}, &bl)) {
+    mon->logger->inc(l_mon_osdmap_cache_hit);
+    return 0;
+  }
+  int ret = PaxosService::get_version_full(ver, bl);
+  if (!ret) {
+    mon->logger->inc(l_mon_osdmap_cache_miss);
+    if (significant_features != OSDMap::SIGNIFICANT_FEATURES) {
+      reencode_full_map(bl, features);
     }
-    return ret;
+    full_osd_cache.add({ver, significant_features}, bl);
+  }
+  return ret;
 }
 
 epoch_t OSDMonitor::blacklist(const entity_addr_t& a, utime_t until)
@@ -2985,10 +3053,13 @@ void OSDMonitor::check_osdmap_sub(Subscription *sub)
   dout(10) << __func__ << " " << sub << " next " << sub->next
 	   << (sub->onetime ? " (onetime)":" (ongoing)") << dendl;
   if (sub->next <= osdmap.get_epoch()) {
-    if (sub->next >= 1)
+    if (sub->next >= 1) {
       send_incremental(sub->next, sub->session, sub->incremental_onetime);
-    else
-      sub->session->con->send_message(build_latest_full());
+    } else {
+      uint64_t features = sub->session->con_features ?
+	sub->session->con_features : CEPH_FEATURES_ALL;
+      sub->session->con->send_message(build_latest_full(features));
+    }
     if (sub->onetime)
       mon->session_map.remove_sub(sub);
     else
@@ -3823,7 +3894,8 @@ namespace {
     RECOVERY_PRIORITY, RECOVERY_OP_PRIORITY, SCRUB_PRIORITY,
     COMPRESSION_MODE, COMPRESSION_ALGORITHM, COMPRESSION_REQUIRED_RATIO,
     COMPRESSION_MAX_BLOB_SIZE, COMPRESSION_MIN_BLOB_SIZE,
-    CSUM_TYPE, CSUM_MAX_BLOCK, CSUM_MIN_BLOCK };
+    CSUM_TYPE, CSUM_MAX_BLOCK, CSUM_MIN_BLOCK,
+    COMPRESSION_DICTIONARY };
 
   std::set<osd_pool_get_choices>
     subtract_second_from_first(const std::set<osd_pool_get_choices>& first,
@@ -4434,6 +4506,7 @@ bool OSDMonitor::preprocess_command(MonOpRequestRef op)
       {"csum_type", CSUM_TYPE},
       {"csum_max_block", CSUM_MAX_BLOCK},
       {"csum_min_block", CSUM_MIN_BLOCK},
+      {"compression_dictionary", COMPRESSION_DICTIONARY},
     };
 
     typedef std::set<osd_pool_get_choices> choices_set_t;
@@ -4635,6 +4708,7 @@ bool OSDMonitor::preprocess_command(MonOpRequestRef op)
 	  case CSUM_TYPE:
 	  case CSUM_MAX_BLOCK:
 	  case CSUM_MIN_BLOCK:
+	  case COMPRESSION_DICTIONARY:
 	    for (i = ALL_CHOICES.begin(); i != ALL_CHOICES.end(); ++i) {
 	      if (i->second == *it)
 		break;
@@ -4789,6 +4863,7 @@ bool OSDMonitor::preprocess_command(MonOpRequestRef op)
 	  case CSUM_TYPE:
 	  case CSUM_MAX_BLOCK:
 	  case CSUM_MIN_BLOCK:
+	  case COMPRESSION_DICTIONARY:
 	    for (i = ALL_CHOICES.begin(); i != ALL_CHOICES.end(); ++i) {
 	      if (i->second == *it)
 		break;
@@ -6183,6 +6258,21 @@ int OSDMonitor::prepare_command_pool_set(map<string,cmd_vartype> &cmdmap,
 	  return -EINVAL;
         }
       }
+    } else if (var == "compression_dictionary") {
+      if (!unset) {
+        bufferlist dict, b64;
+        b64.append(val);
+        try {
+          dict.decode_base64(b64);
+        } catch (buffer::error& e) {
+          ss << "compression_dictionary must be valid base64";
+          return -EINVAL;
+        }
+        if (dict.length() == 0) {
+          ss << "compression_dictionary is empty";
+          return -EINVAL;
+        }
+      }
     } else if (var == "compression_required_ratio") {
       if (floaterr.length()) {
         ss << "error parsing float value '" << val << "': " << floaterr;
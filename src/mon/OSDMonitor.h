@@ -142,8 +142,18 @@ public:
 
   map<int,double> osd_weight;
 
-  SimpleLRU<version_t, bufferlist> inc_osd_cache;
-  SimpleLRU<version_t, bufferlist> full_osd_cache;
+  // cached map encodings, keyed by (version, significant feature bits)
+  // so old-format reencodes are done once per epoch, not per subscriber
+  typedef std::pair<version_t,uint64_t> osdmap_cache_key_t;
+  struct osdmap_cache_key_hash {
+    size_t operator()(const osdmap_cache_key_t &k) const {
+      return std::hash<uint64_t>()(k.first ^ (k.second << 1));
+    }
+  };
+  SimpleLRU<osdmap_cache_key_t, bufferlist,
+	    std::less<osdmap_cache_key_t>, osdmap_cache_key_hash> inc_osd_cache;
+  SimpleLRU<osdmap_cache_key_t, bufferlist,
+	    std::less<osdmap_cache_key_t>, osdmap_cache_key_hash> full_osd_cache;
 
   bool check_failures(utime_t now);
   bool check_failure(utime_t now, int target_osd, failure_info_t& fi);
@@ -246,8 +256,8 @@ private:
   bool can_mark_in(int o);
 
   // ...
-  MOSDMap *build_latest_full();
-  MOSDMap *build_incremental(epoch_t first, epoch_t last);
+  MOSDMap *build_latest_full(uint64_t features);
+  MOSDMap *build_incremental(epoch_t first, epoch_t last, uint64_t features);
   void send_full(MonOpRequestRef op);
   void send_incremental(MonOpRequestRef op, epoch_t first);
 public:
@@ -528,6 +538,11 @@ public:
 
   int get_version(version_t ver, bufferlist& bl) override;
   int get_version_full(version_t ver, bufferlist& bl) override;
+  int get_version(version_t ver, uint64_t features, bufferlist& bl);
+  int get_version_full(version_t ver, uint64_t features, bufferlist& bl);
+
+  void reencode_incremental_map(bufferlist& bl, uint64_t features);
+  void reencode_full_map(bufferlist& bl, uint64_t features);
 
   epoch_t blacklist(const entity_addr_t& a, utime_t until);
 
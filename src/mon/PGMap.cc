@@ -1079,13 +1079,23 @@ void PGMap::apply_incremental(CephContext *cct, const Incremental& inc)
       pg_pool_sum_old[update_pg.pool()] = pg_pool_sum[update_pg.pool()];
 
     auto t = pg_stat.find(update_pg);
+    epoch_t old_lec = 0;
     if (t == pg_stat.end()) {
       pg_stat.insert(make_pair(update_pg, update_stat));
     } else {
+      old_lec = t->second.get_effective_last_epoch_clean();
       stat_pg_sub(update_pg, t->second);
       t->second = update_stat;
     }
     stat_pg_add(update_pg, update_stat);
+
+    epoch_t lec = update_stat.get_effective_last_epoch_clean();
+    if (min_last_epoch_clean &&
+	(lec < min_last_epoch_clean ||  // we did
+	 (lec > min_last_epoch_clean && // we might
+	  old_lec == min_last_epoch_clean)
+	))
+      min_last_epoch_clean = 0;  // invalidate
   }
   assert(osd_stat.size() == osd_epochs.size());
   for (auto p = inc.get_osd_stat_updates().begin();
@@ -1105,10 +1115,18 @@ void PGMap::apply_incremental(CephContext *cct, const Incremental& inc)
     auto j = inc.get_osd_epochs().find(osd);
     assert(j != inc.get_osd_epochs().end());
 
-    if (i == osd_epochs.end())
+    epoch_t old_lec = 0;
+    if (i == osd_epochs.end()) {
       osd_epochs.insert(*j);
-    else
+    } else {
+      old_lec = i->second;
       i->second = j->second;
+    }
+    if (min_last_epoch_clean &&
+	(j->second < min_last_epoch_clean ||
+	 (j->second > min_last_epoch_clean &&
+	  old_lec == min_last_epoch_clean)))
+      min_last_epoch_clean = 0;  // invalidate
 
     stat_osd_add(osd, new_stats);
 
@@ -1122,6 +1140,9 @@ void PGMap::apply_incremental(CephContext *cct, const Incremental& inc)
     const pg_t &removed_pg(*p);
     auto s = pg_stat.find(removed_pg);
     if (s != pg_stat.end()) {
+      if (min_last_epoch_clean &&
+	  s->second.get_effective_last_epoch_clean() == min_last_epoch_clean)
+	min_last_epoch_clean = 0;  // invalidate
       stat_pg_sub(removed_pg, s->second);
       pg_stat.erase(s);
     }
@@ -1135,7 +1156,13 @@ void PGMap::apply_incremental(CephContext *cct, const Incremental& inc)
     if (t != osd_stat.end()) {
       stat_osd_sub(t->first, t->second);
       osd_stat.erase(t);
-      osd_epochs.erase(*p);
+      auto i = osd_epochs.find(*p);
+      if (i != osd_epochs.end()) {
+	if (min_last_epoch_clean &&
+	    i->second == min_last_epoch_clean)
+	  min_last_epoch_clean = 0;  // invalidate
+	osd_epochs.erase(i);
+      }
     }
 
     // remove these old osds from full/nearfull set(s), too
@@ -1168,8 +1195,6 @@ void PGMap::apply_incremental(CephContext *cct, const Incremental& inc)
     last_osdmap_epoch = inc.osdmap_epoch;
   if (inc.pg_scan)
     last_pg_scan = inc.pg_scan;
-
-  min_last_epoch_clean = 0;  // invalidate
 }
 
 void PGMap::redo_full_sets()
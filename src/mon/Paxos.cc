@@ -655,6 +655,27 @@ void Paxos::begin(bufferlist& v)
   logger->inc(l_paxos_begin);
   logger->inc(l_paxos_begin_keys, t->get_keys());
   logger->inc(l_paxos_begin_bytes, t->get_bytes());
+
+  // ask others to accept it too!  do this before our own (synchronous)
+  // store write so the peons' writes and the network round-trip overlap
+  // with our fsync.  this doesn't change the accounting: we counted our
+  // own accept above, but OP_ACCEPT replies can't be processed until we
+  // return and release the mon lock, by which point our write is durable.
+  for (set<int>::const_iterator p = mon->get_quorum().begin();
+       p != mon->get_quorum().end();
+       ++p) {
+    if (*p == mon->rank) continue;
+
+    dout(10) << " sending begin to mon." << *p << dendl;
+    MMonPaxos *begin = new MMonPaxos(mon->get_epoch(), MMonPaxos::OP_BEGIN,
+				     ceph_clock_now());
+    begin->values[last_committed+1] = new_value;
+    begin->last_committed = last_committed;
+    begin->pn = accepted_pn;
+
+    mon->messenger->send_message(begin, mon->monmap->get_inst(*p));
+  }
+
   utime_t start = ceph_clock_now();
 
   get_store()->apply_transaction(t);
@@ -670,22 +691,6 @@ void Paxos::begin(bufferlist& v)
     return;
   }
 
-  // ask others to accept it too!
-  for (set<int>::const_iterator p = mon->get_quorum().begin();
-       p != mon->get_quorum().end();
-       ++p) {
-    if (*p == mon->rank) continue;
-    
-    dout(10) << " sending begin to mon." << *p << dendl;
-    MMonPaxos *begin = new MMonPaxos(mon->get_epoch(), MMonPaxos::OP_BEGIN,
-				     ceph_clock_now());
-    begin->values[last_committed+1] = new_value;
-    begin->last_committed = last_committed;
-    begin->pn = accepted_pn;
-    
-    mon->messenger->send_message(begin, mon->monmap->get_inst(*p));
-  }
-
   // set timeout event
   accept_timeout_event = new C_MonContext(mon, [this](int r) {
       if (r == -ECANCELED)
@@ -1512,7 +1517,9 @@ void Paxos::propose_pending()
   pending_proposal->encode(bl);
 
   dout(10) << __func__ << " " << (last_committed + 1)
-	   << " " << bl.length() << " bytes" << dendl;
+	   << " " << bl.length() << " bytes"
+	   << " (" << pending_finishers.size() << " queued proposals)"
+	   << dendl;
   dout(30) << __func__ << " transaction dump:\n";
   JSONFormatter f(true);
   pending_proposal->dump(&f);
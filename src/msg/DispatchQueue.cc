@@ -16,10 +16,27 @@
 #include "DispatchQueue.h"
 #include "Messenger.h"
 #include "common/ceph_context.h"
+#include "common/admin_socket.h"
+#include "common/errno.h"
+#include "common/Formatter.h"
 
 #define dout_subsys ceph_subsys_ms
 #include "common/debug.h"
 
+class DispatchQueue::DumpHook : public AdminSocketHook {
+  DispatchQueue *dq;
+public:
+  explicit DumpHook(DispatchQueue *dq) : dq(dq) {}
+  bool call(std::string command, cmdmap_t& cmdmap, std::string format,
+	    bufferlist& out) override {
+    std::unique_ptr<Formatter> f(Formatter::create(format, "json-pretty",
+						   "json-pretty"));
+    dq->dump(f.get());
+    f->flush(out);
+    return true;
+  }
+};
+
 
 /*******************
  * DispatchQueue
@@ -67,6 +84,14 @@ bool DispatchQueue::can_fast_dispatch(const Message *m) const
 
 void DispatchQueue::fast_dispatch(Message *m)
 {
+  if (m->has_deferred_data_crc() &&
+      !msgr->ms_can_defer_data_crc(m) &&
+      !m->verify_deferred_data_crc(cct)) {
+    ldout(cct, 0) << "fast_dispatch discarding " << m
+		  << " with bad deferred data crc" << dendl;
+    m->put();
+    return;
+  }
   uint64_t msize = pre_dispatch(m);
   msgr->ms_fast_dispatch(m);
   post_dispatch(m, msize);
@@ -83,11 +108,12 @@ void DispatchQueue::enqueue(Message *m, int priority, uint64_t id)
   Mutex::Locker l(lock);
   ldout(cct,20) << "queue " << m << " prio " << priority << dendl;
   add_arrival(m);
+  add_backlog(m, id);
   if (priority >= CEPH_MSG_PRIO_LOW) {
-    mqueue.enqueue_strict(
+    mqueue->enqueue_strict(
         id, priority, QueueItem(m));
   } else {
-    mqueue.enqueue(
+    mqueue->enqueue(
         id, priority, m->get_cost(), QueueItem(m));
   }
   cond.Signal();
@@ -152,10 +178,12 @@ void DispatchQueue::entry()
 {
   lock.Lock();
   while (true) {
-    while (!mqueue.empty()) {
-      QueueItem qitem = mqueue.dequeue();
-      if (!qitem.is_code())
+    while (!mqueue->empty()) {
+      QueueItem qitem = mqueue->dequeue();
+      if (!qitem.is_code()) {
 	remove_arrival(qitem.get_message());
+	remove_backlog(qitem.get_message());
+      }
       lock.Unlock();
 
       if (qitem.is_code()) {
@@ -192,6 +220,10 @@ void DispatchQueue::entry()
 	if (stop) {
 	  ldout(cct,10) << " stop flag set, discarding " << m << " " << *m << dendl;
 	  m->put();
+	} else if (!m->verify_deferred_data_crc(cct)) {
+	  ldout(cct,0) << " discarding " << m << " with bad deferred data crc"
+		       << dendl;
+	  m->put();
 	} else {
 	  uint64_t msize = pre_dispatch(m);
 	  msgr->ms_deliver_dispatch(m);
@@ -213,24 +245,64 @@ void DispatchQueue::entry()
 void DispatchQueue::discard_queue(uint64_t id) {
   Mutex::Locker l(lock);
   list<QueueItem> removed;
-  mqueue.remove_by_class(id, &removed);
+  mqueue->remove_by_class(id, &removed);
   for (list<QueueItem>::iterator i = removed.begin();
        i != removed.end();
        ++i) {
     assert(!(i->is_code())); // We don't discard id 0, ever!
     Message *m = i->get_message();
     remove_arrival(m);
+    remove_backlog(m);
     dispatch_throttle_release(m->get_dispatch_throttle_size());
     m->put();
   }
 }
 
+void DispatchQueue::dump(Formatter *f) const
+{
+  Mutex::Locker l(lock);
+  f->open_object_section("dispatch_queue");
+  f->dump_unsigned("length", mqueue->length());
+  f->dump_float("max_age",
+		marrival.empty() ? 0 :
+		(double)(ceph_clock_now() - marrival.begin()->first));
+  f->open_array_section("connections");
+  for (map<uint64_t, Backlog>::const_iterator p = backlogs.begin();
+       p != backlogs.end();
+       ++p) {
+    f->open_object_section("connection");
+    f->dump_unsigned("id", p->first);
+    f->dump_unsigned("queued_msgs", p->second.msgs);
+    f->dump_unsigned("queued_bytes", p->second.bytes);
+    f->close_section();
+  }
+  f->close_section();
+  f->open_object_section("mqueue");
+  mqueue->dump(f);
+  f->close_section();
+  f->close_section();
+}
+
 void DispatchQueue::start()
 {
   assert(!stop);
   assert(!dispatch_thread.is_started());
   dispatch_thread.create("ms_dispatch");
   local_delivery_thread.create("ms_local");
+
+  assert(!dump_hook);
+  dump_hook = new DumpHook(this);
+  string cmd = "dispatch_queue dump " + name;
+  int r = cct->get_admin_socket()->register_command(
+    cmd, cmd, dump_hook,
+    "show per-connection dispatch queue backlog");
+  if (r < 0) {
+    // e.g. two messengers with the same name in one process; not fatal
+    ldout(cct, 10) << __func__ << " cannot register admin socket command '"
+		   << cmd << "': " << cpp_strerror(r) << dendl;
+    delete dump_hook;
+    dump_hook = nullptr;
+  }
 }
 
 void DispatchQueue::wait()
@@ -252,6 +324,12 @@ void DispatchQueue::discard_local()
 
 void DispatchQueue::shutdown()
 {
+  if (dump_hook) {
+    cct->get_admin_socket()->unregister_command("dispatch_queue dump " + name);
+    delete dump_hook;
+    dump_hook = nullptr;
+  }
+
   // stop my local delivery thread
   local_delivery_lock.Lock();
   stop_local_delivery = true;
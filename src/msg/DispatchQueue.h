@@ -17,6 +17,7 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <boost/intrusive_ptr.hpp>
 #include "include/assert.h"
 #include "include/xlist.h"
@@ -24,6 +25,7 @@
 #include "common/Cond.h"
 #include "common/Thread.h"
 #include "common/PrioritizedQueue.h"
+#include "common/WeightedPriorityQueue.h"
 
 class CephContext;
 class Messenger;
@@ -63,10 +65,15 @@ class DispatchQueue {
     
   CephContext *cct;
   Messenger *msgr;
+  const std::string name;
   mutable Mutex lock;
   Cond cond;
 
-  PrioritizedQueue<QueueItem, uint64_t> mqueue;
+  // either a PrioritizedQueue or a WeightedPriorityQueue keyed by
+  // connection id, selected by ms_dispatch_queue_type.  wpq spreads
+  // dequeues across connections by cost so one busy peer cannot starve
+  // the others at the same priority.
+  std::unique_ptr<OpQueue<QueueItem, uint64_t>> mqueue;
 
   set<pair<double, Message*> > marrival;
   map<Message *, set<pair<double, Message*> >::iterator> marrival_map;
@@ -86,6 +93,32 @@ class DispatchQueue {
     marrival_map.erase(i);
   }
 
+  // per-connection backlog, exposed via the "dispatch_queue dump" admin
+  // socket command; maintained under lock alongside marrival
+  struct Backlog {
+    unsigned msgs = 0;
+    uint64_t bytes = 0;
+  };
+  map<uint64_t, Backlog> backlogs;
+  map<Message*, uint64_t> backlog_id;
+  void add_backlog(Message *m, uint64_t id) {
+    backlog_id[m] = id;
+    Backlog& b = backlogs[id];
+    b.msgs++;
+    b.bytes += m->get_cost();
+  }
+  void remove_backlog(Message *m) {
+    map<Message*, uint64_t>::iterator i = backlog_id.find(m);
+    assert(i != backlog_id.end());
+    map<uint64_t, Backlog>::iterator b = backlogs.find(i->second);
+    assert(b != backlogs.end());
+    b->second.msgs--;
+    b->second.bytes -= m->get_cost();
+    if (b->second.msgs == 0)
+      backlogs.erase(b);
+    backlog_id.erase(i);
+  }
+
   std::atomic<uint64_t> next_id;
     
   enum { D_CONNECT = 1, D_ACCEPT, D_BAD_REMOTE_RESET, D_BAD_RESET, D_CONN_REFUSED, D_NUM_CODES };
@@ -103,6 +136,9 @@ class DispatchQueue {
     }
   } dispatch_thread;
 
+  class DumpHook;
+  DumpHook *dump_hook;
+
   Mutex local_delivery_lock;
   Cond local_delivery_cond;
   bool stop_local_delivery;
@@ -133,7 +169,7 @@ class DispatchQueue {
 
   int get_queue_len() const {
     Mutex::Locker l(lock);
-    return mqueue.length();
+    return mqueue->length();
   }
 
   /**
@@ -147,7 +183,7 @@ class DispatchQueue {
     Mutex::Locker l(lock);
     if (stop)
       return;
-    mqueue.enqueue_strict(
+    mqueue->enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
       QueueItem(D_CONNECT, con));
@@ -157,7 +193,7 @@ class DispatchQueue {
     Mutex::Locker l(lock);
     if (stop)
       return;
-    mqueue.enqueue_strict(
+    mqueue->enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
       QueueItem(D_ACCEPT, con));
@@ -167,7 +203,7 @@ class DispatchQueue {
     Mutex::Locker l(lock);
     if (stop)
       return;
-    mqueue.enqueue_strict(
+    mqueue->enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
       QueueItem(D_BAD_REMOTE_RESET, con));
@@ -177,7 +213,7 @@ class DispatchQueue {
     Mutex::Locker l(lock);
     if (stop)
       return;
-    mqueue.enqueue_strict(
+    mqueue->enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
       QueueItem(D_BAD_RESET, con));
@@ -187,7 +223,7 @@ class DispatchQueue {
     Mutex::Locker l(lock);
     if (stop)
       return;
-    mqueue.enqueue_strict(
+    mqueue->enqueue_strict(
       0,
       CEPH_MSG_PRIO_HIGHEST,
       QueueItem(D_CONN_REFUSED, con));
@@ -209,22 +245,32 @@ class DispatchQueue {
   void shutdown();
   bool is_started() const {return dispatch_thread.is_started();}
 
+  void dump(ceph::Formatter *f) const;
+
   DispatchQueue(CephContext *cct, Messenger *msgr, string &name)
-    : cct(cct), msgr(msgr),
+    : cct(cct), msgr(msgr), name(name),
       lock("Messenger::DispatchQueue::lock" + name),
-      mqueue(cct->_conf->ms_pq_max_tokens_per_priority,
-	     cct->_conf->ms_pq_min_cost),
       next_id(1),
       dispatch_thread(this),
+      dump_hook(nullptr),
       local_delivery_lock("Messenger::DispatchQueue::local_delivery_lock" + name),
       stop_local_delivery(false),
       local_delivery_thread(this),
       dispatch_throttler(cct, string("msgr_dispatch_throttler-") + name,
                          cct->_conf->ms_dispatch_throttle_bytes),
       stop(false)
-    {}
+    {
+      if (cct->_conf->ms_dispatch_queue_type == "wpq")
+	mqueue.reset(new WeightedPriorityQueue<QueueItem, uint64_t>(
+	  cct->_conf->ms_pq_max_tokens_per_priority,
+	  cct->_conf->ms_pq_min_cost));
+      else
+	mqueue.reset(new PrioritizedQueue<QueueItem, uint64_t>(
+	  cct->_conf->ms_pq_max_tokens_per_priority,
+	  cct->_conf->ms_pq_min_cost));
+    }
   ~DispatchQueue() {
-    assert(mqueue.empty());
+    assert(mqueue->empty());
     assert(marrival.empty());
     assert(local_messages.empty());
   }
@@ -67,6 +67,14 @@ public:
    * fast dispatch; false otherwise.
    */
   virtual bool ms_can_fast_dispatch_any() const { return false; }
+  /**
+   * Declare that this Dispatcher takes responsibility for verifying
+   * the deferred data crc (Message::verify_deferred_data_crc()) of
+   * messages it fast dispatches, e.g. on a worker thread that touches
+   * the payload anyway.  If false, the crc is checked before
+   * ms_fast_dispatch is called.
+   */
+  virtual bool ms_can_defer_data_crc() const { return false; }
   /**
    * Perform a "fast dispatch" on a given message. See
    * ms_can_fast_dispatch() for the requirements.
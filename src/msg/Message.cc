@@ -6,6 +6,7 @@
 # include <cxxabi.h>
 #endif
 
+#include <atomic>
 #include <iostream>
 using namespace std;
 
@@ -193,6 +194,13 @@ using namespace std;
 
 #define dout_subsys ceph_subsys_ms
 
+// the per-op message types are allocated and freed constantly; carve
+// them out of per-shard slabs instead of hitting the heap every time
+MEMPOOL_DEFINE_SLAB_OBJECT_FACTORY(MOSDOp, mosd_op, msgr);
+MEMPOOL_DEFINE_SLAB_OBJECT_FACTORY(MOSDOpReply, mosd_opreply, msgr);
+MEMPOOL_DEFINE_SLAB_OBJECT_FACTORY(MOSDRepOp, mosd_repop, msgr);
+MEMPOOL_DEFINE_SLAB_OBJECT_FACTORY(MOSDRepOpReply, mosd_repopreply, msgr);
+
 void Message::encode(uint64_t features, int crcflags)
 {
   // encode and copy out of *m
@@ -273,6 +281,23 @@ void Message::dump(Formatter *f) const
   f->dump_string("summary", ss.str());
 }
 
+bool Message::verify_deferred_data_crc(CephContext *cct)
+{
+  if (!data_crc_deferred)
+    return true;
+  data_crc_deferred = false;
+  __u32 data_crc = data.crc32c(0);
+  if (data_crc != footer.data_crc) {
+    if (cct) {
+      ldout(cct, 0) << "bad crc in data " << data_crc << " != exp "
+		    << footer.data_crc << " (deferred check) in " << *this
+		    << dendl;
+    }
+    return false;
+  }
+  return true;
+}
+
 Message *decode_message(CephContext *cct, int crcflags,
 			ceph_msg_header& header,
 			ceph_msg_footer& footer,
@@ -303,17 +328,25 @@ Message *decode_message(CephContext *cct, int crcflags,
       return 0;
     }
   }
+  bool defer_data_crc = false;
   if (crcflags & MSG_CRC_DATA) {
     if ((footer.flags & CEPH_MSG_FOOTER_NOCRC) == 0) {
-      __u32 data_crc = data.crc32c(0);
-      if (data_crc != footer.data_crc) {
-	if (cct) {
-	  ldout(cct, 0) << "bad crc in data " << data_crc << " != exp " << footer.data_crc << dendl;
-	  ldout(cct, 20) << " ";
-	  data.hexdump(*_dout);
-	  *_dout << dendl;
+      if (cct && cct->_conf->ms_crc_data_deferred) {
+	// postpone the (potentially large) data crc to whoever
+	// dispatches or dequeues the message; see
+	// verify_deferred_data_crc()
+	defer_data_crc = true;
+      } else {
+	__u32 data_crc = data.crc32c(0);
+	if (data_crc != footer.data_crc) {
+	  if (cct) {
+	    ldout(cct, 0) << "bad crc in data " << data_crc << " != exp " << footer.data_crc << dendl;
+	    ldout(cct, 20) << " ";
+	    data.hexdump(*_dout);
+	    *_dout << dendl;
+	  }
+	  return 0;
 	}
-	return 0;
       }
     }
   }
@@ -823,6 +856,7 @@ Message *decode_message(CephContext *cct, int crcflags,
   m->set_payload(front);
   m->set_middle(middle);
   m->set_data(data);
+  m->set_data_crc_deferred(defer_data_crc);
 
   try {
     m->decode_payload();
@@ -856,6 +890,19 @@ void Message::encode_trace(bufferlist &bl, uint64_t features) const
   ::encode(*p, bl);
 }
 
+#ifdef WITH_BLKIN
+// 1-in-N sampling for traces we initiate ourselves; a single
+// process-wide counter is enough since this only needs to catch a
+// representative slice of traffic, not attribute it.
+static bool trace_sample(uint64_t every_n)
+{
+  if (!every_n)
+    return false;
+  static std::atomic<uint64_t> count(0);
+  return (++count % every_n) == 0;
+}
+#endif
+
 void Message::decode_trace(bufferlist::iterator &p, bool create)
 {
   blkin_trace_info info = {};
@@ -871,7 +918,9 @@ void Message::decode_trace(bufferlist::iterator &p, bool create)
     trace.init(get_type_name(), endpoint, &info, true);
     trace.event("decoded trace");
   } else if (create || (msgr->get_myname().is_osd() &&
-                        msgr->cct->_conf->osd_blkin_trace_all)) {
+                        (msgr->cct->_conf->osd_blkin_trace_all ||
+                         trace_sample(
+                           msgr->cct->_conf->osd_blkin_trace_every_n)))) {
     // create a trace even if we didn't get one on the wire
     trace.init(get_type_name(), endpoint);
     trace.event("created trace");
@@ -279,6 +279,10 @@ protected:
   // currently throttled.
   uint64_t dispatch_throttle_size = 0;
 
+  // true if the data crc check was postponed off the msgr thread; see
+  // verify_deferred_data_crc()
+  bool data_crc_deferred = false;
+
   friend class Messenger;
 
 public:
@@ -325,6 +329,10 @@ public:
   void set_dispatch_throttle_size(uint64_t s) { dispatch_throttle_size = s; }
   uint64_t get_dispatch_throttle_size() const { return dispatch_throttle_size; }
 
+  void set_data_crc_deferred(bool b) { data_crc_deferred = b; }
+  bool has_deferred_data_crc() const { return data_crc_deferred; }
+  bool verify_deferred_data_crc(CephContext *cct);
+
   const ceph_msg_header &get_header() const { return header; }
   ceph_msg_header &get_header() { return header; }
   void set_header(const ceph_msg_header &e) { header = e; }
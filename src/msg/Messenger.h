@@ -572,6 +572,22 @@ public:
     return false;
   }
 
+  /**
+   * Check whether the Dispatcher that will fast dispatch this message
+   * takes responsibility for the deferred data crc check.
+   *
+   * @param m The Message we are testing.
+   */
+  bool ms_can_defer_data_crc(const Message *m) {
+    for (list<Dispatcher*>::iterator p = fast_dispatchers.begin();
+	 p != fast_dispatchers.end();
+	 ++p) {
+      if ((*p)->ms_can_fast_dispatch(m))
+	return (*p)->ms_can_defer_data_crc();
+    }
+    return false;
+  }
+
   /**
    * Deliver a single Message via "fast dispatch".
    *
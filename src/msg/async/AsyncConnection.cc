@@ -141,6 +141,8 @@ AsyncConnection::AsyncConnection(CephContext *cct, AsyncMessenger *m, DispatchQu
   // double recv_max_prefetch see "read_until"
   recv_buf = new char[2*recv_max_prefetch];
   state_buffer = new char[4096];
+  if (cct->_conf->ms_compress_on_wire)
+    compressor = Compressor::create(cct, cct->_conf->ms_compress_type);
   logger->inc(l_msgr_created_connections);
 }
 
@@ -618,6 +620,14 @@ void AsyncConnection::process()
               if (data_buf.length() < data_len)
                 data_buf.push_back(buffer::create(data_len - data_buf.length()));
               data_blp = data_buf.begin();
+            } else if ((data_off & ~CEPH_PAGE_MASK) == 0) {
+              // aligned payload: read into a recycled worker buffer and
+              // hand it to the message as-is
+              ldout(async_msgr->cct,20) << __func__ << " using worker rx buffer"
+                                  << " len " << data_len << dendl;
+              data_buf.clear();
+              data_buf.push_back(worker->get_rx_buffer(data_len));
+              data_blp = data_buf.begin();
             } else {
               ldout(async_msgr->cct,20) << __func__ << " allocating new rx buffer at offset " << data_off << dendl;
               alloc_aligned_buffer(data_buf, data_len, data_off);
@@ -690,6 +700,39 @@ void AsyncConnection::process()
             goto fail;
           }
 
+          if (footer.flags & CEPH_MSG_FOOTER_COMPRESSED) {
+            // the data crc covers the compressed bytes; verify here and
+            // tell decode_message not to re-check the expanded payload
+            if ((async_msgr->crcflags & MSG_CRC_DATA) &&
+                (footer.flags & CEPH_MSG_FOOTER_NOCRC) == 0 &&
+                data.crc32c(0) != footer.data_crc) {
+              ldout(async_msgr->cct, 0) << __func__ << " bad crc in compressed data" << dendl;
+              goto fail;
+            }
+            __u8 alg;
+            bufferlist z, raw;
+            try {
+              bufferlist::iterator p = data.begin();
+              ::decode(alg, p);
+              ::decode(z, p);
+            } catch (const buffer::error &e) {
+              ldout(async_msgr->cct, 0) << __func__ << " corrupt compressed payload" << dendl;
+              goto fail;
+            }
+            if (!rx_compressor || rx_compressor->get_type() != alg)
+              rx_compressor = Compressor::create(async_msgr->cct, alg);
+            if (!rx_compressor || rx_compressor->decompress(z, raw) < 0) {
+              ldout(async_msgr->cct, 0) << __func__ << " failed to decompress payload alg "
+                                  << (int)alg << dendl;
+              goto fail;
+            }
+            logger->inc(l_msgr_compress_recv_bytes, data.length());
+            data.claim(raw);
+            footer.flags = ((unsigned)footer.flags &
+                            ~CEPH_MSG_FOOTER_COMPRESSED) |
+              CEPH_MSG_FOOTER_NOCRC;
+          }
+
           ldout(async_msgr->cct, 20) << __func__ << " got " << front.length() << " + " << middle.length()
                               << " + " << data.length() << " byte message" << dendl;
           Message *message = decode_message(async_msgr->cct, async_msgr->crcflags, current_header, footer,
@@ -2215,15 +2258,54 @@ ssize_t AsyncConnection::write_message(Message *m, bufferlist& bl, bool more)
     }
   }
   
+  // optionally compress the data payload.  the adjusted length and crc
+  // go into local header/footer copies so the Message itself (and any
+  // resend of it) is untouched.  signed sessions are skipped because
+  // the signature already covers the original crcs.
+  bool compressed = false;
+  bufferlist compressed_payload;
+  ceph_msg_header comp_header;
+  ceph_msg_footer comp_footer;
+  if (compressor && session_security.get() == NULL &&
+      header.data_len >= async_msgr->cct->_conf->ms_compress_min_size) {
+    unsigned data_start = header.front_len + header.middle_len;
+    bufferlist dbl, z;
+    dbl.substr_of(bl, data_start, bl.length() - data_start);
+    if (compressor->compress(dbl, z) == 0) {
+      ::encode((__u8)compressor->get_type(), compressed_payload);
+      ::encode(z, compressed_payload);
+      if (compressed_payload.length() < dbl.length()) {
+	comp_header = header;
+	comp_header.data_len = compressed_payload.length();
+	if (msgr->crcflags & MSG_CRC_HEADER)
+	  comp_header.crc = ceph_crc32c(0, (unsigned char*)&comp_header,
+					sizeof(comp_header) -
+					sizeof(comp_header.crc));
+	comp_footer = footer;
+	comp_footer.flags = (unsigned)comp_footer.flags |
+	  CEPH_MSG_FOOTER_COMPRESSED;
+	if (msgr->crcflags & MSG_CRC_DATA)
+	  comp_footer.data_crc = compressed_payload.crc32c(0);
+	logger->inc(l_msgr_compress_sent_raw_bytes, dbl.length());
+	logger->inc(l_msgr_compress_sent_bytes, compressed_payload.length());
+	compressed = true;
+      } else {
+	compressed_payload.clear();
+      }
+    }
+  }
+  ceph_msg_header& wire_header = compressed ? comp_header : header;
+  ceph_msg_footer& wire_footer = compressed ? comp_footer : footer;
+
   unsigned original_bl_len = outcoming_bl.length();
 
   outcoming_bl.append(CEPH_MSGR_TAG_MSG);
 
   if (has_feature(CEPH_FEATURE_NOSRCADDR)) {
-    outcoming_bl.append((char*)&header, sizeof(header));
+    outcoming_bl.append((char*)&wire_header, sizeof(wire_header));
   } else {
     ceph_msg_header_old oldheader;
-    memcpy(&oldheader, &header, sizeof(header));
+    memcpy(&oldheader, &wire_header, sizeof(wire_header));
     oldheader.src.name = header.src;
     oldheader.src.addr = get_peer_addr();
     oldheader.orig_src = oldheader.src;
@@ -2239,29 +2321,34 @@ ssize_t AsyncConnection::write_message(Message *m, bufferlist& bl, bool more)
                              << " data=" << header.data_len
                              << " off " << header.data_off << dendl;
 
-  if ((bl.length() <= ASYNC_COALESCE_THRESHOLD) && (bl.buffers().size() > 1)) {
+  if (compressed) {
+    bufferlist hbl;
+    hbl.substr_of(bl, 0, header.front_len + header.middle_len);
+    outcoming_bl.claim_append(hbl);
+    outcoming_bl.claim_append(compressed_payload);
+  } else if ((bl.length() <= ASYNC_COALESCE_THRESHOLD) && (bl.buffers().size() > 1)) {
     std::list<buffer::ptr>::const_iterator pb;
     for (pb = bl.buffers().begin(); pb != bl.buffers().end(); ++pb) {
       outcoming_bl.append((char*)pb->c_str(), pb->length());
     }
   } else {
-    outcoming_bl.claim_append(bl);  
+    outcoming_bl.claim_append(bl);
   }
 
   // send footer; if receiver doesn't support signatures, use the old footer format
   ceph_msg_footer_old old_footer;
   if (has_feature(CEPH_FEATURE_MSG_AUTH)) {
-    outcoming_bl.append((char*)&footer, sizeof(footer));
+    outcoming_bl.append((char*)&wire_footer, sizeof(wire_footer));
   } else {
     if (msgr->crcflags & MSG_CRC_HEADER) {
-      old_footer.front_crc = footer.front_crc;
-      old_footer.middle_crc = footer.middle_crc;
-      old_footer.data_crc = footer.data_crc;
+      old_footer.front_crc = wire_footer.front_crc;
+      old_footer.middle_crc = wire_footer.middle_crc;
+      old_footer.data_crc = wire_footer.data_crc;
     } else {
        old_footer.front_crc = old_footer.middle_crc = 0;
     }
-    old_footer.data_crc = msgr->crcflags & MSG_CRC_DATA ? footer.data_crc : 0;
-    old_footer.flags = footer.flags;
+    old_footer.data_crc = msgr->crcflags & MSG_CRC_DATA ? wire_footer.data_crc : 0;
+    old_footer.flags = wire_footer.flags;
     outcoming_bl.append((char*)&old_footer, sizeof(old_footer));
   }
 
@@ -2269,7 +2356,16 @@ ssize_t AsyncConnection::write_message(Message *m, bufferlist& bl, bool more)
   logger->inc(l_msgr_send_bytes, outcoming_bl.length() - original_bl_len);
   ldout(async_msgr->cct, 20) << __func__ << " sending " << m->get_seq()
                              << " " << m << dendl;
-  ssize_t rc = _try_send(more);
+  ssize_t rc;
+  uint64_t batch = async_msgr->cct->_conf->ms_async_send_batch_size;
+  if (more && batch && outcoming_bl.length() < batch) {
+    // more messages are queued and not much is pending yet: skip the
+    // syscall and let the next write_message (or the flush at the tail
+    // of handle_write) push the accumulated bytes in one sendmsg
+    rc = 0;
+  } else {
+    rc = _try_send(more);
+  }
   if (rc < 0) {
     ldout(async_msgr->cct, 1) << __func__ << " error sending " << m << ", "
                               << cpp_strerror(rc) << dendl;
@@ -28,6 +28,7 @@ using namespace std;
 
 #include "auth/AuthSessionHandler.h"
 #include "common/ceph_time.h"
+#include "compressor/Compressor.h"
 #include "common/perf_counters.h"
 #include "include/buffer.h"
 #include "msg/Connection.h"
@@ -372,6 +373,8 @@ class AsyncConnection : public Connection {
   Worker *worker;
   EventCenter *center;
   ceph::shared_ptr<AuthSessionHandler> session_security;
+  CompressorRef compressor;     ///< compresses outgoing data payloads
+  CompressorRef rx_compressor;  ///< matches the peer's algorithm
 
  public:
   // used by eventcallback
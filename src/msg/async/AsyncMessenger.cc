@@ -28,6 +28,7 @@
 #include "messages/MOSDOp.h"
 #include "messages/MOSDOpReply.h"
 #include "common/EventTrace.h"
+#include "include/ceph_hash.h"
 
 #define dout_subsys ceph_subsys_ms
 #undef dout_prefix
@@ -179,6 +180,18 @@ void Processor::accept()
     if (r == 0) {
       ldout(msgr->cct, 10) << __func__ << " accepted incoming on sd " << cli_socket.fd() << dendl;
 
+      if (msgr->cct->_conf->ms_async_steer_connections &&
+	  !msgr->get_stack()->support_local_listen_table()) {
+	// rebind the connection to the worker this flow hashes to, so that
+	// a peer's rx queue, msgr worker and (with ms_async_affinity_cores)
+	// op shard can share a core.  dpdk keeps per-worker listen tables
+	// and is already steered by the nic.
+	Worker *steered = msgr->get_stack()->get_worker_by_hash(
+	    ceph_str_hash_linux((const char*)addr.get_sockaddr(),
+				addr.get_sockaddr_len()));
+	w->release_worker();
+	w = steered;
+      }
       msgr->add_accept(w, std::move(cli_socket), addr);
       continue;
     } else {
@@ -522,7 +535,13 @@ AsyncConnectionRef AsyncMessenger::create_connect(const entity_addr_t& addr, int
       << ", creating connection and registering" << dendl;
 
   // create connection
-  Worker *w = stack->get_worker();
+  Worker *w;
+  if (cct->_conf->ms_async_steer_connections)
+    w = stack->get_worker_by_hash(
+	ceph_str_hash_linux((const char*)addr.get_sockaddr(),
+			    addr.get_sockaddr_len()));
+  else
+    w = stack->get_worker();
   AsyncConnectionRef conn = new AsyncConnection(cct, this, &dispatch_queue, w);
   conn->connect(addr, type);
   assert(!conns.count(addr));
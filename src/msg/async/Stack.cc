@@ -40,6 +40,7 @@ std::function<void ()> NetworkStack::add_thread(unsigned i)
       sprintf(tp_name, "msgr-worker-%d", w->id);
       ceph_pthread_setname(pthread_self(), tp_name);
       const uint64_t EventMaxWaitUs = 30000000;
+      const uint64_t busy_poll_us = cct->_conf->ms_async_busy_poll_us;
       w->center.set_owner();
       ldout(cct, 10) << __func__ << " starting" << dendl;
       w->initialize();
@@ -55,6 +56,22 @@ std::function<void ()> NetworkStack::add_thread(unsigned i)
           // TODO do something?
         }
         w->perf_logger->tinc(l_msgr_running_total_time, dur);
+        if (busy_poll_us) {
+          // hybrid polling: keep spinning with a zero timeout for a
+          // while before blocking again, extending the window whenever
+          // something fires.  this trades a busy core for the wakeup
+          // latency of going back to sleep between back-to-back events.
+          auto poll_end = ceph::mono_clock::now() +
+            std::chrono::microseconds(busy_poll_us);
+          while (!w->done && ceph::mono_clock::now() < poll_end) {
+            ceph::timespan d;
+            if (w->center.process_events(0, &d) > 0) {
+              w->perf_logger->tinc(l_msgr_running_total_time, d);
+              poll_end = ceph::mono_clock::now() +
+                std::chrono::microseconds(busy_poll_us);
+            }
+          }
+        }
       }
       w->reset();
       w->destroy();
@@ -193,6 +193,9 @@ enum {
   l_msgr_send_bytes,
   l_msgr_created_connections,
   l_msgr_active_connections,
+  l_msgr_compress_sent_bytes,
+  l_msgr_compress_sent_raw_bytes,
+  l_msgr_compress_recv_bytes,
 
   l_msgr_running_total_time,
   l_msgr_running_send_time,
@@ -217,6 +220,9 @@ class Worker {
   std::atomic_uint references;
   EventCenter center;
 
+  /// recycling pool of page-aligned rx payload buffers, see get_rx_buffer()
+  std::vector<bufferptr> rx_buffer_pool;
+
   Worker(const Worker&) = delete;
   Worker& operator=(const Worker&) = delete;
 
@@ -233,6 +239,9 @@ class Worker {
     plb.add_u64_counter(l_msgr_send_bytes, "msgr_send_bytes", "Network received bytes");
     plb.add_u64_counter(l_msgr_active_connections, "msgr_active_connections", "Active connection number");
     plb.add_u64_counter(l_msgr_created_connections, "msgr_created_connections", "Created connection number");
+    plb.add_u64_counter(l_msgr_compress_sent_bytes, "msgr_compress_sent_bytes", "Compressed payload bytes sent");
+    plb.add_u64_counter(l_msgr_compress_sent_raw_bytes, "msgr_compress_sent_raw_bytes", "Original size of compressed payloads sent");
+    plb.add_u64_counter(l_msgr_compress_recv_bytes, "msgr_compress_recv_bytes", "Compressed payload bytes received");
 
     plb.add_time(l_msgr_running_total_time, "msgr_running_total_time", "The total time of thread running");
     plb.add_time(l_msgr_running_send_time, "msgr_running_send_time", "The total time of message sending");
@@ -257,6 +266,23 @@ class Worker {
 
   virtual void initialize() {}
   PerfCounters *get_perf_counter() { return perf_logger; }
+  bufferptr get_rx_buffer(unsigned len) {
+    // a pooled buffer is handed off to the Message on dispatch; once
+    // the message is freed we hold the only remaining reference and
+    // the buffer can be handed out again, sparing an allocation (and
+    // for stacks with registered memory, a re-registration) per
+    // message.  only called from this worker's event thread.
+    for (auto& p : rx_buffer_pool) {
+      if (p.raw_nref() == 1 && p.raw_length() >= len)
+	return bufferptr(p, 0, len);
+    }
+    bufferptr p = buffer::create_page_aligned(
+      MAX(len, (unsigned)cct->_conf->ms_async_rx_buffer_size));
+    if (rx_buffer_pool.size() <
+	(size_t)cct->_conf->ms_async_rx_buffer_pool_size)
+      rx_buffer_pool.push_back(p);
+    return bufferptr(p, 0, len);
+  }
   void release_worker() {
     int oldref = references.fetch_sub(1);
     assert(oldref > 0);
@@ -328,6 +354,16 @@ class NetworkStack : public CephContext::ForkWatcher {
   Worker *get_worker(unsigned i) {
     return workers[i];
   }
+  // deterministic flow->worker mapping. Unlike get_worker() the choice
+  // doesn't depend on current load, so a given peer always lands on the
+  // same worker and can be aligned with NIC RSS queue/core steering
+  // (see ms_async_steer_connections).
+  Worker *get_worker_by_hash(uint64_t h) {
+    Spinlock::Locker l(pool_spin);
+    Worker *w = workers[h % num_workers];
+    ++w->references;
+    return w;
+  }
   void drain();
   unsigned get_num_worker() const {
     return num_workers;
@@ -758,7 +758,8 @@ void Infiniband::init()
   srq = create_shared_receive_queue(max_recv_wr, MAX_SHARED_RX_SGE_COUNT);
   post_channel_cluster();
 
-  dispatcher->polling_start();
+  for (auto &&d : dispatchers)
+    d->polling_start();
 }
 
 Infiniband::~Infiniband()
@@ -766,19 +767,18 @@ Infiniband::~Infiniband()
   if (!initialized)
     return;
 
-  if (dispatcher)
-    dispatcher->polling_stop();
+  for (auto &&d : dispatchers)
+    d->polling_stop();
 
   ibv_destroy_srq(srq);
   delete memory_manager;
   delete pd;
 }
 
-void Infiniband::set_dispatcher(RDMADispatcher *d)
+void Infiniband::add_dispatcher(RDMADispatcher *d)
 {
-  assert(!d ^ !dispatcher);
-
-  dispatcher = d;
+  assert(d);
+  dispatchers.push_back(d);
 }
 
 /**
@@ -226,7 +226,7 @@ class Infiniband {
   Device *device;
   ProtectionDomain *pd;
   DeviceList *device_list = nullptr;
-  RDMADispatcher *dispatcher = nullptr;
+  std::vector<RDMADispatcher*> dispatchers;
   void wire_gid_to_gid(const char *wgid, union ibv_gid *gid);
   void gid_to_wire_gid(const union ibv_gid *gid, char wgid[]);
   CephContext *cct;
@@ -240,7 +240,7 @@ class Infiniband {
   ~Infiniband();
   void init();
 
-  void set_dispatcher(RDMADispatcher *d);
+  void add_dispatcher(RDMADispatcher *d);
 
   class CompletionChannel {
     static const uint32_t MAX_ACK_EVENT = 5000;
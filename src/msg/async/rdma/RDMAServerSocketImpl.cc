@@ -104,7 +104,10 @@ int RDMAServerSocketImpl::accept(ConnectedSocket *sock, const SocketOptions &opt
 
   RDMAConnectedSocketImpl* server;
   //Worker* w = dispatcher->get_stack()->get_worker();
-  server = new RDMAConnectedSocketImpl(cct, infiniband, dispatcher, dynamic_cast<RDMAWorker*>(w));
+  // route the accepted qp to the accepting worker's own dispatcher so
+  // its completions are polled by that shard
+  RDMAWorker *rw = dynamic_cast<RDMAWorker*>(w);
+  server = new RDMAConnectedSocketImpl(cct, infiniband, rw->get_dispatcher(), rw);
   server->set_accept_fd(sd);
   ldout(cct, 20) << __func__ << " accepted a new QP, tcp_fd: " << sd << dendl;
   std::unique_ptr<RDMAConnectedSocketImpl> csi(server);
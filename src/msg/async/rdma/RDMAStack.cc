@@ -47,8 +47,6 @@ RDMADispatcher::~RDMADispatcher()
   delete tx_cc;
   delete rx_cc;
   delete async_handler;
-
-  global_infiniband->set_dispatcher(nullptr);
 }
 
 RDMADispatcher::RDMADispatcher(CephContext* c, RDMAStack* s)
@@ -431,7 +429,7 @@ RDMAWorker::~RDMAWorker()
 void RDMAWorker::initialize()
 {
   if (!dispatcher) {
-    dispatcher = stack->get_dispatcher();
+    dispatcher = stack->get_dispatcher(id);
   }
 }
 
@@ -439,7 +437,7 @@ int RDMAWorker::listen(entity_addr_t &sa, const SocketOptions &opt,ServerSocket
 {
   global_infiniband->init();
 
-  auto p = new RDMAServerSocketImpl(cct, global_infiniband.get(), get_stack()->get_dispatcher(), this, sa);
+  auto p = new RDMAServerSocketImpl(cct, global_infiniband.get(), get_stack()->get_dispatcher(id), this, sa);
   int r = p->listen(sa, opt);
   if (r < 0) {
     delete p;
@@ -454,7 +452,7 @@ int RDMAWorker::connect(const entity_addr_t &addr, const SocketOptions &opts, Co
 {
   global_infiniband->init();
 
-  RDMAConnectedSocketImpl* p = new RDMAConnectedSocketImpl(cct, global_infiniband.get(), get_stack()->get_dispatcher(), this);
+  RDMAConnectedSocketImpl* p = new RDMAConnectedSocketImpl(cct, global_infiniband.get(), get_stack()->get_dispatcher(id), this);
   int r = p->try_connect(addr, opts);
 
   if (r < 0) {
@@ -474,7 +472,7 @@ int RDMAWorker::get_reged_mem(RDMAConnectedSocketImpl *o, std::vector<Chunk*> &c
   assert(r >= 0);
   size_t got = global_infiniband->get_memory_manager()->get_tx_buffer_size() * r;
   ldout(cct, 30) << __func__ << " need " << bytes << " bytes, reserve " << got << " registered  bytes, inflight " << dispatcher->inflight << dendl;
-  stack->get_dispatcher()->inflight += r;
+  dispatcher->inflight += r;
   if (got >= bytes)
     return r;
 
@@ -546,8 +544,12 @@ RDMAStack::RDMAStack(CephContext *cct, const string &t): NetworkStack(cct, t)
     global_infiniband.construct(
       cct, cct->_conf->ms_async_rdma_device_name, cct->_conf->ms_async_rdma_port_num);
   ldout(cct, 20) << __func__ << " constructing RDMAStack..." << dendl;
-  dispatcher = new RDMADispatcher(cct, this);
-  global_infiniband->set_dispatcher(dispatcher);
+  unsigned num_dis = MAX(1u, cct->_conf->ms_async_rdma_dispatchers);
+  for (unsigned i = 0; i < num_dis; ++i) {
+    RDMADispatcher *d = new RDMADispatcher(cct, this);
+    global_infiniband->add_dispatcher(d);
+    dispatchers.push_back(d);
+  }
 
   unsigned num = get_num_worker();
   for (unsigned i = 0; i < num; ++i) {
@@ -555,7 +557,8 @@ RDMAStack::RDMAStack(CephContext *cct, const string &t): NetworkStack(cct, t)
     w->set_stack(this);
   }
 
-  ldout(cct, 20) << " creating RDMAStack:" << this << " with dispatcher:" << dispatcher << dendl;
+  ldout(cct, 20) << " creating RDMAStack:" << this << " with " << num_dis
+                 << " dispatchers" << dendl;
 }
 
 RDMAStack::~RDMAStack()
@@ -564,7 +567,8 @@ RDMAStack::~RDMAStack()
     unsetenv("RDMAV_HUGEPAGES_SAFE");	//remove env variable on destruction
   }
 
-  delete dispatcher;
+  for (auto &&d : dispatchers)
+    delete d;
 }
 
 void RDMAStack::spawn_worker(unsigned i, std::function<void ()> &&func)
@@ -193,6 +193,7 @@ class RDMAWorker : public Worker {
   virtual int connect(const entity_addr_t &addr, const SocketOptions &opts, ConnectedSocket *socket) override;
   virtual void initialize() override;
   RDMAStack *get_stack() { return stack; }
+  RDMADispatcher *get_dispatcher() { return dispatcher; }
   int get_reged_mem(RDMAConnectedSocketImpl *o, std::vector<Chunk*> &c, size_t bytes);
   void remove_pending_conn(RDMAConnectedSocketImpl *o) {
     assert(center.in_thread());
@@ -299,7 +300,9 @@ class RDMAServerSocketImpl : public ServerSocketImpl {
 
 class RDMAStack : public NetworkStack {
   vector<std::thread> threads;
-  RDMADispatcher *dispatcher;
+  // each dispatcher polls its own tx/rx cq pair on a dedicated thread;
+  // workers (and hence their qps) are sharded across the dispatchers
+  vector<RDMADispatcher*> dispatchers;
   PerfCounters *perf_counter;
 
   std::atomic<bool> fork_finished = {false};
@@ -312,7 +315,9 @@ class RDMAStack : public NetworkStack {
 
   virtual void spawn_worker(unsigned i, std::function<void ()> &&func) override;
   virtual void join_worker(unsigned i) override;
-  RDMADispatcher *get_dispatcher() { return dispatcher; }
+  RDMADispatcher *get_dispatcher(unsigned i) {
+    return dispatchers[i % dispatchers.size()];
+  }
 
   virtual bool is_ready() override { return fork_finished.load(); };
   virtual void ready() override { fork_finished = true; };
@@ -1531,6 +1531,9 @@ public:
 
   virtual void get_db_statistics(Formatter *f) { }
   virtual void generate_db_histogram(Formatter *f) { }
+  /// hint that a bulk ingest (e.g. PG import) is starting/finishing;
+  /// backends may defer kv compaction for the duration
+  virtual void set_bulk_load(bool enable) { }
   virtual void flush_cache() { }
   virtual void dump_perf_counters(Formatter *f) {}
 
@@ -1713,6 +1716,56 @@ public:
      return read(c->get_cid(), oid, offset, len, bl, op_flags);
    }
 
+  /**
+   * readv -- read multiple byte ranges of data from an object
+   *
+   * The extents are read in offset order and the results concatenated
+   * into a single bufferlist.  Extents must be sorted and
+   * non-overlapping (i.e. come from a prior fiemap); an extent that
+   * runs past the end of the object is trimmed in @m to what was
+   * actually read, and any extents beyond it are erased.
+   *
+   * An enlightened implementation resolves the object metadata once
+   * for all extents instead of once per read call.
+   *
+   * @param c collection for object
+   * @param oid oid of object
+   * @param m extents to read (offset -> length), trimmed on return
+   * @param bl output bufferlist
+   * @param op_flags is CEPH_OSD_OP_FLAG_*
+   * @returns total bytes read on success, or negative error code on failure.
+   */
+   virtual int readv(
+     CollectionHandle &c,
+     const ghobject_t& oid,
+     map<uint64_t, uint64_t>& m,
+     bufferlist& bl,
+     uint32_t op_flags = 0) {
+     int total = 0;
+     auto p = m.begin();
+     while (p != m.end()) {
+       bufferlist t;
+       int r = read(c, oid, p->first, p->second, t, op_flags);
+       if (r < 0)
+	 return r;
+       total += r;
+       bl.claim_append(t);
+       if (r < (int)p->second) {
+	 // reached the end of the object; trim this extent and drop the rest
+	 if (r == 0) {
+	   p = m.erase(p);
+	 } else {
+	   p->second = r;
+	   ++p;
+	 }
+	 m.erase(p, m.end());
+	 break;
+       }
+       ++p;
+     }
+     return total;
+   }
+
   /**
    * fiemap -- get extent map of data of an object
    *
@@ -1743,6 +1796,44 @@ public:
      return fiemap(c->get_cid(), oid, offset, len, destmap);
    }
 
+  /// stored data checksums for one logical extent, see get_csums()
+  struct csum_extent_t {
+    uint64_t offset = 0;          ///< logical offset this extent covers
+    uint64_t length = 0;          ///< logical length covered
+    int csum_type = 0;            ///< Checksummer::CSumType (CSUM_NONE if absent)
+    uint64_t csum_chunk_size = 0; ///< bytes covered by each checksum value
+    bufferlist csum_data;         ///< concatenated raw checksum values
+  };
+
+  /**
+   * get_csums -- get the store's internal data checksums for an object
+   *
+   * Returns the checksums the store keeps for the given logical range
+   * without reading any object data.  The chunking and algorithm
+   * reflect this store's physical layout, so the values are NOT
+   * comparable between replicas; they are useful for local inspection
+   * and debugging (e.g. via the objectstore tool).
+   *
+   * A store that keeps no data checksums returns -EOPNOTSUPP.
+   *
+   * @param cid collection for object
+   * @param oid oid of object
+   * @param offset location offset of first byte of interest
+   * @param len number of bytes of interest
+   * @param out populated with one entry per checksummed extent
+   * @returns 0 on success, negative error code on failure.
+   */
+  virtual int get_csums(const coll_t& cid, const ghobject_t& oid,
+			uint64_t offset, size_t len,
+			vector<csum_extent_t> *out) {
+    return -EOPNOTSUPP;
+  }
+  virtual int get_csums(CollectionHandle& c, const ghobject_t& oid,
+			uint64_t offset, size_t len,
+			vector<csum_extent_t> *out) {
+    return get_csums(c->get_cid(), oid, offset, len, out);
+  }
+
   /**
    * getattr -- get an xattr of an object
    *
@@ -1759,6 +1850,36 @@ public:
     return getattr(c->get_cid(), oid, name, value);
   }
 
+  /**
+   * getattr_batch -- get one named attr for many objects
+   *
+   * Objects that no longer exist are simply absent from the result;
+   * any other error aborts the batch.  Backends may override this to
+   * amortize per-call overhead across the batch.
+   *
+   * @param c collection for objects
+   * @param oids objects to query
+   * @param name name of attr to read
+   * @param out map of oid to attr value for the objects that exist
+   * @returns 0 on success, negative error code on failure.
+   */
+  virtual int getattr_batch(CollectionHandle &c,
+			    const vector<ghobject_t>& oids,
+			    const char *name,
+			    map<ghobject_t, bufferptr> *out) {
+    for (vector<ghobject_t>::const_iterator p = oids.begin();
+	 p != oids.end(); ++p) {
+      bufferptr bp;
+      int r = getattr(c, *p, name, bp);
+      if (r == -ENOENT)
+	continue;
+      if (r < 0)
+	return r;
+      (*out)[*p] = bp;
+    }
+    return 0;
+  }
+
   /**
    * getattr -- get an xattr of an object
    *
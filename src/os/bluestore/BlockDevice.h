@@ -27,6 +27,34 @@
 
 #define SPDK_PREFIX "spdk:"
 
+/*
+ * Write lifetime hints, used to steer writes with different expected
+ * lifetimes to different flash streams (multi-stream / open-channel
+ * style devices).  The values match the kernel's WRITE_LIFE_* rw
+ * hints so they can be handed to fcntl(F_SET_FILE_RW_HINT) directly;
+ * on platforms without rw hint support everything collapses to a
+ * single class.
+ */
+#if defined(__linux__)
+#ifndef WRITE_LIFE_NOT_SET
+#define WRITE_LIFE_NOT_SET	0	// no hint
+#define WRITE_LIFE_NONE		1	// explicitly no hint
+#define WRITE_LIFE_SHORT	2	// short lifetime
+#define WRITE_LIFE_MEDIUM	3	// medium lifetime
+#define WRITE_LIFE_LONG		4	// long lifetime
+#define WRITE_LIFE_EXTREME	5	// extremely long lifetime
+#endif
+#define WRITE_LIFE_MAX		6
+#else
+#define WRITE_LIFE_NOT_SET	0
+#define WRITE_LIFE_NONE		0
+#define WRITE_LIFE_SHORT	0
+#define WRITE_LIFE_MEDIUM	0
+#define WRITE_LIFE_LONG		0
+#define WRITE_LIFE_EXTREME	0
+#define WRITE_LIFE_MAX		1
+#endif
+
 /// track in-flight io
 struct IOContext {
 private:
@@ -121,7 +149,8 @@ public:
   virtual int write(
     uint64_t off,
     bufferlist& bl,
-    bool buffered) = 0;
+    bool buffered,
+    int write_hint = WRITE_LIFE_NOT_SET) = 0;
 
   virtual int aio_read(
     uint64_t off,
@@ -132,7 +161,8 @@ public:
     uint64_t off,
     bufferlist& bl,
     IOContext *ioc,
-    bool buffered) = 0;
+    bool buffered,
+    int write_hint = WRITE_LIFE_NOT_SET) = 0;
   virtual int flush() = 0;
 
   void queue_reap_ioc(IOContext *ioc);
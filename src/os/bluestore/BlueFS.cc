@@ -536,7 +536,8 @@ int BlueFS::_replay(bool noop)
   FileReader *log_reader = new FileReader(
     log_file, cct->_conf->bluefs_max_prefetch,
     false,  // !random
-    true);  // ignore eof
+    true,   // ignore eof
+    true);  // pipeline readahead of the next window while we decode
   while (true) {
     assert((log_reader->buf.pos & ~super.block_mask()) == 0);
     uint64_t pos = log_reader->buf.pos;
@@ -916,6 +917,46 @@ int BlueFS::_read_random(
   return ret;
 }
 
+void BlueFS::_start_readahead(FileReader *h, FileReaderBuffer *buf)
+{
+  if (buf->next_ioc) {
+    return;   // already in flight
+  }
+  uint64_t off = buf->get_buf_end();
+  uint64_t want = buf->max_prefetch;
+  uint64_t allocated = h->file->fnode.get_allocated();
+  if (off >= allocated) {
+    return;
+  }
+  want = MIN(want, allocated - off);
+  uint64_t x_off = 0;
+  auto p = h->file->fnode.seek(off, &x_off);
+  unsigned bdev_id = p->bdev;
+  buf->next_off = off;
+  buf->next_bl.clear();
+  buf->next_ioc = new IOContext(cct, nullptr);
+  // an IOContext is submitted to one device, so stop at a bdev change
+  while (want > 0 &&
+	 p != h->file->fnode.extents.end() &&
+	 p->bdev == bdev_id) {
+    uint64_t l = MIN(p->length - x_off, want);
+    bdev[bdev_id]->aio_read(p->offset + x_off, l, &buf->next_bl,
+			    buf->next_ioc);
+    want -= l;
+    ++p;
+    x_off = 0;
+  }
+  if (!buf->next_ioc->has_pending_aios()) {
+    delete buf->next_ioc;
+    buf->next_ioc = nullptr;
+    buf->next_bl.clear();
+    return;
+  }
+  dout(20) << __func__ << " 0x" << std::hex << buf->next_off
+	   << "~" << buf->next_bl.length() << std::dec << dendl;
+  bdev[bdev_id]->aio_submit(buf->next_ioc);
+}
+
 int BlueFS::_read(
   FileReader *h,         ///< [in] read from here
   FileReaderBuffer *buf, ///< [in] reader state
@@ -948,23 +989,44 @@ int BlueFS::_read(
     if (off < buf->bl_off || off >= buf->get_buf_end()) {
       buf->bl.clear();
       buf->bl_off = off & super.block_mask();
-      uint64_t x_off = 0;
-      auto p = h->file->fnode.seek(buf->bl_off, &x_off);
-      uint64_t want = ROUND_UP_TO(len + (off & ~super.block_mask()),
-				  super.block_size);
-      want = MAX(want, buf->max_prefetch);
-      uint64_t l = MIN(p->length - x_off, want);
-      uint64_t eof_offset = ROUND_UP_TO(h->file->fnode.size, super.block_size);
-      if (!h->ignore_eof &&
-	  buf->bl_off + l > eof_offset) {
-	l = eof_offset - buf->bl_off;
+      if (buf->next_ioc && buf->next_off == buf->bl_off) {
+	// readahead hit: the window we want is already in flight
+	dout(20) << __func__ << " readahead hit 0x" << std::hex
+		 << buf->next_off << "~" << buf->next_bl.length()
+		 << std::dec << dendl;
+	buf->next_ioc->aio_wait();
+	delete buf->next_ioc;
+	buf->next_ioc = nullptr;
+	buf->bl.claim(buf->next_bl);
+      } else {
+	if (buf->next_ioc) {
+	  // seek invalidated the readahead; drain it before reusing
+	  buf->next_ioc->aio_wait();
+	  delete buf->next_ioc;
+	  buf->next_ioc = nullptr;
+	  buf->next_bl.clear();
+	}
+	uint64_t x_off = 0;
+	auto p = h->file->fnode.seek(buf->bl_off, &x_off);
+	uint64_t want = ROUND_UP_TO(len + (off & ~super.block_mask()),
+				    super.block_size);
+	want = MAX(want, buf->max_prefetch);
+	uint64_t l = MIN(p->length - x_off, want);
+	uint64_t eof_offset = ROUND_UP_TO(h->file->fnode.size, super.block_size);
+	if (!h->ignore_eof &&
+	    buf->bl_off + l > eof_offset) {
+	  l = eof_offset - buf->bl_off;
+	}
+	dout(20) << __func__ << " fetching 0x"
+		 << std::hex << x_off << "~" << l << std::dec
+		 << " of " << *p << dendl;
+	int r = bdev[p->bdev]->read(p->offset + x_off, l, &buf->bl, ioc[p->bdev],
+				    cct->_conf->bluefs_buffered_io);
+	assert(r == 0);
+      }
+      if (h->readahead) {
+	_start_readahead(h, buf);
       }
-      dout(20) << __func__ << " fetching 0x"
-               << std::hex << x_off << "~" << l << std::dec
-               << " of " << *p << dendl;
-      int r = bdev[p->bdev]->read(p->offset + x_off, l, &buf->bl, ioc[p->bdev],
-				  cct->_conf->bluefs_buffered_io);
-      assert(r == 0);
     }
     left = buf->get_buf_remaining(off);
     dout(20) << __func__ << " left 0x" << std::hex << left
@@ -1605,6 +1667,17 @@ int BlueFS::_flush_range(FileWriter *h, uint64_t offset, uint64_t length)
   h->pos = offset + length;
   h->tail_block.clear();
 
+  // steer the bluefs log and rocksdb wal to a short-lifetime flash
+  // stream; ssts are overwritten far less often.
+  int write_hint;
+  if (h->writer_type == WRITER_WAL || h->file->fnode.ino == 1) {
+    write_hint = WRITE_LIFE_SHORT;
+  } else if (h->writer_type == WRITER_SST) {
+    write_hint = WRITE_LIFE_MEDIUM;
+  } else {
+    write_hint = WRITE_LIFE_NOT_SET;
+  }
+
   uint64_t bloff = 0;
   while (length > 0) {
     uint64_t x_len = MIN(p->length - x_off, length);
@@ -1636,9 +1709,10 @@ int BlueFS::_flush_range(FileWriter *h, uint64_t offset, uint64_t length)
       }
     }
     if (cct->_conf->bluefs_sync_write) {
-      bdev[p->bdev]->write(p->offset + x_off, t, buffered);
+      bdev[p->bdev]->write(p->offset + x_off, t, buffered, write_hint);
     } else {
-      bdev[p->bdev]->aio_write(p->offset + x_off, t, h->iocv[p->bdev], buffered);
+      bdev[p->bdev]->aio_write(p->offset + x_off, t, h->iocv[p->bdev], buffered,
+			       write_hint);
     }
     bloff += x_len;
     length -= x_len;
@@ -166,10 +166,22 @@ public:
     uint64_t pos;           ///< current logical offset
     uint64_t max_prefetch;  ///< max allowed prefetch
 
+    /// in-flight readahead of the next window, for sequential readers
+    /// that opt in (log replay)
+    uint64_t next_off = 0;  ///< logical offset of readahead window
+    bufferlist next_bl;     ///< readahead landing buffer
+    IOContext *next_ioc = nullptr;
+
     explicit FileReaderBuffer(uint64_t mpf)
       : bl_off(0),
 	pos(0),
 	max_prefetch(mpf) {}
+    ~FileReaderBuffer() {
+      if (next_ioc) {
+	next_ioc->aio_wait();
+	delete next_ioc;
+      }
+    }
 
     uint64_t get_buf_end() {
       return bl_off + bl.length();
@@ -195,12 +207,14 @@ public:
     FileReaderBuffer buf;
     bool random;
     bool ignore_eof;        ///< used when reading our log file
+    bool readahead;         ///< pipeline reads of the next window
 
-    FileReader(FileRef f, uint64_t mpf, bool rand, bool ie)
+    FileReader(FileRef f, uint64_t mpf, bool rand, bool ie, bool ra=false)
       : file(f),
 	buf(mpf),
 	random(rand),
-	ignore_eof(ie) {
+	ignore_eof(ie),
+	readahead(ra) {
       ++file->num_readers;
     }
     ~FileReader() {
@@ -269,6 +283,7 @@ private:
 
   int _allocate(uint8_t bdev, uint64_t len,
 		mempool::bluefs::vector<bluefs_extent_t> *ev);
+  void _start_readahead(FileReader *h, FileReaderBuffer *buf);
   int _flush_range(FileWriter *h, uint64_t offset, uint64_t length);
   int _flush(FileWriter *h, bool force);
   int _fsync(FileWriter *h, std::unique_lock<std::mutex>& l);
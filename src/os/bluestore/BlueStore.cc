@@ -15,8 +15,11 @@
 #include <stdlib.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 
+#include <thread>
+
 #include "include/cpp-btree/btree_set.h"
 
 #include "BlueStore.h"
@@ -32,6 +35,7 @@
 #include "BlueRocksEnv.h"
 #include "auth/Crypto.h"
 #include "common/EventTrace.h"
+#include "common/deleter.h"
 
 #define dout_context cct
 #define dout_subsys ceph_subsys_bluestore
@@ -39,16 +43,16 @@
 using bid_t = decltype(BlueStore::Blob::id);
 
 // bluestore_cache_onode
-MEMPOOL_DEFINE_OBJECT_FACTORY(BlueStore::Onode, bluestore_onode,
-			      bluestore_cache_onode);
+MEMPOOL_DEFINE_SLAB_OBJECT_FACTORY(BlueStore::Onode, bluestore_onode,
+				   bluestore_cache_onode);
 
 // bluestore_cache_other
 MEMPOOL_DEFINE_OBJECT_FACTORY(BlueStore::Buffer, bluestore_buffer,
 			      bluestore_cache_other);
-MEMPOOL_DEFINE_OBJECT_FACTORY(BlueStore::Extent, bluestore_extent,
-			      bluestore_cache_other);
-MEMPOOL_DEFINE_OBJECT_FACTORY(BlueStore::Blob, bluestore_blob,
-			      bluestore_cache_other);
+MEMPOOL_DEFINE_SLAB_OBJECT_FACTORY(BlueStore::Extent, bluestore_extent,
+				   bluestore_cache_other);
+MEMPOOL_DEFINE_SLAB_OBJECT_FACTORY(BlueStore::Blob, bluestore_blob,
+				   bluestore_cache_other);
 MEMPOOL_DEFINE_OBJECT_FACTORY(BlueStore::SharedBlob, bluestore_shared_blob,
 			      bluestore_cache_other);
 
@@ -56,6 +60,72 @@ MEMPOOL_DEFINE_OBJECT_FACTORY(BlueStore::SharedBlob, bluestore_shared_blob,
 MEMPOOL_DEFINE_OBJECT_FACTORY(BlueStore::TransContext, bluestore_transcontext,
 			      bluestore_txc);
 
+/*
+ * Optional hugepage-backed slab pool for buffer cache payloads
+ * (bluestore_cache_hugepage_buffers).  Read results being admitted to
+ * the buffer cache are copied into 64K chunks carved out of 2M slabs
+ * mapped with MADV_HUGEPAGE, so the long-lived cache copy sits on
+ * hugepages and repeated hits on a warm cache stop chewing through
+ * dTLB entries; the bufferlist handed back to the reader is untouched.
+ * Slabs are never unmapped and chunks recycle through a freelist from
+ * the bufferptr deleter, so a cached buffer may safely outlive the
+ * store instance that created it.  The copies are accounted in the
+ * bluestore_cache_data mempool by the cache like any other payload.
+ */
+class HugePageBufferPool {
+  static const size_t slab_size = 2 * 1024 * 1024;
+  static const size_t chunk_size = 64 * 1024;
+  std::mutex lock;
+  std::vector<char*> free_chunks;
+  bool slab_alloc_failed = false;
+
+  bool _refill() {
+    char *slab = (char*)::mmap(nullptr, slab_size, PROT_READ | PROT_WRITE,
+			       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (slab == MAP_FAILED) {
+      slab_alloc_failed = true;
+      return false;
+    }
+#ifdef MADV_HUGEPAGE
+    // advisory; if the kernel declines the slab is still usable
+    ::madvise(slab, slab_size, MADV_HUGEPAGE);
+#endif
+    for (size_t off = 0; off < slab_size; off += chunk_size) {
+      free_chunks.push_back(slab + off);
+    }
+    return true;
+  }
+  void _release(char *chunk) {
+    std::lock_guard<std::mutex> l(lock);
+    free_chunks.push_back(chunk);
+  }
+
+public:
+  /// replace bl's content with a copy in a pooled hugepage chunk;
+  /// leaves bl alone if it doesn't fit or no slab could be mapped
+  void try_copy(bufferlist *bl) {
+    unsigned len = bl->length();
+    if (len == 0 || len > chunk_size)
+      return;
+    char *chunk;
+    {
+      std::lock_guard<std::mutex> l(lock);
+      if (free_chunks.empty() && (slab_alloc_failed || !_refill()))
+	return;
+      chunk = free_chunks.back();
+      free_chunks.pop_back();
+    }
+    bl->copy(0, len, chunk);
+    bufferlist newbl;
+    newbl.append(bufferptr(buffer::claim_buffer(
+      len, chunk,
+      make_deleter([this, chunk] { _release(chunk); }))));
+    bl->swap(newbl);
+  }
+};
+
+static HugePageBufferPool huge_buffer_pool;
+
 
 // kv store prefixes
 const string PREFIX_SUPER = "S";   // field -> value
@@ -2647,6 +2717,11 @@ void BlueStore::ExtentMap::fault_range(
       assert(p->dirty == false);
       assert(v.length() == p->shard_info->bytes);
       onode->c->store->logger->inc(l_bluestore_onode_shard_misses);
+      // fragmentation telemetry: extents and bytes per shard faulted in
+      onode->c->store->logger->inc(l_bluestore_extent_shard_extents,
+				   p->extents);
+      onode->c->store->logger->inc(l_bluestore_extent_shard_bytes,
+				   v.length());
     } else {
       onode->c->store->logger->inc(l_bluestore_onode_shard_hits);
     }
@@ -3298,10 +3373,62 @@ void BlueStore::Collection::split_cache(
 
 // =======================================================
 
+void BlueStore::MempoolThread::_balance_cache_ratios()
+{
+  CephContext *cct = store->cct;
+  uint64_t onode_hits = store->logger->get(l_bluestore_onode_hits);
+  uint64_t onode_misses = store->logger->get(l_bluestore_onode_misses);
+  uint64_t buffer_hit_bytes = store->logger->get(l_bluestore_buffer_hit_bytes);
+  uint64_t buffer_miss_bytes = store->logger->get(l_bluestore_buffer_miss_bytes);
+  uint64_t onode_lookups =
+    (onode_hits - last_onode_hits) + (onode_misses - last_onode_misses);
+  uint64_t buffer_reads =
+    (buffer_hit_bytes - last_buffer_hit_bytes) +
+    (buffer_miss_bytes - last_buffer_miss_bytes);
+  if (onode_lookups && buffer_reads) {
+    double onode_rate =
+      (double)(onode_hits - last_onode_hits) / (double)onode_lookups;
+    double buffer_rate =
+      (double)(buffer_hit_bytes - last_buffer_hit_bytes) /
+      (double)buffer_reads;
+    double step = cct->_conf->bluestore_cache_autotune_step;
+    double min = cct->_conf->bluestore_cache_autotune_min_ratio;
+    // leave the kv share alone; shift between meta and data only, and
+    // only when the hit rates clearly disagree (hysteresis to avoid
+    // oscillating on noise)
+    if (onode_rate + .05 < buffer_rate &&
+	store->cache_meta_ratio - step >= min) {
+      store->cache_meta_ratio -= step;
+      store->cache_data_ratio += step;
+    } else if (buffer_rate + .05 < onode_rate &&
+	       store->cache_data_ratio - step >= min) {
+      store->cache_meta_ratio += step;
+      store->cache_data_ratio -= step;
+    }
+    ldout(cct, 20) << __func__ << " onode_rate " << onode_rate
+		   << " buffer_rate " << buffer_rate
+		   << " -> meta " << store->cache_meta_ratio
+		   << " data " << store->cache_data_ratio << dendl;
+  }
+  last_onode_hits = onode_hits;
+  last_onode_misses = onode_misses;
+  last_buffer_hit_bytes = buffer_hit_bytes;
+  last_buffer_miss_bytes = buffer_miss_bytes;
+}
+
 void *BlueStore::MempoolThread::entry()
 {
   Mutex::Locker l(lock);
   while (!stop) {
+    if (store->cct->_conf->bluestore_cache_autotune) {
+      utime_t now = ceph_clock_now();
+      if (now >= next_balance) {
+	_balance_cache_ratios();
+	next_balance = now;
+	next_balance += store->cct->_conf->bluestore_cache_autotune_interval;
+      }
+    }
+
     uint64_t meta_bytes =
       mempool::bluestore_cache_other::allocated_bytes() +
       mempool::bluestore_cache_onode::allocated_bytes();
@@ -3762,6 +3889,10 @@ void BlueStore::_init_logger()
   b.add_time_avg(l_bluestore_kv_lat, "kv_lat",
 		 "Average kv_thread sync latency",
 		 "k_l", PerfCountersBuilder::PRIO_INTERESTING);
+  b.add_u64_avg(l_bluestore_kv_sync_batch_txcs, "kv_sync_batch_txcs",
+		"Average transactions per kv sync cycle");
+  b.add_u64_avg(l_bluestore_kv_sync_batch_costs, "kv_sync_batch_costs",
+		"Average throttle cost (bytes) per kv sync cycle");
   b.add_time_avg(l_bluestore_state_prepare_lat, "state_prepare_lat",
     "Average prepare state latency");
   b.add_time_avg(l_bluestore_state_aio_wait_lat, "state_aio_wait_lat",
@@ -3791,7 +3922,16 @@ void BlueStore::_init_logger()
   b.add_time_avg(l_bluestore_submit_lat, "submit_lat",
 		 "Average submit latency",
 		 "s_l", PerfCountersBuilder::PRIO_CRITICAL);
-  b.add_time_avg(l_bluestore_commit_lat, "commit_lat",
+  // latency histogram axis configuration, values are in nanoseconds
+  PerfHistogramCommon::axis_config_d commit_lat_axis_config{
+    "Latency (nsec)",
+    PerfHistogramCommon::SCALE_LOG2, ///< Latency in logarithmic scale
+    0,                               ///< Start at 0
+    100000,                          ///< Quantization unit is 100usec
+    32,                              ///< Enough to cover much longer than slow commits
+  };
+  b.add_time_avg_histogram(l_bluestore_commit_lat, "commit_lat",
+		 commit_lat_axis_config,
 		 "Average commit latency",
 		 "c_l", PerfCountersBuilder::PRIO_CRITICAL);
   b.add_time_avg(l_bluestore_read_lat, "read_lat",
@@ -3841,6 +3981,12 @@ void BlueStore::_init_logger()
   b.add_u64_counter(l_bluestore_onode_shard_misses,
 		    "bluestore_onode_shard_misses",
 		    "Sum for onode-shard lookups missed in the cache");
+  b.add_u64_avg(l_bluestore_extent_shard_extents,
+		"bluestore_extent_shard_extents",
+		"Average extents per extent-map shard loaded from kv");
+  b.add_u64_avg(l_bluestore_extent_shard_bytes,
+		"bluestore_extent_shard_bytes",
+		"Average encoded bytes per extent-map shard loaded from kv");
   b.add_u64(l_bluestore_extents, "bluestore_extents",
 	    "Number of extents in cache");
   b.add_u64(l_bluestore_blobs, "bluestore_blobs",
@@ -3853,6 +3999,9 @@ void BlueStore::_init_logger()
     "Sum for bytes of read hit in the cache");
   b.add_u64(l_bluestore_buffer_miss_bytes, "bluestore_buffer_miss_bytes",
     "Sum for bytes of read missed in the cache");
+  b.add_u64_counter(l_bluestore_buffer_skipped_bytes,
+    "bluestore_buffer_skipped_bytes",
+    "Sum for bytes kept out of the cache by read fadvise hints");
 
   b.add_u64_counter(l_bluestore_write_big, "bluestore_write_big",
 		    "Large aligned writes into fresh blobs");
@@ -4647,6 +4796,9 @@ int BlueStore::_open_db(bool create)
     return -EIO;
   }
 
+  // both the freelist bitmap (xor) and the statfs key (int64 array add)
+  // are maintained via merge operators, so commits issue blind merges
+  // instead of read-modify-write and never serialize on these keys.
   FreelistManager::setup_merge_operators(db);
   db->set_merge_operator(PREFIX_STAT, merge_op);
 
@@ -5219,6 +5371,10 @@ int BlueStore::mkfs()
 void BlueStore::set_cache_shards(unsigned num)
 {
   dout(10) << __func__ << " " << num << dendl;
+  // callers (e.g. the OSD) pass their op shard count; let the configured
+  // value raise it so onode/buffer cache contention can be tuned
+  // independently.  we never shrink, since collections hold shard refs.
+  num = MAX(num, cct->_conf->bluestore_cache_shards);
   size_t old = cache_shards.size();
   assert(num >= old);
   cache_shards.resize(num);
@@ -5453,6 +5609,34 @@ int BlueStore::fsck(bool deep)
   };
   mempool::bluestore_fsck::map<uint64_t,sb_info_t> sb_info;
 
+  // deep mode: data reads/csum verification dominate, so they are farmed
+  // out to a worker pool while the metadata walk itself stays ordered
+  struct deep_read_item_t {
+    CollectionRef c;
+    OnodeRef o;
+  };
+  std::mutex deep_lock;
+  std::condition_variable deep_cond;
+  std::list<deep_read_item_t> deep_queue;
+  std::vector<std::thread> deep_workers;
+  bool deep_queue_done = false;
+  std::atomic<int> deep_errors = {0};
+  auto deep_drain = [&]() {
+    if (deep_workers.empty())
+      return;
+    {
+      std::unique_lock<std::mutex> l(deep_lock);
+      deep_queue_done = true;
+      deep_cond.notify_all();
+    }
+    for (auto& t : deep_workers) {
+      t.join();
+    }
+    deep_workers.clear();
+    errors += deep_errors.load();
+    deep_errors = 0;
+  };
+
   uint64_t num_objects = 0;
   uint64_t num_extents = 0;
   uint64_t num_blobs = 0;
@@ -5511,6 +5695,40 @@ int BlueStore::fsck(bool deep)
   if (r < 0)
     goto out_scan;
 
+  if (deep) {
+    int n = MAX(1, cct->_conf->bluestore_fsck_deep_threads);
+    dout(1) << __func__ << " spawning " << n << " deep read workers" << dendl;
+    for (int i = 0; i < n; ++i) {
+      deep_workers.emplace_back([&] {
+	  std::unique_lock<std::mutex> l(deep_lock);
+	  while (true) {
+	    if (!deep_queue.empty()) {
+	      deep_read_item_t item = deep_queue.front();
+	      deep_queue.pop_front();
+	      l.unlock();
+	      {
+		RWLock::RLocker cl(item.c->lock);
+		bufferlist bl;
+		int r = _do_read(item.c.get(), item.o, 0, item.o->onode.size,
+				 bl, 0);
+		if (r < 0) {
+		  derr << "fsck error: " << item.o->oid
+		       << " error during read: " << cpp_strerror(r) << dendl;
+		  ++deep_errors;
+		}
+	      }
+	      l.lock();
+	      deep_cond.notify_all();
+	    } else if (deep_queue_done) {
+	      break;
+	    } else {
+	      deep_cond.wait(l);
+	    }
+	  }
+	});
+    }
+  }
+
   used_blocks.resize(bdev->get_size() / block_size);
   apply(
     0, SUPER_RESERVED, block_size, used_blocks, "0~SUPER_RESERVED",
@@ -5813,13 +6031,15 @@ int BlueStore::fsck(bool deep)
         }
       }
       if (deep) {
-	bufferlist bl;
-	int r = _do_read(c.get(), o, 0, o->onode.size, bl, 0);
-	if (r < 0) {
-	  ++errors;
-	  derr << __func__ << " error: " << oid << " error during read: "
-	       << cpp_strerror(r) << dendl;
+	// hand the data read off to the workers; cap the backlog so we
+	// don't pin every onode we have visited in memory
+	std::unique_lock<std::mutex> l(deep_lock);
+	while (deep_queue.size() >=
+	       (size_t)cct->_conf->bluestore_fsck_deep_threads * 2) {
+	  deep_cond.wait(l);
 	}
+	deep_queue.push_back(deep_read_item_t{c, o});
+	deep_cond.notify_one();
       }
       // omap
       if (o->onode.has_omap()) {
@@ -5833,6 +6053,7 @@ int BlueStore::fsck(bool deep)
       }
     }
   }
+  deep_drain();
   dout(1) << __func__ << " checking shared_blobs" << dendl;
   it = db->get_iterator(PREFIX_SHARED_BLOB);
   if (it) {
@@ -5974,6 +6195,7 @@ int BlueStore::fsck(bool deep)
   }
 
  out_scan:
+  deep_drain();
   mempool_thread.shutdown();
   _flush_cache();
  out_alloc:
@@ -6216,6 +6438,19 @@ int BlueStore::set_collection_opts(
     return -ENOENT;
   RWLock::WLocker l(c->lock);
   c->pool_opts = opts;
+  c->compression_dict.clear();
+  string dict_b64;
+  if (opts.get(pool_opts_t::COMPRESSION_DICTIONARY, &dict_b64)) {
+    bufferlist b64;
+    b64.append(dict_b64);
+    try {
+      c->compression_dict.decode_base64(b64);
+    } catch (buffer::error& e) {
+      derr << __func__ << " " << cid
+	   << " invalid compression_dictionary, ignoring" << dendl;
+      c->compression_dict.clear();
+    }
+  }
   return 0;
 }
 
@@ -6284,6 +6519,71 @@ int BlueStore::read(
   return r;
 }
 
+int BlueStore::readv(
+  CollectionHandle &c_,
+  const ghobject_t& oid,
+  map<uint64_t, uint64_t>& m,
+  bufferlist& bl,
+  uint32_t op_flags)
+{
+  utime_t start = ceph_clock_now();
+  Collection *c = static_cast<Collection *>(c_.get());
+  const coll_t &cid = c->get_cid();
+  dout(15) << __func__ << " " << cid << " " << oid
+	   << " in " << m.size() << " extents" << dendl;
+  if (!c->exists)
+    return -ENOENT;
+
+  bl.clear();
+  int r = 0;
+  int total = 0;
+  {
+    RWLock::RLocker l(c->lock);
+    utime_t start1 = ceph_clock_now();
+    OnodeRef o = c->get_onode(oid, false);
+    logger->tinc(l_bluestore_read_onode_meta_lat, ceph_clock_now() - start1);
+    if (!o || !o->exists) {
+      r = -ENOENT;
+      goto out;
+    }
+
+    // one onode lookup amortized over all the extents; each extent is
+    // read and (if needed) decompressed independently.
+    auto p = m.begin();
+    while (p != m.end()) {
+      bufferlist t;
+      r = _do_read(c, o, p->first, p->second, t, op_flags);
+      if (r < 0)
+	goto out;
+      total += r;
+      bl.claim_append(t);
+      if (r < (int)p->second) {
+	// reached the end of the object; trim this extent and drop the rest
+	if (r == 0) {
+	  p = m.erase(p);
+	} else {
+	  p->second = r;
+	  ++p;
+	}
+	m.erase(p, m.end());
+	break;
+      }
+      ++p;
+    }
+  }
+
+ out:
+  if (r >= 0 && _debug_data_eio(oid)) {
+    r = -EIO;
+    derr << __func__ << " " << c->cid << " " << oid << " INJECT EIO" << dendl;
+  }
+  dout(10) << __func__ << " " << cid << " " << oid
+	   << " in " << m.size() << " extents = "
+	   << (r < 0 ? r : total) << dendl;
+  logger->tinc(l_bluestore_read_lat, ceph_clock_now() - start);
+  return r < 0 ? r : total;
+}
+
 // --------------------------------------------------------
 // intermediate data structures used while reading
 struct region_t {
@@ -6351,6 +6651,14 @@ int BlueStore::_do_read(
     length = o->onode.size - offset;
   }
 
+  if (!buffered && cct->_conf->bluestore_default_buffered_read &&
+      (op_flags & (CEPH_OSD_OP_FLAG_FADVISE_DONTNEED |
+		   CEPH_OSD_OP_FLAG_FADVISE_NOCACHE)) != 0) {
+    // these bytes would have been cached (and evicted client-hot
+    // buffers) without the hint
+    logger->inc(l_bluestore_buffer_skipped_bytes, length);
+  }
+
   utime_t start = ceph_clock_now();
   o->extent_map.fault_range(db, offset, length);
   logger->tinc(l_bluestore_read_onode_meta_lat, ceph_clock_now() - start);
@@ -6515,12 +6823,16 @@ int BlueStore::_do_read(
 	return -EIO;
       }
       bufferlist raw_bl;
-      r = _decompress(compressed_bl, &raw_bl);
+      r = _decompress(compressed_bl, &raw_bl, c->compression_dict);
       if (r < 0)
 	return r;
       if (buffered) {
+	bufferlist cache_bl = raw_bl;
+	if (cct->_conf->bluestore_cache_hugepage_buffers) {
+	  huge_buffer_pool.try_copy(&cache_bl);
+	}
 	bptr->shared_blob->bc.did_read(bptr->shared_blob->get_cache(), 0,
-				       raw_bl);
+				       cache_bl);
       }
       for (auto& i : b2r_it->second) {
 	ready_regions[i.logical_offset].substr_of(
@@ -6533,8 +6845,12 @@ int BlueStore::_do_read(
 	  return -EIO;
 	}
 	if (buffered) {
+	  bufferlist cache_bl = reg.bl;
+	  if (cct->_conf->bluestore_cache_hugepage_buffers) {
+	    huge_buffer_pool.try_copy(&cache_bl);
+	  }
 	  bptr->shared_blob->bc.did_read(bptr->shared_blob->get_cache(),
-					 reg.r_off, reg.bl);
+					 reg.r_off, cache_bl);
 	}
 
 	// prune and keep result
@@ -6616,7 +6932,8 @@ int BlueStore::_verify_csum(OnodeRef& o,
   return r;
 }
 
-int BlueStore::_decompress(bufferlist& source, bufferlist* result)
+int BlueStore::_decompress(bufferlist& source, bufferlist* result,
+			   const bufferlist& dict)
 {
   int r = 0;
   utime_t start = ceph_clock_now();
@@ -6635,7 +6952,7 @@ int BlueStore::_decompress(bufferlist& source, bufferlist* result)
     derr << __func__ << " can't load decompressor " << alg << dendl;
     r = -EIO;
   } else {
-    r = cp->decompress(i, chdr.length, *result);
+    r = cp->decompress(i, chdr.length, *result, dict);
     if (r < 0) {
       derr << __func__ << " decompression failed with exit code " << r << dendl;
       r = -EIO;
@@ -6772,6 +7089,81 @@ int BlueStore::fiemap(
   return r;
 }
 
+int BlueStore::get_csums(
+  const coll_t& cid,
+  const ghobject_t& oid,
+  uint64_t offset,
+  size_t len,
+  vector<csum_extent_t> *out)
+{
+  CollectionHandle c = _get_collection(cid);
+  if (!c)
+    return -ENOENT;
+  return get_csums(c, oid, offset, len, out);
+}
+
+int BlueStore::get_csums(
+  CollectionHandle &c_,
+  const ghobject_t& oid,
+  uint64_t offset,
+  size_t length,
+  vector<csum_extent_t> *out)
+{
+  Collection *c = static_cast<Collection *>(c_.get());
+  if (!c->exists)
+    return -ENOENT;
+  RWLock::RLocker l(c->lock);
+
+  OnodeRef o = c->get_onode(oid, false);
+  if (!o || !o->exists) {
+    return -ENOENT;
+  }
+
+  dout(20) << __func__ << " 0x" << std::hex << offset << "~" << length
+	   << " size 0x" << o->onode.size << std::dec << dendl;
+
+  if (offset >= o->onode.size)
+    return 0;
+  if (offset + length > o->onode.size) {
+    length = o->onode.size - offset;
+  }
+  uint64_t end = offset + length;
+
+  o->extent_map.fault_range(db, offset, length);
+  auto eend = o->extent_map.extent_map.end();
+  auto ep = o->extent_map.seek_lextent(offset);
+  while (ep != eend && ep->logical_offset < end) {
+    if (ep->logical_offset + ep->length <= offset) {
+      ++ep;
+      continue;
+    }
+    const bluestore_blob_t& blob = ep->blob->get_blob();
+    csum_extent_t e;
+    e.offset = ep->logical_offset;
+    e.length = ep->length;
+    e.csum_type = blob.csum_type;
+    if (blob.has_csum()) {
+      size_t vsize = blob.get_csum_value_size();
+      uint32_t chunk_size = blob.get_csum_chunk_size();
+      e.csum_chunk_size = chunk_size;
+      // checksum values for the chunks covering
+      // [blob_offset, blob_offset + length)
+      uint64_t first = ep->blob_offset / chunk_size;
+      uint64_t last =
+	(ep->blob_offset + ep->length + chunk_size - 1) / chunk_size;
+      e.csum_data.append(
+	bufferptr(blob.csum_data, first * vsize, (last - first) * vsize));
+    }
+    dout(30) << __func__ << " lextent 0x" << std::hex << e.offset << "~"
+	     << e.length << std::dec << " csum_type " << e.csum_type
+	     << " chunk_size " << e.csum_chunk_size
+	     << " " << e.csum_data.length() << " bytes of csum data" << dendl;
+    out->push_back(std::move(e));
+    ++ep;
+  }
+  return 0;
+}
+
 int BlueStore::getattr(
   const coll_t& cid,
   const ghobject_t& oid,
@@ -6824,6 +7216,42 @@ int BlueStore::getattr(
 }
 
 
+int BlueStore::getattr_batch(
+  CollectionHandle &c_,
+  const vector<ghobject_t>& oids,
+  const char *name,
+  map<ghobject_t, bufferptr> *out)
+{
+  Collection *c = static_cast<Collection *>(c_.get());
+  dout(15) << __func__ << " " << c->cid << " " << oids.size() << " oids "
+	   << name << dendl;
+  if (!c->exists)
+    return -ENOENT;
+
+  int r = 0;
+  {
+    // take the collection lock once for the whole batch; the attrs
+    // come straight off the (possibly cached) onodes
+    RWLock::RLocker l(c->lock);
+    mempool::bluestore_cache_other::string k(name);
+
+    for (vector<ghobject_t>::const_iterator p = oids.begin();
+	 p != oids.end(); ++p) {
+      OnodeRef o = c->get_onode(*p, false);
+      if (!o || !o->exists)
+	continue;
+      if (!o->onode.attrs.count(k)) {
+	r = -ENODATA;
+	break;
+      }
+      (*out)[*p] = o->onode.attrs[k];
+    }
+  }
+  dout(10) << __func__ << " " << c->cid << " " << oids.size() << " oids "
+	   << name << " = " << r << dendl;
+  return r;
+}
+
 int BlueStore::getattrs(
   const coll_t& cid,
   const ghobject_t& oid,
@@ -8081,9 +8509,11 @@ void BlueStore::_osr_drain_preceding(TransContext *txc)
   dout(10) << __func__ << " " << txc << " osr " << osr << dendl;
   ++deferred_aggressive; // FIXME: maybe osr-local aggressive flag?
   {
-    // submit anything pending
+    // submit anything pending.  if it can't go down yet (overlap with a
+    // running batch), _deferred_aio_finish will requeue us since we are
+    // in aggressive mode.
     deferred_lock.lock();
-    if (osr->deferred_pending) {
+    if (_deferred_can_submit(osr)) {
       _deferred_submit_unlock(osr);
     } else {
       deferred_lock.unlock();
@@ -8423,6 +8853,10 @@ void BlueStore::_kv_sync_thread()
 	logger->tinc(l_bluestore_kv_flush_lat, dur_flush);
 	logger->tinc(l_bluestore_kv_commit_lat, dur_kv);
 	logger->tinc(l_bluestore_kv_lat, dur);
+	// convoy visibility: how much one sync cycle drags through the
+	// single wal write+flush
+	logger->inc(l_bluestore_kv_sync_batch_txcs, kv_committing.size());
+	logger->inc(l_bluestore_kv_sync_batch_costs, costs);
       }
 
       if (bluefs) {
@@ -8568,13 +9002,38 @@ void BlueStore::_deferred_queue(TransContext *txc)
     }
   }
   if (deferred_aggressive &&
-      !txc->osr->deferred_running) {
+      _deferred_can_submit(txc->osr.get())) {
     _deferred_submit_unlock(txc->osr.get());
   } else {
     deferred_lock.unlock();
   }
 }
 
+bool BlueStore::_deferred_can_submit(OpSequencer *osr)
+{
+  // caller holds deferred_lock
+  if (!osr->deferred_pending) {
+    return false;
+  }
+  if (osr->deferred_running == 0) {
+    return true;
+  }
+  if (osr->deferred_running >=
+      (int)cct->_conf->bluestore_deferred_max_running) {
+    return false;
+  }
+  // pipelining batch N+1 behind batch N is only safe if they touch
+  // disjoint disk ranges; otherwise the aios (or a crash replay) could
+  // apply overlapping writes out of order.
+  for (auto& p : osr->deferred_pending->iomap) {
+    if (osr->deferred_running_ranges.intersects(p.first,
+						p.second.bl.length())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void BlueStore::deferred_try_submit()
 {
   dout(20) << __func__ << " " << deferred_queue.size() << " osrs, "
@@ -8586,7 +9045,7 @@ void BlueStore::deferred_try_submit()
     osrs.push_back(&osr);
   }
   for (auto& osr : osrs) {
-    if (!osr->deferred_running) {
+    if (_deferred_can_submit(osr.get())) {
       _deferred_submit_unlock(osr.get());
       deferred_lock.lock();
     }
@@ -8599,13 +9058,16 @@ void BlueStore::_deferred_submit_unlock(OpSequencer *osr)
 	   << " " << osr->deferred_pending->iomap.size() << " ios pending "
 	   << dendl;
   assert(osr->deferred_pending);
-  assert(!osr->deferred_running);
 
   auto b = osr->deferred_pending;
   deferred_queue_size -= b->seq_bytes.size();
   assert(deferred_queue_size >= 0);
 
-  osr->deferred_running = osr->deferred_pending;
+  ++osr->deferred_running;
+  for (auto& p : b->iomap) {
+    osr->deferred_running_ranges.union_insert(p.first,
+					      p.second.bl.length());
+  }
   osr->deferred_pending = nullptr;
 
   uint64_t start = 0, pos = 0;
@@ -8648,17 +9110,18 @@ void BlueStore::_deferred_submit_unlock(OpSequencer *osr)
   bdev->aio_submit(&b->ioc);
 }
 
-void BlueStore::_deferred_aio_finish(OpSequencer *osr)
+void BlueStore::_deferred_aio_finish(OpSequencer *osr, DeferredBatch *b)
 {
-  dout(10) << __func__ << " osr " << osr << dendl;
-  assert(osr->deferred_running);
-  DeferredBatch *b = osr->deferred_running;
+  dout(10) << __func__ << " osr " << osr << " batch " << b << dendl;
 
   {
     std::lock_guard<std::mutex> l(deferred_lock);
-    assert(osr->deferred_running == b);
-    osr->deferred_running = nullptr;
-    if (!osr->deferred_pending) {
+    assert(osr->deferred_running > 0);
+    --osr->deferred_running;
+    for (auto& p : b->iomap) {
+      osr->deferred_running_ranges.erase(p.first, p.second.bl.length());
+    }
+    if (!osr->deferred_pending && !osr->deferred_running) {
       auto q = deferred_queue.iterator_to(*osr);
       deferred_queue.erase(q);
     } else if (deferred_aggressive) {
@@ -9437,7 +9900,8 @@ void BlueStore::_do_write_small(
 		b_off, padded,
 		[&](uint64_t offset, bufferlist& t) {
 		  bdev->aio_write(offset, t,
-				  &txc->ioc, wctx->buffered);
+				  &txc->ioc, wctx->buffered,
+				  wctx->write_hint);
 		});
 	    }
 	  }
@@ -9815,7 +10279,7 @@ int BlueStore::_do_alloc_write(
       // FIXME: memory alignment here is bad
       bufferlist t;
 
-      r = c->compress(*l, t);
+      r = c->compress(*l, t, coll->compression_dict);
       assert(r == 0);
 
       chdr.length = t.length();
@@ -9950,7 +10414,7 @@ int BlueStore::_do_alloc_write(
 	b->get_blob().map_bl(
 	  b_off, *l,
 	  [&](uint64_t offset, bufferlist& t) {
-	    bdev->aio_write(offset, t, &txc->ioc, false);
+	    bdev->aio_write(offset, t, &txc->ioc, false, wctx->write_hint);
 	  });
       }
     }
@@ -10089,6 +10553,18 @@ void BlueStore::_choose_write_options(
 
   // compression parameters
   unsigned alloc_hints = o->onode.alloc_hint_flags;
+
+  // map the client's expected-lifetime alloc hints to a bdev write
+  // lifetime hint so the device can place the data in a matching
+  // flash stream.
+  if (alloc_hints & CEPH_OSD_ALLOC_HINT_FLAG_SHORTLIVED) {
+    wctx->write_hint = WRITE_LIFE_SHORT;
+  } else if (alloc_hints & CEPH_OSD_ALLOC_HINT_FLAG_LONGLIVED) {
+    wctx->write_hint = WRITE_LIFE_LONG;
+  } else if (alloc_hints & (CEPH_OSD_ALLOC_HINT_FLAG_IMMUTABLE |
+			    CEPH_OSD_ALLOC_HINT_FLAG_APPEND_ONLY)) {
+    wctx->write_hint = WRITE_LIFE_EXTREME;
+  }
   auto cm = select_option(
     "compression_mode",
     comp_mode.load(),
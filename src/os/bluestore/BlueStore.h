@@ -60,6 +60,8 @@ enum {
   l_bluestore_kv_flush_lat,
   l_bluestore_kv_commit_lat,
   l_bluestore_kv_lat,
+  l_bluestore_kv_sync_batch_txcs,
+  l_bluestore_kv_sync_batch_costs,
   l_bluestore_state_prepare_lat,
   l_bluestore_state_aio_wait_lat,
   l_bluestore_state_io_done_lat,
@@ -96,12 +98,15 @@ enum {
   l_bluestore_onode_misses,
   l_bluestore_onode_shard_hits,
   l_bluestore_onode_shard_misses,
+  l_bluestore_extent_shard_extents,
+  l_bluestore_extent_shard_bytes,
   l_bluestore_extents,
   l_bluestore_blobs,
   l_bluestore_buffers,
   l_bluestore_buffer_bytes,
   l_bluestore_buffer_hit_bytes,
   l_bluestore_buffer_miss_bytes,
+  l_bluestore_buffer_skipped_bytes,
   l_bluestore_write_big,
   l_bluestore_write_big_bytes,
   l_bluestore_write_big_blobs,
@@ -1339,6 +1344,7 @@ public:
 
     //pool options
     pool_opts_t pool_opts;
+    bufferlist compression_dict; ///< decoded per-pool compression dictionary
 
     OnodeRef get_onode(const ghobject_t& oid, bool create);
 
@@ -1631,7 +1637,7 @@ public:
 		       bufferlist::const_iterator& p);
 
     void aio_finish(BlueStore *store) override {
-      store->_deferred_aio_finish(osr);
+      store->_deferred_aio_finish(osr, this);
     }
   };
 
@@ -1649,7 +1655,11 @@ public:
 
     boost::intrusive::list_member_hook<> deferred_osr_queue_item;
 
-    DeferredBatch *deferred_running = nullptr;
+    int deferred_running = 0;            ///< in-flight deferred batches
+    /// disk ranges covered by in-flight batches; a second batch may only
+    /// be submitted while one is running if their ranges are disjoint,
+    /// else the io (and crash replay) could apply them out of order
+    interval_set<uint64_t> deferred_running_ranges;
     DeferredBatch *deferred_pending = nullptr;
 
     Sequencer *parent;
@@ -1930,11 +1940,19 @@ private:
     Cond cond;
     Mutex lock;
     bool stop = false;
+
+    // cache autotune state: counter values at the last rebalance
+    uint64_t last_onode_hits = 0;
+    uint64_t last_onode_misses = 0;
+    uint64_t last_buffer_hit_bytes = 0;
+    uint64_t last_buffer_miss_bytes = 0;
+    utime_t next_balance;
   public:
     explicit MempoolThread(BlueStore *s)
       : store(s),
 	lock("BlueStore::MempoolThread::lock") {}
     void *entry() override;
+    void _balance_cache_ratios();
     void init() {
       assert(stop == false);
       create("bstore_mempool");
@@ -2038,8 +2056,9 @@ private:
   bluestore_deferred_op_t *_get_deferred_op(TransContext *txc, OnodeRef o);
   void _deferred_queue(TransContext *txc);
   void deferred_try_submit();
+  bool _deferred_can_submit(OpSequencer *osr);
   void _deferred_submit_unlock(OpSequencer *osr);
-  void _deferred_aio_finish(OpSequencer *osr);
+  void _deferred_aio_finish(OpSequencer *osr, DeferredBatch *b);
   int _deferred_replay();
 
 public:
@@ -2152,6 +2171,10 @@ public:
 
   void get_db_statistics(Formatter *f) override;
   void generate_db_histogram(Formatter *f) override;
+  void set_bulk_load(bool enable) override {
+    if (db)
+      db->set_bulk_load(enable);
+  }
   void _flush_cache();
   void flush_cache() override;
   void dump_perf_counters(Formatter *f) override {
@@ -2203,6 +2226,12 @@ public:
     size_t len,
     bufferlist& bl,
     uint32_t op_flags = 0) override;
+  int readv(
+    CollectionHandle &c,
+    const ghobject_t& oid,
+    map<uint64_t, uint64_t>& m,
+    bufferlist& bl,
+    uint32_t op_flags = 0) override;
   int _do_read(
     Collection *c,
     OnodeRef o,
@@ -2224,12 +2253,23 @@ public:
   int fiemap(CollectionHandle &c, const ghobject_t& oid,
 	     uint64_t offset, size_t len, map<uint64_t, uint64_t>& destmap) override;
 
+  int get_csums(const coll_t& cid, const ghobject_t& oid,
+		uint64_t offset, size_t len,
+		vector<csum_extent_t> *out) override;
+  int get_csums(CollectionHandle &c, const ghobject_t& oid,
+		uint64_t offset, size_t len,
+		vector<csum_extent_t> *out) override;
 
   int getattr(const coll_t& cid, const ghobject_t& oid, const char *name,
 	      bufferptr& value) override;
   int getattr(CollectionHandle &c, const ghobject_t& oid, const char *name,
 	      bufferptr& value) override;
 
+  int getattr_batch(CollectionHandle &c,
+		    const vector<ghobject_t>& oids,
+		    const char *name,
+		    map<ghobject_t, bufferptr> *out) override;
+
   int getattrs(const coll_t& cid, const ghobject_t& oid,
 	       map<string,bufferptr>& aset) override;
   int getattrs(CollectionHandle &c, const ghobject_t& oid,
@@ -2411,7 +2451,8 @@ private:
     uint64_t blob_xoffset,
     const bufferlist& bl,
     uint64_t logical_offset) const;
-  int _decompress(bufferlist& source, bufferlist* result);
+  int _decompress(bufferlist& source, bufferlist* result,
+		  const bufferlist& dict);
 
 
   // --------------------------------------------------------
@@ -2420,6 +2461,7 @@ private:
   struct WriteContext {
     bool buffered = false;          ///< buffered write
     bool compress = false;          ///< compressed write
+    int write_hint = WRITE_LIFE_NOT_SET;  ///< bdev write lifetime hint
     uint64_t target_blob_size = 0;  ///< target (max) blob size
     unsigned csum_order = 0;        ///< target checksum chunk order
 
@@ -2464,6 +2506,7 @@ private:
     void fork(const WriteContext& other) {
       buffered = other.buffered;
       compress = other.compress;
+      write_hint = other.write_hint;
       target_blob_size = other.target_blob_size;
       csum_order = other.csum_order;
     }
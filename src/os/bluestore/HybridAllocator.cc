@@ -0,0 +1,189 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "HybridAllocator.h"
+#include "bluestore_types.h"
+#include "common/debug.h"
+
+#define dout_context cct
+#define dout_subsys ceph_subsys_bluestore
+#undef dout_prefix
+#define dout_prefix *_dout << "hybridalloc "
+
+HybridAllocator::HybridAllocator(CephContext* cct, int64_t device_size,
+				 int64_t _block_size)
+  : cct(cct),
+    block_size(_block_size),
+    small_max(cct->_conf->bluestore_hybrid_alloc_small_max),
+    region_size(P2ROUNDUP(cct->_conf->bluestore_hybrid_alloc_region_size,
+			  (uint64_t)_block_size)),
+    num_reserved(0),
+    btree(cct),
+    bitmap(cct, device_size, _block_size)
+{
+}
+
+HybridAllocator::~HybridAllocator()
+{
+}
+
+int HybridAllocator::reserve(uint64_t need)
+{
+  std::lock_guard<std::mutex> l(lock);
+  int64_t f = btree.get_free() + bitmap.get_free();
+  dout(10) << __func__ << " need 0x" << std::hex << need
+	   << " num_free 0x" << f
+	   << " num_reserved 0x" << num_reserved << std::dec << dendl;
+  if ((int64_t)need > f - num_reserved)
+    return -ENOSPC;
+  num_reserved += need;
+  return 0;
+}
+
+void HybridAllocator::unreserve(uint64_t unused)
+{
+  std::lock_guard<std::mutex> l(lock);
+  dout(10) << __func__ << " unused 0x" << std::hex << unused
+	   << " num_reserved 0x" << num_reserved << std::dec << dendl;
+  assert(num_reserved >= (int64_t)unused);
+  num_reserved -= unused;
+}
+
+/*
+ * Move a chunk of free space from the btree side over to the bitmap
+ * side so small allocations can keep packing densely.  Returns bytes
+ * moved, or -ENOSPC if the btree side is exhausted too.
+ */
+int64_t HybridAllocator::_refill_small(uint64_t alloc_unit)
+{
+  uint64_t want = MAX(region_size, small_max);
+  if (btree.reserve(want) < 0)
+    return -ENOSPC;
+  AllocExtentVector extents;
+  int64_t got = btree.allocate(want, alloc_unit, want, -1, &extents);
+  if (got <= 0) {
+    btree.unreserve(want);
+    return -ENOSPC;
+  }
+  if (got < (int64_t)want)
+    btree.unreserve(want - got);
+  std::lock_guard<std::mutex> l(lock);
+  for (auto& e : extents) {
+    dout(10) << __func__ << " region 0x" << std::hex << e.offset
+	     << "~" << e.length << std::dec << dendl;
+    bitmap.init_add_free(e.offset, e.length);
+    small_regions.insert(e.offset, e.length);
+  }
+  return got;
+}
+
+int64_t HybridAllocator::allocate(
+  uint64_t want_size,
+  uint64_t alloc_unit,
+  uint64_t max_alloc_size,
+  int64_t hint,
+  mempool::bluestore_alloc::vector<AllocExtent> *extents)
+{
+  dout(10) << __func__ << " want 0x" << std::hex << want_size
+	   << " alloc_unit 0x" << alloc_unit
+	   << " hint 0x" << hint << std::dec << dendl;
+  int64_t got = -ENOSPC;
+
+  // small requests go to the bitmap side; carve a fresh region from the
+  // btree if it runs dry.  large requests best-fit out of the btree so
+  // we never scan bitmaps for contiguous space.
+  if (want_size <= small_max &&
+      alloc_unit % block_size == 0) {
+    if (bitmap.reserve(want_size) < 0) {
+      if (_refill_small(alloc_unit) > 0) {
+	if (bitmap.reserve(want_size) < 0) {
+	  got = -ENOSPC;
+	} else {
+	  got = bitmap.allocate(want_size, alloc_unit, max_alloc_size,
+				hint, extents);
+	  if (got < 0)
+	    bitmap.unreserve(want_size);
+	}
+      }
+    } else {
+      got = bitmap.allocate(want_size, alloc_unit, max_alloc_size,
+			    hint, extents);
+      if (got < 0)
+	bitmap.unreserve(want_size);
+    }
+    if (got > 0 && got < (int64_t)want_size)
+      bitmap.unreserve(want_size - got);
+  }
+
+  if (got <= 0) {
+    if (btree.reserve(want_size) == 0) {
+      got = btree.allocate(want_size, alloc_unit, max_alloc_size,
+			   hint, extents);
+      if (got < 0)
+	btree.unreserve(want_size);
+      else if (got < (int64_t)want_size)
+	btree.unreserve(want_size - got);
+    } else {
+      got = -ENOSPC;
+    }
+  }
+
+  if (got > 0) {
+    std::lock_guard<std::mutex> l(lock);
+    num_reserved -= MIN(num_reserved, got);
+  }
+  return got;
+}
+
+void HybridAllocator::release(
+  uint64_t offset, uint64_t length)
+{
+  dout(10) << __func__ << " 0x" << std::hex << offset << "~" << length
+	   << std::dec << dendl;
+  // route each piece back to whichever side owns it
+  interval_set<uint64_t> released;
+  released.insert(offset, length);
+  interval_set<uint64_t> small;
+  {
+    std::lock_guard<std::mutex> l(lock);
+    small.intersection_of(released, small_regions);
+  }
+  for (auto p = small.begin(); p != small.end(); ++p) {
+    bitmap.release(p.get_start(), p.get_len());
+    released.erase(p.get_start(), p.get_len());
+  }
+  for (auto p = released.begin(); p != released.end(); ++p) {
+    btree.release(p.get_start(), p.get_len());
+  }
+}
+
+uint64_t HybridAllocator::get_free()
+{
+  return btree.get_free() + bitmap.get_free();
+}
+
+void HybridAllocator::dump()
+{
+  dout(0) << __func__ << " instance " << this << dendl;
+  btree.dump();
+  bitmap.dump();
+}
+
+void HybridAllocator::init_add_free(uint64_t offset, uint64_t length)
+{
+  // regions are only handed to the bitmap side at runtime, so all
+  // initial free space lands in the btree
+  btree.init_add_free(offset, length);
+}
+
+void HybridAllocator::init_rm_free(uint64_t offset, uint64_t length)
+{
+  btree.init_rm_free(offset, length);
+}
+
+void HybridAllocator::shutdown()
+{
+  dout(1) << __func__ << dendl;
+  btree.shutdown();
+  bitmap.shutdown();
+}
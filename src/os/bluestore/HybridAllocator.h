@@ -0,0 +1,59 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#ifndef CEPH_OS_BLUESTORE_HYBRIDALLOCATOR_H
+#define CEPH_OS_BLUESTORE_HYBRIDALLOCATOR_H
+
+#include <mutex>
+
+#include "Allocator.h"
+#include "StupidAllocator.h"
+#include "BitMapAllocator.h"
+#include "include/interval_set.h"
+
+/// Composite allocator: a btree of free extents (StupidAllocator) serves
+/// large allocations with best-fit behavior, while small allocations are
+/// packed into regions that are carved out of the btree side on demand and
+/// tracked by a bitmap (BitMapAllocator).  This keeps the btree shallow on
+/// aged stores while avoiding bitmap scans for large contiguous requests.
+class HybridAllocator : public Allocator {
+  CephContext* cct;
+
+  int64_t block_size;
+  uint64_t small_max;     ///< requests <= this go to the bitmap side
+  uint64_t region_size;   ///< how much we carve per refill
+  int64_t num_reserved;   ///< reserved bytes
+
+  StupidAllocator btree;      ///< extent btree, large allocations
+  BitMapAllocator bitmap;     ///< dense small allocations
+
+  std::mutex lock;                       ///< protects small_regions
+  interval_set<uint64_t> small_regions;  ///< space owned by the bitmap side
+
+  int64_t _refill_small(uint64_t alloc_unit);
+
+public:
+  HybridAllocator(CephContext* cct, int64_t device_size, int64_t _block_size);
+  ~HybridAllocator() override;
+
+  int reserve(uint64_t need) override;
+  void unreserve(uint64_t unused) override;
+
+  int64_t allocate(
+    uint64_t want_size, uint64_t alloc_unit, uint64_t max_alloc_size,
+    int64_t hint, mempool::bluestore_alloc::vector<AllocExtent> *extents) override;
+
+  void release(
+    uint64_t offset, uint64_t length) override;
+
+  uint64_t get_free() override;
+
+  void dump() override;
+
+  void init_add_free(uint64_t offset, uint64_t length) override;
+  void init_rm_free(uint64_t offset, uint64_t length) override;
+
+  void shutdown() override;
+};
+
+#endif
@@ -35,8 +35,8 @@
 
 KernelDevice::KernelDevice(CephContext* cct, aio_callback_t cb, void *cbpriv)
   : BlockDevice(cct),
-    fd_direct(-1),
-    fd_buffered(-1),
+    fd_directs(WRITE_LIFE_MAX, -1),
+    fd_buffereds(WRITE_LIFE_MAX, -1),
     size(0), block_size(0),
     fs(NULL), aio(false), dio(false),
     debug_lock("KernelDevice::debug_lock"),
@@ -55,7 +55,7 @@ int KernelDevice::_lock()
   memset(&l, 0, sizeof(l));
   l.l_type = F_WRLCK;
   l.l_whence = SEEK_SET;
-  int r = ::fcntl(fd_direct, F_SETLK, &l);
+  int r = ::fcntl(fd_directs[WRITE_LIFE_NOT_SET], F_SETLK, &l);
   if (r < 0)
     return -errno;
   return 0;
@@ -64,21 +64,57 @@ int KernelDevice::_lock()
 int KernelDevice::open(const string& p)
 {
   path = p;
-  int r = 0;
+  int r = 0, i = 0;
+  uint64_t hint;
   dout(1) << __func__ << " path " << path << dendl;
 
-  fd_direct = ::open(path.c_str(), O_RDWR | O_DIRECT);
-  if (fd_direct < 0) {
-    r = -errno;
-    derr << __func__ << " open got: " << cpp_strerror(r) << dendl;
-    return r;
+  // one fd pair per write lifetime hint class; the hint is a property
+  // of the open file description, so writes with different expected
+  // lifetimes need to go through different fds to land in different
+  // flash streams.
+  for (i = 0; i < WRITE_LIFE_MAX; i++) {
+    int fd = ::open(path.c_str(), O_RDWR | O_DIRECT);
+    if (fd < 0) {
+      r = -errno;
+      break;
+    }
+    fd_directs[i] = fd;
+
+    fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+      r = -errno;
+      break;
+    }
+    fd_buffereds[i] = fd;
   }
-  fd_buffered = ::open(path.c_str(), O_RDWR);
-  if (fd_buffered < 0) {
-    r = -errno;
+  if (i != WRITE_LIFE_MAX) {
     derr << __func__ << " open got: " << cpp_strerror(r) << dendl;
-    goto out_direct;
+    goto out_fail;
+  }
+
+#if defined(F_SET_FILE_RW_HINT)
+  for (i = WRITE_LIFE_NONE; i < WRITE_LIFE_MAX; i++) {
+    hint = i;
+    if (fcntl(fd_directs[i], F_SET_FILE_RW_HINT, &hint) < 0) {
+      r = -errno;
+      break;
+    }
+    if (fcntl(fd_buffereds[i], F_SET_FILE_RW_HINT, &hint) < 0) {
+      r = -errno;
+      break;
+    }
   }
+  if (i != WRITE_LIFE_MAX) {
+    enable_wrt = false;
+    dout(0) << __func__ << " rw hints unsupported on " << path
+	    << " (" << cpp_strerror(r) << "), all writes share one stream"
+	    << dendl;
+  }
+#else
+  (void)hint;
+  enable_wrt = false;
+#endif
+
   dio = true;
   aio = cct->_conf->bdev_aio;
   if (!aio) {
@@ -87,7 +123,7 @@ int KernelDevice::open(const string& p)
 
   // disable readahead as it will wreak havoc on our mix of
   // directio/aio and buffered io.
-  r = posix_fadvise(fd_buffered, 0, 0, POSIX_FADV_RANDOM);
+  r = posix_fadvise(fd_buffereds[WRITE_LIFE_NOT_SET], 0, 0, POSIX_FADV_RANDOM);
   if (r) {
     r = -r;
     derr << __func__ << " open got: " << cpp_strerror(r) << dendl;
@@ -102,7 +138,7 @@ int KernelDevice::open(const string& p)
   }
 
   struct stat st;
-  r = ::fstat(fd_direct, &st);
+  r = ::fstat(fd_directs[WRITE_LIFE_NOT_SET], &st);
   if (r < 0) {
     r = -errno;
     derr << __func__ << " fstat got " << cpp_strerror(r) << dendl;
@@ -122,7 +158,7 @@ int KernelDevice::open(const string& p)
 
   if (S_ISBLK(st.st_mode)) {
     int64_t s;
-    r = get_block_device_size(fd_direct, &s);
+    r = get_block_device_size(fd_directs[WRITE_LIFE_NOT_SET], &s);
     if (r < 0) {
       goto out_fail;
     }
@@ -133,7 +169,7 @@ int KernelDevice::open(const string& p)
 
   {
     char partition[PATH_MAX], devname[PATH_MAX];
-    r = get_device_by_fd(fd_buffered, partition, devname, sizeof(devname));
+    r = get_device_by_fd(fd_buffereds[WRITE_LIFE_NOT_SET], partition, devname, sizeof(devname));
     if (r < 0) {
       derr << "unable to get device name for " << path << ": "
 	   << cpp_strerror(r) << dendl;
@@ -149,7 +185,7 @@ int KernelDevice::open(const string& p)
     goto out_fail;
   }
 
-  fs = FS::create_by_fd(fd_direct);
+  fs = FS::create_by_fd(fd_directs[WRITE_LIFE_NOT_SET]);
   assert(fs);
 
   // round size down to an even block
@@ -166,11 +202,16 @@ int KernelDevice::open(const string& p)
   return 0;
 
  out_fail:
-  VOID_TEMP_FAILURE_RETRY(::close(fd_buffered));
-  fd_buffered = -1;
- out_direct:
-  VOID_TEMP_FAILURE_RETRY(::close(fd_direct));
-  fd_direct = -1;
+  for (i = 0; i < WRITE_LIFE_MAX; i++) {
+    if (fd_directs[i] >= 0) {
+      VOID_TEMP_FAILURE_RETRY(::close(fd_directs[i]));
+      fd_directs[i] = -1;
+    }
+    if (fd_buffereds[i] >= 0) {
+      VOID_TEMP_FAILURE_RETRY(::close(fd_buffereds[i]));
+      fd_buffereds[i] = -1;
+    }
+  }
   return r;
 }
 
@@ -183,13 +224,15 @@ void KernelDevice::close()
   delete fs;
   fs = NULL;
 
-  assert(fd_direct >= 0);
-  VOID_TEMP_FAILURE_RETRY(::close(fd_direct));
-  fd_direct = -1;
+  for (int i = 0; i < WRITE_LIFE_MAX; i++) {
+    assert(fd_directs[i] >= 0);
+    VOID_TEMP_FAILURE_RETRY(::close(fd_directs[i]));
+    fd_directs[i] = -1;
 
-  assert(fd_buffered >= 0);
-  VOID_TEMP_FAILURE_RETRY(::close(fd_buffered));
-  fd_buffered = -1;
+    assert(fd_buffereds[i] >= 0);
+    VOID_TEMP_FAILURE_RETRY(::close(fd_buffereds[i]));
+    fd_buffereds[i] = -1;
+  }
 
   path.clear();
 }
@@ -214,14 +257,14 @@ int KernelDevice::collect_metadata(string prefix, map<string,string> *pm) const
   }
 
   struct stat st;
-  int r = ::fstat(fd_buffered, &st);
+  int r = ::fstat(fd_buffereds[WRITE_LIFE_NOT_SET], &st);
   if (r < 0)
     return -errno;
   if (S_ISBLK(st.st_mode)) {
     (*pm)[prefix + "access_mode"] = "blk";
     char partition_path[PATH_MAX];
     char dev_node[PATH_MAX];
-    int rc = get_device_by_fd(fd_buffered, partition_path, dev_node, PATH_MAX);
+    int rc = get_device_by_fd(fd_buffereds[WRITE_LIFE_NOT_SET], partition_path, dev_node, PATH_MAX);
     switch (rc) {
     case -EOPNOTSUPP:
     case -EINVAL:
@@ -291,7 +334,7 @@ int KernelDevice::flush()
     _exit(1);
   }
   utime_t start = ceph_clock_now();
-  int r = ::fdatasync(fd_direct);
+  int r = ::fdatasync(fd_directs[WRITE_LIFE_NOT_SET]);
   utime_t end = ceph_clock_now();
   utime_t dur = end - start;
   if (r < 0) {
@@ -341,8 +384,12 @@ void KernelDevice::_aio_thread()
     dout(40) << __func__ << " polling" << dendl;
     int max = cct->_conf->bdev_aio_reap_max;
     aio_t *aio[max];
-    int r = aio_queue.get_next_completed(cct->_conf->bdev_aio_poll_ms,
-					 aio, max);
+    // in polled mode we spin on the completion ring instead of blocking
+    // in io_getevents; libaio peeks at the ring from userspace, so an
+    // empty poll costs no syscall.
+    int r = aio_queue.get_next_completed(
+      cct->_conf->bdev_aio_poll ? 0 : cct->_conf->bdev_aio_poll_ms,
+      aio, max);
     if (r < 0) {
       derr << __func__ << " got " << cpp_strerror(r) << dendl;
     }
@@ -522,7 +569,8 @@ void KernelDevice::aio_submit(IOContext *ioc)
   }
 }
 
-int KernelDevice::_sync_write(uint64_t off, bufferlist &bl, bool buffered)
+int KernelDevice::_sync_write(uint64_t off, bufferlist &bl, bool buffered,
+			      int write_hint)
 {
   uint64_t len = bl.length();
   dout(5) << __func__ << " 0x" << std::hex << off << "~" << len
@@ -536,7 +584,7 @@ int KernelDevice::_sync_write(uint64_t off, bufferlist &bl, bool buffered)
   }
   vector<iovec> iov;
   bl.prepare_iov(&iov);
-  int r = ::pwritev(buffered ? fd_buffered : fd_direct,
+  int r = ::pwritev(choose_fd(buffered, write_hint),
 		    &iov[0], iov.size(), off);
 
   if (r < 0) {
@@ -546,7 +594,8 @@ int KernelDevice::_sync_write(uint64_t off, bufferlist &bl, bool buffered)
   }
   if (buffered) {
     // initiate IO (but do not wait)
-    r = ::sync_file_range(fd_buffered, off, len, SYNC_FILE_RANGE_WRITE);
+    r = ::sync_file_range(choose_fd(true, write_hint), off, len,
+			  SYNC_FILE_RANGE_WRITE);
     if (r < 0) {
       r = -errno;
       derr << __func__ << " sync_file_range error: " << cpp_strerror(r) << dendl;
@@ -562,7 +611,8 @@ int KernelDevice::_sync_write(uint64_t off, bufferlist &bl, bool buffered)
 int KernelDevice::write(
   uint64_t off,
   bufferlist &bl,
-  bool buffered)
+  bool buffered,
+  int write_hint)
 {
   uint64_t len = bl.length();
   dout(20) << __func__ << " 0x" << std::hex << off << "~" << len << std::dec
@@ -582,14 +632,15 @@ int KernelDevice::write(
   bl.hexdump(*_dout);
   *_dout << dendl;
 
-  return _sync_write(off, bl, buffered);
+  return _sync_write(off, bl, buffered, write_hint);
 }
 
 int KernelDevice::aio_write(
   uint64_t off,
   bufferlist &bl,
   IOContext *ioc,
-  bool buffered)
+  bool buffered,
+  int write_hint)
 {
   uint64_t len = bl.length();
   dout(20) << __func__ << " 0x" << std::hex << off << "~" << len << std::dec
@@ -613,7 +664,7 @@ int KernelDevice::aio_write(
 
 #ifdef HAVE_LIBAIO
   if (aio && dio && !buffered) {
-    ioc->pending_aios.push_back(aio_t(ioc, fd_direct));
+    ioc->pending_aios.push_back(aio_t(ioc, choose_fd(false, write_hint)));
     ++ioc->num_pending;
     aio_t& aio = ioc->pending_aios.back();
     if (cct->_conf->bdev_inject_crash &&
@@ -639,7 +690,7 @@ int KernelDevice::aio_write(
   } else
 #endif
   {
-    int r = _sync_write(off, bl, buffered);
+    int r = _sync_write(off, bl, buffered, write_hint);
     _aio_log_finish(ioc, off, len);
     if (r < 0)
       return r;
@@ -663,7 +714,8 @@ int KernelDevice::read(uint64_t off, uint64_t len, bufferlist *pbl,
   _aio_log_start(ioc, off, len);
 
   bufferptr p = buffer::create_page_aligned(len);
-  int r = ::pread(buffered ? fd_buffered : fd_direct,
+  int r = ::pread(buffered ? fd_buffereds[WRITE_LIFE_NOT_SET]
+		  : fd_directs[WRITE_LIFE_NOT_SET],
 		  p.c_str(), len, off);
   if (r < 0) {
     r = -errno;
@@ -694,7 +746,7 @@ int KernelDevice::aio_read(
 #ifdef HAVE_LIBAIO
   if (aio && dio) {
     _aio_log_start(ioc, off, len);
-    ioc->pending_aios.push_back(aio_t(ioc, fd_direct));
+    ioc->pending_aios.push_back(aio_t(ioc, fd_directs[WRITE_LIFE_NOT_SET]));
     ++ioc->num_pending;
     aio_t& aio = ioc->pending_aios.back();
     aio.pread(off, len);
@@ -721,7 +773,7 @@ int KernelDevice::direct_read_unaligned(uint64_t off, uint64_t len, char *buf)
   bufferptr p = buffer::create_page_aligned(aligned_len);
   int r = 0;
 
-  r = ::pread(fd_direct, p.c_str(), aligned_len, aligned_off);
+  r = ::pread(fd_directs[WRITE_LIFE_NOT_SET], p.c_str(), aligned_len, aligned_off);
   if (r < 0) {
     r = -errno;
     derr << __func__ << " 0x" << std::hex << off << "~" << len << std::dec 
@@ -762,7 +814,7 @@ int KernelDevice::read_random(uint64_t off, uint64_t len, char *buf,
     char *t = buf;
     uint64_t left = len;
     while (left > 0) {
-      r = ::pread(fd_buffered, t, left, off);
+      r = ::pread(fd_buffereds[WRITE_LIFE_NOT_SET], t, left, off);
       if (r < 0) {
 	r = -errno;
         derr << __func__ << " 0x" << std::hex << off << "~" << left 
@@ -775,7 +827,7 @@ int KernelDevice::read_random(uint64_t off, uint64_t len, char *buf,
     }
   } else {
     //direct and aligned read
-    r = ::pread(fd_direct, buf, len, off);
+    r = ::pread(fd_directs[WRITE_LIFE_NOT_SET], buf, len, off);
     if (r < 0) {
       r = -errno;
       derr << __func__ << " direct_aligned_read" << " 0x" << std::hex 
@@ -802,7 +854,7 @@ int KernelDevice::invalidate_cache(uint64_t off, uint64_t len)
 	  << dendl;
   assert(off % block_size == 0);
   assert(len % block_size == 0);
-  int r = posix_fadvise(fd_buffered, off, len, POSIX_FADV_DONTNEED);
+  int r = posix_fadvise(fd_buffereds[WRITE_LIFE_NOT_SET], off, len, POSIX_FADV_DONTNEED);
   if (r) {
     r = -r;
     derr << __func__ << " 0x" << std::hex << off << "~" << len << std::dec
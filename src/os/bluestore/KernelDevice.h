@@ -16,6 +16,7 @@
 #define CEPH_OS_BLUESTORE_KERNELDEVICE_H
 
 #include <atomic>
+#include <vector>
 
 #include "os/fs/FS.h"
 #include "os/fs/aio.h"
@@ -24,7 +25,8 @@
 #include "BlockDevice.h"
 
 class KernelDevice : public BlockDevice {
-  int fd_direct, fd_buffered;
+  std::vector<int> fd_directs, fd_buffereds;
+  bool enable_wrt = true;
   uint64_t size;
   uint64_t block_size;
   std::string path;
@@ -60,7 +62,13 @@ class KernelDevice : public BlockDevice {
   void _aio_log_start(IOContext *ioc, uint64_t offset, uint64_t length);
   void _aio_log_finish(IOContext *ioc, uint64_t offset, uint64_t length);
 
-  int _sync_write(uint64_t off, bufferlist& bl, bool buffered);
+  int _sync_write(uint64_t off, bufferlist& bl, bool buffered, int write_hint);
+
+  int choose_fd(bool buffered, int write_hint) const {
+    if (!enable_wrt)
+      write_hint = WRITE_LIFE_NOT_SET;
+    return buffered ? fd_buffereds[write_hint] : fd_directs[write_hint];
+  }
 
   int _lock();
 
@@ -95,10 +103,12 @@ public:
 	       IOContext *ioc) override;
   int read_random(uint64_t off, uint64_t len, char *buf, bool buffered) override;
 
-  int write(uint64_t off, bufferlist& bl, bool buffered) override;
+  int write(uint64_t off, bufferlist& bl, bool buffered,
+	    int write_hint = WRITE_LIFE_NOT_SET) override;
   int aio_write(uint64_t off, bufferlist& bl,
 		IOContext *ioc,
-		bool buffered) override;
+		bool buffered,
+		int write_hint = WRITE_LIFE_NOT_SET) override;
   int flush() override;
 
   // for managing buffered readers/writers
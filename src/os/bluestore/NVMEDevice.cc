@@ -65,6 +65,7 @@ enum {
   l_bluestore_nvmedevice_read_queue_lat,
   l_bluestore_nvmedevice_flush_queue_lat,
   l_bluestore_nvmedevice_queue_ops,
+  l_bluestore_nvmedevice_qpair_depth,
   l_bluestore_nvmedevice_polling_lat,
   l_bluestore_nvmedevice_buffer_alloc_failed,
   l_bluestore_nvmedevice_last
@@ -147,6 +148,7 @@ class SharedDriverQueueData {
     b.add_time_avg(l_bluestore_nvmedevice_read_lat, "read_lat", "Average read completing latency");
     b.add_time_avg(l_bluestore_nvmedevice_flush_lat, "flush_lat", "Average flush completing latency");
     b.add_u64(l_bluestore_nvmedevice_queue_ops, "queue_ops", "Operations in nvme queue");
+    b.add_u64(l_bluestore_nvmedevice_qpair_depth, "qpair_depth", "Commands inflight on the nvme qpair");
     b.add_time_avg(l_bluestore_nvmedevice_polling_lat, "polling_lat", "Average polling latency");
     b.add_time_avg(l_bluestore_nvmedevice_aio_write_queue_lat, "aio_write_queue_lat", "Average queue write request latency");
     b.add_time_avg(l_bluestore_nvmedevice_read_queue_lat, "read_queue_lat", "Average queue read request latency");
@@ -460,7 +462,8 @@ void SharedDriverQueueData::_aio_thread()
   ceph::coarse_real_clock::time_point cur, start
     = ceph::coarse_real_clock::now();
   while (true) {
-    bool inflight = queue_op_seq.load() - completed_op_seq.load();
+    uint64_t inflight = queue_op_seq.load() - completed_op_seq.load();
+    logger->set(l_bluestore_nvmedevice_qpair_depth, inflight);
  again:
     dout(40) << __func__ << " polling" << dendl;
     if (inflight) {
@@ -975,8 +978,8 @@ void NVMEDevice::aio_submit(IOContext *ioc)
     ioc->num_pending -= pending;
     assert(ioc->num_pending.load() == 0);  // we should be only thread doing this
     // Only need to push the first entry
-  if(queue_id == -1)
-    queue_id = ceph_gettid();
+    if (queue_id == -1)
+      queue_id = ceph_gettid();
     driver->get_queue(queue_id)->queue_task(t, pending);
     ioc->nvme_task_first = ioc->nvme_task_last = nullptr;
   }
@@ -986,7 +989,8 @@ int NVMEDevice::aio_write(
     uint64_t off,
     bufferlist &bl,
     IOContext *ioc,
-    bool buffered)
+    bool buffered,
+    int write_hint)
 {
   uint64_t len = bl.length();
   dout(20) << __func__ << " " << off << "~" << len << " ioc " << ioc
@@ -1025,7 +1029,8 @@ int NVMEDevice::aio_write(
   return 0;
 }
 
-int NVMEDevice::write(uint64_t off, bufferlist &bl, bool buffered)
+int NVMEDevice::write(uint64_t off, bufferlist &bl, bool buffered,
+		      int write_hint)
 {
   // FIXME: there is presumably a more efficient way to do this...
   IOContext ioc(cct, NULL);
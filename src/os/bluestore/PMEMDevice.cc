@@ -102,6 +102,13 @@ int PMEMDevice::open(const string& p)
   }
   size = map_len;
 
+  // BlockDevice defaults to rotational and we never probe sysfs here;
+  // left unset, bluestore applies its hdd tuning (notably
+  // bluestore_prefer_deferred_size_hdd) and round-trips every small
+  // write through the kv wal before the pmem_memcpy_persist, instead
+  // of the ssd profile's direct single copy.
+  rotational = false;
+
   // Operate as though the block size is 4 KB.  The backing file
   // blksize doesn't strictly matter except that some file systems may
   // require a read/modify/write if we write something smaller than
@@ -214,7 +221,8 @@ void PMEMDevice::aio_submit(IOContext *ioc)
   return;
 }
 
-int PMEMDevice::write(uint64_t off, bufferlist& bl, bool buffered)
+int PMEMDevice::write(uint64_t off, bufferlist& bl, bool buffered,
+		      int write_hint)
 {
   uint64_t len = bl.length();
   dout(20) << __func__ << " " << off << "~" << len  << dendl;
@@ -251,9 +259,10 @@ int PMEMDevice::aio_write(
   uint64_t off,
   bufferlist &bl,
   IOContext *ioc,
-  bool buffered)
+  bool buffered,
+  int write_hint)
 {
-  return write(off, bl, buffered);
+  return write(off, bl, buffered, write_hint);
 }
 
 
@@ -2,6 +2,11 @@
 
 #include "JournalingObjectStore.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include "common/errno.h"
 #include "common/debug.h"
 
@@ -67,11 +72,52 @@ int JournalingObjectStore::journal_replay(uint64_t fs_op_seq)
 
   replaying = true;
 
+  // read and checksum-validate entries in a separate thread so journal
+  // io and crc verification overlap with transaction apply; entries are
+  // handed over (and applied) in the order they appear in the journal.
+  std::deque<std::pair<uint64_t, bufferlist> > readq;
+  std::mutex readq_lock;
+  std::condition_variable readq_put, readq_get;
+  bool read_done = false;
+  const uint64_t readahead = cct->_conf->journal_replay_readahead;
+  std::thread reader;
+  if (readahead) {
+    reader = std::thread([&] {
+	uint64_t expect_seq = op_seq + 1;
+	while (true) {
+	  bufferlist bl;
+	  uint64_t seq = expect_seq;
+	  if (!journal->read_entry(bl, seq)) {
+	    break;
+	  }
+	  expect_seq = seq + 1;
+	  std::unique_lock<std::mutex> l(readq_lock);
+	  readq_put.wait(l, [&] { return readq.size() < readahead; });
+	  readq.emplace_back(seq, std::move(bl));
+	  readq_get.notify_one();
+	}
+	std::unique_lock<std::mutex> l(readq_lock);
+	read_done = true;
+	readq_get.notify_one();
+      });
+  }
+
   int count = 0;
   while (1) {
     bufferlist bl;
     uint64_t seq = op_seq + 1;
-    if (!journal->read_entry(bl, seq)) {
+    if (readahead) {
+      std::unique_lock<std::mutex> l(readq_lock);
+      readq_get.wait(l, [&] { return !readq.empty() || read_done; });
+      if (readq.empty()) {
+	dout(3) << "journal_replay: end of journal, done." << dendl;
+	break;
+      }
+      seq = readq.front().first;
+      bl = std::move(readq.front().second);
+      readq.pop_front();
+      readq_put.notify_one();
+    } else if (!journal->read_entry(bl, seq)) {
       dout(3) << "journal_replay: end of journal, done." << dendl;
       break;
     }
@@ -99,6 +145,10 @@ int JournalingObjectStore::journal_replay(uint64_t fs_op_seq)
     dout(3) << "journal_replay: r = " << r << ", op_seq now " << op_seq << dendl;
   }
 
+  if (reader.joinable()) {
+    reader.join();
+  }
+
   if (count)
     dout(3) << "journal_replay: total = " << count << dendl;
 
@@ -4,9 +4,11 @@
 #include "acconfig.h"
 
 #include "os/filestore/WBThrottle.h"
+#include "common/Clock.h"
 #include "common/perf_counters.h"
 
 WBThrottle::WBThrottle(CephContext *cct) :
+  limit_scale(1.0), flush_lat_ewma(0),
   cur_ios(0), cur_size(0),
   cct(cct),
   logger(NULL),
@@ -28,10 +30,14 @@ WBThrottle::WBThrottle(CephContext *cct) :
   b.add_u64(l_wbthrottle_ios_wb, "ios_wb", "Written operations");
   b.add_u64(l_wbthrottle_inodes_dirtied, "inodes_dirtied", "Entries waiting for write");
   b.add_u64(l_wbthrottle_inodes_wb, "inodes_wb", "Written entries");
+  b.add_time_avg(l_wbthrottle_flush_lat, "flush_lat", "Per-inode flush latency");
+  b.add_u64(l_wbthrottle_limit_scale, "limit_scale",
+	    "Feedback scale applied to the configured limits, in percent");
   logger = b.create_perf_counters();
   cct->get_perfcounters_collection()->add(logger);
   for (unsigned i = l_wbthrottle_first + 1; i != l_wbthrottle_last; ++i)
     logger->set(i, 0);
+  logger->set(l_wbthrottle_limit_scale, 100);
 
   cct->_conf->add_observer(this);
 }
@@ -78,6 +84,8 @@ const char** WBThrottle::get_tracked_conf_keys() const
     "filestore_wbthrottle_xfs_ios_hard_limit",
     "filestore_wbthrottle_xfs_inodes_start_flusher",
     "filestore_wbthrottle_xfs_inodes_hard_limit",
+    "filestore_wbthrottle_adaptive",
+    "filestore_wbthrottle_adaptive_target_lat",
     NULL
   };
   return KEYS;
@@ -87,37 +95,81 @@ void WBThrottle::set_from_conf()
 {
   assert(lock.is_locked());
   if (fs == BTRFS) {
-    size_limits.first =
+    size_limits_base.first =
       cct->_conf->filestore_wbthrottle_btrfs_bytes_start_flusher;
-    size_limits.second =
+    size_limits_base.second =
       cct->_conf->filestore_wbthrottle_btrfs_bytes_hard_limit;
-    io_limits.first =
+    io_limits_base.first =
       cct->_conf->filestore_wbthrottle_btrfs_ios_start_flusher;
-    io_limits.second =
+    io_limits_base.second =
       cct->_conf->filestore_wbthrottle_btrfs_ios_hard_limit;
-    fd_limits.first =
+    fd_limits_base.first =
       cct->_conf->filestore_wbthrottle_btrfs_inodes_start_flusher;
-    fd_limits.second =
+    fd_limits_base.second =
       cct->_conf->filestore_wbthrottle_btrfs_inodes_hard_limit;
   } else if (fs == XFS) {
-    size_limits.first =
+    size_limits_base.first =
       cct->_conf->filestore_wbthrottle_xfs_bytes_start_flusher;
-    size_limits.second =
+    size_limits_base.second =
       cct->_conf->filestore_wbthrottle_xfs_bytes_hard_limit;
-    io_limits.first =
+    io_limits_base.first =
       cct->_conf->filestore_wbthrottle_xfs_ios_start_flusher;
-    io_limits.second =
+    io_limits_base.second =
       cct->_conf->filestore_wbthrottle_xfs_ios_hard_limit;
-    fd_limits.first =
+    fd_limits_base.first =
       cct->_conf->filestore_wbthrottle_xfs_inodes_start_flusher;
-    fd_limits.second =
+    fd_limits_base.second =
       cct->_conf->filestore_wbthrottle_xfs_inodes_hard_limit;
   } else {
     assert(0 == "invalid value for fs");
   }
+  if (!cct->_conf->filestore_wbthrottle_adaptive) {
+    limit_scale = 1.0;
+    logger->set(l_wbthrottle_limit_scale, 100);
+  }
+  _update_limits();
   cond.Signal();
 }
 
+void WBThrottle::_update_limits()
+{
+  assert(lock.is_locked());
+  size_limits.first = MAX((uint64_t)1, (uint64_t)(size_limits_base.first * limit_scale));
+  size_limits.second = MAX(size_limits.first,
+			   (uint64_t)(size_limits_base.second * limit_scale));
+  io_limits.first = MAX((uint64_t)1, (uint64_t)(io_limits_base.first * limit_scale));
+  io_limits.second = MAX(io_limits.first,
+			 (uint64_t)(io_limits_base.second * limit_scale));
+  fd_limits.first = MAX((uint64_t)1, (uint64_t)(fd_limits_base.first * limit_scale));
+  fd_limits.second = MAX(fd_limits.first,
+			 (uint64_t)(fd_limits_base.second * limit_scale));
+}
+
+void WBThrottle::_adjust_limits(double flush_lat)
+{
+  assert(lock.is_locked());
+  // feedback controller: hold the smoothed per-inode flush latency near
+  // the target by scaling the configured limits.  A slow device sees its
+  // allowed backlog shrink multiplicatively (so writers block earlier and
+  // the flusher keeps the queue short); a fast device creeps back up
+  // additively until the configured limits are reached.
+  double target = cct->_conf->filestore_wbthrottle_adaptive_target_lat;
+  if (target <= 0)
+    return;
+  flush_lat_ewma = 0.9 * flush_lat_ewma + 0.1 * flush_lat;
+  double old_scale = limit_scale;
+  if (flush_lat_ewma > target) {
+    limit_scale = MAX(0.01, limit_scale * 0.9);
+  } else if (flush_lat_ewma < target / 2) {
+    limit_scale = MIN(1.0, limit_scale + 0.02);
+  }
+  if (limit_scale != old_scale) {
+    _update_limits();
+    logger->set(l_wbthrottle_limit_scale, (uint64_t)(limit_scale * 100));
+    cond.Signal();
+  }
+}
+
 void WBThrottle::handle_conf_change(const md_config_t *conf,
 				    const std::set<std::string> &changed)
 {
@@ -165,11 +217,13 @@ void *WBThrottle::entry()
     logger->dec(l_wbthrottle_inodes_dirtied);
     logger->inc(l_wbthrottle_inodes_wb);
     lock.Unlock();
+    utime_t start = ceph_clock_now();
 #ifdef HAVE_FDATASYNC
     ::fdatasync(**wb.get<1>());
 #else
     ::fsync(**wb.get<1>());
 #endif
+    utime_t lat = ceph_clock_now() - start;
 #ifdef HAVE_POSIX_FADVISE
     if (cct->_conf->filestore_fadvise && wb.get<2>().nocache) {
       int fa_r = posix_fadvise(**wb.get<1>(), 0, 0, POSIX_FADV_DONTNEED);
@@ -177,6 +231,9 @@ void *WBThrottle::entry()
     }
 #endif
     lock.Lock();
+    logger->tinc(l_wbthrottle_flush_lat, lat);
+    if (cct->_conf->filestore_wbthrottle_adaptive)
+      _adjust_limits(lat);
     clearing = ghobject_t();
     cond.Signal();
     wb = boost::tuple<ghobject_t, FDRef, PendingWB>();
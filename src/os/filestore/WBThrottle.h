@@ -34,6 +34,8 @@ enum {
   l_wbthrottle_ios_wb,
   l_wbthrottle_inodes_dirtied,
   l_wbthrottle_inodes_wb,
+  l_wbthrottle_flush_lat,
+  l_wbthrottle_limit_scale,
   l_wbthrottle_last
 };
 
@@ -57,6 +59,14 @@ class WBThrottle : Thread, public md_config_obs_t {
   /// Limits on unflushed objects
   pair<uint64_t, uint64_t> fd_limits;
 
+  /// unscaled limits as configured, see _adjust_limits()
+  pair<uint64_t, uint64_t> size_limits_base;
+  pair<uint64_t, uint64_t> io_limits_base;
+  pair<uint64_t, uint64_t> fd_limits_base;
+
+  double limit_scale;     ///< feedback scale applied to the base limits
+  double flush_lat_ewma;  ///< smoothed per-inode flush latency (seconds)
+
   uint64_t cur_ios;  /// Currently unflushed IOs
   uint64_t cur_size; /// Currently unflushed bytes
 
@@ -128,6 +138,8 @@ private:
   FS fs;
 
   void set_from_conf();
+  void _update_limits();
+  void _adjust_limits(double flush_lat);
   bool beyond_limit() const {
     if (cur_ios < io_limits.first &&
 	pending_wbs.size() < fd_limits.first &&
@@ -71,7 +71,9 @@ int aio_queue_t::get_next_completed(int timeout_ms, aio_t **paio, int max)
 
   int r = 0;
   do {
-    r = io_getevents(ctx, 1, max, event, &t);
+    // a zero timeout means a pure poll: don't block for a minimum of
+    // one event, just reap whatever is already in the ring.
+    r = io_getevents(ctx, timeout_ms ? 1 : 0, max, event, &t);
   } while (r == -EINTR);
 
   for (int i=0; i<r; ++i) {
@@ -88,6 +88,7 @@ static ostream &operator<<(
 ostream &operator<<(ostream &lhs, const ECBackend::read_request_t &rhs)
 {
   return lhs << "read_request_t(to_read=[" << rhs.to_read << "]"
+	     << ", want_to_read=" << rhs.want_to_read
 	     << ", need=" << rhs.need
 	     << ", want_attrs=" << rhs.want_attrs
 	     << ")";
@@ -254,6 +255,7 @@ struct RecoveryMessages {
   void read(
     ECBackend *ec,
     const hobject_t &hoid, uint64_t off, uint64_t len,
+    const set<int> &want,
     const set<pg_shard_t> &need,
     bool attrs) {
     list<boost::tuple<uint64_t, uint64_t, uint32_t> > to_read;
@@ -264,6 +266,7 @@ struct RecoveryMessages {
 	hoid,
 	ECBackend::read_request_t(
 	  to_read,
+	  want,
 	  need,
 	  attrs,
 	  new OnRecoveryReadComplete(
@@ -566,6 +569,7 @@ void ECBackend::continue_recovery_op(
 	op.hoid,
 	op.recovery_progress.data_recovered_to,
 	amount,
+	want,
 	to_read,
 	op.recovery_progress.first && !op.obc);
       op.extent_requested = make_pair(
@@ -1198,7 +1202,15 @@ void ECBackend::handle_sub_read_reply(
         dout(20) << __func__ << " have shard=" << j->first.shard << dendl;
       }
       set<int> want_to_read, dummy_minimum;
-      get_want_to_read_shards(&want_to_read);
+      map<hobject_t, read_request_t>::const_iterator req_iter =
+	rop.to_read.find(iter->first);
+      if (req_iter != rop.to_read.end()) {
+	want_to_read = req_iter->second.want_to_read;
+      } else {
+	// @see send_all_remaining_reads; the re-read dropped the
+	// other objects from to_read
+	get_want_to_read_shards(&want_to_read);
+      }
       int err;
       if ((err = ec_impl->minimum_to_decode(want_to_read, have, &dummy_minimum)) < 0) {
 	dout(20) << __func__ << " minimum_to_decode failed" << dendl;
@@ -1548,7 +1560,26 @@ int ECBackend::get_min_avail_to_read_shards(
   }
 
   set<int> need;
-  int r = ec_impl->minimum_to_decode(want, have, &need);
+  int r;
+  if (cct->_conf->osd_ec_cost_aware_reads) {
+    // weight each available shard by the crush distance between its
+    // OSD and us so the planner prefers recovery sets that stay close
+    // by; with no crush_location configured every shard gets the same
+    // cost and planning degrades to plain minimum_to_decode
+    const multimap<string,string> loc = cct->crush_location.get_location();
+    OSDMapRef osdmap = get_osdmap();
+    map<int, int> cost;
+    for (map<shard_id_t, pg_shard_t>::const_iterator i = shards.begin();
+	 i != shards.end();
+	 ++i) {
+      int d = osdmap->crush->get_common_ancestor_distance(
+	cct, i->second.osd, loc);
+      cost[static_cast<int>(i->first)] = (d >= 0 ? d : INT_MAX);
+    }
+    r = ec_impl->minimum_to_decode_with_cost(want, cost, &need);
+  } else {
+    r = ec_impl->minimum_to_decode(want, have, &need);
+  }
   if (r < 0)
     return r;
 
@@ -2078,6 +2109,15 @@ int ECBackend::objects_read_sync(
   return -EOPNOTSUPP;
 }
 
+int ECBackend::objects_readv_sync(
+  const hobject_t &hoid,
+  map<uint64_t, uint64_t>& m,
+  uint32_t op_flags,
+  bufferlist *bl)
+{
+  return -EOPNOTSUPP;
+}
+
 void ECBackend::objects_read_async(
   const hobject_t &hoid,
   const list<pair<boost::tuple<uint64_t, uint64_t, uint32_t>,
@@ -2090,6 +2130,7 @@ void ECBackend::objects_read_async(
 
   uint32_t flags = 0;
   extent_set es;
+  set<int> chunks;
   for (list<pair<boost::tuple<uint64_t, uint64_t, uint32_t>,
 	 pair<bufferlist*, Context*> > >::const_iterator i =
 	 to_read.begin();
@@ -2103,8 +2144,14 @@ void ECBackend::objects_read_async(
     esnew.insert(tmp.first, tmp.second);
     es.union_of(esnew);
     flags |= i->first.get<2>();
+    // the data chunks the unaligned ranges actually cover; the
+    // stripe bounded extents above always cover all of them
+    if (i->first.get<1>() > 0)
+      sinfo.offset_len_to_data_chunk_indices(
+	i->first.get<0>(), i->first.get<1>(), &chunks);
   }
 
+  map<hobject_t, set<int> > want_chunks;
   if (!es.empty()) {
     auto &offsets = reads[hoid];
     for (auto j = es.begin();
@@ -2116,6 +2163,7 @@ void ECBackend::objects_read_async(
 	  j.get_len(),
 	  flags));
     }
+    want_chunks[hoid].swap(chunks);
   }
 
   struct cb {
@@ -2186,6 +2234,7 @@ void ECBackend::objects_read_async(
   };
   objects_read_and_reconstruct(
     reads,
+    want_chunks,
     fast_read,
     make_gen_lambda_context<
       map<hobject_t,pair<int, extent_map> > &&, cb>(
@@ -2229,6 +2278,37 @@ struct CallClientContexts :
 	   ++j) {
 	to_decode[j->first.shard].claim(j->second);
       }
+      if (to_decode.size() < ec->ec_impl->get_data_chunk_count()) {
+	// partial read: only the data chunks covering this extent were
+	// fetched, so place each chunk at its logical offset instead of
+	// reassembling whole stripes
+	const vector<int> &chunk_mapping = ec->ec_impl->get_chunk_mapping();
+	const uint64_t chunk_size = ec->sinfo.get_chunk_size();
+	for (int i = 0; i < (int)ec->ec_impl->get_data_chunk_count(); ++i) {
+	  int chunk = (int)chunk_mapping.size() > i ? chunk_mapping[i] : i;
+	  map<int, bufferlist>::iterator p = to_decode.find(chunk);
+	  if (p == to_decode.end())
+	    continue;
+	  for (uint64_t off = 0; off < p->second.length();
+	       off += chunk_size) {
+	    uint64_t logical = adjusted.first +
+	      (off / chunk_size) * ec->sinfo.get_stripe_width() +
+	      i * chunk_size;
+	    uint64_t piece_len = MIN(chunk_size, p->second.length() - off);
+	    // clip to the extent the caller asked for
+	    uint64_t start = MAX(logical, read.get<0>());
+	    uint64_t end = MIN(logical + piece_len,
+			       read.get<0>() + read.get<1>());
+	    if (start >= end)
+	      continue;
+	    bufferlist piece;
+	    piece.substr_of(p->second, off + (start - logical), end - start);
+	    result.insert(start, piece.length(), std::move(piece));
+	  }
+	}
+	res.returned.pop_front();
+	continue;
+      }
       int r = ECUtil::decode(
 	ec->sinfo,
 	ec->ec_impl,
@@ -2258,6 +2338,7 @@ void ECBackend::objects_read_and_reconstruct(
   const map<hobject_t,
     std::list<boost::tuple<uint64_t, uint64_t, uint32_t> >
   > &reads,
+  const map<hobject_t, set<int> > &want_chunks,
   bool fast_read,
   GenContextURef<map<hobject_t,pair<int, extent_map> > &&> &&func)
 {
@@ -2268,11 +2349,30 @@ void ECBackend::objects_read_and_reconstruct(
     return;
   }
 
-  set<int> want_to_read;
-  get_want_to_read_shards(&want_to_read);
-    
+  set<int> want_to_read_all;
+  get_want_to_read_shards(&want_to_read_all);
+
   map<hobject_t, read_request_t> for_read_op;
   for (auto &&to_read: reads) {
+    set<int> want_to_read;
+    map<hobject_t, set<int> >::const_iterator witer =
+      want_chunks.find(to_read.first);
+    if (cct->_conf->osd_ec_partial_reads &&
+	!fast_read &&
+	witer != want_chunks.end() &&
+	!witer->second.empty() &&
+	witer->second.size() < ec_impl->get_data_chunk_count()) {
+      // sub-stripe read: only fetch the data chunks covering the
+      // requested ranges instead of reconstructing whole stripes
+      const vector<int> &chunk_mapping = ec_impl->get_chunk_mapping();
+      for (int i : witer->second) {
+	int chunk = (int)chunk_mapping.size() > i ? chunk_mapping[i] : i;
+	want_to_read.insert(chunk);
+      }
+    } else {
+      want_to_read = want_to_read_all;
+    }
+
     set<pg_shard_t> shards;
     int r = get_min_avail_to_read_shards(
       to_read.first,
@@ -2292,6 +2392,7 @@ void ECBackend::objects_read_and_reconstruct(
 	to_read.first,
 	read_request_t(
 	  to_read.second,
+	  want_to_read,
 	  shards,
 	  false,
 	  c)));
@@ -2327,6 +2428,7 @@ int ECBackend::send_all_remaining_reads(
   // TODOSAM: this doesn't seem right
   list<boost::tuple<uint64_t, uint64_t, uint32_t> > offsets =
     rop.to_read.find(hoid)->second.to_read;
+  set<int> want_to_read = rop.to_read.find(hoid)->second.want_to_read;
   GenContext<pair<RecoveryMessages *, read_result_t& > &> *c =
     rop.to_read.find(hoid)->second.cb;
 
@@ -2336,6 +2438,7 @@ int ECBackend::send_all_remaining_reads(
       hoid,
       read_request_t(
 	offsets,
+	want_to_read,
 	shards,
 	false,
 	c)));
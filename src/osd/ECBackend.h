@@ -127,6 +127,12 @@ public:
     uint32_t op_flags,
     bufferlist *bl) override;
 
+  int objects_readv_sync(
+    const hobject_t &hoid,
+    map<uint64_t, uint64_t>& m,
+    uint32_t op_flags,
+    bufferlist *bl) override;
+
   /**
    * Async read mechanism
    *
@@ -144,10 +150,19 @@ public:
    * still only perform a client read from shards in the acting set.  This
    * ensures that we won't ever have to restart a client initiated read in
    * check_recovery_sources.
+   *
+   * When a read covers only some of the data chunks of its stripes, we
+   * can fetch just those chunks (@see osd_ec_partial_reads) rather than
+   * reconstructing whole stripes from every data shard.  want_chunks
+   * carries the logical data chunk indices the caller's unaligned
+   * extents actually touch; if a wanted shard turns out to be
+   * unavailable or returns an error we fall back to reading enough
+   * shards to decode as before.
    */
   void objects_read_and_reconstruct(
     const map<hobject_t, std::list<boost::tuple<uint64_t, uint64_t, uint32_t> >
     > &reads,
+    const map<hobject_t, set<int> > &want_chunks,
     bool fast_read,
     GenContextURef<map<hobject_t,pair<int, extent_map> > &&> &&func);
 
@@ -197,6 +212,7 @@ public:
     }
     objects_read_and_reconstruct(
       _to_read,
+      map<hobject_t, set<int> >(),
       false,
       make_gen_lambda_context<
       map<hobject_t,pair<int, extent_map> > &&, Func>(
@@ -354,16 +370,18 @@ public:
   };
   struct read_request_t {
     const list<boost::tuple<uint64_t, uint64_t, uint32_t> > to_read;
+    const set<int> want_to_read;
     const set<pg_shard_t> need;
     const bool want_attrs;
     GenContext<pair<RecoveryMessages *, read_result_t& > &> *cb;
     read_request_t(
       const list<boost::tuple<uint64_t, uint64_t, uint32_t> > &to_read,
+      const set<int> &want_to_read,
       const set<pg_shard_t> &need,
       bool want_attrs,
       GenContext<pair<RecoveryMessages *, read_result_t& > &> *cb)
-      : to_read(to_read), need(need), want_attrs(want_attrs),
-	cb(cb) {}
+      : to_read(to_read), want_to_read(want_to_read), need(need),
+	want_attrs(want_attrs), cb(cb) {}
   };
   friend ostream &operator<<(ostream &lhs, const read_request_t &rhs);
 
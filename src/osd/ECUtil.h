@@ -81,6 +81,20 @@ public:
       (in.first - off) + in.second);
     return std::make_pair(off, len);
   }
+  void offset_len_to_data_chunk_indices(
+    uint64_t off, uint64_t len, std::set<int> *indices) const {
+    const uint64_t data_chunk_count = stripe_width / chunk_size;
+    assert(len > 0);
+    const uint64_t first_chunk = off / chunk_size;
+    const uint64_t last_chunk = (off + len + chunk_size - 1) / chunk_size;
+    if (last_chunk - first_chunk >= data_chunk_count) {
+      for (uint64_t i = 0; i < data_chunk_count; ++i)
+	indices->insert((int)i);
+      return;
+    }
+    for (uint64_t i = first_chunk; i < last_chunk; ++i)
+      indices->insert((int)(i % data_chunk_count));
+  }
 };
 
 int decode(
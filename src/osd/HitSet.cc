@@ -250,3 +250,26 @@ void BloomHitSet::dump(Formatter *f) const {
   bloom.dump(f);
   f->close_section();
 }
+
+void ReadFreqSketch::dump(Formatter *f) const {
+  f->dump_unsigned("width", width);
+  f->dump_unsigned("depth", DEPTH);
+  f->dump_unsigned("inserts", inserts);
+
+  // histogram of first-row counter values by power of two; the shape
+  // of the non-zero buckets approximates the heat skew across objects
+  std::map<unsigned, unsigned> hist;
+  for (unsigned i = 0; i < width; ++i) {
+    hist[cbits((unsigned)counters[i])]++;
+  }
+  f->open_array_section("counter_histogram");
+  for (std::map<unsigned, unsigned>::iterator p = hist.begin();
+       p != hist.end();
+       ++p) {
+    f->open_object_section("bucket");
+    f->dump_unsigned("count_log2", p->first);
+    f->dump_unsigned("counters", p->second);
+    f->close_section();
+  }
+  f->close_section();
+}
@@ -15,9 +15,14 @@
 #ifndef CEPH_OSD_HITSET_H
 #define CEPH_OSD_HITSET_H
 
+#include <limits>
+#include <vector>
+
 #include <boost/scoped_ptr.hpp>
 
+#include "include/ceph_hash.h"
 #include "include/encoding.h"
+#include "include/intarith.h"
 #include "include/unordered_set.h"
 #include "common/bloom_filter.hpp"
 #include "common/hobject.h"
@@ -450,4 +455,57 @@ public:
 };
 WRITE_CLASS_ENCODER(BloomHitSet)
 
+/**
+ * ReadFreqSketch
+ *
+ * HitSets record whether an object was touched during an interval;
+ * this companion structure records approximately how often, via a
+ * small count-min sketch.  decay() halves every counter and is invoked
+ * once per hit set interval, so estimates age exponentially.  It is
+ * primary-side in-memory state only -- like the rest of the tier
+ * agent state it starts cold after peering.
+ */
+class ReadFreqSketch {
+  static const unsigned DEPTH = 4;
+  unsigned width;
+  std::vector<uint16_t> counters;  ///< DEPTH rows of width counters
+  uint64_t inserts = 0;
+
+  unsigned index(uint32_t hash, unsigned row) const {
+    uint32_t v[2] = { hash, (uint32_t)(row + 1) * 0x9e3779b9u };
+    return (ceph_str_hash_rjenkins((const char *)v, sizeof(v)) % width) +
+      row * width;
+  }
+
+public:
+  explicit ReadFreqSketch(unsigned w)
+    : width(MAX(w, 128u)), counters(width * DEPTH, 0) {}
+
+  void insert(uint32_t hash) {
+    ++inserts;
+    for (unsigned d = 0; d < DEPTH; ++d) {
+      uint16_t& c = counters[index(hash, d)];
+      if (c < std::numeric_limits<uint16_t>::max())
+	++c;
+    }
+  }
+
+  /// estimated hit count since roughly the last few decay() calls;
+  /// never under-counts, may over-count on collisions
+  uint32_t estimate(uint32_t hash) const {
+    uint32_t est = std::numeric_limits<uint32_t>::max();
+    for (unsigned d = 0; d < DEPTH; ++d)
+      est = MIN(est, (uint32_t)counters[index(hash, d)]);
+    return est;
+  }
+
+  /// exponential aging
+  void decay() {
+    for (auto& c : counters)
+      c >>= 1;
+  }
+
+  void dump(Formatter *f) const;
+};
+
 #endif
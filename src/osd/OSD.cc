@@ -136,6 +136,9 @@
 
 #include "objclass/objclass.h"
 
+#include "erasure-code/ErasureCode.h"
+#include "erasure-code/ErasureCodePlugin.h"
+
 #include "common/cmdparse.h"
 #include "include/str_list.h"
 #include "include/util.h"
@@ -1454,6 +1457,31 @@ bool OSDService::_get_map_bl(epoch_t e, bufferlist& bl)
   return found;
 }
 
+bool OSDService::get_map_bl(epoch_t e, bufferlist& bl)
+{
+  {
+    Mutex::Locker l(map_cache_lock);
+    if (map_bl_cache.lookup(e, &bl)) {
+      if (logger)
+	logger->inc(l_osd_map_bl_cache_hit);
+      return true;
+    }
+    if (logger)
+      logger->inc(l_osd_map_bl_cache_miss);
+  }
+  // do the store read with map_cache_lock dropped so that concurrent
+  // readers (e.g. the peering threads advancing many PGs through a
+  // backlog of maps on boot) do not serialize on the object store
+  bool found = store->read(coll_t::meta(),
+			   OSD::get_osdmap_pobject_name(e), 0, 0, bl,
+			   CEPH_OSD_OP_FLAG_FADVISE_WILLNEED) >= 0;
+  if (found) {
+    Mutex::Locker l(map_cache_lock);
+    _add_map_bl(e, bl);
+  }
+  return found;
+}
+
 bool OSDService::get_inc_map_bl(epoch_t e, bufferlist& bl)
 {
   Mutex::Locker l(map_cache_lock);
@@ -1544,30 +1572,37 @@ OSDMapRef OSDService::_add_map(OSDMap *o)
 
 OSDMapRef OSDService::try_get_map(epoch_t epoch)
 {
-  Mutex::Locker l(map_cache_lock);
-  OSDMapRef retval = map_cache.lookup(epoch);
-  if (retval) {
-    dout(30) << "get_map " << epoch << " -cached" << dendl;
-    if (logger) {
-      logger->inc(l_osd_map_cache_hit);
+  {
+    Mutex::Locker l(map_cache_lock);
+    OSDMapRef retval = map_cache.lookup(epoch);
+    if (retval) {
+      dout(30) << "get_map " << epoch << " -cached" << dendl;
+      if (logger) {
+	logger->inc(l_osd_map_cache_hit);
+      }
+      return retval;
     }
-    return retval;
-  }
-  if (logger) {
-    logger->inc(l_osd_map_cache_miss);
-    epoch_t lb = map_cache.cached_key_lower_bound();
-    if (epoch < lb) {
-      dout(30) << "get_map " << epoch << " - miss, below lower bound" << dendl;
-      logger->inc(l_osd_map_cache_miss_low);
-      logger->inc(l_osd_map_cache_miss_low_avg, lb - epoch);
+    if (logger) {
+      logger->inc(l_osd_map_cache_miss);
+      epoch_t lb = map_cache.cached_key_lower_bound();
+      if (epoch < lb) {
+	dout(30) << "get_map " << epoch << " - miss, below lower bound" << dendl;
+	logger->inc(l_osd_map_cache_miss_low);
+	logger->inc(l_osd_map_cache_miss_low_avg, lb - epoch);
+      }
     }
   }
 
+  // load and decode outside map_cache_lock; decoding a large map is
+  // expensive and holding the lock here would serialize the peering
+  // threads, which all walk the same range of maps during boot.  if
+  // several threads race to decode the same epoch, _add_map() keeps
+  // whichever copy lands in the cache first and the losers are freed.
   OSDMap *map = new OSDMap;
   if (epoch > 0) {
     dout(20) << "get_map " << epoch << " - loading and decoding " << map << dendl;
     bufferlist bl;
-    if (!_get_map_bl(epoch, bl) || bl.length() == 0) {
+    if (!get_map_bl(epoch, bl) || bl.length() == 0) {
       derr << "failed to load OSD map for epoch " << epoch << ", got " << bl.length() << " bytes" << dendl;
       delete map;
       return OSDMapRef();
@@ -1576,7 +1611,7 @@ OSDMapRef OSDService::try_get_map(epoch_t epoch)
   } else {
     dout(20) << "get_map " << epoch << " - return initial " << map << dendl;
   }
-  return _add_map(map);
+  return add_map(map);
 }
 
 // ops
@@ -2134,6 +2169,10 @@ bool OSD::asok_command(string admin_command, cmdmap_t& cmdmap, string format,
     service.remote_reserver.dump(f);
     f->close_section();
     f->close_section();
+  } else if (admin_command == "dump_osd_network") {
+    int64_t value = 0;
+    cmd_getval(cct, cmdmap, "value", value);
+    dump_osd_network(f, value);
   } else if (admin_command == "get_latest_osdmap") {
     get_latest_osdmap();
   } else if (admin_command == "heap") {
@@ -2209,6 +2248,87 @@ bool OSD::asok_command(string admin_command, cmdmap_t& cmdmap, string format,
       pg->unlock();
     }
     f->close_section();
+  } else if (admin_command == "dump_object_heat") {
+    f->open_object_section("object_heat");
+    RWLock::RLocker l2(pg_map_lock);
+    for (ceph::unordered_map<spg_t,PG*>::iterator it = pg_map.begin();
+        it != pg_map.end();
+        ++it) {
+      PG *pg = it->second;
+      pg->lock();
+      pg->dump_object_heat(f);
+      pg->unlock();
+    }
+    f->close_section();
+  } else if (admin_command == "ec_bench") {
+    string plugin = "jerasure";
+    string technique;
+    int64_t k = 2;
+    int64_t m = 1;
+    int64_t size = 4194304;
+    int64_t iterations = 16;
+    cmd_getval(cct, cmdmap, "plugin", plugin);
+    cmd_getval(cct, cmdmap, "technique", technique);
+    cmd_getval(cct, cmdmap, "k", k);
+    cmd_getval(cct, cmdmap, "m", m);
+    cmd_getval(cct, cmdmap, "size", size);
+    cmd_getval(cct, cmdmap, "iterations", iterations);
+    ceph::ErasureCodeProfile profile;
+    profile["plugin"] = plugin;
+    profile["k"] = stringify(k);
+    profile["m"] = stringify(m);
+    if (!technique.empty())
+      profile["technique"] = technique;
+    ceph::ErasureCodeInterfaceRef ec_impl;
+    stringstream messages;
+    int r = ceph::ErasureCodePluginRegistry::instance().factory(
+      plugin,
+      cct->_conf->get_val<std::string>("erasure_code_dir"),
+      profile,
+      &ec_impl,
+      &messages);
+    if (r < 0 || !ec_impl) {
+      ss << "failed to load erasure code plugin: " << messages.str();
+      delete f;
+      return false;
+    }
+    bufferlist in;
+    in.append(string(size, 'X'));
+    in.rebuild_aligned(ceph::ErasureCode::SIMD_ALIGN);
+    set<int> want_to_encode;
+    for (unsigned int i = 0; i < ec_impl->get_chunk_count(); i++)
+      want_to_encode.insert(i);
+    {
+      // encode once outside the timed loop so one-time setup such as
+      // generator matrix and table construction is not measured
+      map<int,bufferlist> encoded;
+      r = ec_impl->encode(want_to_encode, in, &encoded);
+    }
+    utime_t begin_time = ceph_clock_now();
+    for (int64_t i = 0; r == 0 && i < iterations; i++) {
+      map<int,bufferlist> encoded;
+      r = ec_impl->encode(want_to_encode, in, &encoded);
+    }
+    utime_t end_time = ceph_clock_now();
+    if (r < 0) {
+      ss << "encode failed: " << cpp_strerror(r);
+      delete f;
+      return false;
+    }
+    double elapsed = end_time - begin_time;
+    f->open_object_section("ec_bench");
+    f->dump_string("plugin", plugin);
+    f->dump_string("technique",
+		   profile.count("technique") ? profile["technique"] : "");
+    f->dump_int("k", k);
+    f->dump_int("m", m);
+    f->dump_int("object_size", size);
+    f->dump_int("iterations", iterations);
+    f->dump_float("elapsed_sec", elapsed);
+    f->dump_float("encode_mbps",
+		  elapsed > 0 ?
+		  (double)size * iterations / elapsed / 1048576 : 0);
+    f->close_section();
   } else {
     assert(0 == "broken asok registration");
   }
@@ -2493,19 +2613,28 @@ int OSD::init()
     goto out;
 
   /**
-   * FIXME: this is a placeholder implementation that unconditionally
-   * sends every is_primary PG's stats every time we're called, unlike
-   * the existing mon PGStats mechanism that uses pg_stat_queue and acks.
-   * This has equivalent cost to the existing worst case where all
-   * PGs are busy and their stats are always enqueued for sending.
+   * Reports to the mgr carry only pgs whose published stats changed
+   * since the last report, plus a periodic full resync
+   * (osd_mgr_pg_stats_resync_interval) since there is no ack on this
+   * path to detect a lost report.
    */
   mgrc.set_pgstats_cb([this](){
       RWLock::RLocker l(map_lock);
-      
-      utime_t had_for = ceph_clock_now() - had_map_since;
+
+      utime_t now = ceph_clock_now();
+      utime_t had_for = now - had_map_since;
       osd_stat_t cur_stat = service.get_osd_stat();
       cur_stat.os_perf_stat = store->get_cur_stats();
 
+      bool full = false;
+      if (mgr_last_pg_stats_full == utime_t() ||
+	  now - mgr_last_pg_stats_full >=
+	    cct->_conf->osd_mgr_pg_stats_resync_interval) {
+	full = true;
+	mgr_last_pg_stats_full = now;
+	mgr_pg_stats_sent.clear();  // also drops pgs we no longer serve
+      }
+
       MPGStats *m = new MPGStats(monc->get_fsid(), osdmap->get_epoch(), had_for);
       m->osd_stat = cur_stat;
 
@@ -2513,6 +2642,7 @@ int OSD::init()
       min_last_epoch_clean = osdmap->get_epoch();
       min_last_epoch_clean_pgs.clear();
       RWLock::RLocker lpg(pg_map_lock);
+      unsigned skipped = 0;
       for (const auto &i : pg_map) {
         PG *pg = i.second;
         if (!pg->is_primary()) {
@@ -2521,13 +2651,25 @@ int OSD::init()
 
         pg->pg_stats_publish_lock.Lock();
         if (pg->pg_stats_publish_valid) {
-          m->pg_stat[pg->info.pgid.pgid] = pg->pg_stats_publish;
 	  const auto lec = pg->pg_stats_publish.get_effective_last_epoch_clean();
 	  min_last_epoch_clean = min(min_last_epoch_clean, lec);
 	  min_last_epoch_clean_pgs.push_back(pg->info.pgid.pgid);
+	  auto& sent = mgr_pg_stats_sent[pg->info.pgid.pgid];
+	  if (full ||
+	      sent.first != pg->pg_stats_publish.reported_epoch ||
+	      sent.second != pg->pg_stats_publish.reported_seq) {
+	    m->pg_stat[pg->info.pgid.pgid] = pg->pg_stats_publish;
+	    sent = make_pair(pg->pg_stats_publish.reported_epoch,
+			     pg->pg_stats_publish.reported_seq);
+	  } else {
+	    ++skipped;
+	  }
         }
         pg->pg_stats_publish_lock.Unlock();
       }
+      dout(20) << "mgr pgstats cb: " << m->pg_stat.size() << " pgs, "
+	       << skipped << " unchanged"
+	       << (full ? " (full resync)" : "") << dendl;
 
       return m;
   });
@@ -2606,8 +2748,12 @@ int OSD::init()
   check_config();
 
   dout(10) << "ensuring pgs have consumed prior maps" << dendl;
+  utime_t consume_start = ceph_clock_now();
   consume_map();
   peering_wq.drain();
+  utime_t consume_lat = ceph_clock_now() - consume_start;
+  logger->tset(l_osd_boot_peering_lat, consume_lat);
+  dout(10) << "pgs consumed prior maps in " << consume_lat << dendl;
 
   dout(0) << "done with init, starting boot process" << dendl;
 
@@ -2689,6 +2835,13 @@ void OSD::final_init()
 				     asok_hook,
 				     "show recovery reservations");
   assert(r == 0);
+  r = admin_socket->register_command(
+    "dump_osd_network",
+    "dump_osd_network name=value,type=CephInt,req=false",
+    asok_hook,
+    "dump heartbeat ping round trip times, restricted to peers whose"
+    " average RTT is at or above the given threshold (ms)");
+  assert(r == 0);
   r = admin_socket->register_command("get_latest_osdmap", "get_latest_osdmap",
 				     asok_hook,
 				     "force osd to update the latest map from "
@@ -2745,6 +2898,23 @@ void OSD::final_init()
 				     asok_hook,
 				     "show recent state history");
   assert(r == 0);
+  r = admin_socket->register_command("dump_object_heat", "dump_object_heat",
+				     asok_hook,
+				     "show per-pg read-frequency sketches");
+  assert(r == 0);
+
+  r = admin_socket->register_command(
+    "ec_bench",
+    "ec_bench " \
+    "name=plugin,type=CephString,req=false " \
+    "name=technique,type=CephString,req=false " \
+    "name=k,type=CephInt,req=false,range=1 " \
+    "name=m,type=CephInt,req=false,range=1 " \
+    "name=size,type=CephInt,req=false,range=1 " \
+    "name=iterations,type=CephInt,req=false,range=1",
+    asok_hook,
+    "measure erasure code encode throughput on this host");
+  assert(r == 0);
 
   test_ops_hook = new TestOpsSocketHook(&(this->service), this->store);
   // Note: pools are CephString instead of CephPoolname because
@@ -2880,8 +3050,9 @@ void OSD::create_logger()
     l_osd_op_outb,  "op_out_bytes",
     "Client operations total read size",
     "rd", PerfCountersBuilder::PRIO_INTERESTING);
-  osd_plb.add_time_avg(
+  osd_plb.add_time_avg_histogram(
     l_osd_op_lat,   "op_latency",
+    op_hist_x_axis_config,
     "Latency of client operations (including queue time)",
     "l", 9);
   osd_plb.add_time_avg(
@@ -2956,6 +3127,8 @@ void OSD::create_logger()
     "Latency of IO before calling queue(before really queue into ShardedOpWq)"); // client io before queue op_wq latency
   osd_plb.add_time_avg(l_osd_op_before_dequeue_op_lat, "op_before_dequeue_op_lat",
     "Latency of IO before calling dequeue_op(already dequeued and get PG lock)"); // client io before dequeue_op latency
+  osd_plb.add_time_avg(l_osd_op_queue_lat, "op_queue_lat",
+    "Time ops spend in the sharded op queue (enqueue_op to dequeue_op)"); // op queue residency
 
   osd_plb.add_u64_counter(
     l_osd_sop, "subop", "Suboperations");
@@ -3013,6 +3186,9 @@ void OSD::create_logger()
     "Placement groups ready to be deleted from this osd");
   osd_plb.add_u64(
     l_osd_hb_to, "heartbeat_to_peers", "Heartbeat (ping) peers we send to");
+  osd_plb.add_time_avg(
+    l_osd_hb_ping_rtt, "heartbeat_ping_rtt",
+    "Round trip time of heartbeat pings");
   osd_plb.add_u64_counter(l_osd_map, "map_messages", "OSD map messages");
   osd_plb.add_u64_counter(l_osd_mape, "map_message_epochs", "OSD map epochs");
   osd_plb.add_u64_counter(
@@ -3099,6 +3275,34 @@ void OSD::create_logger()
   osd_plb.add_u64_counter(
     l_osd_pg_biginfo, "osd_pg_biginfo", "PG updated its biginfo attr");
 
+  osd_plb.add_u64_counter(
+    l_osd_op_shard_steals, "op_shard_steals",
+    "Ops processed by an idle thread on behalf of another shard");
+
+  osd_plb.add_time(
+    l_osd_boot_peering_lat, "boot_peering_latency",
+    "Time spent bringing PGs up to date with the osdmap during init");
+
+  osd_plb.add_u64_counter(
+    l_osd_objects_trimmed, "objects_trimmed",
+    "Objects trimmed by snap trimming");
+  osd_plb.add_u64_counter(
+    l_osd_snaps_purged, "snaps_purged",
+    "Snaps fully purged by snap trimming");
+
+  osd_plb.add_u64_counter(
+    l_osd_notify, "notify", "Notifies processed");
+  osd_plb.add_u64_avg(
+    l_osd_notify_watchers, "notify_watchers",
+    "Watchers fanned out to per notify");
+  osd_plb.add_time_avg(
+    l_osd_notify_lat, "notify_latency",
+    "Time from notify start until all watchers acked or timed out");
+
+  osd_plb.add_u64_counter(
+    l_osd_op_delayed_degraded, "op_delayed_degraded",
+    "Ops delayed waiting for a degraded object to be recovered");
+
   logger = osd_plb.create_perf_counters();
   cct->get_perfcounters_collection()->add(logger);
 }
@@ -3217,6 +3421,8 @@ int OSD::shutdown()
   cct->get_admin_socket()->unregister_command("calc_objectstore_db_histogram");
   cct->get_admin_socket()->unregister_command("flush_store_cache");
   cct->get_admin_socket()->unregister_command("dump_pgstate_history");
+  cct->get_admin_socket()->unregister_command("dump_object_heat");
+  cct->get_admin_socket()->unregister_command("ec_bench");
   delete asok_hook;
   asok_hook = NULL;
 
@@ -4715,6 +4921,11 @@ void OSD::handle_osd_ping(MOSDPing *m)
     {
       map<int,HeartbeatInfo>::iterator i = heartbeat_peers.find(from);
       if (i != heartbeat_peers.end()) {
+	// the reply carries our original send stamp, so the RTT is
+	// measured entirely against our own clock
+	utime_t rtt = ceph_clock_now() - m->stamp;
+	if (logger)
+	  logger->tinc(l_osd_hb_ping_rtt, rtt);
 	if (m->get_connection() == i->second.con_back) {
 	  dout(25) << "handle_osd_ping got reply from osd." << from
 		   << " first_tx " << i->second.first_tx
@@ -4723,6 +4934,7 @@ void OSD::handle_osd_ping(MOSDPing *m)
 		   << " last_rx_front " << i->second.last_rx_front
 		   << dendl;
 	  i->second.last_rx_back = m->stamp;
+	  HeartbeatInfo::sample_rtt(&i->second.rtts_back, rtt);
 	  // if there is no front con, set both stamps.
 	  if (i->second.con_front == NULL)
 	    i->second.last_rx_front = m->stamp;
@@ -4734,6 +4946,7 @@ void OSD::handle_osd_ping(MOSDPing *m)
 		   << " last_rx_front " << i->second.last_rx_front << " -> " << m->stamp
 		   << dendl;
 	  i->second.last_rx_front = m->stamp;
+	  HeartbeatInfo::sample_rtt(&i->second.rtts_front, rtt);
 	}
 
         utime_t cutoff = ceph_clock_now();
@@ -4895,6 +5108,26 @@ void OSD::heartbeat()
 
   logger->set(l_osd_hb_to, heartbeat_peers.size());
 
+  // warn about abnormally slow peers; a single bad link shows up here
+  // long before it degrades into slow requests
+  int64_t warn_ms = cct->_conf->osd_heartbeat_rtt_warn_ms;
+  if (warn_ms > 0 && now - last_hb_rtt_warn > 60.0) {
+    for (map<int,HeartbeatInfo>::iterator i = heartbeat_peers.begin();
+	 i != heartbeat_peers.end();
+	 ++i) {
+      double slowest = std::max(
+	HeartbeatInfo::avg_rtt(i->second.rtts_back),
+	HeartbeatInfo::avg_rtt(i->second.rtts_front));
+      if (slowest * 1000.0 >= warn_ms) {
+	clog->warn() << "slow heartbeat ping to osd." << i->first
+		     << " average round trip time "
+		     << (slowest * 1000.0) << " ms exceeds "
+		     << warn_ms << " ms";
+	last_hb_rtt_warn = now;
+      }
+    }
+  }
+
   // hmm.. am i all alone?
   dout(30) << "heartbeat lonely?" << dendl;
   if (heartbeat_peers.empty()) {
@@ -4908,6 +5141,44 @@ void OSD::heartbeat()
   dout(30) << "heartbeat done" << dendl;
 }
 
+void OSD::dump_osd_network(Formatter *f, int64_t threshold_ms)
+{
+  Mutex::Locker l(heartbeat_lock);
+  f->open_object_section("network_ping_times");
+  f->dump_int("threshold_ms", threshold_ms);
+  f->open_array_section("entries");
+  for (map<int,HeartbeatInfo>::iterator i = heartbeat_peers.begin();
+       i != heartbeat_peers.end();
+       ++i) {
+    for (int side = 0; side < 2; ++side) {
+      const list<double> &rtts =
+	side ? i->second.rtts_front : i->second.rtts_back;
+      if (rtts.empty())
+	continue;
+      double min = rtts.front();
+      double max = rtts.front();
+      for (double rtt : rtts) {
+	min = std::min(min, rtt);
+	max = std::max(max, rtt);
+      }
+      double avg = HeartbeatInfo::avg_rtt(rtts);
+      if (avg * 1000.0 < threshold_ms)
+	continue;
+      f->open_object_section("entry");
+      f->dump_int("peer", i->first);
+      f->dump_string("interface", side ? "front" : "back");
+      f->dump_float("last_ms", rtts.back() * 1000.0);
+      f->dump_float("min_ms", min * 1000.0);
+      f->dump_float("average_ms", avg * 1000.0);
+      f->dump_float("max_ms", max * 1000.0);
+      f->dump_unsigned("samples", rtts.size());
+      f->close_section();
+    }
+  }
+  f->close_section();
+  f->close_section();
+}
+
 bool OSD::heartbeat_reset(Connection *con)
 {
   HeartbeatSession *s = static_cast<HeartbeatSession*>(con->get_priv());
@@ -4976,6 +5247,22 @@ void OSD::tick()
   tick_timer.add_event_after(OSD_TICK_INTERVAL, new C_Tick(this));
 }
 
+void OSD::resize_pg_object_context_caches()
+{
+  // split the OSD-wide budget evenly across the current PGs; fall back
+  // to the per-PG knob when no budget is set.  SharedLRU::set_size only
+  // needs its own lock, so we don't have to take each pg lock here.
+  int64_t budget = cct->_conf->osd_object_context_cache_budget;
+  RWLock::RLocker l(pg_map_lock);
+  size_t per_pg = cct->_conf->osd_pg_object_context_cache_count;
+  if (budget > 0 && !pg_map.empty()) {
+    per_pg = MAX(budget / (int64_t)pg_map.size(), (int64_t)1);
+  }
+  for (auto& i : pg_map) {
+    i.second->set_context_cache_size(per_pg);
+  }
+}
+
 void OSD::tick_without_osd_lock()
 {
   assert(tick_timer_lock.is_locked());
@@ -4988,6 +5275,11 @@ void OSD::tick_without_osd_lock()
   logger->set(l_osd_cached_crc_adjusted, buffer::get_cached_crc_adjusted());
   logger->set(l_osd_missed_crc, buffer::get_missed_crc());
 
+  // pg count changes are rare; rebalancing the budget once a tick is plenty
+  if (cct->_conf->osd_object_context_cache_budget > 0) {
+    resize_pg_object_context_caches();
+  }
+
   // osd_lock is not being held, which means the OSD state
   // might change when doing the monitor report
   if (is_active() || is_waiting_for_healthy()) {
@@ -7471,10 +7763,19 @@ void OSD::handle_osd_map(MOSDMap *m)
 
       OSDMap *o = new OSDMap;
       if (e > 1) {
-	bufferlist obl;
-        bool got = get_map_bl(e - 1, obl);
-        assert(got);
-	o->decode(obl);
+	// start from the previous epoch's decoded map (either just added
+	// by the last pass through this loop, or loaded into the cache on
+	// demand); copying it is much cheaper than decoding the full e-1
+	// bufferlist from scratch for every epoch.
+	OSDMapRef prev = service.try_get_map(e - 1);
+	if (prev) {
+	  o->deepish_copy_from(*prev);
+	} else {
+	  bufferlist obl;
+	  bool got = get_map_bl(e - 1, obl);
+	  assert(got);
+	  o->decode(obl);
+	}
       }
 
       OSDMap::Incremental inc;
@@ -9216,7 +9517,9 @@ bool OSD::op_is_discardable(const MOSDOp *op)
 
 void OSD::enqueue_op(spg_t pg, OpRequestRef& op, epoch_t epoch)
 {
-  utime_t latency = ceph_clock_now() - op->get_req()->get_recv_stamp();
+  utime_t now = ceph_clock_now();
+  op->set_queued_time(now);
+  utime_t latency = now - op->get_req()->get_recv_stamp();
   dout(15) << "enqueue_op " << op << " prio " << op->get_req()->get_priority()
 	   << " cost " << op->get_req()->get_cost()
 	   << " latency " << latency
@@ -9242,6 +9545,13 @@ void OSD::dequeue_op(
   FUNCTRACE();
   OID_EVENT_TRACE_WITH_MSG(op->get_req(), "DEQUEUE_OP_BEGIN", false);
 
+  if (!op->get_nonconst_req()->verify_deferred_data_crc(cct)) {
+    derr << __func__ << " bad deferred data crc in " << *(op->get_req())
+	 << ", dropping op and resetting session" << dendl;
+    op->get_req()->get_connection()->mark_down();
+    return;
+  }
+
   utime_t now = ceph_clock_now();
   op->set_dequeued_time(now);
   utime_t latency = now - op->get_req()->get_recv_stamp();
@@ -9252,6 +9562,7 @@ void OSD::dequeue_op(
 	   << " pg " << *pg << dendl;
 
   logger->tinc(l_osd_op_before_dequeue_op_lat, latency);
+  logger->tinc(l_osd_op_queue_lat, now - op->get_queued_time());
 
   Session *session = static_cast<Session *>(
     op->get_req()->get_connection()->get_priv());
@@ -9391,6 +9702,8 @@ const char** OSD::get_tracked_conf_keys() const
     "osd_client_message_cap",
     "osd_heartbeat_min_size",
     "osd_heartbeat_interval",
+    "osd_object_context_cache_budget",
+    "osd_pg_object_context_cache_count",
     NULL
   };
   return KEYS;
@@ -9432,6 +9745,10 @@ void OSD::handle_conf_change(const struct md_config_t *conf,
       changed.count("osd_disk_thread_ioprio_priority")) {
     set_disk_tp_priority();
   }
+  if (changed.count("osd_object_context_cache_budget") ||
+      changed.count("osd_pg_object_context_cache_count")) {
+    resize_pg_object_context_caches();
+  }
   if (changed.count("osd_map_cache_size")) {
     service.map_cache.set_size(cct->_conf->osd_map_cache_size);
     service.map_bl_cache.set_size(cct->_conf->osd_map_cache_size);
@@ -9866,6 +10183,32 @@ void OSD::ShardedOpWQ::clear_pg_slots()
 #undef dout_prefix
 #define dout_prefix *_dout << "osd." << osd->whoami << " op_wq(" << shard_index << ") "
 
+bool OSD::ShardedOpWQ::_steal_shard(uint32_t *pshard_index, ShardData **psdata)
+{
+  uint32_t shard_index = *pshard_index;
+  // Ops for a pg are only ever queued and tracked (pg_slots) in the
+  // pg's home shard, and each shard already runs several threads, so
+  // processing an item on behalf of another shard is no different from
+  // being one more thread of that shard: everything below the dequeue
+  // is keyed off the victim's ShardData and its ordering lock.
+  (*psdata)->sdata_op_ordering_lock.Unlock();
+  for (uint32_t i = 1; i < num_shards; ++i) {
+    uint32_t victim_index = (shard_index + i) % num_shards;
+    ShardData *vdata = shard_list[victim_index];
+    vdata->sdata_op_ordering_lock.Lock();
+    if (!vdata->pqueue->empty()) {
+      dout(20) << __func__ << " stealing from shard " << victim_index << dendl;
+      osd->logger->inc(l_osd_op_shard_steals);
+      *pshard_index = victim_index;
+      *psdata = vdata;
+      return true;
+    }
+    vdata->sdata_op_ordering_lock.Unlock();
+  }
+  (*psdata)->sdata_op_ordering_lock.Lock();
+  return false;
+}
+
 void OSD::ShardedOpWQ::_process(uint32_t thread_index, heartbeat_handle_d *hb)
 {
   uint32_t shard_index = thread_index % num_shards;
@@ -9874,7 +10217,9 @@ void OSD::ShardedOpWQ::_process(uint32_t thread_index, heartbeat_handle_d *hb)
 
   // peek at spg_t
   sdata->sdata_op_ordering_lock.Lock();
-  if (sdata->pqueue->empty()) {
+  if (sdata->pqueue->empty() &&
+      !(osd->cct->_conf->osd_op_shard_steal && num_shards > 1 &&
+	_steal_shard(&shard_index, &sdata))) {
     dout(20) << __func__ << " empty q, waiting" << dendl;
     // optimistically sleep a moment; maybe another work item will come along.
     osd->cct->get_heartbeat_map()->reset_timeout(hb,
@@ -10159,6 +10504,9 @@ std::ostream& operator<<(std::ostream& out, const OSD::io_queue& q) {
   case OSD::io_queue::mclock_client:
     out << "mclock_client";
     break;
+  case OSD::io_queue::fifo:
+    out << "fifo";
+    break;
   }
   return out;
 }
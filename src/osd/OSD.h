@@ -55,6 +55,7 @@ using namespace std;
 #include "common/sharedptr_registry.hpp"
 #include "common/WeightedPriorityQueue.h"
 #include "common/PrioritizedQueue.h"
+#include "common/FifoPriorityQueue.h"
 #include "osd/mClockOpClassQueue.h"
 #include "osd/mClockClientQueue.h"
 #include "messages/MOSDOp.h"
@@ -96,6 +97,7 @@ enum {
 
   l_osd_op_before_queue_op_lat,
   l_osd_op_before_dequeue_op_lat,
+  l_osd_op_queue_lat,
 
   l_osd_sop,
   l_osd_sop_inb,
@@ -128,6 +130,7 @@ enum {
   l_osd_pg_replica,
   l_osd_pg_stray,
   l_osd_hb_to,
+  l_osd_hb_ping_rtt,
   l_osd_map,
   l_osd_mape,
   l_osd_mape_dup,
@@ -177,6 +180,19 @@ enum {
   l_osd_pg_fastinfo,
   l_osd_pg_biginfo,
 
+  l_osd_op_shard_steals,
+
+  l_osd_boot_peering_lat,
+
+  l_osd_objects_trimmed,
+  l_osd_snaps_purged,
+
+  l_osd_notify,
+  l_osd_notify_watchers,
+  l_osd_notify_lat,
+
+  l_osd_op_delayed_degraded,
+
   l_osd_last,
 };
 
@@ -986,10 +1002,7 @@ public:
   }
   void pin_map_bl(epoch_t e, bufferlist &bl);
   void _add_map_bl(epoch_t e, bufferlist& bl);
-  bool get_map_bl(epoch_t e, bufferlist& bl) {
-    Mutex::Locker l(map_cache_lock);
-    return _get_map_bl(e, bl);
-  }
+  bool get_map_bl(epoch_t e, bufferlist& bl);
   bool _get_map_bl(epoch_t e, bufferlist& bl);
 
   void add_map_inc_bl(epoch_t e, bufferlist& bl) {
@@ -1207,6 +1220,11 @@ protected:
   Messenger   *objecter_messenger;
   MonClient   *monc; // check the "monc helpers" list before accessing directly
   MgrClient   mgrc;
+  /// last (reported_epoch, reported_seq) included in a mgr stats report
+  /// per pg, so unchanged pgs can be skipped.  Only touched from the
+  /// mgrc pgstats callback, which MgrClient serializes.
+  map<pg_t, pair<epoch_t, uint64_t> > mgr_pg_stats_sent;
+  utime_t mgr_last_pg_stats_full;
   PerfCounters      *logger;
   PerfCounters      *recoverystate_perf;
   ObjectStore *store;
@@ -1226,6 +1244,7 @@ protected:
   void create_recoverystate_perf();
   void tick();
   void tick_without_osd_lock();
+  void resize_pg_object_context_caches();
   void _dispatch(Message *m);
   void dispatch_op(OpRequestRef op);
 
@@ -1462,6 +1481,25 @@ private:
     utime_t last_rx_back;   ///< last time we got a ping reply on the back side
     epoch_t epoch;      ///< most recent epoch we wanted this peer
 
+    /// number of recent ping round trip times we remember per interface
+    static const unsigned RTT_WINDOW = 32;
+    list<double> rtts_back;   ///< recent ping RTTs on the back interface
+    list<double> rtts_front;  ///< recent ping RTTs on the front interface
+
+    static void sample_rtt(list<double> *rtts, double rtt) {
+      rtts->push_back(rtt);
+      if (rtts->size() > RTT_WINDOW)
+	rtts->pop_front();
+    }
+    static double avg_rtt(const list<double> &rtts) {
+      if (rtts.empty())
+	return 0.0;
+      double sum = 0.0;
+      for (double rtt : rtts)
+	sum += rtt;
+      return sum / rtts.size();
+    }
+
     bool is_unhealthy(utime_t cutoff) const {
       return
 	! ((last_rx_front > cutoff ||
@@ -1488,6 +1526,7 @@ private:
   std::atomic_bool heartbeat_need_update;   
   map<int,HeartbeatInfo> heartbeat_peers;  ///< map of osd id to HeartbeatInfo
   utime_t last_mon_heartbeat;
+  utime_t last_hb_rtt_warn;  ///< last time we warned about slow ping RTTs
   Messenger *hb_front_client_messenger;
   Messenger *hb_back_client_messenger;
   Messenger *hb_front_server_messenger;
@@ -1513,6 +1552,7 @@ private:
   void heartbeat_check();
   void heartbeat_entry();
   void need_heartbeat_peer_update();
+  void dump_osd_network(Formatter *f, int64_t threshold_ms);
 
   void heartbeat_kick() {
     Mutex::Locker l(heartbeat_lock);
@@ -1591,6 +1631,7 @@ private:
     weightedpriority,
     mclock_opclass,
     mclock_client,
+    fifo,
   };
   friend std::ostream& operator<<(std::ostream& out, const OSD::io_queue& q);
 
@@ -1687,6 +1728,11 @@ private:
 	} else if (opqueue == io_queue::mclock_client) {
 	  pqueue = std::unique_ptr
 	    <ceph::mClockClientQueue>(new ceph::mClockClientQueue(cct));
+	} else if (opqueue == io_queue::fifo) {
+	  pqueue = std::unique_ptr
+	    <FifoPriorityQueue<pair<spg_t,PGQueueable>,entity_inst_t>>(
+	      new FifoPriorityQueue<pair<spg_t,PGQueueable>,entity_inst_t>(
+		max_tok_per_prio, min_cost));
 	}
       }
     }; // struct ShardData
@@ -1739,6 +1785,11 @@ private:
     /// try to do some work
     void _process(uint32_t thread_index, heartbeat_handle_d *hb) override;
 
+    /// retarget an idle thread at a backlogged shard; called with
+    /// (*sdata)'s ordering lock held and its queue empty, returns with
+    /// the victim's ordering lock held on success
+    bool _steal_shard(uint32_t *shard_index, ShardData **sdata);
+
     /// enqueue a new item
     void _enqueue(pair <spg_t, PGQueueable> item) override;
 
@@ -2305,6 +2356,9 @@ private:
       return false;
     }
   }
+  // deferred data crcs are verified in dequeue_op, on the shard worker
+  // that handles the op anyway
+  bool ms_can_defer_data_crc() const override { return true; }
   void ms_fast_dispatch(Message *m) override;
   void ms_fast_preprocess(Message *m) override;
   bool ms_dispatch(Message *m) override;
@@ -2334,6 +2388,8 @@ private:
       return io_queue::mclock_opclass;
     } else if (cct->_conf->osd_op_queue == "mclock_client") {
       return io_queue::mclock_client;
+    } else if (cct->_conf->osd_op_queue == "fifo") {
+      return io_queue::fifo;
     } else {
       return io_queue::prioritized;
     }
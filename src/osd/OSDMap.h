@@ -29,7 +29,7 @@
 #include "include/types.h"
 #include "osd_types.h"
 
-//#include "include/ceph_features.h"
+#include "include/ceph_features.h"
 #include "crush/CrushWrapper.h"
 #include <vector>
 #include <list>
@@ -119,7 +119,7 @@ ostream& operator<<(ostream& out, const osd_xinfo_t& xi);
 struct PGTempMap {
 #if 1
   bufferlist data;
-  typedef btree::btree_map<pg_t,int32_t*> map_t;
+  typedef mempool::osdmap::btree_map<pg_t,int32_t*> map_t;
   map_t map;
 
   void encode(bufferlist& bl) const {
@@ -965,6 +965,19 @@ public:
    */
   uint64_t get_features(int entity_type, uint64_t *mask) const;
 
+  /// feature bits that change how an osdmap is encoded on the wire
+  static const uint64_t SIGNIFICANT_FEATURES =
+    CEPH_FEATURE_PGID64 |
+    CEPH_FEATURE_PGPOOL3 |
+    CEPH_FEATURE_OSDENC |
+    CEPH_FEATURE_OSDMAP_ENC |
+    CEPH_FEATURE_MSG_ADDR2;
+
+  /// the subset of @p features that affect the osdmap encoding
+  static uint64_t get_significant_features(uint64_t features) {
+    return SIGNIFICANT_FEATURES & features;
+  }
+
   /**
    * get oldest *client* version (firefly, hammer, etc.) that can connect given
    * the feature bits required (according to get_features()).
@@ -3144,7 +3144,7 @@ void PG::append_log(
   auto last = logv.rbegin();
   if (is_primary() && last != logv.rend()) {
     projected_log.skip_can_rollback_to_to_head();
-    projected_log.trim(cct, last->version, nullptr);
+    projected_log.trim(cct, last->version, nullptr, nullptr, nullptr);
   }
 
   if (transaction_applied && roll_forward_to > pg_log.get_can_rollback_to()) {
@@ -3316,15 +3316,18 @@ void PG::update_snap_map(
   const vector<pg_log_entry_t> &log_entries,
   ObjectStore::Transaction &t)
 {
+  OSDriver::OSTransaction _t(osdriver.get_transaction(&t));
+  // coalesce the mapper updates for the whole batch of log entries
+  // into a single omap_setkeys/omap_rmkeys pair
+  MapCacher::BatchTransaction<std::string, bufferlist> bt(&_t);
   for (vector<pg_log_entry_t>::const_iterator i = log_entries.begin();
        i != log_entries.end();
        ++i) {
-    OSDriver::OSTransaction _t(osdriver.get_transaction(&t));
     if (i->soid.snap < CEPH_MAXSNAP) {
       if (i->is_delete()) {
 	int r = snap_mapper.remove_oid(
 	  i->soid,
-	  &_t);
+	  &bt);
 	assert(r == 0);
       } else if (i->is_update()) {
 	assert(i->snaps.length() > 0);
@@ -3342,14 +3345,14 @@ void PG::update_snap_map(
 	  snap_mapper.add_oid(
 	    i->soid,
 	    _snaps,
-	    &_t);
+	    &bt);
 	} else if (i->is_modify()) {
 	  assert(i->is_modify());
 	  int r = snap_mapper.update_snaps(
 	    i->soid,
 	    _snaps,
 	    0,
-	    &_t);
+	    &bt);
 	  assert(r == 0);
 	} else {
 	  assert(i->is_clean());
@@ -3357,6 +3360,7 @@ void PG::update_snap_map(
       }
     }
   }
+  bt.flush();
 }
 
 /**
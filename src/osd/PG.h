@@ -993,6 +993,9 @@ public:
   bool all_unfound_are_queried_or_lost(const OSDMapRef osdmap) const;
   virtual void dump_recovery_info(Formatter *f) const = 0;
 
+  /// dump the read-frequency sketch, if any (see dump_object_heat)
+  virtual void dump_object_heat(Formatter *f) const {}
+
   bool calc_min_last_complete_ondisk() {
     eversion_t min = last_complete_ondisk;
     assert(!actingbackfill.empty());
@@ -2510,6 +2513,9 @@ public:
   virtual void check_blacklisted_watchers() = 0;
   virtual void get_watchers(std::list<obj_watch_item_t>&) = 0;
 
+  /// adjust the object context cache limit; called without the pg lock
+  virtual void set_context_cache_size(size_t count) = 0;
+
   virtual bool agent_work(int max) = 0;
   virtual bool agent_work(int max, int agent_flush_quota) = 0;
   virtual void agent_stop() = 0;
@@ -285,6 +285,31 @@ int PGBackend::objects_get_attr(
   return r;
 }
 
+int PGBackend::objects_get_attr_batch(
+  const vector<hobject_t> &hoids,
+  const string &attr,
+  map<hobject_t, bufferlist> *out)
+{
+  shard_id_t shard = get_parent()->whoami_shard().shard;
+  vector<ghobject_t> goids;
+  goids.reserve(hoids.size());
+  for (vector<hobject_t>::const_iterator p = hoids.begin();
+       p != hoids.end(); ++p) {
+    goids.push_back(ghobject_t(*p, ghobject_t::NO_GEN, shard));
+  }
+  map<ghobject_t, bufferptr> vals;
+  int r = store->getattr_batch(ch, goids, attr.c_str(), &vals);
+  if (r < 0)
+    return r;
+  for (map<ghobject_t, bufferptr>::iterator p = vals.begin();
+       p != vals.end(); ++p) {
+    bufferlist bl;
+    bl.push_back(std::move(p->second));
+    (*out)[p->first.hobj] = std::move(bl);
+  }
+  return 0;
+}
+
 int PGBackend::objects_get_attrs(
   const hobject_t &hoid,
   map<string, bufferlist> *out)
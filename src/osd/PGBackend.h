@@ -515,6 +515,12 @@ typedef ceph::shared_ptr<const OSDMap> OSDMapRef;
      const string &attr,
      bufferlist *out);
 
+   /// fetch one attr for many objects; missing objects are omitted
+   int objects_get_attr_batch(
+     const vector<hobject_t> &hoids,
+     const string &attr,
+     map<hobject_t, bufferlist> *out);
+
    virtual int objects_get_attrs(
      const hobject_t &hoid,
      map<string, bufferlist> *out);
@@ -526,6 +532,13 @@ typedef ceph::shared_ptr<const OSDMap> OSDMapRef;
      uint32_t op_flags,
      bufferlist *bl) = 0;
 
+   /// vectored objects_read_sync; trims @m to the extents actually read
+   virtual int objects_readv_sync(
+     const hobject_t &hoid,
+     map<uint64_t, uint64_t>& m,
+     uint32_t op_flags,
+     bufferlist *bl) = 0;
+
    virtual void objects_read_async(
      const hobject_t &hoid,
      const list<pair<boost::tuple<uint64_t, uint64_t, uint32_t>,
@@ -46,7 +46,9 @@ void PGLog::IndexedLog::split_out_child(
 void PGLog::IndexedLog::trim(
   CephContext* cct,
   eversion_t s,
-  set<eversion_t> *trimmed)
+  set<eversion_t> *trimmed,
+  set<string> *trimmed_dups,
+  eversion_t *write_from_dups)
 {
   if (complete_to != log.end() &&
       complete_to->version <= s) {
@@ -57,6 +59,16 @@ void PGLog::IndexedLog::trim(
 
   assert(s <= can_rollback_to);
 
+  // We keep dup entries for the last osd_pg_log_dups_tracked versions;
+  // anything trimmed within that window leaves a pg_log_dup_t behind so
+  // replayed client requests can still be recognized after the log
+  // itself has been shrunk.
+  version_t dups_tracked = cct ? cct->_conf->osd_pg_log_dups_tracked : 0;
+  version_t earliest_dup_version =
+    (log.empty() || log.rbegin()->version.version < dups_tracked)
+    ? 0u
+    : log.rbegin()->version.version - dups_tracked + 1;
+
   while (!log.empty()) {
     pg_log_entry_t &e = *log.begin();
     if (e.version > s)
@@ -67,6 +79,27 @@ void PGLog::IndexedLog::trim(
 
     unindex(e);         // remove from index,
 
+    // add to dup detection trimmed list; a caller passing a null
+    // trimmed_dups (e.g. the projected log) doesn't persist the log and
+    // doesn't want dup entries accumulating either
+    if (trimmed_dups && e.version.version >= earliest_dup_version) {
+      if (write_from_dups != nullptr && *write_from_dups > e.version) {
+	generic_dout(20) << "updating write_from_dups from "
+			 << *write_from_dups << " to " << e.version << dendl;
+	*write_from_dups = e.version;
+      }
+      if (e.reqid_is_indexed()) {
+	dups.push_back(pg_log_dup_t(e));
+	index(dups.back());
+      }
+      for (const auto& extra : e.extra_reqids) {
+	// note: extras have the same version as the outer op
+	dups.push_back(pg_log_dup_t(e.version, extra.second,
+				    extra.first, e.return_code));
+	index(dups.back());
+      }
+    }
+
     if (rollback_info_trimmed_to_riter == log.rend() ||
 	e.version == rollback_info_trimmed_to_riter->version) {
       log.pop_front();
@@ -76,6 +109,17 @@ void PGLog::IndexedLog::trim(
     }
   }
 
+  while (!dups.empty()) {
+    pg_log_dup_t& e = *dups.begin();
+    if (e.version.version >= earliest_dup_version)
+      break;
+    generic_dout(20) << "trim dup " << e << dendl;
+    if (trimmed_dups)
+      trimmed_dups->insert(e.get_key_name());
+    unindex(e);
+    dups.pop_front();
+  }
+
   // raise tail?
   if (tail < s)
     tail = s;
@@ -124,7 +168,7 @@ void PGLog::trim(
     assert(trim_to <= info.last_complete);
 
     dout(10) << "trim " << log << " to " << trim_to << dendl;
-    log.trim(cct, trim_to, &trimmed);
+    log.trim(cct, trim_to, &trimmed, &trimmed_dups, &write_from_dups);
     info.log_tail = log.tail;
   }
 }
@@ -446,7 +490,11 @@ void PGLog::write_log_and_missing(
 	     << ", dirty_from: " << dirty_from
 	     << ", writeout_from: " << writeout_from
 	     << ", trimmed: " << trimmed
+	     << ", trimmed_dups: " << trimmed_dups
 	     << ", clear_divergent_priors: " << clear_divergent_priors
+	     << ", dirty_to_dups: " << dirty_to_dups
+	     << ", dirty_from_dups: " << dirty_from_dups
+	     << ", write_from_dups: " << write_from_dups
 	     << dendl;
     _write_log_and_missing(
       t, km, log, coll, log_oid,
@@ -458,6 +506,10 @@ void PGLog::write_log_and_missing(
       !touched_log,
       require_rollback,
       clear_divergent_priors,
+      dirty_to_dups,
+      dirty_from_dups,
+      write_from_dups,
+      trimmed_dups,
       (pg_log_debug ? &log_keys_debug : 0));
     undirty();
   } else {
@@ -496,7 +548,12 @@ void PGLog::write_log_and_missing(
     eversion_t(),
     set<eversion_t>(),
     missing,
-    true, require_rollback, false, 0);
+    true, require_rollback, false,
+    eversion_t::max(),
+    eversion_t(),
+    eversion_t(),
+    set<string>() /* rewrite all the dups we have */,
+    0);
 }
 
 void PGLog::_write_log_and_missing_wo_missing(
@@ -602,9 +659,13 @@ void PGLog::_write_log_and_missing(
   bool touch_log,
   bool require_rollback,
   bool clear_divergent_priors,
+  eversion_t dirty_to_dups,
+  eversion_t dirty_from_dups,
+  eversion_t write_from_dups,
+  const set<string> &trimmed_dups,
   set<string> *log_keys_debug
   ) {
-  set<string> to_remove;
+  set<string> to_remove(trimmed_dups);
   for (set<eversion_t>::const_iterator i = trimmed.begin();
        i != trimmed.end();
        ++i) {
@@ -649,11 +710,44 @@ void PGLog::_write_log_and_missing(
     (*km)[p->get_key_name()].claim(bl);
   }
 
+  if (dirty_to_dups != eversion_t()) {
+    t.omap_rmkeyrange(
+      coll, log_oid,
+      "dup_" + eversion_t().get_key_name(),
+      "dup_" + dirty_to_dups.get_key_name());
+  }
+  if (dirty_to_dups != eversion_t::max() &&
+      dirty_from_dups != eversion_t::max()) {
+    t.omap_rmkeyrange(
+      coll, log_oid,
+      "dup_" + dirty_from_dups.get_key_name(),
+      "dup_" + eversion_t::max().get_key_name());
+  }
+
+  for (const auto& entry : log.dups) {
+    if (entry.version > dirty_to_dups)
+      break;
+    bufferlist bl;
+    ::encode(entry, bl);
+    (*km)[entry.get_key_name()].claim(bl);
+  }
+
+  for (auto p = log.dups.rbegin();
+       p != log.dups.rend() &&
+	 (p->version >= dirty_from_dups || p->version >= write_from_dups) &&
+	 p->version >= dirty_to_dups;
+       ++p) {
+    bufferlist bl;
+    ::encode(*p, bl);
+    (*km)[p->get_key_name()].claim(bl);
+  }
+
   if (log_keys_debug) {
     for (map<string, bufferlist>::iterator i = (*km).begin();
 	 i != (*km).end();
 	 ++i) {
-      if (i->first[0] == '_')
+      if (i->first[0] == '_' ||
+	  i->first.compare(0, 4, "dup_") == 0)
 	continue;
       assert(!log_keys_debug->count(i->first));
       log_keys_debug->insert(i->first);
@@ -27,7 +27,11 @@ using namespace std;
 #define PGLOG_INDEXED_OBJECTS          (1 << 0)
 #define PGLOG_INDEXED_CALLER_OPS       (1 << 1)
 #define PGLOG_INDEXED_EXTRA_CALLER_OPS (1 << 2)
-#define PGLOG_INDEXED_ALL              (PGLOG_INDEXED_OBJECTS | PGLOG_INDEXED_CALLER_OPS | PGLOG_INDEXED_EXTRA_CALLER_OPS)
+#define PGLOG_INDEXED_DUPS             (1 << 3)
+#define PGLOG_INDEXED_ALL              (PGLOG_INDEXED_OBJECTS | \
+					PGLOG_INDEXED_CALLER_OPS | \
+					PGLOG_INDEXED_EXTRA_CALLER_OPS | \
+					PGLOG_INDEXED_DUPS)
 
 class CephContext;
 
@@ -82,6 +86,7 @@ public:
     mutable ceph::unordered_map<hobject_t,pg_log_entry_t*> objects;  // ptrs into log.  be careful!
     mutable ceph::unordered_map<osd_reqid_t,pg_log_entry_t*> caller_ops;
     mutable ceph::unordered_multimap<osd_reqid_t,pg_log_entry_t*> extra_caller_ops;
+    mutable ceph::unordered_map<osd_reqid_t,pg_log_dup_t*> dup_index;
 
     // recovery pointers
     list<pg_log_entry_t>::iterator complete_to; // not inclusive of referenced item
@@ -252,7 +257,13 @@ public:
         if (!(indexed_data & PGLOG_INDEXED_EXTRA_CALLER_OPS)) {
           index_extra_caller_ops();
         }
-        return extra_caller_ops.count(r);
+        if (!extra_caller_ops.count(r)) {
+          if (!(indexed_data & PGLOG_INDEXED_DUPS)) {
+            index_dups();
+          }
+          return dup_index.count(r);
+        }
+        return true;
       }
       return true;
     }
@@ -296,6 +307,18 @@ public:
 	}
 	assert(0 == "in extra_caller_ops but not extra_reqids");
       }
+
+      if (!(indexed_data & PGLOG_INDEXED_DUPS)) {
+	index_dups();
+      }
+      auto q = dup_index.find(r);
+      if (q != dup_index.end()) {
+	*version = q->second->version;
+	*user_version = q->second->user_version;
+	*return_code = q->second->return_code;
+	return true;
+      }
+
       return false;
     }
 
@@ -333,6 +356,12 @@ public:
 	caller_ops.clear();
       if (to_index & PGLOG_INDEXED_EXTRA_CALLER_OPS)
 	extra_caller_ops.clear();
+      if (to_index & PGLOG_INDEXED_DUPS) {
+	dup_index.clear();
+	for (auto& i : dups) {
+	  dup_index[i.reqid] = const_cast<pg_log_dup_t*>(&i);
+	}
+      }
 
       for (list<pg_log_entry_t>::const_iterator i = log.begin();
 	   i != log.end();
@@ -374,6 +403,10 @@ public:
       index(PGLOG_INDEXED_EXTRA_CALLER_OPS);
     }
 
+    void index_dups() const {
+      index(PGLOG_INDEXED_DUPS);
+    }
+
     void index(pg_log_entry_t& e) {
       if ((indexed_data & PGLOG_INDEXED_OBJECTS) && e.object_is_indexed()) {
         if (objects.count(e.soid) == 0 ||
@@ -394,10 +427,17 @@ public:
         }
       }
     }
+    void index(pg_log_dup_t& e) {
+      if (indexed_data & PGLOG_INDEXED_DUPS) {
+	dup_index[e.reqid] = &e;
+      }
+    }
+
     void unindex() {
       objects.clear();
       caller_ops.clear();
       extra_caller_ops.clear();
+      dup_index.clear();
       indexed_data = 0;
     }
     void unindex(pg_log_entry_t& e) {
@@ -430,6 +470,14 @@ public:
       }
     }
 
+    void unindex(pg_log_dup_t& e) {
+      if (indexed_data & PGLOG_INDEXED_DUPS) {
+	auto i = dup_index.find(e.reqid);
+	if (i != dup_index.end() && i->second == &e)
+	  dup_index.erase(i);
+      }
+    }
+
     // actors
     void add(const pg_log_entry_t& e, bool applied = true) {
       if (!applied) {
@@ -476,7 +524,9 @@ public:
     void trim(
       CephContext* cct,
       eversion_t s,
-      set<eversion_t> *trimmed);
+      set<eversion_t> *trimmed,
+      set<string> *trimmed_dups,
+      eversion_t *write_from_dups);
 
     ostream& print(ostream& out) const;
   };
@@ -492,11 +542,16 @@ protected:
   eversion_t dirty_from;       ///< must clear/writeout all keys >= dirty_from
   eversion_t writeout_from;    ///< must writout keys >= writeout_from
   set<eversion_t> trimmed;     ///< must clear keys in trimmed
+  set<string> trimmed_dups;    ///< must clear keys in trimmed_dups
   CephContext *cct;
   bool pg_log_debug;
   /// Log is clean on [dirty_to, dirty_from)
   bool touched_log;
   bool clear_divergent_priors;
+  /// Log dups are clean on [dirty_to_dups, dirty_from_dups)
+  eversion_t dirty_to_dups;    ///< must clear/writeout all dups <= dirty_to_dups
+  eversion_t dirty_from_dups;  ///< must clear/writeout all dups >= dirty_from_dups
+  eversion_t write_from_dups;  ///< must writeout dups >= write_from_dups
 
   void mark_dirty_to(eversion_t to) {
     if (to > dirty_to)
@@ -510,6 +565,14 @@ protected:
     if (from < writeout_from)
       writeout_from = from;
   }
+  void mark_dirty_to_dups(eversion_t to) {
+    if (to > dirty_to_dups)
+      dirty_to_dups = to;
+  }
+  void mark_dirty_from_dups(eversion_t from) {
+    if (from < dirty_from_dups)
+      dirty_from_dups = from;
+  }
 public:
   bool is_dirty() const {
     return !touched_log ||
@@ -517,11 +580,17 @@ public:
       (dirty_from != eversion_t::max()) ||
       (writeout_from != eversion_t::max()) ||
       !(trimmed.empty()) ||
+      !(trimmed_dups.empty()) ||
+      (dirty_to_dups != eversion_t()) ||
+      (dirty_from_dups != eversion_t::max()) ||
+      (write_from_dups != eversion_t::max()) ||
       !missing.is_clean();
   }
   void mark_log_for_rewrite() {
     mark_dirty_to(eversion_t::max());
     mark_dirty_from(eversion_t());
+    mark_dirty_to_dups(eversion_t::max());
+    mark_dirty_from_dups(eversion_t());
     touched_log = false;
   }
 protected:
@@ -549,7 +618,11 @@ protected:
     dirty_from = eversion_t::max();
     touched_log = true;
     trimmed.clear();
+    trimmed_dups.clear();
     writeout_from = eversion_t::max();
+    dirty_to_dups = eversion_t();
+    dirty_from_dups = eversion_t::max();
+    write_from_dups = eversion_t::max();
     check();
     missing.flush();
   }
@@ -562,7 +635,9 @@ public:
     cct(cct),
     pg_log_debug(!(cct && !(cct->_conf->osd_debug_pg_log_writeout))),
     touched_log(false),
-    clear_divergent_priors(false) {}
+    clear_divergent_priors(false),
+    dirty_from_dups(eversion_t::max()),
+    write_from_dups(eversion_t::max()) {}
 
 
   void reset_backfill();
@@ -1096,6 +1171,10 @@ public:
     bool touch_log,
     bool require_rollback,
     bool clear_divergent_priors,
+    eversion_t dirty_to_dups,
+    eversion_t dirty_from_dups,
+    eversion_t write_from_dups,
+    const set<string> &trimmed_dups,
     set<string> *log_keys_debug
     );
 
@@ -1145,6 +1224,7 @@ public:
     map<eversion_t, hobject_t> divergent_priors;
     bool has_divergent_priors = false;
     list<pg_log_entry_t> entries;
+    mempool::osd_pglog::list<pg_log_dup_t> dups;
     if (p) {
       for (p->seek_to_first(); p->valid() ; p->next(false)) {
 	// non-log pgmeta_oid keys are prefixed with _; skip those
@@ -1166,6 +1246,13 @@ public:
 	  pair<hobject_t, pg_missing_item> p;
 	  ::decode(p, bp);
 	  missing.add(p.first, p.second.need, p.second.have);
+	} else if (p->key().substr(0, 4) == string("dup_")) {
+	  pg_log_dup_t dup;
+	  ::decode(dup, bp);
+	  if (!dups.empty()) {
+	    assert(dups.back().version < dup.version);
+	  }
+	  dups.push_back(dup);
 	} else {
 	  pg_log_entry_t e;
 	  e.decode_with_checksum(bp);
@@ -1186,7 +1273,8 @@ public:
       info.log_tail,
       on_disk_can_rollback_to,
       on_disk_rollback_info_trimmed_to,
-      std::move(entries));
+      std::move(entries),
+      std::move(dups));
 
     if (has_divergent_priors || debug_verify_stored_missing) {
       // build missing
@@ -617,6 +617,7 @@ void PrimaryLogPG::wait_for_degraded_object(const hobject_t& soid, OpRequestRef
   maybe_kick_recovery(soid);
   waiting_for_degraded_object[soid].push_back(op);
   op->mark_delayed("waiting for degraded object");
+  osd->logger->inc(l_osd_op_delayed_degraded);
 }
 
 void PrimaryLogPG::block_write_on_full_cache(
@@ -2151,6 +2152,9 @@ void PrimaryLogPG::do_op(OpRequestRef& op)
     }
     if (!op->hitset_inserted) {
       hit_set->insert(oid);
+      if (read_freq) {
+	read_freq->insert(oid.get_hash());
+      }
       op->hitset_inserted = true;
       if (hit_set->is_full() ||
           hit_set_start_stamp + pool.info.hit_set_period <= m->get_recv_stamp()) {
@@ -3994,36 +3998,6 @@ int PrimaryLogPG::do_xattr_cmp_str(int op, string& v1s, bufferlist& xattr)
   }
 }
 
-int PrimaryLogPG::do_extent_cmp(OpContext *ctx, OSDOp& osd_op)
-{
-  ceph_osd_op& op = osd_op.op;
-  vector<OSDOp> read_ops(1);
-  OSDOp& read_op = read_ops[0];
-  int result = 0;
-
-  read_op.op.op = CEPH_OSD_OP_SYNC_READ;
-  read_op.op.extent.offset = op.extent.offset;
-  read_op.op.extent.length = op.extent.length;
-  read_op.op.extent.truncate_seq = op.extent.truncate_seq;
-  read_op.op.extent.truncate_size = op.extent.truncate_size;
-
-  result = do_osd_ops(ctx, read_ops);
-  if (result < 0) {
-    derr << "do_extent_cmp do_osd_ops failed " << result << dendl;
-    return result;
-  }
-
-  if (read_op.outdata.length() != osd_op.indata.length())
-    return -EINVAL;
-
-  for (uint64_t p = 0; p < osd_op.indata.length(); p++) {
-    if (read_op.outdata[p] != osd_op.indata[p]) {
-      return (-MAX_ERRNO - p);
-    }
-  }
-
-  return result;
-}
 
 int PrimaryLogPG::do_writesame(OpContext *ctx, OSDOp& osd_op)
 {
@@ -4481,6 +4455,108 @@ struct C_ChecksumRead : public Context {
   }
 };
 
+struct C_ExtentCmpRead : public Context {
+  PrimaryLogPG *primary_log_pg;
+  OSDOp &osd_op;
+  ceph_le64 read_length;
+  bufferlist read_bl;
+  Context *fill_extent_ctx;
+
+  C_ExtentCmpRead(PrimaryLogPG *primary_log_pg, OSDOp &osd_op,
+		  boost::optional<uint32_t> maybe_crc, uint64_t size,
+		  OSDService *osd, hobject_t soid, __le32 flags)
+    : primary_log_pg(primary_log_pg), osd_op(osd_op),
+      fill_extent_ctx(new FillInVerifyExtent(&read_length, &osd_op.rval,
+					     &read_bl, maybe_crc, size,
+					     osd, soid, flags)) {
+  }
+  ~C_ExtentCmpRead() override {
+    delete fill_extent_ctx;
+  }
+
+  void finish(int r) override {
+    if (r == -ENOENT) {
+      osd_op.rval = 0;
+      read_bl.clear();
+      delete fill_extent_ctx;
+    } else {
+      fill_extent_ctx->complete(r);
+    }
+    fill_extent_ctx = nullptr;
+
+    if (osd_op.rval >= 0) {
+      osd_op.rval = primary_log_pg->finish_extent_cmp(osd_op, read_bl);
+    }
+  }
+};
+
+int PrimaryLogPG::do_extent_cmp(OpContext *ctx, OSDOp& osd_op,
+				bool *async_read)
+{
+  dout(20) << __func__ << dendl;
+  ceph_osd_op& op = osd_op.op;
+
+  *async_read = false;
+  if (op.extent.length == 0) {
+    dout(20) << __func__ << " zero length extent" << dendl;
+    return finish_extent_cmp(osd_op, bufferlist());
+  } else if (!ctx->obs->exists || ctx->obs->oi.is_whiteout()) {
+    dout(20) << __func__ << " object DNE" << dendl;
+    return finish_extent_cmp(osd_op, bufferlist());
+  } else if (pool.info.require_rollback()) {
+    // If there is a data digest and it is possible we are reading
+    // entire object, pass the digest.
+    auto& oi = ctx->new_obs.oi;
+    boost::optional<uint32_t> maybe_crc;
+    if (oi.is_data_digest() && op.extent.offset == 0 &&
+        op.extent.length >= oi.size) {
+      maybe_crc = oi.data_digest;
+    }
+
+    // async read so the shard reads don't block the op thread; the
+    // compare runs from the read completion
+    auto& soid = oi.soid;
+    auto extent_cmp_ctx = new C_ExtentCmpRead(this, osd_op, maybe_crc,
+					      oi.size, osd, soid, op.flags);
+    ctx->pending_async_reads.push_back({
+      {op.extent.offset, op.extent.length, op.flags},
+      {&extent_cmp_ctx->read_bl, extent_cmp_ctx}});
+
+    dout(10) << __func__ << ": async_read noted for " << soid << dendl;
+    *async_read = true;
+    return 0;
+  }
+
+  // sync read
+  vector<OSDOp> read_ops(1);
+  OSDOp& read_op = read_ops[0];
+
+  read_op.op.op = CEPH_OSD_OP_SYNC_READ;
+  read_op.op.extent.offset = op.extent.offset;
+  read_op.op.extent.length = op.extent.length;
+  read_op.op.extent.truncate_seq = op.extent.truncate_seq;
+  read_op.op.extent.truncate_size = op.extent.truncate_size;
+
+  int result = do_osd_ops(ctx, read_ops);
+  if (result < 0) {
+    derr << __func__ << " failed " << result << dendl;
+    return result;
+  }
+  return finish_extent_cmp(osd_op, read_op.outdata);
+}
+
+int PrimaryLogPG::finish_extent_cmp(OSDOp& osd_op, const bufferlist &read_bl)
+{
+  for (uint64_t idx = 0; idx < osd_op.indata.length(); ++idx) {
+    char read_byte = (idx < read_bl.length() ? read_bl[idx] : 0);
+    if (osd_op.indata[idx] != read_byte) {
+      return (-MAX_ERRNO - idx);
+    }
+  }
+
+  return 0;
+}
+
 int PrimaryLogPG::do_checksum(OpContext *ctx, OSDOp& osd_op,
 			      bufferlist::iterator *bl_it, bool *async_read)
 {
@@ -4724,7 +4800,13 @@ int PrimaryLogPG::do_osd_ops(OpContext *ctx, vector<OSDOp>& ops)
     case CEPH_OSD_OP_CMPEXT:
       ++ctx->num_read;
       tracepoint(osd, do_osd_op_pre_extent_cmp, soid.oid.name.c_str(), soid.snap.val, oi.size, oi.truncate_seq, op.extent.offset, op.extent.length, op.extent.truncate_size, op.extent.truncate_seq);
-      result = do_extent_cmp(ctx, osd_op);
+      {
+	bool async_read;
+	result = do_extent_cmp(ctx, osd_op, &async_read);
+	if (result == 0 && async_read) {
+	  continue;
+	}
+      }
       break;
 
     case CEPH_OSD_OP_SYNC_READ:
@@ -4907,51 +4989,61 @@ int PrimaryLogPG::do_osd_ops(OpContext *ctx, vector<OSDOp>& ops)
 	  result = r;
           break;
 	}
-        map<uint64_t, uint64_t>::iterator miter;
         bufferlist data_bl;
-	uint64_t last = op.extent.offset;
-        for (miter = m.begin(); miter != m.end(); ++miter) {
-	  // verify hole?
-	  if (cct->_conf->osd_verify_sparse_read_holes &&
-	      last < miter->first) {
-	    bufferlist t;
-	    uint64_t len = miter->first - last;
-	    r = pgbackend->objects_read_sync(soid, last, len, op.flags, &t);
-	    if (r == -EIO) {
-	      r = rep_repair_primary_object(soid, ctx->op);
+	if (!cct->_conf->osd_verify_sparse_read_holes) {
+	  // read all the extents in a single pass over the object instead
+	  // of one backend read per extent; the backend trims m to what
+	  // was actually read
+	  r = pgbackend->objects_readv_sync(soid, m, op.flags, &data_bl);
+	  if (r < 0) {
+	    result = r;
+	    break;
+	  }
+	  total_read = r;
+	  dout(10) << "sparse-read " << m.size() << " extents" << dendl;
+	} else {
+	  map<uint64_t, uint64_t>::iterator miter;
+	  uint64_t last = op.extent.offset;
+	  for (miter = m.begin(); miter != m.end(); ++miter) {
+	    // verify hole?
+	    if (last < miter->first) {
+	      bufferlist t;
+	      uint64_t len = miter->first - last;
+	      r = pgbackend->objects_read_sync(soid, last, len, op.flags, &t);
+	      if (r == -EIO) {
+		r = rep_repair_primary_object(soid, ctx->op);
+	      }
+	      if (r < 0) {
+		osd->clog->error() << coll << " " << soid
+				   << " sparse-read failed to read: "
+				   << r;
+	      } else if (!t.is_zero()) {
+		osd->clog->error() << coll << " " << soid << " sparse-read found data in hole "
+				   << last << "~" << len;
+	      }
 	    }
+
+	    bufferlist tmpbl;
+	    r = pgbackend->objects_read_sync(soid, miter->first, miter->second, op.flags, &tmpbl);
 	    if (r < 0) {
-	      osd->clog->error() << coll << " " << soid
-				 << " sparse-read failed to read: "
-				 << r;
-	    } else if (!t.is_zero()) {
-	      osd->clog->error() << coll << " " << soid << " sparse-read found data in hole "
-				 << last << "~" << len;
+	      result = r;
+	      break;
 	    }
-	  }
 
-          bufferlist tmpbl;
-	  r = pgbackend->objects_read_sync(soid, miter->first, miter->second, op.flags, &tmpbl);
-          if (r < 0) {
-            result = r;
-            break;
-          }
+	    if (r < (int)miter->second) /* this is usually happen when we get extent that exceeds the actual file size */
+	      miter->second = r;
+	    total_read += r;
+	    dout(10) << "sparse-read " << miter->first << "@" << miter->second << dendl;
+	    data_bl.claim_append(tmpbl);
+	    last = miter->first + r;
+	  }
 
-          if (r < (int)miter->second) /* this is usually happen when we get extent that exceeds the actual file size */
-            miter->second = r;
-          total_read += r;
-          dout(10) << "sparse-read " << miter->first << "@" << miter->second << dendl;
-	  data_bl.claim_append(tmpbl);
-	  last = miter->first + r;
-        }
-        
-        if (r < 0) {
-          result = r;
-          break;
-        }
+	  if (r < 0) {
+	    result = r;
+	    break;
+	  }
 
-	// verify trailing hole?
-	if (cct->_conf->osd_verify_sparse_read_holes) {
+	  // verify trailing hole?
 	  uint64_t end = MIN(op.extent.offset + op.extent.length, oi.size);
 	  if (last < end) {
 	    bufferlist t;
@@ -11179,6 +11271,7 @@ uint64_t PrimaryLogPG::recover_primary(uint64_t max, ThreadPool::TPHandle &handl
   int skipped = 0;
 
   PGBackend::RecoveryHandle *h = pgbackend->open_recovery_op();
+  h->cache_dont_need = cct->_conf->osd_recovery_cache_dont_need;
   map<version_t, hobject_t>::const_iterator p =
     missing.get_rmissing().lower_bound(pg_log.get_log().last_requested);
   while (p != missing.get_rmissing().end()) {
@@ -11400,6 +11493,7 @@ uint64_t PrimaryLogPG::recover_replicas(uint64_t max, ThreadPool::TPHandle &hand
   uint64_t started = 0;
 
   PGBackend::RecoveryHandle *h = pgbackend->open_recovery_op();
+  h->cache_dont_need = cct->_conf->osd_recovery_cache_dont_need;
 
   // this is FAR from an optimal recovery order.  pretty lame, really.
   assert(!actingbackfill.empty());
@@ -11594,6 +11688,7 @@ uint64_t PrimaryLogPG::recover_backfill(
   backfill_info.trim_to(last_backfill_started);
 
   PGBackend::RecoveryHandle *h = pgbackend->open_recovery_op();
+  h->cache_dont_need = cct->_conf->osd_recovery_cache_dont_need;
   while (ops < max) {
     if (backfill_info.begin <= earliest_peer_backfill() &&
 	!backfill_info.extends_to_end() && backfill_info.empty()) {
@@ -12073,6 +12168,7 @@ void PrimaryLogPG::scan_range(
   dout(10) << " got " << ls.size() << " items, next " << bi->end << dendl;
   dout(20) << ls << dendl;
 
+  vector<hobject_t> missed;
   for (vector<hobject_t>::iterator p = ls.begin(); p != ls.end(); ++p) {
     handle.reset_tp_timeout();
     ObjectContextRef obc;
@@ -12082,20 +12178,27 @@ void PrimaryLogPG::scan_range(
       bi->objects[*p] = obc->obs.oi.version;
       dout(20) << "  " << *p << " " << obc->obs.oi.version << dendl;
     } else {
-      bufferlist bl;
-      int r = pgbackend->objects_get_attr(*p, OI_ATTR, &bl);
+      missed.push_back(*p);
+    }
+  }
 
-      /* If the object does not exist here, it must have been removed
-	 * between the collection_list_partial and here.  This can happen
-	 * for the first item in the range, which is usually last_backfill.
-	 */
-      if (r == -ENOENT)
-	continue;
+  if (!missed.empty()) {
+    // fetch all the missing object_infos in one pass through the store
+    // rather than one getattr round trip per object
+    map<hobject_t, bufferlist> attrs;
+    int r = pgbackend->objects_get_attr_batch(missed, OI_ATTR, &attrs);
+    assert(r >= 0);
+    handle.reset_tp_timeout();
 
-      assert(r >= 0);
-      object_info_t oi(bl);
-      bi->objects[*p] = oi.version;
-      dout(20) << "  " << *p << " " << oi.version << dendl;
+    /* Objects absent from the result were removed between the
+     * collection_list_partial and here.  This can happen for the first
+     * item in the range, which is usually last_backfill.
+     */
+    for (map<hobject_t, bufferlist>::iterator p = attrs.begin();
+	 p != attrs.end(); ++p) {
+      object_info_t oi(p->second);
+      bi->objects[p->first] = oi.version;
+      dout(20) << "  " << p->first << " " << oi.version << dendl;
     }
   }
 }
@@ -12182,6 +12285,7 @@ void PrimaryLogPG::hit_set_clear()
 {
   dout(20) << __func__ << dendl;
   hit_set.reset();
+  read_freq.reset();
   hit_set_start_stamp = utime_t();
 }
 
@@ -12291,6 +12395,15 @@ void PrimaryLogPG::hit_set_create()
   }
   hit_set.reset(new HitSet(params));
   hit_set_start_stamp = now;
+
+  unsigned sketch_width = cct->_conf->osd_agent_read_freq_sketch_width;
+  if (sketch_width > 0) {
+    if (!read_freq) {
+      read_freq.reset(new ReadFreqSketch(sketch_width));
+    }
+  } else {
+    read_freq.reset();
+  }
 }
 
 /**
@@ -12329,6 +12442,11 @@ void PrimaryLogPG::hit_set_persist()
   bufferlist bl;
   unsigned max = pool.info.hit_set_count;
 
+  // age frequency estimates once per hit set interval
+  if (read_freq) {
+    read_freq->decay();
+  }
+
   utime_t now = ceph_clock_now();
   hobject_t oid;
 
@@ -13185,8 +13303,14 @@ void PrimaryLogPG::agent_estimate_temp(const hobject_t& oid, int *temp)
   assert(hit_set);
   assert(temp);
   *temp = 0;
-  if (hit_set->contains(oid))
+  if (hit_set->contains(oid)) {
     *temp = 1000000;
+    if (read_freq) {
+      // weight by how often the object was hit recently, capped so a
+      // single scorching object cannot swamp the histogram
+      *temp += 100000 * MIN(read_freq->estimate(oid.get_hash()), 64u);
+    }
+  }
   unsigned i = 0;
   int last_n = pool.info.hit_set_search_last_n;
   for (map<time_t,HitSetRef>::reverse_iterator p =
@@ -13199,6 +13323,16 @@ void PrimaryLogPG::agent_estimate_temp(const hobject_t& oid, int *temp)
   }
 }
 
+void PrimaryLogPG::dump_object_heat(Formatter *f) const
+{
+  if (!read_freq) {
+    return;
+  }
+  f->open_object_section(stringify(info.pgid).c_str());
+  read_freq->dump(f);
+  f->close_section();
+}
+
 // Dup op detection
 
 bool PrimaryLogPG::already_complete(eversion_t v)
@@ -14101,6 +14235,7 @@ boost::statechart::result PrimaryLogPG::AwaitAsyncWork::react(const DoSnapWork&)
     ldout(pg->cct, 10) << "purged_snaps now "
 		       << pg->info.purged_snaps << ", snap_trimq now "
 		       << pg->snap_trimq << dendl;
+    pg->osd->logger->inc(l_osd_snaps_purged);
 
     ObjectStore::Transaction t;
     pg->dirty_big_info = true;
@@ -14144,6 +14279,7 @@ boost::statechart::result PrimaryLogPG::AwaitAsyncWork::react(const DoSnapWork&)
     ctx->register_on_success(
       [pg, object, &in_flight]() {
 	assert(in_flight.find(object) != in_flight.end());
+	pg->osd->logger->inc(l_osd_objects_trimmed);
 	in_flight.erase(object);
 	if (in_flight.empty()) {
 	  if (pg->state_test(PG_STATE_SNAPTRIM_ERROR)) {
@@ -883,6 +883,7 @@ protected:
   // hot/cold tracking
   HitSetRef hit_set;        ///< currently accumulating HitSet
   utime_t hit_set_start_stamp;    ///< time the current HitSet started recording
+  std::unique_ptr<ReadFreqSketch> read_freq; ///< per-object hit frequency
 
 
   void hit_set_clear();     ///< discard any HitSet state
@@ -894,6 +895,8 @@ protected:
   void hit_set_in_memory_trim(uint32_t max_in_memory); ///< discard old in memory HitSets
   void hit_set_remove_all();
 
+  void dump_object_heat(Formatter *f) const override;
+
   hobject_t get_hit_set_current_object(utime_t stamp);
   hobject_t get_hit_set_archive_object(utime_t start,
 				       utime_t end,
@@ -1331,7 +1334,11 @@ protected:
 
   friend class C_ChecksumRead;
 
-  int do_extent_cmp(OpContext *ctx, OSDOp& osd_op);
+  int do_extent_cmp(OpContext *ctx, OSDOp& osd_op, bool *async_read);
+  int finish_extent_cmp(OSDOp& osd_op, const bufferlist &read_bl);
+
+  friend class C_ExtentCmpRead;
+
   int do_writesame(OpContext *ctx, OSDOp& osd_op);
 
   bool pgls_filter(PGLSFilter *filter, hobject_t& sobj, bufferlist& outdata);
@@ -1767,6 +1774,9 @@ public:
   void on_flushed() override;
   void on_removal(ObjectStore::Transaction *t) override;
   void on_shutdown() override;
+  void set_context_cache_size(size_t count) override {
+    object_contexts.set_size(count);
+  }
   bool check_failsafe_full(ostream &ss) override;
   bool check_osdmap_full(const set<pg_shard_t> &missing_on) override;
   int rep_repair_primary_object(const hobject_t& soid, OpRequestRef op);
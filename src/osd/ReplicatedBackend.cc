@@ -278,6 +278,15 @@ int ReplicatedBackend::objects_read_sync(
   return store->read(ch, ghobject_t(hoid), off, len, *bl, op_flags);
 }
 
+int ReplicatedBackend::objects_readv_sync(
+  const hobject_t &hoid,
+  map<uint64_t, uint64_t>& m,
+  uint32_t op_flags,
+  bufferlist *bl)
+{
+  return store->readv(ch, ghobject_t(hoid), m, *bl, op_flags);
+}
+
 struct AsyncReadCallback : public GenContext<ThreadPool::TPHandle&> {
   int r;
   Context *c;
@@ -2005,8 +2014,13 @@ int ReplicatedBackend::build_push_op(const ObjectRecoveryInfo &recovery_info,
     if (!recovery_info.copy_subset.empty()) {
       interval_set<uint64_t> copy_subset = recovery_info.copy_subset;
       map<uint64_t, uint64_t> m;
-      int r = store->fiemap(ch, ghobject_t(recovery_info.soid), 0,
-                            copy_subset.range_end(), m);
+      // everything before data_recovered_to has been pushed already,
+      // no need to map it again on every chunk
+      int r = store->fiemap(ch, ghobject_t(recovery_info.soid),
+                            progress.data_recovered_to,
+                            copy_subset.range_end() -
+                              progress.data_recovered_to,
+                            m);
       if (r >= 0)  {
         interval_set<uint64_t> fiemap_included(m);
         copy_subset.intersection_of(fiemap_included);
@@ -2109,6 +2123,9 @@ bool ReplicatedBackend::handle_push_reply(
     PushInfo *pi = &pushing[soid][peer];
     bool error = pushing[soid].begin()->second.recovery_progress.error;
 
+    if (pi->chunks_in_flight > 0)
+      pi->chunks_in_flight--;
+
     if (!pi->recovery_progress.data_complete && !error) {
       dout(10) << " pushing more from, "
 	       << pi->recovery_progress.data_recovered_to
@@ -2127,7 +2144,13 @@ bool ReplicatedBackend::handle_push_reply(
 	goto done;
       }
       pi->recovery_progress = new_progress;
+      pi->chunks_in_flight++;
       return true;
+    } else if (pi->chunks_in_flight > 0 && !error) {
+      // all chunks are built and sent, wait for the remaining acks
+      dout(10) << " waiting for " << pi->chunks_in_flight
+	       << " in flight chunks of " << soid << dendl;
+      return false;
     } else {
       // done!
 done:
@@ -2303,6 +2326,28 @@ int ReplicatedBackend::start_pushes(
       }
       return r;
     }
+    // Keep a window of chunks in flight so a large object streams to
+    // the peer instead of paying a round trip per chunk; every ack in
+    // handle_push_reply refills the window by one chunk.
+    PushInfo &pi = pushing[soid][peer];
+    pi.chunks_in_flight = 1;
+    while (!pi.recovery_progress.data_complete &&
+	   (uint64_t)pi.chunks_in_flight <
+	     cct->_conf->osd_recovery_max_chunks_in_flight) {
+      h->pushes[peer].push_back(PushOp());
+      ObjectRecoveryProgress new_progress;
+      r = build_push_op(pi.recovery_info, pi.recovery_progress,
+			&new_progress, &(h->pushes[peer].back()),
+			&(pi.stat), cache);
+      if (r < 0) {
+	// drop the failed chunk; the ack paced path will retry the
+	// read and handle a persistent error
+	h->pushes[peer].pop_back();
+	break;
+      }
+      pi.recovery_progress = new_progress;
+      pi.chunks_in_flight++;
+    }
   }
   return shards.size();
 }
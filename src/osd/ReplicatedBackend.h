@@ -153,6 +153,12 @@ public:
     uint32_t op_flags,
     bufferlist *bl) override;
 
+  int objects_readv_sync(
+    const hobject_t &hoid,
+    map<uint64_t, uint64_t>& m,
+    uint32_t op_flags,
+    bufferlist *bl) override;
+
   void objects_read_async(
     const hobject_t &hoid,
     const list<pair<boost::tuple<uint64_t, uint64_t, uint32_t>,
@@ -168,8 +174,10 @@ private:
     ObjectContextRef obc;
     object_stat_sum_t stat;
     ObcLockManager lock_manager;
+    int chunks_in_flight = 0; ///< push ops sent to the peer, not yet acked
 
     void dump(Formatter *f) const {
+      f->dump_int("chunks_in_flight", chunks_in_flight);
       {
 	f->open_object_section("recovery_progress");
 	recovery_progress.dump(f);
@@ -204,6 +204,7 @@ void Notify::maybe_complete_notify()
     unregister_cb();
 
     complete = true;
+    osd->logger->tinc(l_osd_notify_lat, ceph_clock_now() - start_time);
   }
 }
 
@@ -218,6 +219,9 @@ void Notify::discard()
 void Notify::init()
 {
   Mutex::Locker l(lock);
+  start_time = ceph_clock_now();
+  osd->logger->inc(l_osd_notify);
+  osd->logger->inc(l_osd_notify_watchers, watchers.size());
   register_cb();
   maybe_complete_notify();
 }
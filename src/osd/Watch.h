@@ -63,6 +63,7 @@ class Notify {
   uint64_t cookie;
   uint64_t notify_id;
   uint64_t version;
+  utime_t start_time;  ///< when init() began the fan-out
 
   OSDService *osd;
   CancelableContext *cb;
@@ -104,16 +104,36 @@ namespace ceph {
     osd_op_type_t type =
       boost::apply_visitor(pg_queueable_visitor, request.second.get_variant());
 
-    // if we got client_op back then we need to distinguish between
-    // a client op and an osd subop.
-
     if (osd_op_type_t::client_op != type) {
       return type;
-    } else if (MSG_OSD_SUBOP ==
-	       boost::get<OpRequestRef>(
-		 request.second.get_variant())->get_req()->get_header().type) {
+    }
+
+    // if we got client_op back then we need to distinguish between a
+    // true client op and the messages OSDs send each other, so that
+    // replication traffic and replica-side background work (recovery
+    // pushes, rep scrub) are scheduled in the class whose work they
+    // carry out rather than competing as client ops.
+    switch (boost::get<OpRequestRef>(
+	      request.second.get_variant())->get_req()->get_header().type) {
+    case MSG_OSD_SUBOP:
+    case MSG_OSD_SUBOPREPLY:
+    case MSG_OSD_REPOP:
+    case MSG_OSD_REPOPREPLY:
+    case MSG_OSD_EC_WRITE:
+    case MSG_OSD_EC_WRITE_REPLY:
+    case MSG_OSD_EC_READ:
+    case MSG_OSD_EC_READ_REPLY:
       return osd_op_type_t::osd_subop;
-    } else {
+    case MSG_OSD_PG_PUSH:
+    case MSG_OSD_PG_PULL:
+    case MSG_OSD_PG_PUSH_REPLY:
+    case MSG_OSD_PG_SCAN:
+    case MSG_OSD_PG_BACKFILL:
+    case MSG_OSD_PG_BACKFILL_REMOVE:
+      return osd_op_type_t::bg_recovery;
+    case MSG_OSD_REP_SCRUB:
+      return osd_op_type_t::bg_scrub;
+    default:
       return osd_op_type_t::client_op;
     }
   }
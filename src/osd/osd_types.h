@@ -1033,6 +1033,7 @@ public:
     CSUM_TYPE,
     CSUM_MAX_BLOCK,
     CSUM_MIN_BLOCK,
+    COMPRESSION_DICTIONARY, ///< base64 encoded trained dictionary blob
   };
 
   enum type_t {
@@ -3389,6 +3390,44 @@ WRITE_CLASS_ENCODER(pg_log_entry_t)
 
 ostream& operator<<(ostream& out, const pg_log_entry_t& e);
 
+/**
+ * pg_log_dup_t - compact remnant of a trimmed log entry
+ *
+ * Enough of a trimmed pg_log_entry_t to still answer "have we already
+ * seen this reqid, and with what result" for replay dup detection,
+ * without keeping the whole entry (and its mod_desc) in memory.
+ */
+struct pg_log_dup_t {
+  osd_reqid_t reqid;  // caller+tid to uniquely identify request
+  eversion_t version;
+  version_t user_version; // the user version for this op
+  int32_t return_code; // only stored for ERRORs for dup detection
+
+  pg_log_dup_t()
+    : user_version(0), return_code(0)
+  {}
+  explicit pg_log_dup_t(const pg_log_entry_t& entry)
+    : reqid(entry.reqid), version(entry.version),
+      user_version(entry.user_version), return_code(entry.return_code)
+  {}
+  pg_log_dup_t(const eversion_t& v, version_t uv,
+	       const osd_reqid_t& rid, int return_code)
+    : reqid(rid), version(v), user_version(uv),
+      return_code(return_code)
+  {}
+
+  string get_key_name() const;
+  void encode(bufferlist &bl) const;
+  void decode(bufferlist::iterator &bl);
+  void dump(Formatter *f) const;
+  static void generate_test_instances(list<pg_log_dup_t*>& o);
+
+  friend std::ostream& operator<<(std::ostream& out, const pg_log_dup_t& e);
+};
+WRITE_CLASS_ENCODER(pg_log_dup_t)
+
+std::ostream& operator<<(std::ostream& out, const pg_log_dup_t& e);
+
 
 
 /**
@@ -3416,7 +3455,10 @@ protected:
 
 public:
   mempool::osd_pglog::list<pg_log_entry_t> log;  // the actual log.
-  
+
+  // entries just for dup op detection ordered oldest to newest
+  mempool::osd_pglog::list<pg_log_dup_t> dups;
+
   pg_log_t() = default;
   pg_log_t(const eversion_t &last_update,
 	   const eversion_t &log_tail,
@@ -3437,11 +3479,25 @@ public:
       log.push_back(entry);
     }
   }
+  pg_log_t(const eversion_t &last_update,
+	   const eversion_t &log_tail,
+	   const eversion_t &can_rollback_to,
+	   const eversion_t &rollback_info_trimmed_to,
+	   const std::list<pg_log_entry_t> &entries,
+	   mempool::osd_pglog::list<pg_log_dup_t> &&dup_entries)
+    : head(last_update), tail(log_tail), can_rollback_to(can_rollback_to),
+      rollback_info_trimmed_to(rollback_info_trimmed_to),
+      dups(std::move(dup_entries)) {
+    for (auto &&entry: entries) {
+      log.push_back(entry);
+    }
+  }
 
   void clear() {
     eversion_t z;
     rollback_info_trimmed_to = can_rollback_to = head = tail = z;
     log.clear();
+    dups.clear();
   }
 
   eversion_t get_rollback_info_trimmed_to() const {
@@ -3469,12 +3525,18 @@ public:
       oldlog.erase(i++);
     }
 
-    return pg_log_t(
+    // dup entries are keyed by reqid, not object, so we can't tell
+    // which child they belong to; keep a copy in both.  a reqid only
+    // ever resends to the pg its object hashes to, so the extra
+    // entries can never produce a false dup hit.
+    pg_log_t childret(
       head,
       tail,
       can_rollback_to,
       rollback_info_trimmed_to,
       std::move(childlog));
+    childret.dups = dups;
+    return childret;
   }
 
   mempool::osd_pglog::list<pg_log_entry_t> rewind_from_head(eversion_t newhead) {
@@ -195,14 +195,14 @@ void ObjectCacher::Object::merge_left(BufferHead *left, BufferHead *right)
   ldout(oc->cct, 10) << "merge_left result " << *left << dendl;
 }
 
-void ObjectCacher::Object::try_merge_bh(BufferHead *bh)
+ObjectCacher::BufferHead *ObjectCacher::Object::try_merge_bh(BufferHead *bh)
 {
   assert(oc->lock.is_locked());
   ldout(oc->cct, 10) << "try_merge_bh " << *bh << dendl;
 
   // do not merge rx buffers; last_read_tid may not match
   if (bh->is_rx())
-    return;
+    return bh;
 
   // to the left?
   map<loff_t,BufferHead*>::iterator p = data.find(bh->start());
@@ -226,6 +226,8 @@ void ObjectCacher::Object::try_merge_bh(BufferHead *bh)
       p->second->get_state() == bh->get_state() &&
       p->second->can_merge_journal(bh))
     merge_left(bh, p->second);
+
+  return bh;
 }
 
 /*
@@ -1217,7 +1219,7 @@ void ObjectCacher::bh_write_commit(int64_t poolid, sobject_t oid,
     finish_contexts(cct, ls, r);
 }
 
-void ObjectCacher::flush(ZTracer::Trace *trace, loff_t amount)
+loff_t ObjectCacher::flush(ZTracer::Trace *trace, loff_t amount, int max_count)
 {
   assert(trace != nullptr);
   assert(lock.is_locked());
@@ -1232,19 +1234,30 @@ void ObjectCacher::flush(ZTracer::Trace *trace, loff_t amount)
    * lru_dirty.lru_get_next_expire() again.
    */
   int64_t left = amount;
+  int count = max_count;
   while (amount == 0 || left > 0) {
+    if (max_count > 0 && count <= 0)
+      break;
     BufferHead *bh = static_cast<BufferHead*>(
       bh_lru_dirty.lru_get_next_expire());
     if (!bh) break;
     if (bh->last_write > cutoff) break;
 
     if (scattered_write) {
-      bh_write_adjacencies(bh, cutoff, amount > 0 ? &left : NULL, NULL);
+      bh_write_adjacencies(bh, cutoff, amount > 0 ? &left : NULL,
+			   max_count > 0 ? &count : NULL);
     } else {
+      // coalesce with contiguous dirty neighbors so we issue one
+      // larger write instead of several small ones
+      bh = bh->ob->try_merge_bh(bh);
       left -= bh->length();
       bh_write(bh, *trace);
+      --count;
     }
   }
+  if (amount == 0)
+    return 0;
+  return left < 0 ? amount : amount - left;
 }
 
 
@@ -1885,7 +1898,20 @@ void ObjectCacher::flusher_entry()
       ldout(cct, 10) << "flusher " << get_stat_dirty() << " dirty + "
 		     << get_stat_dirty_waiting() << " dirty_waiting > target "
 		     << target_dirty << ", flushing some dirty bhs" << dendl;
-      flush(&trace, actual - target_dirty);
+      // flush in bounded batches, backing off the lock between them so
+      // that a large dirty backlog doesn't starve readers/writers who
+      // share our lock
+      loff_t need = actual - target_dirty;
+      while (need > 0 && !flusher_stop) {
+	loff_t n = flush(&trace, need, MAX_FLUSH_UNDER_LOCK);
+	if (n == 0)
+	  break;
+	need -= n;
+	if (need > 0) {
+	  lock.Unlock();
+	  lock.Lock();
+	}
+      }
     } else {
       // check tail of lru for old dirty items
       ceph::real_time cutoff = ceph::real_clock::now();
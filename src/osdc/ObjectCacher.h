@@ -341,7 +341,7 @@ class ObjectCacher {
     // mid-level
     BufferHead *split(BufferHead *bh, loff_t off);
     void merge_left(BufferHead *left, BufferHead *right);
-    void try_merge_bh(BufferHead *bh);
+    BufferHead* try_merge_bh(BufferHead *bh);
 
     bool is_cached(loff_t off, loff_t len) const;
     bool include_all_cached_data(loff_t off, loff_t len);
@@ -530,7 +530,7 @@ class ObjectCacher {
 			    int64_t *amount, int *max_count);
 
   void trim();
-  void flush(ZTracer::Trace *trace, loff_t amount=0);
+  loff_t flush(ZTracer::Trace *trace, loff_t amount=0, int max_count=0);
 
   /**
    * flush a range of buffers
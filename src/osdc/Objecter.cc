@@ -42,6 +42,7 @@
 
 #include "messages/MWatchNotify.h"
 
+#include <atomic>
 #include <errno.h>
 
 #include "common/config.h"
@@ -73,6 +74,7 @@ enum {
   l_osdc_op_send_bytes,
   l_osdc_op_resend,
   l_osdc_op_reply,
+  l_osdc_op_latency,
 
   l_osdc_op,
   l_osdc_op_r,
@@ -147,6 +149,9 @@ enum {
 };
 
 
+// process-wide counter for 1-in-N trace sampling (see _prepare_osd_op)
+static std::atomic<uint64_t> trace_sample_count(0);
+
 // config obs ----------------------------
 
 static const char *config_keys[] = {
@@ -249,6 +254,17 @@ void Objecter::init()
     pcb.add_u64_counter(l_osdc_op_send_bytes, "op_send_bytes", "Sent data");
     pcb.add_u64_counter(l_osdc_op_resend, "op_resend", "Resent operations");
     pcb.add_u64_counter(l_osdc_op_reply, "op_reply", "Operation reply");
+    // operation round trip time, values are in nanoseconds
+    PerfHistogramCommon::axis_config_d op_latency_axis_config{
+      "Latency (nsec)",
+      PerfHistogramCommon::SCALE_LOG2, ///< Latency in logarithmic scale
+      0,                               ///< Start at 0
+      100000,                          ///< Quantization unit is 100usec
+      32,                              ///< Enough to cover much longer than slow requests
+    };
+    pcb.add_time_avg_histogram(l_osdc_op_latency, "op_latency",
+			       op_latency_axis_config,
+			       "Operation round trip time since last send");
 
     pcb.add_u64_counter(l_osdc_op, "op", "Operations");
     pcb.add_u64_counter(l_osdc_op_r, "op_r", "Read operations", "rd",
@@ -1009,10 +1025,52 @@ bool Objecter::ms_dispatch(Message *m)
   return false;
 }
 
+/**
+ * Collect the pgs whose mapping an incremental may have changed.
+ *
+ * Returns true iff every mapping change in @inc can be attributed to
+ * specific pgs, in which case those pgs are added to @pgs.  Anything
+ * that can move mappings through crush (osd state, weight or address
+ * changes, crush or pool updates, flag changes) makes per-pg
+ * attribution impossible and returns false, meaning all requests must
+ * be rescanned.  pg_temp/primary_temp and pg-upmap churn -- the bulk
+ * of a map storm during recovery -- is per-pg attributable.
+ */
+bool Objecter::_get_changed_pgs(const OSDMap::Incremental& inc,
+				set<pg_t> *pgs)
+{
+  if (inc.fullmap.length() ||
+      inc.crush.length() ||
+      inc.new_flags >= 0 ||
+      inc.new_max_osd >= 0 ||
+      !inc.new_pools.empty() ||
+      !inc.old_pools.empty() ||
+      !inc.new_up_client.empty() ||
+      !inc.new_state.empty() ||
+      !inc.new_weight.empty() ||
+      !inc.new_primary_affinity.empty()) {
+    return false;
+  }
+  for (auto& p : inc.new_pg_temp)
+    pgs->insert(p.first);
+  for (auto& p : inc.new_primary_temp)
+    pgs->insert(p.first);
+  for (auto& p : inc.new_pg_upmap)
+    pgs->insert(p.first);
+  for (auto& p : inc.new_pg_upmap_items)
+    pgs->insert(p.first);
+  for (auto& pg : inc.old_pg_upmap)
+    pgs->insert(pg);
+  for (auto& pg : inc.old_pg_upmap_items)
+    pgs->insert(pg);
+  return true;
+}
+
 void Objecter::_scan_requests(OSDSession *s,
 			      bool force_resend,
 			      bool cluster_full,
 			      map<int64_t, bool> *pool_full_map,
+			      const set<pg_t> *changed_pgs,
 			      map<ceph_tid_t, Op*>& need_resend,
 			      list<LingerOp*>& need_resend_linger,
 			      map<ceph_tid_t, CommandOp*>& need_resend_command,
@@ -1034,10 +1092,15 @@ void Objecter::_scan_requests(OSDSession *s,
     ++lp;
     ldout(cct, 10) << " checking linger op " << op->linger_id << dendl;
     bool unregister, force_resend_writes = cluster_full;
-    int r = _recalc_linger_op_target(op, sul);
     if (pool_full_map)
       force_resend_writes = force_resend_writes ||
 	(*pool_full_map)[op->target.base_oloc.pool];
+    if (changed_pgs && !force_resend && !force_resend_writes &&
+	!changed_pgs->count(op->target.actual_pgid.pgid)) {
+      // this epoch cannot have changed the mapping
+      continue;
+    }
+    int r = _recalc_linger_op_target(op, sul);
     switch (r) {
     case RECALC_OP_TARGET_NO_ACTION:
       if (!force_resend && !force_resend_writes)
@@ -1069,6 +1132,11 @@ void Objecter::_scan_requests(OSDSession *s,
     if (pool_full_map)
       force_resend_writes = force_resend_writes ||
 	(*pool_full_map)[op->target.base_oloc.pool];
+    if (changed_pgs && !force_resend && !force_resend_writes &&
+	!changed_pgs->count(op->target.actual_pgid.pgid)) {
+      // this epoch cannot have changed the mapping
+      continue;
+    }
     int r = _calc_target(&op->target,
 			 op->session ? op->session->con.get() : nullptr);
     switch (r) {
@@ -1131,6 +1199,20 @@ void Objecter::_scan_requests(OSDSession *s,
   }
 }
 
+void Objecter::_prune_pg_mappings(const OSDMap& map)
+{
+  unique_lock l(pg_mapping_lock);
+  auto p = pg_mappings.begin();
+  while (p != pg_mappings.end()) {
+    const pg_pool_t *pi = map.get_pg_pool(p->first.pool());
+    if (!pi || p->first.ps() >= pi->get_pg_num()) {
+      p = pg_mappings.erase(p);
+    } else {
+      ++p;
+    }
+  }
+}
+
 void Objecter::handle_osd_map(MOSDMap *m)
 {
   shunique_lock sul(rwlock, acquire_unique);
@@ -1171,6 +1253,8 @@ void Objecter::handle_osd_map(MOSDMap *m)
 
     if (osdmap->get_epoch()) {
       bool skipped_map = false;
+      set<pg_t> changed_pgs;
+      bool scan_all = false;
       // we want incrementals
       for (epoch_t e = osdmap->get_epoch() + 1;
 	   e <= m->get_last();
@@ -1181,6 +1265,8 @@ void Objecter::handle_osd_map(MOSDMap *m)
 	  ldout(cct, 3) << "handle_osd_map decoding incremental epoch " << e
 			<< dendl;
 	  OSDMap::Incremental inc(m->incremental_maps[e]);
+	  if (!_get_changed_pgs(inc, &changed_pgs))
+	    scan_all = true;
 	  osdmap->apply_incremental(inc);
 
           emit_blacklist_events(inc);
@@ -1196,6 +1282,7 @@ void Objecter::handle_osd_map(MOSDMap *m)
 
           osdmap = new_osdmap;
 
+	  scan_all = true;
 	  logger->inc(l_osdc_map_full);
 	}
 	else {
@@ -1217,26 +1304,37 @@ void Objecter::handle_osd_map(MOSDMap *m)
 	cluster_full = cluster_full || _osdmap_full_flag();
 	update_pool_full_map(pool_full_map);
 
-	// check all outstanding requests on every epoch
-	_scan_requests(homeless_session, skipped_map, cluster_full,
-		       &pool_full_map, need_resend,
+	assert(e == osdmap->get_epoch());
+      }
+
+      // scan outstanding requests once against the final map rather
+      // than once per epoch; a recovery storm can deliver dozens of
+      // epochs in one message and the intermediate targets are moot.
+      // if every incremental's change set was attributable to specific
+      // pgs, only requests targeting the union need a recalc.
+      const set<pg_t> *scan_pgs =
+	(!scan_all && !skipped_map) ? &changed_pgs : nullptr;
+      if (scan_pgs) {
+	ldout(cct, 10) << __func__ << " epoch " << osdmap->get_epoch()
+		       << " limiting scan to " << scan_pgs->size()
+		       << " changed pgs" << dendl;
+      }
+      _scan_requests(homeless_session, skipped_map, cluster_full,
+		     &pool_full_map, scan_pgs, need_resend,
+		     need_resend_linger, need_resend_command, sul);
+      for (map<int,OSDSession*>::iterator p = osd_sessions.begin();
+	   p != osd_sessions.end(); ) {
+	OSDSession *s = p->second;
+	_scan_requests(s, skipped_map, cluster_full,
+		       &pool_full_map, scan_pgs, need_resend,
 		       need_resend_linger, need_resend_command, sul);
-	for (map<int,OSDSession*>::iterator p = osd_sessions.begin();
-	     p != osd_sessions.end(); ) {
-	  OSDSession *s = p->second;
-	  _scan_requests(s, skipped_map, cluster_full,
-			 &pool_full_map, need_resend,
-			 need_resend_linger, need_resend_command, sul);
-	  ++p;
-	  // osd down or addr change?
-	  if (!osdmap->is_up(s->osd) ||
-	      (s->con &&
-	       s->con->get_peer_addr() != osdmap->get_inst(s->osd).addr)) {
-	    close_session(s);
-	  }
+	++p;
+	// osd down or addr change?
+	if (!osdmap->is_up(s->osd) ||
+	    (s->con &&
+	     s->con->get_peer_addr() != osdmap->get_inst(s->osd).addr)) {
+	  close_session(s);
 	}
-
-	assert(e == osdmap->get_epoch());
       }
 
     } else {
@@ -1245,14 +1343,14 @@ void Objecter::handle_osd_map(MOSDMap *m)
 	for (map<int,OSDSession*>::iterator p = osd_sessions.begin();
 	     p != osd_sessions.end(); ++p) {
 	  OSDSession *s = p->second;
-	  _scan_requests(s, false, false, NULL, need_resend,
+	  _scan_requests(s, false, false, NULL, nullptr, need_resend,
 			 need_resend_linger, need_resend_command, sul);
 	}
 	ldout(cct, 3) << "handle_osd_map decoding full epoch "
 		      << m->get_last() << dendl;
 	osdmap->decode(m->maps[m->get_last()]);
 
-	_scan_requests(homeless_session, false, false, NULL,
+	_scan_requests(homeless_session, false, false, NULL, nullptr,
 		       need_resend, need_resend_linger,
 		       need_resend_command, sul);
       } else {
@@ -1262,6 +1360,10 @@ void Objecter::handle_osd_map(MOSDMap *m)
 	monc->renew_subs();
       }
     }
+
+    // drop cached mappings for pgs that no longer exist; surviving
+    // stale entries are refreshed lazily by _calc_target
+    _prune_pg_mappings(*osdmap);
   }
 
   // make sure need_resend targets reflect latest map
@@ -2260,6 +2362,18 @@ void Objecter::op_submit(Op *op, ceph_tid_t *ptid, int *ctx_budget)
   _op_submit_with_budget(op, rl, ptid, ctx_budget);
 }
 
+void Objecter::op_submit_batch(vector<Op*>& ops, vector<ceph_tid_t*>& ptids)
+{
+  assert(ptids.empty() || ptids.size() == ops.size());
+  shunique_lock rl(rwlock, ceph::acquire_shared);
+  for (size_t i = 0; i < ops.size(); ++i) {
+    ceph_tid_t tid = 0;
+    ceph_tid_t *ptid = (!ptids.empty() && ptids[i]) ? ptids[i] : &tid;
+    ops[i]->trace.event("op submit");
+    _op_submit_with_budget(ops[i], rl, ptid, NULL);
+  }
+}
+
 void Objecter::_op_submit_with_budget(Op *op, shunique_lock& sul,
 				      ceph_tid_t *ptid,
 				      int *ctx_budget)
@@ -2818,8 +2932,21 @@ int Objecter::_calc_target(op_target_t *t, Connection *con, bool any_change)
   unsigned pg_num = pi->get_pg_num();
   int up_primary, acting_primary;
   vector<int> up, acting;
-  osdmap->pg_to_up_acting_osds(pgid, &up, &up_primary,
-			       &acting, &acting_primary);
+  ps_t actual_ps = ceph_stable_mod(pgid.ps(), pg_num, pi->get_pg_num_mask());
+  pg_t actual_pgid(actual_ps, pgid.pool());
+  pg_mapping_t pg_mapping;
+  if (_lookup_pg_mapping(actual_pgid, osdmap->get_epoch(), &pg_mapping)) {
+    up = std::move(pg_mapping.up);
+    up_primary = pg_mapping.up_primary;
+    acting = std::move(pg_mapping.acting);
+    acting_primary = pg_mapping.acting_primary;
+  } else {
+    osdmap->pg_to_up_acting_osds(actual_pgid, &up, &up_primary,
+				 &acting, &acting_primary);
+    _update_pg_mapping(actual_pgid,
+		       pg_mapping_t(osdmap->get_epoch(), up, up_primary,
+				    acting, acting_primary));
+  }
   bool sort_bitwise = osdmap->test_flag(CEPH_OSDMAP_SORTBITWISE);
   unsigned prev_seed = ceph_stable_mod(pgid.ps(), t->pg_num, t->pg_num_mask);
   pg_t prev_pgid(prev_seed, pgid.pool());
@@ -3087,7 +3214,7 @@ void Objecter::_finish_op(Op *op, int r)
 
   // op->session->lock is locked unique or op->session is null
 
-  if (!op->ctx_budgeted && op->budgeted)
+  if (!op->ctx_budgeted && op->budget >= 0)
     put_op_budget(op);
 
   if (op->ontimeout && r != -ETIMEDOUT)
@@ -3153,7 +3280,10 @@ MOSDOp *Objecter::_prepare_osd_op(Op *op)
   m->set_mtime(op->mtime);
   m->set_retry_attempt(op->attempts++);
 
-  if (!op->trace.valid() && cct->_conf->osdc_blkin_trace_all) {
+  if (!op->trace.valid() &&
+      (cct->_conf->osdc_blkin_trace_all ||
+       (cct->_conf->osdc_blkin_trace_every_n &&
+	(++trace_sample_count % cct->_conf->osdc_blkin_trace_every_n) == 0))) {
     op->trace.init("op", &trace_endpoint);
   }
 
@@ -3498,6 +3628,7 @@ void Objecter::handle_osd_op_reply(MOSDOpReply *m)
     op->onfinish = NULL;
   }
   logger->inc(l_osdc_op_reply);
+  logger->tinc(l_osdc_op_latency, ceph::mono_clock::now() - op->stamp);
 
   /* get it before we call _finish_op() */
   auto completion_lock = s->get_lock(op->target.base_oid);
@@ -1226,6 +1226,47 @@ private:
   using unique_lock = std::unique_lock<decltype(rwlock)>;
   using shared_lock = boost::shared_lock<decltype(rwlock)>;
   using shunique_lock = ceph::shunique_lock<decltype(rwlock)>;
+
+  /**
+   * Cached pg -> up/acting mapping.
+   *
+   * pg_to_up_acting_osds() is a pure function of the osdmap, so once
+   * we have run crush for a pg we can reuse the result for every op
+   * that lands in that pg until the map changes.  Entries carry the
+   * epoch they were computed at and are refreshed lazily on lookup;
+   * pgs that cease to exist are pruned when a new map arrives.
+   */
+  struct pg_mapping_t {
+    epoch_t epoch = 0;
+    vector<int> up;
+    int up_primary = -1;
+    vector<int> acting;
+    int acting_primary = -1;
+
+    pg_mapping_t() {}
+    pg_mapping_t(epoch_t epoch, vector<int> up, int up_primary,
+		 vector<int> acting, int acting_primary)
+      : epoch(epoch), up(std::move(up)), up_primary(up_primary),
+	acting(std::move(acting)), acting_primary(acting_primary) {}
+  };
+  mutable boost::shared_mutex pg_mapping_lock;
+  map<pg_t, pg_mapping_t> pg_mappings;  ///< (actual) pg -> mapping
+
+  bool _lookup_pg_mapping(const pg_t& pg, epoch_t epoch,
+			  pg_mapping_t *pg_mapping) const {
+    shared_lock l(pg_mapping_lock);
+    auto p = pg_mappings.find(pg);
+    if (p == pg_mappings.end() ||
+	p->second.epoch != epoch)
+      return false;
+    *pg_mapping = p->second;
+    return true;
+  }
+  void _update_pg_mapping(const pg_t& pg, pg_mapping_t&& pg_mapping) {
+    unique_lock l(pg_mapping_lock);
+    pg_mappings[pg] = std::move(pg_mapping);
+  }
+  void _prune_pg_mappings(const OSDMap& map);
   ceph::timer<ceph::mono_clock> timer;
 
   PerfCounters *logger;
@@ -1351,7 +1392,9 @@ public:
 
     epoch_t map_dne_bound;
 
-    bool budgeted;
+    /// throttle budget taken for this op, or -1 if none; remembering
+    /// it here avoids recomputing it from the op vector on completion
+    int budget;
 
     /// true if we should resend this message on failure
     bool should_resend;
@@ -1384,7 +1427,7 @@ public:
       objver(ov),
       reply_epoch(NULL),
       map_dne_bound(0),
-      budgeted(false),
+      budget(-1),
       should_resend(true),
       ctx_budgeted(false),
       data_offset(offset) {
@@ -1973,7 +2016,7 @@ private:
       op_throttle_bytes.take(op_budget);
       op_throttle_ops.take(1);
     }
-    op->budgeted = true;
+    op->budget = op_budget;
     return op_budget;
   }
   void put_op_budget_bytes(int op_budget) {
@@ -1982,9 +2025,9 @@ private:
     op_throttle_ops.put(1);
   }
   void put_op_budget(Op *op) {
-    assert(op->budgeted);
-    int op_budget = calc_op_budget(op);
-    put_op_budget_bytes(op_budget);
+    assert(op->budget >= 0);
+    put_op_budget_bytes(op->budget);
+    op->budget = -1;
   }
   void put_nlist_context_budget(NListContext *list_context);
   Throttle op_throttle_bytes, op_throttle_ops;
@@ -2057,11 +2100,15 @@ private:
 		      bool force_resend,
 		      bool cluster_full,
 		      map<int64_t, bool> *pool_full_map,
+		      const set<pg_t> *changed_pgs,
 		      map<ceph_tid_t, Op*>& need_resend,
 		      list<LingerOp*>& need_resend_linger,
 		      map<ceph_tid_t, CommandOp*>& need_resend_command,
 		      shunique_lock& sul);
 
+  static bool _get_changed_pgs(const OSDMap::Incremental& inc,
+			       set<pg_t> *pgs);
+
   int64_t get_object_hash_position(int64_t pool, const string& key,
 				   const string& ns);
   int64_t get_object_pg_hash_position(int64_t pool, const string& key,
@@ -2127,6 +2174,9 @@ private:
   // public interface
 public:
   void op_submit(Op *op, ceph_tid_t *ptid = NULL, int *ctx_budget = NULL);
+  /// submit several prepared ops while taking the objecter state lock
+  /// only once; ptids must be empty or have one slot per op
+  void op_submit_batch(vector<Op*>& ops, vector<ceph_tid_t*>& ptids);
   bool is_active() {
     shared_lock l(rwlock);
     return !((!inflight_ops) && linger_ops.empty() &&
@@ -33,6 +33,53 @@ void Striper::file_to_extents(CephContext *cct, const char *object_format,
 			      vector<ObjectExtent>& extents,
 			      uint64_t buffer_offset)
 {
+  if (layout->stripe_count == 1) {
+    // fast path: with no striping each object covers a single contiguous
+    // range of the file, so the extents can be computed arithmetically in
+    // object order directly into the caller's (reusable) vector without
+    // the intermediate per-object map
+    ldout(cct, 10) << "file_to_extents " << offset << "~" << len
+		   << " format " << object_format
+		   << dendl;
+    assert(len > 0);
+
+    __u32 object_size = layout->object_size;
+    uint64_t cur = offset;
+    uint64_t left = len;
+    extents.reserve(extents.size() +
+		    ((offset % object_size) + len + object_size - 1) /
+		      object_size);
+    while (left > 0) {
+      uint64_t objectno = cur / object_size;
+      uint64_t block_off = cur % object_size;
+      uint64_t x_len = MIN(left, object_size - block_off);
+
+      char buf[strlen(object_format) + 32];
+      snprintf(buf, sizeof(buf), object_format, (long long unsigned)objectno);
+
+      extents.resize(extents.size() + 1);
+      ObjectExtent &ex = extents.back();
+      ex.oid = object_t(buf);
+      ex.objectno = objectno;
+      ex.oloc = OSDMap::file_to_object_locator(*layout);
+      ex.offset = block_off;
+      ex.length = x_len;
+      ex.truncate_size = object_truncate_size(cct, layout, objectno,
+					      trunc_size);
+      ex.buffer_extents.push_back(make_pair(cur - offset + buffer_offset,
+					    x_len));
+
+      ldout(cct, 20) << " off " << cur << " objectno " << objectno << " "
+		     << block_off << "~" << x_len << dendl;
+      ldout(cct, 15) << "file_to_extents  " << ex << " in " << ex.oloc
+		     << dendl;
+
+      left -= x_len;
+      cur += x_len;
+    }
+    return;
+  }
+
   map<object_t,vector<ObjectExtent> > object_extents;
   file_to_extents(cct, object_format, layout, offset, len, trunc_size,
 		  object_extents, buffer_offset);
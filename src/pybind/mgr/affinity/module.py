@@ -0,0 +1,231 @@
+
+"""
+Automatic primary affinity adjustment from observed read service times
+
+Watches the per-OSD read latency counters reported to the mgr, scores
+each OSD against the cluster median, and gradually shifts primary
+affinity away from outliers so a dying-but-not-dead disk stops leading
+PGs long before an operator notices it by hand.
+"""
+
+import errno
+import json
+from threading import Event
+
+from mgr_module import MgrModule, CommandResult
+
+
+def median(values):
+    values = sorted(values)
+    n = len(values)
+    if n == 0:
+        return None
+    if n % 2 == 1:
+        return values[n // 2]
+    return (values[n // 2 - 1] + values[n // 2]) / 2.0
+
+
+class Module(MgrModule):
+    config_keys = {
+        # only log intended changes unless explicitly enabled
+        'active': 'false',
+        'interval': 60,
+        # an OSD is an outlier when its average read service time
+        # exceeds this multiple of the cluster median
+        'outlier_threshold': 2.0,
+        # ignore sampling intervals with fewer read ops than this
+        'min_ops': 100,
+        # affinity is moved in these increments
+        'step': 0.1,
+        # never push an OSD's primary affinity below this
+        'min_affinity': 0.1,
+    }
+
+    COMMANDS = [
+        {
+            "cmd": "affinity config-set name=key,type=CephString "
+                   "name=value,type=CephString",
+            "desc": "Set a configuration value",
+            "perm": "rw"
+        },
+        {
+            "cmd": "affinity config-show",
+            "desc": "Show current configuration",
+            "perm": "r"
+        },
+        {
+            "cmd": "affinity status",
+            "desc": "Show per-OSD read service times and outlier scores",
+            "perm": "r"
+        },
+    ]
+
+    def __init__(self, *args, **kwargs):
+        super(Module, self).__init__(*args, **kwargs)
+        self.event = Event()
+        self.run = False
+        self.config = dict()
+        self.scores = dict()
+
+    def init_module_config(self):
+        for key, default in self.config_keys.items():
+            self.set_config_option(key, self.get_config(key, default))
+
+    def set_config_option(self, option, value):
+        if option not in self.config_keys.keys():
+            raise RuntimeError('{0} is an unknown configuration '
+                               'option'.format(option))
+
+        if option in ['interval', 'min_ops']:
+            try:
+                value = int(value)
+            except (ValueError, TypeError):
+                raise RuntimeError('invalid {0} configured. Please specify '
+                                   'a valid integer'.format(option))
+        elif option in ['outlier_threshold', 'step', 'min_affinity']:
+            try:
+                value = float(value)
+            except (ValueError, TypeError):
+                raise RuntimeError('invalid {0} configured. Please specify '
+                                   'a valid float'.format(option))
+
+        if option == 'interval' and value < 10:
+            raise RuntimeError('interval should be set to at least 10 seconds')
+
+        self.config[option] = value
+
+    def get_config(self, key, default=None):
+        value = super(Module, self).get_config(key)
+        if value is None:
+            return default
+        return value
+
+    def _read_service_time(self, osd_id):
+        """
+        Average read service time (seconds) of one OSD over the
+        counter window retained by the mgr, or None if there were too
+        few reads to judge.
+        """
+        name = str(osd_id)
+        lat = self.get_counter('osd', name, 'osd.op_r_latency')
+        ops = self.get_counter('osd', name, 'osd.op_r')
+        lat = lat.get('osd.op_r_latency', [])
+        ops = ops.get('osd.op_r', [])
+        if len(lat) < 2 or len(ops) < 2:
+            return None
+
+        delta_ops = ops[-1][1] - ops[0][1]
+        if delta_ops < self.config['min_ops']:
+            return None
+
+        # op_r_latency is a long-running average; the reported value is
+        # the cumulative sum in nanoseconds
+        delta_lat = lat[-1][1] - lat[0][1]
+        return (delta_lat / float(delta_ops)) / 1e9
+
+    def _set_primary_affinity(self, osd_id, weight):
+        self.log.warn('setting osd.%d primary-affinity to %.2f',
+                      osd_id, weight)
+        result = CommandResult('')
+        self.send_command(result, 'mon', '', json.dumps({
+            'prefix': 'osd primary-affinity',
+            'id': osd_id,
+            'weight': weight,
+        }), '')
+        r, outb, outs = result.wait()
+        if r != 0:
+            self.log.error('failed to set primary-affinity on osd.%d: %s',
+                           osd_id, outs)
+
+    def _evaluate(self):
+        osd_map = self.get('osd_map')
+
+        service_times = dict()
+        affinities = dict()
+        for osd in osd_map['osds']:
+            osd_id = osd['osd']
+            if osd['up'] == 0 or osd['in'] == 0:
+                continue
+            svc = self._read_service_time(osd_id)
+            if svc is None:
+                continue
+            service_times[osd_id] = svc
+            affinities[osd_id] = osd['primary_affinity']
+
+        cluster_median = median(service_times.values())
+        if cluster_median is None or cluster_median <= 0.0:
+            self.log.debug('not enough read traffic to score OSDs')
+            return
+
+        self.scores = dict()
+        threshold = self.config['outlier_threshold']
+        step = self.config['step']
+        for osd_id, svc in service_times.items():
+            score = svc / cluster_median
+            self.scores[osd_id] = {
+                'service_time_ms': svc * 1000.0,
+                'score': score,
+                'primary_affinity': affinities[osd_id],
+            }
+
+            current = affinities[osd_id]
+            if score >= threshold:
+                # degrade gradually rather than benching the OSD outright
+                target = max(current - step, self.config['min_affinity'])
+            elif score < threshold * 0.75 and current < 1.0:
+                # recover slowly once service times return to normal
+                target = min(current + step, 1.0)
+            else:
+                continue
+
+            if abs(target - current) < 0.01:
+                continue
+
+            self.log.info('osd.%d score %.2f (%.1f ms vs median %.1f ms), '
+                          'primary-affinity %.2f -> %.2f',
+                          osd_id, score, svc * 1000.0,
+                          cluster_median * 1000.0, current, target)
+            if self.config['active'] == 'true':
+                self._set_primary_affinity(osd_id, target)
+            else:
+                self.log.info('inactive (mgr/affinity/active != true), '
+                              'not changing osd.%d', osd_id)
+
+    def handle_command(self, command):
+        if command['prefix'] == 'affinity config-show':
+            return 0, json.dumps(self.config), ''
+        elif command['prefix'] == 'affinity config-set':
+            key = command['key']
+            value = command['value']
+            if not value:
+                return -errno.EINVAL, '', 'Value should not be empty or None'
+
+            self.log.debug('Setting configuration option %s to %s', key, value)
+            self.set_config_option(key, value)
+            self.set_config(key, value)
+            return 0, 'Configuration option {0} updated'.format(key), ''
+        elif command['prefix'] == 'affinity status':
+            return 0, json.dumps(self.scores, indent=2), ''
+        else:
+            return (-errno.EINVAL, '',
+                    "Command not found '{0}'".format(command['prefix']))
+
+    def shutdown(self):
+        self.log.info('Stopping affinity module')
+        self.run = False
+        self.event.set()
+
+    def serve(self):
+        self.log.info('Starting affinity module')
+        self.run = True
+
+        self.init_module_config()
+
+        while self.run:
+            try:
+                self._evaluate()
+            except Exception as exc:
+                self.log.error('Exception while scoring OSDs: %s', exc)
+
+            self.event.wait(self.config['interval'])
+            self.event.clear()
@@ -17,8 +17,9 @@ using namespace rgw::asio;
 
 ClientIO::ClientIO(tcp::socket& socket,
                    parser_type& parser,
-                   beast::flat_streambuf& buffer)
-  : socket(socket), parser(parser), buffer(buffer), txbuf(*this)
+                   beast::flat_streambuf& buffer,
+                   boost::asio::yield_context yield)
+  : socket(socket), parser(parser), buffer(buffer), yield(yield), txbuf(*this)
 {
 }
 
@@ -85,7 +86,10 @@ void ClientIO::init_env(CephContext *cct)
 size_t ClientIO::write_data(const char* buf, size_t len)
 {
   boost::system::error_code ec;
-  auto bytes = boost::asio::write(socket, boost::asio::buffer(buf, len), ec);
+  // suspend this coroutine until the write completes so the io_service
+  // thread is free to run other connections in the meantime
+  auto bytes = boost::asio::async_write(socket, boost::asio::buffer(buf, len),
+                                        yield[ec]);
   if (ec) {
     derr << "write_data failed: " << ec.message() << dendl;
     throw rgw::io::Exception(ec.value(), std::system_category());
@@ -108,7 +112,8 @@ size_t ClientIO::read_data(char* buf, size_t max)
       << buffer.size() << " bytes buffered" << dendl;
 
   while (boost::asio::buffer_size(body_remaining) && !parser.is_complete()) {
-    auto bytes = beast::http::read_some(socket, buffer, parser, ec);
+    auto bytes = beast::http::async_read_some(socket, buffer, parser,
+                                              yield[ec]);
     buffer.consume(bytes);
     if (ec == boost::asio::error::connection_reset ||
         ec == boost::asio::error::eof ||
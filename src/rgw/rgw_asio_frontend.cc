@@ -2,6 +2,7 @@
 // vim: ts=8 sw=2 smarttab
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -108,7 +109,7 @@ static void handle_connection(RGWProcessEnv& env, tcp::socket socket,
     // process the request
     RGWRequest req{env.store->get_new_req_id()};
 
-    rgw::asio::ClientIO real_client{socket, parser, buffer};
+    rgw::asio::ClientIO real_client{socket, parser, buffer, yield};
 
     auto real_client_io = rgw::io::add_reordering(
                             rgw::io::add_buffering(
@@ -187,11 +188,13 @@ void AsioFrontend::accept(boost::system::error_code ec)
   } else if (ec) {
     throw ec;
   }
-  auto socket = std::move(peer_socket);
-  // spawn a coroutine to handle the connection
+  // spawn a coroutine to handle the connection. the socket must be owned
+  // by the coroutine, as the handler may not run until after accept()
+  // has returned
+  auto socket = std::make_shared<tcp::socket>(std::move(peer_socket));
   boost::asio::spawn(service,
-                     [&] (boost::asio::yield_context yield) {
-                       handle_connection(env, std::move(socket), yield);
+                     [this, socket] (boost::asio::yield_context yield) {
+                       handle_connection(env, std::move(*socket), yield);
                      });
   acceptor.async_accept(peer_socket,
                         [this] (boost::system::error_code ec) {
@@ -240,20 +240,50 @@ TokenEngine::authenticate(const std::string& token,
     return result_t::grant(std::move(apl));
   }
 
+  /* A token that Keystone rejected a moment ago will be rejected again.
+   * Deny it from cache instead of re-validating on every retry. */
+  if (token_cache.find_invalid(token_id)) {
+    ldout(cct, 20) << "cached rejection for token_id=" << token_id << dendl;
+    return result_t::deny(-EACCES);
+  }
+
+  /* Coalesce concurrent validations of the same token: let a single thread
+   * take the round-trip to Keystone while the others wait for its verdict.
+   * This way a latency spike on the Keystone side ties up one gateway
+   * thread per distinct token instead of the whole pool. */
+  if (! token_cache.start_validation(token_id)) {
+    t = token_cache.find(token_id);
+    if (t) {
+      ldout(cct, 20) << "coalesced token.project.id=" << t->get_project_id()
+                     << dendl;
+      auto apl = apl_factory->create_apl_remote(cct, s, get_acl_strategy(*t),
+                                                get_creds_info(*t, roles.admin));
+      return result_t::grant(std::move(apl));
+    }
+    return result_t::deny(-EACCES);
+  }
+
   /* Retrieve token. */
-  if (rgw_is_pki_token(token)) {
-    try {
-      t = decode_pki_token(token);
-    } catch (...) {
-      /* Last resort. */
+  try {
+    if (rgw_is_pki_token(token)) {
+      try {
+        t = decode_pki_token(token);
+      } catch (...) {
+        /* Last resort. */
+        t = get_from_keystone(token);
+      }
+    } else {
+      /* Can't decode, just go to the Keystone server for validation. */
       t = get_from_keystone(token);
     }
-  } else {
-    /* Can't decode, just go to the Keystone server for validation. */
-    t = get_from_keystone(token);
+  } catch (...) {
+    token_cache.finish_validation(token_id);
+    throw;
   }
 
   if (! t) {
+    token_cache.add_invalid(token_id);
+    token_cache.finish_validation(token_id);
     return result_t::deny(-EACCES);
   }
 
@@ -262,6 +292,7 @@ TokenEngine::authenticate(const std::string& token,
     ldout(cct, 0) << "got expired token: " << t->get_project_name()
                   << ":" << t->get_user_name()
                   << " expired: " << t->get_expires() << dendl;
+    token_cache.finish_validation(token_id);
     return result_t::deny(-EPERM);
   }
 
@@ -272,12 +303,15 @@ TokenEngine::authenticate(const std::string& token,
                     << ":" << t->get_user_name()
                     << " expires: " << t->get_expires() << dendl;
       token_cache.add(token_id, *t);
+      token_cache.finish_validation(token_id);
       auto apl = apl_factory->create_apl_remote(cct, s, get_acl_strategy(*t),
                                             get_creds_info(*t, roles.admin));
       return result_t::grant(std::move(apl));
     }
   }
 
+  token_cache.finish_validation(token_id);
+
   ldout(cct, 0) << "user does not hold a matching role; required roles: "
                 << g_conf->rgw_keystone_accepted_roles << dendl;
 
@@ -11,14 +11,15 @@ using namespace std;
 
 int ObjectCache::get(string& name, ObjectCacheInfo& info, uint32_t mask, rgw_cache_entry_info *cache_info)
 {
-  RWLock::RLocker l(lock);
-
   if (!enabled) {
     return -ENOENT;
   }
 
-  map<string, ObjectCacheEntry>::iterator iter = cache_map.find(name);
-  if (iter == cache_map.end()) {
+  Shard& shard = get_shard(name);
+  RWLock::RLocker l(shard.lock);
+
+  map<string, ObjectCacheEntry>::iterator iter = shard.cache_map.find(name);
+  if (iter == shard.cache_map.end()) {
     ldout(cct, 10) << "cache get: name=" << name << " : miss" << dendl;
     if(perfcounter) perfcounter->inc(l_rgw_cache_miss);
     return -ENOENT;
@@ -26,15 +27,16 @@ int ObjectCache::get(string& name, ObjectCacheInfo& info, uint32_t mask, rgw_cac
 
   ObjectCacheEntry *entry = &iter->second;
 
-  if (lru_counter - entry->lru_promotion_ts > lru_window) {
-    ldout(cct, 20) << "cache get: touching lru, lru_counter=" << lru_counter
+  if (shard.lru_counter - entry->lru_promotion_ts > lru_window) {
+    ldout(cct, 20) << "cache get: touching lru, lru_counter="
+                   << shard.lru_counter
                    << " promotion_ts=" << entry->lru_promotion_ts << dendl;
-    lock.unlock();
-    lock.get_write(); /* promote lock to writer */
+    shard.lock.unlock();
+    shard.lock.get_write(); /* promote lock to writer */
 
     /* need to redo this because entry might have dropped off the cache */
-    iter = cache_map.find(name);
-    if (iter == cache_map.end()) {
+    iter = shard.cache_map.find(name);
+    if (iter == shard.cache_map.end()) {
       ldout(cct, 10) << "lost race! cache get: name=" << name << " : miss" << dendl;
       if(perfcounter) perfcounter->inc(l_rgw_cache_miss);
       return -ENOENT;
@@ -42,8 +44,8 @@ int ObjectCache::get(string& name, ObjectCacheInfo& info, uint32_t mask, rgw_cac
 
     entry = &iter->second;
     /* check again, we might have lost a race here */
-    if (lru_counter - entry->lru_promotion_ts > lru_window) {
-      touch_lru(name, *entry, iter->second.lru_iter);
+    if (shard.lru_counter - entry->lru_promotion_ts > lru_window) {
+      touch_lru(shard, name, *entry, iter->second.lru_iter);
     }
   }
 
@@ -71,67 +73,79 @@ int ObjectCache::get(string& name, ObjectCacheInfo& info, uint32_t mask, rgw_cac
 
 bool ObjectCache::chain_cache_entry(list<rgw_cache_entry_info *>& cache_info_entries, RGWChainedCache::Entry *chained_entry)
 {
-  RWLock::WLocker l(lock);
-
   if (!enabled) {
     return false;
   }
 
-  list<rgw_cache_entry_info *>::iterator citer;
+  /* the chained entries may span several shards; take the affected shard
+   * locks in a stable (address) order to avoid deadlocking against
+   * concurrent chainers */
+  std::set<Shard *> affected_shards;
+  for (auto cache_info : cache_info_entries) {
+    affected_shards.insert(&get_shard(cache_info->cache_locator));
+  }
+  for (auto shard : affected_shards) {
+    shard->lock.get_write();
+  }
+
+  bool valid = true;
 
   list<ObjectCacheEntry *> cache_entry_list;
 
   /* first verify that all entries are still valid */
-  for (citer = cache_info_entries.begin(); citer != cache_info_entries.end(); ++citer) {
-    rgw_cache_entry_info *cache_info = *citer;
-
+  for (auto cache_info : cache_info_entries) {
     ldout(cct, 10) << "chain_cache_entry: cache_locator=" << cache_info->cache_locator << dendl;
-    map<string, ObjectCacheEntry>::iterator iter = cache_map.find(cache_info->cache_locator);
-    if (iter == cache_map.end()) {
+    Shard& shard = get_shard(cache_info->cache_locator);
+    map<string, ObjectCacheEntry>::iterator iter = shard.cache_map.find(cache_info->cache_locator);
+    if (iter == shard.cache_map.end()) {
       ldout(cct, 20) << "chain_cache_entry: couldn't find cache locator" << dendl;
-      return false;
+      valid = false;
+      break;
     }
 
     ObjectCacheEntry *entry = &iter->second;
 
     if (entry->gen != cache_info->gen) {
       ldout(cct, 20) << "chain_cache_entry: entry.gen (" << entry->gen << ") != cache_info.gen (" << cache_info->gen << ")" << dendl;
-      return false;
+      valid = false;
+      break;
     }
 
     cache_entry_list.push_back(entry);
   }
 
+  if (valid) {
+    chained_entry->cache->chain_cb(chained_entry->key, chained_entry->data);
 
-  chained_entry->cache->chain_cb(chained_entry->key, chained_entry->data);
-
-  list<ObjectCacheEntry *>::iterator liter;
-
-  for (liter = cache_entry_list.begin(); liter != cache_entry_list.end(); ++liter) {
-    ObjectCacheEntry *entry = *liter;
-
-    entry->chained_entries.push_back(make_pair(chained_entry->cache, chained_entry->key));
+    for (auto entry : cache_entry_list) {
+      entry->chained_entries.push_back(make_pair(chained_entry->cache,
+						 chained_entry->key));
+    }
   }
 
-  return true;
+  for (auto shard : affected_shards) {
+    shard->lock.unlock();
+  }
+  return valid;
 }
 
 void ObjectCache::put(string& name, ObjectCacheInfo& info, rgw_cache_entry_info *cache_info)
 {
-  RWLock::WLocker l(lock);
-
   if (!enabled) {
     return;
   }
 
+  Shard& shard = get_shard(name);
+  RWLock::WLocker l(shard.lock);
+
   ldout(cct, 10) << "cache put: name=" << name << " info.flags=0x"
                  << std::hex << info.flags << std::dec << dendl;
-  map<string, ObjectCacheEntry>::iterator iter = cache_map.find(name);
-  if (iter == cache_map.end()) {
+  map<string, ObjectCacheEntry>::iterator iter = shard.cache_map.find(name);
+  if (iter == shard.cache_map.end()) {
     ObjectCacheEntry entry;
-    entry.lru_iter = lru.end();
-    cache_map.insert(pair<string, ObjectCacheEntry>(name, entry));
-    iter = cache_map.find(name);
+    entry.lru_iter = shard.lru.end();
+    shard.cache_map.insert(pair<string, ObjectCacheEntry>(name, entry));
+    iter = shard.cache_map.find(name);
   }
   ObjectCacheEntry& entry = iter->second;
   ObjectCacheInfo& target = entry.info;
@@ -145,7 +159,7 @@ void ObjectCache::put(string& name, ObjectCacheInfo& info, rgw_cache_entry_info
   entry.chained_entries.clear();
   entry.gen++;
 
-  touch_lru(name, entry, entry.lru_iter);
+  touch_lru(shard, name, entry, entry.lru_iter);
 
   target.status = info.status;
 
@@ -195,14 +209,15 @@ void ObjectCache::put(string& name, ObjectCacheInfo& info, rgw_cache_entry_info
 
 void ObjectCache::remove(string& name)
 {
-  RWLock::WLocker l(lock);
-
   if (!enabled) {
     return;
   }
 
-  map<string, ObjectCacheEntry>::iterator iter = cache_map.find(name);
-  if (iter == cache_map.end())
+  Shard& shard = get_shard(name);
+  RWLock::WLocker l(shard.lock);
+
+  map<string, ObjectCacheEntry>::iterator iter = shard.cache_map.find(name);
+  if (iter == shard.cache_map.end())
     return;
 
   ldout(cct, 10) << "removing " << name << " from cache" << dendl;
@@ -214,14 +229,16 @@ void ObjectCache::remove(string& name)
     chained_cache->invalidate(iiter->second);
   }
 
-  remove_lru(name, iter->second.lru_iter);
-  cache_map.erase(iter);
+  remove_lru(shard, name, iter->second.lru_iter);
+  shard.cache_map.erase(iter);
 }
 
-void ObjectCache::touch_lru(string& name, ObjectCacheEntry& entry, std::list<string>::iterator& lru_iter)
+void ObjectCache::touch_lru(Shard& shard, string& name, ObjectCacheEntry& entry,
+			    std::list<string>::iterator& lru_iter)
 {
-  while (lru_size > (size_t)cct->_conf->rgw_cache_lru_size) {
-    list<string>::iterator iter = lru.begin();
+  while (shard.lru_size >
+	 (size_t)cct->_conf->rgw_cache_lru_size / SHARD_COUNT) {
+    list<string>::iterator iter = shard.lru.begin();
     if ((*iter).compare(name) == 0) {
       /*
        * if the entry we're touching happens to be at the lru end, don't remove it,
@@ -229,45 +246,44 @@ void ObjectCache::touch_lru(string& name, ObjectCacheEntry& entry, std::list<str
        */
       break;
     }
-    map<string, ObjectCacheEntry>::iterator map_iter = cache_map.find(*iter);
+    map<string, ObjectCacheEntry>::iterator map_iter = shard.cache_map.find(*iter);
     ldout(cct, 10) << "removing entry: name=" << *iter << " from cache LRU" << dendl;
-    if (map_iter != cache_map.end())
-      cache_map.erase(map_iter);
-    lru.pop_front();
-    lru_size--;
+    if (map_iter != shard.cache_map.end())
+      shard.cache_map.erase(map_iter);
+    shard.lru.pop_front();
+    shard.lru_size--;
   }
 
-  if (lru_iter == lru.end()) {
-    lru.push_back(name);
-    lru_size++;
+  if (lru_iter == shard.lru.end()) {
+    shard.lru.push_back(name);
+    shard.lru_size++;
     lru_iter--;
     ldout(cct, 10) << "adding " << name << " to cache LRU end" << dendl;
   } else {
     ldout(cct, 10) << "moving " << name << " to cache LRU end" << dendl;
-    lru.erase(lru_iter);
-    lru.push_back(name);
-    lru_iter = lru.end();
+    shard.lru.erase(lru_iter);
+    shard.lru.push_back(name);
+    lru_iter = shard.lru.end();
     --lru_iter;
   }
 
-  lru_counter++;
-  entry.lru_promotion_ts = lru_counter;
+  shard.lru_counter++;
+  entry.lru_promotion_ts = shard.lru_counter;
 }
 
-void ObjectCache::remove_lru(string& name, std::list<string>::iterator& lru_iter)
+void ObjectCache::remove_lru(Shard& shard, string& name,
+			     std::list<string>::iterator& lru_iter)
 {
-  if (lru_iter == lru.end())
+  if (lru_iter == shard.lru.end())
     return;
 
-  lru.erase(lru_iter);
-  lru_size--;
-  lru_iter = lru.end();
+  shard.lru.erase(lru_iter);
+  shard.lru_size--;
+  lru_iter = shard.lru.end();
 }
 
 void ObjectCache::set_enabled(bool status)
 {
-  RWLock::WLocker l(lock);
-
   enabled = status;
 
   if (!enabled) {
@@ -277,20 +293,20 @@ void ObjectCache::set_enabled(bool status)
 
 void ObjectCache::invalidate_all()
 {
-  RWLock::WLocker l(lock);
-
   do_invalidate_all();
 }
 
 void ObjectCache::do_invalidate_all()
 {
-  cache_map.clear();
-  lru.clear();
-
-  lru_size = 0;
-  lru_counter = 0;
-  lru_window = 0;
+  for (auto& shard : shards) {
+    RWLock::WLocker l(shard.lock);
+    shard.cache_map.clear();
+    shard.lru.clear();
+    shard.lru_size = 0;
+    shard.lru_counter = 0;
+  }
 
+  RWLock::RLocker l(lock);
   for (list<RGWChainedCache *>::iterator iter = chained_cache.begin(); iter != chained_cache.end(); ++iter) {
     (*iter)->invalidate_all();
   }
@@ -5,6 +5,7 @@
 #define CEPH_RGWCACHE_H
 
 #include "rgw_rados.h"
+#include <atomic>
 #include <string>
 #include <map>
 #include "include/types.h"
@@ -135,30 +136,46 @@ struct ObjectCacheEntry {
 };
 
 class ObjectCache {
-  std::map<string, ObjectCacheEntry> cache_map;
-  std::list<string> lru;
-  unsigned long lru_size;
-  unsigned long lru_counter;
+  /* the cache is sharded by name hash so that concurrent requests don't
+   * all serialize on a single lock; each shard maintains its own LRU */
+  struct Shard {
+    std::map<string, ObjectCacheEntry> cache_map;
+    std::list<string> lru;
+    unsigned long lru_size;
+    unsigned long lru_counter;
+    RWLock lock;
+
+    Shard() : lru_size(0), lru_counter(0), lock("ObjectCache::Shard") {}
+  };
+
+  static constexpr unsigned SHARD_COUNT = 16;
+
+  Shard shards[SHARD_COUNT];
   unsigned long lru_window;
-  RWLock lock;
+  RWLock lock; //< protects chained cache registration only
   CephContext *cct;
 
   list<RGWChainedCache *> chained_cache;
 
-  bool enabled;
+  std::atomic<bool> enabled;
+
+  Shard& get_shard(const string& name) {
+    return shards[ceph_str_hash_linux(name.c_str(), name.size()) % SHARD_COUNT];
+  }
 
-  void touch_lru(string& name, ObjectCacheEntry& entry, std::list<string>::iterator& lru_iter);
-  void remove_lru(string& name, std::list<string>::iterator& lru_iter);
+  void touch_lru(Shard& shard, string& name, ObjectCacheEntry& entry,
+                 std::list<string>::iterator& lru_iter);
+  void remove_lru(Shard& shard, string& name, std::list<string>::iterator& lru_iter);
 
   void do_invalidate_all();
 public:
-  ObjectCache() : lru_size(0), lru_counter(0), lru_window(0), lock("ObjectCache"), cct(NULL), enabled(false) { }
+  ObjectCache() : lru_window(0), lock("ObjectCache"), cct(NULL), enabled(false) { }
   int get(std::string& name, ObjectCacheInfo& bl, uint32_t mask, rgw_cache_entry_info *cache_info);
   void put(std::string& name, ObjectCacheInfo& bl, rgw_cache_entry_info *cache_info);
   void remove(std::string& name);
   void set_ctx(CephContext *_cct) {
     cct = _cct;
-    lru_window = cct->_conf->rgw_cache_lru_size / 2;
+    lru_window = cct->_conf->rgw_cache_lru_size / (SHARD_COUNT * 2);
   }
   bool chain_cache_entry(list<rgw_cache_entry_info *>& cache_info_entries, RGWChainedCache::Entry *chained_entry);
 
@@ -539,34 +556,39 @@ int RGWCache<T>::watch_cb(uint64_t notify_id,
 			  uint64_t notifier_id,
 			  bufferlist& bl)
 {
-  RGWCacheNotifyInfo info;
+  /* a notification carries one or more concatenated entries; senders
+   * coalescing updates (rgw_cache_notify_interval_msec) pack a whole batch
+   * into a single notify */
+  bufferlist::iterator iter = bl.begin();
+  while (!iter.end()) {
+    RGWCacheNotifyInfo info;
+
+    try {
+      ::decode(info, iter);
+    } catch (buffer::end_of_buffer& err) {
+      mydout(0) << "ERROR: got bad notification" << dendl;
+      return -EIO;
+    } catch (buffer::error& err) {
+      mydout(0) << "ERROR: buffer::error" << dendl;
+      return -EIO;
+    }
 
-  try {
-    bufferlist::iterator iter = bl.begin();
-    ::decode(info, iter);
-  } catch (buffer::end_of_buffer& err) {
-    mydout(0) << "ERROR: got bad notification" << dendl;
-    return -EIO;
-  } catch (buffer::error& err) {
-    mydout(0) << "ERROR: buffer::error" << dendl;
-    return -EIO;
-  }
+    rgw_pool pool;
+    string oid;
+    normalize_pool_and_obj(info.obj.pool, info.obj.oid, pool, oid);
+    string name = normal_name(pool, oid);
 
-  rgw_pool pool;
-  string oid;
-  normalize_pool_and_obj(info.obj.pool, info.obj.oid, pool, oid);
-  string name = normal_name(pool, oid);
-  
-  switch (info.op) {
-  case UPDATE_OBJ:
-    cache.put(name, info.obj_info, NULL);
-    break;
-  case REMOVE_OBJ:
-    cache.remove(name);
-    break;
-  default:
-    mydout(0) << "WARNING: got unknown notification op: " << info.op << dendl;
-    return -EINVAL;
+    switch (info.op) {
+    case UPDATE_OBJ:
+      cache.put(name, info.obj_info, NULL);
+      break;
+    case REMOVE_OBJ:
+      cache.remove(name);
+      break;
+    default:
+      mydout(0) << "WARNING: got unknown notification op: " << info.op << dendl;
+      return -EINVAL;
+    }
   }
 
   return 0;
@@ -140,10 +140,14 @@ int rgw_perf_start(CephContext *cct)
 
   plb.add_u64_counter(l_rgw_cache_hit, "cache_hit", "Cache hits");
   plb.add_u64_counter(l_rgw_cache_miss, "cache_miss", "Cache miss");
+  plb.add_time_avg(l_rgw_cache_inval_lat, "cache_inval_lat", "Cache invalidation notify latency");
 
   plb.add_u64_counter(l_rgw_keystone_token_cache_hit, "keystone_token_cache_hit", "Keystone token cache hits");
   plb.add_u64_counter(l_rgw_keystone_token_cache_miss, "keystone_token_cache_miss", "Keystone token cache miss");
 
+  plb.add_u64(l_rgw_gc_pending_entries, "gc_pending_entries", "Expired GC entries awaiting processing");
+  plb.add_time(l_rgw_gc_backlog_age, "gc_backlog_age", "Age of the oldest expired GC entry");
+
   perfcounter = plb.create_perf_counters();
   cct->get_perfcounters_collection()->add(perfcounter);
   return 0;
@@ -1372,9 +1376,12 @@ std::string url_decode(const boost::string_view& src_str, bool in_query)
 
 void rgw_uri_escape_char(char c, string& dst)
 {
-  char buf[16];
-  snprintf(buf, sizeof(buf), "%%%.2X", (int)(unsigned char)c);
-  dst.append(buf);
+  static const char hex[] = "0123456789ABCDEF";
+  char buf[3];
+  buf[0] = '%';
+  buf[1] = hex[(unsigned char)c >> 4];
+  buf[2] = hex[(unsigned char)c & 0xf];
+  dst.append(buf, sizeof(buf));
 }
 
 static bool char_needs_url_encoding(char c)
@@ -1412,13 +1419,19 @@ static bool char_needs_url_encoding(char c)
 void url_encode(const string& src, string& dst)
 {
   const char *p = src.c_str();
-  for (unsigned i = 0; i < src.size(); i++, p++) {
-    if (char_needs_url_encoding(*p)) {
+  const char *end = p + src.size();
+  while (p < end) {
+    // bulk-copy runs of characters that need no escaping instead of
+    // growing dst one byte at a time
+    const char *run = p;
+    while (p < end && !char_needs_url_encoding(*p))
+      p++;
+    if (p != run)
+      dst.append(run, p - run);
+    if (p < end) {
       rgw_uri_escape_char(*p, dst);
-      continue;
+      p++;
     }
-
-    dst.append(p, 1);
   }
 }
 
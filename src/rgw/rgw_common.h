@@ -248,10 +248,14 @@ enum {
 
   l_rgw_cache_hit,
   l_rgw_cache_miss,
+  l_rgw_cache_inval_lat,
 
   l_rgw_keystone_token_cache_hit,
   l_rgw_keystone_token_cache_miss,
 
+  l_rgw_gc_pending_entries,
+  l_rgw_gc_backlog_age,
+
   l_rgw_last,
 };
 
@@ -2057,10 +2061,14 @@ static inline void buf_to_hex(const unsigned char* const buf,
                               const size_t len,
                               char* const str)
 {
-  str[0] = '\0';
+  // every ETag and signature comes through here; a nibble table is far
+  // cheaper than a sprintf("%02x") per byte
+  static const char hex[] = "0123456789abcdef";
   for (size_t i = 0; i < len; i++) {
-    ::sprintf(&str[i*2], "%02x", static_cast<int>(buf[i]));
+    str[i*2] = hex[buf[i] >> 4];
+    str[i*2+1] = hex[buf[i] & 0xf];
   }
+  str[len*2] = '\0';
 }
 
 template<size_t N> static inline std::array<char, N * 2 + 1>
@@ -840,6 +840,11 @@ public:
   RGWCoroutine *store_marker(const string& new_marker, uint64_t index_pos, const real_time& timestamp) override {
     sync_marker.marker = new_marker;
     sync_marker.pos = index_pos;
+    if (!ceph::real_clock::is_zero(timestamp)) {
+      /* track the datalog timestamp of the last synced entry, so that
+       * sync status can report how far behind the shard lags */
+      sync_marker.timestamp = timestamp;
+    }
 
     ldout(sync_env->cct, 20) << __func__ << "(): updating marker marker_oid=" << marker_oid << " marker=" << new_marker << dendl;
     RGWRados *store = sync_env->store;
@@ -1039,6 +1044,15 @@ class RGWDataSyncShardCR : public RGWCoroutine {
   list<rgw_data_change_log_entry>::iterator log_iter;
   bool truncated;
 
+  /* next batch of log entries, prefetched while the current batch is
+   * still being applied */
+  list<rgw_data_change_log_entry> next_log_entries;
+  bool next_truncated;
+  string next_marker;
+  boost::intrusive_ptr<RGWCoroutinesStack> fetch_stack;
+  bool fetch_done;
+  int fetch_ret;
+
   RGWDataChangesLogInfo shard_info;
   string datalog_marker;
 
@@ -1089,14 +1103,21 @@ public:
 						      pool(_pool),
 						      shard_id(_shard_id),
 						      sync_marker(_marker),
-                                                      marker_tracker(NULL), truncated(false), inc_lock("RGWDataSyncShardCR::inc_lock"),
-                                                      total_entries(0), spawn_window(BUCKET_SHARD_SYNC_SPAWN_WINDOW), reset_backoff(NULL),
+                                                      marker_tracker(NULL), truncated(false),
+                                                      next_truncated(false), fetch_done(false), fetch_ret(0),
+                                                      inc_lock("RGWDataSyncShardCR::inc_lock"),
+                                                      total_entries(0), reset_backoff(NULL),
                                                       lease_cr(nullptr), lease_stack(nullptr), error_repo(nullptr), max_error_entries(DATA_SYNC_MAX_ERR_ENTRIES),
                                                       retry_backoff_secs(RETRY_BACKOFF_SECS_DEFAULT) {
     set_description() << "data sync shard source_zone=" << sync_env->source_zone << " shard_id=" << shard_id;
     status_oid = RGWDataSyncStatusManager::shard_obj_name(sync_env->source_zone, shard_id);
     error_oid = status_oid + ".retry";
 
+    spawn_window = sync_env->cct->_conf->rgw_data_sync_spawn_window;
+    if (spawn_window < 1) {
+      spawn_window = BUCKET_SHARD_SYNC_SPAWN_WINDOW;
+    }
+
     logger.init(sync_env, "DataShard", status_oid);
   }
 
@@ -1120,6 +1141,24 @@ public:
     marker_tracker = mt;
   }
 
+  /* reap finished children; remembers the result of the log prefetch
+   * stack so that the pipeline can pick it up */
+  void collect_children() {
+    int child_ret;
+    RGWCoroutinesStack *child;
+    while (collect_next(&child_ret, &child)) {
+      if (child == fetch_stack.get()) {
+        fetch_done = true;
+        fetch_ret = child_ret;
+        continue;
+      }
+      if (child_ret < 0) {
+        ldout(sync_env->cct, 0) << "ERROR: a sync operation returned error" << dendl;
+        /* we have reported this error */
+      }
+    }
+  }
+
   int operate() override {
     int r;
     while (true) {
@@ -1298,12 +1337,43 @@ public:
 	ldout(sync_env->cct, 20) << __func__ << ":" << __LINE__ << ": shard_id=" << shard_id << " datalog_marker=" << datalog_marker << " sync_marker.marker=" << sync_marker.marker << dendl;
 	if (datalog_marker > sync_marker.marker) {
           spawned_keys.clear();
-          yield call(new RGWReadRemoteDataLogShardCR(sync_env, shard_id, &sync_marker.marker, &log_entries, &truncated));
-          if (retcode < 0) {
-            ldout(sync_env->cct, 0) << "ERROR: failed to read remote data log info: ret=" << retcode << dendl;
-            stop_spawned_services();
-            drain_all();
-            return set_cr_error(retcode);
+          if (!fetch_stack) {
+            /* prime the pipeline; subsequent iterations find the next
+             * batch already prefetched */
+            yield call(new RGWReadRemoteDataLogShardCR(sync_env, shard_id, &sync_marker.marker, &log_entries, &truncated));
+            if (retcode < 0) {
+              ldout(sync_env->cct, 0) << "ERROR: failed to read remote data log info: ret=" << retcode << dendl;
+              stop_spawned_services();
+              drain_all();
+              return set_cr_error(retcode);
+            }
+          } else {
+            /* wait for the prefetch issued while the previous batch was
+             * being applied */
+            while (!fetch_done) {
+              yield wait_for_child();
+              collect_children();
+            }
+            fetch_stack.reset();
+            if (fetch_ret < 0) {
+              ldout(sync_env->cct, 0) << "ERROR: failed to read remote data log info: ret=" << fetch_ret << dendl;
+              stop_spawned_services();
+              drain_all();
+              return set_cr_error(fetch_ret);
+            }
+            sync_marker.marker = next_marker;
+            log_entries.swap(next_log_entries);
+            next_log_entries.clear();
+            truncated = next_truncated;
+          }
+          if (truncated) {
+            /* overlap the next round-trip to the source zone with the
+             * apply stage below; per-bucket-shard ordering is preserved
+             * by the marker tracker's key_to_marker index */
+            next_marker = sync_marker.marker;
+            fetch_done = false;
+            fetch_ret = 0;
+            fetch_stack.reset(spawn(new RGWReadRemoteDataLogShardCR(sync_env, shard_id, &next_marker, &next_log_entries, &next_truncated), false));
           }
           for (log_iter = log_entries.begin(); log_iter != log_entries.end(); ++log_iter) {
             ldout(sync_env->cct, 20) << __func__ << ":" << __LINE__ << ": shard_id=" << shard_id << " log_entry: " << log_iter->log_id << ":" << log_iter->log_timestamp << ":" << log_iter->entry.key << dendl;
@@ -1329,17 +1399,11 @@ public:
               }
             }
 	  }
-          while ((int)num_spawned() > spawn_window) {
+          /* don't count the prefetch against the apply window */
+          while ((int)num_spawned() > spawn_window + (fetch_stack && !fetch_done ? 1 : 0)) {
             set_status() << "num_spawned() > spawn_window";
             yield wait_for_child();
-            int ret;
-            while (collect(&ret, lease_stack.get())) {
-              if (ret < 0) {
-                ldout(sync_env->cct, 0) << "ERROR: a sync operation returned error" << dendl;
-                /* we have reported this error */
-              }
-              /* not waiting for child here */
-            }
+            collect_children();
           }
 	}
 	ldout(sync_env->cct, 20) << __func__ << ":" << __LINE__ << ": shard_id=" << shard_id << " datalog_marker=" << datalog_marker << " sync_marker.marker=" << sync_marker.marker << dendl;
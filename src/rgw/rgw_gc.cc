@@ -128,11 +128,33 @@ int RGWGC::list(int *index, string& marker, uint32_t max, bool expired_only, std
   return 0;
 }
 
-int RGWGC::process(int index, int max_secs)
+/* wait out the pending object removals, logging (and reporting) any failure */
+static int drain_removals(std::list<std::pair<librados::AioCompletion *, string> >& ios)
+{
+  int ret = 0;
+  for (auto& io : ios) {
+    io.first->wait_for_safe();
+    int r = io.first->get_return_value();
+    if (r == -ENOENT)
+      r = 0;
+    if (r < 0) {
+      dout(0) << "failed to remove " << io.second << " r=" << r << dendl;
+      ret = r;
+    }
+    io.first->release();
+  }
+  ios.clear();
+  return ret;
+}
+
+int RGWGC::process(int index, int max_secs, uint64_t *pending_entries,
+		   ceph::real_time *oldest_pending)
 {
   rados::cls::lock::Lock l(gc_index_lock_name);
   utime_t end = ceph_clock_now();
   std::list<string> remove_tags;
+  std::list<std::pair<AioCompletion *, string> > ios;
+  size_t max_concurrent_io = cct->_conf->rgw_gc_max_concurrent_io;
 
   /* max_secs should be greater than zero. We don't want a zero max_secs
    * to be translated as no timeout, since we'd then need to break the
@@ -180,11 +202,20 @@ int RGWGC::process(int index, int max_secs)
       if (now >= end)
         goto done;
 
+      if (pending_entries)
+        (*pending_entries)++;
+      if (oldest_pending && info.time < *oldest_pending)
+        *oldest_pending = info.time;
+
       remove_tag = true;
       for (liter = chain.objs.begin(); liter != chain.objs.end(); ++liter) {
         cls_rgw_obj& obj = *liter;
 
         if (obj.pool != last_pool) {
+          /* removals are submitted against the current ioctx, so they need
+           * to drain before it can be replaced */
+          if (drain_removals(ios) < 0)
+            remove_tag = false;
           delete ctx;
           ctx = new IoCtx;
 	  ret = rgw_init_ioctx(store->get_rados_handle(), obj.pool, *ctx);
@@ -202,17 +233,27 @@ int RGWGC::process(int index, int max_secs)
 	dout(5) << "gc::process: removing " << obj.pool << ":" << obj.key.name << dendl;
 	ObjectWriteOperation op;
 	cls_refcount_put(op, info.tag, true);
-        ret = ctx->operate(oid, &op);
-	if (ret == -ENOENT)
-	  ret = 0;
+        AioCompletion *c = librados::Rados::aio_create_completion(NULL, NULL, NULL);
+        ret = ctx->aio_operate(oid, c, &op);
         if (ret < 0) {
+          c->release();
           remove_tag = false;
-          dout(0) << "failed to remove " << obj.pool << ":" << oid << "@" << obj.loc << dendl;
+          dout(0) << "failed to schedule removal of " << obj.pool << ":" << oid << "@" << obj.loc << dendl;
+        } else {
+          ios.push_back(make_pair(c, obj.pool + ":" + oid + "@" + obj.loc));
+          if (ios.size() >= max_concurrent_io) {
+            if (drain_removals(ios) < 0)
+              remove_tag = false;
+          }
         }
 
         if (going_down()) // leave early, even if tag isn't removed, it's ok
           goto done;
       }
+      /* the tag can only go once all of the chain's removals are known to
+       * have succeeded */
+      if (drain_removals(ios) < 0)
+        remove_tag = false;
       if (remove_tag) {
         remove_tags.push_back(info.tag);
 #define MAX_REMOVE_CHUNK 16
@@ -229,6 +270,9 @@ int RGWGC::process(int index, int max_secs)
   } while (truncated);
 
 done:
+  /* leave any in-flight removals to finish; their tags weren't queued for
+   * removal, so they'll be retried on the next cycle if one failed */
+  drain_removals(ios);
   if (!remove_tags.empty())
     RGWGC::remove(index, remove_tags);
   l.unlock(&store->gc_pool_ctx, obj_names[index]);
@@ -236,22 +280,45 @@ done:
   return 0;
 }
 
-int RGWGC::process()
+int RGWGC::process(int worker_id)
 {
   int max_secs = cct->_conf->rgw_gc_processor_max_time;
+  int num_workers = std::max<int>(workers.size(), 1);
 
   unsigned start;
   int ret = get_random_bytes((char *)&start, sizeof(start));
   if (ret < 0)
     return ret;
 
+  /* stagger the workers across the shard space; the per-shard lock leases
+   * keep any overlapping scans from processing the same shard twice */
+  start += (max_objs * worker_id) / num_workers;
+
+  /* only one worker accounts the backlog, from the shards its own pass
+   * covers; shards leased to other workers are skipped and not counted */
+  bool report_stats = (worker_id == 0 && perfcounter);
+  uint64_t pending_entries = 0;
+  ceph::real_time oldest_pending = ceph::real_time::max();
+
   for (int i = 0; i < max_objs; i++) {
     int index = (i + start) % max_objs;
-    ret = process(index, max_secs);
+    ret = process(index, max_secs,
+		  report_stats ? &pending_entries : NULL,
+		  report_stats ? &oldest_pending : NULL);
     if (ret < 0)
       return ret;
   }
 
+  if (report_stats) {
+    perfcounter->set(l_rgw_gc_pending_entries, pending_entries);
+    utime_t age;
+    if (pending_entries > 0) {
+      auto span = ceph::real_clock::now() - oldest_pending;
+      age = utime_t(std::chrono::duration_cast<std::chrono::seconds>(span).count(), 0);
+    }
+    perfcounter->tset(l_rgw_gc_backlog_age, age);
+  }
+
   return 0;
 }
 
@@ -262,30 +329,36 @@ bool RGWGC::going_down()
 
 void RGWGC::start_processor()
 {
-  worker = new GCWorker(cct, this);
-  worker->create("rgw_gc");
+  int num_workers = std::max(cct->_conf->rgw_gc_processor_threads, 1);
+  for (int i = 0; i < num_workers; i++) {
+    GCWorker *worker = new GCWorker(cct, this, i);
+    char buf[16];
+    snprintf(buf, sizeof(buf), "rgw_gc_%d", i);
+    worker->create(buf);
+    workers.push_back(worker);
+  }
 }
 
 void RGWGC::stop_processor()
 {
   down_flag = true;
-  if (worker) {
+  for (auto worker : workers) {
     worker->stop();
     worker->join();
+    delete worker;
   }
-  delete worker;
-  worker = NULL;
+  workers.clear();
 }
 
 void *RGWGC::GCWorker::entry() {
   do {
     utime_t start = ceph_clock_now();
-    dout(2) << "garbage collection: start" << dendl;
-    int r = gc->process();
+    dout(2) << "garbage collection: start (worker " << id << ")" << dendl;
+    int r = gc->process(id);
     if (r < 0) {
       dout(0) << "ERROR: garbage collection process() returned error r=" << r << dendl;
     }
-    dout(2) << "garbage collection: stop" << dendl;
+    dout(2) << "garbage collection: stop (worker " << id << ")" << dendl;
 
     if (gc->going_down())
       break;
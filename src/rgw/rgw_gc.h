@@ -28,18 +28,19 @@ class RGWGC {
   class GCWorker : public Thread {
     CephContext *cct;
     RGWGC *gc;
+    int id;
     Mutex lock;
     Cond cond;
 
   public:
-    GCWorker(CephContext *_cct, RGWGC *_gc) : cct(_cct), gc(_gc), lock("GCWorker") {}
+    GCWorker(CephContext *_cct, RGWGC *_gc, int _id) : cct(_cct), gc(_gc), id(_id), lock("GCWorker") {}
     void *entry() override;
     void stop();
   };
 
-  GCWorker *worker;
+  std::vector<GCWorker *> workers;
 public:
-  RGWGC() : cct(NULL), store(NULL), max_objs(0), obj_names(NULL), worker(NULL) {}
+  RGWGC() : cct(NULL), store(NULL), max_objs(0), obj_names(NULL) {}
   ~RGWGC() {
     stop_processor();
     finalize();
@@ -55,8 +56,9 @@ public:
 
   int list(int *index, string& marker, uint32_t max, bool expired_only, std::list<cls_rgw_gc_obj_info>& result, bool *truncated);
   void list_init(int *index) { *index = 0; }
-  int process(int index, int process_max_secs);
-  int process();
+  int process(int index, int process_max_secs,
+	      uint64_t *pending_entries = NULL, ceph::real_time *oldest_pending = NULL);
+  int process(int worker_id = 0);
 
   bool going_down();
   void start_processor();
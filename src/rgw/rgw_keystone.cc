@@ -404,32 +404,41 @@ int TokenEnvelope::parse(CephContext* const cct,
 bool TokenCache::find(const std::string& token_id,
                       rgw::keystone::TokenEnvelope& token)
 {
-  Mutex::Locker l(lock);
-  return find_locked(token_id, token);
+  Shard& shard = get_shard(token_id);
+  Mutex::Locker l(shard.lock);
+  return find_locked(shard, token_id, token);
 }
 
-bool TokenCache::find_locked(const std::string& token_id,
+bool TokenCache::find_locked(Shard& shard, const std::string& token_id,
                              rgw::keystone::TokenEnvelope& token)
 {
-  assert(lock.is_locked_by_me());
-  map<string, token_entry>::iterator iter = tokens.find(token_id);
-  if (iter == tokens.end()) {
+  assert(shard.lock.is_locked_by_me());
+  map<string, token_entry>::iterator iter = shard.tokens.find(token_id);
+  if (iter == shard.tokens.end()) {
     if (perfcounter) perfcounter->inc(l_rgw_keystone_token_cache_miss);
     return false;
   }
 
   token_entry& entry = iter->second;
-  tokens_lru.erase(entry.lru_iter);
+
+  if (entry.invalid_until) {
+    /* A cached rejection isn't a usable token. find_invalid() takes
+     * care of returning and expiring such entries. */
+    if (perfcounter) perfcounter->inc(l_rgw_keystone_token_cache_miss);
+    return false;
+  }
+
+  shard.tokens_lru.erase(entry.lru_iter);
 
   if (entry.token.expired()) {
-    tokens.erase(iter);
+    shard.tokens.erase(iter);
     if (perfcounter) perfcounter->inc(l_rgw_keystone_token_cache_hit);
     return false;
   }
   token = entry.token;
 
-  tokens_lru.push_front(token_id);
-  entry.lru_iter = tokens_lru.begin();
+  shard.tokens_lru.push_front(token_id);
+  entry.lru_iter = shard.tokens_lru.begin();
 
   if (perfcounter) perfcounter->inc(l_rgw_keystone_token_cache_hit);
 
@@ -438,76 +447,180 @@ bool TokenCache::find_locked(const std::string& token_id,
 
 bool TokenCache::find_admin(rgw::keystone::TokenEnvelope& token)
 {
-  Mutex::Locker l(lock);
-
-  return find_locked(admin_token_id, token);
+  std::string token_id;
+  {
+    Mutex::Locker l(lock);
+    token_id = admin_token_id;
+  }
+  if (token_id.empty()) {
+    return false;
+  }
+  return find(token_id, token);
 }
 
 bool TokenCache::find_barbican(rgw::keystone::TokenEnvelope& token)
 {
-  Mutex::Locker l(lock);
+  std::string token_id;
+  {
+    Mutex::Locker l(lock);
+    token_id = barbican_token_id;
+  }
+  if (token_id.empty()) {
+    return false;
+  }
+  return find(token_id, token);
+}
 
-  return find_locked(barbican_token_id, token);
+bool TokenCache::find_invalid(const std::string& token_id)
+{
+  Shard& shard = get_shard(token_id);
+  Mutex::Locker l(shard.lock);
+
+  map<string, token_entry>::iterator iter = shard.tokens.find(token_id);
+  if (iter == shard.tokens.end()) {
+    return false;
+  }
+
+  token_entry& entry = iter->second;
+  if (! entry.invalid_until) {
+    return false;
+  }
+
+  if (ceph_clock_now().sec() >= entry.invalid_until) {
+    shard.tokens_lru.erase(entry.lru_iter);
+    shard.tokens.erase(iter);
+    return false;
+  }
+
+  if (perfcounter) perfcounter->inc(l_rgw_keystone_token_cache_hit);
+
+  return true;
 }
 
 void TokenCache::add(const std::string& token_id,
                      const rgw::keystone::TokenEnvelope& token)
 {
-  Mutex::Locker l(lock);
-  add_locked(token_id, token);
+  Shard& shard = get_shard(token_id);
+  Mutex::Locker l(shard.lock);
+  add_locked(shard, token_id, token);
 }
 
-void TokenCache::add_locked(const std::string& token_id,
+void TokenCache::add_locked(Shard& shard, const std::string& token_id,
                             const rgw::keystone::TokenEnvelope& token)
 {
-  assert(lock.is_locked_by_me());
-  map<string, token_entry>::iterator iter = tokens.find(token_id);
-  if (iter != tokens.end()) {
+  assert(shard.lock.is_locked_by_me());
+  map<string, token_entry>::iterator iter = shard.tokens.find(token_id);
+  if (iter != shard.tokens.end()) {
     token_entry& e = iter->second;
-    tokens_lru.erase(e.lru_iter);
+    shard.tokens_lru.erase(e.lru_iter);
   }
 
-  tokens_lru.push_front(token_id);
-  token_entry& entry = tokens[token_id];
+  shard.tokens_lru.push_front(token_id);
+  token_entry& entry = shard.tokens[token_id];
   entry.token = token;
-  entry.lru_iter = tokens_lru.begin();
+  entry.invalid_until = 0;
+  entry.lru_iter = shard.tokens_lru.begin();
 
-  while (tokens_lru.size() > max) {
-    list<string>::reverse_iterator riter = tokens_lru.rbegin();
-    iter = tokens.find(*riter);
-    assert(iter != tokens.end());
-    tokens.erase(iter);
-    tokens_lru.pop_back();
+  while (shard.tokens_lru.size() > max) {
+    list<string>::reverse_iterator riter = shard.tokens_lru.rbegin();
+    iter = shard.tokens.find(*riter);
+    assert(iter != shard.tokens.end());
+    shard.tokens.erase(iter);
+    shard.tokens_lru.pop_back();
   }
 }
 
 void TokenCache::add_admin(const rgw::keystone::TokenEnvelope& token)
 {
-  Mutex::Locker l(lock);
+  std::string token_id;
+  rgw_get_token_id(token.token.id, token_id);
 
-  rgw_get_token_id(token.token.id, admin_token_id);
-  add_locked(admin_token_id, token);
+  {
+    Mutex::Locker l(lock);
+    admin_token_id = token_id;
+  }
+  add(token_id, token);
 }
 
 void TokenCache::add_barbican(const rgw::keystone::TokenEnvelope& token)
 {
-  Mutex::Locker l(lock);
+  std::string token_id;
+  rgw_get_token_id(token.token.id, token_id);
+
+  {
+    Mutex::Locker l(lock);
+    barbican_token_id = token_id;
+  }
+  add(token_id, token);
+}
+
+void TokenCache::add_invalid(const std::string& token_id)
+{
+  const int ttl = cct->_conf->rgw_keystone_token_cache_negative_ttl;
+  if (ttl <= 0) {
+    return;
+  }
+
+  Shard& shard = get_shard(token_id);
+  Mutex::Locker l(shard.lock);
 
-  rgw_get_token_id(token.token.id, barbican_token_id);
-  add_locked(barbican_token_id, token);
+  add_locked(shard, token_id, TokenEnvelope());
+  shard.tokens[token_id].invalid_until = ceph_clock_now().sec() + ttl;
 }
 
 void TokenCache::invalidate(const std::string& token_id)
 {
-  Mutex::Locker l(lock);
-  map<string, token_entry>::iterator iter = tokens.find(token_id);
-  if (iter == tokens.end())
+  Shard& shard = get_shard(token_id);
+  Mutex::Locker l(shard.lock);
+  map<string, token_entry>::iterator iter = shard.tokens.find(token_id);
+  if (iter == shard.tokens.end())
     return;
 
   ldout(cct, 20) << "invalidating revoked token id=" << token_id << dendl;
   token_entry& e = iter->second;
-  tokens_lru.erase(e.lru_iter);
-  tokens.erase(iter);
+  shard.tokens_lru.erase(e.lru_iter);
+  shard.tokens.erase(iter);
+}
+
+bool TokenCache::start_validation(const std::string& token_id)
+{
+  Mutex::Locker l(lock);
+
+  map<string, validation_entry *>::iterator iter = validations.find(token_id);
+  if (iter == validations.end()) {
+    validations[token_id] = new validation_entry;
+    return true;
+  }
+
+  validation_entry *e = iter->second;
+  e->waiters++;
+  while (! e->done) {
+    e->cond.Wait(lock);
+  }
+  if (--e->waiters == 0) {
+    delete e;
+  }
+
+  return false;
+}
+
+void TokenCache::finish_validation(const std::string& token_id)
+{
+  Mutex::Locker l(lock);
+
+  map<string, validation_entry *>::iterator iter = validations.find(token_id);
+  if (iter == validations.end()) {
+    return;
+  }
+
+  validation_entry *e = iter->second;
+  validations.erase(iter);
+  e->done = true;
+  if (e->waiters > 0) {
+    e->cond.SignalAll();
+  } else {
+    delete e;
+  }
 }
 
 int TokenCache::RevokeThread::check_revoked()
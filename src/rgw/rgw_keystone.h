@@ -12,6 +12,7 @@
 #include "rgw_common.h"
 #include "rgw_http_client.h"
 #include "common/Cond.h"
+#include "include/ceph_hash.h"
 
 #include <atomic>
 
@@ -215,6 +216,7 @@ public:
 class TokenCache {
   struct token_entry {
     TokenEnvelope token;
+    time_t invalid_until = 0;  /* a negative entry when non-zero */
     list<string>::iterator lru_iter;
   };
 
@@ -246,20 +248,48 @@ class TokenCache {
 
   CephContext * const cct;
 
+  /* The cache is sharded by token id hash so that concurrent requests
+   * don't all serialize on a single lock. Each shard has its own LRU. */
+  struct Shard {
+    std::map<std::string, token_entry> tokens;
+    std::list<std::string> tokens_lru;
+    Mutex lock;
+
+    Shard() : lock("rgw::keystone::TokenCache::Shard") {}
+  };
+
+  /* Tracks tokens with a validation request to Keystone in flight, so
+   * that concurrent requests bearing the same token trigger just one
+   * round-trip and the remaining threads wait for its result. */
+  struct validation_entry {
+    Cond cond;
+    int waiters = 0;
+    bool done = false;
+  };
+
+  static constexpr unsigned SHARD_COUNT = 16;
+
+  Shard shards[SHARD_COUNT];
+
   std::string admin_token_id;
   std::string barbican_token_id;
-  std::map<std::string, token_entry> tokens;
-  std::list<std::string> tokens_lru;
 
-  Mutex lock;
+  Mutex lock; //< protects admin/barbican token ids and validations
+  std::map<std::string, validation_entry *> validations;
 
-  const size_t max;
+  const size_t max; //< per shard
+
+  Shard& get_shard(const std::string& token_id) {
+    return shards[ceph_str_hash_linux(token_id.c_str(),
+                                      token_id.size()) % SHARD_COUNT];
+  }
 
   TokenCache(const rgw::keystone::Config& config)
     : revocator(g_ceph_context, this, config),
       cct(g_ceph_context),
       lock("rgw::keystone::TokenCache"),
-      max(cct->_conf->rgw_keystone_token_cache_size) {
+      max((cct->_conf->rgw_keystone_token_cache_size + SHARD_COUNT - 1)
+          / SHARD_COUNT) {
     /* revocation logic needs to be smarter, but meanwhile,
      *  make it optional.
      * see http://tracker.ceph.com/issues/9493
@@ -303,14 +333,25 @@ public:
   }
   bool find_admin(TokenEnvelope& token);
   bool find_barbican(TokenEnvelope& token);
+  bool find_invalid(const std::string& token_id);
   void add(const std::string& token_id, const TokenEnvelope& token);
   void add_admin(const TokenEnvelope& token);
   void add_barbican(const TokenEnvelope& token);
+  void add_invalid(const std::string& token_id);
   void invalidate(const std::string& token_id);
   bool going_down() const;
+
+  /* Returns true if the caller is responsible for validating the token
+   * against Keystone and must call finish_validation() afterwards. A false
+   * return means another thread just finished validating the very same
+   * token; its result (positive or negative) is already in the cache. */
+  bool start_validation(const std::string& token_id);
+  void finish_validation(const std::string& token_id);
 private:
-  void add_locked(const std::string& token_id, const TokenEnvelope& token);
-  bool find_locked(const std::string& token_id, TokenEnvelope& token);
+  void add_locked(Shard& shard, const std::string& token_id,
+                  const TokenEnvelope& token);
+  bool find_locked(Shard& shard, const std::string& token_id,
+                   TokenEnvelope& token);
 
 };
 
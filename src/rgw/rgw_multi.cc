@@ -172,6 +172,125 @@ int list_multipart_parts(RGWRados *store, RGWBucketInfo& bucket_info, CephContex
   return 0;
 }
 
+int list_multipart_parts_parallel(RGWRados *store, RGWBucketInfo& bucket_info,
+                                CephContext *cct, const string& upload_id,
+                                string& meta_oid, const map<int, string>& parts_req,
+                                map<uint32_t, RGWUploadPartInfo>& parts,
+                                bool *mismatch)
+{
+  parts.clear();
+  *mismatch = false;
+
+  if (!is_v2_upload_id(upload_id) || parts_req.empty()) {
+    *mismatch = true; /* no sorted omap keys to predict pages with */
+    return 0;
+  }
+
+  /* page boundaries are predicted from the client's part list, which for a
+   * well-formed completion names exactly the parts in the upload. any
+   * discrepancy (missing part, extra part, unsorted omap keys written by a
+   * mixed rgw version) surfaces as a page mismatch below */
+  std::vector<string> keys;
+  keys.reserve(parts_req.size());
+  for (auto& part : parts_req) {
+    if (part.first < 0) {
+      *mismatch = true;
+      return 0;
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "part.%08d", part.first);
+    keys.push_back(buf);
+  }
+
+  rgw_obj obj;
+  obj.init_ns(bucket_info.bucket, meta_oid, RGW_OBJ_NS_MULTIPART);
+  obj.set_in_extra_data(true);
+
+  rgw_raw_obj raw_obj;
+  store->obj_to_raw(bucket_info.placement_rule, obj, &raw_obj);
+
+  rgw_rados_ref ref;
+  int ret = store->get_raw_obj_ref(raw_obj, &ref);
+  if (ret < 0)
+    return ret;
+
+#define PARTS_PER_OMAP_PAGE 1000
+  struct Page {
+    std::map<string, bufferlist> vals;
+    bool more{false};
+    int rval{0};
+    librados::AioCompletion *completion{nullptr};
+  };
+  size_t num_pages = (keys.size() + PARTS_PER_OMAP_PAGE - 1) / PARTS_PER_OMAP_PAGE;
+  std::vector<Page> pages(num_pages);
+
+  /* read all of the pages in one concurrent sweep instead of waiting out
+   * a round trip per page */
+  for (size_t i = 0; i < num_pages; i++) {
+    size_t first = i * PARTS_PER_OMAP_PAGE;
+    size_t count = std::min<size_t>(keys.size() - first, PARTS_PER_OMAP_PAGE);
+    string start_after = (i == 0 ? string("part.") : keys[first - 1]);
+
+    librados::ObjectReadOperation op;
+    op.omap_get_vals2(start_after, count, &pages[i].vals, &pages[i].more,
+                      &pages[i].rval);
+    pages[i].completion = librados::Rados::aio_create_completion(NULL, NULL, NULL);
+    ret = ref.ioctx.aio_operate(ref.oid, pages[i].completion, &op, NULL);
+    if (ret < 0)
+      break;
+  }
+
+  int first_err = (ret < 0 ? ret : 0);
+  for (auto& page : pages) {
+    if (!page.completion)
+      continue;
+    page.completion->wait_for_complete();
+    int r = page.completion->get_return_value();
+    if (r < 0 && first_err >= 0)
+      first_err = r;
+    page.completion->release();
+  }
+  if (first_err < 0)
+    return first_err;
+
+  size_t idx = 0;
+  for (size_t i = 0; i < num_pages; i++) {
+    Page& page = pages[i];
+    size_t first = i * PARTS_PER_OMAP_PAGE;
+    size_t count = std::min<size_t>(keys.size() - first, PARTS_PER_OMAP_PAGE);
+
+    if (page.rval < 0)
+      return page.rval;
+
+    if (page.vals.size() != count ||
+        (i == num_pages - 1 && page.more)) {
+      parts.clear();
+      *mismatch = true;
+      return 0;
+    }
+
+    for (auto& kv : page.vals) {
+      if (kv.first != keys[idx]) {
+        parts.clear();
+        *mismatch = true;
+        return 0;
+      }
+      bufferlist::iterator bli = kv.second.begin();
+      RGWUploadPartInfo info;
+      try {
+        ::decode(info, bli);
+      } catch (buffer::error& err) {
+        ldout(cct, 0) << "ERROR: could not part info, caught buffer::error" << dendl;
+        return -EIO;
+      }
+      parts[info.num] = info;
+      ++idx;
+    }
+  }
+
+  return 0;
+}
+
 int list_multipart_parts(RGWRados *store, struct req_state *s,
                                 const string& upload_id,
                                 string& meta_oid, int num_parts,
@@ -95,6 +95,18 @@ extern int list_multipart_parts(RGWRados *store, struct req_state *s,
                                 int *next_marker, bool *truncated,
                                 bool assume_unsorted = false);
 
+/* fetch the info for the exact set of parts named in a complete request,
+ * reading all of the meta object's omap pages concurrently instead of one
+ * round trip per page. only usable with v2 upload ids, whose omap keys sort
+ * in part order; if the upload's contents don't match the request (or the
+ * keys turn out unsorted), *mismatch is set and the caller should fall back
+ * to list_multipart_parts() to diagnose the specific error */
+extern int list_multipart_parts_parallel(RGWRados *store, RGWBucketInfo& bucket_info,
+                                CephContext *cct, const string& upload_id,
+                                string& meta_oid, const map<int, string>& parts_req,
+                                map<uint32_t, RGWUploadPartInfo>& parts,
+                                bool *mismatch);
+
 extern int abort_multipart_upload(RGWRados *store, CephContext *cct, RGWObjectCtx *obj_ctx,
                                 RGWBucketInfo& bucket_info, RGWMPObj& mp_obj);
 
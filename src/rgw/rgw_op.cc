@@ -3173,6 +3173,16 @@ static CompressorRef get_compressor_plugin(const req_state *s,
   return Compressor::create(s->cct, alg);
 }
 
+/* feed a bufferlist into an MD5 digest segment by segment; calling c_str()
+ * on a multi-segment bufferlist would first flatten it into a freshly
+ * allocated contiguous buffer, copying the whole chunk */
+static void hash_update_bl(MD5& hash, const bufferlist& bl)
+{
+  for (const auto& ptr : bl.buffers()) {
+    hash.Update((const byte *)ptr.c_str(), ptr.length());
+  }
+}
+
 void RGWPutObj::execute()
 {
   RGWPutObjProcessor *processor = NULL;
@@ -3324,7 +3334,7 @@ void RGWPutObj::execute()
     }
 
     if (need_calc_md5) {
-      hash.Update((const byte *)data.c_str(), data.length());
+      hash_update_bl(hash, data);
     }
 
     /* update torrrent */
@@ -3653,7 +3663,7 @@ void RGWPostObj::execute()
         break;
       }
 
-      hash.Update((const byte *)data.c_str(), data.length());
+      hash_update_bl(hash, data);
       op_ret = put_data_and_throttle(filter, data, ofs, false);
 
       ofs += len;
@@ -5188,21 +5198,45 @@ void RGWCompleteMultipart::execute()
     return;
   }
 
-  do {
-    op_ret = list_multipart_parts(store, s, upload_id, meta_oid, max_parts,
-				  marker, obj_parts, &marker, &truncated);
+  bool parts_prefetched = false;
+  if (is_v2_upload_id(upload_id)) {
+    /* fetch all of the requested parts' info in one concurrent sweep of the
+     * meta object's omap, so completion isn't serialized on a round trip
+     * per 1000 parts */
+    bool mismatch = false;
+    op_ret = list_multipart_parts_parallel(store, s->bucket_info, s->cct,
+					   upload_id, meta_oid, parts->parts,
+					   obj_parts, &mismatch);
     if (op_ret == -ENOENT) {
       op_ret = -ERR_NO_SUCH_UPLOAD;
     }
     if (op_ret < 0)
       return;
+    /* on a mismatch fall through to the serial listing below, which
+     * reports the offending part as before */
+    parts_prefetched = !mismatch;
+  }
 
-    total_parts += obj_parts.size();
-    if (!truncated && total_parts != (int)parts->parts.size()) {
-      ldout(s->cct, 0) << "NOTICE: total parts mismatch: have: " << total_parts
-		       << " expected: " << parts->parts.size() << dendl;
-      op_ret = -ERR_INVALID_PART;
-      return;
+  do {
+    if (parts_prefetched) {
+      truncated = false;
+      total_parts = obj_parts.size();
+    } else {
+      op_ret = list_multipart_parts(store, s, upload_id, meta_oid, max_parts,
+				    marker, obj_parts, &marker, &truncated);
+      if (op_ret == -ENOENT) {
+        op_ret = -ERR_NO_SUCH_UPLOAD;
+      }
+      if (op_ret < 0)
+        return;
+
+      total_parts += obj_parts.size();
+      if (!truncated && total_parts != (int)parts->parts.size()) {
+        ldout(s->cct, 0) << "NOTICE: total parts mismatch: have: " << total_parts
+			 << " expected: " << parts->parts.size() << dendl;
+        op_ret = -ERR_INVALID_PART;
+        return;
+      }
     }
 
     for (obj_iter = obj_parts.begin(); iter != parts->parts.end() && obj_iter != obj_parts.end(); ++iter, ++obj_iter, ++handled_parts) {
@@ -6176,7 +6210,7 @@ int RGWBulkUploadOp::handle_file(const boost::string_ref path,
       op_ret = len;
       return op_ret;
     } else if (len > 0) {
-      hash.Update((const byte *)data.c_str(), data.length());
+      hash_update_bl(hash, data);
       op_ret = put_data_and_throttle(filter, data, ofs, false);
       if (op_ret < 0) {
         ldout(s->cct, 20) << "processor->thottle_data() returned ret="
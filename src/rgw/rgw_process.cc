@@ -12,6 +12,7 @@
 #include "rgw_process.h"
 #include "rgw_loadgen.h"
 #include "rgw_client_io.h"
+#include "rgw_qos.h"
 
 #define dout_subsys ceph_subsys_rgw
 
@@ -119,6 +120,10 @@ int process_request(RGWRados* const store,
 {
   int ret = 0;
 
+  /* all frontends funnel through here, so a single throttle instance sees
+   * the whole request stream */
+  static RGWQoSThrottle qos_throttle(g_ceph_context);
+
   client_io->init(g_ceph_context);
 
   req->log_init();
@@ -199,6 +204,21 @@ int process_request(RGWRados* const store,
     goto done;
   }
 
+  {
+    /* admission control: now that the requester and bucket are known, shed
+     * the request if either of them is over its configured ops budget */
+    double retry_after = 0;
+    string bucket_key = s->bucket_tenant.empty() ? s->bucket_name
+					: s->bucket_tenant + "/" + s->bucket_name;
+    if (!qos_throttle.admit(s->user->user_id.to_str(), bucket_key, &retry_after)) {
+      dout(5) << "request shed by qos throttle, uid=" << s->user->user_id
+	      << " bucket=" << bucket_key << dendl;
+      dump_header(s, "Retry-After", (long long)retry_after + 1);
+      abort_early(s, op, -ERR_SERVICE_UNAVAILABLE, handler);
+      goto done;
+    }
+  }
+
   ret = rgw_process_authenticated(handler, op, req, s);
   if (ret < 0) {
     abort_early(s, op, ret, handler);
@@ -0,0 +1,102 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "rgw_qos.h"
+
+#include "common/ceph_context.h"
+#include "common/config.h"
+#include "common/dout.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define dout_context g_ceph_context
+#define dout_subsys ceph_subsys_rgw
+
+/* keep idle token buckets around for a while so short request gaps don't
+ * reset the accounting */
+#define QOS_IDLE_PURGE_SECS 300
+
+RGWQoSThrottle::RGWQoSThrottle(CephContext *_cct)
+  : cct(_cct), lock("RGWQoSThrottle")
+{
+}
+
+bool RGWQoSThrottle::try_admit(const std::string& key, int64_t rate, int64_t burst, double *retry_after)
+{
+  if (burst <= 0) {
+    burst = rate;
+  }
+
+  utime_t now = ceph_clock_now();
+  TokenBucket& tb = state[key];
+  if (tb.last_refill.is_zero()) {
+    /* first request for this key, start with a full bucket */
+    tb.tokens = burst;
+  } else {
+    double elapsed = now - tb.last_refill;
+    tb.tokens = std::min((double)burst, tb.tokens + elapsed * rate);
+  }
+  tb.last_refill = now;
+
+  if (tb.tokens >= 1) {
+    tb.tokens -= 1;
+    return true;
+  }
+
+  double wait = (1 - tb.tokens) / rate;
+  if (wait > *retry_after) {
+    *retry_after = wait;
+  }
+  ldout(cct, 10) << "qos: out of tokens for " << key << ", retry in " << wait << "s" << dendl;
+  return false;
+}
+
+void RGWQoSThrottle::trim(const utime_t& now)
+{
+  size_t max_entries = cct->_conf->rgw_qos_cache_size;
+  if (state.size() <= max_entries) {
+    return;
+  }
+
+  for (auto iter = state.begin(); iter != state.end(); ) {
+    if (now - iter->second.last_refill > QOS_IDLE_PURGE_SECS) {
+      iter = state.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+bool RGWQoSThrottle::admit(const std::string& user_id, const std::string& bucket_key, double *retry_after)
+{
+  int64_t user_rate = cct->_conf->rgw_qos_user_ops_rate;
+  int64_t bucket_rate = cct->_conf->rgw_qos_bucket_ops_rate;
+
+  if (user_rate <= 0 && bucket_rate <= 0) {
+    return true;
+  }
+
+  Mutex::Locker l(lock);
+
+  bool admitted = true;
+
+  /* deliberately charge both buckets even when one of them sheds the
+   * request: a shed request still occupied a frontend thread */
+  if (user_rate > 0 && !user_id.empty()) {
+    if (!try_admit("u:" + user_id, user_rate,
+		   cct->_conf->rgw_qos_user_ops_burst, retry_after)) {
+      admitted = false;
+    }
+  }
+  if (bucket_rate > 0 && !bucket_key.empty()) {
+    if (!try_admit("b:" + bucket_key, bucket_rate,
+		   cct->_conf->rgw_qos_bucket_ops_burst, retry_after)) {
+      admitted = false;
+    }
+  }
+
+  trim(ceph_clock_now());
+
+  return admitted;
+}
@@ -0,0 +1,43 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#ifndef CEPH_RGW_QOS_H
+#define CEPH_RGW_QOS_H
+
+#include <string>
+#include <map>
+
+#include "common/Mutex.h"
+#include "include/utime.h"
+
+class CephContext;
+
+/* Token bucket admission control for the request path, keyed by user and
+ * bucket. Requests are admitted while tokens are available and shed
+ * otherwise, so a single tenant hammering the gateway can't consume every
+ * frontend thread. Rates and bursts come from the rgw_qos_* config options;
+ * a rate of zero disables the corresponding check.
+ */
+class RGWQoSThrottle {
+  struct TokenBucket {
+    double tokens{0};
+    utime_t last_refill;
+  };
+
+  CephContext *cct;
+  Mutex lock;
+  std::map<std::string, TokenBucket> state;
+
+  /* caller holds lock */
+  bool try_admit(const std::string& key, int64_t rate, int64_t burst, double *retry_after);
+  void trim(const utime_t& now);
+
+public:
+  explicit RGWQoSThrottle(CephContext *_cct);
+
+  /* decide whether to admit a request for the given user and bucket; when
+   * shedding, *retry_after holds the suggested client backoff in seconds */
+  bool admit(const std::string& user_id, const std::string& bucket_key, double *retry_after);
+};
+
+#endif
@@ -2539,6 +2539,18 @@ int RGWPutObjProcessor_Aio::throttle_data(void *handle, const rgw_raw_obj& obj,
 
   /* now throttle. Note that need_to_wait should only affect the first IO operation */
   if (pending_size > window_size || _wait) {
+    if (orig_size == pending_size && pending_size > window_size) {
+      /* nothing completed since the last call and the window is full: acks
+       * are lagging the arrival rate, so shrink the window and surface the
+       * backpressure to the client sooner instead of buffering more */
+      uint64_t min_window_size = store->ctx()->_conf->rgw_put_obj_min_window_size;
+      uint64_t chunk_size = store->ctx()->_conf->rgw_max_chunk_size;
+      if (window_size > min_window_size + chunk_size) {
+        window_size -= chunk_size;
+      } else {
+        window_size = min_window_size;
+      }
+    }
     int r = wait_pending_front();
     if (r < 0)
       return r;
@@ -3055,6 +3067,22 @@ void *RGWRadosThread::Worker::entry() {
   return NULL;
 }
 
+/* periodically sends out the cache invalidation notifies that distribute()
+ * coalesced (only runs when rgw_cache_notify_interval_msec > 0) */
+class RGWCacheNotifyFlusher : public RGWRadosThread {
+  uint64_t interval_msec() override {
+    return cct->_conf->rgw_cache_notify_interval_msec;
+  }
+public:
+  explicit RGWCacheNotifyFlusher(RGWRados *_store)
+    : RGWRadosThread(_store, "cache_ntfy") {}
+
+  int process() override {
+    store->flush_cache_notifies();
+    return 0;
+  }
+};
+
 class RGWMetaNotifier : public RGWRadosThread {
   RGWMetaNotifierManager notify_mgr;
   RGWMetadataLog *const log;
@@ -4580,6 +4608,14 @@ int RGWRados::initialize()
 
 void RGWRados::finalize_watch()
 {
+  if (cache_notify_flusher) {
+    cache_notify_flusher->stop();
+    delete cache_notify_flusher;
+    cache_notify_flusher = NULL;
+    /* push out whatever was still pending */
+    flush_cache_notifies();
+  }
+
   for (int i = 0; i < num_watchers; i++) {
     RGWWatcher *watcher = watchers[i];
     watcher->unregister_watch();
@@ -4748,6 +4784,12 @@ int RGWRados::init_watch()
       return r;
   }
 
+  if (cct->_conf->rgw_cache_notify_interval_msec > 0) {
+    cache_notify_pending.resize(num_watchers);
+    cache_notify_flusher = new RGWCacheNotifyFlusher(this);
+    cache_notify_flusher->start();
+  }
+
   watch_initialized = true;
 
   set_cache_enabled(true);
@@ -4755,7 +4797,7 @@ int RGWRados::init_watch()
   return 0;
 }
 
-void RGWRados::pick_control_oid(const string& key, string& notify_oid)
+void RGWRados::pick_control_oid(const string& key, string& notify_oid, int *pindex)
 {
   uint32_t r = ceph_str_hash_linux(key.c_str(), key.size());
 
@@ -4765,6 +4807,10 @@ void RGWRados::pick_control_oid(const string& key, string& notify_oid)
 
   notify_oid = notify_oid_prefix;
   notify_oid.append(buf);
+
+  if (pindex) {
+    *pindex = i;
+  }
 }
 
 int RGWRados::open_pool_ctx(const rgw_pool& pool, librados::IoCtx&  io_ctx)
@@ -8213,24 +8259,27 @@ bool RGWRados::is_syncing_bucket_meta(const rgw_bucket& bucket)
 
 int RGWRados::check_bucket_empty(RGWBucketInfo& bucket_info)
 {
-  std::map<string, rgw_bucket_dir_entry> ent_map;
+  std::vector<rgw_bucket_dir_entry> ent_list;
   rgw_obj_index_key marker;
   string prefix;
   bool is_truncated;
 
   do {
+    ent_list.clear();
 #define NUM_ENTRIES 1000
-    int r = cls_bucket_list(bucket_info, RGW_NO_SHARD, marker, prefix, NUM_ENTRIES, true, ent_map,
-                        &is_truncated, &marker);
+    // name ordering doesn't matter here, so use the unordered scan and
+    // avoid querying every index shard for each page
+    int r = cls_bucket_list_unordered(bucket_info, RGW_NO_SHARD, marker, prefix,
+                                      NUM_ENTRIES, true, ent_list,
+                                      &is_truncated, &marker);
     if (r < 0)
       return r;
 
     string ns;
-    std::map<string, rgw_bucket_dir_entry>::iterator eiter;
-    for (eiter = ent_map.begin(); eiter != ent_map.end(); ++eiter) {
+    for (auto& entry : ent_list) {
       rgw_obj_key obj;
 
-      if (rgw_obj_key::oid_to_key_in_ns(eiter->second.key.name, &obj, ns))
+      if (rgw_obj_key::oid_to_key_in_ns(entry.key.name, &obj, ns))
         return -ENOTEMPTY;
     }
   } while (is_truncated);
@@ -10181,6 +10230,7 @@ struct get_obj_data : public RefCountedObject {
   uint64_t total_read;
   Mutex lock;
   Mutex data_lock;
+  Cond data_cond; /* signalled (under data_lock) when an io completes */
   list<get_obj_aio_data> aio_data;
   RGWGetDataCB *client_cb;
   std::atomic<bool> cancelled = { false };
@@ -10368,18 +10418,26 @@ void RGWRados::get_obj_aio_completion_cb(completion_t c, void *arg)
   int r;
 
   ldout(cct, 20) << "get_obj_aio_completion_cb: io completion ofs=" << ofs << " len=" << len << dendl;
-  d->throttle.put(len);
 
   r = rados_aio_get_return_value(c);
-  if (r < 0) {
-    ldout(cct, 0) << "ERROR: got unexpected error when trying to read object: " << r << dendl;
-    d->set_cancelled(r);
+  if (r < 0 || d->is_cancelled()) {
+    /* nothing will be handed to the client, return the whole reservation */
+    d->throttle.put(len);
+    if (r < 0) {
+      ldout(cct, 0) << "ERROR: got unexpected error when trying to read object: " << r << dendl;
+      d->set_cancelled(r);
+    }
+    d->data_lock.Lock();
+    d->data_cond.SignalAll();
+    d->data_lock.Unlock();
     goto done;
   }
 
-  if (d->is_cancelled()) {
-    goto done;
-  }
+  /* the reservation for data that was actually read is only returned once
+   * the data is handed to the client (flush_read_list()), so that the read
+   * window is paced by the client drain rate; short reads return the
+   * remainder now */
+  d->throttle.put(len - r);
 
   d->data_lock.Lock();
 
@@ -10391,6 +10449,7 @@ void RGWRados::get_obj_aio_completion_cb(completion_t c, void *arg)
   d->read_list.splice(d->read_list.end(), bl_list);
 
 done_unlock:
+  d->data_cond.SignalAll();
   d->data_lock.Unlock();
 done:
   d->put();
@@ -10413,6 +10472,9 @@ int RGWRados::flush_read_list(struct get_obj_data *d)
   for (iter = l.begin(); iter != l.end(); ++iter) {
     bufferlist& bl = *iter;
     r = d->client_cb->handle_data(bl, 0, bl.length());
+    /* now that the data has been written out to the client its window
+     * reservation can be returned, unblocking further reads */
+    d->throttle.put(bl.length());
     if (r < 0) {
       dout(0) << "ERROR: flush_read_list(): d->client_cb->handle_data() returned " << r << dendl;
       break;
@@ -10473,7 +10535,27 @@ int RGWRados::get_obj_iterate_cb(RGWObjectCtx *ctx, RGWObjState *astate,
     }
   }
 
-  d->throttle.get(len);
+  /* Reserve a window slot for the read. The reservation is only released
+   * back as the data is written out to the client, so the window bounds how
+   * far ahead of the client we read the tail objects: a fast client keeps
+   * the full window of reads in flight across the osds, while a slow one
+   * stops us from buffering more than the window. Since this thread is also
+   * the one draining to the client, flush whatever is ready while waiting
+   * for a slot to open up. */
+  while (!d->throttle.get_or_fail(len)) {
+    if (d->is_cancelled()) {
+      return d->get_err_code();
+    }
+    r = flush_read_list(d);
+    if (r < 0) {
+      return r;
+    }
+    d->data_lock.Lock();
+    if (d->read_list.empty()) {
+      d->data_cond.WaitInterval(d->data_lock, utime_t(1, 0));
+    }
+    d->data_lock.Unlock();
+  }
   if (d->is_cancelled()) {
     return d->get_err_code();
   }
@@ -12077,10 +12159,71 @@ int RGWRados::distribute(const string& key, bufferlist& bl)
     return 0;
 
   string notify_oid;
-  pick_control_oid(key, notify_oid);
+  int index;
+  pick_control_oid(key, notify_oid, &index);
+
+  if (cache_notify_flusher) {
+    /* coalesce with other updates hashing to the same control oid; the
+     * flusher sends the whole batch as a single notify within the
+     * configured interval */
+    bool flush_now;
+    {
+      Mutex::Locker l(cache_notify_lock);
+      pending_cache_notify& pending = cache_notify_pending[index];
+      if (pending.count == 0) {
+        pending.first_ts = ceph_clock_now();
+      }
+      pending.bl.claim_append(bl);
+      pending.count++;
+#define MAX_CACHE_NOTIFY_SIZE (1 << 20)
+      flush_now = (pending.bl.length() >= MAX_CACHE_NOTIFY_SIZE);
+    }
+    if (flush_now) {
+      flush_cache_notifies();
+    }
+    return 0;
+  }
 
   ldout(cct, 10) << "distributing notification oid=" << notify_oid << " bl.length()=" << bl.length() << dendl;
-  return control_pool_ctx.notify2(notify_oid, bl, 0, NULL);
+  utime_t start = ceph_clock_now();
+  int r = control_pool_ctx.notify2(notify_oid, bl, 0, NULL);
+  if (perfcounter) {
+    perfcounter->tinc(l_rgw_cache_inval_lat, ceph_clock_now() - start);
+  }
+  return r;
+}
+
+void RGWRados::flush_cache_notifies()
+{
+  for (int i = 0; i < num_watchers; i++) {
+    bufferlist bl;
+    utime_t first_ts;
+    int count;
+    {
+      Mutex::Locker l(cache_notify_lock);
+      pending_cache_notify& pending = cache_notify_pending[i];
+      if (pending.count == 0) {
+        continue;
+      }
+      bl.claim(pending.bl);
+      first_ts = pending.first_ts;
+      count = pending.count;
+      pending.count = 0;
+    }
+
+    ldout(cct, 10) << "distributing batched notification oid=" << notify_oids[i]
+                   << " entries=" << count << " bl.length()=" << bl.length() << dendl;
+    int r = control_pool_ctx.notify2(notify_oids[i], bl, 0, NULL);
+    if (r < 0) {
+      ldout(cct, 0) << "ERROR: failed to distribute cache notification on "
+                    << notify_oids[i] << " r=" << r << dendl;
+    }
+    /* latency as seen by a peer: from the oldest coalesced update to the
+     * notify being acked by all watchers */
+    if (perfcounter) {
+      perfcounter->tinc(l_rgw_cache_inval_lat, ceph_clock_now() - first_ts);
+    }
+  }
 }
 
 int RGWRados::pool_iterate_begin(const rgw_pool& pool, RGWPoolIterCtx& ctx)
@@ -12579,9 +12722,12 @@ int RGWRados::cls_bucket_list(RGWBucketInfo& bucket_info, int shard_id, rgw_obj_
     return r;
 
   // Create a list of iterators that are used to iterate each shard
-  vector<map<string, struct rgw_bucket_dir_entry>::iterator> vcurrents(list_results.size());
-  vector<map<string, struct rgw_bucket_dir_entry>::iterator> vends(list_results.size());
-  vector<string> vnames(list_results.size());
+  vector<map<string, struct rgw_bucket_dir_entry>::iterator> vcurrents;
+  vector<map<string, struct rgw_bucket_dir_entry>::iterator> vends;
+  vector<string> vnames;
+  vcurrents.reserve(list_results.size());
+  vends.reserve(list_results.size());
+  vnames.reserve(list_results.size());
   map<int, struct rgw_cls_list_ret>::iterator iter = list_results.begin();
   *is_truncated = false;
   for (; iter != list_results.end(); ++iter) {
@@ -12659,6 +12805,120 @@ int RGWRados::cls_bucket_list(RGWBucketInfo& bucket_info, int shard_id, rgw_obj_
   return 0;
 }
 
+int RGWRados::cls_bucket_list_unordered(RGWBucketInfo& bucket_info, int shard_id,
+			                rgw_obj_index_key& start, const string& prefix,
+				        uint32_t num_entries, bool list_versions,
+				        vector<rgw_bucket_dir_entry>& ent_list,
+				        bool *is_truncated, rgw_obj_index_key *last_entry,
+				        bool (*force_check_filter)(const string& name))
+{
+  ldout(cct, 10) << "cls_bucket_list_unordered " << bucket_info.bucket << " start " << start.name << "[" << start.instance << "] num_entries " << num_entries << dendl;
+
+  *is_truncated = false;
+
+  librados::IoCtx index_ctx;
+  map<int, string> oids;
+  int r = open_bucket_index(bucket_info, index_ctx, oids, shard_id);
+  if (r < 0)
+    return r;
+
+  // entries are returned shard by shard with no cross-shard merge; since
+  // entries are assigned to shards by key hash, the marker's own hash
+  // identifies the shard the previous page left off in, so the cursor
+  // needs no extra state
+  uint32_t current_shard = 0;
+  if (shard_id >= 0) {
+    current_shard = shard_id;
+  } else if (!start.empty()) {
+    int target_shard_id;
+    r = get_target_shard_id(bucket_info, start.name, &target_shard_id);
+    if (r < 0) {
+      return r;
+    }
+    if (target_shard_id >= 0) {
+      current_shard = target_shard_id;
+    }
+  }
+
+  uint32_t count = 0;
+  map<string, bufferlist> updates;
+  rgw_obj_index_key last_added_entry;
+  cls_rgw_obj_key marker_key(start.name, start.instance);
+
+  while (count < num_entries) {
+    assert(oids.count(current_shard) > 0);
+    map<int, string> shard_oid;
+    shard_oid[current_shard] = oids[current_shard];
+
+    map<int, struct rgw_cls_list_ret> list_results;
+    r = CLSRGWIssueBucketList(index_ctx, marker_key, prefix, num_entries - count,
+			      list_versions, shard_oid, list_results,
+			      cct->_conf->rgw_bucket_index_max_aio)();
+    if (r < 0)
+      return r;
+
+    rgw_cls_list_ret& result = list_results[current_shard];
+
+    for (auto& miter : result.dir.m) {
+      rgw_bucket_dir_entry& dirent = miter.second;
+      marker_key = dirent.key;
+
+      bool force_check = force_check_filter && force_check_filter(dirent.key.name);
+      r = 0;
+      if ((!dirent.exists && !dirent.is_delete_marker()) || !dirent.pending_map.empty() || force_check) {
+	/* there are uncommitted ops. We need to check the current state,
+	 * and if the tags are old we need to do cleanup as well. */
+	librados::IoCtx sub_ctx;
+	sub_ctx.dup(index_ctx);
+	r = check_disk_state(sub_ctx, bucket_info, dirent, dirent, updates[shard_oid[current_shard]]);
+	if (r < 0 && r != -ENOENT) {
+	  return r;
+	}
+      }
+      if (r >= 0) {
+	ldout(cct, 10) << "RGWRados::cls_bucket_list_unordered: got " << dirent.key.name << "[" << dirent.key.instance << "]" << dendl;
+	last_added_entry = dirent.key;
+	ent_list.push_back(std::move(dirent));
+	++count;
+      }
+    }
+
+    if (count >= num_entries) {
+      // there may be more entries in this shard or in the remaining shards
+      *is_truncated = result.is_truncated ||
+	(shard_id < 0 && current_shard + 1 < oids.size());
+      break;
+    }
+
+    if (!result.is_truncated) {
+      // this shard is exhausted; move on to the next one
+      if (shard_id >= 0 || current_shard + 1 >= oids.size()) {
+	break;
+      }
+      ++current_shard;
+      marker_key = cls_rgw_obj_key();
+    }
+  }
+
+  // Suggest updates if there is any
+  for (auto& miter : updates) {
+    if (miter.second.length()) {
+      ObjectWriteOperation o;
+      cls_rgw_suggest_changes(o, miter.second);
+      // we don't care if we lose suggested updates, send them off blindly
+      AioCompletion *c = librados::Rados::aio_create_completion(NULL, NULL, NULL);
+      index_ctx.aio_operate(miter.first, c, &o);
+      c->release();
+    }
+  }
+
+  if (!ent_list.empty()) {
+    *last_entry = last_added_entry;
+  }
+
+  return 0;
+}
+
 int RGWRados::cls_obj_usage_log_add(const string& oid, rgw_usage_log_info& info)
 {
   rgw_raw_obj obj(get_zone_params().usage_log_pool, oid);
@@ -25,6 +25,7 @@
 #include "rgw_sync_module.h"
 
 class RGWWatcher;
+class RGWCacheNotifyFlusher;
 class SafeTimer;
 class ACLOwner;
 class RGWGC;
@@ -2285,7 +2286,21 @@ class RGWRados
   librados::IoCtx control_pool_ctx;   // .rgw.control
   bool watch_initialized;
 
+  /* batched cache invalidation notifies, one pending batch per control oid
+   * (only used when rgw_cache_notify_interval_msec > 0) */
+  struct pending_cache_notify {
+    bufferlist bl;
+    utime_t first_ts;
+    int count{0};
+  };
+  Mutex cache_notify_lock;
+  std::vector<pending_cache_notify> cache_notify_pending;
+  RGWCacheNotifyFlusher *cache_notify_flusher;
+
+  void flush_cache_notifies();
+
   friend class RGWWatcher;
+  friend class RGWCacheNotifyFlusher;
 
   Mutex bucket_id_lock;
 
@@ -2362,6 +2377,8 @@ public:
                meta_sync_thread_lock("meta_sync_thread_lock"), data_sync_thread_lock("data_sync_thread_lock"),
                num_watchers(0), watchers(NULL),
                watch_initialized(false),
+               cache_notify_lock("cache_notify_lock"),
+               cache_notify_flusher(NULL),
                bucket_id_lock("rados_bucket_id"),
                bucket_index_max_shards(0),
                max_bucket_id(0), cct(NULL),
@@ -3354,7 +3371,7 @@ public:
 		       uint64_t cookie,
 		       uint64_t notifier_id,
 		       bufferlist& bl) { return 0; }
-  void pick_control_oid(const string& key, string& notify_oid);
+  void pick_control_oid(const string& key, string& notify_oid, int *pindex = NULL);
 
   virtual void set_cache_enabled(bool state) {}
 
@@ -3415,6 +3432,13 @@ public:
                       uint32_t num_entries, bool list_versions, map<string, rgw_bucket_dir_entry>& m,
                       bool *is_truncated, rgw_obj_index_key *last_entry,
                       bool (*force_check_filter)(const string&  name) = NULL);
+  /* list the bucket index shard by shard without a cross-shard merge;
+   * entries are not returned in name order, but each page costs a single
+   * round trip instead of one per shard */
+  int cls_bucket_list_unordered(RGWBucketInfo& bucket_info, int shard_id, rgw_obj_index_key& start, const string& prefix,
+                                uint32_t num_entries, bool list_versions, vector<rgw_bucket_dir_entry>& ent_list,
+                                bool *is_truncated, rgw_obj_index_key *last_entry,
+                                bool (*force_check_filter)(const string& name) = NULL);
   int cls_bucket_head(const RGWBucketInfo& bucket_info, int shard_id, map<string, struct rgw_bucket_dir_header>& headers, map<int, string> *bucket_instance_ids = NULL);
   int cls_bucket_head_async(const RGWBucketInfo& bucket_info, int shard_id, RGWGetDirHeader_CB *ctx, int *num_aio);
   int list_bi_log_entries(RGWBucketInfo& bucket_info, int shard_id, string& marker, uint32_t max, std::list<rgw_bi_log_entry>& result, bool *truncated);
@@ -344,13 +344,156 @@ public:
   }
 };
 
+int RGWBucketReshard::get_bi_log_markers(map<int, string>& markers)
+{
+  int ret = store->get_bi_log_status(bucket_info, -1, markers);
+  if (ret < 0) {
+    ldout(store->ctx(), 0) << __func__ << " ERROR: failed to read bucket index log markers: "
+			   << cpp_strerror(-ret) << dendl;
+  }
+  return ret;
+}
+
+/* copy the current authoritative index entry for a single key from the old
+ * bucket index to its target shard in the new one, adjusting the target
+ * stats by the delta against whatever the bulk copy already put there */
+static int replay_bi_log_key(RGWRados *store,
+			     RGWBucketInfo& bucket_info,
+			     const RGWBucketInfo& new_bucket_info,
+			     const string& object, const string& instance)
+{
+  cls_rgw_obj_key cls_key(object, instance);
+  rgw_obj_key key(cls_key);
+  BIIndexType index_type = (instance.empty() ? PlainIdx : InstanceIdx);
+
+  rgw_obj src_obj(bucket_info.bucket, key);
+  rgw_cls_bi_entry src_entry;
+  int src_ret = store->bi_get(bucket_info.bucket, src_obj, index_type, &src_entry);
+  if (src_ret < 0 && src_ret != -ENOENT) {
+    lderr(store->ctx()) << "ERROR: bi_get() on source index returned ret=" << src_ret << dendl;
+    return src_ret;
+  }
+
+  rgw_obj target_obj(new_bucket_info.bucket, key);
+  int target_shard_id;
+  int ret = store->get_target_shard_id(new_bucket_info, target_obj.get_hash_object(), &target_shard_id);
+  if (ret < 0) {
+    lderr(store->ctx()) << "ERROR: get_target_shard_id() returned ret=" << ret << dendl;
+    return ret;
+  }
+
+  int sid = (new_bucket_info.num_shards > 0 ? (target_shard_id > 0 ? target_shard_id : 0) : -1);
+
+  RGWRados::BucketShard bs(store);
+  ret = bs.init(new_bucket_info.bucket, sid);
+  if (ret < 0) {
+    lderr(store->ctx()) << "ERROR: bs.init() returned ret=" << ret << dendl;
+    return ret;
+  }
+
+  /* what did the bulk copy leave in the target shard for this key? */
+  rgw_cls_bi_entry old_entry;
+  int old_ret = cls_rgw_bi_get(bs.index_ctx, bs.bucket_obj, index_type, cls_key, &old_entry);
+  if (old_ret < 0 && old_ret != -ENOENT) {
+    lderr(store->ctx()) << "ERROR: bi_get() on target index returned ret=" << old_ret << dendl;
+    return old_ret;
+  }
+
+  if (src_ret == -ENOENT && old_ret == -ENOENT) {
+    /* created and removed again while the copy was running */
+    return 0;
+  }
+
+  map<uint8_t, rgw_bucket_category_stats> stats_delta;
+  cls_rgw_obj_key entry_key;
+  uint8_t category;
+  rgw_bucket_category_stats entry_stats;
+
+  if (old_ret == 0 && old_entry.get_info(&entry_key, &category, &entry_stats)) {
+    rgw_bucket_category_stats& delta = stats_delta[category];
+    delta.num_entries -= entry_stats.num_entries;
+    delta.total_size -= entry_stats.total_size;
+    delta.total_size_rounded -= entry_stats.total_size_rounded;
+  }
+
+  librados::ObjectWriteOperation op;
+  if (src_ret == 0) {
+    if (src_entry.get_info(&entry_key, &category, &entry_stats)) {
+      rgw_bucket_category_stats& delta = stats_delta[category];
+      delta.num_entries += entry_stats.num_entries;
+      delta.total_size += entry_stats.total_size;
+      delta.total_size_rounded += entry_stats.total_size_rounded;
+    }
+    store->bi_put(op, bs, src_entry);
+  } else {
+    /* the key was removed from the source after the bulk copy picked it up */
+    set<string> to_remove;
+    to_remove.insert(old_entry.idx);
+    op.omap_rm_keys(to_remove);
+  }
+  if (!stats_delta.empty()) {
+    /* deltas can be negative; the cls method adds them to unsigned counters,
+     * which wraps around to the right result */
+    cls_rgw_bucket_update_stats(op, false, stats_delta);
+  }
+
+  ret = bs.index_ctx.operate(bs.bucket_obj, &op);
+  if (ret < 0) {
+    derr << "ERROR: failed to update target bucket shard (bs=" << bs.bucket << "/" << bs.shard_id << ") error=" << cpp_strerror(-ret) << dendl;
+    return ret;
+  }
+  return 0;
+}
+
+int RGWBucketReshard::replay_bi_log(const RGWBucketInfo& new_bucket_info,
+				    map<int, string>& markers,
+				    int max_entries, uint64_t *num_keys)
+{
+  /* writes are blocked by now, so the source index is quiescent and every
+   * key only needs to be copied once, no matter how often the log names it */
+  set<pair<string, string> > done_keys;
+
+  int num_source_shards = (bucket_info.num_shards > 0 ? bucket_info.num_shards : 1);
+  for (int i = 0; i < num_source_shards; ++i) {
+    int shard_id = (bucket_info.num_shards > 0 ? i : -1);
+    string marker = markers[i];
+    bool truncated = true;
+    while (truncated) {
+      list<rgw_bi_log_entry> log_entries;
+      int ret = store->list_bi_log_entries(bucket_info, shard_id, marker, max_entries, log_entries, &truncated);
+      if (ret < 0) {
+	lderr(store->ctx()) << "ERROR: list_bi_log_entries(): " << cpp_strerror(-ret) << dendl;
+	return ret;
+      }
+      if (log_entries.empty()) {
+	break;
+      }
+      for (auto& log_entry : log_entries) {
+	marker = log_entry.id;
+	if (!done_keys.insert(make_pair(log_entry.object, log_entry.instance)).second) {
+	  continue;
+	}
+	ret = replay_bi_log_key(store, bucket_info, new_bucket_info, log_entry.object, log_entry.instance);
+	if (ret < 0) {
+	  return ret;
+	}
+      }
+    }
+  }
+  if (num_keys) {
+    *num_keys = done_keys.size();
+  }
+  return 0;
+}
+
 int RGWBucketReshard::do_reshard(
 		   int num_shards,
 		   const RGWBucketInfo& new_bucket_info,
 		   int max_entries,
                    bool verbose,
                    ostream *out,
-		   Formatter *formatter)
+		   Formatter *formatter,
+		   map<int, string> *bilog_markers)
 {
   rgw_bucket& bucket = bucket_info.bucket;
 
@@ -470,6 +613,27 @@ int RGWBucketReshard::do_reshard(
     return EIO;
   }
 
+  if (bilog_markers) {
+    /* writes kept flowing to the old index during the copy; block them now
+     * and catch up on whatever the bucket index log accumulated since the
+     * markers were recorded */
+    ret = set_resharding_status(new_bucket_info.bucket.bucket_id, num_shards,
+				CLS_RGW_RESHARD_IN_PROGRESS);
+    if (ret < 0) {
+      return ret;
+    }
+
+    uint64_t num_keys = 0;
+    ret = replay_bi_log(new_bucket_info, *bilog_markers, max_entries, &num_keys);
+    if (ret < 0) {
+      lderr(store->ctx()) << "ERROR: failed to replay bucket index log: " << cpp_strerror(-ret) << dendl;
+      return ret;
+    }
+    if (out) {
+      (*out) << "replayed keys modified during reshard: " << num_keys << std::endl;
+    }
+  }
+
   RGWBucketAdminOpState bucket_op;
 
   bucket_op.set_bucket_name(new_bucket_info.bucket.name);
@@ -538,16 +702,31 @@ int RGWBucketReshard::execute(int num_shards, int max_op_entries,
     }
   }
 
-  ret = set_resharding_status(new_bucket_info.bucket.bucket_id, num_shards, CLS_RGW_RESHARD_IN_PROGRESS);
-  if (ret < 0) {
-    unlock_bucket();
-    return ret;
+  /* if the bucket index log captures every index update we can leave writes
+   * flowing to the old index while the bulk of the entries is copied, and
+   * only block them for the (short) log replay at the end; versioned buckets
+   * still take the blocking path, as olh state is not replayed here */
+  map<int, string> bilog_markers;
+  bool online = store->get_zone().log_data && !bucket_info.versioned();
+  if (online) {
+    ret = get_bi_log_markers(bilog_markers);
+    if (ret < 0) {
+      unlock_bucket();
+      return ret;
+    }
+  } else {
+    ret = set_resharding_status(new_bucket_info.bucket.bucket_id, num_shards, CLS_RGW_RESHARD_IN_PROGRESS);
+    if (ret < 0) {
+      unlock_bucket();
+      return ret;
+    }
   }
 
   ret = do_reshard(num_shards,
 		   new_bucket_info,
 		   max_op_entries,
-                   verbose, out, formatter);
+                   verbose, out, formatter,
+		   (online ? &bilog_markers : nullptr));
 
   if (ret < 0) {
     unlock_bucket();
@@ -30,12 +30,17 @@ class RGWBucketReshard {
   int clear_resharding();
 
   int create_new_bucket_instance(int new_num_shards, RGWBucketInfo& new_bucket_info);
+  int get_bi_log_markers(std::map<int, string>& markers);
+  int replay_bi_log(const RGWBucketInfo& new_bucket_info,
+		    std::map<int, string>& markers,
+		    int max_entries, uint64_t *num_keys);
   int do_reshard(int num_shards,
 		 const RGWBucketInfo& new_bucket_info,
 		 int max_entries,
                  bool verbose,
                  ostream *os,
-		 Formatter *formatter);
+		 Formatter *formatter,
+		 std::map<int, string> *bilog_markers);
 public:
   RGWBucketReshard(RGWRados *_store, const RGWBucketInfo& _bucket_info,
                    const std::map<string, bufferlist>& _bucket_attrs);
@@ -2354,6 +2354,19 @@ TEST(BufferList, append) {
       EXPECT_FALSE(ptr.get_raw());
     }
   }
+  //
+  // contiguous sub-ptrs of the same raw merge into the tail segment
+  //
+  {
+    bufferptr ptr(4);
+    ptr.copy_in(0, 4, "ABCD");
+    bufferlist bl;
+    bl.append(bufferptr(ptr, 0, 2));
+    bl.append(bufferptr(ptr, 2, 2));
+    EXPECT_EQ((unsigned)1, bl.get_num_buffers());
+    EXPECT_EQ((unsigned)4, bl.length());
+    EXPECT_EQ(0, ::memcmp("ABCD", bl.c_str(), 4));
+  }
 }
 
 TEST(BufferList, append_zero) {
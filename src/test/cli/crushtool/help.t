@@ -86,6 +86,7 @@
         [--num-rep n]
         [--pool-id n]      specifies pool id
         [--batches b]      split the CRUSH mapping into b > 1 rounds
+        [--num-threads n]  spread the mapping simulation over n threads
         [--weight|-w devno weight]
                            where weight is 0 to 1.0
         [--simulate]       simulate placements using a random
@@ -98,6 +99,7 @@
      --show-mappings       show mappings
      --show-bad-mappings   show bad mappings
      --show-choose-tries   show choose tries histogram
+     --show-overload       show p99/max device overload vs expectation
      --output-name name
                            prepend the data file(s) generated during the
                            testing routine with name
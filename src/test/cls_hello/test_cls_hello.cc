@@ -133,6 +133,57 @@ TEST(ClsHello, BadMethods) {
   ASSERT_EQ(0, destroy_one_pool_pp(pool_name, cluster));
 }
 
+TEST(ClsHello, BatchedCalls) {
+  Rados cluster;
+  std::string pool_name = get_temp_pool_name();
+  ASSERT_EQ("", create_one_pool_pp(pool_name, cluster));
+  IoCtx ioctx;
+  cluster.ioctx_create(pool_name.c_str(), ioctx);
+
+  // several class calls batched in a single operation dispatch as one
+  // osd op and commit (or abort) as one transaction
+  bufferlist in, out;
+  ObjectWriteOperation wr;
+  wr.exec("hello", "record_hello", in);
+  wr.exec("hello", "writes_dont_return_data", in);
+  ASSERT_EQ(0, ioctx.operate("myobject", &wr));
+
+  ASSERT_EQ(0, ioctx.exec("myobject", "hello", "replay", in, out));
+  ASSERT_EQ(std::string("Hello, world!"), std::string(out.c_str(), out.length()));
+  bufferlist attr;
+  ASSERT_GT(ioctx.getxattr("myobject", "foo", attr), 0);
+  ASSERT_EQ(std::string("bar"), std::string(attr.c_str(), attr.length()));
+
+  // batched reads can return data per call
+  bufferlist out1, out2;
+  int rval1 = 0, rval2 = 0;
+  ObjectReadOperation rd;
+  rd.exec("hello", "say_hello", in, &out1, &rval1);
+  rd.exec("hello", "say_hello", in, &out2, &rval2);
+  bufferlist unused;
+  ASSERT_EQ(0, ioctx.operate("myobject", &rd, &unused));
+  ASSERT_EQ(0, rval1);
+  ASSERT_EQ(0, rval2);
+  ASSERT_EQ(std::string("Hello, world!"), std::string(out1.c_str(), out1.length()));
+  ASSERT_EQ(std::string("Hello, world!"), std::string(out2.c_str(), out2.length()));
+
+  // if any call in the batch fails, the whole transaction is rolled
+  // back: the object the first call created must not exist
+  char buf[4096];
+  memset(buf, 1, sizeof(buf));
+  bufferlist big;
+  big.append(buf, sizeof(buf));
+  ObjectWriteOperation bad;
+  bad.exec("hello", "record_hello", in);
+  bad.exec("hello", "writes_dont_return_data", big);
+  ASSERT_EQ(-EINVAL, ioctx.operate("otherobject", &bad));
+  uint64_t size;
+  time_t mtime;
+  ASSERT_EQ(-ENOENT, ioctx.stat("otherobject", &size, &mtime));
+
+  ASSERT_EQ(0, destroy_one_pool_pp(pool_name, cluster));
+}
+
 TEST(ClsHello, Filter) {
   Rados cluster;
   std::string pool_name = get_temp_pool_name();
@@ -1272,6 +1272,64 @@ TEST_F(TestClsRbd, object_map_update)
   ioctx.close();
 }
 
+TEST_F(TestClsRbd, object_map_update_batch)
+{
+  librados::IoCtx ioctx;
+  ASSERT_EQ(0, _rados.ioctx_create(_pool_name.c_str(), ioctx));
+
+  string oid = get_temp_image_name();
+  BitVector<2> ref_bit_vector;
+  ref_bit_vector.resize(16);
+  for (uint64_t i = 0; i < ref_bit_vector.size(); ++i) {
+    ref_bit_vector[i] = 2;
+  }
+
+  BitVector<2> osd_bit_vector;
+
+  librados::ObjectWriteOperation op1;
+  object_map_resize(&op1, ref_bit_vector.size(), 2);
+  ASSERT_EQ(0, ioctx.operate(oid, &op1));
+  ASSERT_EQ(0, object_map_load(&ioctx, oid, &osd_bit_vector));
+  ASSERT_EQ(ref_bit_vector, osd_bit_vector);
+
+  ref_bit_vector[1] = 1;
+  ref_bit_vector[7] = 1;
+  ref_bit_vector[8] = 1;
+  ref_bit_vector[14] = 1;
+
+  std::map<uint64_t, uint64_t> ranges;
+  ranges[1] = 2;
+  ranges[7] = 9;
+  ranges[14] = 15;
+
+  librados::ObjectWriteOperation op2;
+  object_map_update_batch(&op2, ranges, 1, boost::optional<uint8_t>());
+  ASSERT_EQ(0, ioctx.operate(oid, &op2));
+  ASSERT_EQ(0, object_map_load(&ioctx, oid, &osd_bit_vector));
+  ASSERT_EQ(ref_bit_vector, osd_bit_vector);
+
+  ref_bit_vector[7] = 3;
+  ref_bit_vector[8] = 3;
+
+  ranges.clear();
+  ranges[6] = 10;
+
+  librados::ObjectWriteOperation op3;
+  object_map_update_batch(&op3, ranges, 3, 1);
+  ASSERT_EQ(0, ioctx.operate(oid, &op3));
+  ASSERT_EQ(0, object_map_load(&ioctx, oid, &osd_bit_vector));
+  ASSERT_EQ(ref_bit_vector, osd_bit_vector);
+
+  ranges.clear();
+  ranges[15] = 17;
+
+  librados::ObjectWriteOperation op4;
+  object_map_update_batch(&op4, ranges, 1, boost::optional<uint8_t>());
+  ASSERT_EQ(-ERANGE, ioctx.operate(oid, &op4));
+
+  ioctx.close();
+}
+
 TEST_F(TestClsRbd, object_map_load_enoent)
 {
   librados::IoCtx ioctx;
@@ -3,6 +3,7 @@
 
 #include "include/types.h"
 #include "cls/rgw/cls_rgw_client.h"
+#include "cls/rgw/cls_rgw_const.h"
 #include "cls/rgw/cls_rgw_ops.h"
 
 #include "gtest/gtest.h"
@@ -140,6 +141,78 @@ TEST(cls_rgw, index_basic)
   test_stats(ioctx, bucket_oid, 0, NUM_OBJS, obj_size * NUM_OBJS);
 }
 
+TEST(cls_rgw, index_batch)
+{
+  string bucket_oid = str_int("bucket", 10);
+
+  OpMgr mgr;
+
+  ObjectWriteOperation *op = mgr.write_op();
+  cls_rgw_bucket_init(*op);
+  ASSERT_EQ(0, ioctx.operate(bucket_oid, op));
+
+  uint64_t obj_size = 1024;
+
+  /* prepare all objects in a single batched call */
+  list<rgw_cls_obj_prepare_op> prepare_entries;
+  for (int i = 0; i < NUM_OBJS; i++) {
+    rgw_cls_obj_prepare_op prepare;
+    prepare.op = CLS_RGW_OP_ADD;
+    prepare.key = cls_rgw_obj_key(str_int("obj", i), string());
+    prepare.tag = str_int("tag", i);
+    prepare.locator = str_int("loc", i);
+    prepare.log_op = true;
+    prepare_entries.push_back(prepare);
+  }
+  op = mgr.write_op();
+  cls_rgw_bucket_batch_prepare_op(*op, prepare_entries);
+  ASSERT_EQ(0, ioctx.operate(bucket_oid, op));
+
+  /* pending operations don't show up in the stats yet */
+  test_stats(ioctx, bucket_oid, 0, 0, 0);
+
+  /* complete them in a single batched call */
+  list<rgw_cls_obj_complete_op> complete_entries;
+  for (int i = 0; i < NUM_OBJS; i++) {
+    rgw_cls_obj_complete_op complete;
+    complete.op = CLS_RGW_OP_ADD;
+    complete.key = cls_rgw_obj_key(str_int("obj", i), string());
+    complete.tag = str_int("tag", i);
+    complete.ver.pool = ioctx.get_id();
+    complete.ver.epoch = i + 1;
+    complete.meta.category = 0;
+    complete.meta.size = obj_size;
+    complete.meta.accounted_size = obj_size;
+    complete.log_op = true;
+    complete_entries.push_back(complete);
+  }
+  op = mgr.write_op();
+  cls_rgw_bucket_batch_complete_op(*op, complete_entries);
+  ASSERT_EQ(0, ioctx.operate(bucket_oid, op));
+
+  test_stats(ioctx, bucket_oid, 0, NUM_OBJS, obj_size * NUM_OBJS);
+
+  /* every batched entry logs its own bilog record: NUM_OBJS from the
+   * prepare batch plus NUM_OBJS from the complete batch */
+  {
+    cls_rgw_bi_log_list_op call;
+    call.max = 2 * NUM_OBJS + 1;
+    bufferlist in, out;
+    ::encode(call, in);
+    ASSERT_EQ(0, ioctx.exec(bucket_oid, RGW_CLASS, RGW_BI_LOG_LIST, in, out));
+    cls_rgw_bi_log_list_ret bilog;
+    bufferlist::iterator biter = out.begin();
+    ::decode(bilog, biter);
+    ASSERT_EQ(2 * NUM_OBJS, (int)bilog.entries.size());
+  }
+
+  /* an empty batch is rejected */
+  list<rgw_cls_obj_prepare_op> empty_entries;
+  op = mgr.write_op();
+  cls_rgw_bucket_batch_prepare_op(*op, empty_entries);
+  ASSERT_EQ(-EINVAL, ioctx.operate(bucket_oid, op));
+}
+
 TEST(cls_rgw, index_multiple_obj_writers)
 {
   string bucket_oid = str_int("bucket", 1);
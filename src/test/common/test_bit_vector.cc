@@ -201,6 +201,68 @@ TYPED_TEST(BitVectorTest, partial_decode_encode) {
   }
 }
 
+TYPED_TEST(BitVectorTest, partial_footer_encode) {
+  typename TestFixture::bit_vector_t bit_vector;
+
+  uint64_t elements_per_byte = 8 / bit_vector.BIT_COUNT;
+  bit_vector.resize(9161 * elements_per_byte);
+  for (uint64_t i = 0; i < bit_vector.size(); ++i) {
+    bit_vector[i] = i % 4;
+  }
+
+  bufferlist bl;
+  ::encode(bit_vector, bl);
+
+  // update elements within a single data block and splice the updated
+  // data and CRCs into the full encoding
+  uint64_t element_offset = bit_vector.BLOCK_SIZE * elements_per_byte;
+  uint64_t element_length = 2;
+  for (uint64_t i = 0; i < element_length; ++i) {
+    bit_vector[element_offset + i] = (bit_vector[element_offset + i] + 1) % 4;
+  }
+
+  uint64_t byte_offset;
+  uint64_t byte_length;
+  bit_vector.get_data_extents(element_offset, element_length, &byte_offset,
+			      &byte_length);
+
+  bufferlist data_bl;
+  bit_vector.encode_data(data_bl, byte_offset, byte_length);
+
+  uint64_t crc_byte_offset;
+  uint64_t crc_byte_length;
+  bit_vector.get_data_crcs_extents(element_offset, element_length,
+				   &crc_byte_offset, &crc_byte_length);
+
+  bufferlist crc_bl;
+  bit_vector.encode_data_crcs(crc_bl, element_offset, element_length);
+  ASSERT_EQ(crc_byte_length, crc_bl.length());
+
+  bufferlist updated_bl;
+  updated_bl.substr_of(bl, 0, bit_vector.get_header_length() + byte_offset);
+  updated_bl.append(data_bl);
+
+  uint64_t tail_data_offset = bit_vector.get_header_length() + byte_offset +
+			      byte_length;
+  bufferlist tail_bl;
+  tail_bl.substr_of(bl, tail_data_offset,
+		    bit_vector.get_footer_offset() + crc_byte_offset -
+		      tail_data_offset);
+  updated_bl.append(tail_bl);
+  updated_bl.append(crc_bl);
+
+  uint64_t tail_footer_offset = bit_vector.get_footer_offset() +
+				crc_byte_offset + crc_byte_length;
+  tail_bl.clear();
+  tail_bl.substr_of(bl, tail_footer_offset, bl.length() - tail_footer_offset);
+  updated_bl.append(tail_bl);
+
+  typename TestFixture::bit_vector_t updated_bit_vector;
+  bufferlist::iterator updated_it = updated_bl.begin();
+  ::decode(updated_bit_vector, updated_it);
+  ASSERT_EQ(bit_vector, updated_bit_vector);
+}
+
 TYPED_TEST(BitVectorTest, header_crc) {
   typename TestFixture::bit_vector_t bit_vector;
 
@@ -0,0 +1,138 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "gtest/gtest.h"
+#include "common/FifoPriorityQueue.h"
+#include "common/PrioritizedQueue.h"
+#include "common/WeightedPriorityQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using std::vector;
+
+class FifoPriorityQueueTest : public testing::Test
+{
+protected:
+  typedef int Klass;
+  typedef unsigned Item;
+  typedef FifoPriorityQueue<Item, Klass> FQ;
+};
+
+TEST_F(FifoPriorityQueueTest, capacity) {
+  FQ fq(0, 0);
+  EXPECT_TRUE(fq.empty());
+  EXPECT_EQ(0u, fq.length());
+
+  fq.enqueue_strict(Klass(1), 0, Item(0));
+  EXPECT_FALSE(fq.empty());
+  EXPECT_EQ(1u, fq.length());
+
+  for (int i = 0; i < 3; i++) {
+    fq.enqueue(Klass(1), 0, 10, Item(0));
+  }
+  for (unsigned i = 4; i > 0; i--) {
+    EXPECT_FALSE(fq.empty());
+    EXPECT_EQ(i, fq.length());
+    fq.dequeue();
+  }
+  EXPECT_TRUE(fq.empty());
+  EXPECT_EQ(0u, fq.length());
+}
+
+TEST_F(FifoPriorityQueueTest, strict_before_normal) {
+  FQ fq(0, 0);
+  fq.enqueue(Klass(1), 200, 1, Item(1));
+  fq.enqueue_strict(Klass(1), 10, Item(2));
+  EXPECT_EQ(2u, fq.dequeue());
+  EXPECT_EQ(1u, fq.dequeue());
+  EXPECT_TRUE(fq.empty());
+}
+
+TEST_F(FifoPriorityQueueTest, priority_and_fifo_order) {
+  FQ fq(0, 0);
+  fq.enqueue(Klass(1), 10, 1, Item(1));
+  fq.enqueue(Klass(1), 10, 1, Item(2));
+  fq.enqueue(Klass(2), 63, 1, Item(3));
+  fq.enqueue(Klass(2), 64, 1, Item(4));   // across a bitmap word boundary
+  fq.enqueue(Klass(1), 10, 1, Item(5));
+  // highest priority first, FIFO within a priority
+  EXPECT_EQ(4u, fq.dequeue());
+  EXPECT_EQ(3u, fq.dequeue());
+  EXPECT_EQ(1u, fq.dequeue());
+  EXPECT_EQ(2u, fq.dequeue());
+  EXPECT_EQ(5u, fq.dequeue());
+  EXPECT_TRUE(fq.empty());
+}
+
+TEST_F(FifoPriorityQueueTest, enqueue_front) {
+  FQ fq(0, 0);
+  fq.enqueue(Klass(1), 10, 1, Item(1));
+  fq.enqueue_front(Klass(1), 10, 1, Item(2));
+  EXPECT_EQ(2u, fq.dequeue());
+  EXPECT_EQ(1u, fq.dequeue());
+}
+
+TEST_F(FifoPriorityQueueTest, clamped_priority) {
+  FQ fq(0, 0);
+  fq.enqueue(Klass(1), 1000000, 1, Item(1));
+  fq.enqueue(Klass(1), 255, 1, Item(2));
+  EXPECT_EQ(1u, fq.dequeue());
+  EXPECT_EQ(2u, fq.dequeue());
+}
+
+TEST_F(FifoPriorityQueueTest, remove_by_class) {
+  FQ fq(0, 0);
+  fq.enqueue(Klass(1), 10, 1, Item(1));
+  fq.enqueue(Klass(2), 10, 1, Item(2));
+  fq.enqueue(Klass(1), 20, 1, Item(3));
+  fq.enqueue_strict(Klass(1), 5, Item(4));
+  std::list<Item> removed;
+  fq.remove_by_class(Klass(1), &removed);
+  EXPECT_EQ(3u, removed.size());
+  EXPECT_EQ(1u, fq.length());
+  EXPECT_EQ(2u, fq.dequeue());
+  EXPECT_TRUE(fq.empty());
+}
+
+// Rough single-threaded enqueue/dequeue rate comparison against wpq
+// and prio under a synthetic mix; numbers go to stdout for eyeballing,
+// there is deliberately no pass/fail threshold.
+template <typename Q>
+static void queue_churn(Q &q, const char *name, unsigned count)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < count; ++i) {
+    unsigned prio = (i % 5) * 63;
+    if (i % 7 == 0)
+      q.enqueue_strict(int(i % 13), prio, i);
+    else
+      q.enqueue(int(i % 13), prio, 1 << (i % 20), i);
+    if (i % 3 == 0)
+      q.dequeue();
+  }
+  while (!q.empty())
+    q.dequeue();
+  auto end = std::chrono::steady_clock::now();
+  std::cout << name << ": " << count << " ops in "
+	    << std::chrono::duration_cast<std::chrono::microseconds>(
+	      end - start).count() << "us" << std::endl;
+}
+
+TEST_F(FifoPriorityQueueTest, benchmark) {
+  const unsigned count = 1000000;
+  {
+    FifoPriorityQueue<Item, Klass> q(4194304, 65536);
+    queue_churn(q, "fifo", count);
+  }
+  {
+    WeightedPriorityQueue<Item, Klass> q(4194304, 65536);
+    queue_churn(q, "wpq ", count);
+  }
+  {
+    PrioritizedQueue<Item, Klass> q(4194304, 65536);
+    queue_churn(q, "prio", count);
+  }
+}
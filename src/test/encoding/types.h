@@ -72,6 +72,7 @@ TYPE(pg_history_t)
 TYPE(pg_info_t)
 TYPE_FEATUREFUL(pg_query_t)
 TYPE(pg_log_entry_t)
+TYPE(pg_log_dup_t)
 TYPE(pg_log_t)
 TYPE(pg_missing_item)
 TYPE(pg_missing_t)
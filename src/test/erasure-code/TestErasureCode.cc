@@ -85,6 +85,61 @@ public:
  *  It is possible for a flawed implementation to pas the test because the
  *  underlying allocation function enforces it.
  */
+TEST(ErasureCodeTest, minimum_to_decode_with_cost)
+{
+  ErasureCodeTest erasure_code(3, 1, 64);
+
+  set<int> want_to_read;
+  want_to_read.insert(0);
+
+  //
+  // flat costs plan exactly like minimum_to_decode
+  //
+  {
+    map<int, int> available;
+    for (int i = 0; i < 4; i++)
+      available[i] = 1;
+    set<int> minimum;
+    EXPECT_EQ(0, erasure_code.minimum_to_decode_with_cost(
+		want_to_read, available, &minimum));
+    EXPECT_EQ(1u, minimum.size());
+    EXPECT_EQ(1u, minimum.count(0));
+  }
+
+  //
+  // an expensive chunk that is not needed to decode is avoided
+  //
+  {
+    ErasureCodeTest ec_2_2(2, 2, 64);
+    map<int, int> available;
+    available[1] = 1;
+    available[2] = 1;
+    available[3] = 10;
+    set<int> minimum;
+    EXPECT_EQ(0, ec_2_2.minimum_to_decode_with_cost(
+		want_to_read, available, &minimum));
+    EXPECT_EQ(2u, minimum.size());
+    EXPECT_EQ(1u, minimum.count(1));
+    EXPECT_EQ(1u, minimum.count(2));
+    EXPECT_EQ(0u, minimum.count(3));
+  }
+
+  //
+  // a chunk in want_to_read is read even if it is the most expensive
+  //
+  {
+    map<int, int> available;
+    for (int i = 0; i < 4; i++)
+      available[i] = 1;
+    available[0] = 10;
+    set<int> minimum;
+    EXPECT_EQ(0, erasure_code.minimum_to_decode_with_cost(
+		want_to_read, available, &minimum));
+    EXPECT_EQ(1u, minimum.size());
+    EXPECT_EQ(1u, minimum.count(0));
+  }
+}
+
 TEST(ErasureCodeTest, encode_memory_align)
 {
   int k = 3;
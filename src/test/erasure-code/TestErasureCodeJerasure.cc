@@ -277,6 +277,69 @@ TEST(ErasureCodeTest, encode)
   }
 }
 
+TEST(ErasureCodeTest, encode_delta)
+{
+  const char *ws[] = { "8", "16", "32" };
+  for (unsigned int i = 0; i < sizeof(ws) / sizeof(ws[0]); i++) {
+    ErasureCodeJerasureReedSolomonVandermonde jerasure;
+    ErasureCodeProfile profile;
+    profile["k"] = "4";
+    profile["m"] = "2";
+    profile["w"] = ws[i];
+    jerasure.init(profile, &cerr);
+
+    unsigned aligned_object_size = jerasure.get_alignment() * 2;
+    bufferlist in;
+    in.append(string(aligned_object_size, 'X'));
+    set<int> want_to_encode;
+    for (unsigned int j = 0; j < jerasure.get_chunk_count(); j++)
+      want_to_encode.insert(j);
+    map<int,bufferlist> encoded;
+    EXPECT_EQ(0, jerasure.encode(want_to_encode, in, &encoded));
+
+    //
+    // overwrite one data chunk, apply the deltas to the coding chunks
+    // and verify the result matches a full re-encode of the modified
+    // stripe
+    //
+    int modified_chunk = 2;
+    bufferlist new_chunk;
+    new_chunk.append(string(encoded[modified_chunk].length(), 'Y'));
+    map<int,bufferlist> parity_delta;
+    EXPECT_EQ(0, jerasure.encode_delta(modified_chunk,
+				       encoded[modified_chunk],
+				       new_chunk,
+				       &parity_delta));
+    EXPECT_EQ(jerasure.get_chunk_count() -
+	      jerasure.get_data_chunk_count(), parity_delta.size());
+
+    map<int,bufferlist> patched = encoded;
+    patched[modified_chunk] = new_chunk;
+    for (map<int,bufferlist>::iterator d = parity_delta.begin();
+	 d != parity_delta.end();
+	 ++d) {
+      ASSERT_EQ(patched[d->first].length(), d->second.length());
+      char *parity = patched[d->first].c_str();
+      const char *delta = d->second.c_str();
+      for (unsigned int b = 0; b < d->second.length(); b++)
+	parity[b] ^= delta[b];
+    }
+
+    bufferlist modified_in;
+    for (unsigned int j = 0; j < jerasure.get_data_chunk_count(); j++)
+      modified_in.append(patched[j]);
+    map<int,bufferlist> reencoded;
+    EXPECT_EQ(0, jerasure.encode(want_to_encode, modified_in, &reencoded));
+    for (unsigned int j = jerasure.get_data_chunk_count();
+	 j < jerasure.get_chunk_count();
+	 j++) {
+      ASSERT_EQ(reencoded[j].length(), patched[j].length());
+      EXPECT_EQ(0, memcmp(reencoded[j].c_str(), patched[j].c_str(),
+			  patched[j].length()));
+    }
+  }
+}
+
 TEST(ErasureCodeTest, create_rule)
 {
   CrushWrapper *c = new CrushWrapper;
@@ -428,6 +428,50 @@ TYPED_TEST(TestJournalPlayer, PrefetchLargeMissingSequence) {
   ASSERT_EQ(expected_entries, entries);
 }
 
+TYPED_TEST(TestJournalPlayer, FetchAheadObjectSets) {
+  std::string oid = this->get_temp_oid();
+
+  cls::journal::ObjectSetPosition commit_position;
+
+  ASSERT_EQ(0, this->create(oid));
+  ASSERT_EQ(0, this->client_register(oid));
+  ASSERT_EQ(0, this->client_commit(oid, commit_position));
+
+  journal::JournalMetadataPtr metadata = this->create_metadata(oid);
+  ASSERT_EQ(0, this->init_metadata(metadata));
+
+  journal::JournalPlayer *player = this->create_player(oid, metadata);
+  BOOST_SCOPE_EXIT_ALL( (player) ) {
+    C_SaferCond unwatch_ctx;
+    player->shut_down(&unwatch_ctx);
+    ASSERT_EQ(0, unwatch_ctx.wait());
+  };
+
+  // span several closed object sets so that playback promotes the
+  // read-ahead object players at each object boundary
+  ASSERT_EQ(0, metadata->set_active_set(2));
+  for (uint64_t entry_tid = 0; entry_tid < 12; ++entry_tid) {
+    uint64_t object_num = ((entry_tid / 4) * 2) + (entry_tid % 2);
+    ASSERT_EQ(0, this->write_entry(oid, object_num, 234, entry_tid));
+  }
+
+  player->prefetch();
+
+  Entries entries;
+  ASSERT_TRUE(this->wait_for_entries(player, 12, &entries));
+  ASSERT_TRUE(this->wait_for_complete(player));
+
+  Entries expected_entries;
+  for (uint64_t entry_tid = 0; entry_tid < 12; ++entry_tid) {
+    expected_entries.push_back(this->create_entry(234, entry_tid));
+  }
+  ASSERT_EQ(expected_entries, entries);
+
+  uint64_t last_tid;
+  ASSERT_TRUE(metadata->get_last_allocated_entry_tid(234, &last_tid));
+  ASSERT_EQ(11U, last_tid);
+}
+
 TYPED_TEST(TestJournalPlayer, PrefetchBlockedNewTag) {
   std::string oid = this->get_temp_oid();
 
@@ -227,6 +227,39 @@ TEST_F(TestObjectRecorder, AppendFlushByAge) {
   ASSERT_EQ(0U, object->get_pending_appends());
 }
 
+TEST_F(TestObjectRecorder, AppendBatchedByAge) {
+  std::string oid = get_temp_oid();
+  ASSERT_EQ(0, create(oid));
+  ASSERT_EQ(0, client_register(oid));
+  journal::JournalMetadataPtr metadata = create_metadata(oid);
+  ASSERT_EQ(0, init_metadata(metadata));
+
+  // a flush age on its own is sufficient to batch appends
+  set_flush_interval(0);
+  set_flush_bytes(0);
+  set_flush_age(0.1);
+  shared_ptr<Mutex> lock(new Mutex("object_recorder_lock"));
+  journal::ObjectRecorderPtr object = create_object(oid, 24, lock);
+
+  journal::AppendBuffer append_buffer1 = create_append_buffer(234, 123,
+                                                              "payload");
+  journal::AppendBuffers append_buffers;
+  append_buffers = {append_buffer1};
+  lock->Lock();
+  ASSERT_FALSE(object->append_unlock(std::move(append_buffers)));
+
+  journal::AppendBuffer append_buffer2 = create_append_buffer(234, 124,
+                                                              "payload");
+  append_buffers = {append_buffer2};
+  lock->Lock();
+  ASSERT_FALSE(object->append_unlock(std::move(append_buffers)));
+
+  C_SaferCond cond;
+  append_buffer2.first->wait(&cond);
+  ASSERT_EQ(0, cond.wait());
+  ASSERT_EQ(0U, object->get_pending_appends());
+}
+
 TEST_F(TestObjectRecorder, AppendFilledObject) {
   std::string oid = get_temp_oid();
   ASSERT_EQ(0, create(oid));
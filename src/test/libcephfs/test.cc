@@ -1435,6 +1435,55 @@ TEST(LibCephFS, Nlink) {
   ceph_shutdown(cmount);
 }
 
+TEST(LibCephFS, LookupBatch) {
+  struct ceph_mount_info *cmount;
+  ASSERT_EQ(ceph_create(&cmount, NULL), 0);
+  ASSERT_EQ(ceph_conf_read_file(cmount, NULL), 0);
+  ASSERT_EQ(0, ceph_conf_parse_env(cmount, NULL));
+  ASSERT_EQ(ceph_mount(cmount, "/"), 0);
+
+  Inode *root, *dir;
+
+  ASSERT_EQ(ceph_ll_lookup_root(cmount, &root), 0);
+
+  char dirname[32];
+  sprintf(dirname, "lookupbatch%x", getpid());
+
+  struct ceph_statx stx;
+  UserPerm *perms = ceph_mount_perms(cmount);
+
+  ASSERT_EQ(ceph_ll_mkdir(cmount, root, dirname, 0755, &dir, &stx, 0, 0, perms), 0);
+
+  char filenames[4][32];
+  for (int i = 0; i < 4; i++) {
+    Inode *file;
+    Fh *fh;
+    sprintf(filenames[i], "file%d", i);
+    ASSERT_EQ(ceph_ll_create(cmount, dir, filenames[i], 0666,
+			     O_RDWR|O_CREAT|O_EXCL, &file, &fh, &stx,
+			     CEPH_STATX_INO, 0, perms), 0);
+    ASSERT_EQ(ceph_ll_close(cmount, fh), 0);
+    ceph_ll_put(cmount, file);
+  }
+
+  const char *names[5] = { filenames[0], filenames[1], filenames[2],
+			   filenames[3], "no-such-file" };
+  Inode *out[5];
+  struct ceph_statx stxs[5];
+
+  ASSERT_EQ(ceph_ll_lookup_batch(cmount, dir, names, 5, out, stxs,
+				 CEPH_STATX_INO, 0, perms), 4);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(out[i] != NULL);
+    ASSERT_NE(stxs[i].stx_ino, 0u);
+    ceph_ll_put(cmount, out[i]);
+  }
+  ASSERT_TRUE(out[4] == NULL);
+  ASSERT_EQ(stxs[4].stx_ino, 0u);
+
+  ceph_shutdown(cmount);
+}
+
 TEST(LibCephFS, SlashDotDot) {
   struct ceph_mount_info *cmount;
   ASSERT_EQ(ceph_create(&cmount, NULL), 0);
@@ -1582,6 +1582,82 @@ TEST(LibRadosAio, RoundTripWriteFullPP) {
   delete my_completion3;
 }
 
+TEST(LibRadosAio, PollMode) {
+  AioTestData test_data;
+  ASSERT_EQ("", test_data.init());
+  // polling an io context not in poll mode fails
+  ASSERT_EQ(-EINVAL, rados_aio_poll(test_data.m_ioctx, 0, 0));
+  rados_ioctx_set_pollmode(test_data.m_ioctx, 1);
+  rados_completion_t my_completion;
+  ASSERT_EQ(0, rados_aio_create_completion((void*)&test_data,
+	      set_completion_complete, set_completion_safe, &my_completion));
+  char buf[128];
+  memset(buf, 0xcc, sizeof(buf));
+  ASSERT_EQ(0, rados_aio_write(test_data.m_ioctx, "foo",
+			       my_completion, buf, sizeof(buf), 0));
+  {
+    TestAlarm alarm;
+    ASSERT_EQ(0, rados_aio_wait_for_safe(my_completion));
+  }
+  // the callbacks did not fire yet; reap them inline
+  ASSERT_FALSE(test_data.m_complete);
+  int r = 0;
+  {
+    TestAlarm alarm;
+    while (r == 0)
+      r = rados_aio_poll(test_data.m_ioctx, 0, 1000);
+  }
+  ASSERT_EQ(1, r);
+  ASSERT_TRUE(test_data.m_complete);
+  ASSERT_TRUE(test_data.m_safe);
+  {
+    TestAlarm alarm;
+    sem_wait(test_data.m_sem);
+    sem_wait(test_data.m_sem);
+  }
+  ASSERT_EQ(0, rados_aio_get_return_value(my_completion));
+  rados_aio_release(my_completion);
+}
+
+TEST(LibRadosAio, OperateBatchPP) {
+  AioTestDataPP test_data;
+  ASSERT_EQ("", test_data.init());
+  char buf[128];
+  memset(buf, 0xcc, sizeof(buf));
+  bufferlist bl1;
+  bl1.append(buf, sizeof(buf));
+  std::vector<std::string> oids;
+  std::vector<ObjectWriteOperation*> ops;
+  std::vector<AioCompletion*> comps;
+  ObjectWriteOperation op[3];
+  for (int i = 0; i < 3; ++i) {
+    oids.push_back("foo" + stringify(i));
+    op[i].write(0, bl1);
+    ops.push_back(&op[i]);
+    comps.push_back(test_data.m_cluster.aio_create_completion(
+	  (void*)&test_data, set_completion_complete, set_completion_safe));
+  }
+  ASSERT_EQ(0, test_data.m_ioctx.aio_operate_batch(oids, ops, comps));
+  for (int i = 0; i < 3; ++i) {
+    {
+      TestAlarm alarm;
+      ASSERT_EQ(0, comps[i]->wait_for_complete());
+    }
+    ASSERT_EQ(0, comps[i]->get_return_value());
+    delete comps[i];
+  }
+  for (int i = 0; i < 3; ++i) {
+    bufferlist bl2;
+    ASSERT_EQ((int)sizeof(buf),
+	      test_data.m_ioctx.read("foo" + stringify(i), bl2,
+				     sizeof(buf), 0));
+    ASSERT_EQ(0, memcmp(bl2.c_str(), buf, sizeof(buf)));
+  }
+  // mismatched vector sizes are rejected
+  comps.clear();
+  ASSERT_EQ(-EINVAL, test_data.m_ioctx.aio_operate_batch(oids, ops, comps));
+}
+
 //using ObjectWriteOperation/ObjectReadOperation with iohint
 TEST(LibRadosAio, RoundTripWriteFullPP2)
 {
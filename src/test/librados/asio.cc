@@ -0,0 +1,131 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * Copyright (C) 2017 Red Hat, Inc.
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation. See file COPYING.
+ */
+
+#include "librados/librados_asio.h"
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <mutex>
+
+#include <boost/asio/use_future.hpp>
+
+#include "test/librados/test.h"
+
+using namespace librados;
+
+// fixture with a connected cluster, a test pool, and an object "exist"
+// initialized with the payload "hello"
+class AsioRados : public ::testing::Test {
+ protected:
+  static Rados rados;
+  static IoCtx io;
+  static std::string pool_name;
+
+  static void SetUpTestCase() {
+    pool_name = get_temp_pool_name();
+    ASSERT_EQ("", create_one_pool_pp(pool_name, rados));
+    ASSERT_EQ(0, rados.ioctx_create(pool_name.c_str(), io));
+
+    bufferlist bl;
+    bl.append("hello");
+    ASSERT_EQ(0, io.write_full("exist", bl));
+  }
+
+  static void TearDownTestCase() {
+    io.close();
+    ASSERT_EQ(0, destroy_one_pool_pp(pool_name, rados));
+  }
+};
+Rados AsioRados::rados;
+IoCtx AsioRados::io;
+std::string AsioRados::pool_name;
+
+TEST_F(AsioRados, AsyncReadCallback)
+{
+  std::mutex mutex;
+  std::condition_variable cond;
+  int done = 0;
+
+  auto success_cb = [&] (boost::system::error_code ec, bufferlist bl) {
+    EXPECT_FALSE(ec);
+    EXPECT_EQ("hello", std::string(bl.c_str(), bl.length()));
+    std::lock_guard<std::mutex> lock(mutex);
+    ++done;
+    cond.notify_one();
+  };
+  async_read(io, "exist", 256, 0, success_cb);
+
+  auto failure_cb = [&] (boost::system::error_code ec, bufferlist bl) {
+    EXPECT_EQ(boost::system::errc::no_such_file_or_directory, ec);
+    EXPECT_EQ(0u, bl.length());
+    std::lock_guard<std::mutex> lock(mutex);
+    ++done;
+    cond.notify_one();
+  };
+  async_read(io, "noexist", 256, 0, failure_cb);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  cond.wait(lock, [&] { return done == 2; });
+}
+
+TEST_F(AsioRados, AsyncReadFuture)
+{
+  auto f1 = async_read(io, "exist", 256, 0, boost::asio::use_future);
+  auto f2 = async_read(io, "noexist", 256, 0, boost::asio::use_future);
+
+  bufferlist bl;
+  EXPECT_NO_THROW({
+    bl = f1.get();
+    EXPECT_EQ("hello", std::string(bl.c_str(), bl.length()));
+  });
+  EXPECT_THROW(f2.get(), boost::system::system_error);
+}
+
+TEST_F(AsioRados, AsyncWriteFuture)
+{
+  bufferlist bl;
+  bl.append("hello");
+
+  auto f = async_write(io, "written", bl, bl.length(), 0,
+		       boost::asio::use_future);
+  EXPECT_NO_THROW(f.get());
+
+  auto f2 = async_read(io, "written", 256, 0, boost::asio::use_future);
+  EXPECT_NO_THROW({
+    bufferlist out = f2.get();
+    EXPECT_EQ("hello", std::string(out.c_str(), out.length()));
+  });
+}
+
+TEST_F(AsioRados, AsyncReadOperationFuture)
+{
+  ObjectReadOperation op;
+  op.read(0, 256, nullptr, nullptr);
+  auto f = async_operate(io, "exist", &op, 0, boost::asio::use_future);
+
+  EXPECT_NO_THROW({
+    bufferlist bl = f.get();
+    EXPECT_EQ("hello", std::string(bl.c_str(), bl.length()));
+  });
+}
+
+TEST_F(AsioRados, AsyncWriteOperationFuture)
+{
+  bufferlist bl;
+  bl.append("hello");
+
+  ObjectWriteOperation op;
+  op.write_full(bl);
+  auto f = async_operate(io, "written2", &op, 0, boost::asio::use_future);
+  EXPECT_NO_THROW(f.get());
+}
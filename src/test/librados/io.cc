@@ -29,6 +29,16 @@ TEST_F(LibRadosIo, SimpleWrite) {
   ASSERT_EQ(0, rados_write(ioctx, "foo", buf, sizeof(buf), 0));
 }
 
+TEST_F(LibRadosIo, ZerocopyWrite) {
+  char buf[128];
+  char buf2[sizeof(buf)];
+  memset(buf, 0xcc, sizeof(buf));
+  ASSERT_EQ(0, rados_write_zerocopy(ioctx, "foo", buf, sizeof(buf), 0));
+  memset(buf2, 0, sizeof(buf2));
+  ASSERT_EQ((int)sizeof(buf2), rados_read(ioctx, "foo", buf2, sizeof(buf2), 0));
+  ASSERT_EQ(0, memcmp(buf, buf2, sizeof(buf)));
+}
+
 TEST_F(LibRadosIo, TooBig) {
   char buf[1];
   ASSERT_EQ(-E2BIG, rados_write(ioctx, "A", buf, UINT_MAX, 0));
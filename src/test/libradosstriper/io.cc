@@ -27,6 +27,36 @@ TEST_F(StriperTestPP, SimpleWritePP) {
   ASSERT_EQ(0, striper.write("SimpleWritePP", bl, sizeof(buf), 0));
 }
 
+TEST_F(StriperTest, SingleWriterWrite) {
+  ASSERT_EQ(0, rados_striper_set_single_writer(striper, 1));
+  char buf[128];
+  memset(buf, 0xcc, sizeof(buf));
+  // create, append and read back without per-op locking
+  ASSERT_EQ(0, rados_striper_write(striper, "SingleWriterWrite", buf, sizeof(buf), 0));
+  ASSERT_EQ(0, rados_striper_append(striper, "SingleWriterWrite", buf, sizeof(buf)));
+  char buf2[256];
+  ASSERT_EQ((int)sizeof(buf2),
+            rados_striper_read(striper, "SingleWriterWrite", buf2, sizeof(buf2), 0));
+  ASSERT_EQ(0, memcmp(buf, buf2, sizeof(buf)));
+  ASSERT_EQ(0, memcmp(buf, buf2 + sizeof(buf), sizeof(buf)));
+  // reading a non existing object still yields -ENOENT
+  ASSERT_EQ(-ENOENT,
+            rados_striper_read(striper, "SingleWriterNone", buf2, sizeof(buf2), 0));
+}
+
+TEST_F(StriperTestPP, SingleWriterWritePP) {
+  ASSERT_EQ(0, striper.set_single_writer(true));
+  char buf[128];
+  memset(buf, 0xcc, sizeof(buf));
+  bufferlist bl;
+  bl.append(buf, sizeof(buf));
+  ASSERT_EQ(0, striper.write("SingleWriterWritePP", bl, sizeof(buf), 0));
+  bufferlist bl2;
+  ASSERT_EQ((int)sizeof(buf),
+            striper.read("SingleWriterWritePP", &bl2, sizeof(buf), 0));
+  ASSERT_EQ(0, memcmp(bl2.c_str(), buf, sizeof(buf)));
+}
+
 TEST_F(StriperTest, SimpleWriteFull) {
   char buf[128];
   memset(buf, 0xcc, sizeof(buf));
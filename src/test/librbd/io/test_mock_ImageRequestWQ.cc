@@ -37,6 +37,7 @@ struct ImageRequest<librbd::MockTestImageCtx> {
   static void aio_write(librbd::MockTestImageCtx *ictx, AioCompletion *c,
                         Extents &&image_extents, bufferlist &&bl, int op_flags,
                         const ZTracer::Trace &parent_trace) {
+    c->set_request_count(0);
   }
 
 
@@ -275,5 +276,24 @@ TEST_F(TestMockIoImageRequestWQ, RefreshError) {
   aio_comp->release();
 }
 
+TEST_F(TestMockIoImageRequestWQ, InlineWriteDispatch) {
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  MockTestImageCtx mock_image_ctx(*ictx);
+  mock_image_ctx.aio_inline_dispatch = true;
+
+  InSequence seq;
+  MockImageRequestWQ mock_image_request_wq(&mock_image_ctx, "io", 60, nullptr);
+  EXPECT_CALL(mock_image_request_wq, queue(_)).Times(0);
+
+  expect_is_refresh_request(mock_image_ctx, false);
+  auto *aio_comp = new librbd::io::AioCompletion();
+  mock_image_request_wq.aio_write(aio_comp, 0, 0, {}, 0);
+
+  ASSERT_EQ(0, aio_comp->wait_for_complete());
+  aio_comp->release();
+}
+
 } // namespace io
 } // namespace librbd
@@ -12,6 +12,8 @@ namespace librbd {
 
 struct MockObjectMap {
   MOCK_CONST_METHOD1(enabled, bool(const RWLock &object_map_lock));
+  MOCK_CONST_METHOD1(object_may_exist, bool(uint64_t object_no));
+  MOCK_CONST_METHOD1(object_may_not_exist, bool(uint64_t object_no));
 
   MOCK_METHOD1(open, void(Context *on_finish));
   MOCK_METHOD1(close, void(Context *on_finish));
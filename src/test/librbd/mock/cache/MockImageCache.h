@@ -30,6 +30,7 @@ struct MockImageCache {
 
   MOCK_METHOD4(aio_discard, void(uint64_t, uint64_t, bool, Context *));
   MOCK_METHOD1(aio_flush, void(Context *));
+  MOCK_METHOD1(flush, void(Context *));
   MOCK_METHOD5(aio_writesame_mock, void(uint64_t, uint64_t, ceph::bufferlist& bl,
                                         int, Context *));
   void aio_writesame(uint64_t off, uint64_t len, ceph::bufferlist&& bl,
@@ -12,6 +12,7 @@
 #include "librbd/ObjectMap.h"
 #include "librbd/Operations.h"
 #include "librbd/api/DiffIterate.h"
+#include "librbd/cache/ImageCache.h"
 #include "librbd/io/AioCompletion.h"
 #include "librbd/io/ImageRequest.h"
 #include "librbd/io/ImageRequestWQ.h"
@@ -779,6 +780,132 @@ TEST_F(TestInternal, DiscardCopyup)
   }
 }
 
+TEST_F(TestInternal, ThrottledCopyup)
+{
+  REQUIRE_FEATURE(RBD_FEATURE_LAYERING);
+
+  ASSERT_EQ(0, _rados.conf_set("rbd_concurrent_copyups", "1"));
+  BOOST_SCOPE_EXIT(&_rados) {
+    ASSERT_EQ(0, _rados.conf_set("rbd_concurrent_copyups", "0"));
+  } BOOST_SCOPE_EXIT_END;
+
+  m_image_name = get_temp_image_name();
+  m_image_size = 1 << 14;
+
+  uint64_t features = 0;
+  get_features(&features);
+  int order = 12;
+  ASSERT_EQ(0, m_rbd.create2(m_ioctx, m_image_name.c_str(), m_image_size,
+                             features, &order));
+
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  bufferlist bl;
+  bl.append(std::string(4096, '1'));
+  for (size_t i = 0; i < m_image_size; i += bl.length()) {
+    ASSERT_EQ((ssize_t)bl.length(),
+	      ictx->io_work_queue->write(i, bl.length(),
+					 bufferlist{bl}, 0));
+  }
+
+  ASSERT_EQ(0, snap_create(*ictx, "snap1"));
+  ASSERT_EQ(0,
+	    ictx->operations->snap_protect(cls::rbd::UserSnapshotNamespace(),
+					   "snap1"));
+
+  std::string clone_name = get_temp_image_name();
+  ASSERT_EQ(0, librbd::clone(m_ioctx, m_image_name.c_str(), "snap1", m_ioctx,
+			     clone_name.c_str(), features, &order, 0, 0));
+
+  librbd::ImageCtx *ictx2;
+  ASSERT_EQ(0, open_image(clone_name, &ictx2));
+  ASSERT_EQ(1U, ictx2->concurrent_copyups);
+
+  // writes to adjacent objects force concurrent copyups through the
+  // single-slot throttle and the coalesced parent read
+  bufferlist write_bl;
+  write_bl.append(std::string(2048, '2'));
+
+  std::list<librbd::io::AioCompletion *> comps;
+  for (size_t i = 0; i < m_image_size; i += (1 << order)) {
+    auto c = librbd::io::AioCompletion::create(new DummyContext());
+    c->get();
+    comps.push_back(c);
+    ictx2->io_work_queue->aio_write(c, i + 32, write_bl.length(),
+                                    bufferlist{write_bl}, 0);
+  }
+  for (auto c : comps) {
+    ASSERT_EQ(0, c->wait_for_complete());
+    c->put();
+  }
+
+  bufferptr read_ptr(write_bl.length());
+  bufferlist read_bl;
+  read_bl.push_back(read_ptr);
+
+  bufferlist parent_bl;
+  parent_bl.substr_of(bl, 0, 2016);
+
+  librbd::io::ReadResult read_result{&read_bl};
+  for (size_t i = 0; i < m_image_size; i += (1 << order)) {
+    // verify the written extent ...
+    ASSERT_EQ((ssize_t)write_bl.length(),
+              ictx2->io_work_queue->read(i + 32, write_bl.length(),
+                                         librbd::io::ReadResult{read_result},
+                                         0));
+    ASSERT_TRUE(write_bl.contents_equal(read_bl));
+
+    // ... and the copied-up parent data after it
+    ASSERT_EQ((ssize_t)parent_bl.length(),
+              ictx2->io_work_queue->read(i + 2080, parent_bl.length(),
+                                         librbd::io::ReadResult{read_result},
+                                         0));
+    ASSERT_TRUE(parent_bl.contents_equal(read_bl));
+  }
+}
+
+TEST_F(TestInternal, ReadaheadBuffer)
+{
+  CephContext* cct = reinterpret_cast<CephContext*>(_rados.cct());
+  std::string orig_cache = cct->_conf->rbd_cache ? "true" : "false";
+
+  ASSERT_EQ(0, _rados.conf_set("rbd_cache", "false"));
+  ASSERT_EQ(0, _rados.conf_set("rbd_readahead_buffer_bytes", "4194304"));
+  BOOST_SCOPE_EXIT(&_rados, &orig_cache) {
+    ASSERT_EQ(0, _rados.conf_set("rbd_cache", orig_cache.c_str()));
+    ASSERT_EQ(0, _rados.conf_set("rbd_readahead_buffer_bytes", "0"));
+  } BOOST_SCOPE_EXIT_END;
+
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+  ASSERT_TRUE(ictx->readahead_buffer != nullptr);
+
+  bufferlist bl;
+  for (char c = 'a'; c <= 'z'; c++) {
+    bl.append(std::string(4096, c));
+  }
+  ASSERT_EQ((ssize_t)bl.length(),
+            ictx->io_work_queue->write(0, bl.length(), bufferlist{bl}, 0));
+
+  // sequential reads trigger speculative reads into the buffer
+  bufferptr read_ptr(4096);
+  bufferlist read_bl;
+  read_bl.push_back(read_ptr);
+
+  librbd::io::ReadResult read_result{&read_bl};
+  for (uint64_t off = 0; off < bl.length(); off += 4096) {
+    ASSERT_EQ(4096,
+              ictx->io_work_queue->read(off, 4096,
+                                        librbd::io::ReadResult{read_result},
+                                        0));
+    bufferlist expected_bl;
+    expected_bl.substr_of(bl, off, 4096);
+    ASSERT_TRUE(expected_bl.contents_equal(read_bl));
+  }
+  ASSERT_LT(0U, ictx->perfcounter->get(l_librbd_readahead_hit));
+}
+
 TEST_F(TestInternal, ShrinkFlushesCache) {
   librbd::ImageCtx *ictx;
   ASSERT_EQ(0, open_image(m_image_name, &ictx));
@@ -804,6 +931,42 @@ TEST_F(TestInternal, ShrinkFlushesCache) {
   c->put();
 }
 
+TEST_F(TestInternal, ImageCacheWriteBack) {
+  ASSERT_EQ(0, _rados.conf_set("rbd_image_cache", "true"));
+  BOOST_SCOPE_EXIT(void) {
+    ASSERT_EQ(0, _rados.conf_set("rbd_image_cache", "false"));
+  } BOOST_SCOPE_EXIT_END;
+
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+  ASSERT_TRUE(ictx->image_cache != nullptr);
+
+  bufferlist bl;
+  bl.append(std::string(4096, '1'));
+  ASSERT_EQ(4096, ictx->io_work_queue->write(0, bl.length(), bufferlist{bl},
+                                             0));
+
+  // reads are served from the local write log until write-back
+  bufferptr read_ptr(4096);
+  bufferlist read_bl;
+  read_bl.push_back(read_ptr);
+  librbd::io::ReadResult read_result{&read_bl};
+  ASSERT_EQ(4096,
+            ictx->io_work_queue->read(0, 4096,
+                                      librbd::io::ReadResult{read_result}, 0));
+  ASSERT_TRUE(bl.contents_equal(read_bl));
+
+  // a flush writes the dirty extents back to the cluster
+  C_SaferCond flush_ctx;
+  ictx->image_cache->flush(&flush_ctx);
+  ASSERT_EQ(0, flush_ctx.wait());
+
+  bufferlist rados_bl;
+  ASSERT_EQ(4096, ictx->data_ctx.read(ictx->get_object_name(0), rados_bl,
+                                      4096, 0));
+  ASSERT_TRUE(bl.contents_equal(rados_bl));
+}
+
 TEST_F(TestInternal, ImageOptions) {
   rbd_image_options_t opts1 = NULL, opts2 = NULL;
   uint64_t uint64_val1 = 10, uint64_val2 = 0;
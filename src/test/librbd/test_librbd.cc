@@ -364,6 +364,49 @@ TEST_F(TestLibRBD, CreateAndStatPP)
   ioctx.close();
 }
 
+TEST_F(TestLibRBD, SnapCreateBatchPP)
+{
+  librados::IoCtx ioctx;
+  ASSERT_EQ(0, _rados.ioctx_create(m_pool_name.c_str(), ioctx));
+
+  librbd::RBD rbd;
+  int order = 0;
+  uint64_t size = 2 << 20;
+  std::vector<std::string> names;
+  for (int i = 0; i < 3; ++i) {
+    names.push_back(get_temp_image_name());
+    ASSERT_EQ(0, create_image_pp(rbd, ioctx, names[i].c_str(), size, &order));
+  }
+
+  std::vector<int> results;
+  ASSERT_EQ(0, rbd.snap_create_batch(ioctx, names, "snap1", &results));
+  ASSERT_EQ(names.size(), results.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    ASSERT_EQ(0, results[i]);
+
+    librbd::Image image;
+    std::vector<librbd::snap_info_t> snaps;
+    ASSERT_EQ(0, rbd.open(ioctx, image, names[i].c_str(), NULL));
+    ASSERT_EQ(0, image.snap_list(snaps));
+    ASSERT_EQ(1U, snaps.size());
+    ASSERT_EQ("snap1", snaps[0].name);
+    ASSERT_EQ(0, image.close());
+  }
+
+  // second create reports per-image -EEXIST
+  ASSERT_EQ(-EEXIST, rbd.snap_create_batch(ioctx, names, "snap1", &results));
+  for (size_t i = 0; i < names.size(); ++i) {
+    ASSERT_EQ(-EEXIST, results[i]);
+  }
+
+  ASSERT_EQ(0, rbd.snap_remove_batch(ioctx, names, "snap1", &results));
+  for (size_t i = 0; i < names.size(); ++i) {
+    ASSERT_EQ(0, results[i]);
+  }
+
+  ioctx.close();
+}
+
 TEST_F(TestLibRBD, GetId)
 {
   rados_ioctx_t ioctx;
@@ -0,0 +1,106 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * Copyright (C) 2017 Red Hat, Inc.
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+/*
+ * Measure the marshalling cost of the dominant message on the data
+ * path: a single-op MOSDOp and its MOSDOpReply.  Reports cycles and
+ * nanoseconds per encode and per decode so changes to the encoders can
+ * be compared before/after.
+ *
+ *   ceph_perf_mosdop [count]
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+#include "common/ceph_argparse.h"
+#include "common/Cycles.h"
+#include "global/global_init.h"
+#include "messages/MOSDOp.h"
+#include "messages/MOSDOpReply.h"
+
+int main(int argc, char **argv)
+{
+  vector<const char*> args;
+  argv_to_vec(argc, (const char **)argv, args);
+
+  auto cct = global_init(NULL, args, CEPH_ENTITY_TYPE_CLIENT,
+			 CODE_ENVIRONMENT_UTILITY, 0);
+  common_init_finish(g_ceph_context);
+  Cycles::init();
+
+  uint64_t count = 1000000;
+  if (args.size() > 0)
+    count = atoll(args[0]);
+
+  const uint64_t features = CEPH_FEATURES_SUPPORTED_DEFAULT;
+
+  object_t oid("perf-mosdop-object");
+  pg_t pgid(1, 2);
+  hobject_t hobj(oid, string(), CEPH_NOSNAP, pgid.ps(), pgid.pool(),
+		 string());
+  spg_t spgid(pgid);
+
+  MOSDOp *m = new MOSDOp(0, 1, hobj, spgid, 100, 0, features);
+  m->read(4096, 4096);
+
+  // encode
+  uint64_t start = Cycles::rdtsc();
+  for (uint64_t i = 0; i < count; ++i) {
+    m->clear_payload();
+    m->encode_payload(features);
+  }
+  uint64_t cycles = (Cycles::rdtsc() - start) / count;
+  cout << "MOSDOp encode: " << cycles << " cycles/msg ("
+       << (uint64_t)(Cycles::to_seconds(cycles) * 1000000000)
+       << " ns)" << std::endl;
+
+  // decode
+  bufferlist pl = m->get_payload();
+  ceph_msg_header header = m->get_header();
+  start = Cycles::rdtsc();
+  for (uint64_t i = 0; i < count; ++i) {
+    MOSDOp *d = new MOSDOp();
+    d->set_header(header);
+    bufferlist c = pl;
+    d->set_payload(c);
+    d->decode_payload();
+    d->finish_decode();
+    d->put();
+  }
+  cycles = (Cycles::rdtsc() - start) / count;
+  cout << "MOSDOp decode: " << cycles << " cycles/msg ("
+       << (uint64_t)(Cycles::to_seconds(cycles) * 1000000000)
+       << " ns)" << std::endl;
+
+  // reply encode
+  MOSDOpReply *r = new MOSDOpReply(m, 0, 100, 0, false);
+  start = Cycles::rdtsc();
+  for (uint64_t i = 0; i < count; ++i) {
+    r->clear_payload();
+    r->encode_payload(features);
+  }
+  cycles = (Cycles::rdtsc() - start) / count;
+  cout << "MOSDOpReply encode: " << cycles << " cycles/msg ("
+       << (uint64_t)(Cycles::to_seconds(cycles) * 1000000000)
+       << " ns)" << std::endl;
+
+  r->put();
+  m->put();
+  return 0;
+}
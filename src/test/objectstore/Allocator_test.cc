@@ -218,7 +218,7 @@ TEST_P(AllocTest, test_alloc_big)
 
 TEST_P(AllocTest, test_alloc_hint_bmap)
 {
-  if (GetParam() == std::string("stupid")) {
+  if (GetParam() != std::string("bitmap")) {
     return;
   }
   int64_t blocks = BitMapArea::get_level_factor(g_ceph_context, 2) * 4;
@@ -277,7 +277,7 @@ TEST_P(AllocTest, test_alloc_hint_bmap)
 INSTANTIATE_TEST_CASE_P(
   Allocator,
   AllocTest,
-  ::testing::Values("stupid", "bitmap"));
+  ::testing::Values("stupid", "bitmap", "hybrid"));
 
 #else
 
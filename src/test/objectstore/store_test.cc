@@ -32,6 +32,7 @@
 #include "include/Context.h"
 #include "common/ceph_argparse.h"
 #include "global/global_init.h"
+#include "common/Checksummer.h"
 #include "common/Mutex.h"
 #include "common/Cond.h"
 #include "common/errno.h"
@@ -510,6 +511,58 @@ TEST_P(StoreTest, FiemapHoles) {
   }
 }
 
+TEST_P(StoreTest, GetCsums) {
+  ObjectStore::Sequencer osr("test");
+  coll_t cid;
+  int r = 0;
+  ghobject_t oid(hobject_t(sobject_t("csum_object", CEPH_NOSNAP)));
+  bufferlist bl;
+  bl.append(string(0x10000, 'a'));
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    t.write(cid, oid, 0, bl.length(), bl);
+    r = apply_transaction(store, &osr, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  {
+    vector<ObjectStore::csum_extent_t> csums;
+    r = store->get_csums(cid, oid, 0, bl.length(), &csums);
+    if (r == -EOPNOTSUPP) {
+      cout << "store keeps no csums, skipping" << std::endl;
+    } else {
+      ASSERT_EQ(r, 0);
+      uint64_t covered = 0;
+      for (auto& e : csums) {
+	cout << " got 0x" << std::hex << e.offset << "~" << e.length
+	     << std::dec << " csum_type " << e.csum_type
+	     << " chunk_size " << e.csum_chunk_size
+	     << " " << e.csum_data.length() << " bytes" << std::endl;
+	covered += e.length;
+	if (e.csum_type != Checksummer::CSUM_NONE) {
+	  ASSERT_GT(e.csum_chunk_size, 0u);
+	  ASSERT_GT(e.csum_data.length(), 0u);
+	}
+      }
+      ASSERT_EQ(covered, (uint64_t)bl.length());
+    }
+    // a range past eof yields nothing
+    csums.clear();
+    r = store->get_csums(cid, oid, bl.length() * 2, 0x1000, &csums);
+    if (r != -EOPNOTSUPP) {
+      ASSERT_EQ(r, 0);
+      ASSERT_TRUE(csums.empty());
+    }
+  }
+  {
+    ObjectStore::Transaction t;
+    t.remove(cid, oid);
+    t.remove_collection(cid);
+    r = apply_transaction(store, &osr, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
+
 TEST_P(StoreTest, SimpleMetaColTest) {
   ObjectStore::Sequencer osr("test");
   coll_t cid;
@@ -4231,6 +4284,149 @@ TEST_P(StoreTest, Synthetic) {
   doSyntheticTest(store, 10000, 400*1024, 40*1024, 0);
 }
 
+// Fast-forward a fresh store through heavy create/overwrite/delete/clone
+// churn before running the usual synthetic mix, so allocator and
+// extent-map regressions that only manifest on aged stores show up here
+// instead of months later in production.  The generator is seeded
+// (STORE_TEST_AGING_SEED overrides) so any failure can be replayed.
+void doAgingTest(boost::scoped_ptr<ObjectStore>& store,
+		 int aging_ops, int bench_ops,
+		 uint64_t max_obj, uint64_t max_wr, uint64_t align)
+{
+  ObjectStore::Sequencer osr("test");
+  MixedGenerator gen(555);
+  unsigned seed = 4242;
+  if (getenv("STORE_TEST_AGING_SEED")) {
+    seed = atoi(getenv("STORE_TEST_AGING_SEED"));
+  }
+  cerr << "aging with seed " << seed << std::endl;
+  gen_type rng(seed);
+  coll_t cid(spg_t(pg_t(0,555), shard_id_t::NO_SHARD));
+
+  g_ceph_context->_conf->set_val("bluestore_fsck_on_mount", "false");
+  g_ceph_context->_conf->set_val("bluestore_fsck_on_umount", "false");
+  g_ceph_context->_conf->apply_changes(NULL);
+
+  SyntheticWorkloadState test_obj(store.get(), &gen, &rng, &osr, cid,
+				  max_obj, max_wr, align);
+  test_obj.init();
+  for (int i = 0; i < aging_ops/10; ++i) {
+    if (!(i % 500)) cerr << "seeding object " << i << std::endl;
+    test_obj.touch();
+  }
+
+  // churn: no reads, delete-heavy and overwrite-heavy so the allocator
+  // sees many alloc/free cycles and extent maps accumulate shards
+  for (int i = 0; i < aging_ops; ++i) {
+    if (!(i % 1000)) {
+      cerr << "aging op " << i << std::endl;
+      test_obj.print_internal_state();
+    }
+    boost::uniform_int<> true_false(0, 999);
+    int val = true_false(rng);
+    if (val > 820) {
+      test_obj.unlink();
+    } else if (val > 770) {
+      test_obj.truncate();
+    } else if (val > 690) {
+      test_obj.zero();
+    } else if (val > 620) {
+      test_obj.clone();
+    } else if (val > 120) {
+      test_obj.write();
+    } else {
+      test_obj.touch();
+    }
+  }
+  test_obj.wait_for_done();
+
+  // issue a read to refresh cache stats and let the mempool thread
+  // catch up before sampling the counters
+  test_obj.read();
+  test_obj.wait_for_done();
+  sleep(1);
+
+  const PerfCounters* logger = store->get_perf_counters();
+  store_statfs_t aged;
+  test_obj.statfs(aged);
+  uint64_t aged_onodes = logger->get(l_bluestore_onodes);
+  uint64_t aged_extents = logger->get(l_bluestore_extents);
+  uint64_t aged_blobs = logger->get(l_bluestore_blobs);
+  cerr << "aged store: allocated " << aged.allocated
+       << " stored " << aged.stored
+       << " onodes " << aged_onodes
+       << " extents " << aged_extents
+       << " blobs " << aged_blobs << std::endl;
+  if (aged.stored) {
+    cerr << "aged allocation overhead "
+	 << (double)aged.allocated / (double)aged.stored << std::endl;
+  }
+
+  // benchmark mix against the aged state
+  for (int i = 0; i < bench_ops; ++i) {
+    if (!(i % 1000)) {
+      cerr << "bench op " << i << std::endl;
+      test_obj.print_internal_state();
+    }
+    boost::uniform_int<> true_false(0, 999);
+    int val = true_false(rng);
+    if (val > 970) {
+      test_obj.scan();
+    } else if (val > 950) {
+      test_obj.stat();
+    } else if (val > 850) {
+      test_obj.zero();
+    } else if (val > 800) {
+      test_obj.unlink();
+    } else if (val > 550) {
+      test_obj.write();
+    } else if (val > 500) {
+      test_obj.clone();
+    } else if (val > 450) {
+      test_obj.clone_range();
+    } else if (val > 300) {
+      test_obj.stash();
+    } else if (val > 100) {
+      test_obj.read();
+    } else {
+      test_obj.truncate();
+    }
+  }
+  test_obj.wait_for_done();
+  sleep(1);
+
+  store_statfs_t bench;
+  test_obj.statfs(bench);
+  uint64_t bench_extents = logger->get(l_bluestore_extents);
+  uint64_t bench_blobs = logger->get(l_bluestore_blobs);
+  cerr << "after bench: allocated " << bench.allocated
+       << " stored " << bench.stored
+       << " extents " << bench_extents
+       << " blobs " << bench_blobs << std::endl;
+
+  // generous bounds meant to catch order-of-magnitude fragmentation
+  // regressions on the aged store, not to benchmark absolute numbers
+  if (bench.stored) {
+    ASSERT_LT((double)bench.allocated / (double)bench.stored, 16.0);
+  }
+  if (bench_blobs) {
+    ASSERT_LT((double)bench_extents / (double)bench_blobs, 16.0);
+  }
+
+  test_obj.fsck(true);
+  test_obj.shutdown();
+
+  g_ceph_context->_conf->set_val("bluestore_fsck_on_mount", "true");
+  g_ceph_context->_conf->set_val("bluestore_fsck_on_umount", "true");
+  g_ceph_context->_conf->apply_changes(NULL);
+}
+
+TEST_P(StoreTest, AgedSynthetic) {
+  if (string(GetParam()) != "bluestore")
+    return;
+  doAgingTest(store, 20000, 5000, 400*1024, 40*1024, 0);
+}
+
 
 TEST_P(StoreTestSpecificAUSize, SyntheticMatrixSharding) {
   if (string(GetParam()) != "bluestore")
@@ -1,11 +1,13 @@
 // -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
 // vim: ts=8 sw=2 smarttab
 
+#include <algorithm>
 #include <chrono>
 #include <cassert>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <thread>
 
 #include "os/ObjectStore.h"
@@ -14,6 +16,8 @@
 
 #include "common/strtol.h"
 #include "common/ceph_argparse.h"
+#include "common/perf_counters.h"
+#include "common/Formatter.h"
 
 #define dout_context g_ceph_context
 #define dout_subsys ceph_subsys_filestore
@@ -29,8 +33,14 @@ static void usage()
       "	       number of times to repeat the write cycle\n"
       "	 --threads\n"
       "	       number of threads to carry out this workload\n"
+      "	 --queue-depth\n"
+      "	       number of transactions to keep in flight per thread\n"
+      "	 --omap-keys\n"
+      "	       set this many omap keys in each transaction\n"
       "	 --multi-object\n"
-      "	       have each thread write to a separate object\n" << dendl;
+      "	       have each thread write to a separate object\n"
+      "	 --dump-perf\n"
+      "	       dump the store's perf counters on completion\n" << dendl;
   generic_server_usage();
 }
 
@@ -73,30 +83,45 @@ struct Config {
   byte_units block_size;
   int repeats;
   int threads;
+  int queue_depth;
+  int omap_keys;
   bool multi_object;
+  bool dump_perf;
   Config()
     : size(1048576), block_size(4096),
       repeats(1), threads(1),
-      multi_object(false) {}
+      queue_depth(16), omap_keys(0),
+      multi_object(false), dump_perf(false) {}
 };
 
-class C_NotifyCond : public Context {
+// records the commit latency of one transaction and releases its
+// queue-depth slot
+class C_OnCommit : public Context {
   std::mutex *mutex;
   std::condition_variable *cond;
-  bool *done;
+  int *in_flight;
+  std::vector<double> *latencies;
+  std::chrono::high_resolution_clock::time_point start;
 public:
-  C_NotifyCond(std::mutex *mutex, std::condition_variable *cond, bool *done)
-    : mutex(mutex), cond(cond), done(done) {}
+  C_OnCommit(std::mutex *mutex, std::condition_variable *cond,
+             int *in_flight, std::vector<double> *latencies)
+    : mutex(mutex), cond(cond), in_flight(in_flight), latencies(latencies),
+      start(std::chrono::high_resolution_clock::now()) {}
   void finish(int r) override {
+    using namespace std::chrono;
+    auto lat = duration_cast<microseconds>(
+        high_resolution_clock::now() - start);
     std::lock_guard<std::mutex> lock(*mutex);
-    *done = true;
+    latencies->push_back(lat.count());
+    --*in_flight;
     cond->notify_one();
   }
 };
 
 void osbench_worker(ObjectStore *os, const Config &cfg,
                     const coll_t cid, const ghobject_t oid,
-                    uint64_t starting_offset)
+                    uint64_t starting_offset,
+                    std::vector<double> *latencies)
 {
   bufferlist data;
   data.append(buffer::create(cfg.block_size));
@@ -109,40 +134,56 @@ void osbench_worker(ObjectStore *os, const Config &cfg,
 
   ObjectStore::Sequencer sequencer("osbench");
 
+  std::mutex mutex;
+  std::condition_variable cond;
+  int in_flight = 0;
+  unsigned omap_seq = 0;
+
   for (int i = 0; i < cfg.repeats; ++i) {
     uint64_t offset = starting_offset;
     size_t len = cfg.size;
 
-    vector<ObjectStore::Transaction> tls;
-
     std::cout << "Write cycle " << i << std::endl;
     while (len) {
       size_t count = len < cfg.block_size ? len : (size_t)cfg.block_size;
 
-      auto t = new ObjectStore::Transaction;
-      t->write(cid, oid, offset, count, data);
-      tls.push_back(std::move(*t));
-      delete t;
+      vector<ObjectStore::Transaction> tls(1);
+      auto &t = tls.back();
+      t.write(cid, oid, offset, count, data);
+      if (cfg.omap_keys) {
+        std::map<std::string, bufferlist> keys;
+        for (int k = 0; k < cfg.omap_keys; ++k) {
+          bufferlist val;
+          val.append("osbench omap value payload");
+          std::stringstream key;
+          key << "osbench-" << omap_seq++ << "-" << k;
+          keys[key.str()] = val;
+        }
+        t.omap_setkeys(cid, oid, keys);
+      }
+
+      // respect the queue depth so we measure a steady stream of
+      // transactions instead of one huge burst per cycle
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return in_flight < cfg.queue_depth; });
+        ++in_flight;
+      }
+      os->queue_transactions(&sequencer, tls, nullptr,
+                             new C_OnCommit(&mutex, &cond, &in_flight,
+                                            latencies));
 
       offset += count;
       if (offset > cfg.size)
         offset -= cfg.size;
       len -= count;
     }
+  }
 
-    // set up the finisher
-    std::mutex mutex;
-    std::condition_variable cond;
-    bool done = false;
-
-    os->queue_transactions(&sequencer, tls, nullptr,
-                           new C_NotifyCond(&mutex, &cond, &done));
-
+  // drain
+  {
     std::unique_lock<std::mutex> lock(mutex);
-    cond.wait(lock, [&done](){ return done; });
-    lock.unlock();
-
-
+    cond.wait(lock, [&] { return in_flight == 0; });
   }
   sequencer.flush();
 }
@@ -181,8 +222,18 @@ int main(int argc, const char *argv[])
       cfg.repeats = atoi(val.c_str());
     } else if (ceph_argparse_witharg(args, i, &val, "--threads", (char*)nullptr)) {
       cfg.threads = atoi(val.c_str());
+    } else if (ceph_argparse_witharg(args, i, &val, "--queue-depth", (char*)nullptr)) {
+      cfg.queue_depth = atoi(val.c_str());
+      if (cfg.queue_depth < 1) {
+        derr << "queue-depth must be at least 1" << dendl;
+        usage();
+      }
+    } else if (ceph_argparse_witharg(args, i, &val, "--omap-keys", (char*)nullptr)) {
+      cfg.omap_keys = atoi(val.c_str());
     } else if (ceph_argparse_flag(args, i, "--multi-object", (char*)nullptr)) {
       cfg.multi_object = true;
+    } else if (ceph_argparse_flag(args, i, "--dump-perf", (char*)nullptr)) {
+      cfg.dump_perf = true;
     } else {
       derr << "Error: can't understand argument: " << *i << "\n" << dendl;
       usage();
@@ -199,6 +250,8 @@ int main(int argc, const char *argv[])
   dout(0) << "block-size " << cfg.block_size << dendl;
   dout(0) << "repeats " << cfg.repeats << dendl;
   dout(0) << "threads " << cfg.threads << dendl;
+  dout(0) << "queue-depth " << cfg.queue_depth << dendl;
+  dout(0) << "omap-keys " << cfg.omap_keys << dendl;
 
   auto os = std::unique_ptr<ObjectStore>(
       ObjectStore::create(g_ceph_context,
@@ -292,13 +345,15 @@ int main(int argc, const char *argv[])
   // run the worker threads
   std::vector<std::thread> workers;
   workers.reserve(cfg.threads);
+  std::vector<std::vector<double>> latencies(cfg.threads);
 
   using namespace std::chrono;
   auto t1 = high_resolution_clock::now();
   for (int i = 0; i < cfg.threads; i++) {
     const auto &oid = cfg.multi_object ? oids[i] : oids[0];
     workers.emplace_back(osbench_worker, os.get(), std::ref(cfg),
-                         cid, oid, i * cfg.size / cfg.threads);
+                         cid, oid, i * cfg.size / cfg.threads,
+                         &latencies[i]);
   }
   for (auto &worker : workers)
     worker.join();
@@ -313,6 +368,35 @@ int main(int argc, const char *argv[])
       << duration.count() << "us, at a rate of " << rate << "/s and "
       << iops << " iops" << dendl;
 
+  // per-transaction commit latency distribution
+  std::vector<double> all;
+  for (const auto &v : latencies)
+    all.insert(all.end(), v.begin(), v.end());
+  if (!all.empty()) {
+    std::sort(all.begin(), all.end());
+    auto pct = [&all](double centile) {
+      size_t rank = (size_t)(centile * all.size() / 100);
+      return all[std::min(rank, all.size() - 1)];
+    };
+    double avg = std::accumulate(all.begin(), all.end(), 0.0) / all.size();
+    dout(0) << "Commit latency (us): avg " << avg
+        << " min " << all.front()
+        << " p50 " << pct(50)
+        << " p95 " << pct(95)
+        << " p99 " << pct(99)
+        << " max " << all.back() << dendl;
+  }
+
+  if (cfg.dump_perf) {
+    // per-stage breakdown from the store's own counters
+    // (l_bluestore_*, l_filestore_*, ...)
+    Formatter *f = Formatter::create("json-pretty");
+    g_ceph_context->get_perfcounters_collection()->dump_formatted(f, false);
+    f->flush(std::cout);
+    std::cout << std::endl;
+    delete f;
+  }
+
   // remove the objects
   ObjectStore::Sequencer osr(__func__);
   ObjectStore::Transaction t;
@@ -56,5 +56,35 @@ TEST(ECUtil, stripe_info_t)
 
   ASSERT_EQ(s.offset_len_to_stripe_bounds(make_pair(swidth-10, (uint64_t)20)),
             make_pair((uint64_t)0, 2*swidth));
+
+  const uint64_t csize = s.get_chunk_size();
+  std::set<int> indices;
+
+  // a single aligned chunk touches one data shard
+  s.offset_len_to_data_chunk_indices(0, csize, &indices);
+  ASSERT_EQ(indices, std::set<int>{0});
+  indices.clear();
+
+  s.offset_len_to_data_chunk_indices(2*csize, csize, &indices);
+  ASSERT_EQ(indices, std::set<int>{2});
+  indices.clear();
+
+  // an unaligned range touches the chunks on either side
+  s.offset_len_to_data_chunk_indices(csize - 1, (uint64_t)2, &indices);
+  ASSERT_EQ(indices, (std::set<int>{0, 1}));
+  indices.clear();
+
+  // crossing a stripe boundary wraps around to the first chunk
+  s.offset_len_to_data_chunk_indices(swidth - csize, 2*csize, &indices);
+  ASSERT_EQ(indices, (std::set<int>{0, 3}));
+  indices.clear();
+
+  // a full stripe (and anything longer) touches every data chunk
+  s.offset_len_to_data_chunk_indices(csize, swidth, &indices);
+  ASSERT_EQ(indices, (std::set<int>{0, 1, 2, 3}));
+  indices.clear();
+
+  s.offset_len_to_data_chunk_indices(0, 10*swidth, &indices);
+  ASSERT_EQ(indices, (std::set<int>{0, 1, 2, 3}));
 }
 
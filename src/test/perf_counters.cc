@@ -188,6 +188,50 @@ TEST(PerfCounters, MultiplePerfCounters) {
   ASSERT_EQ("{}", msg);
 }
 
+enum {
+  TEST_PERFCOUNTERS3_ELEMENT_FIRST = 600,
+  TEST_PERFCOUNTERS3_ELEMENT_1,
+  TEST_PERFCOUNTERS3_ELEMENT_LAST,
+};
+
+static PerfCounters* setup_test_perfcounter3(CephContext *cct)
+{
+  PerfCountersBuilder bld(cct, "test_perfcounter_3",
+	  TEST_PERFCOUNTERS3_ELEMENT_FIRST, TEST_PERFCOUNTERS3_ELEMENT_LAST);
+  PerfHistogramCommon::axis_config_d lat_axis{
+    "Latency (nsec)", PerfHistogramCommon::SCALE_LINEAR, 0, 100, 4};
+  bld.add_time_avg_histogram(TEST_PERFCOUNTERS3_ELEMENT_1, "element1",
+			     lat_axis);
+  return bld.create_perf_counters();
+}
+
+TEST(PerfCounters, TimeAvgHistogram) {
+  PerfCountersCollection *coll = g_ceph_context->get_perfcounters_collection();
+  coll->clear();
+  PerfCounters* fake_pf = setup_test_perfcounter3(g_ceph_context);
+  coll->add(fake_pf);
+  AdminSocketClient client(get_rand_socket_path());
+  std::string msg;
+
+  fake_pf->tinc(TEST_PERFCOUNTERS3_ELEMENT_1, utime_t(0, 50));
+  fake_pf->tinc(TEST_PERFCOUNTERS3_ELEMENT_1, utime_t(0, 150));
+  fake_pf->tinc(TEST_PERFCOUNTERS3_ELEMENT_1, utime_t(0, 1000000));
+
+  // the average is still reported through the regular dump ...
+  ASSERT_EQ("", client.do_request("{ \"prefix\": \"perf dump\", \"format\": \"json\" }", &msg));
+  ASSERT_EQ(sd("{\"test_perfcounter_3\":{\"element1\":{\"avgcount\":3,"
+	    "\"sum\":0.001000200,\"avgtime\":0.000333400}}}"), msg);
+
+  // ... and the quantized values through the histogram dump
+  ASSERT_EQ("", client.do_request("{ \"prefix\": \"perf histogram dump\", \"format\": \"json\" }", &msg));
+  ASSERT_EQ(sd("{\"test_perfcounter_3\":{\"element1\":{\"axes\":[{\"name\":\"Latency (nsec)\","
+	    "\"min\":0,\"quant_size\":100,\"buckets\":4,\"scale_type\":\"linear\","
+	    "\"ranges\":[{\"max\":-1},{\"min\":0,\"max\":99},{\"min\":100,\"max\":199},{\"min\":200}]}],"
+	    "\"values\":[0,1,1,1]}}}"), msg);
+
+  coll->clear();
+}
+
 TEST(PerfCounters, CephContextPerfCounters) {
   // Enable the perf counter
   g_ceph_context->enable_perf_counter();
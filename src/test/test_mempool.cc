@@ -184,6 +184,40 @@ struct obj {
 };
 MEMPOOL_DEFINE_OBJECT_FACTORY(obj, obj, osdmap);
 
+struct slab_obj {
+  MEMPOOL_CLASS_HELPERS();
+  int a;
+  int b;
+  slab_obj() : a(1), b(1) {}
+  slab_obj(int _a) : a(_a), b(2) {}
+};
+MEMPOOL_DEFINE_SLAB_OBJECT_FACTORY(slab_obj, slab_obj, osdmap);
+
+TEST(mempool, test_slab_factory)
+{
+  size_t items = mempool::osdmap::allocated_items();
+  std::vector<slab_obj*> objs;
+  // churn through more objects than one slab holds, including reuse
+  for (unsigned i = 0; i < 200; ++i) {
+    objs.push_back(new slab_obj(i));
+  }
+  check_usage(mempool::osdmap::id);
+  EXPECT_EQ(items + 200, mempool::osdmap::allocated_items());
+  for (unsigned i = 0; i < 200; ++i) {
+    EXPECT_EQ((int)i, objs[i]->a);
+  }
+  for (auto o : objs) {
+    delete o;
+  }
+  objs.clear();
+  EXPECT_EQ(items, mempool::osdmap::allocated_items());
+  // freed objects come back off the shard free list
+  slab_obj *o = new slab_obj(42);
+  EXPECT_EQ(42, o->a);
+  delete o;
+  check_usage(mempool::osdmap::id);
+}
+
 TEST(mempool, test_factory)
 {
    obj *o1 = new obj();
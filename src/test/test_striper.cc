@@ -22,6 +22,45 @@ TEST(Striper, Stripe1)
   ASSERT_EQ(94208u, ex[2].truncate_size);
 }
 
+TEST(Striper, StripeCountOneFastPath)
+{
+  file_layout_t l;
+
+  l.object_size = 4194304;
+  l.stripe_unit = 4194304;
+  l.stripe_count = 1;
+
+  // unaligned range spanning several objects
+  uint64_t offset = 4194304 - 1234;
+  uint64_t len = 2 * 4194304 + 5678;
+  uint64_t trunc_size = 3 * 4194304 + 9999;
+
+  vector<ObjectExtent> ex;
+  Striper::file_to_extents(g_ceph_context, 1, &l, offset, len, trunc_size, ex);
+
+  cout << "result " << ex << std::endl;
+
+  // the fast path must produce the same extents as the generic
+  // map-based implementation
+  map<object_t, vector<ObjectExtent> > object_extents;
+  char format[32];
+  snprintf(format, sizeof(format), "%llx.%%08llx", 1llu);
+  Striper::file_to_extents(g_ceph_context, format, &l, offset, len,
+			   trunc_size, object_extents);
+  vector<ObjectExtent> expected_ex;
+  Striper::assimilate_extents(object_extents, expected_ex);
+
+  ASSERT_EQ(expected_ex.size(), ex.size());
+  for (size_t i = 0; i < ex.size(); ++i) {
+    ASSERT_EQ(expected_ex[i].oid, ex[i].oid);
+    ASSERT_EQ(expected_ex[i].objectno, ex[i].objectno);
+    ASSERT_EQ(expected_ex[i].offset, ex[i].offset);
+    ASSERT_EQ(expected_ex[i].length, ex[i].length);
+    ASSERT_EQ(expected_ex[i].truncate_size, ex[i].truncate_size);
+    ASSERT_EQ(expected_ex[i].buffer_extents, ex[i].buffer_extents);
+  }
+}
+
 TEST(Striper, EmptyPartialResult)
 {
   file_layout_t l;
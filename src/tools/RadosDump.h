@@ -392,6 +392,23 @@ class RadosDump
         return ret;
       }
 
+    // Variant that appends the section to a bufferlist instead of
+    // writing it out, so callers can assemble sections off the main
+    // thread and write them in order later.
+    template <typename T>
+      int write_section(sectiontype_t type, const T& obj, bufferlist &out) {
+        if (dry_run)
+          return 0;
+        bufferlist bl;
+        obj.encode(bl);
+        header hdr(type, bl.length());
+        hdr.encode(out);
+        out.claim_append(bl);
+        footer ft;
+        ft.encode(out);
+        return 0;
+      }
+
     int write_simple(sectiontype_t type, int fd)
     {
       if (dry_run)
@@ -402,6 +419,15 @@ class RadosDump
       hdr.encode(hbl);
       return hbl.write_fd(fd);
     }
+
+    int write_simple(sectiontype_t type, bufferlist &out)
+    {
+      if (dry_run)
+        return 0;
+      header hdr(type, 0);
+      hdr.encode(out);
+      return 0;
+    }
 };
 
 #endif
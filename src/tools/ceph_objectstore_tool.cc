@@ -19,6 +19,8 @@
 
 #include <stdlib.h>
 
+#include <thread>
+
 #include "common/Formatter.h"
 #include "common/errno.h"
 #include "common/ceph_argparse.h"
@@ -74,6 +76,7 @@ const ssize_t max_read = 1024 * 1024;
 const int fd_none = INT_MIN;
 bool outistty;
 bool dry_run = false;
+unsigned export_threads = 1;
 
 struct action_on_object_t {
   virtual ~action_on_object_t() {}
@@ -496,7 +499,8 @@ void get_omap_batch(ObjectMap::ObjectMapIterator &iter, map<string, bufferlist>
   }
 }
 
-int ObjectStoreTool::export_file(ObjectStore *store, coll_t cid, ghobject_t &obj)
+int ObjectStoreTool::export_file(ObjectStore *store, coll_t cid,
+				 ghobject_t &obj, bufferlist &out)
 {
   struct stat st;
   mysize_t total;
@@ -506,8 +510,6 @@ int ObjectStoreTool::export_file(ObjectStore *store, coll_t cid, ghobject_t &obj
   if (ret < 0)
     return ret;
 
-  cerr << "Read " << obj << std::endl;
-
   total = st.st_size;
   if (debug)
     cerr << "size=" << total << std::endl;
@@ -530,7 +532,7 @@ int ObjectStoreTool::export_file(ObjectStore *store, coll_t cid, ghobject_t &obj
 
   // NOTE: we include whiteouts, lost, etc.
 
-  ret = write_section(TYPE_OBJECT_BEGIN, objb, file_fd);
+  ret = write_section(TYPE_OBJECT_BEGIN, objb, out);
   if (ret < 0)
     return ret;
 
@@ -555,7 +557,7 @@ int ObjectStoreTool::export_file(ObjectStore *store, coll_t cid, ghobject_t &obj
     total -= ret;
     offset += ret;
 
-    ret = write_section(TYPE_DATA, dblock, file_fd);
+    ret = write_section(TYPE_DATA, dblock, out);
     if (ret) return ret;
   }
 
@@ -564,7 +566,7 @@ int ObjectStoreTool::export_file(ObjectStore *store, coll_t cid, ghobject_t &obj
   ret = store->getattrs(cid, obj, aset);
   if (ret) return ret;
   attr_section as(aset);
-  ret = write_section(TYPE_ATTRS, as, file_fd);
+  ret = write_section(TYPE_ATTRS, as, out);
   if (ret)
     return ret;
 
@@ -581,7 +583,7 @@ int ObjectStoreTool::export_file(ObjectStore *store, coll_t cid, ghobject_t &obj
   }
 
   omap_hdr_section ohs(hdrbuf);
-  ret = write_section(TYPE_OMAP_HDR, ohs, file_fd);
+  ret = write_section(TYPE_OMAP_HDR, ohs, out);
   if (ret)
     return ret;
 
@@ -593,22 +595,22 @@ int ObjectStoreTool::export_file(ObjectStore *store, coll_t cid, ghobject_t &obj
   }
   iter->seek_to_first();
   int mapcount = 0;
-  map<string, bufferlist> out;
+  map<string, bufferlist> omap;
   while(iter->valid()) {
-    get_omap_batch(iter, out);
+    get_omap_batch(iter, omap);
 
-    if (out.empty()) break;
+    if (omap.empty()) break;
 
-    mapcount += out.size();
-    omap_section oms(out);
-    ret = write_section(TYPE_OMAP, oms, file_fd);
+    mapcount += omap.size();
+    omap_section oms(omap);
+    ret = write_section(TYPE_OMAP, oms, out);
     if (ret)
       return ret;
   }
   if (debug)
     cerr << "omap map size " << mapcount << std::endl;
 
-  ret = write_simple(TYPE_OBJECT_END, file_fd);
+  ret = write_simple(TYPE_OBJECT_END, out);
   if (ret)
     return ret;
 
@@ -625,6 +627,7 @@ int ObjectStoreTool::export_files(ObjectStore *store, coll_t coll)
       &objects, &next);
     if (r < 0)
       return r;
+    vector<ghobject_t> todo;
     for (vector<ghobject_t>::iterator i = objects.begin();
 	 i != objects.end();
 	 ++i) {
@@ -632,9 +635,34 @@ int ObjectStoreTool::export_files(ObjectStore *store, coll_t coll)
       if (i->is_pgmeta() || i->hobj.is_temp()) {
 	continue;
       }
-      r = export_file(store, coll, *i);
-      if (r < 0)
-        return r;
+      todo.push_back(*i);
+    }
+    // Read up to export_threads objects concurrently, each worker
+    // serializing its object's sections into a private bufferlist, then
+    // write the buffers out in enumeration order so the stream is
+    // byte-identical to a single-threaded export.  Memory held at any
+    // point is bounded by export_threads fully-buffered objects.
+    for (size_t i = 0; i < todo.size(); i += export_threads) {
+      size_t n = std::min(todo.size() - i, (size_t)export_threads);
+      vector<bufferlist> bls(n);
+      vector<int> rets(n, 0);
+      vector<std::thread> workers;
+      for (size_t j = 1; j < n; ++j) {
+	workers.push_back(std::thread([&, j] {
+	      rets[j] = export_file(store, coll, todo[i + j], bls[j]);
+	    }));
+      }
+      rets[0] = export_file(store, coll, todo[i], bls[0]);
+      for (auto& w : workers)
+	w.join();
+      for (size_t j = 0; j < n; ++j) {
+	if (rets[j] < 0)
+	  return rets[j];
+	cerr << "Read " << todo[i + j] << std::endl;
+	r = bls[j].write_fd(file_fd);
+	if (r < 0)
+	  return r;
+      }
     }
   }
   return 0;
@@ -2550,6 +2578,8 @@ int main(int argc, char **argv)
     ("skip-mount-omap", "Disable mounting of omap")
     ("head", "Find head/snapdir when searching for objects by name")
     ("dry-run", "Don't modify the objectstore")
+    ("threads", po::value<unsigned>(&export_threads)->default_value(1),
+     "Number of parallel object reader threads used by the export op")
     ("namespace", po::value<string>(&argnspace), "Specify namespace when searching for objects")
     ;
 
@@ -2604,6 +2634,8 @@ int main(int argc, char **argv)
 
   if (vm.count("dry-run"))
     dry_run = true;
+  if (export_threads == 0)
+    export_threads = 1;
   osflagbits_t flags = 0;
   if (dry_run || vm.count("skip-journal-replay"))
     flags |= SKIP_JOURNAL_REPLAY;
@@ -3008,6 +3040,8 @@ int main(int argc, char **argv)
 
   if (op == "import") {
 
+    // hold off kv compaction while the whole PG streams in
+    fs->set_bulk_load(true);
     try {
       ret = tool.do_import(fs, superblock, force, pgidstr, *osr);
     }
@@ -3015,6 +3049,7 @@ int main(int argc, char **argv)
       cerr << "do_import threw exception error " << e.what() << std::endl;
       ret = -EFAULT;
     }
+    fs->set_bulk_load(false);
     if (ret == -EFAULT) {
       cerr << "Corrupt input for import" << std::endl;
     }
@@ -36,7 +36,7 @@ class ObjectStoreTool : public RadosDump
       bufferlist &bl, OSDMap &curmap, bool *skipped_objects,
       ObjectStore::Sequencer &osr);
     int export_file(
-        ObjectStore *store, coll_t cid, ghobject_t &obj);
+        ObjectStore *store, coll_t cid, ghobject_t &obj, bufferlist &out);
     int export_files(ObjectStore *store, coll_t coll);
 };
 
@@ -194,6 +194,7 @@ void usage()
   cout << "      [--num-rep n]\n";
   cout << "      [--pool-id n]      specifies pool id\n";
   cout << "      [--batches b]      split the CRUSH mapping into b > 1 rounds\n";
+  cout << "      [--num-threads n]  spread the mapping simulation over n threads\n";
   cout << "      [--weight|-w devno weight]\n";
   cout << "                         where weight is 0 to 1.0\n";
   cout << "      [--simulate]       simulate placements using a random\n";
@@ -206,6 +207,7 @@ void usage()
   cout << "   --show-mappings       show mappings\n";
   cout << "   --show-bad-mappings   show bad mappings\n";
   cout << "   --show-choose-tries   show choose tries histogram\n";
+  cout << "   --show-overload       show p99/max device overload vs expectation\n";
   cout << "   --output-name name\n";
   cout << "                         prepend the data file(s) generated during the\n";
   cout << "                         testing routine with name\n";
@@ -347,6 +349,9 @@ int main(int argc, const char **argv)
     } else if (ceph_argparse_flag(args, i, "--show_choose_tries", (char*)NULL)) {
       display = true;
       tester.set_output_choose_tries(true);
+    } else if (ceph_argparse_flag(args, i, "--show_overload", (char*)NULL)) {
+      display = true;
+      tester.set_output_overload(true);
     } else if (ceph_argparse_witharg(args, i, &val, "-c", "--compile", (char*)NULL)) {
       srcfn = val;
       compile = true;
@@ -599,6 +604,12 @@ int main(int argc, const char **argv)
 	return EXIT_FAILURE;
       }
       tester.set_batches(x);
+    } else if (ceph_argparse_witharg(args, i, &x, err, "--num-threads", (char*)NULL)) {
+      if (!err.str().empty()) {
+	cerr << err.str() << std::endl;
+	return EXIT_FAILURE;
+      }
+      tester.set_num_threads(x);
     } else if (ceph_argparse_witharg(args, i, &y, err, "--mark-down-ratio", (char*)NULL)) {
       if (!err.str().empty()) {
         cerr << err.str() << std::endl;
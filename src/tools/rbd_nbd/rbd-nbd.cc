@@ -40,8 +40,10 @@
 #include "common/config.h"
 #include "common/dout.h"
 
+#include "common/Clock.h"
 #include "common/errno.h"
 #include "common/module.h"
+#include "common/perf_counters.h"
 #include "common/safe_io.h"
 #include "common/TextTable.h"
 #include "common/ceph_argparse.h"
@@ -122,11 +124,25 @@ static void handle_signal(int signum)
   }
 }
 
+enum {
+  l_rbd_nbd_first = 90000,
+  l_rbd_nbd_rd,
+  l_rbd_nbd_rd_bytes,
+  l_rbd_nbd_rd_lat,
+  l_rbd_nbd_wr,
+  l_rbd_nbd_wr_bytes,
+  l_rbd_nbd_wr_lat,
+  l_rbd_nbd_discard,
+  l_rbd_nbd_flush,
+  l_rbd_nbd_last,
+};
+
 class NBDServer
 {
 private:
   int fd;
   librbd::Image &image;
+  PerfCounters *logger = nullptr;
 
 public:
   NBDServer(int _fd, librbd::Image& _image)
@@ -136,7 +152,20 @@ public:
     , reader_thread(*this, &NBDServer::reader_entry)
     , writer_thread(*this, &NBDServer::writer_entry)
     , started(false)
-  {}
+  {
+    PerfCountersBuilder plb(g_ceph_context, "rbd-nbd",
+			    l_rbd_nbd_first, l_rbd_nbd_last);
+    plb.add_u64_counter(l_rbd_nbd_rd, "rd", "Reads");
+    plb.add_u64_counter(l_rbd_nbd_rd_bytes, "rd_bytes", "Data size in reads");
+    plb.add_time_avg(l_rbd_nbd_rd_lat, "rd_latency", "Latency of reads");
+    plb.add_u64_counter(l_rbd_nbd_wr, "wr", "Writes");
+    plb.add_u64_counter(l_rbd_nbd_wr_bytes, "wr_bytes", "Written data");
+    plb.add_time_avg(l_rbd_nbd_wr_lat, "wr_latency", "Write latency");
+    plb.add_u64_counter(l_rbd_nbd_discard, "discard", "Discards");
+    plb.add_u64_counter(l_rbd_nbd_flush, "flush", "Flushes");
+    logger = plb.create_perf_counters();
+    g_ceph_context->get_perfcounters_collection()->add(logger);
+  }
 
 private:
   std::atomic<bool> terminated = { false };
@@ -160,6 +189,7 @@ private:
     struct nbd_reply reply;
     bufferlist data;
     int command;
+    utime_t start_time;
 
     IOContext()
       : item(this)
@@ -246,6 +276,28 @@ private:
     } else {
       ctx->reply.error = htonl(0);
     }
+
+    PerfCounters *logger = ctx->server->logger;
+    utime_t lat = ceph_clock_now() - ctx->start_time;
+    switch (ctx->command) {
+    case NBD_CMD_READ:
+      logger->inc(l_rbd_nbd_rd);
+      logger->inc(l_rbd_nbd_rd_bytes, ctx->request.len);
+      logger->tinc(l_rbd_nbd_rd_lat, lat);
+      break;
+    case NBD_CMD_WRITE:
+      logger->inc(l_rbd_nbd_wr);
+      logger->inc(l_rbd_nbd_wr_bytes, ctx->request.len);
+      logger->tinc(l_rbd_nbd_wr_lat, lat);
+      break;
+    case NBD_CMD_TRIM:
+      logger->inc(l_rbd_nbd_discard);
+      break;
+    case NBD_CMD_FLUSH:
+      logger->inc(l_rbd_nbd_flush);
+      break;
+    }
+
     ctx->server->io_finish(ctx);
 
     aio_completion->release();
@@ -301,6 +353,7 @@ private:
       }
 
       IOContext *pctx = ctx.release();
+      pctx->start_time = ceph_clock_now();
       io_start(pctx);
       librbd::RBD::AioCompletion *c = new librbd::RBD::AioCompletion(pctx, aio_callback);
       switch (pctx->command)
@@ -338,20 +391,19 @@ private:
 
       dout(20) << __func__ << ": got: " << *ctx << dendl;
 
-      int r = safe_write(fd, &ctx->reply, sizeof(struct nbd_reply));
+      // send the reply header and any read payload in one writev so a
+      // read completion costs a single syscall instead of two
+      bufferlist reply_bl;
+      reply_bl.append((char*)&ctx->reply, sizeof(struct nbd_reply));
+      if (ctx->command == NBD_CMD_READ && ctx->reply.error == htonl(0)) {
+	reply_bl.claim_append(ctx->data);
+      }
+      int r = reply_bl.write_fd(fd);
       if (r < 0) {
-	derr << *ctx << ": failed to write reply header: " << cpp_strerror(r)
+	derr << *ctx << ": failed to write reply: " << cpp_strerror(r)
 	     << dendl;
         return;
       }
-      if (ctx->command == NBD_CMD_READ && ctx->reply.error == htonl(0)) {
-	r = ctx->data.write_fd(fd);
-        if (r < 0) {
-	  derr << *ctx << ": failed to write replay data: " << cpp_strerror(r)
-	       << dendl;
-          return;
-	}
-      }
       dout(20) << *ctx << ": finish" << dendl;
     }
     dout(20) << __func__ << ": terminated" << dendl;
@@ -411,6 +463,9 @@ public:
   ~NBDServer()
   {
     stop();
+
+    g_ceph_context->get_perfcounters_collection()->remove(logger);
+    delete logger;
   }
 };
 